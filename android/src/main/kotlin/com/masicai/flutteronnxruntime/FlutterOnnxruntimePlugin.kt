@@ -23,12 +23,20 @@ import io.flutter.plugin.common.MethodChannel.MethodCallHandler
 import io.flutter.plugin.common.MethodChannel.Result
 import java.io.File
 import java.nio.ByteBuffer
+import java.nio.ByteOrder
 import java.nio.FloatBuffer
 import java.nio.IntBuffer
 import java.nio.LongBuffer
 import java.nio.ShortBuffer
+import java.util.Collections
+import java.util.IdentityHashMap
 import java.util.UUID
 import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.RejectedExecutionException
+import java.util.concurrent.ThreadPoolExecutor
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicLong
 
 /**
  * Utility class for float16 conversions
@@ -145,6 +153,64 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
     // Lock to serialize method handler and cleanup to prevent use-after-close races
     private val lock = Any()
 
+    // Runs inference, creates and closes sessions off the channel's task queue. Runs of one session are serialized
+    // by locking the OrtSession, so the pool bounds how many sessions, e.g. on NNAPI, QNN and XNNPACK, run at once.
+    private val inferenceExecutor =
+        ThreadPoolExecutor(2, 2, 30, TimeUnit.SECONDS, LinkedBlockingQueue()).apply { allowCoreThreadTimeOut(true) }
+
+    // Values that runs in flight read as inputs, with the number of runs reading each; guarded by lock
+    private val pinnedValues = IdentityHashMap<OnnxValue, Int>()
+
+    // Pinned values released by Dart, closed once the last run reading them finishes; guarded by lock
+    private val releasedPinnedValues = Collections.newSetFromMap(IdentityHashMap<OnnxValue, Boolean>())
+
+    // Close a value released by Dart, or defer it to the end of the runs reading it
+    private fun closeValue(value: OnnxValue) {
+        if (pinnedValues.containsKey(value)) {
+            releasedPinnedValues.add(value)
+        } else {
+            value.close()
+        }
+    }
+
+    // Stop reading input values at the end of a run, closing those released in the meantime
+    private fun unpinValues(values: Collection<OnnxValue>) {
+        for (value in values) {
+            val count = pinnedValues[value] ?: continue
+            if (count > 1) {
+                pinnedValues[value] = count - 1
+                continue
+            }
+            pinnedValues.remove(value)
+            if (releasedPinnedValues.remove(value)) {
+                try {
+                    value.close()
+                } catch (e: Exception) {
+                    Log.e("ORT_ERROR", "Error closing tensor: ${e.message}")
+                }
+            }
+        }
+    }
+
+    // Whether new session and value IDs are sent to Dart as integer handles instead of UUID strings
+    @Volatile private var integerHandles = false
+
+    // Integer handles come from a counter and are never reused, so a stale handle cannot reach a newer object
+    private val nextHandle = AtomicLong(1)
+
+    // Generate the ID of a new session or OrtValue
+    private fun newId(): String =
+        if (integerHandles) nextHandle.getAndIncrement().toString() else UUID.randomUUID().toString()
+
+    // Convert an ID to the form sent to Dart
+    private fun idToDart(id: String): Any = if (integerHandles) id.toLongOrNull() ?: id else id
+
+    // Read an ID sent by Dart, which is either an integer handle or a string ID
+    private fun idArgument(
+        call: MethodCall,
+        key: String,
+    ): String? = call.argument<Any>(key)?.toString()
+
     private fun ortTypeToString(type: OnnxJavaType): String {
         return when (type.toString()) {
             "FLOAT" -> "float32"
@@ -185,6 +251,59 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
         }
     }
 
+    // ONNX Runtime uses a direct buffer in native order as the memory of a tensor and copies any other buffer into
+    // one first, so the elements of new tensors are written straight into their direct buffer
+    private fun directBuffer(bytes: Int): ByteBuffer = ByteBuffer.allocateDirect(bytes).order(ByteOrder.nativeOrder())
+
+    private fun directFloats(data: FloatArray): FloatBuffer =
+        directBuffer(data.size * 4).asFloatBuffer().apply {
+            put(data)
+            rewind()
+        }
+
+    private fun directInts(data: IntArray): IntBuffer =
+        directBuffer(data.size * 4).asIntBuffer().apply {
+            put(data)
+            rewind()
+        }
+
+    private fun directLongs(data: LongArray): LongBuffer =
+        directBuffer(data.size * 8).asLongBuffer().apply {
+            put(data)
+            rewind()
+        }
+
+    private fun directBytes(data: ByteArray): ByteBuffer =
+        directBuffer(data.size).apply {
+            put(data)
+            rewind()
+        }
+
+    private inline fun directFloats(
+        count: Int,
+        element: (Int) -> Float,
+    ): FloatBuffer = directBuffer(count * 4).asFloatBuffer().apply { for (i in 0 until count) put(i, element(i)) }
+
+    private inline fun directInts(
+        count: Int,
+        element: (Int) -> Int,
+    ): IntBuffer = directBuffer(count * 4).asIntBuffer().apply { for (i in 0 until count) put(i, element(i)) }
+
+    private inline fun directLongs(
+        count: Int,
+        element: (Int) -> Long,
+    ): LongBuffer = directBuffer(count * 8).asLongBuffer().apply { for (i in 0 until count) put(i, element(i)) }
+
+    private inline fun directShorts(
+        count: Int,
+        element: (Int) -> Short,
+    ): ShortBuffer = directBuffer(count * 2).asShortBuffer().apply { for (i in 0 until count) put(i, element(i)) }
+
+    private inline fun directBytes(
+        count: Int,
+        element: (Int) -> Byte,
+    ): ByteBuffer = directBuffer(count).apply { for (i in 0 until count) put(i, element(i)) }
+
     override fun onAttachedToEngine(
         @NonNull flutterPluginBinding: FlutterPlugin.FlutterPluginBinding,
     ) {
@@ -203,296 +322,69 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
     override fun onMethodCall(
         @NonNull call: MethodCall,
         @NonNull result: Result,
+    ) {
+        // Calls that can take seconds run on the inference executor, so that tensor calls on the task queue and
+        // runs of other sessions are not stuck behind them
+        when (call.method) {
+            "createSession" -> dispatch(result) { createSession(call, result) }
+            "runInference" -> dispatch(result) { runInference(call, result) }
+            "closeSession" -> dispatch(result) { closeSession(call, result) }
+            else -> handleMethodCall(call, result)
+        }
+    }
+
+    // Run a call on the inference executor, failing it if the plugin is being detached
+    private fun dispatch(
+        result: Result,
+        work: () -> Unit,
+    ) {
+        try {
+            inferenceExecutor.execute { work() }
+        } catch (e: RejectedExecutionException) {
+            result.error("PLUGIN_ERROR", "The plugin is detached from the engine", null)
+        }
+    }
+
+    private fun handleMethodCall(
+        call: MethodCall,
+        result: Result,
     ): Unit =
         synchronized(lock) {
             when (call.method) {
                 "getPlatformVersion" -> {
                     result.success("Android ${android.os.Build.VERSION.RELEASE}")
                 }
-                "createSession" -> {
-                    try {
-                        val modelPath = call.argument<String>("modelPath")
-                        val sessionOptions = call.argument<Map<String, Any>>("sessionOptions") ?: emptyMap()
-
-                        if (modelPath == null) {
-                            result.error("INVALID_ARGUMENT", "Model path cannot be null", null)
-                            return
-                        }
-
-                        val ortSessionOptions = OrtSession.SessionOptions()
-
-                        // Configure session options based on the provided map
-                        if (sessionOptions.containsKey("intraOpNumThreads")) {
-                            ortSessionOptions.setIntraOpNumThreads((sessionOptions["intraOpNumThreads"] as Number).toInt())
-                        }
-
-                        if (sessionOptions.containsKey("interOpNumThreads")) {
-                            ortSessionOptions.setInterOpNumThreads((sessionOptions["interOpNumThreads"] as Number).toInt())
-                        }
-
-                        // get list of providers, default is empty list
-                        var providers = emptyList<String>()
-                        if (sessionOptions.containsKey("providers")) {
-                            providers = sessionOptions["providers"] as List<String>
-                        }
-                        // if providers is empty, add CPU provider
-                        if (providers.isEmpty()) {
-                            providers = listOf("CPU")
-                        }
-                        var useArena = true
-                        if (sessionOptions.containsKey("useArena")) {
-                            useArena = sessionOptions["useArena"] as Boolean
-                        }
-                        ortSessionOptions.setCPUArenaAllocator(useArena)
-                        var deviceId = 0
-                        if (sessionOptions.containsKey("deviceId")) {
-                            deviceId = sessionOptions["deviceId"] as Int
-                        }
-                        // loop through the providers and add them to the ortSessionOptions
-                        for (provider in providers) {
-                            // add providers with default parameters
-                            when (provider) {
-                                "ACL" -> {
-                                    ortSessionOptions.addACL(true)
-                                }
-                                "ARM_NN" -> {
-                                    ortSessionOptions.addArmNN(useArena)
-                                }
-                                "CORE_ML" -> {
-                                    ortSessionOptions.addCoreML()
-                                }
-                                "CPU" -> {
-                                    ortSessionOptions.addCPU(useArena)
-                                }
-                                "CUDA" -> {
-                                    ortSessionOptions.addCUDA(deviceId)
-                                }
-                                "DIRECT_ML" -> {
-                                    ortSessionOptions.addDirectML(deviceId)
-                                }
-                                "DNNL" -> {
-                                    ortSessionOptions.addDnnl(useArena)
-                                }
-                                "NNAPI" -> {
-                                    ortSessionOptions.addNnapi()
-                                }
-                                "OPEN_VINO" -> {
-                                    ortSessionOptions.addOpenVINO(deviceId.toString())
-                                }
-                                "QNN" -> {
-                                    ortSessionOptions.addQnn(mapOf())
-                                }
-                                "ROCM" -> {
-                                    ortSessionOptions.addROCM(deviceId)
-                                }
-                                "TENSOR_RT" -> {
-                                    ortSessionOptions.addTensorrt(OrtTensorRTProviderOptions(deviceId))
-                                }
-                                "XNNPACK" -> {
-                                    // use an empty map as the parameter
-                                    ortSessionOptions.addXnnpack(mapOf())
-                                }
-                                else -> {
-                                    result.error("INVALID_PROVIDER", "Provider $provider is not supported", null)
-                                    return
-                                }
-                            }
-                        }
-
-                        // Load model from file path
-                        val modelFile = File(modelPath)
-                        if (!modelFile.exists()) {
-                            result.error("FILE_NOT_FOUND", "Model file not found at path: $modelPath", null)
-                            return
-                        }
-
-                        val session = ortEnvironment.createSession(modelPath, ortSessionOptions)
-                        val sessionId = UUID.randomUUID().toString()
-                        sessions[sessionId] = session
-
-                        // Get input and output names
-                        val inputNames = session.inputNames.toList()
-                        val outputNames = session.outputNames.toList()
-
-                        result.success(
-                            mapOf(
-                                "sessionId" to sessionId,
-                                "inputNames" to inputNames,
-                                "outputNames" to outputNames,
-                            ),
-                        )
-                    } catch (e: OrtException) {
-                        result.error("ORT_ERROR", e.message, e.stackTraceToString())
-                    } catch (e: Exception) {
-                        result.error("PLUGIN_ERROR", e.message, e.stackTraceToString())
-                    }
-                }
                 "getAvailableProviders" -> {
                     val providers = OrtEnvironment.getAvailableProviders()
                     val providerList = providers.map { mapProviderNameToEnumName(it.toString()) }.toList()
                     result.success(providerList)
                 }
-                "runInference" -> {
-                    try {
-                        val sessionId = call.argument<String>("sessionId")
-                        val inputs = call.argument<Map<String, Any>>("inputs")
-                        val runOptions = call.argument<Map<String, Any>>("runOptions")
-
-                        if (sessionId == null || !sessions.containsKey(sessionId)) {
-                            result.error("INVALID_SESSION", "Session not found", null)
-                            return
-                        }
-
-                        if (inputs == null) {
-                            result.error("INVALID_ARGUMENT", "Inputs must be a non-null map", null)
-                            return
-                        }
-
-                        val session = sessions[sessionId]!!
-                        val ortInputs = HashMap<String, OnnxValue>()
-
-                        try {
-                            // Process inputs - now expecting only OrtValue references
-                            for ((name, value) in inputs) {
-                                // Only process value as a Map with valueId
-                                if (value is Map<*, *> && value.containsKey("valueId")) {
-                                    val valueId = value["valueId"] as String
-                                    val existingTensor = ortValues[valueId]
-                                    if (existingTensor != null) {
-                                        ortInputs[name] = existingTensor
-                                    } else {
-                                        result.error(
-                                            "INVALID_ORT_VALUE",
-                                            "OrtValue with ID $valueId not found",
-                                            null,
-                                        )
-                                        return
-                                    }
-                                } else {
-                                    result.error(
-                                        "INVALID_INPUT_FORMAT",
-                                        "Input for '$name' must be an OrtValue reference with value ID",
-                                        null,
-                                    )
-                                    return
-                                }
-                            }
-
-                            // Convert inputs to the required type for session.run
-                            val runInputs = HashMap<String, OnnxTensor>()
-                            for ((name, value) in ortInputs) {
-                                if (value is OnnxTensor) {
-                                    runInputs[name] = value
-                                }
-                            }
-
-                            // Create OrtSession.RunOptions if provided
-                            val ortRunOptions =
-                                if (runOptions != null && runOptions.isNotEmpty()) {
-                                    val options = OrtSession.RunOptions()
-
-                                    // Configure log severity level if provided
-                                    if (runOptions.containsKey("logSeverityLevel")) {
-                                        val level = (runOptions["logSeverityLevel"] as Number).toInt()
-                                        val logLevel =
-                                            when (level) {
-                                                0 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_VERBOSE
-                                                1 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_INFO
-                                                2 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_WARNING
-                                                3 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_ERROR
-                                                4 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_FATAL
-                                                // Handle unexpected levels
-                                                else -> OrtLoggingLevel.ORT_LOGGING_LEVEL_WARNING // default to warning
-                                            }
-                                        options.setLogLevel(logLevel)
-                                    }
-
-                                    // Configure log verbosity level if provided
-                                    if (runOptions.containsKey("logVerbosityLevel")) {
-                                        val level = (runOptions["logVerbosityLevel"] as Number).toInt()
-                                        options.setLogVerbosityLevel(level)
-                                    }
-
-                                    // Configure terminate flag if provided
-                                    if (runOptions.containsKey("terminate")) {
-                                        val terminate = runOptions["terminate"] as Boolean
-                                        options.setTerminate(terminate)
-                                    }
-
-                                    options
-                                } else {
-                                    null
-                                }
-
-                            // Run inference with correctly typed inputs and optional run options
-                            val ortOutputs =
-                                if (ortRunOptions != null) {
-                                    session.run(runInputs, ortRunOptions)
-                                } else {
-                                    session.run(runInputs)
-                                }
-
-                            // Process outputs
-                            // Outputs will be a map of outputName -> OrtValue parameters
-                            // OrtValue parameters are: valueId, elementType, shape
-                            val outputs = HashMap<String, Any>()
-
-                            // Convert tensor outputs to Flutter-compatible types
-                            for (outputName in session.outputNames) {
-                                // `Result.get(name)` returns Optional<OnnxValue>; unwrap it and keep tensor outputs only
-                                val outputValue = ortOutputs[outputName].orElse(null)
-                                // create a list of outputValue parameters
-                                val outputValueParams = ArrayList<Any>()
-
-                                val outputTensor = outputValue as? OnnxTensor
-
-                                if (outputTensor != null) {
-                                    // add outputTensor to ortvalues
-                                    val valueId = UUID.randomUUID().toString()
-                                    ortValues[valueId] = outputTensor
-
-                                    outputValueParams.add(valueId)
-                                    outputValueParams.add(ortTypeToString(outputTensor.info.type))
-                                    outputValueParams.add(outputTensor.info.shape.toList())
-                                } else {
-                                    val errorMessage = "Output is null or not a tensor: ${outputValue?.javaClass?.name}"
-                                    outputValueParams.add(errorMessage)
-                                }
-                                outputs[outputName] = outputValueParams
-                            }
-
-                            // Clean up run options if created
-                            ortRunOptions?.close()
-
-                            result.success(outputs)
-                        } catch (e: Exception) {
-                            throw e
-                        }
-                    } catch (e: OrtException) {
-                        result.error("INFERENCE_ERROR", e.message, e.stackTraceToString())
-                    } catch (e: Exception) {
-                        result.error("PLUGIN_ERROR", e.message, e.stackTraceToString())
+                "setInferenceThreads" -> {
+                    val numThreads = call.argument<Int>("numThreads")
+                    if (numThreads == null || numThreads < 1) {
+                        result.error("INVALID_ARG", "numThreads must be a positive integer", null)
+                        return
+                    }
+                    // Grow the maximum before the core size and shrink it after, as the executor requires
+                    // core <= maximum at every step; idle threads above the new size exit
+                    if (numThreads > inferenceExecutor.maximumPoolSize) {
+                        inferenceExecutor.maximumPoolSize = numThreads
+                        inferenceExecutor.corePoolSize = numThreads
+                    } else {
+                        inferenceExecutor.corePoolSize = numThreads
+                        inferenceExecutor.maximumPoolSize = numThreads
                     }
+                    result.success(null)
                 }
-                "closeSession" -> {
-                    try {
-                        val sessionId = call.argument<String>("sessionId")
-
-                        if (sessionId == null || !sessions.containsKey(sessionId)) {
-                            result.error("INVALID_SESSION", "Session not found", null)
-                            return
-                        }
-
-                        val session = sessions[sessionId]!!
-                        session.close()
-                        sessions.remove(sessionId)
-
-                        result.success(null)
-                    } catch (e: OrtException) {
-                        result.error("ORT_ERROR", e.message, e.stackTraceToString())
-                    } catch (e: Exception) {
-                        result.error("PLUGIN_ERROR", e.message, e.stackTraceToString())
+                "setIntegerHandles" -> {
+                    val enabled = call.argument<Boolean>("enabled")
+                    if (enabled == null) {
+                        result.error("INVALID_ARG", "Enabled must be a boolean", null)
+                        return
                     }
+                    // Only changes how new IDs are generated; both forms are always accepted from Dart
+                    integerHandles = enabled
+                    result.success(null)
                 }
                 /** Get metadata about the model
 
@@ -502,7 +394,7 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                  */
                 "getMetadata" -> {
                     try {
-                        val sessionId = call.argument<String>("sessionId")
+                        val sessionId = idArgument(call, "sessionId")
 
                         if (sessionId == null || !sessions.containsKey(sessionId)) {
                             result.error("INVALID_SESSION", "Session not found", null)
@@ -540,7 +432,7 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                  */
                 "getInputInfo" -> {
                     try {
-                        val sessionId = call.argument<String>("sessionId")
+                        val sessionId = idArgument(call, "sessionId")
 
                         if (sessionId == null || !sessions.containsKey(sessionId)) {
                             result.error("INVALID_SESSION", "Session not found", null)
@@ -589,7 +481,7 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                  */
                 "getOutputInfo" -> {
                     try {
-                        val sessionId = call.argument<String>("sessionId")
+                        val sessionId = idArgument(call, "sessionId")
 
                         if (sessionId == null || !sessions.containsKey(sessionId)) {
                             result.error("INVALID_SESSION", "Session not found", null)
@@ -651,14 +543,14 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                 "float32" -> {
                                     val floatData =
                                         when (data) {
-                                            is List<*> -> data.map { (it as Number).toFloat() }.toFloatArray()
-                                            is FloatArray -> data
+                                            is List<*> -> directFloats(data.size) { (data[it] as Number).toFloat() }
+                                            is FloatArray -> directFloats(data)
                                             else -> {
                                                 result.error("INVALID_DATA", "Data must be a list of numbers for float32 type", null)
                                                 return
                                             }
                                         }
-                                    OnnxTensor.createTensor(ortEnvironment, FloatBuffer.wrap(floatData), longShape)
+                                    OnnxTensor.createTensor(ortEnvironment, floatData, longShape)
                                 }
                                 "float16" -> {
                                     when (data) {
@@ -669,28 +561,26 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                             }
 
                                             // Handle both short values (already in float16 format) and float values (need conversion)
-                                            val shortData = ShortArray(data.size)
-                                            when (data[0]) {
-                                                is Number -> {
-                                                    // If source is float, convert to float16
-                                                    for (i in data.indices) {
-                                                        val floatValue = (data[i] as Number).toFloat()
-                                                        shortData[i] = Float16Utils.floatToFloat16(floatValue)
+                                            val shortData =
+                                                when (data[0]) {
+                                                    is Number -> {
+                                                        // If source is float, convert to float16
+                                                        directShorts(data.size) {
+                                                            Float16Utils.floatToFloat16((data[it] as Number).toFloat())
+                                                        }
+                                                    }
+                                                    else -> {
+                                                        result.error("INVALID_DATA", "Data must be a list of numbers for float16 type", null)
+                                                        return
                                                     }
                                                 }
-                                                else -> {
-                                                    result.error("INVALID_DATA", "Data must be a list of numbers for float16 type", null)
-                                                    return
-                                                }
-                                            }
 
                                             // Create tensor with float16 type
-                                            OnnxTensor.createTensor(
-                                                ortEnvironment,
-                                                ShortBuffer.wrap(shortData),
-                                                longShape,
-                                                OnnxJavaType.FLOAT16,
-                                            )
+                                            OnnxTensor.createTensor(ortEnvironment, shortData, longShape, OnnxJavaType.FLOAT16)
+                                        }
+                                        is FloatArray -> {
+                                            val shortData = directShorts(data.size) { Float16Utils.floatToFloat16(data[it]) }
+                                            OnnxTensor.createTensor(ortEnvironment, shortData, longShape, OnnxJavaType.FLOAT16)
                                         }
                                         else -> {
                                             result.error("INVALID_DATA", "Data must be a list of numbers for float16 type", null)
@@ -701,62 +591,50 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                 "int32" -> {
                                     val intData =
                                         when (data) {
-                                            is List<*> -> data.map { (it as Number).toInt() }.toIntArray()
-                                            is IntArray -> data
+                                            is List<*> -> directInts(data.size) { (data[it] as Number).toInt() }
+                                            is IntArray -> directInts(data)
                                             else -> {
                                                 result.error("INVALID_DATA", "Data must be a list of numbers for int32 type", null)
                                                 return
                                             }
                                         }
-                                    OnnxTensor.createTensor(ortEnvironment, IntBuffer.wrap(intData), longShape)
+                                    OnnxTensor.createTensor(ortEnvironment, intData, longShape)
                                 }
                                 "int64" -> {
                                     val longData =
                                         when (data) {
-                                            is List<*> -> data.map { (it as Number).toLong() }.toLongArray()
-                                            is LongArray -> data
+                                            is List<*> -> directLongs(data.size) { (data[it] as Number).toLong() }
+                                            is LongArray -> directLongs(data)
                                             else -> {
                                                 result.error("INVALID_DATA", "Data must be a list of numbers for int64 type", null)
                                                 return
                                             }
                                         }
-                                    OnnxTensor.createTensor(ortEnvironment, LongBuffer.wrap(longData), longShape)
+                                    OnnxTensor.createTensor(ortEnvironment, longData, longShape)
                                 }
                                 "uint8" -> {
                                     val byteData =
                                         when (data) {
-                                            is List<*> -> {
-                                                val bytes = ByteArray(data.size)
-                                                for (i in data.indices) {
-                                                    bytes[i] = (data[i] as Number).toByte()
-                                                }
-                                                bytes
-                                            }
-                                            is ByteArray -> data
+                                            is List<*> -> directBytes(data.size) { (data[it] as Number).toByte() }
+                                            is ByteArray -> directBytes(data)
                                             else -> {
                                                 result.error("INVALID_DATA", "Data must be a list of numbers for uint8 type", null)
                                                 return
                                             }
                                         }
-                                    OnnxTensor.createTensor(ortEnvironment, ByteBuffer.wrap(byteData), longShape, OnnxJavaType.UINT8)
+                                    OnnxTensor.createTensor(ortEnvironment, byteData, longShape, OnnxJavaType.UINT8)
                                 }
                                 "bool" -> {
                                     val boolData =
                                         when (data) {
-                                            is List<*> -> {
-                                                val bytes = ByteArray(data.size)
-                                                for (i in data.indices) {
-                                                    bytes[i] = if (data[i] as Boolean) 1.toByte() else 0.toByte()
-                                                }
-                                                bytes
-                                            }
+                                            is List<*> -> directBytes(data.size) { if (data[it] as Boolean) 1.toByte() else 0.toByte() }
                                             else -> {
                                                 result.error("INVALID_DATA", "Data must be a list of booleans for bool type", null)
                                                 return
                                             }
                                         }
                                     // Boolean tensors are stored as bytes in ONNX Runtime
-                                    OnnxTensor.createTensor(ortEnvironment, ByteBuffer.wrap(boolData), longShape, OnnxJavaType.BOOL)
+                                    OnnxTensor.createTensor(ortEnvironment, boolData, longShape, OnnxJavaType.BOOL)
                                 }
                                 "string" -> {
                                     val stringData =
@@ -778,13 +656,13 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                             }
 
                         // Store the tensor with a unique ID
-                        val valueId = UUID.randomUUID().toString()
+                        val valueId = newId()
                         ortValues[valueId] = tensor
 
                         // Return tensor information
                         val tensorInfo =
                             mapOf(
-                                "valueId" to valueId,
+                                "valueId" to idToDart(valueId),
                                 "dataType" to sourceType,
                                 "shape" to shape,
                             )
@@ -796,7 +674,7 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                 }
                 "convertOrtValue" -> {
                     try {
-                        val valueId = call.argument<String>("valueId")
+                        val valueId = idArgument(call, "valueId")
                         val targetType = call.argument<String>("targetType")
 
                         if (valueId == null || targetType == null) {
@@ -830,18 +708,11 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val floatArray = FloatArray(floatBuffer.remaining())
                                     floatBuffer.get(floatArray)
 
-                                    // Convert float array to short array using OnnxRuntime's float16 utilities
-                                    // Use ShortBuffer to store float16 values
-                                    val shortArray = ShortArray(floatArray.size)
-                                    for (i in floatArray.indices) {
-                                        // Use ai.onnxruntime.OnnxRuntime utility method to convert float to float16
-                                        shortArray[i] = Float16Utils.floatToFloat16(floatArray[i])
-                                    }
+                                    // Convert float array to float16 values using OnnxRuntime's float16 utilities
+                                    val converted = directShorts(floatArray.size) { Float16Utils.floatToFloat16(floatArray[it]) }
 
-                                    // Create a new tensor with float16 data
-                                    val shortBuffer = ShortBuffer.wrap(shortArray)
                                     // Use OnnxTensor.createTensor with the appropriate float16 type
-                                    OnnxTensor.createTensor(ortEnvironment, shortBuffer, shape, OnnxJavaType.FLOAT16)
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape, OnnxJavaType.FLOAT16)
                                 }
                                 // Float16 to float32
                                 dataType == "float16" && targetType == "float32" -> {
@@ -849,8 +720,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val shortArray = ShortArray(shortBuffer.remaining())
                                     shortBuffer.get(shortArray)
 
-                                    val floatArray = FloatArray(shortArray.size) { Float16Utils.float16ToFloat(shortArray[it]) }
-                                    OnnxTensor.createTensor(ortEnvironment, FloatBuffer.wrap(floatArray), shape)
+                                    val converted = directFloats(shortArray.size) { Float16Utils.float16ToFloat(shortArray[it]) }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Int32 to Float32
                                 dataType == "int32" && targetType == "float32" -> {
@@ -858,8 +729,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val intArray = IntArray(intBuffer.remaining())
                                     intBuffer.get(intArray)
 
-                                    val floatArray = FloatArray(intArray.size) { intArray[it].toFloat() }
-                                    OnnxTensor.createTensor(ortEnvironment, FloatBuffer.wrap(floatArray), shape)
+                                    val converted = directFloats(intArray.size) { intArray[it].toFloat() }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Int64 to Float32
                                 dataType == "int64" && targetType == "float32" -> {
@@ -867,8 +738,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val longArray = LongArray(longBuffer.remaining())
                                     longBuffer.get(longArray)
 
-                                    val floatArray = FloatArray(longArray.size) { longArray[it].toFloat() }
-                                    OnnxTensor.createTensor(ortEnvironment, FloatBuffer.wrap(floatArray), shape)
+                                    val converted = directFloats(longArray.size) { longArray[it].toFloat() }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Uint8 to Float32
                                 dataType == "uint8" && targetType == "float32" -> {
@@ -876,8 +747,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val byteArray = ByteArray(byteBuffer.remaining())
                                     byteBuffer.get(byteArray)
 
-                                    val floatArray = FloatArray(byteArray.size) { (byteArray[it].toInt() and 0xFF).toFloat() }
-                                    OnnxTensor.createTensor(ortEnvironment, FloatBuffer.wrap(floatArray), shape)
+                                    val converted = directFloats(byteArray.size) { (byteArray[it].toInt() and 0xFF).toFloat() }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Uint8 to Int32
                                 dataType == "uint8" && targetType == "int32" -> {
@@ -885,8 +756,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val byteArray = ByteArray(byteBuffer.remaining())
                                     byteBuffer.get(byteArray)
 
-                                    val intArray = IntArray(byteArray.size) { byteArray[it].toInt() and 0xFF }
-                                    OnnxTensor.createTensor(ortEnvironment, IntBuffer.wrap(intArray), shape)
+                                    val converted = directInts(byteArray.size) { byteArray[it].toInt() and 0xFF }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Uint8 to Int64
                                 dataType == "uint8" && targetType == "int64" -> {
@@ -894,8 +765,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val byteArray = ByteArray(byteBuffer.remaining())
                                     byteBuffer.get(byteArray)
 
-                                    val longArray = LongArray(byteArray.size) { (byteArray[it].toInt() and 0xFF).toLong() }
-                                    OnnxTensor.createTensor(ortEnvironment, LongBuffer.wrap(longArray), shape)
+                                    val converted = directLongs(byteArray.size) { (byteArray[it].toInt() and 0xFF).toLong() }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Float32 to Int32
                                 dataType == "float32" && targetType == "int32" -> {
@@ -903,8 +774,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val floatArray = FloatArray(floatBuffer.remaining())
                                     floatBuffer.get(floatArray)
 
-                                    val intArray = IntArray(floatArray.size) { floatArray[it].toInt() }
-                                    OnnxTensor.createTensor(ortEnvironment, IntBuffer.wrap(intArray), shape)
+                                    val converted = directInts(floatArray.size) { floatArray[it].toInt() }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Float32 to Int64
                                 dataType == "float32" && targetType == "int64" -> {
@@ -912,8 +783,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val floatArray = FloatArray(floatBuffer.remaining())
                                     floatBuffer.get(floatArray)
 
-                                    val longArray = LongArray(floatArray.size) { floatArray[it].toLong() }
-                                    OnnxTensor.createTensor(ortEnvironment, LongBuffer.wrap(longArray), shape)
+                                    val converted = directLongs(floatArray.size) { floatArray[it].toLong() }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Int32 to Int64
                                 dataType == "int32" && targetType == "int64" -> {
@@ -921,8 +792,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val intArray = IntArray(intBuffer.remaining())
                                     intBuffer.get(intArray)
 
-                                    val longArray = LongArray(intArray.size) { intArray[it].toLong() }
-                                    OnnxTensor.createTensor(ortEnvironment, LongBuffer.wrap(longArray), shape)
+                                    val converted = directLongs(intArray.size) { intArray[it].toLong() }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Int64 to Int32 (with potential loss of precision)
                                 dataType == "int64" && targetType == "int32" -> {
@@ -936,8 +807,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                         Log.w("ORT_CONVERSION", "Converting Int64 to Int32 with data loss")
                                     }
 
-                                    val intArray = IntArray(longArray.size) { longArray[it].toInt() }
-                                    OnnxTensor.createTensor(ortEnvironment, IntBuffer.wrap(intArray), shape)
+                                    val converted = directInts(longArray.size) { longArray[it].toInt() }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Float32 to Uint8
                                 dataType == "float32" && targetType == "uint8" -> {
@@ -946,8 +817,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     floatBuffer.get(floatArray)
 
                                     // Clamp to valid uint8 range [0, 255]
-                                    val byteData = ByteArray(floatArray.size) { floatArray[it].toInt().coerceIn(0, 255).toByte() }
-                                    OnnxTensor.createTensor(ortEnvironment, ByteBuffer.wrap(byteData), shape, OnnxJavaType.UINT8)
+                                    val byteData = directBytes(floatArray.size) { floatArray[it].toInt().coerceIn(0, 255).toByte() }
+                                    OnnxTensor.createTensor(ortEnvironment, byteData, shape, OnnxJavaType.UINT8)
                                 }
                                 // Int32 to Uint8
                                 dataType == "int32" && targetType == "uint8" -> {
@@ -956,8 +827,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     intBuffer.get(intArray)
 
                                     // Clamp to valid uint8 range [0, 255]
-                                    val byteData = ByteArray(intArray.size) { intArray[it].coerceIn(0, 255).toByte() }
-                                    OnnxTensor.createTensor(ortEnvironment, ByteBuffer.wrap(byteData), shape, OnnxJavaType.UINT8)
+                                    val byteData = directBytes(intArray.size) { intArray[it].coerceIn(0, 255).toByte() }
+                                    OnnxTensor.createTensor(ortEnvironment, byteData, shape, OnnxJavaType.UINT8)
                                 }
                                 // Int64 to Uint8
                                 dataType == "int64" && targetType == "uint8" -> {
@@ -966,8 +837,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     longBuffer.get(longArray)
 
                                     // Clamp to valid uint8 range [0, 255]
-                                    val byteData = ByteArray(longArray.size) { longArray[it].coerceIn(0, 255).toByte() }
-                                    OnnxTensor.createTensor(ortEnvironment, ByteBuffer.wrap(byteData), shape, OnnxJavaType.UINT8)
+                                    val byteData = directBytes(longArray.size) { longArray[it].coerceIn(0, 255).toByte() }
+                                    OnnxTensor.createTensor(ortEnvironment, byteData, shape, OnnxJavaType.UINT8)
                                 }
                                 // Boolean to Float32
                                 dataType == "bool" && targetType == "float32" -> {
@@ -975,8 +846,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val byteArray = ByteArray(byteBuffer.remaining())
                                     byteBuffer.get(byteArray)
 
-                                    val floatArray = FloatArray(byteArray.size) { if (byteArray[it] != 0.toByte()) 1.0f else 0.0f }
-                                    OnnxTensor.createTensor(ortEnvironment, FloatBuffer.wrap(floatArray), shape)
+                                    val converted = directFloats(byteArray.size) { if (byteArray[it] != 0.toByte()) 1.0f else 0.0f }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Boolean to Int32
                                 dataType == "bool" && targetType == "int32" -> {
@@ -984,8 +855,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val byteArray = ByteArray(byteBuffer.remaining())
                                     byteBuffer.get(byteArray)
 
-                                    val intArray = IntArray(byteArray.size) { if (byteArray[it] != 0.toByte()) 1 else 0 }
-                                    OnnxTensor.createTensor(ortEnvironment, IntBuffer.wrap(intArray), shape)
+                                    val converted = directInts(byteArray.size) { if (byteArray[it] != 0.toByte()) 1 else 0 }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Boolean to Int64
                                 dataType == "bool" && targetType == "int64" -> {
@@ -993,8 +864,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     val byteArray = ByteArray(byteBuffer.remaining())
                                     byteBuffer.get(byteArray)
 
-                                    val longArray = LongArray(byteArray.size) { if (byteArray[it] != 0.toByte()) 1L else 0L }
-                                    OnnxTensor.createTensor(ortEnvironment, LongBuffer.wrap(longArray), shape)
+                                    val converted = directLongs(byteArray.size) { if (byteArray[it] != 0.toByte()) 1L else 0L }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape)
                                 }
                                 // Boolean to Int8/Uint8
                                 dataType == "bool" && (targetType == "int8" || targetType == "uint8") -> {
@@ -1004,7 +875,7 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
 
                                     // Boolean values are already stored as bytes (0 or 1)
                                     val javaType = if (targetType == "uint8") OnnxJavaType.UINT8 else OnnxJavaType.INT8
-                                    OnnxTensor.createTensor(ortEnvironment, ByteBuffer.wrap(byteArray), shape, javaType)
+                                    OnnxTensor.createTensor(ortEnvironment, directBytes(byteArray), shape, javaType)
                                 }
                                 // Int8/Uint8 to Boolean
                                 (dataType == "int8" || dataType == "uint8") && targetType == "bool" -> {
@@ -1013,9 +884,9 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                                     byteBuffer.get(byteArray)
 
                                     // Convert to boolean representation (non-zero values become true)
-                                    val boolArray =
-                                        ByteArray(byteArray.size) { if (byteArray[it] != 0.toByte()) 1.toByte() else 0.toByte() }
-                                    OnnxTensor.createTensor(ortEnvironment, ByteBuffer.wrap(boolArray), shape, OnnxJavaType.BOOL)
+                                    val converted =
+                                        directBytes(byteArray.size) { if (byteArray[it] != 0.toByte()) 1.toByte() else 0.toByte() }
+                                    OnnxTensor.createTensor(ortEnvironment, converted, shape, OnnxJavaType.BOOL)
                                 }
                                 // Same type conversion (no-op)
                                 (dataType == "float32" && targetType == "float32") ||
@@ -1041,14 +912,14 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                             }
 
                         // register the new tensor to ortValues
-                        val id = UUID.randomUUID().toString()
+                        val id = newId()
                         ortValues[id] = newTensor
                         val newValueId = id
 
                         // Return tensor information
                         val tensorInfo =
                             mapOf(
-                                "valueId" to newValueId,
+                                "valueId" to idToDart(newValueId),
                                 "dataType" to targetType,
                                 "shape" to shape.toList(),
                             )
@@ -1060,7 +931,7 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                 }
                 "getOrtValueData" -> {
                     try {
-                        val valueId = call.argument<String>("valueId")
+                        val valueId = idArgument(call, "valueId")
 
                         if (valueId == null) {
                             result.error("INVALID_ARG", "Missing value ID", null)
@@ -1151,7 +1022,7 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                 }
                 "releaseOrtValue" -> {
                     try {
-                        val valueId = call.argument<String>("valueId")
+                        val valueId = idArgument(call, "valueId")
 
                         if (valueId == null) {
                             result.error("INVALID_ARGUMENT", "Invalid value ID", null)
@@ -1161,7 +1032,7 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                         val tensor = ortValues.remove(valueId)
                         if (tensor != null) {
                             try {
-                                tensor.close()
+                                closeValue(tensor)
                             } catch (e: Exception) {
                                 // Log error but continue
                                 Log.e("ORT_ERROR", "Error closing tensor: ${e.message}")
@@ -1173,18 +1044,368 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                         result.error("RELEASE_ERROR", e.message, e.stackTraceToString())
                     }
                 }
+                "releaseOrtValues" -> {
+                    try {
+                        val valueIds = call.argument<List<Any>>("valueIds")
+
+                        if (valueIds == null) {
+                            result.error("INVALID_ARGUMENT", "Value IDs must be a list", null)
+                            return
+                        }
+
+                        // Unknown IDs are skipped, as releaseOrtValue does
+                        for (valueId in valueIds) {
+                            try {
+                                ortValues.remove(valueId.toString())?.let { closeValue(it) }
+                            } catch (e: Exception) {
+                                Log.e("ORT_ERROR", "Error closing tensor: ${e.message}")
+                            }
+                        }
+
+                        result.success(null)
+                    } catch (e: Exception) {
+                        result.error("RELEASE_ERROR", e.message, e.stackTraceToString())
+                    }
+                }
                 else -> {
                     result.notImplemented()
                 }
             }
         }
 
+    private fun createSession(
+        call: MethodCall,
+        result: Result,
+    ) {
+        try {
+            val modelPath = call.argument<String>("modelPath")
+            val sessionOptions = call.argument<Map<String, Any>>("sessionOptions") ?: emptyMap()
+
+            if (modelPath == null) {
+                result.error("INVALID_ARGUMENT", "Model path cannot be null", null)
+                return
+            }
+
+            val ortSessionOptions = OrtSession.SessionOptions()
+
+            // Configure session options based on the provided map
+            if (sessionOptions.containsKey("intraOpNumThreads")) {
+                ortSessionOptions.setIntraOpNumThreads((sessionOptions["intraOpNumThreads"] as Number).toInt())
+            }
+
+            if (sessionOptions.containsKey("interOpNumThreads")) {
+                ortSessionOptions.setInterOpNumThreads((sessionOptions["interOpNumThreads"] as Number).toInt())
+            }
+
+            // get list of providers, default is empty list
+            var providers = emptyList<String>()
+            if (sessionOptions.containsKey("providers")) {
+                providers = sessionOptions["providers"] as List<String>
+            }
+            // if providers is empty, add CPU provider
+            if (providers.isEmpty()) {
+                providers = listOf("CPU")
+            }
+            var useArena = true
+            if (sessionOptions.containsKey("useArena")) {
+                useArena = sessionOptions["useArena"] as Boolean
+            }
+            ortSessionOptions.setCPUArenaAllocator(useArena)
+            if (sessionOptions.containsKey("enableMemPattern")) {
+                ortSessionOptions.setMemoryPatternOptimization(sessionOptions["enableMemPattern"] as Boolean)
+            }
+            if (sessionOptions["useDeviceAllocatorForInitializers"] == true) {
+                ortSessionOptions.addConfigEntry("session.use_device_allocator_for_initializers", "1")
+            }
+            var deviceId = 0
+            if (sessionOptions.containsKey("deviceId")) {
+                deviceId = sessionOptions["deviceId"] as Int
+            }
+            // loop through the providers and add them to the ortSessionOptions
+            for (provider in providers) {
+                // add providers with default parameters
+                when (provider) {
+                    "ACL" -> {
+                        ortSessionOptions.addACL(true)
+                    }
+                    "ARM_NN" -> {
+                        ortSessionOptions.addArmNN(useArena)
+                    }
+                    "CORE_ML" -> {
+                        ortSessionOptions.addCoreML()
+                    }
+                    "CPU" -> {
+                        ortSessionOptions.addCPU(useArena)
+                    }
+                    "CUDA" -> {
+                        ortSessionOptions.addCUDA(deviceId)
+                    }
+                    "DIRECT_ML" -> {
+                        ortSessionOptions.addDirectML(deviceId)
+                    }
+                    "DNNL" -> {
+                        ortSessionOptions.addDnnl(useArena)
+                    }
+                    "NNAPI" -> {
+                        ortSessionOptions.addNnapi()
+                    }
+                    "OPEN_VINO" -> {
+                        ortSessionOptions.addOpenVINO(deviceId.toString())
+                    }
+                    "QNN" -> {
+                        ortSessionOptions.addQnn(mapOf())
+                    }
+                    "ROCM" -> {
+                        ortSessionOptions.addROCM(deviceId)
+                    }
+                    "TENSOR_RT" -> {
+                        ortSessionOptions.addTensorrt(OrtTensorRTProviderOptions(deviceId))
+                    }
+                    "XNNPACK" -> {
+                        // use an empty map as the parameter
+                        ortSessionOptions.addXnnpack(mapOf())
+                    }
+                    else -> {
+                        result.error("INVALID_PROVIDER", "Provider $provider is not supported", null)
+                        return
+                    }
+                }
+            }
+
+            // Load model from file path
+            val modelFile = File(modelPath)
+            if (!modelFile.exists()) {
+                result.error("FILE_NOT_FOUND", "Model file not found at path: $modelPath", null)
+                return
+            }
+
+            val session = ortEnvironment.createSession(modelPath, ortSessionOptions)
+            val sessionId = newId()
+            sessions[sessionId] = session
+
+            // Get input and output names
+            val inputNames = session.inputNames.toList()
+            val outputNames = session.outputNames.toList()
+
+            result.success(
+                mapOf(
+                    "sessionId" to idToDart(sessionId),
+                    "inputNames" to inputNames,
+                    "outputNames" to outputNames,
+                ),
+            )
+        } catch (e: OrtException) {
+            result.error("ORT_ERROR", e.message, e.stackTraceToString())
+        } catch (e: Exception) {
+            result.error("PLUGIN_ERROR", e.message, e.stackTraceToString())
+        }
+    }
+
+    private fun runInference(
+        call: MethodCall,
+        result: Result,
+    ) {
+        try {
+            val sessionId = idArgument(call, "sessionId")
+            val inputs = call.argument<Map<String, Any>>("inputs")
+            val runOptions = call.argument<Map<String, Any>>("runOptions")
+            val requestedNames = call.argument<List<String>>("outputNames")?.takeIf { it.isNotEmpty() }
+
+            if (inputs == null) {
+                result.error("INVALID_ARGUMENT", "Inputs must be a non-null map", null)
+                return
+            }
+
+            val ortInputs = HashMap<String, OnnxValue>()
+
+            // Look up the session and inputs, and pin the inputs so that releasing them during the run defers
+            // closing them until it finishes
+            val session =
+                synchronized(lock) {
+                    val found = sessionId?.let { sessions[it] }
+                    if (found == null) {
+                        result.error("INVALID_SESSION", "Session not found", null)
+                        return
+                    }
+
+                    // Process inputs - now expecting only OrtValue references
+                    for ((name, value) in inputs) {
+                        // Only process value as a Map with valueId
+                        if (value is Map<*, *> && value.containsKey("valueId")) {
+                            val valueId = value["valueId"].toString()
+                            val existingTensor = ortValues[valueId]
+                            if (existingTensor != null) {
+                                ortInputs[name] = existingTensor
+                            } else {
+                                result.error(
+                                    "INVALID_ORT_VALUE",
+                                    "OrtValue with ID $valueId not found",
+                                    null,
+                                )
+                                return
+                            }
+                        } else {
+                            result.error(
+                                "INVALID_INPUT_FORMAT",
+                                "Input for '$name' must be an OrtValue reference with value ID",
+                                null,
+                            )
+                            return
+                        }
+                    }
+
+                    for (value in ortInputs.values) {
+                        pinnedValues[value] = (pinnedValues[value] ?: 0) + 1
+                    }
+                    found
+                }
+
+            try {
+                // Convert inputs to the required type for session.run
+                val runInputs = HashMap<String, OnnxTensor>()
+                for ((name, value) in ortInputs) {
+                    if (value is OnnxTensor) {
+                        runInputs[name] = value
+                    }
+                }
+
+                // Create OrtSession.RunOptions if provided
+                val ortRunOptions =
+                    if (runOptions != null && runOptions.isNotEmpty()) {
+                        val options = OrtSession.RunOptions()
+
+                        // Configure log severity level if provided
+                        if (runOptions.containsKey("logSeverityLevel")) {
+                            val level = (runOptions["logSeverityLevel"] as Number).toInt()
+                            val logLevel =
+                                when (level) {
+                                    0 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_VERBOSE
+                                    1 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_INFO
+                                    2 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_WARNING
+                                    3 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_ERROR
+                                    4 -> OrtLoggingLevel.ORT_LOGGING_LEVEL_FATAL
+                                    // Handle unexpected levels
+                                    else -> OrtLoggingLevel.ORT_LOGGING_LEVEL_WARNING // default to warning
+                                }
+                            options.setLogLevel(logLevel)
+                        }
+
+                        // Configure log verbosity level if provided
+                        if (runOptions.containsKey("logVerbosityLevel")) {
+                            val level = (runOptions["logVerbosityLevel"] as Number).toInt()
+                            options.setLogVerbosityLevel(level)
+                        }
+
+                        // Configure terminate flag if provided
+                        if (runOptions.containsKey("terminate")) {
+                            val terminate = runOptions["terminate"] as Boolean
+                            options.setTerminate(terminate)
+                        }
+
+                        options
+                    } else {
+                        null
+                    }
+
+                // Run inference with correctly typed inputs, computing only the requested outputs if
+                // there are any, and optional run options. Runs of one session are serialized, runs of others
+                // proceed in parallel on the other executor threads.
+                val ortOutputs =
+                    synchronized(session) {
+                        if (requestedNames != null && ortRunOptions != null) {
+                            session.run(runInputs, requestedNames.toSet(), ortRunOptions)
+                        } else if (requestedNames != null) {
+                            session.run(runInputs, requestedNames.toSet())
+                        } else if (ortRunOptions != null) {
+                            session.run(runInputs, ortRunOptions)
+                        } else {
+                            session.run(runInputs)
+                        }
+                    }
+
+                // Process outputs
+                // Outputs will be a map of outputName -> OrtValue parameters
+                // OrtValue parameters are: valueId, elementType, shape
+                val outputs = HashMap<String, Any>()
+
+                // Convert tensor outputs to Flutter-compatible types
+                for (outputName in requestedNames ?: session.outputNames) {
+                    // `Result.get(name)` returns Optional<OnnxValue>; unwrap it and keep tensor outputs only
+                    val outputValue = ortOutputs[outputName].orElse(null)
+                    // create a list of outputValue parameters
+                    val outputValueParams = ArrayList<Any>()
+
+                    val outputTensor = outputValue as? OnnxTensor
+
+                    if (outputTensor != null) {
+                        // add outputTensor to ortvalues
+                        val valueId = newId()
+                        synchronized(lock) { ortValues[valueId] = outputTensor }
+
+                        outputValueParams.add(idToDart(valueId))
+                        outputValueParams.add(ortTypeToString(outputTensor.info.type))
+                        outputValueParams.add(outputTensor.info.shape.toList())
+                    } else {
+                        val errorMessage = "Output is null or not a tensor: ${outputValue?.javaClass?.name}"
+                        outputValueParams.add(errorMessage)
+                    }
+                    outputs[outputName] = outputValueParams
+                }
+
+                // Clean up run options if created
+                ortRunOptions?.close()
+
+                result.success(outputs)
+            } finally {
+                synchronized(lock) { unpinValues(ortInputs.values) }
+            }
+        } catch (e: OrtException) {
+            result.error("INFERENCE_ERROR", e.message, e.stackTraceToString())
+        } catch (e: Exception) {
+            result.error("PLUGIN_ERROR", e.message, e.stackTraceToString())
+        }
+    }
+
+    private fun closeSession(
+        call: MethodCall,
+        result: Result,
+    ) {
+        try {
+            val sessionId = idArgument(call, "sessionId")
+            val session = synchronized(lock) { sessionId?.let { sessions.remove(it) } }
+
+            if (session == null) {
+                result.error("INVALID_SESSION", "Session not found", null)
+                return
+            }
+
+            // Runs in flight hold the session's lock, so it is closed once they finish
+            synchronized(session) { session.close() }
+
+            result.success(null)
+        } catch (e: OrtException) {
+            result.error("ORT_ERROR", e.message, e.stackTraceToString())
+        } catch (e: Exception) {
+            result.error("PLUGIN_ERROR", e.message, e.stackTraceToString())
+        }
+    }
+
     override fun onDetachedFromEngine(
         @NonNull binding: FlutterPlugin.FlutterPluginBinding,
     ) {
         // Stop accepting new calls before acquiring the lock
         channel.setMethodCallHandler(null)
 
+        // Let queued runs and session creations finish before closing what they use
+        inferenceExecutor.shutdown()
+        try {
+            if (!inferenceExecutor.awaitTermination(10, TimeUnit.SECONDS)) {
+                Log.w("ORT_WARNING", "Inference calls still running while detaching")
+            }
+        } catch (e: InterruptedException) {
+            Thread.currentThread().interrupt()
+        }
+
         // Wait for any in-flight handler call to finish, then clean up
         synchronized(lock) {
             // Close all OrtValues
@@ -1196,6 +1417,8 @@ class FlutterOnnxruntimePlugin : FlutterPlugin, MethodCallHandler {
                 }
             }
             ortValues.clear()
+            pinnedValues.clear()
+            releasedPinnedValues.clear()
 
             // Close all sessions
             for (session in sessions.values) {
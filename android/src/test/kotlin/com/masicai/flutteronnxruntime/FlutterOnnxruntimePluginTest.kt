@@ -24,4 +24,15 @@ internal class FlutterOnnxruntimePluginTest {
 
         Mockito.verify(mockResult).success("Android " + android.os.Build.VERSION.RELEASE)
     }
+
+    @Test
+    fun onMethodCall_setInferenceThreads_rejectsNonPositiveCounts() {
+        val plugin = FlutterOnnxruntimePlugin()
+
+        val call = MethodCall("setInferenceThreads", mapOf("numThreads" to 0))
+        val mockResult: MethodChannel.Result = Mockito.mock(MethodChannel.Result::class.java)
+        plugin.onMethodCall(call, mockResult)
+
+        Mockito.verify(mockResult).error("INVALID_ARG", "numThreads must be a positive integer", null)
+    }
 }
@@ -0,0 +1,149 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "buffer_pool.h"
+#include <new>
+#include <utility>
+
+namespace flutter_onnxruntime {
+
+namespace {
+// Requests up to this size are rounded to the alignment only
+constexpr size_t kSmallClassLimit = 4096;
+} // namespace
+
+PooledBuffer::PooledBuffer(BufferPool *pool, uint8_t *data, size_t size, size_t capacity)
+    : pool_(pool), data_(data), size_(size), capacity_(capacity) {}
+
+PooledBuffer::~PooledBuffer() { reset(); }
+
+PooledBuffer::PooledBuffer(PooledBuffer &&other) noexcept
+    : pool_(other.pool_), data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+  other.pool_ = nullptr;
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.capacity_ = 0;
+}
+
+PooledBuffer &PooledBuffer::operator=(PooledBuffer &&other) noexcept {
+  if (this != &other) {
+    reset();
+    pool_ = other.pool_;
+    data_ = other.data_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.pool_ = nullptr;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+  }
+  return *this;
+}
+
+void PooledBuffer::reset() {
+  if (pool_ && data_) {
+    pool_->release(data_, capacity_);
+  }
+  pool_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  capacity_ = 0;
+}
+
+BufferPool::BufferPool(size_t max_retained_bytes)
+    : max_retained_bytes_(max_retained_bytes), retained_bytes_(0), retained_buffers_(0), hits_(0), misses_(0) {}
+
+BufferPool::~BufferPool() { trim(); }
+
+PooledBuffer BufferPool::acquire(size_t size) {
+  if (size == 0) {
+    return PooledBuffer();
+  }
+
+  size_t capacity = sizeClassFor(size);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = free_lists_.find(capacity);
+    if (it != free_lists_.end() && !it->second.empty()) {
+      uint8_t *data = it->second.back();
+      it->second.pop_back();
+      retained_bytes_ -= capacity;
+      retained_buffers_--;
+      hits_++;
+      return PooledBuffer(this, data, size, capacity);
+    }
+    misses_++;
+  }
+
+  // Allocate outside the lock so a large allocation does not stall other tensors
+  return PooledBuffer(this, allocateBlock(capacity), size, capacity);
+}
+
+void BufferPool::setMaxRetainedBytes(size_t max_retained_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_retained_bytes_ = max_retained_bytes;
+  trimLocked(max_retained_bytes_);
+}
+
+void BufferPool::trim() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  trimLocked(0);
+}
+
+BufferPoolStats BufferPool::getStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return BufferPoolStats{hits_, misses_, retained_bytes_, retained_buffers_, max_retained_bytes_};
+}
+
+size_t BufferPool::sizeClassFor(size_t size) {
+  if (size <= kSmallClassLimit) {
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  size_t power = kSmallClassLimit;
+  while (power < size) {
+    power <<= 1;
+  }
+  // size lies in (power / 2, power], split into four classes of power / 8 each
+  size_t step = power / 8;
+  return (size + step - 1) / step * step;
+}
+
+void BufferPool::release(uint8_t *data, size_t capacity) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (retained_bytes_ + capacity <= max_retained_bytes_) {
+      free_lists_[capacity].push_back(data);
+      retained_bytes_ += capacity;
+      retained_buffers_++;
+      return;
+    }
+  }
+
+  // Over the retention cap, give the block back to the system
+  freeBlock(data);
+}
+
+void BufferPool::trimLocked(size_t max_retained_bytes) {
+  // Free the largest blocks first, they are the most expensive to keep around
+  for (auto it = free_lists_.rbegin(); it != free_lists_.rend() && retained_bytes_ > max_retained_bytes; ++it) {
+    std::vector<uint8_t *> &blocks = it->second;
+    while (!blocks.empty() && retained_bytes_ > max_retained_bytes) {
+      freeBlock(blocks.back());
+      blocks.pop_back();
+      retained_bytes_ -= it->first;
+      retained_buffers_--;
+    }
+  }
+}
+
+uint8_t *BufferPool::allocateBlock(size_t capacity) {
+  return static_cast<uint8_t *>(::operator new(capacity, std::align_val_t(kAlignment)));
+}
+
+void BufferPool::freeBlock(uint8_t *data) { ::operator delete(data, std::align_val_t(kAlignment)); }
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,119 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_BUFFER_POOL_H_
+#define FLUTTER_ONNXRUNTIME_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace flutter_onnxruntime {
+
+class BufferPool;
+
+// Buffer checked out of a BufferPool; it goes back to the pool when destroyed
+class PooledBuffer {
+public:
+  PooledBuffer() = default;
+  ~PooledBuffer();
+
+  PooledBuffer(PooledBuffer &&other) noexcept;
+  PooledBuffer &operator=(PooledBuffer &&other) noexcept;
+
+  // Disallow copy and assign
+  PooledBuffer(const PooledBuffer &) = delete;
+  PooledBuffer &operator=(const PooledBuffer &) = delete;
+
+  uint8_t *data() const { return data_; }
+  // Requested size in bytes
+  size_t size() const { return size_; }
+  // Size of the underlying size-class block in bytes
+  size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  // Give the buffer back to the pool early
+  void reset();
+
+private:
+  friend class BufferPool;
+  PooledBuffer(BufferPool *pool, uint8_t *data, size_t size, size_t capacity);
+
+  BufferPool *pool_ = nullptr;
+  uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+};
+
+// Counters for tuning the pool
+struct BufferPoolStats {
+  size_t hits;             // Acquisitions served from a retained block
+  size_t misses;           // Acquisitions that had to allocate
+  size_t retained_bytes;   // Bytes held in free lists
+  size_t retained_buffers; // Blocks held in free lists
+  size_t max_retained_bytes;
+};
+
+// Size-class pool of 64-byte aligned blocks that back tensor data.
+// Released blocks are kept for reuse up to a retention cap, so steady-state workloads that create
+// tensors of the same sizes every frame stop hitting the system allocator.
+// The pool must outlive every buffer acquired from it.
+class BufferPool {
+public:
+  static constexpr size_t kAlignment = 64;
+  static constexpr size_t kDefaultMaxRetainedBytes = 64 * 1024 * 1024;
+
+  explicit BufferPool(size_t max_retained_bytes = kDefaultMaxRetainedBytes);
+  ~BufferPool();
+
+  // Disallow copy and assign
+  BufferPool(const BufferPool &) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+
+  // Check out a buffer of at least size bytes; the contents are uninitialized
+  PooledBuffer acquire(size_t size);
+
+  // Change the retention cap, freeing retained blocks above it
+  void setMaxRetainedBytes(size_t max_retained_bytes);
+
+  // Free every retained block
+  void trim();
+
+  BufferPoolStats getStats();
+
+  // Block size used for a request of size bytes: multiples of 64 bytes up to 4 KiB,
+  // then four classes per power of two so at most a quarter of a block is wasted
+  static size_t sizeClassFor(size_t size);
+
+private:
+  friend class PooledBuffer;
+
+  // Called by PooledBuffer when it goes out of scope
+  void release(uint8_t *data, size_t capacity);
+
+  void trimLocked(size_t max_retained_bytes);
+
+  static uint8_t *allocateBlock(size_t capacity);
+  static void freeBlock(uint8_t *data);
+
+  // Retained blocks per size class
+  std::map<size_t, std::vector<uint8_t *>> free_lists_;
+
+  size_t max_retained_bytes_;
+  size_t retained_bytes_;
+  size_t retained_buffers_;
+  size_t hits_;
+  size_t misses_;
+
+  // Mutex for thread safety; never held while calling out of the pool
+  std::mutex mutex_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_BUFFER_POOL_H_
@@ -0,0 +1,464 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "convert_kernels.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CONVERT_KERNELS_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CONVERT_KERNELS_NEON 1
+#endif
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// More threads do not help a memory-bound loop
+constexpr size_t kMaxConvertThreads = 4;
+
+template <ConvertType T> struct Element;
+template <> struct Element<ConvertType::kFloat32> {
+  using type = float;
+};
+template <> struct Element<ConvertType::kFloat16> {
+  using type = uint16_t;
+};
+template <> struct Element<ConvertType::kBFloat16> {
+  using type = uint16_t;
+};
+template <> struct Element<ConvertType::kFloat64> {
+  using type = double;
+};
+template <> struct Element<ConvertType::kInt8> {
+  using type = int8_t;
+};
+template <> struct Element<ConvertType::kUint8> {
+  using type = uint8_t;
+};
+template <> struct Element<ConvertType::kInt16> {
+  using type = int16_t;
+};
+template <> struct Element<ConvertType::kUint16> {
+  using type = uint16_t;
+};
+template <> struct Element<ConvertType::kInt32> {
+  using type = int32_t;
+};
+template <> struct Element<ConvertType::kUint32> {
+  using type = uint32_t;
+};
+template <> struct Element<ConvertType::kInt64> {
+  using type = int64_t;
+};
+template <> struct Element<ConvertType::kUint64> {
+  using type = uint64_t;
+};
+template <> struct Element<ConvertType::kBool> {
+  using type = bool;
+};
+
+template <ConvertType T> constexpr bool kIsFloating = T == ConvertType::kFloat32 || T == ConvertType::kFloat16 ||
+                                                     T == ConvertType::kBFloat16 || T == ConvertType::kFloat64;
+
+// The value of an element in the type it is converted through: float16 and bfloat16 as float, bool as 0/1
+template <ConvertType From> auto widen(typename Element<From>::type value) {
+  if constexpr (From == ConvertType::kFloat16) {
+    return float16BitsToFloat(value);
+  } else if constexpr (From == ConvertType::kBFloat16) {
+    return bfloat16BitsToFloat(value);
+  } else if constexpr (From == ConvertType::kBool) {
+    return static_cast<uint8_t>(value ? 1 : 0);
+  } else {
+    return value;
+  }
+}
+
+template <ConvertType From> float toFloat(typename Element<From>::type value) {
+  return static_cast<float>(widen<From>(value));
+}
+
+// Round half away from zero and saturate to the range of Out, in the arithmetic of the source; NaN becomes 0
+template <typename Out, typename Float> Out roundToInteger(Float value) {
+  using Limits = std::numeric_limits<Out>;
+  if (std::isnan(value)) {
+    return 0;
+  }
+  Float rounded = value + (value >= 0 ? Float(0.5) : Float(-0.5));
+  if (rounded <= static_cast<Float>(Limits::min())) {
+    return Limits::min();
+  }
+  if (rounded >= static_cast<Float>(Limits::max())) {
+    return Limits::max();
+  }
+  return static_cast<Out>(rounded);
+}
+
+// Saturate an integer to the range of Out; the comparisons run in 64 bits of the right signedness
+template <typename Out, typename In> Out saturateInteger(In value) {
+  using Limits = std::numeric_limits<Out>;
+  if constexpr (std::is_signed_v<In> && std::is_signed_v<Out>) {
+    int64_t wide = value;
+    if (wide > static_cast<int64_t>(Limits::max())) {
+      return Limits::max();
+    }
+    return wide < static_cast<int64_t>(Limits::min()) ? Limits::min() : static_cast<Out>(value);
+  } else {
+    if constexpr (std::is_signed_v<In>) {
+      if (value < 0) {
+        return 0;
+      }
+    }
+    return static_cast<uint64_t>(value) > static_cast<uint64_t>(Limits::max()) ? Limits::max()
+                                                                                : static_cast<Out>(value);
+  }
+}
+
+// Convert one element; the float32 rules are those of the original scalar loops of TensorManager
+template <ConvertType From, ConvertType To> typename Element<To>::type convertOne(typename Element<From>::type value) {
+  using Out = typename Element<To>::type;
+  if constexpr (From == To) {
+    return value;
+  } else if constexpr (To == ConvertType::kFloat16) {
+    return floatToFloat16Bits(toFloat<From>(value));
+  } else if constexpr (To == ConvertType::kBFloat16) {
+    return floatToBFloat16Bits(toFloat<From>(value));
+  } else if constexpr (To == ConvertType::kBool) {
+    return widen<From>(value) != 0;
+  } else if constexpr (From == ConvertType::kBool) {
+    return static_cast<Out>(value ? 1 : 0);
+  } else if constexpr (From == ConvertType::kFloat32 && To == ConvertType::kUint8) {
+    // Clamp between 0 and 255
+    float val = value < 0 ? 0 : (value > 255 ? 255 : value + 0.5f);
+    return static_cast<uint8_t>(val);
+  } else if constexpr (From == ConvertType::kFloat32 && (To == ConvertType::kInt32 || To == ConvertType::kInt64)) {
+    // Round float to int
+    return static_cast<Out>(value + (value >= 0 ? 0.5f : -0.5f));
+  } else if constexpr (kIsFloating<From> && !kIsFloating<To>) {
+    return roundToInteger<Out>(widen<From>(value));
+  } else if constexpr (!kIsFloating<From> && !kIsFloating<To>) {
+    // Widening is exact, narrower targets clamp to their range to prevent overflow
+    return saturateInteger<Out>(value);
+  } else {
+    // Integers to floats (large 64-bit values lose precision), and between float32 and float64
+    return static_cast<Out>(widen<From>(value));
+  }
+}
+
+// Vector loop over the leading elements of a range; returns how many it converted.
+// Pairs without a vector path leave the whole range to the scalar loop, which the compiler may still vectorize.
+template <ConvertType From, ConvertType To>
+size_t convertVector(const typename Element<From>::type * /* src */, typename Element<To>::type * /* dst */,
+                     size_t /* count */) {
+  return 0;
+}
+
+#if defined(CONVERT_KERNELS_SSE2)
+
+// _mm_cvttps_epi32 truncates like the scalar cvttss2si of static_cast, including 0x80000000 for NaN and
+// out-of-range values, so the results match the scalar loop bit for bit.
+
+template <> size_t convertVector<ConvertType::kFloat32, ConvertType::kInt32>(const float *src, int32_t *dst,
+                                                                            size_t count) {
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 neg_half = _mm_set1_ps(-0.5f);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 value = _mm_loadu_ps(src + i);
+    __m128 non_negative = _mm_cmpge_ps(value, zero);
+    __m128 bias = _mm_or_ps(_mm_and_ps(non_negative, half), _mm_andnot_ps(non_negative, neg_half));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_cvttps_epi32(_mm_add_ps(value, bias)));
+  }
+  return i;
+}
+
+// Clamping first and adding 0.5 afterwards truncates to the same value as the scalar rule; _mm_max_ps returns
+// its second operand for NaN, which maps NaN to 0 like the scalar code does
+static inline __m128i clampToUint8Range(__m128 value) {
+  const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+  return _mm_cvttps_epi32(_mm_add_ps(clamped, _mm_set1_ps(0.5f)));
+}
+
+template <> size_t convertVector<ConvertType::kFloat32, ConvertType::kUint8>(const float *src, uint8_t *dst,
+                                                                            size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i a = clampToUint8Range(_mm_loadu_ps(src + i));
+    __m128i b = clampToUint8Range(_mm_loadu_ps(src + i + 4));
+    __m128i c = clampToUint8Range(_mm_loadu_ps(src + i + 8));
+    __m128i d = clampToUint8Range(_mm_loadu_ps(src + i + 12));
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), packed);
+  }
+  return i;
+}
+
+template <> size_t convertVector<ConvertType::kUint8, ConvertType::kFloat32>(const uint8_t *src, float *dst,
+                                                                            size_t count) {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i low = _mm_unpacklo_epi8(bytes, zero);
+    __m128i high = _mm_unpackhi_epi8(bytes, zero);
+    _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)));
+    _mm_storeu_ps(dst + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)));
+    _mm_storeu_ps(dst + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)));
+    _mm_storeu_ps(dst + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)));
+  }
+  return i;
+}
+
+template <> size_t convertVector<ConvertType::kInt32, ConvertType::kFloat32>(const int32_t *src, float *dst,
+                                                                            size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))));
+  }
+  return i;
+}
+
+// Saturating packs clamp to [0, 255] exactly like the scalar rule
+template <> size_t convertVector<ConvertType::kInt32, ConvertType::kUint8>(const int32_t *src, uint8_t *dst,
+                                                                          size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m128i *in = reinterpret_cast<const __m128i *>(src + i);
+    __m128i low = _mm_packs_epi32(_mm_loadu_si128(in), _mm_loadu_si128(in + 1));
+    __m128i high = _mm_packs_epi32(_mm_loadu_si128(in + 2), _mm_loadu_si128(in + 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(low, high));
+  }
+  return i;
+}
+
+#elif defined(CONVERT_KERNELS_NEON)
+
+// vcvtq_s32_f32 and vcvtq_u32_f32 truncate and saturate like the scalar fcvtzs/fcvtzu of static_cast,
+// including 0 for NaN, so the results match the scalar loop bit for bit.
+
+template <> size_t convertVector<ConvertType::kFloat32, ConvertType::kInt32>(const float *src, int32_t *dst,
+                                                                            size_t count) {
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const float32x4_t neg_half = vdupq_n_f32(-0.5f);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    float32x4_t value = vld1q_f32(src + i);
+    float32x4_t bias = vbslq_f32(vcgeq_f32(value, zero), half, neg_half);
+    vst1q_s32(dst + i, vcvtq_s32_f32(vaddq_f32(value, bias)));
+  }
+  return i;
+}
+
+// vmaxnmq_f32 returns the number for NaN, which maps NaN to 0 like the scalar code does
+static inline uint16x4_t clampToUint8Range(float32x4_t value) {
+  float32x4_t clamped = vminq_f32(vmaxnmq_f32(value, vdupq_n_f32(0.0f)), vdupq_n_f32(255.0f));
+  return vmovn_u32(vcvtq_u32_f32(vaddq_f32(clamped, vdupq_n_f32(0.5f))));
+}
+
+template <> size_t convertVector<ConvertType::kFloat32, ConvertType::kUint8>(const float *src, uint8_t *dst,
+                                                                            size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    uint16x8_t words = vcombine_u16(clampToUint8Range(vld1q_f32(src + i)), clampToUint8Range(vld1q_f32(src + i + 4)));
+    vst1_u8(dst + i, vmovn_u16(words));
+  }
+  return i;
+}
+
+template <> size_t convertVector<ConvertType::kUint8, ConvertType::kFloat32>(const uint8_t *src, float *dst,
+                                                                            size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    uint16x8_t words = vmovl_u8(vld1_u8(src + i));
+    vst1q_f32(dst + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(words))));
+    vst1q_f32(dst + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(words))));
+  }
+  return i;
+}
+
+template <> size_t convertVector<ConvertType::kInt32, ConvertType::kFloat32>(const int32_t *src, float *dst,
+                                                                            size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    vst1q_f32(dst + i, vcvtq_f32_s32(vld1q_s32(src + i)));
+  }
+  return i;
+}
+
+// Saturating narrows clamp to [0, 255] exactly like the scalar rule
+template <> size_t convertVector<ConvertType::kInt32, ConvertType::kUint8>(const int32_t *src, uint8_t *dst,
+                                                                          size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    uint16x8_t words = vcombine_u16(vqmovun_s32(vld1q_s32(src + i)), vqmovun_s32(vld1q_s32(src + i + 4)));
+    vst1_u8(dst + i, vqmovn_u16(words));
+  }
+  return i;
+}
+
+#endif
+
+template <ConvertType From, ConvertType To> void convertRange(const void *src, void *dst, size_t begin, size_t end) {
+  const auto *in = static_cast<const typename Element<From>::type *>(src) + begin;
+  auto *out = static_cast<typename Element<To>::type *>(dst) + begin;
+  size_t count = end - begin;
+  if constexpr (From == To) {
+    std::memcpy(out, in, count * sizeof(*in));
+    return;
+  }
+  for (size_t i = convertVector<From, To>(in, out, count); i < count; i++) {
+    out[i] = convertOne<From, To>(in[i]);
+  }
+}
+
+using ConvertRange = void (*)(const void *src, void *dst, size_t begin, size_t end);
+
+template <ConvertType From, size_t... To>
+constexpr std::array<ConvertRange, kConvertTypeCount> kernelRow(std::index_sequence<To...>) {
+  return {{convertRange<From, static_cast<ConvertType>(To)>...}};
+}
+
+template <size_t... From>
+constexpr std::array<std::array<ConvertRange, kConvertTypeCount>, kConvertTypeCount>
+kernelTable(std::index_sequence<From...> types) {
+  return {{kernelRow<static_cast<ConvertType>(From)>(types)...}};
+}
+
+template <size_t... Types> constexpr std::array<size_t, kConvertTypeCount> sizeTable(std::index_sequence<Types...>) {
+  return {{sizeof(typename Element<static_cast<ConvertType>(Types)>::type)...}};
+}
+
+// The kernel of every pair of types, indexed by source and target type
+constexpr auto kKernels = kernelTable(std::make_index_sequence<kConvertTypeCount>{});
+constexpr auto kSizes = sizeTable(std::make_index_sequence<kConvertTypeCount>{});
+
+} // namespace
+
+size_t convertTypeSize(ConvertType type) {
+  size_t index = static_cast<size_t>(type);
+  return index < kConvertTypeCount ? kSizes[index] : 0;
+}
+
+bool convertElements(ConvertType from, const void *src, ConvertType to, void *dst, size_t count) {
+  size_t from_index = static_cast<size_t>(from);
+  size_t to_index = static_cast<size_t>(to);
+  if (from_index >= kConvertTypeCount || to_index >= kConvertTypeCount) {
+    return false;
+  }
+  ConvertRange kernel = kKernels[from_index][to_index];
+
+  size_t num_threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), kMaxConvertThreads);
+  if (count < kParallelConvertThreshold || num_threads < 2) {
+    kernel(src, dst, 0, count);
+    return true;
+  }
+
+  // Chunks are multiples of 64 elements so every thread but the last runs full vectors
+  size_t chunk = ((count + num_threads - 1) / num_threads + 63) / 64 * 64;
+  std::vector<std::thread> workers;
+  for (size_t begin = chunk; begin < count; begin += chunk) {
+    workers.emplace_back(kernel, src, dst, begin, std::min(begin + chunk, count));
+  }
+  kernel(src, dst, 0, std::min(chunk, count));
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  return true;
+}
+
+uint16_t floatToFloat16Bits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+  uint32_t magnitude = bits & 0x7fffffff;
+
+  if (magnitude > 0x7f800000) {
+    // NaN stays a quiet NaN
+    return sign | 0x7e00;
+  }
+  if (magnitude >= 0x477ff000) {
+    // 65520 and above round to infinity
+    return sign | 0x7c00;
+  }
+  if (magnitude >= 0x38800000) {
+    // Normal in float16: rebias the exponent and round the dropped 13 mantissa bits to nearest even
+    uint32_t rounded = magnitude + 0xfff + ((magnitude >> 13) & 1);
+    return sign | static_cast<uint16_t>((rounded - (112u << 23)) >> 13);
+  }
+
+  // Subnormal in float16, in units of 2^-24
+  uint32_t exponent = magnitude >> 23;
+  uint32_t shift = 126 - exponent;
+  if (exponent == 0 || shift >= 32) {
+    return sign;
+  }
+  uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+  uint32_t result = mantissa >> shift;
+  uint32_t remainder = mantissa & ((1u << shift) - 1);
+  uint32_t halfway = 1u << (shift - 1);
+  if (remainder > halfway || (remainder == halfway && (result & 1))) {
+    result++;
+  }
+  return sign | static_cast<uint16_t>(result);
+}
+
+uint16_t floatToBFloat16Bits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  if ((bits & 0x7fffffff) > 0x7f800000) {
+    // NaN stays a quiet NaN
+    return static_cast<uint16_t>((bits >> 16) | 0x40);
+  }
+  return static_cast<uint16_t>((bits + 0x7fff + ((bits >> 16) & 1)) >> 16);
+}
+
+float float16BitsToFloat(uint16_t bits) {
+  uint32_t sign = static_cast<uint32_t>(bits & 0x8000) << 16;
+  uint32_t exponent = (bits >> 10) & 0x1f;
+  uint32_t mantissa = bits & 0x3ff;
+  uint32_t result;
+  if (exponent == 0x1f) {
+    // Infinity and NaN
+    result = sign | 0x7f800000 | (mantissa << 13);
+  } else if (exponent != 0) {
+    // Normal: rebias the exponent
+    result = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    result = sign;
+  } else {
+    // Subnormal in float16, normal in float: shift the leading 1 into the implicit bit
+    exponent = 113;
+    while ((mantissa & 0x400) == 0) {
+      mantissa <<= 1;
+      exponent--;
+    }
+    result = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+  }
+  float value;
+  std::memcpy(&value, &result, sizeof(value));
+  return value;
+}
+
+float bfloat16BitsToFloat(uint16_t bits) {
+  uint32_t result = static_cast<uint32_t>(bits) << 16;
+  float value;
+  std::memcpy(&value, &result, sizeof(value));
+  return value;
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,59 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_CONVERT_KERNELS_H_
+#define FLUTTER_ONNXRUNTIME_CONVERT_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace flutter_onnxruntime {
+
+// Element types handled by the conversion kernels
+enum class ConvertType {
+  kFloat32,
+  kFloat16,
+  kBFloat16,
+  kFloat64,
+  kInt8,
+  kUint8,
+  kInt16,
+  kUint16,
+  kInt32,
+  kUint32,
+  kInt64,
+  kUint64,
+  kBool
+};
+
+constexpr size_t kConvertTypeCount = static_cast<size_t>(ConvertType::kBool) + 1;
+
+// Inputs of at least this many elements are converted in chunks on several threads
+constexpr size_t kParallelConvertThreshold = 1 << 18;
+
+// Size in bytes of one element of a type
+size_t convertTypeSize(ConvertType type);
+
+// Convert count elements of src from one type to another into dst; returns false if a type is out of range.
+// Every type converts into every other one, and a type into itself is a copy. Floats round half away from zero
+// (in the arithmetic of the source, float16 and bfloat16 in float) when converted to integers and saturate, with
+// NaN as 0; float32 to int32 and int64 keep the truncation of the hardware for NaN and out-of-range values, which
+// the vector paths match. Integer targets saturate, bool maps to 0/1 and treats any non-zero value as true, and
+// float16/bfloat16 targets round to nearest even (float64 through float32).
+// Hot pairs have SSE2 (x86-64) and NEON (ARM64) paths that give bit-identical results to the scalar loops.
+bool convertElements(ConvertType from, const void *src, ConvertType to, void *dst, size_t count);
+
+// Round a float to the nearest float16 or bfloat16, ties to even, and return its bits
+uint16_t floatToFloat16Bits(float value);
+uint16_t floatToBFloat16Bits(float value);
+
+// Widen the bits of a float16 or bfloat16 to a float, which holds every value exactly
+float float16BitsToFloat(uint16_t bits);
+float bfloat16BitsToFloat(uint16_t bits);
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_CONVERT_KERNELS_H_
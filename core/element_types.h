@@ -0,0 +1,177 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_ELEMENT_TYPES_H_
+#define FLUTTER_ONNXRUNTIME_ELEMENT_TYPES_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "convert_kernels.h"
+
+namespace flutter_onnxruntime {
+
+// What the core knows about an ONNX element type at compile time. Types without a specialization are unknown;
+// strings and the complex types are named and sized, but cannot be created from bytes or converted.
+template <ONNXTensorElementDataType T> struct ElementTraits {
+  using type = void; // C++ type of an element, the bits for float16 and bfloat16
+  using wire = void; // element type of the list Dart receives for the tensor
+  static constexpr const char *kName = "unknown";
+  static constexpr size_t kSize = 0;
+  static constexpr bool kConvertible = false;
+  static constexpr ConvertType kConvertType = ConvertType::kFloat32;
+};
+
+// A type that lives in a plain buffer, which the conversion kernels read and write
+template <typename Type, ConvertType Convert, typename Wire = Type> struct ConvertibleTraits {
+  using type = Type;
+  using wire = Wire;
+  static constexpr size_t kSize = sizeof(Type);
+  static constexpr bool kConvertible = true;
+  static constexpr ConvertType kConvertType = Convert;
+};
+
+// A type the plugin only names and sizes
+template <size_t Size> struct OpaqueTraits {
+  using type = void;
+  using wire = void;
+  static constexpr size_t kSize = Size;
+  static constexpr bool kConvertible = false;
+  static constexpr ConvertType kConvertType = ConvertType::kFloat32;
+};
+
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT> : ConvertibleTraits<float, ConvertType::kFloat32> {
+  static constexpr const char *kName = "float32";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8> : ConvertibleTraits<uint8_t, ConvertType::kUint8> {
+  static constexpr const char *kName = "uint8";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8> : ConvertibleTraits<int8_t, ConvertType::kInt8, int32_t> {
+  static constexpr const char *kName = "int8";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16>
+    : ConvertibleTraits<uint16_t, ConvertType::kUint16, int32_t> {
+  static constexpr const char *kName = "uint16";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16> : ConvertibleTraits<int16_t, ConvertType::kInt16, int32_t> {
+  static constexpr const char *kName = "int16";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32> : ConvertibleTraits<int32_t, ConvertType::kInt32> {
+  static constexpr const char *kName = "int32";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64> : ConvertibleTraits<int64_t, ConvertType::kInt64> {
+  static constexpr const char *kName = "int64";
+};
+template <> struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING> : OpaqueTraits<0> {
+  using type = std::string;
+  using wire = std::string;
+  static constexpr const char *kName = "string";
+};
+template <> struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL> : ConvertibleTraits<bool, ConvertType::kBool> {
+  static constexpr const char *kName = "bool";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16>
+    : ConvertibleTraits<uint16_t, ConvertType::kFloat16, float> {
+  static constexpr const char *kName = "float16";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE> : ConvertibleTraits<double, ConvertType::kFloat64> {
+  static constexpr const char *kName = "float64";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32>
+    : ConvertibleTraits<uint32_t, ConvertType::kUint32, int64_t> {
+  static constexpr const char *kName = "uint32";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64>
+    : ConvertibleTraits<uint64_t, ConvertType::kUint64, int64_t> {
+  static constexpr const char *kName = "uint64";
+};
+template <> struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX64> : OpaqueTraits<8> {
+  static constexpr const char *kName = "complex64";
+};
+template <> struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX128> : OpaqueTraits<16> {
+  static constexpr const char *kName = "complex128";
+};
+template <>
+struct ElementTraits<ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16>
+    : ConvertibleTraits<uint16_t, ConvertType::kBFloat16, float> {
+  static constexpr const char *kName = "bfloat16";
+};
+
+// ElementTraits of one type, as a row of the table below
+struct ElementTypeInfo {
+  // Name of the type on the Dart side, e.g. "float32"
+  const char *name;
+
+  // Size in bytes of one element; 0 for strings and unknown types
+  size_t size;
+
+  // Whether tensors of the type live in a plain buffer that can be created from bytes and converted
+  bool convertible;
+
+  // Type of the conversion kernels, if convertible
+  ConvertType convert_type;
+};
+
+// Element types up to bfloat16, the last one the plugin names; later ones, such as the float8 types, are unknown
+constexpr size_t kElementTypeCount = static_cast<size_t>(ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16) + 1;
+
+namespace detail {
+
+template <size_t... Types>
+constexpr std::array<ElementTypeInfo, sizeof...(Types)> elementTypeTable(std::index_sequence<Types...>) {
+  return {{ElementTypeInfo{ElementTraits<static_cast<ONNXTensorElementDataType>(Types)>::kName,
+                           ElementTraits<static_cast<ONNXTensorElementDataType>(Types)>::kSize,
+                           ElementTraits<static_cast<ONNXTensorElementDataType>(Types)>::kConvertible,
+                           ElementTraits<static_cast<ONNXTensorElementDataType>(Types)>::kConvertType}...}};
+}
+
+} // namespace detail
+
+// ElementTypeInfo indexed by ONNXTensorElementDataType
+inline constexpr std::array<ElementTypeInfo, kElementTypeCount> kElementTypes =
+    detail::elementTypeTable(std::make_index_sequence<kElementTypeCount>{});
+
+// Index of a type in tables of kElementTypeCount entries; types beyond the table map to undefined
+constexpr size_t elementTypeIndex(ONNXTensorElementDataType element_type) {
+  size_t index = static_cast<size_t>(element_type);
+  return index < kElementTypeCount ? index : static_cast<size_t>(ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED);
+}
+
+constexpr const ElementTypeInfo &elementTypeInfo(ONNXTensorElementDataType element_type) {
+  return kElementTypes[elementTypeIndex(element_type)];
+}
+
+// Look up a type by its Dart name. This is the only place type names are compared: the method channel parses a
+// name once and everything behind it dispatches on the enum. Returns false for unknown names.
+inline bool parseElementType(std::string_view name, ONNXTensorElementDataType *element_type) {
+  for (size_t i = 1; i < kElementTypeCount; i++) {
+    if (name == kElementTypes[i].name) {
+      *element_type = static_cast<ONNXTensorElementDataType>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_ELEMENT_TYPES_H_
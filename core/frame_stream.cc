@@ -0,0 +1,189 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "frame_stream.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+bool isFixedShape(const std::vector<int64_t> &shape) {
+  for (int64_t dim : shape) {
+    if (dim < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+FrameStream::FrameStream(SessionHandle session_id, size_t depth, SessionManager &session_manager,
+                         TensorManager &tensor_manager)
+    : session_id_(session_id), session_manager_(session_manager), tensor_manager_(tensor_manager),
+      inputs_(session_manager.getInputInfo(session_id)), outputs_(session_manager.getOutputInfo(session_id)) {
+  if (depth == 0 || depth > kMaxStreamDepth) {
+    throw std::invalid_argument("Stream depth must be between 1 and " + std::to_string(kMaxStreamDepth));
+  }
+  if (inputs_.empty() || outputs_.empty()) {
+    throw std::invalid_argument("Session not found or without inputs and outputs");
+  }
+  for (const TensorInfo &input : inputs_) {
+    if (!isFixedShape(input.shape)) {
+      throw std::invalid_argument("Input " + input.name + " has a dynamic shape, which a stream cannot preallocate");
+    }
+    input_names_.push_back(input.name);
+  }
+  for (const TensorInfo &output : outputs_) {
+    output_names_.push_back(output.name);
+  }
+
+  slots_.resize(depth);
+  try {
+    for (Slot &slot : slots_) {
+      for (const TensorInfo &input : inputs_) {
+        slot.inputs.push_back(tensor_manager_.createEmptyTensor(input.element_type, input.shape));
+      }
+      for (const TensorInfo &output : outputs_) {
+        // Outputs of a type that cannot be preallocated, e.g. strings, are allocated by each run like dynamic ones
+        TensorHandle tensor = kInvalidHandle;
+        if (isFixedShape(output.shape)) {
+          try {
+            tensor = tensor_manager_.createEmptyTensor(output.element_type, output.shape);
+          } catch (const std::runtime_error &) {
+          }
+        }
+        slot.outputs.push_back(tensor);
+      }
+    }
+  } catch (const std::runtime_error &e) {
+    releaseTensors();
+    throw std::invalid_argument(std::string("Cannot preallocate the inputs of a stream: ") + e.what());
+  }
+}
+
+FrameStream::~FrameStream() { releaseTensors(); }
+
+void FrameStream::releaseTensors() {
+  for (Slot &slot : slots_) {
+    for (TensorHandle tensor : slot.inputs) {
+      tensor_manager_.releaseTensor(tensor);
+    }
+    for (TensorHandle tensor : slot.outputs) {
+      if (tensor != kInvalidHandle) {
+        tensor_manager_.releaseTensor(tensor);
+      }
+    }
+    for (TensorHandle tensor : slot.run_outputs) {
+      tensor_manager_.releaseTensor(tensor);
+    }
+    slot = Slot();
+  }
+}
+
+std::optional<size_t> FrameStream::acquireSlot() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < slots_.size(); i++) {
+    if (!slots_[i].busy) {
+      slots_[i].busy = true;
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+uint64_t FrameStream::numberFrame() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return next_frame_++;
+}
+
+void FrameStream::writeInput(size_t slot, const std::string &name, const void *data, size_t byte_size) {
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    if (input_names_[i] != name) {
+      continue;
+    }
+    void *tensor_data = nullptr;
+    size_t tensor_size = 0;
+    TensorLease lease = tensor_manager_.acquireTensorData(slots_[slot].inputs[i], &tensor_data, &tensor_size);
+    if (!lease || tensor_size != byte_size) {
+      throw std::invalid_argument("Input " + name + " of a stream needs " + std::to_string(tensor_size) +
+                                  " bytes, got " + std::to_string(byte_size));
+    }
+    std::memcpy(tensor_data, data, byte_size);
+    return;
+  }
+  throw std::invalid_argument("Stream has no input " + name);
+}
+
+std::vector<TensorHandle> FrameStream::run(size_t slot, Ort::RunOptions *run_options) {
+  Slot &frame_slot = slots_[slot];
+
+  std::vector<TensorLease> input_leases;
+  std::vector<const OrtValue *> input_values;
+  for (TensorHandle tensor : frame_slot.inputs) {
+    input_leases.push_back(tensor_manager_.acquireTensor(tensor));
+    input_values.push_back(input_leases.back().get());
+  }
+
+  // The preallocated outputs belong to the stream alone, so they are written without a lease
+  std::vector<OrtValue *> output_values;
+  for (TensorHandle tensor : frame_slot.outputs) {
+    Ort::Value *value = tensor != kInvalidHandle ? tensor_manager_.getTensor(tensor) : nullptr;
+    output_values.push_back(value != nullptr ? static_cast<OrtValue *>(*value) : nullptr);
+  }
+
+  session_manager_.runIntoOutputs(session_id_, input_values, input_names_, output_names_, output_values, run_options);
+
+  // Take ownership of every output the run allocated before storing any of them
+  std::vector<Ort::Value> allocated;
+  for (size_t i = 0; i < output_values.size(); i++) {
+    if (frame_slot.outputs[i] == kInvalidHandle) {
+      allocated.emplace_back(output_values[i]);
+    }
+  }
+
+  std::vector<TensorHandle> outputs = frame_slot.outputs;
+  size_t next_allocated = 0;
+  for (TensorHandle &output : outputs) {
+    if (output == kInvalidHandle) {
+      output = tensor_manager_.storeTensor(std::move(allocated[next_allocated++]));
+      frame_slot.run_outputs.push_back(output);
+    }
+  }
+  return outputs;
+}
+
+void FrameStream::releaseSlot(size_t slot) {
+  std::vector<TensorHandle> run_outputs;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    run_outputs.swap(slots_[slot].run_outputs);
+    slots_[slot].busy = false;
+  }
+  for (TensorHandle tensor : run_outputs) {
+    tensor_manager_.releaseTensor(tensor);
+  }
+}
+
+StreamHandle FrameStreamManager::addStream(std::shared_ptr<FrameStream> stream) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return streams_.insert(std::move(stream));
+}
+
+std::shared_ptr<FrameStream> FrameStreamManager::findStream(StreamHandle stream_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_ptr<FrameStream> *stream = streams_.find(stream_id);
+  return stream != nullptr ? *stream : nullptr;
+}
+
+bool FrameStreamManager::closeStream(StreamHandle stream_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return streams_.erase(stream_id);
+}
+
+} // namespace flutter_onnxruntime
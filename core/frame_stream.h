@@ -0,0 +1,114 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_FRAME_STREAM_H_
+#define FLUTTER_ONNXRUNTIME_FRAME_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "handle_table.h"
+#include "session_manager.h"
+#include "tensor_manager.h"
+
+namespace flutter_onnxruntime {
+
+// Largest number of frames a stream keeps in flight at once
+constexpr size_t kMaxStreamDepth = 8;
+
+// A ring of preallocated input and output tensors of a session, through which a sequence of frames runs without
+// allocating per frame. Each frame claims a free slot, has its inputs copied into the slot and runs on a worker,
+// so the upload of the next frame and the read back of the previous one overlap the run of the current one.
+// Thread safe; a claimed slot is only touched by the frame that claimed it.
+class FrameStream {
+public:
+  // Preallocate depth slots shaped from the input and output info of a session. Throws std::invalid_argument if an
+  // input has a dynamic dimension or is not a fixed-size tensor; outputs of a dynamic shape are allocated per run.
+  FrameStream(SessionHandle session_id, size_t depth, SessionManager &session_manager, TensorManager &tensor_manager);
+
+  // Release the tensors of every slot
+  ~FrameStream();
+
+  FrameStream(const FrameStream &) = delete;
+  FrameStream &operator=(const FrameStream &) = delete;
+
+  SessionHandle session() const { return session_id_; }
+  size_t depth() const { return slots_.size(); }
+  const std::vector<TensorInfo> &inputs() const { return inputs_; }
+  const std::vector<TensorInfo> &outputs() const { return outputs_; }
+
+  // Claim a free slot for a frame; returns nothing if every slot holds a frame in flight
+  std::optional<size_t> acquireSlot();
+
+  // Number the next frame whose inputs were written, counting from 0, so that frames rejected before they run
+  // leave no gap in the numbering
+  uint64_t numberFrame();
+
+  // Copy the element bytes of an input into a claimed slot. Throws std::invalid_argument if the stream has no such
+  // input or the size differs from that of its shape.
+  void writeInput(size_t slot, const std::string &name, const void *data, size_t byte_size);
+
+  // Run the session on the inputs of a claimed slot and return the handles of its outputs in output info order,
+  // which stay valid until the slot is released
+  std::vector<TensorHandle> run(size_t slot, Ort::RunOptions *run_options);
+
+  // Free a slot once its outputs have been read, releasing the outputs its run allocated
+  void releaseSlot(size_t slot);
+
+private:
+  struct Slot {
+    std::vector<TensorHandle> inputs;
+    // Preallocated outputs, or kInvalidHandle for an output of a dynamic shape
+    std::vector<TensorHandle> outputs;
+    // Outputs allocated by the last run, released with the slot
+    std::vector<TensorHandle> run_outputs;
+    bool busy = false;
+  };
+
+  // Release every tensor of the slots
+  void releaseTensors();
+
+  SessionHandle session_id_;
+  SessionManager &session_manager_;
+  TensorManager &tensor_manager_;
+  std::vector<TensorInfo> inputs_;
+  std::vector<TensorInfo> outputs_;
+  std::vector<std::string> input_names_;
+  std::vector<std::string> output_names_;
+
+  // Guards the busy flags and the frame counter
+  std::mutex mutex_;
+  std::vector<Slot> slots_;
+  uint64_t next_frame_ = 0;
+};
+
+// Handle of a stream stored in a FrameStreamManager
+using StreamHandle = Handle;
+
+class FrameStreamManager {
+public:
+  StreamHandle addStream(std::shared_ptr<FrameStream> stream);
+
+  // Get a stream, or nullptr if the handle is unknown
+  std::shared_ptr<FrameStream> findStream(StreamHandle stream_id);
+
+  // Remove a stream; frames in flight keep it alive until they finish. Returns false if the handle is unknown.
+  bool closeStream(StreamHandle stream_id);
+
+private:
+  std::mutex mutex_;
+  HandleTable<std::shared_ptr<FrameStream>> streams_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_FRAME_STREAM_H_
@@ -0,0 +1,173 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "generation.h"
+#include "convert_kernels.h"
+#include "element_types.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// Element type of a session input, or undefined if the session has no such input
+ONNXTensorElementDataType inputType(const std::vector<TensorInfo> &inputs, const std::string &name) {
+  for (const TensorInfo &input : inputs) {
+    if (input.name == name) {
+      return input.element_type;
+    }
+  }
+  return ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+}
+
+} // namespace
+
+Generation::Generation(SessionHandle session_id, std::vector<int64_t> prompt, GenerationOptions options,
+                       SessionManager &session_manager)
+    : session_id_(session_id), tokens_(std::move(prompt)), options_(std::move(options)),
+      session_manager_(session_manager), sampler_(options_.sampling, options_.seed) {
+  if (tokens_.empty()) {
+    throw std::invalid_argument("The prompt of a generation must hold at least one token");
+  }
+
+  std::vector<TensorInfo> inputs = session_manager.getInputInfo(session_id);
+  input_ids_type_ = inputType(inputs, options_.input_ids_name);
+  if (input_ids_type_ == ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED) {
+    throw std::invalid_argument("Session has no input " + options_.input_ids_name);
+  }
+  attention_mask_type_ = inputType(inputs, options_.attention_mask_name);
+  position_ids_type_ = inputType(inputs, options_.position_ids_name);
+
+  std::vector<std::string> output_names = session_manager.getOutputNames(session_id);
+  auto logits = std::find(output_names.begin(), output_names.end(), options_.logits_name);
+  if (logits == output_names.end()) {
+    throw std::invalid_argument("Session has no output " + options_.logits_name);
+  }
+  logits_index_ = logits - output_names.begin();
+}
+
+Ort::Value Generation::createRowTensor(ONNXTensorElementDataType element_type, const std::vector<int64_t> &values) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  int64_t shape[] = {1, static_cast<int64_t>(values.size())};
+  switch (element_type) {
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: {
+    Ort::Value tensor = Ort::Value::CreateTensor(allocator, shape, 2, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64);
+    std::copy(values.begin(), values.end(), tensor.GetTensorMutableData<int64_t>());
+    return tensor;
+  }
+  case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: {
+    Ort::Value tensor = Ort::Value::CreateTensor(allocator, shape, 2, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32);
+    int32_t *data = tensor.GetTensorMutableData<int32_t>();
+    for (size_t i = 0; i < values.size(); i++) {
+      data[i] = static_cast<int32_t>(values[i]);
+    }
+    return tensor;
+  }
+  default:
+    throw std::invalid_argument(std::string("Generation inputs must be int64 or int32 tensors, not ") +
+                                elementTypeInfo(element_type).name);
+  }
+}
+
+GenerationEnd Generation::run(const std::function<void(int64_t)> &on_token) {
+  // With a key/value cache every step after the prompt feeds only the token picked last
+  bool stateful = session_manager_.hasSequenceState(session_id_);
+  if (stateful) {
+    session_manager_.resetSequenceState(session_id_);
+  }
+
+  size_t cached = 0;
+  std::vector<float> logits_scratch;
+  for (size_t generated = 0; generated < options_.max_tokens; generated++) {
+    if (cancelled_) {
+      return GenerationEnd::kCancelled;
+    }
+
+    size_t first = stateful ? cached : 0;
+    std::vector<int64_t> step_tokens(tokens_.begin() + first, tokens_.end());
+
+    std::vector<Ort::Value> inputs;
+    std::vector<std::string> input_names;
+    inputs.push_back(createRowTensor(input_ids_type_, step_tokens));
+    input_names.push_back(options_.input_ids_name);
+    if (attention_mask_type_ != ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED) {
+      inputs.push_back(createRowTensor(attention_mask_type_, std::vector<int64_t>(tokens_.size(), 1)));
+      input_names.push_back(options_.attention_mask_name);
+    }
+    if (position_ids_type_ != ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED) {
+      std::vector<int64_t> positions(step_tokens.size());
+      for (size_t i = 0; i < positions.size(); i++) {
+        positions[i] = static_cast<int64_t>(first + i);
+      }
+      inputs.push_back(createRowTensor(position_ids_type_, positions));
+      input_names.push_back(options_.position_ids_name);
+    }
+
+    std::vector<Ort::Value> outputs = session_manager_.runInference(session_id_, inputs, input_names);
+    cached = tokens_.size();
+
+    // The last row of the logits scores the token after the sequence
+    Ort::Value &logits = outputs.at(logits_index_);
+    if (!logits) {
+      throw std::invalid_argument("Logits output " + options_.logits_name + " is fed back as sequence state");
+    }
+    Ort::TensorTypeAndShapeInfo info = logits.GetTensorTypeAndShapeInfo();
+    std::vector<int64_t> shape = info.GetShape();
+    size_t element_count = info.GetElementCount();
+    if (shape.empty() || shape.back() <= 0 || element_count == 0) {
+      throw std::invalid_argument("Logits output " + options_.logits_name + " is empty");
+    }
+    size_t vocab_size = static_cast<size_t>(shape.back());
+    size_t row_offset = element_count - vocab_size;
+
+    const float *row = nullptr;
+    ONNXTensorElementDataType element_type = info.GetElementType();
+    if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+      row = logits.GetTensorData<float>() + row_offset;
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+      logits_scratch.resize(vocab_size);
+      convertElements(ConvertType::kFloat16, logits.GetTensorData<uint16_t>() + row_offset, ConvertType::kFloat32,
+                      logits_scratch.data(), vocab_size);
+      row = logits_scratch.data();
+    } else {
+      throw std::invalid_argument("Logits output " + options_.logits_name + " must be float32 or float16");
+    }
+
+    int64_t token = sampler_.sample(row, vocab_size);
+    tokens_.push_back(token);
+    on_token(token);
+    if (std::find(options_.stop_tokens.begin(), options_.stop_tokens.end(), token) != options_.stop_tokens.end()) {
+      return GenerationEnd::kStopToken;
+    }
+  }
+  return GenerationEnd::kMaxTokens;
+}
+
+GenerationHandle GenerationManager::addGeneration(std::shared_ptr<Generation> generation) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return generations_.insert(std::move(generation));
+}
+
+std::shared_ptr<Generation> GenerationManager::findGeneration(GenerationHandle generation_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_ptr<Generation> *generation = generations_.find(generation_id);
+  return generation != nullptr ? *generation : nullptr;
+}
+
+void GenerationManager::removeGeneration(GenerationHandle generation_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  generations_.erase(generation_id);
+}
+
+void GenerationManager::cancelAll() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  generations_.forEach([](GenerationHandle, std::shared_ptr<Generation> &generation) { generation->cancel(); });
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,110 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_GENERATION_H_
+#define FLUTTER_ONNXRUNTIME_GENERATION_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <vector>
+
+#include "handle_table.h"
+#include "session_manager.h"
+#include "token_sampler.h"
+
+namespace flutter_onnxruntime {
+
+// Inputs and outputs of a decoder that a Generation feeds and reads, and when it stops
+struct GenerationOptions {
+  // Token ids, attention mask and position ids inputs; the mask and position ids are only fed if the session has them
+  std::string input_ids_name = "input_ids";
+  std::string attention_mask_name = "attention_mask";
+  std::string position_ids_name = "position_ids";
+  // Output of shape [..., vocabulary size] whose last row scores the next token, in float32 or float16
+  std::string logits_name = "logits";
+
+  // Largest number of tokens generated
+  size_t max_tokens = 128;
+  // Tokens that end the generation, such as the end-of-sequence token, which is still emitted
+  std::vector<int64_t> stop_tokens;
+
+  SamplingOptions sampling;
+  uint64_t seed = 0;
+};
+
+// Why a generation ended
+enum class GenerationEnd { kStopToken, kMaxTokens, kCancelled };
+
+// The decode loop of a generative model, run natively so that a whole generation costs one call instead of one per
+// token. On a session with sequence state only the new token is fed at each step after the prompt, since the key/value
+// cache holds the rest; otherwise the whole sequence is fed again. Only one generation at a time may use a session.
+class Generation {
+public:
+  // Throws std::invalid_argument if the prompt is empty or the session has no such input ids or logits
+  Generation(SessionHandle session_id, std::vector<int64_t> prompt, GenerationOptions options,
+             SessionManager &session_manager);
+
+  Generation(const Generation &) = delete;
+  Generation &operator=(const Generation &) = delete;
+
+  // Run the loop on the calling thread, calling on_token with each token as soon as it is picked. A session with
+  // sequence state starts again from its initial state. Throws Ort::Exception or std::invalid_argument if a step
+  // fails.
+  GenerationEnd run(const std::function<void(int64_t)> &on_token);
+
+  // Stop the loop before its next step; callable from any thread
+  void cancel() { cancelled_ = true; }
+
+private:
+  // Tensor of shape [1, count] holding values in the element type of an input, int64 or int32
+  Ort::Value createRowTensor(ONNXTensorElementDataType element_type, const std::vector<int64_t> &values);
+
+  SessionHandle session_id_;
+  std::vector<int64_t> tokens_;
+  GenerationOptions options_;
+  SessionManager &session_manager_;
+  TokenSampler sampler_;
+
+  // Element types of the fed inputs, undefined for the mask and position ids if the session lacks them
+  ONNXTensorElementDataType input_ids_type_ = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  ONNXTensorElementDataType attention_mask_type_ = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  ONNXTensorElementDataType position_ids_type_ = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  size_t logits_index_ = 0;
+
+  std::atomic<bool> cancelled_{false};
+};
+
+// Handle of a generation stored in a GenerationManager
+using GenerationHandle = Handle;
+
+// Generations in flight, so that Dart can cancel them by handle
+class GenerationManager {
+public:
+  GenerationHandle addGeneration(std::shared_ptr<Generation> generation);
+
+  // Get a generation, or nullptr if the handle is unknown or it has finished
+  std::shared_ptr<Generation> findGeneration(GenerationHandle generation_id);
+
+  // Forget a finished generation
+  void removeGeneration(GenerationHandle generation_id);
+
+  // Cancel every generation in flight, so that the workers running them can be joined soon
+  void cancelAll();
+
+private:
+  std::mutex mutex_;
+  HandleTable<std::shared_ptr<Generation>> generations_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_GENERATION_H_
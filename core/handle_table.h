@@ -0,0 +1,167 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_HANDLE_TABLE_H_
+#define FLUTTER_ONNXRUNTIME_HANDLE_TABLE_H_
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace flutter_onnxruntime {
+
+// 64-bit ID of an object stored in a HandleTable.
+// The low 32 bits hold the slot index plus one and the high bits the generation of the slot, so a handle
+// that outlives its object no longer matches once the slot is reused. Generations stay below 2^31 so that
+// handles are always positive when sent to Dart as an int.
+using Handle = uint64_t;
+
+// Never returned by a HandleTable
+constexpr Handle kInvalidHandle = 0;
+
+// Slot table that stores objects by Handle.
+// Lookups index straight into a vector instead of hashing a string ID, and freed slots are reused.
+// Not thread safe; the owning manager serializes access.
+template <typename T> class HandleTable {
+public:
+  // Store a value and return its handle
+  Handle insert(T &&value) {
+    uint32_t index;
+    if (!free_slots_.empty()) {
+      index = free_slots_.back();
+      free_slots_.pop_back();
+    } else {
+      index = static_cast<uint32_t>(slots_.size());
+      slots_.emplace_back();
+    }
+
+    Slot &slot = slots_[index];
+    slot.value.emplace(std::move(value));
+    size_++;
+    return (static_cast<Handle>(slot.generation) << 32) | (static_cast<Handle>(index) + 1);
+  }
+
+  // Get the value of a handle, or nullptr if the handle is unknown or stale
+  T *find(Handle handle) {
+    Slot *slot = slotFor(handle);
+    return slot ? &*slot->value : nullptr;
+  }
+
+  // Get the value of a handle; throws std::out_of_range if the handle is unknown or stale
+  T &at(Handle handle) {
+    T *value = find(handle);
+    if (value == nullptr) {
+      throw std::out_of_range("Unknown handle: " + std::to_string(handle));
+    }
+    return *value;
+  }
+
+  // Remove the value of a handle and return it; std::nullopt if the handle is unknown or stale
+  std::optional<T> take(Handle handle) {
+    Slot *slot = slotFor(handle);
+    if (slot == nullptr) {
+      return std::nullopt;
+    }
+
+    std::optional<T> value(std::move(*slot->value));
+    freeSlot(handle, *slot);
+    return value;
+  }
+
+  // Destroy the value of a handle; returns false if the handle is unknown or stale
+  bool erase(Handle handle) {
+    Slot *slot = slotFor(handle);
+    if (slot == nullptr) {
+      return false;
+    }
+    freeSlot(handle, *slot);
+    return true;
+  }
+
+  // Destroy all values; handles issued so far stay invalid
+  void clear() {
+    for (size_t i = 0; i < slots_.size(); i++) {
+      if (slots_[i].value) {
+        freeSlot((static_cast<Handle>(slots_[i].generation) << 32) | (i + 1), slots_[i]);
+      }
+    }
+  }
+
+  // Call fn(handle, value) for every stored value
+  template <typename Fn> void forEach(Fn fn) {
+    for (size_t i = 0; i < slots_.size(); i++) {
+      if (slots_[i].value) {
+        fn((static_cast<Handle>(slots_[i].generation) << 32) | (i + 1), *slots_[i].value);
+      }
+    }
+  }
+
+  // Number of stored values
+  size_t size() const { return size_; }
+
+private:
+  struct Slot {
+    std::optional<T> value;
+    uint32_t generation = 1;
+  };
+
+  static constexpr uint32_t kMaxGeneration = 0x7fffffff;
+
+  Slot *slotFor(Handle handle) {
+    uint64_t index = handle & 0xffffffff;
+    if (index == 0 || index > slots_.size()) {
+      return nullptr;
+    }
+    Slot &slot = slots_[index - 1];
+    if (!slot.value || slot.generation != (handle >> 32)) {
+      return nullptr;
+    }
+    return &slot;
+  }
+
+  void freeSlot(Handle handle, Slot &slot) {
+    slot.value.reset();
+    // Bump the generation so the old handle no longer matches
+    slot.generation = slot.generation == kMaxGeneration ? 1 : slot.generation + 1;
+    free_slots_.push_back(static_cast<uint32_t>((handle & 0xffffffff) - 1));
+    size_--;
+  }
+
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> free_slots_;
+  size_t size_ = 0;
+};
+
+// Format a handle as the string ID sent to Dart when integer handles are disabled, e.g. "tensor_4294967297"
+inline std::string formatHandle(const char *prefix, Handle handle) { return prefix + std::to_string(handle); }
+
+// Parse a string ID produced by formatHandle; returns kInvalidHandle if it does not match the prefix
+inline Handle parseHandle(const char *prefix, const std::string &id) {
+  std::string_view view(id);
+  std::string_view prefix_view(prefix);
+  if (view.substr(0, prefix_view.size()) != prefix_view) {
+    return kInvalidHandle;
+  }
+
+  Handle handle = kInvalidHandle;
+  const char *begin = view.data() + prefix_view.size();
+  const char *end = view.data() + view.size();
+  auto [ptr, ec] = std::from_chars(begin, end, handle);
+  if (ec != std::errc() || ptr != end) {
+    return kInvalidHandle;
+  }
+  return handle;
+}
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_HANDLE_TABLE_H_
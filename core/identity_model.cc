@@ -0,0 +1,73 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "identity_model.h"
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// Protobuf wire types of the fields written below
+constexpr uint32_t kVarint = 0;
+constexpr uint32_t kLengthDelimited = 2;
+
+void writeVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+void writeVarintField(std::string &out, uint32_t field, uint64_t value) {
+  writeVarint(out, (field << 3) | kVarint);
+  writeVarint(out, value);
+}
+
+// A string, bytes or embedded message field
+void writeBytesField(std::string &out, uint32_t field, const std::string &bytes) {
+  writeVarint(out, (field << 3) | kLengthDelimited);
+  writeVarint(out, bytes.size());
+  out += bytes;
+}
+
+// ValueInfoProto of a tensor without a shape, i.e. of any rank
+std::string tensorValueInfo(const char *name, int32_t element_type) {
+  std::string tensor_type;
+  writeVarintField(tensor_type, 1, static_cast<uint64_t>(element_type)); // TypeProto.Tensor.elem_type
+  std::string type;
+  writeBytesField(type, 1, tensor_type); // TypeProto.tensor_type
+  std::string value_info;
+  writeBytesField(value_info, 1, name); // ValueInfoProto.name
+  writeBytesField(value_info, 2, type); // ValueInfoProto.type
+  return value_info;
+}
+
+} // namespace
+
+std::string buildIdentityModel(int32_t element_type) {
+  std::string node;
+  writeBytesField(node, 1, kIdentityInputName);  // NodeProto.input
+  writeBytesField(node, 2, kIdentityOutputName); // NodeProto.output
+  writeBytesField(node, 4, "Identity");          // NodeProto.op_type
+
+  std::string graph;
+  writeBytesField(graph, 1, node);                                               // GraphProto.node
+  writeBytesField(graph, 2, "identity");                                         // GraphProto.name
+  writeBytesField(graph, 11, tensorValueInfo(kIdentityInputName, element_type));  // GraphProto.input
+  writeBytesField(graph, 12, tensorValueInfo(kIdentityOutputName, element_type)); // GraphProto.output
+
+  std::string opset;
+  writeVarintField(opset, 2, 13); // OperatorSetIdProto.version of the default domain
+
+  std::string model;
+  writeVarintField(model, 1, 7);   // ModelProto.ir_version
+  writeBytesField(model, 7, graph); // ModelProto.graph
+  writeBytesField(model, 8, opset); // ModelProto.opset_import
+  return model;
+}
+
+} // namespace flutter_onnxruntime
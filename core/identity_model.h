@@ -0,0 +1,26 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_IDENTITY_MODEL_H_
+#define FLUTTER_ONNXRUNTIME_IDENTITY_MODEL_H_
+
+#include <cstdint>
+#include <string>
+
+namespace flutter_onnxruntime {
+
+// Name of the input and of the output of an identity model
+constexpr const char *kIdentityInputName = "x";
+constexpr const char *kIdentityOutputName = "y";
+
+// Serialize an ONNX model whose only node is an Identity of a tensor of any rank with an element type, given as its
+// ONNX TensorProto.DataType value. Running it with the input and output bound to different devices makes ONNX
+// Runtime copy a tensor between them, which its C API offers no other way to do.
+std::string buildIdentityModel(int32_t element_type);
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_IDENTITY_MODEL_H_
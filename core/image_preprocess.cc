@@ -0,0 +1,235 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "image_preprocess.h"
+#include "convert_kernels.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// More threads do not help a memory-bound loop
+constexpr size_t kMaxImageThreads = 4;
+
+// Everything a band of rows needs, computed once per image
+struct ImageJob {
+  const ImageTensorOptions *options;
+  const uint8_t *src;
+  void *dst;
+  int out_width;
+  int out_height;
+  bool resize;
+  // scale * pixel + bias normalizes a channel
+  float scale[3];
+  float bias[3];
+  // Bilinear source columns and weights of every output column
+  std::vector<int> x0;
+  std::vector<int> x1;
+  std::vector<float> wx;
+};
+
+inline float clampPixel(float value) { return value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value); }
+
+// Read the RGB values of one source pixel
+template <ImageFormat F> inline void loadPixel(const uint8_t *src, int width, int height, int x, int y, float *rgb) {
+  if constexpr (F == ImageFormat::kNv21) {
+    // Full-range BT.601, as produced by Android cameras
+    float luma = src[static_cast<size_t>(y) * width + x];
+    size_t chroma_stride = 2 * static_cast<size_t>((width + 1) / 2);
+    const uint8_t *vu = src + static_cast<size_t>(width) * height + (y / 2) * chroma_stride + (x / 2) * 2;
+    float v = vu[0] - 128.0f;
+    float u = vu[1] - 128.0f;
+    rgb[0] = clampPixel(luma + 1.402f * v);
+    rgb[1] = clampPixel(luma - 0.344136f * u - 0.714136f * v);
+    rgb[2] = clampPixel(luma + 1.772f * u);
+  } else {
+    constexpr int channels = (F == ImageFormat::kRgba || F == ImageFormat::kBgra) ? 4 : 3;
+    constexpr bool swap = F == ImageFormat::kBgra || F == ImageFormat::kBgr;
+    const uint8_t *pixel = src + (static_cast<size_t>(y) * width + x) * channels;
+    rgb[0] = pixel[swap ? 2 : 0];
+    rgb[1] = pixel[1];
+    rgb[2] = pixel[swap ? 0 : 2];
+  }
+}
+
+// Write one normalized row, held as three channel planes, in the tensor layout and element type
+void storeRow(const ImageJob &job, int y, const float *const *planes) {
+  size_t width = static_cast<size_t>(job.out_width);
+  size_t plane_size = width * static_cast<size_t>(job.out_height);
+  size_t row = static_cast<size_t>(y) * width;
+
+  if (job.options->half_precision) {
+    uint16_t *out = static_cast<uint16_t *>(job.dst);
+    for (int c = 0; c < 3; c++) {
+      for (size_t x = 0; x < width; x++) {
+        uint16_t bits = floatToFloat16Bits(planes[c][x]);
+        out[job.options->channels_first ? c * plane_size + row + x : (row + x) * 3 + c] = bits;
+      }
+    }
+    return;
+  }
+
+  float *out = static_cast<float *>(job.dst);
+  if (job.options->channels_first) {
+    for (int c = 0; c < 3; c++) {
+      std::copy(planes[c], planes[c] + width, out + c * plane_size + row);
+    }
+  } else {
+    float *pixel = out + row * 3;
+    for (size_t x = 0; x < width; x++) {
+      pixel[x * 3] = planes[0][x];
+      pixel[x * 3 + 1] = planes[1][x];
+      pixel[x * 3 + 2] = planes[2][x];
+    }
+  }
+}
+
+template <ImageFormat F> void processRows(const ImageJob &job, int row_begin, int row_end) {
+  const int width = job.options->width;
+  const int height = job.options->height;
+  const size_t out_width = static_cast<size_t>(job.out_width);
+  std::vector<float> scratch(out_width * 3);
+  float *planes[3] = {scratch.data(), scratch.data() + out_width, scratch.data() + out_width * 2};
+  const float y_scale = static_cast<float>(height) / job.out_height;
+
+  for (int y = row_begin; y < row_end; y++) {
+    // Source row band of this output row, with pixel centers aligned like OpenCV's INTER_LINEAR
+    int y0 = y;
+    int y1 = y;
+    float wy = 0.0f;
+    if (job.resize) {
+      float sy = std::max((y + 0.5f) * y_scale - 0.5f, 0.0f);
+      y0 = std::min(static_cast<int>(sy), height - 1);
+      y1 = std::min(y0 + 1, height - 1);
+      wy = sy - y0;
+    }
+
+    for (size_t x = 0; x < out_width; x++) {
+      float rgb[3];
+      if (job.resize) {
+        float p00[3], p01[3], p10[3], p11[3];
+        loadPixel<F>(job.src, width, height, job.x0[x], y0, p00);
+        loadPixel<F>(job.src, width, height, job.x1[x], y0, p01);
+        loadPixel<F>(job.src, width, height, job.x0[x], y1, p10);
+        loadPixel<F>(job.src, width, height, job.x1[x], y1, p11);
+        float wx = job.wx[x];
+        for (int c = 0; c < 3; c++) {
+          float top = p00[c] + (p01[c] - p00[c]) * wx;
+          float bottom = p10[c] + (p11[c] - p10[c]) * wx;
+          rgb[c] = top + (bottom - top) * wy;
+        }
+      } else {
+        loadPixel<F>(job.src, width, height, static_cast<int>(x), y, rgb);
+      }
+      planes[0][x] = rgb[0] * job.scale[0] + job.bias[0];
+      planes[1][x] = rgb[1] * job.scale[1] + job.bias[1];
+      planes[2][x] = rgb[2] * job.scale[2] + job.bias[2];
+    }
+    storeRow(job, y, planes);
+  }
+}
+
+using ProcessRows = void (*)(const ImageJob &job, int row_begin, int row_end);
+
+ProcessRows lookupProcessRows(ImageFormat format) {
+  switch (format) {
+  case ImageFormat::kRgba:
+    return processRows<ImageFormat::kRgba>;
+  case ImageFormat::kBgra:
+    return processRows<ImageFormat::kBgra>;
+  case ImageFormat::kRgb:
+    return processRows<ImageFormat::kRgb>;
+  case ImageFormat::kBgr:
+    return processRows<ImageFormat::kBgr>;
+  case ImageFormat::kNv21:
+    return processRows<ImageFormat::kNv21>;
+  }
+  return processRows<ImageFormat::kRgba>;
+}
+
+} // namespace
+
+bool parseImageFormat(const std::string &name, ImageFormat *format) {
+  static const std::map<std::string, ImageFormat> formats = {
+      {"rgba", ImageFormat::kRgba}, {"bgra", ImageFormat::kBgra}, {"rgb", ImageFormat::kRgb},
+      {"bgr", ImageFormat::kBgr},   {"nv21", ImageFormat::kNv21},
+  };
+
+  auto it = formats.find(name);
+  if (it == formats.end()) {
+    return false;
+  }
+  *format = it->second;
+  return true;
+}
+
+size_t imageByteSize(ImageFormat format, int width, int height) {
+  size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+  switch (format) {
+  case ImageFormat::kRgba:
+  case ImageFormat::kBgra:
+    return pixels * 4;
+  case ImageFormat::kRgb:
+  case ImageFormat::kBgr:
+    return pixels * 3;
+  case ImageFormat::kNv21:
+    return pixels + 2 * static_cast<size_t>((width + 1) / 2) * static_cast<size_t>((height + 1) / 2);
+  }
+  return 0;
+}
+
+void preprocessImage(const ImageTensorOptions &options, const uint8_t *src, void *dst) {
+  ImageJob job;
+  job.options = &options;
+  job.src = src;
+  job.dst = dst;
+  job.out_width = options.target_width > 0 ? options.target_width : options.width;
+  job.out_height = options.target_height > 0 ? options.target_height : options.height;
+  job.resize = job.out_width != options.width || job.out_height != options.height;
+  for (int c = 0; c < 3; c++) {
+    job.scale[c] = 1.0f / (255.0f * options.std[c]);
+    job.bias[c] = -options.mean[c] / options.std[c];
+  }
+
+  if (job.resize) {
+    const float x_scale = static_cast<float>(options.width) / job.out_width;
+    job.x0.resize(job.out_width);
+    job.x1.resize(job.out_width);
+    job.wx.resize(job.out_width);
+    for (int x = 0; x < job.out_width; x++) {
+      float sx = std::max((x + 0.5f) * x_scale - 0.5f, 0.0f);
+      job.x0[x] = std::min(static_cast<int>(sx), options.width - 1);
+      job.x1[x] = std::min(job.x0[x] + 1, options.width - 1);
+      job.wx[x] = sx - job.x0[x];
+    }
+  }
+
+  ProcessRows process = lookupProcessRows(options.format);
+  size_t pixels = static_cast<size_t>(job.out_width) * static_cast<size_t>(job.out_height);
+  size_t num_threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), kMaxImageThreads);
+  num_threads = std::min<size_t>(num_threads, static_cast<size_t>(job.out_height));
+  if (pixels < kParallelImageThreshold || num_threads < 2) {
+    process(job, 0, job.out_height);
+    return;
+  }
+
+  int band = static_cast<int>((job.out_height + num_threads - 1) / num_threads);
+  std::vector<std::thread> workers;
+  for (int begin = band; begin < job.out_height; begin += band) {
+    workers.emplace_back(process, std::cref(job), begin, std::min(begin + band, job.out_height));
+  }
+  process(job, 0, std::min(band, job.out_height));
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,51 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_IMAGE_PREPROCESS_H_
+#define FLUTTER_ONNXRUNTIME_IMAGE_PREPROCESS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace flutter_onnxruntime {
+
+// Pixel layouts of the images accepted by the preprocessing stage
+enum class ImageFormat { kRgba, kBgra, kRgb, kBgr, kNv21 };
+
+// Images with at least this many output pixels are processed in row bands on several threads
+constexpr size_t kParallelImageThreshold = 1 << 16;
+
+// How to turn an image into a normalized 3-channel RGB tensor
+struct ImageTensorOptions {
+  ImageFormat format = ImageFormat::kRgba;
+  int width = 0;
+  int height = 0;
+  // Size of the tensor image, resized with bilinear filtering; 0 keeps the source size
+  int target_width = 0;
+  int target_height = 0;
+  // Per-channel (R, G, B) mean and standard deviation of pixel values scaled to [0, 1]
+  float mean[3] = {0.0f, 0.0f, 0.0f};
+  float std[3] = {1.0f, 1.0f, 1.0f};
+  // NCHW if true, otherwise NHWC
+  bool channels_first = true;
+  // float16 elements if true, otherwise float32
+  bool half_precision = false;
+};
+
+// Parse a format name ("rgba", "bgra", "rgb", "bgr" or "nv21"); returns false if it is unknown
+bool parseImageFormat(const std::string &name, ImageFormat *format);
+
+// Number of bytes of an image; NV21 is a full-size Y plane followed by interleaved V/U at half resolution
+size_t imageByteSize(ImageFormat format, int width, int height);
+
+// Resize, convert to RGB, normalize and lay out an image in one pass over its pixels into dst, which holds
+// 3 * output width * output height elements. The options must be valid and src must hold imageByteSize bytes.
+void preprocessImage(const ImageTensorOptions &options, const uint8_t *src, void *dst);
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_IMAGE_PREPROCESS_H_
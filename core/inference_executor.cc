@@ -0,0 +1,214 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "inference_executor.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace flutter_onnxruntime {
+
+thread_local InferenceExecutor::JobControl *InferenceExecutor::current_job_ = nullptr;
+
+RunScope::RunScope(std::function<void()> terminate) {
+  InferenceExecutor::JobControl *job = InferenceExecutor::current_job_;
+  if (job != nullptr) {
+    job->run->attach(std::move(terminate));
+  }
+}
+
+RunScope::~RunScope() {
+  InferenceExecutor::JobControl *job = InferenceExecutor::current_job_;
+  if (job != nullptr) {
+    job->run->detach();
+  }
+}
+
+RunStop RunScope::stopReason() {
+  InferenceExecutor::JobControl *job = InferenceExecutor::current_job_;
+  return job != nullptr ? job->run->reason() : RunStop::kNone;
+}
+
+InferenceExecutor::InferenceExecutor(size_t num_threads)
+    : target_threads_(num_threads > 0 ? num_threads : 1), active_threads_(0), busy_threads_(0), stopping_(false) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  spawnWorkersLocked();
+}
+
+InferenceExecutor::~InferenceExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+
+  // Workers drain the remaining jobs before exiting
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+void InferenceExecutor::submit(std::function<void()> job, JobPriority priority, std::shared_ptr<RunControl> run) {
+  auto control = std::make_shared<JobControl>();
+  control->priority = priority;
+  control->submit_nanos = steadyNanos();
+  control->run = run ? std::move(run) : std::make_shared<RunControl>();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t index = static_cast<size_t>(priority);
+    jobs_[index].push(QueuedJob{std::move(job), std::move(control)});
+    counters_[index].submitted++;
+
+    // A high-priority job that no idle worker can take frees one by terminating the oldest low-priority run
+    size_t idle_threads = active_threads_ > busy_threads_ ? active_threads_ - busy_threads_ : 0;
+    if (priority == JobPriority::kHigh && jobs_[index].size() > idle_threads) {
+      for (const auto &running : running_low_) {
+        if (running->run->stop(RunStop::kPreempted)) {
+          counters_[static_cast<size_t>(JobPriority::kLow)].preempted++;
+          break;
+        }
+      }
+    }
+  }
+  cv_.notify_one();
+}
+
+size_t InferenceExecutor::cancelLowPriority() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = 0;
+  for (const auto &running : running_low_) {
+    count += running->run->stop(RunStop::kPreempted) ? 1 : 0;
+  }
+
+  // Queued jobs still run, so that they can report the cancellation, but fail as soon as they start
+  std::queue<QueuedJob> &queued = jobs_[static_cast<size_t>(JobPriority::kLow)];
+  for (size_t i = 0; i < queued.size(); i++) {
+    QueuedJob job = std::move(queued.front());
+    queued.pop();
+    count += job.control->run->stop(RunStop::kPreempted) ? 1 : 0;
+    queued.push(std::move(job));
+  }
+  counters_[static_cast<size_t>(JobPriority::kLow)].preempted += count;
+  return count;
+}
+
+std::array<JobQueueStats, kJobPriorityCount> InferenceExecutor::getQueueStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::array<JobQueueStats, kJobPriorityCount> stats;
+  for (size_t i = 0; i < kJobPriorityCount; i++) {
+    const PriorityCounters &counters = counters_[i];
+    stats[i].queued = jobs_[i].size();
+    stats[i].submitted = counters.submitted;
+    stats[i].started = counters.started;
+    stats[i].preempted = counters.preempted;
+    stats[i].wait_micros = counters.wait_nanos / 1000;
+    stats[i].max_wait_micros = counters.max_wait_micros;
+    stats[i].p50_wait_micros = counters.wait_latency.percentile(0.5);
+    stats[i].p90_wait_micros = counters.wait_latency.percentile(0.9);
+    stats[i].p99_wait_micros = counters.wait_latency.percentile(0.99);
+  }
+  return stats;
+}
+
+void InferenceExecutor::setNumThreads(size_t num_threads) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    target_threads_ = num_threads > 0 ? num_threads : 1;
+    spawnWorkersLocked();
+  }
+  // Wake idle workers so that surplus ones can retire
+  cv_.notify_all();
+}
+
+size_t InferenceExecutor::getNumThreads() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return target_threads_;
+}
+
+void InferenceExecutor::spawnWorkersLocked() {
+  // A retired worker pushed its ID with mutex_ held and exits right after unlocking it, so joining only waits for that
+  for (std::thread::id worker_id : retired_workers_) {
+    auto worker = std::find_if(workers_.begin(), workers_.end(),
+                               [worker_id](const std::thread &thread) { return thread.get_id() == worker_id; });
+    if (worker != workers_.end()) {
+      worker->join();
+      workers_.erase(worker);
+    }
+  }
+  retired_workers_.clear();
+
+  while (active_threads_ < target_threads_) {
+    workers_.emplace_back(&InferenceExecutor::workerLoop, this);
+    active_threads_++;
+  }
+}
+
+void InferenceExecutor::workerLoop() {
+  auto has_jobs = [this] {
+    return std::any_of(jobs_.begin(), jobs_.end(), [](const std::queue<QueuedJob> &queue) { return !queue.empty(); });
+  };
+
+  while (true) {
+    QueuedJob job;
+    bool preemptible = false;
+    std::list<std::shared_ptr<JobControl>>::iterator running_low;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this, &has_jobs] { return stopping_ || has_jobs() || active_threads_ > target_threads_; });
+
+      // Retire this worker when the pool has been shrunk; it is joined on the next resize or at destruction
+      if (!stopping_ && active_threads_ > target_threads_) {
+        active_threads_--;
+        retired_workers_.push_back(std::this_thread::get_id());
+        return;
+      }
+
+      if (!has_jobs()) {
+        // Only reachable when stopping and all jobs are drained
+        return;
+      }
+
+      // Take the oldest job of the highest priority that has one
+      auto queue = std::find_if(jobs_.begin(), jobs_.end(),
+                                [](const std::queue<QueuedJob> &pending) { return !pending.empty(); });
+      job = std::move(queue->front());
+      queue->pop();
+      busy_threads_++;
+
+      PriorityCounters &counters = counters_[static_cast<size_t>(job.control->priority)];
+      uint64_t wait_nanos = steadyNanos() - job.control->submit_nanos;
+      uint64_t wait_micros = wait_nanos / 1000;
+      counters.started++;
+      counters.wait_nanos += wait_nanos;
+      counters.max_wait_micros = std::max(counters.max_wait_micros, wait_micros);
+      counters.wait_latency.record(wait_micros);
+      if (job.control->priority == JobPriority::kLow) {
+        running_low = running_low_.insert(running_low_.end(), job.control);
+        preemptible = true;
+      }
+    }
+
+    current_job_ = job.control.get();
+    try {
+      job.run();
+    } catch (const std::exception &e) {
+      std::cerr << "Inference job failed: " << e.what() << std::endl;
+    } catch (...) {
+      std::cerr << "Inference job failed with unknown error" << std::endl;
+    }
+    current_job_ = nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    busy_threads_--;
+    if (preemptible) {
+      running_low_.erase(running_low);
+    }
+  }
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,158 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_INFERENCE_EXECUTOR_H_
+#define FLUTTER_ONNXRUNTIME_INFERENCE_EXECUTOR_H_
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "run_control.h"
+#include "session_stats.h"
+
+namespace flutter_onnxruntime {
+
+// Default number of worker threads used to run inference off the platform thread
+constexpr size_t kDefaultInferenceThreads = 2;
+
+// Number of worker threads that load models and warm up new sessions. Kept apart from the inference
+// workers so that a slow load never delays runs of sessions that are already open.
+constexpr size_t kSessionLoaderThreads = 1;
+
+// Scheduling class of a job. Workers always take the oldest job of the highest class first; a high-priority job
+// that finds every worker busy preempts a running low-priority one.
+enum class JobPriority { kHigh = 0, kNormal = 1, kLow = 2 };
+
+constexpr size_t kJobPriorityCount = 3;
+
+// Counters of the jobs of one priority, read at one point in time
+struct JobQueueStats {
+  // Jobs waiting for a worker
+  size_t queued = 0;
+  uint64_t submitted = 0;
+  uint64_t started = 0;
+  // Jobs terminated by a higher-priority job or by cancelLowPriority()
+  uint64_t preempted = 0;
+  // Time from submit() until a worker started the job, in microseconds
+  uint64_t wait_micros = 0;
+  uint64_t max_wait_micros = 0;
+  uint64_t p50_wait_micros = 0;
+  uint64_t p90_wait_micros = 0;
+  uint64_t p99_wait_micros = 0;
+};
+
+// Attaches terminate, typically RunOptions::SetTerminate so that Session::Run fails soon with a terminate error, to
+// the RunControl of the job running on this thread while the scope is alive. The executor stops a low-priority job
+// when a high-priority job needs its worker; any job can be stopped through the RunControl it was submitted with.
+// Code that does not run on an executor is never stopped.
+class RunScope {
+public:
+  explicit RunScope(std::function<void()> terminate);
+  ~RunScope();
+
+  RunScope(const RunScope &) = delete;
+  RunScope &operator=(const RunScope &) = delete;
+
+  // Why the job running on this thread was stopped, e.g. to report why its run failed
+  static RunStop stopReason();
+};
+
+// Fixed-size pool of worker threads that runs queued jobs (e.g. Session::Run) in FIFO order within each priority.
+// Jobs are expected to post their own results back to the platform thread.
+class InferenceExecutor {
+public:
+  explicit InferenceExecutor(size_t num_threads = kDefaultInferenceThreads);
+
+  // Lets the already queued jobs finish, then joins all worker threads
+  ~InferenceExecutor();
+
+  // Disallow copy and assign
+  InferenceExecutor(const InferenceExecutor &) = delete;
+  InferenceExecutor &operator=(const InferenceExecutor &) = delete;
+
+  // Queue a job to run on one of the worker threads; run lets the caller stop it, e.g. through a RunRegistry
+  void submit(std::function<void()> job, JobPriority priority = JobPriority::kNormal,
+              std::shared_ptr<RunControl> run = nullptr);
+
+  // Preempt every low-priority job, the running ones and those still queued, which then fail as soon as they enter
+  // a RunScope. Returns the number of jobs preempted.
+  size_t cancelLowPriority();
+
+  // Get the counters of each priority, indexed by JobPriority
+  std::array<JobQueueStats, kJobPriorityCount> getQueueStats();
+
+  // Grow or shrink the pool; shrinking lets busy workers finish their current job first
+  void setNumThreads(size_t num_threads);
+
+  // Get the number of worker threads the pool is sized to
+  size_t getNumThreads();
+
+private:
+  // Scheduling state of a job, shared between the queue, the worker running it and its RunScope
+  struct JobControl {
+    JobPriority priority = JobPriority::kNormal;
+    uint64_t submit_nanos = 0;
+    std::shared_ptr<RunControl> run;
+  };
+
+  struct QueuedJob {
+    std::function<void()> run;
+    std::shared_ptr<JobControl> control;
+  };
+
+  struct PriorityCounters {
+    uint64_t submitted = 0;
+    uint64_t started = 0;
+    uint64_t preempted = 0;
+    uint64_t wait_nanos = 0;
+    uint64_t max_wait_micros = 0;
+    LatencyHistogram wait_latency;
+  };
+
+  friend class RunScope;
+
+  // Control of the job running on the calling worker thread, nullptr elsewhere
+  static thread_local JobControl *current_job_;
+
+  // Join the workers that have retired, then start additional workers until the pool reaches target_threads_
+  // (mutex_ must be held)
+  void spawnWorkersLocked();
+
+  // Main loop of a worker thread
+  void workerLoop();
+
+  std::vector<std::thread> workers_;
+  // Workers that returned after the pool was shrunk and are still in workers_ until they are joined
+  std::vector<std::thread::id> retired_workers_;
+  std::array<std::queue<QueuedJob>, kJobPriorityCount> jobs_;
+  std::array<PriorityCounters, kJobPriorityCount> counters_;
+
+  // Low-priority jobs being run, oldest first, which a high-priority job may preempt
+  std::list<std::shared_ptr<JobControl>> running_low_;
+
+  // Number of workers the pool should have and number of workers currently running
+  size_t target_threads_;
+  size_t active_threads_;
+  // Number of workers running a job
+  size_t busy_threads_;
+  bool stopping_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_INFERENCE_EXECUTOR_H_
@@ -0,0 +1,146 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_LRU_CACHE_H_
+#define FLUTTER_ONNXRUNTIME_LRU_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace flutter_onnxruntime {
+
+// Limits and counters of an LruCache
+struct LruCacheStats {
+  size_t max_entries = 0;
+  size_t max_bytes = 0;
+  size_t entries = 0;
+  size_t bytes = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+};
+
+// Least recently used cache of shared values by string key, bounded by entry count and total size.
+// Values are shared, so an evicted value stays alive for as long as someone else still holds it.
+// Evicted values are handed back to the caller so it can release them outside its lock.
+// Not thread safe; the owning manager serializes access.
+template <typename T> class LruCache {
+public:
+  // Set the limits, a limit of 0 meaning no limit on that dimension; both 0 disable the cache and drop its values
+  std::vector<std::shared_ptr<T>> setLimits(size_t max_entries, size_t max_bytes) {
+    max_entries_ = max_entries;
+    max_bytes_ = max_bytes;
+    if (!enabled()) {
+      return clear();
+    }
+    return evict();
+  }
+
+  bool enabled() const { return max_entries_ > 0 || max_bytes_ > 0; }
+
+  // Get the value of a key and mark it as the most recently used, or nullptr if it is not cached
+  std::shared_ptr<T> find(const std::string &key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      misses_++;
+      return nullptr;
+    }
+    hits_++;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->value;
+  }
+
+  // Cache a value of a given size as the most recently used, replacing any value of the same key
+  std::vector<std::shared_ptr<T>> insert(const std::string &key, std::shared_ptr<T> value, size_t bytes) {
+    std::vector<std::shared_ptr<T>> evicted;
+    if (!enabled()) {
+      return evicted;
+    }
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      bytes_ -= it->second->bytes;
+      evicted.push_back(std::move(it->second->value));
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+
+    entries_.push_front(Entry{key, std::move(value), bytes});
+    index_[key] = entries_.begin();
+    bytes_ += bytes;
+
+    for (auto &value_to_release : evict()) {
+      evicted.push_back(std::move(value_to_release));
+    }
+    return evicted;
+  }
+
+  // Drop every value
+  std::vector<std::shared_ptr<T>> clear() {
+    std::vector<std::shared_ptr<T>> evicted;
+    for (Entry &entry : entries_) {
+      evicted.push_back(std::move(entry.value));
+    }
+    entries_.clear();
+    index_.clear();
+    bytes_ = 0;
+    return evicted;
+  }
+
+  LruCacheStats getStats() const {
+    LruCacheStats stats;
+    stats.max_entries = max_entries_;
+    stats.max_bytes = max_bytes_;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    return stats;
+  }
+
+private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<T> value;
+    size_t bytes;
+  };
+
+  // Drop the least recently used values until the cache is within its limits
+  std::vector<std::shared_ptr<T>> evict() {
+    std::vector<std::shared_ptr<T>> evicted;
+    while (!entries_.empty() &&
+           ((max_entries_ > 0 && entries_.size() > max_entries_) || (max_bytes_ > 0 && bytes_ > max_bytes_))) {
+      Entry &entry = entries_.back();
+      bytes_ -= entry.bytes;
+      evicted.push_back(std::move(entry.value));
+      index_.erase(entry.key);
+      entries_.pop_back();
+      evictions_++;
+    }
+    return evicted;
+  }
+
+  // Most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, typename std::list<Entry>::iterator> index_;
+  size_t max_entries_ = 0;
+  size_t max_bytes_ = 0;
+  size_t bytes_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_LRU_CACHE_H_
@@ -0,0 +1,36 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_MAPPED_FILE_H_
+#define FLUTTER_ONNXRUNTIME_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <filesystem>
+
+namespace flutter_onnxruntime {
+
+// Read-only memory mapping of a whole file, unmapped on destruction.
+// The pages are shared with the file cache of the OS, so mapping a model does not copy it onto the heap.
+class MappedFile {
+public:
+  // Map a file; throws std::runtime_error if it cannot be opened, is empty or cannot be mapped
+  explicit MappedFile(const std::filesystem::path &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const void *data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  void *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_MAPPED_FILE_H_
@@ -0,0 +1,243 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_MICRO_BATCHER_H_
+#define FLUTTER_ONNXRUNTIME_MICRO_BATCHER_H_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace flutter_onnxruntime {
+
+// Queue statistics of one batched session
+struct BatchingStats {
+  // Requests waiting for their batch right now, and the most that were ever waiting at once
+  size_t queue_depth = 0;
+  size_t max_queue_depth = 0;
+
+  // Requests and batches dispatched so far
+  uint64_t requests = 0;
+  uint64_t batches = 0;
+
+  // batch_size_histogram[n] is the number of dispatched batches of n requests
+  std::vector<uint64_t> batch_size_histogram;
+};
+
+// Dynamic batcher that gathers concurrent requests per key (a session handle) and dispatches them together.
+// A batch is dispatched once it holds max_batch_size requests or its oldest request has waited for the window,
+// whichever comes first. Dispatch is called on the submitting thread or on the batcher's timer thread without
+// any lock held, and should only hand the batch off, e.g. to an InferenceExecutor.
+template <typename Request> class MicroBatcher {
+public:
+  using Key = uint64_t;
+  using Dispatch = std::function<void(Key key, std::vector<Request> &&batch)>;
+
+  explicit MicroBatcher(Dispatch dispatch) : dispatch_(std::move(dispatch)), stopping_(false) {
+    timer_thread_ = std::thread([this]() { timerLoop(); });
+  }
+
+  // Dispatches the requests still waiting, then joins the timer thread
+  ~MicroBatcher() {
+    std::vector<std::pair<Key, std::vector<Request>>> batches;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      for (auto &entry : queues_) {
+        takeAllLocked(entry.first, entry.second, batches);
+      }
+    }
+    cv_.notify_all();
+    timer_thread_.join();
+    dispatchAll(batches);
+  }
+
+  // Disallow copy and assign
+  MicroBatcher(const MicroBatcher &) = delete;
+  MicroBatcher &operator=(const MicroBatcher &) = delete;
+
+  // Enable batching for a key or change its settings; a max_batch_size below 2 disables it.
+  // Requests already waiting are dispatched if they no longer fit the new settings.
+  void configure(Key key, std::chrono::microseconds window, size_t max_batch_size) {
+    std::vector<std::pair<Key, std::vector<Request>>> batches;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = queues_.find(key);
+      if (max_batch_size < 2) {
+        if (it != queues_.end()) {
+          takeAllLocked(key, it->second, batches);
+          queues_.erase(it);
+        }
+      } else {
+        Queue &queue = it != queues_.end() ? it->second : queues_[key];
+        queue.window = window;
+        queue.max_batch_size = max_batch_size;
+        if (queue.stats.batch_size_histogram.size() < max_batch_size + 1) {
+          queue.stats.batch_size_histogram.resize(max_batch_size + 1, 0);
+        }
+        while (queue.pending.size() >= max_batch_size) {
+          batches.emplace_back(key, takeBatchLocked(queue, max_batch_size));
+        }
+      }
+    }
+    // The window may have shrunk
+    cv_.notify_all();
+    dispatchAll(batches);
+  }
+
+  // Stop batching for a key, dispatching the requests still waiting
+  void remove(Key key) { configure(key, std::chrono::microseconds(0), 0); }
+
+  // Whether batching is enabled for a key
+  bool isEnabled(Key key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queues_.find(key) != queues_.end();
+  }
+
+  // Queue a request; returns false and leaves the request untouched if batching is not enabled for the key
+  bool submit(Key key, Request &&request) {
+    std::vector<Request> batch;
+    bool first_pending = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = queues_.find(key);
+      if (it == queues_.end() || stopping_) {
+        return false;
+      }
+
+      Queue &queue = it->second;
+      first_pending = queue.pending.empty();
+      queue.pending.push_back(Pending{Clock::now(), std::move(request)});
+      queue.stats.max_queue_depth = std::max(queue.stats.max_queue_depth, queue.pending.size());
+      if (queue.pending.size() >= queue.max_batch_size) {
+        batch = takeBatchLocked(queue, queue.max_batch_size);
+      }
+    }
+
+    if (!batch.empty()) {
+      dispatch_(key, std::move(batch));
+    } else if (first_pending) {
+      // A new deadline for the timer thread
+      cv_.notify_all();
+    }
+    return true;
+  }
+
+  // Get the statistics of a key; empty if batching is not enabled for it
+  BatchingStats getStats(Key key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queues_.find(key);
+    if (it == queues_.end()) {
+      return BatchingStats{};
+    }
+    BatchingStats stats = it->second.stats;
+    stats.queue_depth = it->second.pending.size();
+    return stats;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Pending {
+    Clock::time_point enqueued;
+    Request request;
+  };
+
+  struct Queue {
+    std::chrono::microseconds window{0};
+    size_t max_batch_size = 0;
+    std::deque<Pending> pending;
+    BatchingStats stats;
+  };
+
+  // Take the oldest count requests of a queue and record the batch (mutex_ must be held)
+  std::vector<Request> takeBatchLocked(Queue &queue, size_t count) {
+    count = std::min(count, queue.pending.size());
+    std::vector<Request> batch;
+    batch.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      batch.push_back(std::move(queue.pending.front().request));
+      queue.pending.pop_front();
+    }
+
+    if (queue.stats.batch_size_histogram.size() < count + 1) {
+      queue.stats.batch_size_histogram.resize(count + 1, 0);
+    }
+    queue.stats.batch_size_histogram[count]++;
+    queue.stats.batches++;
+    queue.stats.requests += count;
+    return batch;
+  }
+
+  // Take every waiting request of a queue in batches of at most max_batch_size (mutex_ must be held)
+  void takeAllLocked(Key key, Queue &queue, std::vector<std::pair<Key, std::vector<Request>>> &batches) {
+    while (!queue.pending.empty()) {
+      batches.emplace_back(key, takeBatchLocked(queue, std::max<size_t>(queue.max_batch_size, 1)));
+    }
+  }
+
+  void dispatchAll(std::vector<std::pair<Key, std::vector<Request>>> &batches) {
+    for (auto &entry : batches) {
+      dispatch_(entry.first, std::move(entry.second));
+    }
+  }
+
+  // Dispatches the batches whose oldest request has waited for the window
+  void timerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+      Clock::time_point now = Clock::now();
+      Clock::time_point next_deadline = Clock::time_point::max();
+      std::vector<std::pair<Key, std::vector<Request>>> batches;
+      for (auto &entry : queues_) {
+        Queue &queue = entry.second;
+        while (!queue.pending.empty() && queue.pending.front().enqueued + queue.window <= now) {
+          batches.emplace_back(entry.first, takeBatchLocked(queue, queue.max_batch_size));
+        }
+        if (!queue.pending.empty()) {
+          next_deadline = std::min(next_deadline, queue.pending.front().enqueued + queue.window);
+        }
+      }
+
+      if (!batches.empty()) {
+        lock.unlock();
+        dispatchAll(batches);
+        lock.lock();
+        continue;
+      }
+
+      if (next_deadline == Clock::time_point::max()) {
+        cv_.wait(lock);
+      } else {
+        cv_.wait_until(lock, next_deadline);
+      }
+    }
+  }
+
+  Dispatch dispatch_;
+
+  std::unordered_map<Key, Queue> queues_;
+  bool stopping_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+
+  // Started by the constructor once the other members are initialized
+  std::thread timer_thread_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_MICRO_BATCHER_H_
@@ -0,0 +1,265 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "native_api.h"
+#include "inference_executor.h"
+#include "session_manager.h"
+#include "tensor_manager.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using flutter_onnxruntime::kInvalidHandle;
+using flutter_onnxruntime::NativeContext;
+using flutter_onnxruntime::SessionHandle;
+using flutter_onnxruntime::SessionManager;
+using flutter_onnxruntime::steadyNanos;
+using flutter_onnxruntime::TensorHandle;
+using flutter_onnxruntime::TensorLease;
+using flutter_onnxruntime::TraceScope;
+
+// What a void* lease handed to Dart points to
+struct NativeLease {
+  TensorLease lease;
+  void *data = nullptr;
+  size_t byte_size = 0;
+};
+
+// What a void* run result handed to Dart points to
+struct NativeRunResult {
+  std::string error; // Empty on success
+  std::vector<TensorHandle> output_ids;
+  std::vector<int32_t> output_types;
+  std::vector<std::vector<int64_t>> output_shapes;
+};
+
+// Inputs of a run, borrowed on the thread that asks for it so that Dart cannot release them before the run starts
+struct NativeRunInputs {
+  std::vector<TensorLease> leases;
+  std::vector<const OrtValue *> values;
+  std::vector<std::string> names;
+  std::vector<std::string> output_names;
+  uint64_t nanos = 0;
+};
+
+thread_local std::string last_error;
+
+// Borrow the inputs of a run and look up the names of its inputs and outputs; returns an error message, empty if the
+// run can go ahead
+std::string prepareRun(NativeContext *context, SessionHandle session_id, const std::vector<uint32_t> &indices,
+                       const std::vector<TensorHandle> &ids, const std::vector<uint32_t> &output_indices,
+                       NativeRunInputs &inputs) {
+  if (!context->session_manager->hasSession(session_id)) {
+    return "Session not found";
+  }
+
+  uint64_t call_start = steadyNanos();
+  std::vector<std::string> session_inputs = context->session_manager->getInputNames(session_id);
+  for (size_t i = 0; i < ids.size(); i++) {
+    if (indices[i] >= session_inputs.size()) {
+      return "Input index out of range: " + std::to_string(indices[i]);
+    }
+    TensorLease lease = context->tensor_manager->acquireTensor(ids[i]);
+    if (!lease) {
+      return "Input tensor not found: " + session_inputs[indices[i]];
+    }
+    inputs.values.push_back(lease.get());
+    inputs.names.push_back(session_inputs[indices[i]]);
+    inputs.leases.push_back(std::move(lease));
+  }
+
+  if (!output_indices.empty()) {
+    std::vector<std::string> session_outputs = context->session_manager->getOutputNames(session_id);
+    for (uint32_t index : output_indices) {
+      if (index >= session_outputs.size()) {
+        return "Output index out of range: " + std::to_string(index);
+      }
+      inputs.output_names.push_back(session_outputs[index]);
+    }
+  }
+  inputs.nanos = steadyNanos() - call_start;
+  return std::string();
+}
+
+// Run a session on inputs borrowed by prepareRun; their leases stay alive through this call
+NativeRunResult *runSession(NativeContext *context, SessionHandle session_id, const NativeRunInputs &inputs) {
+  TraceScope trace("fort_session_run");
+  auto result = std::make_unique<NativeRunResult>();
+  try {
+    std::vector<Ort::Value> output_tensors = context->session_manager->runInference(
+        session_id, inputs.values, inputs.names, nullptr, inputs.output_names);
+    // Sequences and maps cannot be stored, so the run fails before any output is, like on the method channel
+    std::vector<std::string> output_names = inputs.output_names.empty()
+                                                ? context->session_manager->getOutputNames(session_id)
+                                                : inputs.output_names;
+    for (size_t i = 0; i < output_tensors.size() && i < output_names.size(); i++) {
+      if (output_tensors[i] && !output_tensors[i].IsTensor()) {
+        result->error = "Output " + output_names[i] + " is a sequence or map, only tensor outputs can be returned";
+        return result.release();
+      }
+    }
+
+    uint64_t output_start = steadyNanos();
+    for (Ort::Value &tensor : output_tensors) {
+      // Outputs kept as sequence state are not returned
+      if (!tensor) {
+        result->output_types.push_back(ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED);
+        result->output_shapes.emplace_back();
+        result->output_ids.push_back(kInvalidHandle);
+        continue;
+      }
+      Ort::TensorTypeAndShapeInfo info = tensor.GetTensorTypeAndShapeInfo();
+      result->output_types.push_back(static_cast<int32_t>(info.GetElementType()));
+      result->output_shapes.push_back(info.GetShape());
+      result->output_ids.push_back(context->tensor_manager->storeTensor(std::move(tensor)));
+    }
+    context->session_manager->recordCall(session_id, inputs.nanos, steadyNanos() - output_start);
+  } catch (const std::exception &e) {
+    result->error = e.what();
+  } catch (...) {
+    result->error = "Unknown error during inference";
+  }
+  return result.release();
+}
+
+} // namespace
+
+const char *fort_last_error() { return last_error.c_str(); }
+
+uint64_t fort_tensor_create(void *context, int32_t element_type, const void *data, size_t byte_size,
+                            const int64_t *shape, size_t rank) {
+  try {
+    return static_cast<NativeContext *>(context)->tensor_manager->createTensorFromBytes(
+        static_cast<ONNXTensorElementDataType>(element_type), data, byte_size,
+        std::vector<int64_t>(shape, shape + rank));
+  } catch (const std::exception &e) {
+    last_error = e.what();
+  } catch (...) {
+    last_error = "Unknown error while creating a tensor";
+  }
+  return kInvalidHandle;
+}
+
+int32_t fort_tensor_release(void *context, uint64_t tensor_id) {
+  try {
+    if (static_cast<NativeContext *>(context)->tensor_manager->releaseTensor(tensor_id)) {
+      return 1;
+    }
+    last_error = "Tensor not found";
+  } catch (const std::exception &e) {
+    last_error = e.what();
+  } catch (...) {
+    last_error = "Unknown error while releasing a tensor";
+  }
+  return 0;
+}
+
+size_t fort_tensor_release_many(void *context, const uint64_t *tensor_ids, size_t count) {
+  try {
+    return static_cast<NativeContext *>(context)->tensor_manager->releaseTensors(
+        std::vector<TensorHandle>(tensor_ids, tensor_ids + count));
+  } catch (const std::exception &e) {
+    last_error = e.what();
+  } catch (...) {
+    last_error = "Unknown error while releasing tensors";
+  }
+  return 0;
+}
+
+void *fort_tensor_acquire(void *context, uint64_t tensor_id) {
+  try {
+    auto lease = std::make_unique<NativeLease>();
+    lease->lease = static_cast<NativeContext *>(context)->tensor_manager->acquireTensorData(tensor_id, &lease->data,
+                                                                                             &lease->byte_size);
+    return lease->lease ? lease.release() : nullptr;
+  } catch (...) {
+    // Exceptions must not cross the C ABI
+    return nullptr;
+  }
+}
+
+void *fort_lease_data(void *lease) { return lease ? static_cast<NativeLease *>(lease)->data : nullptr; }
+
+size_t fort_lease_byte_size(void *lease) { return lease ? static_cast<NativeLease *>(lease)->byte_size : 0; }
+
+void fort_lease_release(void *lease) { delete static_cast<NativeLease *>(lease); }
+
+void *fort_session_run(void *context, uint64_t session_id, const uint32_t *input_indices, const uint64_t *input_ids,
+                       size_t input_count, const uint32_t *output_indices, size_t output_count) {
+  auto *native_context = static_cast<NativeContext *>(context);
+  try {
+    NativeRunInputs inputs;
+    std::string error = prepareRun(native_context, session_id,
+                                   std::vector<uint32_t>(input_indices, input_indices + input_count),
+                                   std::vector<TensorHandle>(input_ids, input_ids + input_count),
+                                   std::vector<uint32_t>(output_indices, output_indices + output_count), inputs);
+    if (error.empty()) {
+      return runSession(native_context, session_id, inputs);
+    }
+    auto result = new NativeRunResult();
+    result->error = error;
+    return result;
+  } catch (const std::exception &e) {
+    auto result = new NativeRunResult();
+    result->error = e.what();
+    return result;
+  }
+}
+
+void fort_session_run_async(void *context, uint64_t session_id, const uint32_t *input_indices,
+                            const uint64_t *input_ids, size_t input_count, const uint32_t *output_indices,
+                            size_t output_count, uint64_t tag, fort_run_callback callback) {
+  auto *native_context = static_cast<NativeContext *>(context);
+  try {
+    // The inputs are borrowed before the run is queued; std::function needs a copyable callable, hence the
+    // shared_ptr around them
+    auto inputs = std::make_shared<NativeRunInputs>();
+    std::string error = prepareRun(native_context, session_id,
+                                   std::vector<uint32_t>(input_indices, input_indices + input_count),
+                                   std::vector<TensorHandle>(input_ids, input_ids + input_count),
+                                   std::vector<uint32_t>(output_indices, output_indices + output_count), *inputs);
+    if (!error.empty()) {
+      auto result = new NativeRunResult();
+      result->error = error;
+      callback(tag, result);
+      return;
+    }
+    native_context->inference_executor->submit([native_context, session_id, inputs, tag, callback]() {
+      callback(tag, runSession(native_context, session_id, *inputs));
+    });
+  } catch (const std::exception &e) {
+    auto result = new NativeRunResult();
+    result->error = e.what();
+    callback(tag, result);
+  }
+}
+
+const char *fort_run_error(void *result) {
+  const std::string &error = static_cast<NativeRunResult *>(result)->error;
+  return error.empty() ? nullptr : error.c_str();
+}
+
+size_t fort_run_output_count(void *result) { return static_cast<NativeRunResult *>(result)->output_ids.size(); }
+
+uint64_t fort_run_output_id(void *result, size_t index) {
+  return static_cast<NativeRunResult *>(result)->output_ids[index];
+}
+
+int32_t fort_run_output_type(void *result, size_t index) {
+  return static_cast<NativeRunResult *>(result)->output_types[index];
+}
+
+size_t fort_run_output_rank(void *result, size_t index) {
+  return static_cast<NativeRunResult *>(result)->output_shapes[index].size();
+}
+
+const int64_t *fort_run_output_shape(void *result, size_t index) {
+  return static_cast<NativeRunResult *>(result)->output_shapes[index].data();
+}
+
+void fort_run_release(void *result) { delete static_cast<NativeRunResult *>(result); }
@@ -0,0 +1,96 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_NATIVE_API_H_
+#define FLUTTER_ONNXRUNTIME_NATIVE_API_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "include/flutter_onnxruntime/export.h"
+
+namespace flutter_onnxruntime {
+
+class InferenceExecutor;
+class SessionManager;
+class TensorManager;
+
+// Managers of one plugin instance that the fort_* functions work on.
+// The plugin reports its address to Dart through the getNativeContext method call.
+struct NativeContext {
+  SessionManager *session_manager = nullptr;
+  TensorManager *tensor_manager = nullptr;
+  InferenceExecutor *inference_executor = nullptr;
+};
+
+} // namespace flutter_onnxruntime
+
+// C functions that Dart calls through dart:ffi to move tensor data and run sessions without the method channel,
+// which stays in use for the control-plane calls. context is a NativeContext. None of these functions throw.
+// Element types are ONNXTensorElementDataType values and IDs are the handles used on the method channel.
+extern "C" {
+
+// Called with the tag passed to fort_session_run_async and the result of the run, from a worker thread or, if the
+// run could not be queued, from the calling thread
+typedef void (*fort_run_callback)(uint64_t tag, void *result);
+
+// Message of the last failed fort_tensor_create or fort_tensor_release on the calling thread
+FLUTTER_PLUGIN_EXPORT const char *fort_last_error();
+
+// Create a tensor of a fixed-size element type, copying byte_size bytes of data once into a pooled buffer.
+// Returns the handle of the new tensor, or 0 on failure.
+FLUTTER_PLUGIN_EXPORT uint64_t fort_tensor_create(void *context, int32_t element_type, const void *data,
+                                                  size_t byte_size, const int64_t *shape, size_t rank);
+
+// Release a tensor; returns 0 if it does not exist
+FLUTTER_PLUGIN_EXPORT int32_t fort_tensor_release(void *context, uint64_t tensor_id);
+
+// Release count tensors under one lock, skipping unknown ones; returns how many were released
+FLUTTER_PLUGIN_EXPORT size_t fort_tensor_release_many(void *context, const uint64_t *tensor_ids, size_t count);
+
+// Borrow the data of a stored tensor; returns nullptr if the tensor does not exist or holds strings.
+// The data stays valid until the lease is released, even if the tensor itself is released first.
+FLUTTER_PLUGIN_EXPORT void *fort_tensor_acquire(void *context, uint64_t tensor_id);
+
+// Address and size in bytes of the data of a lease
+FLUTTER_PLUGIN_EXPORT void *fort_lease_data(void *lease);
+FLUTTER_PLUGIN_EXPORT size_t fort_lease_byte_size(void *lease);
+
+// Release a lease; has the signature of a Dart NativeFinalizer callback
+FLUTTER_PLUGIN_EXPORT void fort_lease_release(void *lease);
+
+// Run a session on the calling thread. input_indices[i] is the position of the i-th input in the session's input
+// names and input_ids[i] the tensor fed to it. output_indices lists the positions in the session's output names of
+// the outputs to compute, or is empty (output_count 0) for every output. Returns a result to read with fort_run_*
+// and release.
+FLUTTER_PLUGIN_EXPORT void *fort_session_run(void *context, uint64_t session_id, const uint32_t *input_indices,
+                                             const uint64_t *input_ids, size_t input_count,
+                                             const uint32_t *output_indices, size_t output_count);
+
+// Same as fort_session_run, but queued on the inference worker pool. The indices are copied and the inputs borrowed
+// before returning, so they may be released right away; a run that cannot be queued calls back before returning.
+FLUTTER_PLUGIN_EXPORT void fort_session_run_async(void *context, uint64_t session_id, const uint32_t *input_indices,
+                                                  const uint64_t *input_ids, size_t input_count,
+                                                  const uint32_t *output_indices, size_t output_count, uint64_t tag,
+                                                  fort_run_callback callback);
+
+// Error message of a failed run, or nullptr if it succeeded
+FLUTTER_PLUGIN_EXPORT const char *fort_run_error(void *result);
+
+// Outputs of a successful run, in the order of output_indices or else of the session's output names; index must be
+// below the output count
+FLUTTER_PLUGIN_EXPORT size_t fort_run_output_count(void *result);
+FLUTTER_PLUGIN_EXPORT uint64_t fort_run_output_id(void *result, size_t index);
+FLUTTER_PLUGIN_EXPORT int32_t fort_run_output_type(void *result, size_t index);
+FLUTTER_PLUGIN_EXPORT size_t fort_run_output_rank(void *result, size_t index);
+FLUTTER_PLUGIN_EXPORT const int64_t *fort_run_output_shape(void *result, size_t index);
+
+// Release a run result; the output tensors stay stored until released on their own
+FLUTTER_PLUGIN_EXPORT void fort_run_release(void *result);
+
+} // extern "C"
+
+#endif // FLUTTER_ONNXRUNTIME_NATIVE_API_H_
@@ -0,0 +1,466 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "pipeline.h"
+#include "pipeline_ops.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <set>
+#include <stdexcept>
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// Input and output names of a glue op
+struct OpSignature {
+  const char *op;
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+};
+
+const std::vector<OpSignature> &opSignatures() {
+  static const std::vector<OpSignature> signatures = {
+      {"slice", {"input"}, {"output"}},
+      {"cropResize", {"image", "boxes"}, {"output"}},
+      {"argmax", {"input"}, {"output"}},
+      {"softmax", {"input"}, {"output"}},
+      {"sigmoid", {"input"}, {"output"}},
+      {"topK", {"input"}, {"values", "indices"}},
+      {"nms", {"boxes", "scores"}, {"boxes", "scores", "indices"}},
+  };
+  return signatures;
+}
+
+const OpSignature *findSignature(const std::string &op) {
+  for (const OpSignature &signature : opSignatures()) {
+    if (op == signature.op) {
+      return &signature;
+    }
+  }
+  return nullptr;
+}
+
+double scalarParam(const PipelineStage &stage, const char *name, double default_value) {
+  auto it = stage.scalars.find(name);
+  return it != stage.scalars.end() ? it->second : default_value;
+}
+
+// A required positive integer parameter of a stage
+int64_t sizeParam(const PipelineStage &stage, const char *name) {
+  double value = scalarParam(stage, name, 0);
+  if (value < 1 || value != std::floor(value)) {
+    throw std::invalid_argument("Stage " + stage.name + " needs a positive integer " + name);
+  }
+  return static_cast<int64_t>(value);
+}
+
+std::vector<int64_t> listParam(const PipelineStage &stage, const char *name) {
+  auto it = stage.lists.find(name);
+  return it != stage.lists.end() ? it->second : std::vector<int64_t>{};
+}
+
+int64_t elementCount(const std::vector<int64_t> &shape) {
+  int64_t count = 1;
+  for (int64_t dim : shape) {
+    count *= dim;
+  }
+  return count;
+}
+
+// Check that an input of a glue op is a tensor the CPU can read; throws std::invalid_argument if it is not a tensor
+// or is in device memory
+Ort::ConstValue hostTensor(const PipelineStage &stage, const std::string &input, const OrtValue *value) {
+  Ort::ConstValue tensor{value};
+  if (!tensor.IsTensor()) {
+    throw std::invalid_argument("Input " + input + " of stage " + stage.name + " must be a tensor");
+  }
+  if (tensor.GetTensorMemoryInfo().GetDeviceType() != OrtMemoryInfoDeviceType_CPU) {
+    throw std::invalid_argument("Input " + input + " of stage " + stage.name + " must be in host memory");
+  }
+  return tensor;
+}
+
+// Shape of a float32 tensor input of a glue op; throws std::invalid_argument if it is of another type
+std::vector<int64_t> floatShape(const PipelineStage &stage, const std::string &input, const OrtValue *value) {
+  Ort::ConstValue tensor = hostTensor(stage, input, value);
+  Ort::TensorTypeAndShapeInfo info = tensor.GetTensorTypeAndShapeInfo();
+  if (info.GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+    throw std::invalid_argument("Input " + input + " of stage " + stage.name + " must be a float32 tensor");
+  }
+  return info.GetShape();
+}
+
+Ort::Value allocateTensor(const std::vector<int64_t> &shape, ONNXTensorElementDataType element_type) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  return Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), element_type);
+}
+
+Ort::Value runSlice(const PipelineStage &stage, const OrtValue *input) {
+  Ort::ConstValue tensor = hostTensor(stage, "input", input);
+  Ort::TensorTypeAndShapeInfo info = tensor.GetTensorTypeAndShapeInfo();
+  ONNXTensorElementDataType element_type = info.GetElementType();
+  size_t element_size = SessionManager::getElementSize(element_type);
+  if (element_size == 0) {
+    throw std::invalid_argument("Input of stage " + stage.name + " must be a fixed-size tensor");
+  }
+
+  std::vector<int64_t> shape = info.GetShape();
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> sizes;
+  resolveSlice(shape, listParam(stage, "starts"), listParam(stage, "ends"), listParam(stage, "axes"), &offsets, &sizes);
+  Ort::Value output = allocateTensor(sizes, element_type);
+  sliceElements(tensor.GetTensorRawData(), element_size, shape, offsets, sizes, output.GetTensorMutableRawData());
+  return output;
+}
+
+Ort::Value runCropResize(const PipelineStage &stage, const OrtValue *image, const OrtValue *boxes) {
+  std::vector<int64_t> image_shape = floatShape(stage, "image", image);
+  if (image_shape.size() == 4 && image_shape[0] == 1) {
+    image_shape.erase(image_shape.begin());
+  }
+  if (image_shape.size() != 3) {
+    throw std::invalid_argument("Image of stage " + stage.name + " must have shape [1, C, H, W] or [C, H, W]");
+  }
+  std::vector<int64_t> boxes_shape = floatShape(stage, "boxes", boxes);
+  int64_t box_count = elementCount(boxes_shape) / 4;
+  if (boxes_shape.empty() || boxes_shape.back() != 4) {
+    throw std::invalid_argument("Boxes of stage " + stage.name + " must have shape [K, 4]");
+  }
+
+  int64_t height = sizeParam(stage, "height");
+  int64_t width = sizeParam(stage, "width");
+  Ort::Value output = allocateTensor({box_count, image_shape[0], height, width}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  cropResize(Ort::ConstValue{image}.GetTensorData<float>(), image_shape[0], image_shape[1], image_shape[2],
+             Ort::ConstValue{boxes}.GetTensorData<float>(), box_count, height, width,
+             output.GetTensorMutableData<float>());
+  return output;
+}
+
+// The axis parameter of a stage, -1 by default, resolved against the rank of its input
+size_t axisParam(const PipelineStage &stage, const std::vector<int64_t> &shape) {
+  int64_t rank = static_cast<int64_t>(shape.size());
+  int64_t axis = static_cast<int64_t>(scalarParam(stage, "axis", -1));
+  if (axis < 0) {
+    axis += rank;
+  }
+  if (axis < 0 || axis >= rank || shape[axis] == 0) {
+    throw std::invalid_argument("Axis of stage " + stage.name + " is out of range");
+  }
+  return static_cast<size_t>(axis);
+}
+
+Ort::Value runArgmax(const PipelineStage &stage, const OrtValue *input) {
+  std::vector<int64_t> shape = floatShape(stage, "input", input);
+  size_t axis = axisParam(stage, shape);
+
+  std::vector<int64_t> output_shape = shape;
+  output_shape.erase(output_shape.begin() + axis);
+  Ort::Value output = allocateTensor(output_shape, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64);
+  argmaxAxis(Ort::ConstValue{input}.GetTensorData<float>(), shape, axis, output.GetTensorMutableData<int64_t>());
+  return output;
+}
+
+Ort::Value runSoftmax(const PipelineStage &stage, const OrtValue *input) {
+  std::vector<int64_t> shape = floatShape(stage, "input", input);
+  size_t axis = axisParam(stage, shape);
+  Ort::Value output = allocateTensor(shape, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  softmaxAxis(Ort::ConstValue{input}.GetTensorData<float>(), shape, axis, output.GetTensorMutableData<float>());
+  return output;
+}
+
+Ort::Value runSigmoid(const PipelineStage &stage, const OrtValue *input) {
+  std::vector<int64_t> shape = floatShape(stage, "input", input);
+  Ort::Value output = allocateTensor(shape, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  sigmoidElements(Ort::ConstValue{input}.GetTensorData<float>(), static_cast<size_t>(elementCount(shape)),
+                  output.GetTensorMutableData<float>());
+  return output;
+}
+
+void runTopK(const PipelineStage &stage, const OrtValue *input, std::vector<Ort::Value> *outputs) {
+  std::vector<int64_t> shape = floatShape(stage, "input", input);
+  int64_t k = sizeParam(stage, "k");
+  if (shape.empty() || k > shape.back()) {
+    throw std::invalid_argument("k of stage " + stage.name + " exceeds the size of the last axis");
+  }
+
+  int64_t cols = shape.back();
+  shape.back() = k;
+  Ort::Value values = allocateTensor(shape, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  Ort::Value indices = allocateTensor(shape, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64);
+  topKRows(Ort::ConstValue{input}.GetTensorData<float>(), elementCount(shape) / k, cols, k,
+           values.GetTensorMutableData<float>(), indices.GetTensorMutableData<int64_t>());
+  outputs->push_back(std::move(values));
+  outputs->push_back(std::move(indices));
+}
+
+void runNms(const PipelineStage &stage, const OrtValue *boxes, const OrtValue *scores,
+            std::vector<Ort::Value> *outputs) {
+  std::vector<int64_t> boxes_shape = floatShape(stage, "boxes", boxes);
+  int64_t count = elementCount(floatShape(stage, "scores", scores));
+  if (boxes_shape.empty() || boxes_shape.back() != 4 || elementCount(boxes_shape) != count * 4) {
+    throw std::invalid_argument("Boxes of stage " + stage.name + " must have shape [N, 4] for N scores");
+  }
+
+  const float *box_data = Ort::ConstValue{boxes}.GetTensorData<float>();
+  const float *score_data = Ort::ConstValue{scores}.GetTensorData<float>();
+  std::vector<int64_t> kept = nonMaxSuppression(
+      box_data, score_data, count, static_cast<float>(scalarParam(stage, "iouThreshold", 0.5)),
+      static_cast<float>(scalarParam(stage, "scoreThreshold", -std::numeric_limits<float>::infinity())),
+      static_cast<int64_t>(scalarParam(stage, "maxDetections", 0)));
+
+  int64_t kept_count = static_cast<int64_t>(kept.size());
+  Ort::Value kept_boxes = allocateTensor({kept_count, 4}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  Ort::Value kept_scores = allocateTensor({kept_count}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  Ort::Value kept_indices = allocateTensor({kept_count}, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64);
+  float *box_out = kept_boxes.GetTensorMutableData<float>();
+  float *score_out = kept_scores.GetTensorMutableData<float>();
+  int64_t *index_out = kept_indices.GetTensorMutableData<int64_t>();
+  for (int64_t i = 0; i < kept_count; i++) {
+    std::copy(box_data + kept[i] * 4, box_data + kept[i] * 4 + 4, box_out + i * 4);
+    score_out[i] = score_data[kept[i]];
+    index_out[i] = kept[i];
+  }
+  outputs->push_back(std::move(kept_boxes));
+  outputs->push_back(std::move(kept_scores));
+  outputs->push_back(std::move(kept_indices));
+}
+
+// Run a glue op on its inputs, appending its outputs in the order of its signature
+void runOp(const PipelineStage &stage, const std::map<std::string, const OrtValue *> &inputs,
+           std::vector<Ort::Value> *outputs) {
+  if (stage.op == "slice") {
+    outputs->push_back(runSlice(stage, inputs.at("input")));
+  } else if (stage.op == "cropResize") {
+    outputs->push_back(runCropResize(stage, inputs.at("image"), inputs.at("boxes")));
+  } else if (stage.op == "argmax") {
+    outputs->push_back(runArgmax(stage, inputs.at("input")));
+  } else if (stage.op == "softmax") {
+    outputs->push_back(runSoftmax(stage, inputs.at("input")));
+  } else if (stage.op == "sigmoid") {
+    outputs->push_back(runSigmoid(stage, inputs.at("input")));
+  } else if (stage.op == "topK") {
+    runTopK(stage, inputs.at("input"), outputs);
+  } else {
+    runNms(stage, inputs.at("boxes"), inputs.at("scores"), outputs);
+  }
+}
+
+} // namespace
+
+Pipeline::Pipeline(PipelineDescription description, SessionManager &session_manager)
+    : outputs_(std::move(description.outputs)) {
+  // Output names of every stage by stage name
+  std::map<std::string, size_t> stage_indices;
+  std::vector<std::vector<std::string>> stage_outputs;
+  for (const PipelineStage &stage : description.stages) {
+    if (stage.name.empty() || stage.name.find('/') != std::string::npos) {
+      throw std::invalid_argument("Stage names must be non-empty and must not contain '/'");
+    }
+    if (!stage_indices.emplace(stage.name, stage_indices.size()).second) {
+      throw std::invalid_argument("Duplicate stage name: " + stage.name);
+    }
+
+    if (stage.op == "session") {
+      if (!session_manager.hasSession(stage.session)) {
+        throw std::invalid_argument("Session of stage " + stage.name + " not found");
+      }
+      stage_outputs.push_back(session_manager.getOutputNames(stage.session));
+      continue;
+    }
+    const OpSignature *signature = findSignature(stage.op);
+    if (signature == nullptr) {
+      throw std::invalid_argument("Unknown op of stage " + stage.name + ": " + stage.op);
+    }
+    for (const std::string &input : signature->inputs) {
+      if (stage.inputs.count(input) == 0) {
+        throw std::invalid_argument("Stage " + stage.name + " needs an input " + input);
+      }
+    }
+    stage_outputs.push_back(signature->outputs);
+  }
+
+  // Stage producing a value reference, or none for a pipeline input
+  auto producer = [&](const std::string &reference) -> std::optional<size_t> {
+    size_t separator = reference.find('/');
+    if (separator == std::string::npos) {
+      return std::nullopt;
+    }
+    auto it = stage_indices.find(reference.substr(0, separator));
+    std::string output = reference.substr(separator + 1);
+    if (it == stage_indices.end() || std::find(stage_outputs[it->second].begin(), stage_outputs[it->second].end(),
+                                               output) == stage_outputs[it->second].end()) {
+      throw std::invalid_argument("No stage produces " + reference);
+    }
+    return it->second;
+  };
+
+  // Order the stages so that each runs after the stages it reads from
+  size_t stage_count = description.stages.size();
+  std::vector<std::set<size_t>> dependencies(stage_count);
+  for (size_t i = 0; i < stage_count; i++) {
+    for (const auto &[input, reference] : description.stages[i].inputs) {
+      if (std::optional<size_t> source = producer(reference)) {
+        dependencies[i].insert(*source);
+      }
+    }
+  }
+  std::set<std::string> output_references;
+  for (const auto &[name, reference] : outputs_) {
+    if (!producer(reference)) {
+      throw std::invalid_argument("Pipeline output " + name + " must be produced by a stage");
+    }
+    if (!output_references.insert(reference).second) {
+      throw std::invalid_argument("Several pipeline outputs return " + reference);
+    }
+  }
+
+  std::vector<size_t> order;
+  std::vector<bool> placed(stage_count, false);
+  while (order.size() < stage_count) {
+    size_t placed_before = order.size();
+    for (size_t i = 0; i < stage_count; i++) {
+      if (!placed[i] && std::all_of(dependencies[i].begin(), dependencies[i].end(),
+                                    [&placed](size_t dependency) { return placed[dependency]; })) {
+        placed[i] = true;
+        order.push_back(i);
+      }
+    }
+    if (order.size() == placed_before) {
+      throw std::invalid_argument("Pipeline stages form a cycle");
+    }
+  }
+
+  // Free each intermediate value after the last stage that reads it, or right away if none does
+  std::map<std::string, size_t> last_use;
+  for (size_t position = 0; position < stage_count; position++) {
+    const PipelineStage &stage = description.stages[order[position]];
+    for (const std::string &output : stage_outputs[order[position]]) {
+      last_use[stage.name + "/" + output] = position;
+    }
+    for (const auto &[input, reference] : stage.inputs) {
+      if (producer(reference)) {
+        last_use[reference] = position;
+      }
+    }
+  }
+  for (const auto &[name, reference] : outputs_) {
+    last_use.erase(reference);
+  }
+
+  released_after_.resize(stage_count);
+  for (const auto &[reference, position] : last_use) {
+    released_after_[position].push_back(reference);
+  }
+  for (size_t index : order) {
+    stages_.push_back(std::move(description.stages[index]));
+    stage_outputs_.push_back(std::move(stage_outputs[index]));
+  }
+}
+
+std::vector<std::pair<std::string, Ort::Value>>
+Pipeline::run(SessionManager &session_manager, const std::map<std::string, const OrtValue *> &inputs,
+              Ort::RunOptions *run_options) {
+  TraceScope trace("runPipeline");
+  std::map<std::string, Ort::Value> values;
+  auto resolve = [&](const std::string &reference) -> const OrtValue * {
+    auto value = values.find(reference);
+    if (value != values.end()) {
+      return value->second;
+    }
+    auto input = inputs.find(reference);
+    if (input == inputs.end() || input->second == nullptr) {
+      throw std::invalid_argument("Missing pipeline input: " + reference);
+    }
+    return input->second;
+  };
+
+  for (size_t position = 0; position < stages_.size(); position++) {
+    const PipelineStage &stage = stages_[position];
+    std::vector<Ort::Value> outputs;
+    if (stage.op == "session") {
+      std::vector<const OrtValue *> input_values;
+      std::vector<std::string> input_names;
+      for (const auto &[input, reference] : stage.inputs) {
+        input_values.push_back(resolve(reference));
+        input_names.push_back(input);
+      }
+      outputs = session_manager.runInference(stage.session, input_values, input_names, run_options);
+    } else {
+      std::map<std::string, const OrtValue *> op_inputs;
+      for (const auto &[input, reference] : stage.inputs) {
+        op_inputs[input] = resolve(reference);
+      }
+      runOp(stage, op_inputs, &outputs);
+    }
+
+    for (size_t i = 0; i < outputs.size() && i < stage_outputs_[position].size(); i++) {
+      // An output kept as sequence state of the session is not available to later stages
+      if (!outputs[i]) {
+        continue;
+      }
+      values.insert_or_assign(stage.name + "/" + stage_outputs_[position][i], std::move(outputs[i]));
+    }
+    for (const std::string &reference : released_after_[position]) {
+      values.erase(reference);
+    }
+  }
+
+  // Only the pipeline outputs are left; every one of them reads a distinct stage output. Outputs kept as sequence
+  // state of a session have no value, and sequences and maps cannot be returned.
+  std::vector<std::pair<std::string, Ort::Value>> results;
+  for (const auto &[name, reference] : outputs_) {
+    auto value = values.find(reference);
+    if (value == values.end() || !value->second.IsTensor()) {
+      throw std::invalid_argument("Pipeline output " + name + " reads " + reference + ", which is not a tensor");
+    }
+    results.emplace_back(name, std::move(value->second));
+  }
+  return results;
+}
+
+std::vector<std::pair<std::string, Ort::Value>> runGlueOp(const PipelineStage &stage,
+                                                          const std::map<std::string, const OrtValue *> &inputs) {
+  TraceScope trace("runGlueOp");
+  const OpSignature *signature = findSignature(stage.op);
+  if (signature == nullptr) {
+    throw std::invalid_argument("Unknown op: " + stage.op);
+  }
+  for (const std::string &input : signature->inputs) {
+    auto it = inputs.find(input);
+    if (it == inputs.end() || it->second == nullptr) {
+      throw std::invalid_argument("Op " + stage.op + " needs an input " + input);
+    }
+  }
+
+  std::vector<Ort::Value> outputs;
+  runOp(stage, inputs, &outputs);
+  std::vector<std::pair<std::string, Ort::Value>> results;
+  for (size_t i = 0; i < outputs.size(); i++) {
+    results.emplace_back(signature->outputs[i], std::move(outputs[i]));
+  }
+  return results;
+}
+
+PipelineHandle PipelineManager::addPipeline(std::shared_ptr<Pipeline> pipeline) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pipelines_.insert(std::move(pipeline));
+}
+
+std::shared_ptr<Pipeline> PipelineManager::findPipeline(PipelineHandle pipeline_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_ptr<Pipeline> *pipeline = pipelines_.find(pipeline_id);
+  return pipeline != nullptr ? *pipeline : nullptr;
+}
+
+bool PipelineManager::closePipeline(PipelineHandle pipeline_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pipelines_.erase(pipeline_id);
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,110 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_PIPELINE_H_
+#define FLUTTER_ONNXRUNTIME_PIPELINE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "handle_table.h"
+#include "session_manager.h"
+
+namespace flutter_onnxruntime {
+
+// A stage of a pipeline: a session run or one of the built-in glue ops of pipeline_ops.h.
+//   session:    inputs by model input name; outputs named after the model outputs
+//   slice:      input -> output; lists starts, ends and optional axes
+//   cropResize: image [1, C, H, W] or [C, H, W] and boxes [K, 4] -> output [K, C, height, width]; scalars height
+//               and width
+//   argmax:     input -> int64 output without the reduced axis; scalar axis, -1 by default
+//   softmax:    input -> output of the same shape; scalar axis, -1 by default
+//   sigmoid:    input -> output of the same shape
+//   topK:       input -> values and int64 indices of the k largest elements along the last axis; scalar k
+//   nms:        boxes [N, 4] and scores [N] -> kept boxes, scores and int64 indices; scalars iouThreshold (0.5),
+//               scoreThreshold (none) and maxDetections (0 for all)
+// Glue ops read float32 tensors, except slice, which takes any fixed-size type.
+struct PipelineStage {
+  std::string name;
+  std::string op;
+  SessionHandle session = kInvalidHandle;
+
+  // Value of each input, either "stage/output" or the name of a pipeline input
+  std::map<std::string, std::string> inputs;
+
+  // Parameters of a glue op
+  std::map<std::string, double> scalars;
+  std::map<std::string, std::vector<int64_t>> lists;
+};
+
+// Stages of a pipeline in any order, and the values returned by each pipeline output name
+struct PipelineDescription {
+  std::vector<PipelineStage> stages;
+  std::map<std::string, std::string> outputs;
+};
+
+// Runs a DAG of sessions and glue ops in one call, handing every intermediate value straight to the stages that
+// read it and freeing it after its last reader. Stages hold their sessions by handle, so a pipeline fails to run
+// once one of its sessions is closed.
+class Pipeline {
+public:
+  // Check and order the stages of a description; throws std::invalid_argument if a stage is malformed, reads a
+  // value no stage produces, or the stages form a cycle
+  Pipeline(PipelineDescription description, SessionManager &session_manager);
+
+  // Run the stages on borrowed pipeline inputs, which the caller keeps alive for the duration of the call, and
+  // return the pipeline outputs by name. Throws std::invalid_argument if an input is missing, a glue op gets a
+  // tensor it cannot read (of another type or in device memory), or a pipeline output has no tensor value.
+  std::vector<std::pair<std::string, Ort::Value>> run(SessionManager &session_manager,
+                                                      const std::map<std::string, const OrtValue *> &inputs,
+                                                      Ort::RunOptions *run_options = nullptr);
+
+private:
+  // Stages in an order where every stage comes after the stages it reads from
+  std::vector<PipelineStage> stages_;
+
+  // Output names of each stage of stages_
+  std::vector<std::vector<std::string>> stage_outputs_;
+
+  // Intermediate values that are freed once each stage of stages_ has run
+  std::vector<std::vector<std::string>> released_after_;
+
+  std::map<std::string, std::string> outputs_;
+};
+
+// Run a glue op on its own on borrowed inputs by input name, for post-processing stored tensors without a pipeline,
+// and return its outputs by the names of its signature. The name of the stage is only used in error messages.
+// Throws std::invalid_argument if the op is unknown, an input is missing or the op cannot read it.
+std::vector<std::pair<std::string, Ort::Value>> runGlueOp(const PipelineStage &stage,
+                                                          const std::map<std::string, const OrtValue *> &inputs);
+
+// Handle of a pipeline stored in a PipelineManager
+using PipelineHandle = Handle;
+
+// Pipelines by handle; shared so that a pipeline closed while it runs stays alive until the run ends
+class PipelineManager {
+public:
+  PipelineHandle addPipeline(std::shared_ptr<Pipeline> pipeline);
+
+  // Get a pipeline, or nullptr if the handle is unknown
+  std::shared_ptr<Pipeline> findPipeline(PipelineHandle pipeline_id);
+
+  // Remove a pipeline; returns false if the handle is unknown
+  bool closePipeline(PipelineHandle pipeline_id);
+
+private:
+  std::mutex mutex_;
+  HandleTable<std::shared_ptr<Pipeline>> pipelines_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_PIPELINE_H_
@@ -0,0 +1,654 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "pipeline_ops.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PIPELINE_OPS_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PIPELINE_OPS_NEON 1
+#endif
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// More threads do not help a memory-bound loop
+constexpr size_t kMaxOpThreads = 4;
+
+// Range of expElements: below kExpMin the result is flushed to 0, above kExpMax it is clamped, so that the power of
+// two built from the exponent bits stays a normal float
+constexpr float kExpMin = -87.3f;
+constexpr float kExpMax = 88.0f;
+constexpr float kLog2e = 1.44269504088896341f;
+
+// ln(2) split in a part exact in float and the rest, so that x - n * ln(2) keeps its precision
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+
+// Minimax polynomial of exp(r) - 1 - r over r in [-ln(2) / 2, ln(2) / 2], highest degree first (Cephes expf)
+constexpr float kExpPoly[6] = {1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+                               4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f};
+
+// exp(x) = 2^n * exp(r) with n = round(x * log2(e)) and r = x - n * ln(2)
+inline float expScalar(float x) {
+  if (x != x) {
+    return x;
+  }
+  if (x < kExpMin) {
+    return 0.0f;
+  }
+  x = x < kExpMax ? x : kExpMax;
+  float n = std::nearbyint(x * kLog2e);
+  float r = x - n * kLn2Hi - n * kLn2Lo;
+  float y = kExpPoly[0];
+  for (int i = 1; i < 6; i++) {
+    y = y * r + kExpPoly[i];
+  }
+  y = y * r * r + r + 1.0f;
+  uint32_t bits = static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23;
+  float power;
+  std::memcpy(&power, &bits, sizeof(power));
+  return y * power;
+}
+
+#if defined(PIPELINE_OPS_SSE2)
+
+inline __m128 expVector(__m128 x) {
+  __m128 is_nan = _mm_cmpunord_ps(x, x);
+  __m128 underflow = _mm_cmplt_ps(x, _mm_set1_ps(kExpMin));
+  __m128 clamped = _mm_max_ps(_mm_min_ps(x, _mm_set1_ps(kExpMax)), _mm_set1_ps(kExpMin));
+
+  // _mm_cvtps_epi32 rounds to nearest even like std::nearbyint under the default rounding mode
+  __m128i n = _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(kLog2e)));
+  __m128 nf = _mm_cvtepi32_ps(n);
+  __m128 r = _mm_sub_ps(_mm_sub_ps(clamped, _mm_mul_ps(nf, _mm_set1_ps(kLn2Hi))), _mm_mul_ps(nf, _mm_set1_ps(kLn2Lo)));
+  __m128 y = _mm_set1_ps(kExpPoly[0]);
+  for (int i = 1; i < 6; i++) {
+    y = _mm_add_ps(_mm_mul_ps(y, r), _mm_set1_ps(kExpPoly[i]));
+  }
+  y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(y, r), r), r), _mm_set1_ps(1.0f));
+  __m128 power = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+  __m128 result = _mm_andnot_ps(underflow, _mm_mul_ps(y, power));
+  return _mm_or_ps(_mm_and_ps(is_nan, x), _mm_andnot_ps(is_nan, result));
+}
+
+#elif defined(PIPELINE_OPS_NEON)
+
+inline float32x4_t expVector(float32x4_t x) {
+  uint32x4_t is_number = vceqq_f32(x, x);
+  uint32x4_t underflow = vcltq_f32(x, vdupq_n_f32(kExpMin));
+  float32x4_t clamped = vmaxq_f32(vminq_f32(x, vdupq_n_f32(kExpMax)), vdupq_n_f32(kExpMin));
+
+  int32x4_t n = vcvtnq_s32_f32(vmulq_f32(clamped, vdupq_n_f32(kLog2e)));
+  float32x4_t nf = vcvtq_f32_s32(n);
+  float32x4_t r = vsubq_f32(vsubq_f32(clamped, vmulq_f32(nf, vdupq_n_f32(kLn2Hi))), vmulq_f32(nf, vdupq_n_f32(kLn2Lo)));
+  float32x4_t y = vdupq_n_f32(kExpPoly[0]);
+  for (int i = 1; i < 6; i++) {
+    y = vaddq_f32(vmulq_f32(y, r), vdupq_n_f32(kExpPoly[i]));
+  }
+  y = vaddq_f32(vaddq_f32(vmulq_f32(vmulq_f32(y, r), r), r), vdupq_n_f32(1.0f));
+  float32x4_t power = vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23));
+  float32x4_t result = vbslq_f32(underflow, vdupq_n_f32(0.0f), vmulq_f32(y, power));
+  return vbslq_f32(is_number, result, x);
+}
+
+#endif
+
+void expRange(const float *src, size_t count, float *dst) {
+  size_t i = 0;
+#if defined(PIPELINE_OPS_SSE2)
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(dst + i, expVector(_mm_loadu_ps(src + i)));
+  }
+#elif defined(PIPELINE_OPS_NEON)
+  for (; i + 4 <= count; i += 4) {
+    vst1q_f32(dst + i, expVector(vld1q_f32(src + i)));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = expScalar(src[i]);
+  }
+}
+
+// Run fn(begin, end) over ranges of [0, count) items on several threads once the work, the number of elements the
+// items touch, reaches kParallelOpThreshold
+template <typename Fn> void parallelRanges(size_t count, size_t work, const Fn &fn) {
+  size_t num_threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), kMaxOpThreads);
+  num_threads = std::min(num_threads, count);
+  if (work < kParallelOpThreshold || num_threads < 2) {
+    fn(size_t{0}, count);
+    return;
+  }
+
+  size_t chunk = (count + num_threads - 1) / num_threads;
+  std::vector<std::thread> workers;
+  for (size_t begin = chunk; begin < count; begin += chunk) {
+    workers.emplace_back(fn, begin, std::min(begin + chunk, count));
+  }
+  fn(size_t{0}, std::min(chunk, count));
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+}
+
+// Softmax of contiguous rows
+void softmaxRows(const float *src, size_t cols, size_t begin, size_t end, float *dst) {
+  for (size_t row = begin; row < end; row++) {
+    const float *in = src + row * cols;
+    float *out = dst + row * cols;
+    float max = in[0];
+    for (size_t j = 1; j < cols; j++) {
+      max = in[j] > max ? in[j] : max;
+    }
+    for (size_t j = 0; j < cols; j++) {
+      out[j] = in[j] - max;
+    }
+    expRange(out, cols, out);
+    float sum = 0.0f;
+    for (size_t j = 0; j < cols; j++) {
+      sum += out[j];
+    }
+    float inverse = 1.0f / sum;
+    for (size_t j = 0; j < cols; j++) {
+      out[j] *= inverse;
+    }
+  }
+}
+
+// Softmax along the middle axis of [outer, count, inner] blocks, over columns [inner_begin, inner_end) of every
+// block, keeping the loops along the contiguous inner axis
+void softmaxColumns(const float *src, size_t outer, size_t count, size_t inner, size_t inner_begin, size_t inner_end,
+                    float *dst) {
+  size_t width = inner_end - inner_begin;
+  std::vector<float> max(width);
+  std::vector<float> sum(width);
+  for (size_t o = 0; o < outer; o++) {
+    const float *in = src + o * count * inner + inner_begin;
+    float *out = dst + o * count * inner + inner_begin;
+    std::copy(in, in + width, max.begin());
+    for (size_t j = 1; j < count; j++) {
+      for (size_t i = 0; i < width; i++) {
+        max[i] = in[j * inner + i] > max[i] ? in[j * inner + i] : max[i];
+      }
+    }
+    std::fill(sum.begin(), sum.end(), 0.0f);
+    for (size_t j = 0; j < count; j++) {
+      for (size_t i = 0; i < width; i++) {
+        out[j * inner + i] = in[j * inner + i] - max[i];
+      }
+      expRange(out + j * inner, width, out + j * inner);
+      for (size_t i = 0; i < width; i++) {
+        sum[i] += out[j * inner + i];
+      }
+    }
+    for (size_t i = 0; i < width; i++) {
+      sum[i] = 1.0f / sum[i];
+    }
+    for (size_t j = 0; j < count; j++) {
+      for (size_t i = 0; i < width; i++) {
+        out[j * inner + i] *= sum[i];
+      }
+    }
+  }
+}
+
+// Area of the intersection of two boxes over the area of their union, with corners in any order
+float intersectionOverUnion(const float *a, const float *b) {
+  float a_x1 = std::min(a[0], a[2]), a_x2 = std::max(a[0], a[2]);
+  float a_y1 = std::min(a[1], a[3]), a_y2 = std::max(a[1], a[3]);
+  float b_x1 = std::min(b[0], b[2]), b_x2 = std::max(b[0], b[2]);
+  float b_y1 = std::min(b[1], b[3]), b_y2 = std::max(b[1], b[3]);
+
+  float intersection = std::max(0.0f, std::min(a_x2, b_x2) - std::max(a_x1, b_x1)) *
+                       std::max(0.0f, std::min(a_y2, b_y2) - std::max(a_y1, b_y1));
+  float union_area = (a_x2 - a_x1) * (a_y2 - a_y1) + (b_x2 - b_x1) * (b_y2 - b_y1) - intersection;
+  return union_area > 0.0f ? intersection / union_area : 0.0f;
+}
+
+// Side of the square tiles of transposeElements; 32 x 32 elements of up to 8 bytes fit in a level 1 cache
+constexpr size_t kTransposeTile = 32;
+
+// Copy the elements of a transpose, of one C++ type of their size so that every move is a plain load and store
+template <typename T>
+void transposeAs(const T *src, const std::vector<int64_t> &shape, const std::vector<int64_t> &perm, T *dst) {
+  size_t rank = shape.size();
+  std::vector<size_t> src_strides(rank, 1);
+  for (size_t d = rank - 1; d > 0; d--) {
+    src_strides[d - 1] = src_strides[d] * static_cast<size_t>(shape[d]);
+  }
+
+  // Size, source stride and destination stride of every output axis
+  std::vector<size_t> sizes(rank);
+  std::vector<size_t> strides(rank);
+  for (size_t i = 0; i < rank; i++) {
+    sizes[i] = static_cast<size_t>(shape[perm[i]]);
+    strides[i] = src_strides[perm[i]];
+  }
+  std::vector<size_t> dst_strides(rank, 1);
+  for (size_t d = rank - 1; d > 0; d--) {
+    dst_strides[d - 1] = dst_strides[d] * sizes[d];
+  }
+
+  // The last output axis is contiguous in dst; the output axis read from the last input axis is contiguous in src
+  size_t last = rank - 1;
+  size_t contiguous =
+      static_cast<size_t>(std::find(perm.begin(), perm.end(), static_cast<int64_t>(last)) - perm.begin());
+
+  // Every other output axis is walked by decomposing a flat index
+  std::vector<size_t> outer_axes;
+  size_t outer_count = 1;
+  for (size_t i = 0; i < rank; i++) {
+    if (i != last && i != contiguous) {
+      outer_axes.push_back(i);
+      outer_count *= sizes[i];
+    }
+  }
+
+  for (size_t outer = 0; outer < outer_count; outer++) {
+    size_t src_offset = 0;
+    size_t dst_offset = 0;
+    size_t rest = outer;
+    for (size_t k = outer_axes.size(); k > 0; k--) {
+      size_t axis = outer_axes[k - 1];
+      size_t index = rest % sizes[axis];
+      rest /= sizes[axis];
+      src_offset += index * strides[axis];
+      dst_offset += index * dst_strides[axis];
+    }
+
+    if (contiguous == last) {
+      std::copy(src + src_offset, src + src_offset + sizes[last], dst + dst_offset);
+      continue;
+    }
+    size_t rows = sizes[contiguous];
+    size_t cols = sizes[last];
+    for (size_t row_begin = 0; row_begin < rows; row_begin += kTransposeTile) {
+      size_t row_end = std::min(row_begin + kTransposeTile, rows);
+      for (size_t col_begin = 0; col_begin < cols; col_begin += kTransposeTile) {
+        size_t col_end = std::min(col_begin + kTransposeTile, cols);
+        for (size_t row = row_begin; row < row_end; row++) {
+          const T *in = src + src_offset + row;
+          T *out = dst + dst_offset + row * dst_strides[contiguous];
+          for (size_t col = col_begin; col < col_end; col++) {
+            out[col] = in[col * strides[last]];
+          }
+        }
+      }
+    }
+  }
+}
+
+// Source coordinate of an output pixel center when a span is resized to size pixels, clamped to the image
+float sourceCoordinate(float start, float end, int64_t index, int64_t size, int64_t limit) {
+  float coordinate = start + (static_cast<float>(index) + 0.5f) * (end - start) / static_cast<float>(size) - 0.5f;
+  return std::clamp(coordinate, 0.0f, static_cast<float>(limit - 1));
+}
+
+} // namespace
+
+void softmaxAxis(const float *src, const std::vector<int64_t> &shape, size_t axis, float *dst) {
+  size_t outer = static_cast<size_t>(
+      std::accumulate(shape.begin(), shape.begin() + axis, int64_t{1}, std::multiplies<int64_t>()));
+  size_t count = static_cast<size_t>(shape[axis]);
+  size_t inner = static_cast<size_t>(
+      std::accumulate(shape.begin() + axis + 1, shape.end(), int64_t{1}, std::multiplies<int64_t>()));
+  size_t total = outer * count * inner;
+  if (total == 0) {
+    return;
+  }
+
+  if (inner == 1) {
+    parallelRanges(outer, total, [src, count, dst](size_t begin, size_t end) {
+      softmaxRows(src, count, begin, end, dst);
+    });
+  } else if (outer > 1) {
+    parallelRanges(outer, total, [src, count, inner, dst](size_t begin, size_t end) {
+      softmaxColumns(src + begin * count * inner, end - begin, count, inner, 0, inner, dst + begin * count * inner);
+    });
+  } else {
+    parallelRanges(inner, total, [src, count, inner, dst](size_t begin, size_t end) {
+      softmaxColumns(src, 1, count, inner, begin, end, dst);
+    });
+  }
+}
+
+void sigmoidElements(const float *src, size_t count, float *dst) {
+  parallelRanges(count, count, [src, dst](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      dst[i] = -src[i];
+    }
+    expRange(dst + begin, end - begin, dst + begin);
+    for (size_t i = begin; i < end; i++) {
+      dst[i] = 1.0f / (1.0f + dst[i]);
+    }
+  });
+}
+
+void expElements(const float *src, size_t count, float *dst) {
+  parallelRanges(count, count,
+                 [src, dst](size_t begin, size_t end) { expRange(src + begin, end - begin, dst + begin); });
+}
+
+void resolveSlice(const std::vector<int64_t> &shape, const std::vector<int64_t> &starts,
+                  const std::vector<int64_t> &ends, const std::vector<int64_t> &axes, std::vector<int64_t> *offsets,
+                  std::vector<int64_t> *sizes) {
+  if (starts.size() != ends.size() || (!axes.empty() && axes.size() != starts.size())) {
+    throw std::invalid_argument("Slice starts, ends and axes must have the same length");
+  }
+  if (axes.empty() && starts.size() > shape.size()) {
+    throw std::invalid_argument("Slice has more starts than the input has dimensions");
+  }
+
+  int64_t rank = static_cast<int64_t>(shape.size());
+  offsets->assign(shape.size(), 0);
+  *sizes = shape;
+  for (size_t i = 0; i < starts.size(); i++) {
+    int64_t axis = axes.empty() ? static_cast<int64_t>(i) : axes[i];
+    if (axis < 0) {
+      axis += rank;
+    }
+    if (axis < 0 || axis >= rank) {
+      throw std::invalid_argument("Slice axis out of range: " + std::to_string(axes.empty() ? i : axes[i]));
+    }
+
+    int64_t dim = shape[axis];
+    int64_t start = starts[i] < 0 ? starts[i] + dim : starts[i];
+    int64_t end = ends[i] < 0 ? ends[i] + dim : ends[i];
+    start = std::clamp<int64_t>(start, 0, dim);
+    end = std::clamp<int64_t>(end, start, dim);
+    (*offsets)[axis] = start;
+    (*sizes)[axis] = end - start;
+  }
+}
+
+void sliceElements(const void *src, size_t element_size, const std::vector<int64_t> &shape,
+                   const std::vector<int64_t> &offsets, const std::vector<int64_t> &sizes, void *dst) {
+  size_t rank = shape.size();
+  if (rank == 0) {
+    std::memcpy(dst, src, element_size);
+    return;
+  }
+  for (int64_t size : sizes) {
+    if (size == 0) {
+      return;
+    }
+  }
+
+  // Element strides of the source, and the contiguous run copied per outer index
+  std::vector<size_t> strides(rank, 1);
+  for (size_t d = rank - 1; d > 0; d--) {
+    strides[d - 1] = strides[d] * static_cast<size_t>(shape[d]);
+  }
+  size_t run_bytes = static_cast<size_t>(sizes[rank - 1]) * element_size;
+
+  const uint8_t *source = static_cast<const uint8_t *>(src);
+  uint8_t *out = static_cast<uint8_t *>(dst);
+  std::vector<int64_t> index(rank, 0);
+  while (true) {
+    size_t offset = 0;
+    for (size_t d = 0; d < rank; d++) {
+      offset += static_cast<size_t>(offsets[d] + index[d]) * strides[d];
+    }
+    std::memcpy(out, source + offset * element_size, run_bytes);
+    out += run_bytes;
+
+    // Advance the outer index like an odometer, leaving the last dimension to the memcpy
+    size_t d = rank - 1;
+    while (d > 0) {
+      d--;
+      if (++index[d] < sizes[d]) {
+        break;
+      }
+      index[d] = 0;
+      if (d == 0) {
+        return;
+      }
+    }
+    if (rank == 1) {
+      return;
+    }
+  }
+}
+
+std::vector<int64_t> resolveReshape(const std::vector<int64_t> &shape, const std::vector<int64_t> &target) {
+  int64_t count = std::accumulate(shape.begin(), shape.end(), int64_t{1}, std::multiplies<int64_t>());
+  std::vector<int64_t> resolved = target;
+  int64_t known = 1;
+  int64_t inferred = -1;
+  for (size_t i = 0; i < resolved.size(); i++) {
+    if (resolved[i] == 0) {
+      if (i >= shape.size()) {
+        throw std::invalid_argument("Reshape keeps dimension " + std::to_string(i) +
+                                    ", which the tensor does not have");
+      }
+      resolved[i] = shape[i];
+    } else if (resolved[i] == -1) {
+      if (inferred >= 0) {
+        throw std::invalid_argument("Reshape can infer only one dimension");
+      }
+      inferred = static_cast<int64_t>(i);
+      continue;
+    } else if (resolved[i] < 0) {
+      throw std::invalid_argument("Reshape dimensions must be -1 or more");
+    }
+    known *= resolved[i];
+  }
+  if (inferred >= 0) {
+    if (known == 0 || count % known != 0) {
+      throw std::invalid_argument("Cannot infer a dimension of the reshape of " + std::to_string(count) + " elements");
+    }
+    resolved[inferred] = count / known;
+    known = count;
+  }
+  if (known != count) {
+    throw std::invalid_argument("Cannot reshape " + std::to_string(count) + " elements into " +
+                                std::to_string(known));
+  }
+  return resolved;
+}
+
+std::vector<int64_t> resolvePermutation(size_t rank, const std::vector<int64_t> &perm) {
+  std::vector<int64_t> resolved(rank);
+  if (perm.empty()) {
+    for (size_t i = 0; i < rank; i++) {
+      resolved[i] = static_cast<int64_t>(rank - 1 - i);
+    }
+    return resolved;
+  }
+  if (perm.size() != rank) {
+    throw std::invalid_argument("Transpose needs " + std::to_string(rank) + " axes");
+  }
+  std::vector<bool> seen(rank, false);
+  for (size_t i = 0; i < rank; i++) {
+    int64_t axis = perm[i] < 0 ? perm[i] + static_cast<int64_t>(rank) : perm[i];
+    if (axis < 0 || axis >= static_cast<int64_t>(rank) || seen[axis]) {
+      throw std::invalid_argument("Transpose axes must be a permutation of the axes of the tensor");
+    }
+    seen[axis] = true;
+    resolved[i] = axis;
+  }
+  return resolved;
+}
+
+void transposeElements(const void *src, size_t element_size, const std::vector<int64_t> &shape,
+                       const std::vector<int64_t> &perm, void *dst) {
+  if (shape.empty()) {
+    std::memcpy(dst, src, element_size);
+    return;
+  }
+  for (int64_t dim : shape) {
+    if (dim == 0) {
+      return;
+    }
+  }
+  switch (element_size) {
+  case 1:
+    transposeAs(static_cast<const uint8_t *>(src), shape, perm, static_cast<uint8_t *>(dst));
+    break;
+  case 2:
+    transposeAs(static_cast<const uint16_t *>(src), shape, perm, static_cast<uint16_t *>(dst));
+    break;
+  case 4:
+    transposeAs(static_cast<const uint32_t *>(src), shape, perm, static_cast<uint32_t *>(dst));
+    break;
+  case 8:
+    transposeAs(static_cast<const uint64_t *>(src), shape, perm, static_cast<uint64_t *>(dst));
+    break;
+  default:
+    throw std::invalid_argument("Cannot transpose elements of " + std::to_string(element_size) + " bytes");
+  }
+}
+
+void concatElements(const std::vector<const void *> &srcs, const std::vector<std::vector<int64_t>> &shapes,
+                    size_t element_size, size_t axis, void *dst) {
+  if (srcs.empty()) {
+    return;
+  }
+  const std::vector<int64_t> &first = shapes[0];
+  size_t outer = static_cast<size_t>(
+      std::accumulate(first.begin(), first.begin() + axis, int64_t{1}, std::multiplies<int64_t>()));
+  size_t inner = static_cast<size_t>(
+      std::accumulate(first.begin() + axis + 1, first.end(), int64_t{1}, std::multiplies<int64_t>()));
+
+  uint8_t *out = static_cast<uint8_t *>(dst);
+  for (size_t o = 0; o < outer; o++) {
+    for (size_t i = 0; i < srcs.size(); i++) {
+      size_t run_bytes = static_cast<size_t>(shapes[i][axis]) * inner * element_size;
+      if (run_bytes > 0) {
+        std::memcpy(out, static_cast<const uint8_t *>(srcs[i]) + o * run_bytes, run_bytes);
+      }
+      out += run_bytes;
+    }
+  }
+}
+
+void argmaxAxis(const float *src, const std::vector<int64_t> &shape, size_t axis, int64_t *dst) {
+  size_t outer = static_cast<size_t>(
+      std::accumulate(shape.begin(), shape.begin() + axis, int64_t{1}, std::multiplies<int64_t>()));
+  size_t count = static_cast<size_t>(shape[axis]);
+  size_t inner = static_cast<size_t>(
+      std::accumulate(shape.begin() + axis + 1, shape.end(), int64_t{1}, std::multiplies<int64_t>()));
+
+  // The best value of every column is kept next to its index, so that the loops run along the contiguous inner axis
+  auto argmax_blocks = [src, count, inner, dst](size_t o_begin, size_t o_end, size_t i_begin, size_t i_end) {
+    std::vector<float> best(i_end - i_begin);
+    for (size_t o = o_begin; o < o_end; o++) {
+      const float *block = src + o * count * inner;
+      int64_t *out = dst + o * inner;
+      for (size_t i = i_begin; i < i_end; i++) {
+        best[i - i_begin] = block[i];
+        out[i] = 0;
+      }
+      for (size_t j = 1; j < count; j++) {
+        const float *row = block + j * inner;
+        for (size_t i = i_begin; i < i_end; i++) {
+          if (row[i] > best[i - i_begin]) {
+            best[i - i_begin] = row[i];
+            out[i] = static_cast<int64_t>(j);
+          }
+        }
+      }
+    }
+  };
+
+  size_t total = outer * count * inner;
+  if (outer > 1 || inner == 1) {
+    parallelRanges(outer, total, [&](size_t begin, size_t end) { argmax_blocks(begin, end, 0, inner); });
+  } else {
+    parallelRanges(inner, total, [&](size_t begin, size_t end) { argmax_blocks(0, 1, begin, end); });
+  }
+}
+
+void topKRows(const float *src, int64_t rows, int64_t cols, int64_t k, float *values, int64_t *indices) {
+  size_t work = static_cast<size_t>(rows) * static_cast<size_t>(cols);
+  parallelRanges(static_cast<size_t>(rows), work, [src, cols, k, values, indices](size_t begin, size_t end) {
+    std::vector<int64_t> order(cols);
+    for (int64_t r = static_cast<int64_t>(begin); r < static_cast<int64_t>(end); r++) {
+      const float *row = src + r * cols;
+      std::iota(order.begin(), order.end(), 0);
+      std::partial_sort(order.begin(), order.begin() + k, order.end(), [row](int64_t a, int64_t b) {
+        return row[a] > row[b] || (row[a] == row[b] && a < b);
+      });
+      for (int64_t i = 0; i < k; i++) {
+        values[r * k + i] = row[order[i]];
+        indices[r * k + i] = order[i];
+      }
+    }
+  });
+}
+
+std::vector<int64_t> nonMaxSuppression(const float *boxes, const float *scores, int64_t count, float iou_threshold,
+                                       float score_threshold, int64_t max_detections) {
+  std::vector<int64_t> candidates;
+  for (int64_t i = 0; i < count; i++) {
+    if (scores[i] >= score_threshold) {
+      candidates.push_back(i);
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [scores](int64_t a, int64_t b) { return scores[a] > scores[b]; });
+
+  std::vector<int64_t> kept;
+  for (int64_t candidate : candidates) {
+    if (max_detections > 0 && static_cast<int64_t>(kept.size()) >= max_detections) {
+      break;
+    }
+    bool suppressed = false;
+    for (int64_t k : kept) {
+      if (intersectionOverUnion(boxes + candidate * 4, boxes + k * 4) > iou_threshold) {
+        suppressed = true;
+        break;
+      }
+    }
+    if (!suppressed) {
+      kept.push_back(candidate);
+    }
+  }
+  return kept;
+}
+
+void cropResize(const float *image, int64_t channels, int64_t height, int64_t width, const float *boxes,
+                int64_t box_count, int64_t out_height, int64_t out_width, float *dst) {
+  // Source coordinates are clamped to [0, size - 1], which needs a non-empty image
+  if (height < 1 || width < 1 || out_height < 1 || out_width < 1) {
+    throw std::invalid_argument("Crop and resize needs positive image and output sizes");
+  }
+  size_t plane = static_cast<size_t>(height * width);
+  for (int64_t b = 0; b < box_count; b++) {
+    const float *box = boxes + b * 4;
+    for (int64_t oy = 0; oy < out_height; oy++) {
+      float y = sourceCoordinate(box[1], box[3], oy, out_height, height);
+      int64_t y0 = static_cast<int64_t>(y);
+      int64_t y1 = std::min(y0 + 1, height - 1);
+      float wy = y - static_cast<float>(y0);
+      for (int64_t ox = 0; ox < out_width; ox++) {
+        float x = sourceCoordinate(box[0], box[2], ox, out_width, width);
+        int64_t x0 = static_cast<int64_t>(x);
+        int64_t x1 = std::min(x0 + 1, width - 1);
+        float wx = x - static_cast<float>(x0);
+        for (int64_t c = 0; c < channels; c++) {
+          const float *src = image + c * plane;
+          float top = src[y0 * width + x0] * (1.0f - wx) + src[y0 * width + x1] * wx;
+          float bottom = src[y1 * width + x0] * (1.0f - wx) + src[y1 * width + x1] * wx;
+          dst[((b * channels + c) * out_height + oy) * out_width + ox] = top * (1.0f - wy) + bottom * wy;
+        }
+      }
+    }
+  }
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,86 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_PIPELINE_OPS_H_
+#define FLUTTER_ONNXRUNTIME_PIPELINE_OPS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace flutter_onnxruntime {
+
+// Built-in glue ops run between the sessions of a pipeline, or on their own on stored tensors, on row-major host
+// buffers
+
+// Ops on at least this many elements split their rows across several threads
+constexpr size_t kParallelOpThreshold = 1 << 16;
+
+// Resolve the starts and ends of a slice on some axes, as in the ONNX Slice op with unit steps: negative values count
+// from the end of their axis and all values are clamped to it. Every axis not listed is kept whole. Fills the offset
+// and size of the slice along every dimension; throws std::invalid_argument if the lists do not match or an axis is
+// out of range.
+void resolveSlice(const std::vector<int64_t> &shape, const std::vector<int64_t> &starts,
+                  const std::vector<int64_t> &ends, const std::vector<int64_t> &axes, std::vector<int64_t> *offsets,
+                  std::vector<int64_t> *sizes);
+
+// Copy the slice given by resolveSlice out of src into dst, which holds the product of sizes elements
+void sliceElements(const void *src, size_t element_size, const std::vector<int64_t> &shape,
+                   const std::vector<int64_t> &offsets, const std::vector<int64_t> &sizes, void *dst);
+
+// Resolve the target shape of a reshape, as in the ONNX Reshape op: 0 keeps the dimension of shape at the same index
+// and one dimension may be -1, inferred from the others. Throws std::invalid_argument if the target does not hold
+// as many elements as shape.
+std::vector<int64_t> resolveReshape(const std::vector<int64_t> &shape, const std::vector<int64_t> &target);
+
+// Resolve the permutation of a transpose of rank axes: empty reverses the axes, as in the ONNX Transpose op, and
+// negative axes count from the end. Throws std::invalid_argument if perm is not a permutation of the axes.
+std::vector<int64_t> resolvePermutation(size_t rank, const std::vector<int64_t> &perm);
+
+// Permute the axes of a tensor of shape into dst, whose axis i is axis perm[i] of src. When the axes that are
+// contiguous in src and dst differ, they are copied in square tiles so that both sides stay in cache.
+void transposeElements(const void *src, size_t element_size, const std::vector<int64_t> &shape,
+                       const std::vector<int64_t> &perm, void *dst);
+
+// Concatenate tensors that match in every dimension but axis into dst, one run of each source per outer index
+void concatElements(const std::vector<const void *> &srcs, const std::vector<std::vector<int64_t>> &shapes,
+                    size_t element_size, size_t axis, void *dst);
+
+// Index of the largest element along an axis; dst holds the elements of shape without that axis. Ties keep the
+// first index.
+void argmaxAxis(const float *src, const std::vector<int64_t> &shape, size_t axis, int64_t *dst);
+
+// Softmax along an axis, as in the ONNX Softmax op: exp(x - max) / sum(exp(x - max)) over every slice along the
+// axis. dst holds a tensor of the same shape and may be src.
+void softmaxAxis(const float *src, const std::vector<int64_t> &shape, size_t axis, float *dst);
+
+// Logistic sigmoid 1 / (1 + exp(-x)) of count elements; dst may be src
+void sigmoidElements(const float *src, size_t count, float *dst);
+
+// exp(x) of count elements by the polynomial of the softmax and sigmoid kernels, with SSE2 (x86-64) and NEON
+// (ARM64) paths: within 2 ulp of std::exp, 0 below -87.3 (where std::exp is denormal or 0), exp(88) above 88 and
+// NaN for NaN. dst may be src.
+void expElements(const float *src, size_t count, float *dst);
+
+// The k largest elements of every row of a rows x cols matrix and their indices, in descending order; k must not
+// exceed cols
+void topKRows(const float *src, int64_t rows, int64_t cols, int64_t k, float *values, int64_t *indices);
+
+// Indices of the boxes kept by greedy non-maximum suppression, by descending score. Boxes are (x1, y1, x2, y2)
+// corners; a box is dropped if its score is below score_threshold or its intersection over union with a kept box
+// exceeds iou_threshold. max_detections of 0 keeps every box that survives.
+std::vector<int64_t> nonMaxSuppression(const float *boxes, const float *scores, int64_t count, float iou_threshold,
+                                       float score_threshold, int64_t max_detections);
+
+// Crop regions of a CHW image and resize each to out_height x out_width with bilinear filtering, into dst of shape
+// [box_count, channels, out_height, out_width]. Boxes are (x1, y1, x2, y2) pixel corners and may extend past the
+// image, whose edge pixels are repeated. Throws std::invalid_argument if a size is not positive.
+void cropResize(const float *image, int64_t channels, int64_t height, int64_t width, const float *boxes,
+                int64_t box_count, int64_t out_height, int64_t out_width, float *dst);
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_PIPELINE_OPS_H_
@@ -0,0 +1,322 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "profile_summary.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// Suffix of the event that covers the kernel of a node; the fences around it have their own events
+const char kKernelTimeSuffix[] = "_kernel_time";
+
+// Reads the parts of a JSON document that a trace event needs and skips everything else
+class JsonReader {
+public:
+  explicit JsonReader(const std::string &text) : text_(text) {}
+
+  char peek() {
+    skipWhitespace();
+    return pos_ < text_.size() ? text_[pos_] : '\0';
+  }
+
+  void expect(char c) {
+    if (peek() != c) {
+      fail(std::string("expected '") + c + "'");
+    }
+    pos_++;
+  }
+
+  bool atEnd() { return peek() == '\0'; }
+
+  std::string readString() {
+    expect('"');
+    std::string value;
+    while (pos_ < text_.size() && text_[pos_] != '"') {
+      char c = text_[pos_++];
+      if (c != '\\') {
+        value += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) {
+        break;
+      }
+      char escaped = text_[pos_++];
+      switch (escaped) {
+      case 'b':
+        value += '\b';
+        break;
+      case 'f':
+        value += '\f';
+        break;
+      case 'n':
+        value += '\n';
+        break;
+      case 'r':
+        value += '\r';
+        break;
+      case 't':
+        value += '\t';
+        break;
+      case 'u':
+        appendUtf8(readCodePoint(), value);
+        break;
+      default:
+        value += escaped;
+        break;
+      }
+    }
+    expect('"');
+    return value;
+  }
+
+  double readNumber() {
+    skipWhitespace();
+    size_t start = pos_;
+    while (pos_ < text_.size() && (std::isdigit(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '-' ||
+                                   text_[pos_] == '+' || text_[pos_] == '.' || text_[pos_] == 'e' ||
+                                   text_[pos_] == 'E')) {
+      pos_++;
+    }
+    std::string digits = text_.substr(start, pos_ - start);
+    char *end = nullptr;
+    double value = std::strtod(digits.c_str(), &end);
+    if (digits.empty() || end != digits.c_str() + digits.size()) {
+      fail("expected a number");
+    }
+    return value;
+  }
+
+  // Call on_member with each key of an object; it must consume the value
+  template <typename F> void readObject(F &&on_member) {
+    expect('{');
+    if (peek() == '}') {
+      pos_++;
+      return;
+    }
+    while (true) {
+      std::string key = readString();
+      expect(':');
+      on_member(key);
+      if (peek() == ',') {
+        pos_++;
+        continue;
+      }
+      expect('}');
+      return;
+    }
+  }
+
+  // Call on_element for each element of an array; it must consume the element
+  template <typename F> void readArray(F &&on_element) {
+    expect('[');
+    if (peek() == ']') {
+      pos_++;
+      return;
+    }
+    while (true) {
+      on_element();
+      if (peek() == ',') {
+        pos_++;
+        continue;
+      }
+      expect(']');
+      return;
+    }
+  }
+
+  void skipValue() {
+    char c = peek();
+    if (c == '{') {
+      readObject([this](const std::string &) { skipValue(); });
+    } else if (c == '[') {
+      readArray([this]() { skipValue(); });
+    } else if (c == '"') {
+      readString();
+    } else if (c == 't' || c == 'f' || c == 'n') {
+      while (pos_ < text_.size() && std::isalpha(static_cast<unsigned char>(text_[pos_]))) {
+        pos_++;
+      }
+    } else {
+      readNumber();
+    }
+  }
+
+  [[noreturn]] void fail(const std::string &message) {
+    throw std::runtime_error("Invalid profiling trace at offset " + std::to_string(pos_) + ": " + message);
+  }
+
+private:
+  void skipWhitespace() {
+    while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+      pos_++;
+    }
+  }
+
+  uint32_t readHex4() {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++, pos_++) {
+      if (pos_ >= text_.size() || !std::isxdigit(static_cast<unsigned char>(text_[pos_]))) {
+        fail("invalid \\u escape");
+      }
+      int c = std::tolower(static_cast<unsigned char>(text_[pos_]));
+      value = value * 16 + static_cast<uint32_t>(std::isdigit(c) ? c - '0' : c - 'a' + 10);
+    }
+    return value;
+  }
+
+  // Read the digits of a \u escape, combining a surrogate pair into one code point
+  uint32_t readCodePoint() {
+    uint32_t code_point = readHex4();
+    if (code_point >= 0xD800 && code_point < 0xDC00 && text_.compare(pos_, 2, "\\u") == 0) {
+      pos_ += 2;
+      uint32_t low = readHex4();
+      code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+    }
+    return code_point;
+  }
+
+  static void appendUtf8(uint32_t code_point, std::string &out) {
+    if (code_point < 0x80) {
+      out += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+      out += static_cast<char>(0xC0 | (code_point >> 6));
+      out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+      out += static_cast<char>(0xE0 | (code_point >> 12));
+      out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+      out += static_cast<char>(0xF0 | (code_point >> 18));
+      out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+      out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+  }
+
+  const std::string &text_;
+  size_t pos_ = 0;
+};
+
+// The fields of a trace event that the summary needs
+struct TraceEvent {
+  std::string category;
+  std::string name;
+  double duration = 0;
+  std::string op_type;
+  std::string provider;
+};
+
+TraceEvent readEvent(JsonReader &reader) {
+  TraceEvent event;
+  reader.readObject([&](const std::string &key) {
+    if (key == "cat" && reader.peek() == '"') {
+      event.category = reader.readString();
+    } else if (key == "name" && reader.peek() == '"') {
+      event.name = reader.readString();
+    } else if (key == "dur" && reader.peek() != '"' && reader.peek() != '{' && reader.peek() != '[') {
+      event.duration = reader.readNumber();
+    } else if (key == "args" && reader.peek() == '{') {
+      reader.readObject([&](const std::string &arg) {
+        if (arg == "op_name" && reader.peek() == '"') {
+          event.op_type = reader.readString();
+        } else if (arg == "provider" && reader.peek() == '"') {
+          event.provider = reader.readString();
+        } else {
+          reader.skipValue();
+        }
+      });
+    } else {
+      reader.skipValue();
+    }
+  });
+  return event;
+}
+
+// Add a kernel run to the entry of a key, creating it on first use
+void accumulate(std::map<std::string, ProfileEntry> &entries, const std::string &key, const ProfileEntry &run) {
+  auto it = entries.find(key);
+  if (it == entries.end()) {
+    entries.emplace(key, run);
+    return;
+  }
+  it->second.total_micros += run.total_micros;
+  it->second.calls += run.calls;
+}
+
+std::vector<ProfileEntry> sortedByTime(std::map<std::string, ProfileEntry> &&entries) {
+  std::vector<ProfileEntry> sorted;
+  sorted.reserve(entries.size());
+  for (auto &entry : entries) {
+    sorted.push_back(std::move(entry.second));
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), [](const ProfileEntry &a, const ProfileEntry &b) {
+    return a.total_micros > b.total_micros;
+  });
+  return sorted;
+}
+
+} // namespace
+
+ProfileSummary summarizeProfile(const std::string &trace) {
+  JsonReader reader(trace);
+  std::map<std::string, ProfileEntry> nodes;
+  std::map<std::string, ProfileEntry> ops;
+  ProfileSummary summary;
+
+  const size_t suffix_length = sizeof(kKernelTimeSuffix) - 1;
+  reader.readArray([&]() {
+    if (reader.peek() != '{') {
+      reader.skipValue();
+      return;
+    }
+    TraceEvent event = readEvent(reader);
+    if (event.category != "Node" || event.name.size() <= suffix_length ||
+        event.name.compare(event.name.size() - suffix_length, suffix_length, kKernelTimeSuffix) != 0) {
+      return;
+    }
+
+    ProfileEntry run;
+    run.name = event.name.substr(0, event.name.size() - suffix_length);
+    run.op_type = event.op_type;
+    run.provider = event.provider;
+    run.total_micros = event.duration > 0 ? static_cast<uint64_t>(event.duration) : 0;
+    run.calls = 1;
+    summary.total_micros += run.total_micros;
+
+    accumulate(nodes, run.name, run);
+    ProfileEntry op_run = run;
+    op_run.name = run.op_type;
+    accumulate(ops, run.op_type + '\n' + run.provider, op_run);
+  });
+  if (!reader.atEnd()) {
+    reader.fail("unexpected data after the events");
+  }
+
+  summary.nodes = sortedByTime(std::move(nodes));
+  summary.ops = sortedByTime(std::move(ops));
+  return summary;
+}
+
+ProfileSummary summarizeProfileFile(const std::string &path) {
+  std::ifstream file(std::filesystem::u8path(path), std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open profiling trace: " + path);
+  }
+  std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return summarizeProfile(trace);
+}
+
+} // namespace flutter_onnxruntime
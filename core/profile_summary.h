@@ -0,0 +1,44 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_PROFILE_SUMMARY_H_
+#define FLUTTER_ONNXRUNTIME_PROFILE_SUMMARY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flutter_onnxruntime {
+
+// Time spent in the kernels of one node, or of every node of one operator type on one execution provider
+struct ProfileEntry {
+  // Node name, or the operator type for operator entries
+  std::string name;
+  std::string op_type;
+  std::string provider;
+  uint64_t total_micros = 0;
+  uint64_t calls = 0;
+};
+
+// Kernel times of a profiling trace, each list sorted by total time, longest first
+struct ProfileSummary {
+  std::vector<ProfileEntry> nodes;
+  std::vector<ProfileEntry> ops;
+  // Total kernel time of every node
+  uint64_t total_micros = 0;
+};
+
+// Summarize the "Node" events of a trace in the Chrome trace format written by ONNX Runtime's profiler.
+// Only the kernel time of a node is counted, not the fences around it. Throws std::runtime_error if the
+// trace is not a JSON array of events.
+ProfileSummary summarizeProfile(const std::string &trace);
+
+// Read and summarize a trace file; throws std::runtime_error if it cannot be read or parsed
+ProfileSummary summarizeProfileFile(const std::string &path);
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_PROFILE_SUMMARY_H_
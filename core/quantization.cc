@@ -0,0 +1,783 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "quantization.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+#include "convert_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define QUANTIZATION_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define QUANTIZATION_NEON 1
+#endif
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// A tensor split around the axis of its scales into outer x channels x inner elements; every run of inner elements
+// shares one scale and zero point
+struct QuantizationLayout {
+  size_t outer = 1;
+  size_t channels = 1;
+  size_t inner = 0;
+};
+
+int32_t zeroPoint(const QuantizationParams &params, size_t channel) {
+  return params.zero_points.empty() ? 0 : params.zero_points[channel];
+}
+
+// Check the params against a shape and lay the tensor out by channel
+QuantizationLayout checkQuantization(const std::vector<int64_t> &shape, const QuantizationParams &params) {
+  int32_t low;
+  int32_t high;
+  if (params.element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8) {
+    low = std::numeric_limits<int8_t>::min();
+    high = std::numeric_limits<int8_t>::max();
+  } else if (params.element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8) {
+    low = std::numeric_limits<uint8_t>::min();
+    high = std::numeric_limits<uint8_t>::max();
+  } else {
+    throw std::invalid_argument("Quantized tensors must be int8 or uint8");
+  }
+
+  if (params.scales.empty()) {
+    throw std::invalid_argument("Quantization needs at least one scale");
+  }
+  if (!params.zero_points.empty() && params.zero_points.size() != params.scales.size()) {
+    throw std::invalid_argument("Quantization needs one zero point per scale");
+  }
+  for (float scale : params.scales) {
+    if (!(scale > 0.0f) || !std::isfinite(scale)) {
+      throw std::invalid_argument("Quantization scales must be positive and finite, got " + std::to_string(scale));
+    }
+  }
+  for (int32_t zero_point : params.zero_points) {
+    if (zero_point < low || zero_point > high) {
+      throw std::invalid_argument("Zero point out of range of the quantized type: " + std::to_string(zero_point));
+    }
+  }
+
+  QuantizationLayout layout;
+  size_t count = 1;
+  for (int64_t dim : shape) {
+    count *= static_cast<size_t>(dim);
+  }
+  if (params.scales.size() == 1) {
+    layout.inner = count;
+    return layout;
+  }
+
+  int64_t rank = static_cast<int64_t>(shape.size());
+  int64_t axis = params.axis < 0 ? params.axis + rank : params.axis;
+  if (axis < 0 || axis >= rank) {
+    throw std::invalid_argument("Quantization axis out of range: " + std::to_string(params.axis));
+  }
+  if (shape[axis] != static_cast<int64_t>(params.scales.size())) {
+    throw std::invalid_argument("Expected " + std::to_string(shape[axis]) + " scales along axis " +
+                                std::to_string(params.axis) + ", got " + std::to_string(params.scales.size()));
+  }
+  layout.channels = params.scales.size();
+  layout.inner = 1;
+  for (int64_t i = 0; i < rank; i++) {
+    if (i < axis) {
+      layout.outer *= static_cast<size_t>(shape[i]);
+    } else if (i > axis) {
+      layout.inner *= static_cast<size_t>(shape[i]);
+    }
+  }
+  return layout;
+}
+
+// Vector loops over the leading elements of a run; they return how many they quantized or dequantized.
+// low and high bound x / scale to the values that stay in range once the zero point is added.
+template <typename Q>
+size_t quantizeVector(const float * /* src */, Q * /* dst */, size_t /* count */, float /* scale */,
+                      int32_t /* zero_point */, float /* low */, float /* high */) {
+  return 0;
+}
+
+template <typename Q>
+size_t dequantizeVector(const Q * /* src */, float * /* dst */, size_t /* count */, float /* scale */,
+                        int32_t /* zero_point */) {
+  return 0;
+}
+
+#if defined(QUANTIZATION_SSE2)
+
+// _mm_div_ps rounds like the scalar division and _mm_cvtps_epi32 rounds half to even like std::nearbyint in the
+// default rounding mode, so the results match the scalar loop bit for bit. NaN lanes are zeroed before clamping,
+// as _mm_max_ps would return low for them.
+static inline __m128i quantizeLanes(__m128 value, __m128 scale, __m128 low, __m128 high, __m128i zero_point) {
+  __m128 scaled = _mm_div_ps(value, scale);
+  scaled = _mm_and_ps(scaled, _mm_cmpord_ps(scaled, scaled));
+  scaled = _mm_min_ps(_mm_max_ps(scaled, low), high);
+  return _mm_add_epi32(_mm_cvtps_epi32(scaled), zero_point);
+}
+
+// The lanes are already in range, so the saturating packs only narrow them
+template <>
+size_t quantizeVector<uint8_t>(const float *src, uint8_t *dst, size_t count, float scale, int32_t zero_point,
+                               float low, float high) {
+  const __m128 scales = _mm_set1_ps(scale);
+  const __m128 lows = _mm_set1_ps(low);
+  const __m128 highs = _mm_set1_ps(high);
+  const __m128i zero_points = _mm_set1_epi32(zero_point);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i a = quantizeLanes(_mm_loadu_ps(src + i), scales, lows, highs, zero_points);
+    __m128i b = quantizeLanes(_mm_loadu_ps(src + i + 4), scales, lows, highs, zero_points);
+    __m128i c = quantizeLanes(_mm_loadu_ps(src + i + 8), scales, lows, highs, zero_points);
+    __m128i d = quantizeLanes(_mm_loadu_ps(src + i + 12), scales, lows, highs, zero_points);
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), packed);
+  }
+  return i;
+}
+
+template <>
+size_t quantizeVector<int8_t>(const float *src, int8_t *dst, size_t count, float scale, int32_t zero_point,
+                              float low, float high) {
+  const __m128 scales = _mm_set1_ps(scale);
+  const __m128 lows = _mm_set1_ps(low);
+  const __m128 highs = _mm_set1_ps(high);
+  const __m128i zero_points = _mm_set1_epi32(zero_point);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i a = quantizeLanes(_mm_loadu_ps(src + i), scales, lows, highs, zero_points);
+    __m128i b = quantizeLanes(_mm_loadu_ps(src + i + 4), scales, lows, highs, zero_points);
+    __m128i c = quantizeLanes(_mm_loadu_ps(src + i + 8), scales, lows, highs, zero_points);
+    __m128i d = quantizeLanes(_mm_loadu_ps(src + i + 12), scales, lows, highs, zero_points);
+    __m128i packed = _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), packed);
+  }
+  return i;
+}
+
+// Sign-extend eight 16-bit lanes, subtract the zero point and scale them into dst
+static inline void dequantizeWords(__m128i words, __m128i zero_point, __m128 scale, float *dst) {
+  __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16);
+  __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16);
+  _mm_storeu_ps(dst, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(low, zero_point)), scale));
+  _mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(high, zero_point)), scale));
+}
+
+template <>
+size_t dequantizeVector<uint8_t>(const uint8_t *src, float *dst, size_t count, float scale, int32_t zero_point) {
+  const __m128 scales = _mm_set1_ps(scale);
+  const __m128i zero_points = _mm_set1_epi32(zero_point);
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    dequantizeWords(_mm_unpacklo_epi8(bytes, zero), zero_points, scales, dst + i);
+    dequantizeWords(_mm_unpackhi_epi8(bytes, zero), zero_points, scales, dst + i + 8);
+  }
+  return i;
+}
+
+template <>
+size_t dequantizeVector<int8_t>(const int8_t *src, float *dst, size_t count, float scale, int32_t zero_point) {
+  const __m128 scales = _mm_set1_ps(scale);
+  const __m128i zero_points = _mm_set1_epi32(zero_point);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    dequantizeWords(_mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8), zero_points, scales, dst + i);
+    dequantizeWords(_mm_srai_epi16(_mm_unpackhi_epi8(bytes, bytes), 8), zero_points, scales, dst + i + 8);
+  }
+  return i;
+}
+
+#elif defined(QUANTIZATION_NEON)
+
+// vcvtnq_s32_f32 rounds half to even like std::nearbyint in the default rounding mode, so the results match the
+// scalar loop bit for bit. NaN lanes are zeroed before clamping, as vmaxq_f32 would keep them.
+static inline int32x4_t quantizeLanes(float32x4_t value, float32x4_t scale, float32x4_t low, float32x4_t high,
+                                      int32x4_t zero_point) {
+  float32x4_t scaled = vdivq_f32(value, scale);
+  scaled = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(scaled), vceqq_f32(scaled, scaled)));
+  scaled = vminq_f32(vmaxq_f32(scaled, low), high);
+  return vaddq_s32(vcvtnq_s32_f32(scaled), zero_point);
+}
+
+// Eight quantized lanes narrowed to 16 bits; they are already in range, so the saturating narrows only narrow them
+static inline int16x8_t quantizeWords(const float *src, float32x4_t scale, float32x4_t low, float32x4_t high,
+                                      int32x4_t zero_point) {
+  int32x4_t a = quantizeLanes(vld1q_f32(src), scale, low, high, zero_point);
+  int32x4_t b = quantizeLanes(vld1q_f32(src + 4), scale, low, high, zero_point);
+  return vcombine_s16(vqmovn_s32(a), vqmovn_s32(b));
+}
+
+template <>
+size_t quantizeVector<uint8_t>(const float *src, uint8_t *dst, size_t count, float scale, int32_t zero_point,
+                               float low, float high) {
+  const float32x4_t scales = vdupq_n_f32(scale);
+  const float32x4_t lows = vdupq_n_f32(low);
+  const float32x4_t highs = vdupq_n_f32(high);
+  const int32x4_t zero_points = vdupq_n_s32(zero_point);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    int16x8_t a = quantizeWords(src + i, scales, lows, highs, zero_points);
+    int16x8_t b = quantizeWords(src + i + 8, scales, lows, highs, zero_points);
+    vst1q_u8(dst + i, vcombine_u8(vqmovun_s16(a), vqmovun_s16(b)));
+  }
+  return i;
+}
+
+template <>
+size_t quantizeVector<int8_t>(const float *src, int8_t *dst, size_t count, float scale, int32_t zero_point,
+                              float low, float high) {
+  const float32x4_t scales = vdupq_n_f32(scale);
+  const float32x4_t lows = vdupq_n_f32(low);
+  const float32x4_t highs = vdupq_n_f32(high);
+  const int32x4_t zero_points = vdupq_n_s32(zero_point);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    int16x8_t a = quantizeWords(src + i, scales, lows, highs, zero_points);
+    int16x8_t b = quantizeWords(src + i + 8, scales, lows, highs, zero_points);
+    vst1q_s8(dst + i, vcombine_s8(vqmovn_s16(a), vqmovn_s16(b)));
+  }
+  return i;
+}
+
+// Widen eight 16-bit lanes, subtract the zero point and scale them into dst
+static inline void dequantizeWords(int16x8_t words, int32x4_t zero_point, float32x4_t scale, float *dst) {
+  int32x4_t low = vsubq_s32(vmovl_s16(vget_low_s16(words)), zero_point);
+  int32x4_t high = vsubq_s32(vmovl_s16(vget_high_s16(words)), zero_point);
+  vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(low), scale));
+  vst1q_f32(dst + 4, vmulq_f32(vcvtq_f32_s32(high), scale));
+}
+
+template <>
+size_t dequantizeVector<uint8_t>(const uint8_t *src, float *dst, size_t count, float scale, int32_t zero_point) {
+  const float32x4_t scales = vdupq_n_f32(scale);
+  const int32x4_t zero_points = vdupq_n_s32(zero_point);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    uint8x16_t bytes = vld1q_u8(src + i);
+    dequantizeWords(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(bytes))), zero_points, scales, dst + i);
+    dequantizeWords(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(bytes))), zero_points, scales, dst + i + 8);
+  }
+  return i;
+}
+
+template <>
+size_t dequantizeVector<int8_t>(const int8_t *src, float *dst, size_t count, float scale, int32_t zero_point) {
+  const float32x4_t scales = vdupq_n_f32(scale);
+  const int32x4_t zero_points = vdupq_n_s32(zero_point);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    int8x16_t bytes = vld1q_s8(src + i);
+    dequantizeWords(vmovl_s8(vget_low_s8(bytes)), zero_points, scales, dst + i);
+    dequantizeWords(vmovl_s8(vget_high_s8(bytes)), zero_points, scales, dst + i + 8);
+  }
+  return i;
+}
+
+#endif
+
+// Quantize a run of elements sharing one scale and zero point
+template <typename Q> void quantizeRun(const float *src, Q *dst, size_t count, float scale, int32_t zero_point) {
+  const float low = static_cast<float>(std::numeric_limits<Q>::min() - zero_point);
+  const float high = static_cast<float>(std::numeric_limits<Q>::max() - zero_point);
+  size_t i = quantizeVector<Q>(src, dst, count, scale, zero_point, low, high);
+  for (; i < count; i++) {
+    float scaled = src[i] / scale;
+    scaled = std::isnan(scaled) ? 0.0f : std::min(std::max(scaled, low), high);
+    dst[i] = static_cast<Q>(static_cast<int32_t>(std::nearbyint(scaled)) + zero_point);
+  }
+}
+
+template <typename Q> void dequantizeRun(const Q *src, float *dst, size_t count, float scale, int32_t zero_point) {
+  size_t i = dequantizeVector<Q>(src, dst, count, scale, zero_point);
+  for (; i < count; i++) {
+    dst[i] = static_cast<float>(static_cast<int32_t>(src[i]) - zero_point) * scale;
+  }
+}
+
+template <typename Q>
+void quantizeLayout(const float *src, Q *dst, const QuantizationLayout &layout, const QuantizationParams &params) {
+  for (size_t outer = 0; outer < layout.outer; outer++) {
+    for (size_t channel = 0; channel < layout.channels; channel++) {
+      size_t offset = (outer * layout.channels + channel) * layout.inner;
+      quantizeRun(src + offset, dst + offset, layout.inner, params.scales[channel], zeroPoint(params, channel));
+    }
+  }
+}
+
+template <typename Q>
+void dequantizeLayout(const Q *src, float *dst, const QuantizationLayout &layout, const QuantizationParams &params) {
+  for (size_t outer = 0; outer < layout.outer; outer++) {
+    for (size_t channel = 0; channel < layout.channels; channel++) {
+      size_t offset = (outer * layout.channels + channel) * layout.inner;
+      dequantizeRun(src + offset, dst + offset, layout.inner, params.scales[channel], zeroPoint(params, channel));
+    }
+  }
+}
+
+// Protobuf wire types
+constexpr uint32_t kVarint = 0;
+constexpr uint32_t kFixed64 = 1;
+constexpr uint32_t kLengthDelimited = 2;
+constexpr uint32_t kFixed32 = 5;
+
+// Values of TensorProto.DataType read below
+constexpr int32_t kDataTypeFloat = 1;
+constexpr int32_t kDataTypeUint8 = 2;
+constexpr int32_t kDataTypeInt8 = 3;
+constexpr int32_t kDataTypeFloat16 = 10;
+constexpr int32_t kDataTypeBFloat16 = 16;
+
+struct Field {
+  uint32_t number = 0;
+  uint32_t wire_type = 0;
+  // Value of a varint, fixed64 or fixed32 field
+  uint64_t value = 0;
+  // Value of a length-delimited field: a string, bytes, an embedded message or a packed repeated field
+  std::string_view bytes;
+};
+
+// Reads the fields of a serialized protobuf message in order
+class FieldReader {
+public:
+  explicit FieldReader(std::string_view message) : message_(message) {}
+
+  // Read the next field; returns false at the end of the message or if it is malformed, which sets malformed()
+  bool next(Field *field) {
+    if (pos_ >= message_.size()) {
+      return false;
+    }
+    uint64_t key;
+    if (!readVarint(&key)) {
+      return fail();
+    }
+    field->number = static_cast<uint32_t>(key >> 3);
+    field->wire_type = static_cast<uint32_t>(key & 7);
+    switch (field->wire_type) {
+    case kVarint:
+      return readVarint(&field->value) || fail();
+    case kFixed64:
+    case kFixed32: {
+      size_t size = field->wire_type == kFixed64 ? 8 : 4;
+      if (message_.size() - pos_ < size) {
+        return fail();
+      }
+      field->value = 0;
+      std::memcpy(&field->value, message_.data() + pos_, size);
+      pos_ += size;
+      return true;
+    }
+    case kLengthDelimited: {
+      uint64_t size;
+      if (!readVarint(&size) || message_.size() - pos_ < size) {
+        return fail();
+      }
+      field->bytes = message_.substr(pos_, static_cast<size_t>(size));
+      pos_ += static_cast<size_t>(size);
+      return true;
+    }
+    default:
+      // Groups are deprecated and never used by ONNX
+      return fail();
+    }
+  }
+
+  bool malformed() const { return malformed_; }
+
+  // Read every varint of a packed repeated field
+  static bool readPacked(std::string_view bytes, std::vector<uint64_t> *values) {
+    FieldReader reader(bytes);
+    while (reader.pos_ < bytes.size()) {
+      uint64_t value;
+      if (!reader.readVarint(&value)) {
+        return false;
+      }
+      values->push_back(value);
+    }
+    return true;
+  }
+
+private:
+  bool readVarint(uint64_t *value) {
+    *value = 0;
+    for (int shift = 0; shift < 64 && pos_ < message_.size(); shift += 7) {
+      uint8_t byte = static_cast<uint8_t>(message_[pos_++]);
+      *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool fail() {
+    malformed_ = true;
+    return false;
+  }
+
+  std::string_view message_;
+  size_t pos_ = 0;
+  bool malformed_ = false;
+};
+
+// The fields of a TensorProto that hold small constants such as scales and zero points
+struct ParsedTensor {
+  std::string_view name;
+  std::vector<int64_t> dims;
+  int32_t data_type = 0;
+  std::vector<float> float_data;
+  std::vector<int32_t> int32_data;
+  std::string_view raw_data;
+  bool external = false;
+};
+
+// Append the values of a repeated varint field, packed or not
+bool appendVarints(const Field &field, std::vector<uint64_t> *values) {
+  if (field.wire_type == kVarint) {
+    values->push_back(field.value);
+    return true;
+  }
+  return field.wire_type == kLengthDelimited && FieldReader::readPacked(field.bytes, values);
+}
+
+bool parseTensor(std::string_view message, ParsedTensor *tensor) {
+  FieldReader reader(message);
+  Field field;
+  std::vector<uint64_t> dims;
+  std::vector<uint64_t> int32_data;
+  while (reader.next(&field)) {
+    if (field.number == 1 && !appendVarints(field, &dims)) { // TensorProto.dims
+      return false;
+    } else if (field.number == 2 && field.wire_type == kVarint) { // TensorProto.data_type
+      tensor->data_type = static_cast<int32_t>(field.value);
+    } else if (field.number == 4 && field.wire_type == kFixed32) { // TensorProto.float_data
+      float value;
+      uint32_t bits = static_cast<uint32_t>(field.value);
+      std::memcpy(&value, &bits, sizeof(value));
+      tensor->float_data.push_back(value);
+    } else if (field.number == 4 && field.wire_type == kLengthDelimited) {
+      size_t count = field.bytes.size() / sizeof(float);
+      tensor->float_data.resize(tensor->float_data.size() + count);
+      std::memcpy(tensor->float_data.data() + tensor->float_data.size() - count, field.bytes.data(),
+                  count * sizeof(float));
+    } else if (field.number == 5 && !appendVarints(field, &int32_data)) { // TensorProto.int32_data
+      return false;
+    } else if (field.number == 8 && field.wire_type == kLengthDelimited) { // TensorProto.name
+      tensor->name = field.bytes;
+    } else if (field.number == 9 && field.wire_type == kLengthDelimited) { // TensorProto.raw_data
+      tensor->raw_data = field.bytes;
+    } else if (field.number == 14 && field.wire_type == kVarint) { // TensorProto.data_location
+      tensor->external = field.value == 1;
+    }
+  }
+  for (uint64_t dim : dims) {
+    tensor->dims.push_back(static_cast<int64_t>(dim));
+  }
+  for (uint64_t value : int32_data) {
+    tensor->int32_data.push_back(static_cast<int32_t>(value));
+  }
+  return !reader.malformed();
+}
+
+// Number of elements of a scalar or 1-D tensor; 0 for tensors of a higher rank, which are not per-tensor or
+// per-channel parameters
+size_t parameterCount(const ParsedTensor &tensor) {
+  if (tensor.dims.empty()) {
+    return 1;
+  }
+  return tensor.dims.size() == 1 && tensor.dims[0] > 0 ? static_cast<size_t>(tensor.dims[0]) : 0;
+}
+
+bool readScales(const ParsedTensor &tensor, std::vector<float> *scales) {
+  size_t count = parameterCount(tensor);
+  if (count == 0 || tensor.external) {
+    return false;
+  }
+  if (tensor.data_type == kDataTypeFloat) {
+    if (!tensor.raw_data.empty()) {
+      if (tensor.raw_data.size() != count * sizeof(float)) {
+        return false;
+      }
+      scales->resize(count);
+      std::memcpy(scales->data(), tensor.raw_data.data(), count * sizeof(float));
+      return true;
+    }
+    *scales = tensor.float_data;
+    return scales->size() == count;
+  }
+  if (tensor.data_type == kDataTypeFloat16 || tensor.data_type == kDataTypeBFloat16) {
+    std::vector<uint16_t> bits(count);
+    if (!tensor.raw_data.empty()) {
+      if (tensor.raw_data.size() != count * sizeof(uint16_t)) {
+        return false;
+      }
+      std::memcpy(bits.data(), tensor.raw_data.data(), count * sizeof(uint16_t));
+    } else if (tensor.int32_data.size() == count) {
+      std::transform(tensor.int32_data.begin(), tensor.int32_data.end(), bits.begin(),
+                     [](int32_t value) { return static_cast<uint16_t>(value); });
+    } else {
+      return false;
+    }
+    for (uint16_t value : bits) {
+      scales->push_back(tensor.data_type == kDataTypeFloat16 ? float16BitsToFloat(value) : bfloat16BitsToFloat(value));
+    }
+    return true;
+  }
+  return false;
+}
+
+bool readZeroPoints(const ParsedTensor &tensor, std::vector<int32_t> *zero_points,
+                    ONNXTensorElementDataType *element_type) {
+  size_t count = parameterCount(tensor);
+  if (count == 0 || tensor.external) {
+    return false;
+  }
+  if (tensor.data_type == kDataTypeUint8) {
+    *element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+  } else if (tensor.data_type == kDataTypeInt8) {
+    *element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8;
+  } else {
+    return false;
+  }
+  if (!tensor.raw_data.empty()) {
+    if (tensor.raw_data.size() != count) {
+      return false;
+    }
+    for (char byte : tensor.raw_data) {
+      zero_points->push_back(tensor.data_type == kDataTypeInt8 ? static_cast<int32_t>(static_cast<int8_t>(byte))
+                                                               : static_cast<int32_t>(static_cast<uint8_t>(byte)));
+    }
+    return true;
+  }
+  *zero_points = tensor.int32_data;
+  return zero_points->size() == count;
+}
+
+// The fields of a NodeProto needed to find quantization nodes and constants
+struct ParsedNode {
+  std::vector<std::string_view> inputs;
+  std::vector<std::string_view> outputs;
+  std::string_view op_type;
+  std::string_view domain;
+  // Attributes of QuantizeLinear and DequantizeLinear
+  int64_t axis = 1;
+  int64_t block_size = 0;
+  int64_t output_dtype = 0;
+  // TensorProto of the value attribute of a Constant
+  std::string_view value;
+};
+
+bool parseAttribute(std::string_view message, ParsedNode *node) {
+  FieldReader reader(message);
+  Field field;
+  std::string_view name;
+  int64_t int_value = 0;
+  std::string_view tensor;
+  while (reader.next(&field)) {
+    if (field.number == 1 && field.wire_type == kLengthDelimited) { // AttributeProto.name
+      name = field.bytes;
+    } else if (field.number == 3 && field.wire_type == kVarint) { // AttributeProto.i
+      int_value = static_cast<int64_t>(field.value);
+    } else if (field.number == 5 && field.wire_type == kLengthDelimited) { // AttributeProto.t
+      tensor = field.bytes;
+    }
+  }
+  if (name == "axis") {
+    node->axis = int_value;
+  } else if (name == "block_size") {
+    node->block_size = int_value;
+  } else if (name == "output_dtype") {
+    node->output_dtype = int_value;
+  } else if (name == "value") {
+    node->value = tensor;
+  }
+  return !reader.malformed();
+}
+
+bool parseNode(std::string_view message, ParsedNode *node) {
+  FieldReader reader(message);
+  Field field;
+  while (reader.next(&field)) {
+    if (field.wire_type != kLengthDelimited) {
+      continue;
+    }
+    if (field.number == 1) { // NodeProto.input
+      node->inputs.push_back(field.bytes);
+    } else if (field.number == 2) { // NodeProto.output
+      node->outputs.push_back(field.bytes);
+    } else if (field.number == 4) { // NodeProto.op_type
+      node->op_type = field.bytes;
+    } else if (field.number == 5 && !parseAttribute(field.bytes, node)) { // NodeProto.attribute
+      return false;
+    } else if (field.number == 7) { // NodeProto.domain
+      node->domain = field.bytes;
+    }
+  }
+  return !reader.malformed();
+}
+
+bool isQuantizationNode(const ParsedNode &node) {
+  return (node.op_type == "QuantizeLinear" || node.op_type == "DequantizeLinear") &&
+         (node.domain.empty() || node.domain == "ai.onnx" || node.domain == "com.microsoft") &&
+         node.inputs.size() >= 2 && !node.outputs.empty();
+}
+
+// Read the name field of a message, such as a ValueInfoProto or TensorProto
+bool parseName(std::string_view message, uint32_t name_field, std::string_view *name) {
+  FieldReader reader(message);
+  Field field;
+  while (reader.next(&field)) {
+    if (field.number == name_field && field.wire_type == kLengthDelimited) {
+      *name = field.bytes;
+    }
+  }
+  return !reader.malformed();
+}
+
+// The main graph of a model, with the constants its quantization nodes may read
+struct ParsedGraph {
+  std::vector<ParsedNode> quantization_nodes;
+  std::unordered_map<std::string_view, std::string_view> constants; // TensorProto by name
+  std::vector<std::string_view> inputs;
+  std::vector<std::string_view> outputs;
+};
+
+bool parseGraph(std::string_view message, ParsedGraph *graph) {
+  FieldReader reader(message);
+  Field field;
+  while (reader.next(&field)) {
+    if (field.wire_type != kLengthDelimited) {
+      continue;
+    }
+    if (field.number == 1) { // GraphProto.node
+      ParsedNode node;
+      if (!parseNode(field.bytes, &node)) {
+        return false;
+      }
+      if (isQuantizationNode(node)) {
+        graph->quantization_nodes.push_back(std::move(node));
+      } else if (node.op_type == "Constant" && node.outputs.size() == 1 && !node.value.empty()) {
+        graph->constants[node.outputs[0]] = node.value;
+      }
+    } else if (field.number == 5) { // GraphProto.initializer
+      // Only the name is read here, the few initializers quantization nodes use are parsed later
+      std::string_view name;
+      if (!parseName(field.bytes, 8, &name)) { // TensorProto.name
+        return false;
+      }
+      graph->constants[name] = field.bytes;
+    } else if (field.number == 11 || field.number == 12) { // GraphProto.input and GraphProto.output
+      std::string_view name;
+      if (!parseName(field.bytes, 1, &name)) { // ValueInfoProto.name
+        return false;
+      }
+      (field.number == 11 ? graph->inputs : graph->outputs).push_back(name);
+    }
+  }
+  return !reader.malformed();
+}
+
+// The parameters of a quantization node, if its scale and zero point are constants of a supported type
+bool readNodeQuantization(const ParsedGraph &graph, const ParsedNode &node, QuantizationParams *params) {
+  if (node.block_size != 0) {
+    // Blocked quantization has several scales along the axis, which QuantizationParams does not describe
+    return false;
+  }
+  auto scale = graph.constants.find(node.inputs[1]);
+  ParsedTensor scale_tensor;
+  if (scale == graph.constants.end() || !parseTensor(scale->second, &scale_tensor) ||
+      !readScales(scale_tensor, &params->scales)) {
+    return false;
+  }
+
+  params->axis = node.axis;
+  params->element_type =
+      node.output_dtype == kDataTypeInt8 ? ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8 : ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+  if (node.inputs.size() >= 3 && !node.inputs[2].empty()) {
+    auto zero_point = graph.constants.find(node.inputs[2]);
+    ParsedTensor zero_point_tensor;
+    if (zero_point == graph.constants.end() || !parseTensor(zero_point->second, &zero_point_tensor) ||
+        !readZeroPoints(zero_point_tensor, &params->zero_points, &params->element_type) ||
+        params->zero_points.size() != params->scales.size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+void quantizeElements(const float *src, const std::vector<int64_t> &shape, const QuantizationParams &params,
+                      void *dst) {
+  QuantizationLayout layout = checkQuantization(shape, params);
+  if (params.element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8) {
+    quantizeLayout(src, static_cast<int8_t *>(dst), layout, params);
+  } else {
+    quantizeLayout(src, static_cast<uint8_t *>(dst), layout, params);
+  }
+}
+
+void dequantizeElements(const void *src, const std::vector<int64_t> &shape, const QuantizationParams &params,
+                        float *dst) {
+  QuantizationLayout layout = checkQuantization(shape, params);
+  if (params.element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8) {
+    dequantizeLayout(static_cast<const int8_t *>(src), dst, layout, params);
+  } else {
+    dequantizeLayout(static_cast<const uint8_t *>(src), dst, layout, params);
+  }
+}
+
+ModelQuantization readModelQuantization(const void *data, size_t size) {
+  ModelQuantization quantization;
+  FieldReader reader(std::string_view(static_cast<const char *>(data), size));
+  Field field;
+  ParsedGraph graph;
+  bool has_graph = false;
+  while (reader.next(&field)) {
+    if (field.number == 7 && field.wire_type == kLengthDelimited) { // ModelProto.graph
+      has_graph = parseGraph(field.bytes, &graph);
+      if (!has_graph) {
+        return quantization;
+      }
+    }
+  }
+  if (reader.malformed() || !has_graph) {
+    return quantization;
+  }
+
+  // A graph input is the data of the node that quantizes or dequantizes it, a graph output the result of one
+  for (std::string_view input : graph.inputs) {
+    for (const ParsedNode &node : graph.quantization_nodes) {
+      QuantizationParams params;
+      if (node.inputs[0] == input && readNodeQuantization(graph, node, &params)) {
+        quantization.inputs.emplace(std::string(input), std::move(params));
+        break;
+      }
+    }
+  }
+  for (std::string_view output : graph.outputs) {
+    for (const ParsedNode &node : graph.quantization_nodes) {
+      QuantizationParams params;
+      if (node.outputs[0] == output && readNodeQuantization(graph, node, &params)) {
+        quantization.outputs.emplace(std::string(output), std::move(params));
+        break;
+      }
+    }
+  }
+  return quantization;
+}
+
+} // namespace flutter_onnxruntime
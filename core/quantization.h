@@ -0,0 +1,61 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_QUANTIZATION_H_
+#define FLUTTER_ONNXRUNTIME_QUANTIZATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <vector>
+
+namespace flutter_onnxruntime {
+
+// Linear quantization of a tensor, as in the ONNX QuantizeLinear and DequantizeLinear ops
+struct QuantizationParams {
+  // One scale for the whole tensor, or one per index along axis
+  std::vector<float> scales;
+
+  // Zero point of each scale; empty for zero points of 0
+  std::vector<int32_t> zero_points;
+
+  // Axis of per-channel scales; negative values count from the end
+  int64_t axis = 1;
+
+  // Type of the quantized elements, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8 or ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8
+  ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+};
+
+// Quantize the float elements of a tensor of a shape into dst of params.element_type:
+// saturate(round(x / scale) + zero_point), rounding half to even and mapping NaN to the zero point.
+// Throws std::invalid_argument if the scales do not match the shape, a scale is not positive and finite, or a zero
+// point does not fit the element type. SSE2 (x86-64) and NEON (ARM64) paths give bit-identical results to the scalar
+// loop.
+void quantizeElements(const float *src, const std::vector<int64_t> &shape, const QuantizationParams &params,
+                      void *dst);
+
+// Dequantize the elements of a tensor of params.element_type into floats: (x - zero_point) * scale. Throws like
+// quantizeElements.
+void dequantizeElements(const void *src, const std::vector<int64_t> &shape, const QuantizationParams &params,
+                        float *dst);
+
+// Quantization of the inputs and outputs of a QDQ model, by name
+struct ModelQuantization {
+  std::map<std::string, QuantizationParams> inputs;
+  std::map<std::string, QuantizationParams> outputs;
+};
+
+// Read the scales and zero points of the QuantizeLinear or DequantizeLinear node that takes each graph input as its
+// data, and of the one that produces each graph output, from the bytes of a serialized ONNX model. Only scales and
+// zero points held in initializers or Constant nodes of the main graph are found. A model that cannot be parsed has
+// no quantization.
+ModelQuantization readModelQuantization(const void *data, size_t size);
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_QUANTIZATION_H_
@@ -0,0 +1,136 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "run_control.h"
+#include "session_stats.h"
+#include <chrono>
+
+namespace flutter_onnxruntime {
+
+bool RunControl::stop(RunStop reason) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (reason_ != RunStop::kNone) {
+    return false;
+  }
+  reason_ = reason;
+  if (terminate_) {
+    terminate_();
+  }
+  return true;
+}
+
+void RunControl::attach(std::function<void()> terminate) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A run stopped while it was still queued is terminated as soon as it gets here
+  if (reason_ != RunStop::kNone) {
+    terminate();
+  }
+  terminate_ = std::move(terminate);
+}
+
+void RunControl::detach() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  terminate_ = nullptr;
+}
+
+RunStop RunControl::reason() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reason_;
+}
+
+RunRegistry::~RunRegistry() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  if (watchdog_.joinable()) {
+    watchdog_.join();
+  }
+}
+
+void RunRegistry::track(const std::shared_ptr<RunControl> &run, const std::string &tag, uint64_t timeout_nanos) {
+  if (tag.empty() && timeout_nanos == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!tag.empty()) {
+      run->tag_ = tag;
+      tagged_.emplace(tag, run);
+    }
+    if (timeout_nanos > 0) {
+      run->deadline_nanos_ = steadyNanos() + timeout_nanos;
+      deadlines_.emplace(run->deadline_nanos_, run);
+      if (!watchdog_.joinable()) {
+        watchdog_ = std::thread(&RunRegistry::watchdogLoop, this);
+      }
+    }
+  }
+  // The watchdog may have to wake up earlier for the new deadline
+  cv_.notify_all();
+}
+
+void RunRegistry::untrack(const std::shared_ptr<RunControl> &run) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!run->tag_.empty()) {
+    auto range = tagged_.equal_range(run->tag_);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == run) {
+        tagged_.erase(it);
+        break;
+      }
+    }
+    run->tag_.clear();
+  }
+  if (run->deadline_nanos_ > 0) {
+    auto range = deadlines_.equal_range(run->deadline_nanos_);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == run) {
+        deadlines_.erase(it);
+        break;
+      }
+    }
+    run->deadline_nanos_ = 0;
+  }
+}
+
+bool RunRegistry::cancel(const std::string &tag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto range = tagged_.equal_range(tag);
+  if (range.first == range.second) {
+    return false;
+  }
+  for (auto it = range.first; it != range.second; ++it) {
+    it->second->stop(RunStop::kCancelled);
+  }
+  return true;
+}
+
+void RunRegistry::watchdogLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (deadlines_.empty()) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    uint64_t now = steadyNanos();
+    uint64_t next = deadlines_.begin()->first;
+    if (next > now) {
+      cv_.wait_for(lock, std::chrono::nanoseconds(next - now));
+      continue;
+    }
+
+    // Runs stay tracked by their tag until they finish; only the deadline is spent
+    std::shared_ptr<RunControl> run = deadlines_.begin()->second;
+    deadlines_.erase(deadlines_.begin());
+    run->deadline_nanos_ = 0;
+    run->stop(RunStop::kTimedOut);
+  }
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,85 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_RUN_CONTROL_H_
+#define FLUTTER_ONNXRUNTIME_RUN_CONTROL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace flutter_onnxruntime {
+
+// Why a run was stopped before it finished
+enum class RunStop { kNone, kPreempted, kCancelled, kTimedOut };
+
+// Stops one run from any thread, typically by calling RunOptions::SetTerminate while the run is in Session::Run
+class RunControl {
+public:
+  // Stop the run for a reason, terminating it at once if it is attached; returns false if it was already stopped
+  bool stop(RunStop reason);
+
+  // Attach the function that terminates the run, which is called at once if the run was stopped before
+  void attach(std::function<void()> terminate);
+
+  // Detach the terminate function before what it terminates goes away
+  void detach();
+
+  // Why the run was stopped, kNone if it was not
+  RunStop reason();
+
+private:
+  friend class RunRegistry;
+
+  std::mutex mutex_;
+  RunStop reason_ = RunStop::kNone;
+  std::function<void()> terminate_;
+
+  // Tag and deadline the run is tracked by, guarded by the mutex of its RunRegistry
+  std::string tag_;
+  uint64_t deadline_nanos_ = 0;
+};
+
+// Runs in flight that Dart can cancel by the tag it gave them, and the deadlines after which a watchdog thread
+// stops them. The watchdog starts with the first deadline.
+class RunRegistry {
+public:
+  RunRegistry() = default;
+  ~RunRegistry();
+
+  RunRegistry(const RunRegistry &) = delete;
+  RunRegistry &operator=(const RunRegistry &) = delete;
+
+  // Track a run from its submission; an empty tag cannot be cancelled and a timeout of 0 sets no deadline
+  void track(const std::shared_ptr<RunControl> &run, const std::string &tag, uint64_t timeout_nanos);
+
+  // Forget a run once it has finished
+  void untrack(const std::shared_ptr<RunControl> &run);
+
+  // Stop every run in flight with a tag; returns false if there is none
+  bool cancel(const std::string &tag);
+
+private:
+  // Main loop of the watchdog thread
+  void watchdogLoop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unordered_multimap<std::string, std::shared_ptr<RunControl>> tagged_;
+  std::multimap<uint64_t, std::shared_ptr<RunControl>> deadlines_;
+  std::thread watchdog_;
+  bool stopping_ = false;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_RUN_CONTROL_H_
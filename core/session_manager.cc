@@ -0,0 +1,1376 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "session_manager.h"
+#include "element_types.h"
+#include "identity_model.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifdef FLUTTER_ONNXRUNTIME_DIRECTML
+#include <dml_provider_factory.h>
+#endif
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// Bytes of the elements of fixed-size tensors; strings and non-tensor values count as 0
+uint64_t totalByteSize(const OrtValue *const *values, size_t count) {
+  uint64_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    Ort::ConstValue value{values[i]};
+    if (values[i] != nullptr && value.IsTensor()) {
+      Ort::TensorTypeAndShapeInfo info = value.GetTensorTypeAndShapeInfo();
+      total += elementTypeInfo(info.GetElementType()).size * info.GetElementCount();
+    }
+  }
+  return total;
+}
+
+// Whether a model input or output is a fixed-size tensor whose leading dimension is dynamic
+bool isBatchable(const Ort::TypeInfo &type_info) {
+  if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+    return false;
+  }
+  auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+  std::vector<int64_t> shape = tensor_info.GetShape();
+  return !shape.empty() && shape[0] == -1 && elementTypeInfo(tensor_info.GetElementType()).size != 0;
+}
+
+// Whether requests to a session can be stacked along axis 0 and its outputs split back
+bool hasDynamicBatch(Ort::Session &session) {
+  size_t num_inputs = session.GetInputCount();
+  size_t num_outputs = session.GetOutputCount();
+  if (num_inputs == 0 || num_outputs == 0) {
+    return false;
+  }
+
+  for (size_t i = 0; i < num_inputs; i++) {
+    if (!isBatchable(session.GetInputTypeInfo(i))) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < num_outputs; i++) {
+    if (!isBatchable(session.GetOutputTypeInfo(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Concatenate tensors that share an element type and trailing dimensions along axis 0
+Ort::Value concatenate(const std::vector<const OrtValue *> &parts, ONNXTensorElementDataType element_type,
+                       const std::vector<int64_t> &shape) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value result = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), element_type);
+
+  auto *dst = static_cast<uint8_t *>(result.GetTensorMutableRawData());
+  size_t element_size = elementTypeInfo(element_type).size;
+  for (const OrtValue *part : parts) {
+    Ort::ConstValue value(part);
+    size_t bytes = value.GetTensorTypeAndShapeInfo().GetElementCount() * element_size;
+    std::memcpy(dst, value.GetTensorRawData(), bytes);
+    dst += bytes;
+  }
+  return result;
+}
+
+// Identify a model file by its path, modification time and size.
+// Returns an empty string if the file cannot be inspected, which bypasses the caches.
+std::string modelIdentity(const char *model_path, const std::filesystem::path &path, size_t *model_size) {
+  std::error_code error;
+  uintmax_t size = std::filesystem::file_size(path, error);
+  if (error) {
+    return {};
+  }
+  auto modified = std::filesystem::last_write_time(path, error);
+  if (error) {
+    return {};
+  }
+
+  *model_size = static_cast<size_t>(size);
+  return std::string(model_path) + '\n' + std::to_string(modified.time_since_epoch().count()) + '\n' +
+         std::to_string(size);
+}
+
+// FNV-1a hash of a key, naming the files of an optimized model
+std::string hashKey(const std::string &key) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : key) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  char name[17];
+  std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+  return name;
+}
+
+// Read a whole file; empty if it cannot be read
+std::string readTextFile(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Create a session from a model file, sharing prepacked weights through prepacked_weights unless it is null
+std::shared_ptr<Ort::Session> newSession(Ort::Env &env, const std::filesystem::path &model_path,
+                                         const Ort::SessionOptions &session_options,
+                                         Ort::PrepackedWeightsContainer *prepacked_weights) {
+  if (prepacked_weights == nullptr) {
+    return std::make_shared<Ort::Session>(env, model_path.c_str(), session_options);
+  }
+  return std::make_shared<Ort::Session>(env, model_path.c_str(), session_options, *prepacked_weights);
+}
+
+// Create a session from the bytes of a model, sharing prepacked weights through prepacked_weights unless it is null
+std::shared_ptr<Ort::Session> newSession(Ort::Env &env, const void *model_data, size_t model_size,
+                                         const Ort::SessionOptions &session_options,
+                                         Ort::PrepackedWeightsContainer *prepacked_weights) {
+  if (prepacked_weights == nullptr) {
+    return std::make_shared<Ort::Session>(env, model_data, model_size, session_options);
+  }
+  return std::make_shared<Ort::Session>(env, model_data, model_size, session_options, *prepacked_weights);
+}
+
+// Create a session from a model file, parsed from a read-only mapping of the file if map_model is set
+std::shared_ptr<Ort::Session> openSession(Ort::Env &env, const std::filesystem::path &model_path,
+                                          const Ort::SessionOptions &session_options, bool map_model,
+                                          Ort::PrepackedWeightsContainer *prepacked_weights) {
+  if (!map_model) {
+    return newSession(env, model_path, session_options, prepacked_weights);
+  }
+
+  // ONNX Runtime copies what it needs out of the model bytes, so the mapping is only held while parsing
+  MappedFile model(model_path);
+  return newSession(env, model.data(), model.size(), session_options, prepacked_weights);
+}
+
+// Load a model, reusing the optimized graph saved in optimized_model_dir by an earlier load of the same model file
+// (identity) with the same ONNX Runtime version and options, or saving it there for next time.
+// The key file next to a saved graph is written once the session is created, so a graph without a matching key
+// file is incomplete or stale and gets replaced.
+std::shared_ptr<Ort::Session> loadSession(Ort::Env &env, const std::filesystem::path &model_path,
+                                          const Ort::SessionOptions &session_options, bool map_model,
+                                          Ort::PrepackedWeightsContainer *prepacked_weights,
+                                          const std::string &identity, const std::string &options_key,
+                                          const std::string &optimized_model_dir) {
+  std::error_code error;
+  if (optimized_model_dir.empty() || identity.empty() ||
+      (!std::filesystem::create_directories(std::filesystem::u8path(optimized_model_dir), error) && error)) {
+    return openSession(env, model_path, session_options, map_model, prepacked_weights);
+  }
+
+  std::string optimized_key = identity + '\n' + Ort::GetVersionString() + '\n' + options_key;
+  std::filesystem::path optimized_path =
+      std::filesystem::u8path(optimized_model_dir) / (hashKey(optimized_key) + ".onnx");
+  std::filesystem::path key_path = optimized_path;
+  key_path += ".key";
+
+  if (readTextFile(key_path) == optimized_key) {
+    // The graph is already optimized
+    Ort::SessionOptions optimized_options = session_options.Clone();
+    optimized_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+    try {
+      return newSession(env, optimized_path, optimized_options, prepacked_weights);
+    } catch (const Ort::Exception &e) {
+      // A damaged graph is optimized again from the source model
+      std::cerr << "Discarding optimized model " << optimized_path << ": " << e.what() << std::endl;
+    }
+  }
+
+  std::filesystem::remove(key_path, error);
+  Ort::SessionOptions saving_options = session_options.Clone();
+  saving_options.SetOptimizedModelFilePath(optimized_path.c_str());
+  std::shared_ptr<Ort::Session> session;
+  try {
+    session = openSession(env, model_path, saving_options, map_model, prepacked_weights);
+  } catch (const Ort::Exception &e) {
+    // Graphs with nodes compiled by an execution provider such as TensorRT cannot be saved
+    std::cerr << "Not saving optimized model " << optimized_path << ": " << e.what() << std::endl;
+    std::filesystem::remove(optimized_path, error);
+    return openSession(env, model_path, session_options, map_model, prepacked_weights);
+  }
+
+  std::ofstream key_file(key_path, std::ios::binary);
+  key_file << optimized_key;
+  return session;
+}
+
+// Read the input and output names of a new session
+std::shared_ptr<CachedModel> describeModel(std::shared_ptr<Ort::Session> session) {
+  auto model = std::make_shared<CachedModel>();
+  model->session = std::move(session);
+
+  // Get input names
+  Ort::AllocatorWithDefaultOptions allocator;
+  size_t num_inputs = model->session->GetInputCount();
+  for (size_t i = 0; i < num_inputs; i++) {
+    auto input_name = model->session->GetInputNameAllocated(i, allocator);
+    model->input_names.push_back(std::string(input_name.get()));
+  }
+
+  // Get output names
+  size_t num_outputs = model->session->GetOutputCount();
+  for (size_t i = 0; i < num_outputs; i++) {
+    auto output_name = model->session->GetOutputNameAllocated(i, allocator);
+    model->output_names.push_back(std::string(output_name.get()));
+  }
+
+  model->dynamic_batch = hasDynamicBatch(*model->session);
+  return model;
+}
+
+// Read the quantization of the inputs and outputs of a model file; a file that cannot be mapped has none
+ModelQuantization readModelFileQuantization(const std::filesystem::path &model_path) {
+  try {
+    MappedFile model(model_path);
+    return readModelQuantization(model.data(), model.size());
+  } catch (const std::runtime_error &) {
+    return {};
+  }
+}
+
+// Quantization of a model, reading its file the first time it is asked for
+const ModelQuantization &modelQuantization(LazyModelQuantization &lazy) {
+  std::call_once(lazy.read, [&lazy] {
+    if (!lazy.model_path.empty()) {
+      lazy.quantization = readModelFileQuantization(lazy.model_path);
+    }
+  });
+  return lazy.quantization;
+}
+
+// Append the provider that owns the memory of an allocator to the options of a copy session
+void appendCopyProvider(Ort::SessionOptions &options, const std::string &allocator_name, int device_id) {
+  if (allocator_name == "Cuda") {
+    OrtCUDAProviderOptionsV2 *cuda_options = nullptr;
+    Ort::ThrowOnError(Ort::GetApi().CreateCUDAProviderOptions(&cuda_options));
+    struct CudaOptionsDeleter {
+      void operator()(OrtCUDAProviderOptionsV2 *p) { Ort::GetApi().ReleaseCUDAProviderOptions(p); }
+    };
+    std::unique_ptr<OrtCUDAProviderOptionsV2, CudaOptionsDeleter> cuda_options_ptr(cuda_options);
+
+    std::string device_id_str = std::to_string(device_id);
+    const char *keys[] = {"device_id"};
+    const char *values[] = {device_id_str.c_str()};
+    Ort::ThrowOnError(Ort::GetApi().UpdateCUDAProviderOptions(cuda_options_ptr.get(), keys, values, 1));
+    options.AppendExecutionProvider_CUDA_V2(*cuda_options_ptr);
+    return;
+  }
+#ifdef FLUTTER_ONNXRUNTIME_DIRECTML
+  if (allocator_name == "DML") {
+    // DirectML supports neither memory patterns nor running nodes in parallel
+    options.DisableMemPattern();
+    options.SetExecutionMode(ORT_SEQUENTIAL);
+    Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_DML(options, device_id));
+    return;
+  }
+#endif
+  throw std::runtime_error("Cannot copy a tensor from " + allocator_name + " memory to the host");
+}
+
+// Zero-filled tensor of an input's tensor type, with each dynamic dimension sized from dynamic_dims by symbolic name,
+// or default_dim if it is not listed. String tensors hold empty strings.
+Ort::Value createZeroTensor(const Ort::TypeInfo &type_info, const std::map<std::string, int64_t> &dynamic_dims,
+                            int64_t default_dim) {
+  auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+  ONNXTensorElementDataType element_type = tensor_info.GetElementType();
+  std::vector<int64_t> shape = tensor_info.GetShape();
+  std::vector<const char *> symbolic_dims = tensor_info.GetSymbolicDimensions();
+  size_t element_count = 1;
+  for (size_t d = 0; d < shape.size(); d++) {
+    if (shape[d] < 0) {
+      auto it = d < symbolic_dims.size() && symbolic_dims[d] != nullptr ? dynamic_dims.find(symbolic_dims[d])
+                                                                         : dynamic_dims.end();
+      shape[d] = it != dynamic_dims.end() ? it->second : default_dim;
+    }
+    element_count *= static_cast<size_t>(shape[d]);
+  }
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value value = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), element_type);
+  size_t element_size = elementTypeInfo(element_type).size;
+  if (element_size > 0 && element_count > 0) {
+    std::memset(value.GetTensorMutableRawData(), 0, element_size * element_count);
+  }
+  return value;
+}
+
+// Set the values of a sequence state to its initial empty sequence
+void resetState(Ort::Session &session, const std::vector<std::string> &input_names, SequenceState &state) {
+  std::vector<Ort::Value> values;
+  for (const auto &loop : state.loops) {
+    size_t index = std::find(input_names.begin(), input_names.end(), loop.second) - input_names.begin();
+    values.push_back(createZeroTensor(session.GetInputTypeInfo(index), state.initial_dims, 0));
+  }
+  state.values = std::move(values);
+}
+
+// Bytes of the values of a sequence state
+uint64_t stateByteSize(const SequenceState &state) {
+  std::vector<const OrtValue *> values(state.values.begin(), state.values.end());
+  return totalByteSize(values.data(), values.size());
+}
+
+} // namespace
+
+bool parseGraphOptimizationLevel(const std::string &name, GraphOptimizationLevel *level) {
+  static const std::map<std::string, GraphOptimizationLevel> levels = {
+      {"disabled", GraphOptimizationLevel::ORT_DISABLE_ALL},
+      {"basic", GraphOptimizationLevel::ORT_ENABLE_BASIC},
+      {"extended", GraphOptimizationLevel::ORT_ENABLE_EXTENDED},
+      {"all", GraphOptimizationLevel::ORT_ENABLE_ALL},
+  };
+
+  auto it = levels.find(name);
+  if (it == levels.end()) {
+    return false;
+  }
+  *level = it->second;
+  return true;
+}
+
+SessionManager::SessionManager() {
+  // The ONNX Runtime environment is created on first use, so that its thread pools can still be configured
+}
+
+SessionManager::~SessionManager() {
+  // Clear all sessions
+  std::lock_guard<TracedMutex> lock(mutex_);
+  sessions_.clear();
+  session_cache_.clear();
+}
+
+SessionHandle SessionManager::createSession(const char *model_path, const Ort::SessionOptions &session_options,
+                                            const std::string &options_key, const std::string &optimized_model_dir,
+                                            bool map_model, bool profiling) {
+  // The model is loaded without holding the lock
+  try {
+    std::filesystem::path path = std::filesystem::u8path(model_path);
+    std::string identity;
+    std::string cache_key;
+    size_t model_size = 0;
+    std::shared_ptr<CachedModel> model;
+    bool cache_enabled;
+    {
+      std::lock_guard<TracedMutex> lock(mutex_);
+      cache_enabled = session_cache_.enabled();
+    }
+    // The identity also keys the prepacked weights shared by sessions of the same model file
+    identity = modelIdentity(model_path, path, &model_size);
+    if (cache_enabled && !identity.empty() && !profiling) {
+      cache_key = identity + '\n' + options_key;
+    }
+    if (!cache_key.empty()) {
+      std::lock_guard<TracedMutex> lock(mutex_);
+      model = session_cache_.find(cache_key);
+    }
+
+    if (!model) {
+      // Create a new session with the provided options
+      // With shared thread pools, the session must not create pools of its own
+      bool global_thread_pools;
+      bool shared_arena;
+      Ort::Env &env = acquireEnv(&global_thread_pools, &shared_arena);
+      Ort::SessionOptions options = session_options.Clone();
+      if (global_thread_pools) {
+        options.DisablePerSessionThreads();
+      }
+      if (shared_arena) {
+        options.AddConfigEntry("session.use_env_allocators", "1");
+      }
+      std::shared_ptr<Ort::PrepackedWeightsContainer> prepacked_weights = acquirePrepackedWeights(identity);
+      model = describeModel(loadSession(env, path, options, map_model, prepacked_weights.get(), identity, options_key,
+                                        optimized_model_dir));
+      model->prepacked_weights = std::move(prepacked_weights);
+      model->quantization->model_path = path;
+
+      if (!cache_key.empty()) {
+        // Evicted models are released after the lock, as destroying a session can take a while
+        std::vector<std::shared_ptr<CachedModel>> evicted;
+        std::lock_guard<TracedMutex> lock(mutex_);
+        evicted = session_cache_.insert(cache_key, model, model_size);
+      }
+    }
+
+    return addSession(*model);
+  } catch (const Ort::Exception &e) {
+    std::cerr << "ONNX Runtime Error: " << e.what() << std::endl;
+    throw;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    throw;
+  }
+}
+
+SessionHandle SessionManager::createSessionFromBuffer(const void *model_data, size_t model_size,
+                                                      const Ort::SessionOptions &session_options) {
+  // The model is loaded without holding the lock
+  try {
+    bool global_thread_pools;
+    bool shared_arena;
+    Ort::Env &env = acquireEnv(&global_thread_pools, &shared_arena);
+    Ort::SessionOptions options = session_options.Clone();
+    if (global_thread_pools) {
+      options.DisablePerSessionThreads();
+    }
+    if (shared_arena) {
+      options.AddConfigEntry("session.use_env_allocators", "1");
+    }
+    std::shared_ptr<CachedModel> model =
+        describeModel(std::make_shared<Ort::Session>(env, model_data, model_size, options));
+    model->quantization->quantization = readModelQuantization(model_data, model_size);
+    return addSession(*model);
+  } catch (const Ort::Exception &e) {
+    std::cerr << "ONNX Runtime Error: " << e.what() << std::endl;
+    throw;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    throw;
+  }
+}
+
+Ort::Env &SessionManager::acquireEnv(bool *global_thread_pools, bool *shared_arena) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  if (!env_) {
+    env_ = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "FlutterOnnxRuntime");
+  }
+  *global_thread_pools = thread_pools_.has_value();
+  if (shared_arena != nullptr) {
+    *shared_arena = shared_arena_.has_value();
+  }
+  return *env_;
+}
+
+std::shared_ptr<Ort::PrepackedWeightsContainer> SessionManager::acquirePrepackedWeights(const std::string &identity) {
+  if (identity.empty()) {
+    return nullptr;
+  }
+  std::lock_guard<TracedMutex> lock(mutex_);
+  std::shared_ptr<Ort::PrepackedWeightsContainer> weights = prepacked_weights_[identity].lock();
+  if (!weights) {
+    // Containers of models no session uses anymore are dropped
+    for (auto it = prepacked_weights_.begin(); it != prepacked_weights_.end();) {
+      it = it->second.expired() && it->first != identity ? prepacked_weights_.erase(it) : std::next(it);
+    }
+    weights = std::make_shared<Ort::PrepackedWeightsContainer>();
+    prepacked_weights_[identity] = weights;
+  }
+  return weights;
+}
+
+SessionHandle SessionManager::addSession(const CachedModel &model) {
+  // Create session info
+  auto session_info_ptr = std::make_shared<SessionInfo>();
+  SessionInfo &session_info = *session_info_ptr;
+  session_info.prepacked_weights = model.prepacked_weights;
+  session_info.session = model.session;
+  session_info.input_names = model.input_names;
+  session_info.output_names = model.output_names;
+  session_info.dynamic_batch = model.dynamic_batch;
+  session_info.quantization = model.quantization;
+
+  // Store the session info
+  std::lock_guard<TracedMutex> lock(mutex_);
+  return sessions_.insert(std::move(session_info_ptr));
+}
+
+bool SessionManager::closeSession(SessionHandle session_id) {
+  // Runs still in flight hold their own reference, so the session is destroyed once the last one finishes
+  std::shared_ptr<SessionInfo> session_info;
+  {
+    std::lock_guard<TracedMutex> lock(mutex_);
+
+    std::optional<std::shared_ptr<SessionInfo>> entry = sessions_.take(session_id);
+    if (!entry) {
+      return false;
+    }
+    session_info = std::move(*entry);
+  }
+
+  // Release outside the lock, as destroying a session can take a while
+  session_info.reset();
+  return true;
+}
+
+void SessionManager::configureSessionCache(size_t max_sessions, size_t max_bytes) {
+  // Evicted models are released after the lock, as destroying a session can take a while
+  std::vector<std::shared_ptr<CachedModel>> evicted;
+  std::lock_guard<TracedMutex> lock(mutex_);
+  evicted = session_cache_.setLimits(max_sessions, max_bytes);
+}
+
+void SessionManager::configureThreadPools(const ThreadPoolOptions &options) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  if (env_) {
+    // Existing sessions would keep their own pools, so the environment is never replaced
+    if (thread_pools_ && *thread_pools_ == options) {
+      return;
+    }
+    throw std::runtime_error(
+        "Thread pools must be configured before the first session is created or the shared arena is configured");
+  }
+
+  Ort::ThreadingOptions threading_options;
+  threading_options.SetGlobalIntraOpNumThreads(options.intra_op_threads);
+  threading_options.SetGlobalInterOpNumThreads(options.inter_op_threads);
+  threading_options.SetGlobalSpinControl(options.allow_spinning ? 1 : 0);
+  if (!options.intra_op_affinity.empty()) {
+    Ort::ThrowOnError(
+        Ort::GetApi().SetGlobalIntraOpThreadAffinity(threading_options, options.intra_op_affinity.c_str()));
+  }
+
+  env_ = std::make_unique<Ort::Env>(threading_options, ORT_LOGGING_LEVEL_WARNING, "FlutterOnnxRuntime");
+  thread_pools_ = options;
+}
+
+void SessionManager::configureSharedArena(const ArenaOptions &options) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  if (shared_arena_) {
+    // Sessions already created hold the registered allocator, so it is never replaced
+    if (*shared_arena_ == options) {
+      return;
+    }
+    throw std::runtime_error("The shared arena is already configured with other options");
+  }
+  if (!env_) {
+    env_ = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "FlutterOnnxRuntime");
+  }
+
+  Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::ArenaCfg arena_cfg(options.max_bytes, options.extend_strategy, options.initial_chunk_bytes,
+                          options.max_dead_bytes_per_chunk);
+  env_->CreateAndRegisterAllocator(memory_info, arena_cfg);
+  shared_arena_ = options;
+}
+
+bool SessionManager::hasSession(SessionHandle session_id) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  return sessions_.find(session_id) != nullptr;
+}
+
+std::vector<std::string> SessionManager::getInputNames(SessionHandle session_id) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (session_info) {
+    return session_info->input_names;
+  }
+
+  return {};
+}
+
+std::vector<std::string> SessionManager::getOutputNames(SessionHandle session_id) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (session_info) {
+    return session_info->output_names;
+  }
+
+  return {};
+}
+
+std::shared_ptr<SessionInfo> SessionManager::findSession(SessionHandle session_id) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  std::shared_ptr<SessionInfo> *session_info = sessions_.find(session_id);
+  if (session_info == nullptr) {
+    return nullptr;
+  }
+  return *session_info;
+}
+
+// Get element type string helper
+const char *SessionManager::getElementTypeString(ONNXTensorElementDataType element_type) {
+  return elementTypeInfo(element_type).name;
+}
+
+size_t SessionManager::getElementSize(ONNXTensorElementDataType element_type) {
+  return elementTypeInfo(element_type).size;
+}
+
+// Get model metadata
+ModelMetadata SessionManager::getModelMetadata(SessionHandle session_id) {
+  ModelMetadata metadata{};
+
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (session_info) {
+    try {
+      Ort::Session *session = session_info->session.get();
+      if (session) {
+        // Get model metadata
+        Ort::ModelMetadata model_metadata = session->GetModelMetadata();
+        Ort::AllocatorWithDefaultOptions allocator;
+
+        // Extract metadata details
+        auto producer_name = model_metadata.GetProducerNameAllocated(allocator);
+        auto graph_name = model_metadata.GetGraphNameAllocated(allocator);
+        auto domain = model_metadata.GetDomainAllocated(allocator);
+        auto description = model_metadata.GetDescriptionAllocated(allocator);
+
+        metadata.producer_name = producer_name.get();
+        metadata.graph_name = graph_name.get();
+        metadata.domain = domain.get();
+        metadata.description = description.get();
+        metadata.version = model_metadata.GetVersion();
+
+        // Add custom metadata if needed
+        // Currently returning an empty map as in the original implementation
+      }
+    } catch (const Ort::Exception &e) {
+      std::cerr << "ONNX Runtime Error: " << e.what() << std::endl;
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+    }
+  }
+
+  return metadata;
+}
+
+// Get input info
+std::vector<TensorInfo> SessionManager::getInputInfo(SessionHandle session_id) {
+  std::vector<TensorInfo> info_list;
+
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (session_info) {
+    try {
+      Ort::Session *session = session_info->session.get();
+      if (session) {
+        size_t num_inputs = session->GetInputCount();
+        Ort::AllocatorWithDefaultOptions allocator;
+
+        for (size_t i = 0; i < num_inputs; i++) {
+          TensorInfo info{};
+
+          // Get input name
+          auto input_name = session->GetInputNameAllocated(i, allocator);
+          info.name = input_name.get();
+
+          // Get type and shape
+          auto type_info = session->GetInputTypeInfo(i);
+          ONNXType onnx_type = type_info.GetONNXType();
+
+          if (onnx_type == ONNX_TYPE_TENSOR) {
+            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+            info.shape = tensor_info.GetShape();
+
+            // Get element type
+            info.element_type = tensor_info.GetElementType();
+            info.type = getElementTypeString(info.element_type);
+          } else {
+            // Non-tensor type
+            info.type = "non-tensor";
+          }
+
+          const ModelQuantization &model_quantization = modelQuantization(*session_info->quantization);
+          auto quantization = model_quantization.inputs.find(info.name);
+          if (quantization != model_quantization.inputs.end()) {
+            info.quantization = quantization->second;
+          }
+
+          info_list.push_back(info);
+        }
+      }
+    } catch (const Ort::Exception &e) {
+      std::cerr << "ONNX Runtime Error: " << e.what() << std::endl;
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+    }
+  }
+
+  return info_list;
+}
+
+// Get output info
+std::vector<TensorInfo> SessionManager::getOutputInfo(SessionHandle session_id) {
+  std::vector<TensorInfo> info_list;
+
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (session_info) {
+    try {
+      Ort::Session *session = session_info->session.get();
+      if (session) {
+        size_t num_outputs = session->GetOutputCount();
+        Ort::AllocatorWithDefaultOptions allocator;
+
+        for (size_t i = 0; i < num_outputs; i++) {
+          TensorInfo info{};
+
+          // Get output name
+          auto output_name = session->GetOutputNameAllocated(i, allocator);
+          info.name = output_name.get();
+
+          // Get type and shape
+          auto type_info = session->GetOutputTypeInfo(i);
+          ONNXType onnx_type = type_info.GetONNXType();
+
+          if (onnx_type == ONNX_TYPE_TENSOR) {
+            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+            info.shape = tensor_info.GetShape();
+
+            // Get element type
+            info.element_type = tensor_info.GetElementType();
+            info.type = getElementTypeString(info.element_type);
+          } else {
+            // Non-tensor type
+            info.type = "non-tensor";
+          }
+
+          const ModelQuantization &model_quantization = modelQuantization(*session_info->quantization);
+          auto quantization = model_quantization.outputs.find(info.name);
+          if (quantization != model_quantization.outputs.end()) {
+            info.quantization = quantization->second;
+          }
+
+          info_list.push_back(info);
+        }
+      }
+    } catch (const Ort::Exception &e) {
+      std::cerr << "ONNX Runtime Error: " << e.what() << std::endl;
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+    }
+  }
+
+  return info_list;
+}
+
+void SessionManager::warmupSession(SessionHandle session_id, int runs,
+                                   const std::map<std::string, int64_t> &dynamic_dims) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  Ort::Session *session = session_info->session.get();
+  size_t num_inputs = session->GetInputCount();
+  if (runs <= 0 || num_inputs == 0) {
+    return;
+  }
+
+  std::vector<Ort::Value> inputs;
+  inputs.reserve(num_inputs);
+  for (size_t i = 0; i < num_inputs; i++) {
+    Ort::TypeInfo type_info = session->GetInputTypeInfo(i);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+      return;
+    }
+    inputs.push_back(createZeroTensor(type_info, dynamic_dims, 1));
+  }
+
+  for (int run = 0; run < runs; run++) {
+    runInference(session_id, inputs, session_info->input_names);
+  }
+
+  // The stats describe real runs only
+  session_info->stats.reset();
+}
+
+std::optional<std::string> SessionManager::endProfiling(SessionHandle session_id) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    return std::nullopt;
+  }
+
+  // ONNX Runtime writes the trace file here, and returns an empty path if the session was not profiled
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::AllocatedStringPtr profile_path = session_info->session->EndProfilingAllocated(allocator);
+  return std::string(profile_path.get());
+}
+
+std::optional<SessionStatsSnapshot> SessionManager::getSessionStats(SessionHandle session_id) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    return std::nullopt;
+  }
+  return session_info->stats.snapshot();
+}
+
+void SessionManager::recordCall(SessionHandle session_id, uint64_t input_nanos, uint64_t output_nanos) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (session_info) {
+    session_info->stats.recordCall(input_nanos, output_nanos);
+  }
+}
+
+// Run inference with provided input names
+std::vector<Ort::Value> SessionManager::runInference(SessionHandle session_id,
+                                                     const std::vector<Ort::Value> &input_tensors,
+                                                     const std::vector<std::string> &input_names,
+                                                     Ort::RunOptions *run_options) {
+  std::vector<const OrtValue *> input_values;
+  input_values.reserve(input_tensors.size());
+  for (const auto &tensor : input_tensors) {
+    input_values.push_back(tensor);
+  }
+  return runInference(session_id, input_values, input_names, run_options);
+}
+
+std::vector<Ort::Value> SessionManager::runInference(SessionHandle session_id,
+                                                     const std::vector<const OrtValue *> &input_values,
+                                                     const std::vector<std::string> &input_names,
+                                                     Ort::RunOptions *run_options,
+                                                     const std::vector<std::string> &output_names) {
+
+  // Only the lookup is locked; ORT sessions can run concurrently from several threads, and the
+  // shared_ptr keeps the session alive even if it is closed while this run is in flight
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  Ort::Session *session = session_info->session.get();
+  if (!session) {
+    throw Ort::Exception("Session is invalid", ORT_INVALID_ARGUMENT);
+  }
+
+  if (input_values.empty()) {
+    throw Ort::Exception("No input tensors provided", ORT_INVALID_ARGUMENT);
+  }
+
+  if (input_names.size() != input_values.size()) {
+    throw Ort::Exception("Number of input names must match number of input tensors", ORT_INVALID_ARGUMENT);
+  }
+
+  // A session with sequence state runs one step at a time, each fed the state the previous step left
+  std::unique_lock<std::mutex> state_lock(session_info->state_mutex);
+  SequenceState *state = session_info->sequence_state.get();
+  if (!state) {
+    state_lock.unlock();
+  }
+
+  // Prepare input names, followed by the state inputs the caller did not pass
+  std::vector<const char *> input_names_char;
+  for (const auto &name : input_names) {
+    input_names_char.push_back(name.c_str());
+  }
+  std::vector<const OrtValue *> run_inputs = input_values;
+  if (state) {
+    for (size_t i = 0; i < state->loops.size(); i++) {
+      const std::string &input_name = state->loops[i].second;
+      if (std::find(input_names.begin(), input_names.end(), input_name) == input_names.end()) {
+        input_names_char.push_back(input_name.c_str());
+        run_inputs.push_back(state->values[i]);
+      }
+    }
+  }
+
+  // Prepare output names: the selected ones, followed by the looped outputs that were not selected
+  const std::vector<std::string> &selected = output_names.empty() ? session_info->output_names : output_names;
+  std::vector<const char *> output_names_char;
+  for (const auto &name : selected) {
+    output_names_char.push_back(name.c_str());
+  }
+  std::vector<size_t> state_indices;
+  if (state) {
+    for (const auto &loop : state->loops) {
+      auto output = std::find(selected.begin(), selected.end(), loop.first);
+      state_indices.push_back(output != selected.end() ? output - selected.begin() : output_names_char.size());
+      if (output == selected.end()) {
+        output_names_char.push_back(loop.first.c_str());
+      }
+    }
+  }
+
+  // Create default run options if none provided
+  Ort::RunOptions default_run_options;
+  Ort::RunOptions *run_opts = run_options ? run_options : &default_run_options;
+
+  // Run inference through the C API, which takes the inputs as plain OrtValue pointers
+  // so that stored tensors can be passed without wrapping or copying them - let exceptions propagate out
+  std::vector<OrtValue *> raw_outputs(output_names_char.size(), nullptr);
+  TraceScope run_trace("Session::Run");
+  uint64_t run_start = steadyNanos();
+  Ort::ThrowOnError(Ort::GetApi().Run(*session, *run_opts, input_names_char.data(), run_inputs.data(),
+                                      run_inputs.size(), output_names_char.data(), output_names_char.size(),
+                                      raw_outputs.data()));
+  run_trace.end();
+  session_info->stats.recordRun(steadyNanos() - run_start, totalByteSize(run_inputs.data(), run_inputs.size()),
+                                totalByteSize(raw_outputs.data(), raw_outputs.size()));
+
+  std::vector<Ort::Value> output_tensors;
+  output_tensors.reserve(raw_outputs.size());
+  for (OrtValue *output : raw_outputs) {
+    output_tensors.emplace_back(output);
+  }
+
+  // The looped outputs become the state of the next step without leaving native memory
+  if (state) {
+    for (size_t i = 0; i < state->loops.size(); i++) {
+      state->values[i] = std::move(output_tensors[state_indices[i]]);
+    }
+    session_info->state_bytes = stateByteSize(*state);
+    output_tensors.erase(output_tensors.begin() + selected.size(), output_tensors.end());
+  }
+
+  return output_tensors;
+}
+
+void SessionManager::runIntoOutputs(SessionHandle session_id, const std::vector<const OrtValue *> &input_values,
+                                    const std::vector<std::string> &input_names,
+                                    const std::vector<std::string> &output_names, std::vector<OrtValue *> &outputs,
+                                    Ort::RunOptions *run_options) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  if (input_values.empty()) {
+    throw Ort::Exception("No input tensors provided", ORT_INVALID_ARGUMENT);
+  }
+
+  if (input_names.size() != input_values.size() || output_names.size() != outputs.size()) {
+    throw Ort::Exception("Number of names must match number of tensors", ORT_INVALID_ARGUMENT);
+  }
+
+  std::vector<const char *> input_names_char;
+  for (const auto &name : input_names) {
+    input_names_char.push_back(name.c_str());
+  }
+  std::vector<const char *> output_names_char;
+  for (const auto &name : output_names) {
+    output_names_char.push_back(name.c_str());
+  }
+
+  Ort::RunOptions default_run_options;
+  Ort::RunOptions *run_opts = run_options ? run_options : &default_run_options;
+
+  // Preallocated outputs are passed to the C API as they are, so the run writes straight into them
+  TraceScope run_trace("Session::Run into outputs");
+  uint64_t run_start = steadyNanos();
+  Ort::ThrowOnError(Ort::GetApi().Run(*session_info->session, *run_opts, input_names_char.data(), input_values.data(),
+                                      input_values.size(), output_names_char.data(), output_names_char.size(),
+                                      outputs.data()));
+  run_trace.end();
+  session_info->stats.recordRun(steadyNanos() - run_start, totalByteSize(input_values.data(), input_values.size()),
+                                totalByteSize(outputs.data(), outputs.size()));
+}
+
+std::vector<Ort::Value> SessionManager::runInferenceOnDevice(SessionHandle session_id,
+                                                             const std::vector<const OrtValue *> &input_values,
+                                                             const std::vector<std::string> &input_names,
+                                                             const Ort::MemoryInfo &output_memory_info,
+                                                             Ort::RunOptions *run_options,
+                                                             const std::vector<std::string> &output_names) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  if (input_values.empty()) {
+    throw Ort::Exception("No input tensors provided", ORT_INVALID_ARGUMENT);
+  }
+
+  if (input_names.size() != input_values.size()) {
+    throw Ort::Exception("Number of input names must match number of input tensors", ORT_INVALID_ARGUMENT);
+  }
+
+  // A binding of this run only, so that concurrent runs of the session do not share it
+  Ort::IoBinding io_binding(*session_info->session);
+  for (size_t i = 0; i < input_values.size(); i++) {
+    Ort::ThrowOnError(Ort::GetApi().BindInput(io_binding, input_names[i].c_str(), input_values[i]));
+  }
+  for (const auto &name : output_names.empty() ? session_info->output_names : output_names) {
+    io_binding.BindOutput(name.c_str(), output_memory_info);
+  }
+
+  // Create default run options if none provided
+  Ort::RunOptions default_run_options;
+  Ort::RunOptions *run_opts = run_options ? run_options : &default_run_options;
+
+  TraceScope run_trace("Session::Run on device");
+  uint64_t run_start = steadyNanos();
+  session_info->session->Run(*run_opts, io_binding);
+  io_binding.SynchronizeOutputs();
+  run_trace.end();
+  std::vector<Ort::Value> output_tensors = io_binding.GetOutputValues();
+
+  std::vector<const OrtValue *> output_values(output_tensors.begin(), output_tensors.end());
+  session_info->stats.recordRun(steadyNanos() - run_start, totalByteSize(input_values.data(), input_values.size()),
+                                totalByteSize(output_values.data(), output_values.size()));
+  return output_tensors;
+}
+
+Ort::Value SessionManager::copyToHost(const OrtValue *value) {
+  TraceScope trace("SessionManager::copyToHost");
+  Ort::ConstValue device_value{value};
+  Ort::ConstMemoryInfo memory_info = device_value.GetTensorMemoryInfo();
+  std::shared_ptr<Ort::Session> session = acquireCopySession(
+      device_value.GetTensorTypeAndShapeInfo().GetElementType(), memory_info.GetAllocatorName(),
+      memory_info.GetDeviceId());
+
+  Ort::IoBinding io_binding(*session);
+  Ort::ThrowOnError(Ort::GetApi().BindInput(io_binding, kIdentityInputName, value));
+  io_binding.BindOutput(kIdentityOutputName, Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault));
+  session->Run(Ort::RunOptions(), io_binding);
+  io_binding.SynchronizeOutputs();
+  std::vector<Ort::Value> outputs = io_binding.GetOutputValues();
+  return std::move(outputs.at(0));
+}
+
+std::shared_ptr<Ort::Session> SessionManager::acquireCopySession(ONNXTensorElementDataType element_type,
+                                                                 const std::string &allocator_name, int device_id) {
+  auto key = std::make_tuple(static_cast<int>(element_type), allocator_name, device_id);
+  {
+    std::lock_guard<TracedMutex> lock(mutex_);
+    auto session_it = copy_sessions_.find(key);
+    if (session_it != copy_sessions_.end()) {
+      return session_it->second;
+    }
+  }
+
+  // The session is created without holding the lock; if two threads race, the first one stored is kept
+  bool global_thread_pools;
+  Ort::Env &env = acquireEnv(&global_thread_pools);
+  Ort::SessionOptions options;
+  if (global_thread_pools) {
+    options.DisablePerSessionThreads();
+  } else {
+    options.SetIntraOpNumThreads(1);
+  }
+  appendCopyProvider(options, allocator_name, device_id);
+  std::string model = buildIdentityModel(static_cast<int32_t>(element_type));
+  auto session = std::make_shared<Ort::Session>(env, model.data(), model.size(), options);
+
+  std::lock_guard<TracedMutex> lock(mutex_);
+  return copy_sessions_.emplace(key, std::move(session)).first->second;
+}
+
+std::vector<std::vector<Ort::Value>>
+SessionManager::runBatch(SessionHandle session_id, const std::vector<std::vector<const OrtValue *>> &input_values,
+                         const std::vector<std::vector<std::string>> &input_names, Ort::RunOptions *run_options,
+                         std::vector<std::string> *errors) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  if (input_names.size() != input_values.size()) {
+    throw Ort::Exception("Number of input name lists must match number of requests", ORT_INVALID_ARGUMENT);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(session_info->state_mutex);
+    if (session_info->sequence_state) {
+      throw Ort::Exception("A session with sequence state runs one step at a time through runInference",
+                           ORT_INVALID_ARGUMENT);
+    }
+  }
+
+  if (errors != nullptr) {
+    errors->assign(input_values.size(), std::string());
+  }
+
+  if (input_values.size() > 1 && session_info->dynamic_batch && !session_info->unsplittable_outputs) {
+    std::vector<std::vector<Ort::Value>> outputs;
+    try {
+      outputs = runStacked(session_id, *session_info, input_values, input_names, run_options);
+    } catch (const std::exception &) {
+      // With errors, the requests run one by one to tell which of them failed
+      if (errors == nullptr) {
+        throw;
+      }
+    }
+    if (!outputs.empty()) {
+      return outputs;
+    }
+  }
+
+  // One run per request, still answered in a single channel message
+  std::vector<std::vector<Ort::Value>> outputs;
+  outputs.reserve(input_values.size());
+  for (size_t r = 0; r < input_values.size(); r++) {
+    if (errors == nullptr) {
+      outputs.push_back(runInference(session_id, input_values[r], input_names[r], run_options));
+      continue;
+    }
+    try {
+      outputs.push_back(runInference(session_id, input_values[r], input_names[r], run_options));
+    } catch (const std::exception &e) {
+      outputs.emplace_back();
+      (*errors)[r] = e.what();
+    }
+  }
+  return outputs;
+}
+
+std::vector<std::vector<Ort::Value>>
+SessionManager::runStacked(SessionHandle session_id, SessionInfo &session_info,
+                           const std::vector<std::vector<const OrtValue *>> &input_values,
+                           const std::vector<std::vector<std::string>> &input_names, Ort::RunOptions *run_options) {
+  const std::vector<std::string> &session_input_names = session_info.input_names;
+  size_t num_requests = input_values.size();
+  size_t num_inputs = session_input_names.size();
+
+  // parts[i][r] is input i of request r in the session's input order; every request must provide every input
+  std::vector<std::vector<const OrtValue *>> parts(num_inputs, std::vector<const OrtValue *>(num_requests, nullptr));
+  for (size_t r = 0; r < num_requests; r++) {
+    if (input_values[r].size() != num_inputs || input_names[r].size() != num_inputs) {
+      return {};
+    }
+    for (size_t j = 0; j < num_inputs; j++) {
+      auto it = std::find(session_input_names.begin(), session_input_names.end(), input_names[r][j]);
+      if (it == session_input_names.end()) {
+        return {};
+      }
+      parts[it - session_input_names.begin()][r] = input_values[r][j];
+    }
+  }
+
+  // The inputs of a request share its leading dimension, and the requests agree on type and trailing dimensions
+  std::vector<int64_t> batch_sizes(num_requests, 0);
+  int64_t total_batch_size = 0;
+  std::vector<Ort::Value> stacked_inputs;
+  stacked_inputs.reserve(num_inputs);
+  for (size_t i = 0; i < num_inputs; i++) {
+    ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+    std::vector<int64_t> stacked_shape;
+    for (size_t r = 0; r < num_requests; r++) {
+      if (parts[i][r] == nullptr) {
+        return {};
+      }
+      Ort::ConstValue part(parts[i][r]);
+      if (!part.IsTensor()) {
+        return {};
+      }
+      auto tensor_info = part.GetTensorTypeAndShapeInfo();
+      std::vector<int64_t> shape = tensor_info.GetShape();
+      if (shape.empty() || shape[0] < 1 || (i > 0 && shape[0] != batch_sizes[r])) {
+        return {};
+      }
+      batch_sizes[r] = shape[0];
+
+      if (r == 0) {
+        element_type = tensor_info.GetElementType();
+        if (elementTypeInfo(element_type).size == 0) {
+          return {};
+        }
+        stacked_shape = shape;
+        stacked_shape[0] = 0;
+      } else if (tensor_info.GetElementType() != element_type ||
+                 !std::equal(shape.begin() + 1, shape.end(), stacked_shape.begin() + 1, stacked_shape.end())) {
+        return {};
+      }
+      stacked_shape[0] += shape[0];
+    }
+    total_batch_size = stacked_shape[0];
+    stacked_inputs.push_back(concatenate(parts[i], element_type, stacked_shape));
+  }
+
+  std::vector<const OrtValue *> stacked_values;
+  stacked_values.reserve(stacked_inputs.size());
+  for (const auto &tensor : stacked_inputs) {
+    stacked_values.push_back(tensor);
+  }
+  std::vector<Ort::Value> stacked_outputs = runInference(session_id, stacked_values, session_input_names, run_options);
+
+  // Split each output back along axis 0. Outputs whose leading dimension does not follow the batch
+  // (e.g. a reduction over it) cannot be split, so the requests are run one by one instead, now and in every
+  // later batch of the session.
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::vector<std::vector<Ort::Value>> outputs(num_requests);
+  for (auto &output : stacked_outputs) {
+    auto tensor_info = output.GetTensorTypeAndShapeInfo();
+    ONNXTensorElementDataType element_type = tensor_info.GetElementType();
+    std::vector<int64_t> shape = tensor_info.GetShape();
+    size_t element_size = elementTypeInfo(element_type).size;
+    if (shape.empty() || shape[0] != total_batch_size || element_size == 0) {
+      session_info.unsplittable_outputs = true;
+      return {};
+    }
+
+    size_t row_bytes = tensor_info.GetElementCount() / static_cast<size_t>(total_batch_size) * element_size;
+    const auto *src = static_cast<const uint8_t *>(output.GetTensorRawData());
+    for (size_t r = 0; r < num_requests; r++) {
+      shape[0] = batch_sizes[r];
+      Ort::Value part = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), element_type);
+      size_t bytes = static_cast<size_t>(batch_sizes[r]) * row_bytes;
+      std::memcpy(part.GetTensorMutableRawData(), src, bytes);
+      src += bytes;
+      outputs[r].push_back(std::move(part));
+    }
+  }
+  return outputs;
+}
+
+void SessionManager::enableSequenceState(SessionHandle session_id,
+                                         const std::vector<std::pair<std::string, std::string>> &loops,
+                                         const std::map<std::string, int64_t> &initial_dims) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  if (loops.empty()) {
+    throw Ort::Exception("Sequence state needs at least one output to feed back", ORT_INVALID_ARGUMENT);
+  }
+
+  auto state = std::make_unique<SequenceState>();
+  const std::vector<std::string> &input_names = session_info->input_names;
+  const std::vector<std::string> &output_names = session_info->output_names;
+  for (const auto &[output_name, input_name] : loops) {
+    if (std::find(output_names.begin(), output_names.end(), output_name) == output_names.end()) {
+      throw Ort::Exception("Session has no output " + output_name, ORT_INVALID_ARGUMENT);
+    }
+    if (std::find(input_names.begin(), input_names.end(), input_name) == input_names.end()) {
+      throw Ort::Exception("Session has no input " + input_name, ORT_INVALID_ARGUMENT);
+    }
+    state->loops.emplace_back(output_name, input_name);
+  }
+  state->initial_dims = initial_dims;
+  resetState(*session_info->session, input_names, *state);
+
+  std::lock_guard<std::mutex> lock(session_info->state_mutex);
+  session_info->state_bytes = stateByteSize(*state);
+  session_info->sequence_state = std::move(state);
+}
+
+bool SessionManager::resetSequenceState(SessionHandle session_id) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(session_info->state_mutex);
+  if (!session_info->sequence_state) {
+    return false;
+  }
+  resetState(*session_info->session, session_info->input_names, *session_info->sequence_state);
+  session_info->state_bytes = stateByteSize(*session_info->sequence_state);
+  return true;
+}
+
+void SessionManager::disableSequenceState(SessionHandle session_id) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(session_info->state_mutex);
+  session_info->sequence_state.reset();
+  session_info->state_bytes = 0;
+}
+
+std::vector<std::pair<SessionHandle, uint64_t>> SessionManager::getSequenceStateBytes() {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  std::vector<std::pair<SessionHandle, uint64_t>> state_bytes;
+  sessions_.forEach([&state_bytes](SessionHandle session_id, std::shared_ptr<SessionInfo> &session_info) {
+    if (session_info->state_bytes > 0) {
+      state_bytes.emplace_back(session_id, session_info->state_bytes.load());
+    }
+  });
+  return state_bytes;
+}
+
+bool SessionManager::hasSequenceState(SessionHandle session_id) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(session_info->state_mutex);
+  return session_info->sequence_state != nullptr;
+}
+
+void SessionManager::bindOutputs(SessionHandle session_id, const std::vector<std::string> &output_names,
+                                 std::vector<TensorLease> &&outputs) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  if (output_names.empty() || output_names.size() != outputs.size()) {
+    throw Ort::Exception("Number of output names must match number of output tensors", ORT_INVALID_ARGUMENT);
+  }
+
+  std::lock_guard<std::mutex> lock(session_info->binding_mutex);
+
+  auto io_binding = std::make_unique<Ort::IoBinding>(*session_info->session);
+  for (size_t i = 0; i < outputs.size(); i++) {
+    Ort::ThrowOnError(Ort::GetApi().BindOutput(*io_binding, output_names[i].c_str(), outputs[i].get()));
+  }
+
+  session_info->io_binding = std::move(io_binding);
+  session_info->bound_output_names = output_names;
+  session_info->bound_outputs = std::move(outputs);
+}
+
+void SessionManager::unbindOutputs(SessionHandle session_id) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(session_info->binding_mutex);
+  session_info->io_binding.reset();
+  session_info->bound_output_names.clear();
+  session_info->bound_outputs.clear();
+}
+
+std::vector<std::pair<std::string, TensorHandle>>
+SessionManager::runWithBinding(SessionHandle session_id, const std::vector<const OrtValue *> &input_values,
+                               const std::vector<std::string> &input_names, Ort::RunOptions *run_options) {
+  std::shared_ptr<SessionInfo> session_info = findSession(session_id);
+  if (!session_info) {
+    throw Ort::Exception("Session not found", ORT_INVALID_ARGUMENT);
+  }
+
+  if (input_values.empty()) {
+    throw Ort::Exception("No input tensors provided", ORT_INVALID_ARGUMENT);
+  }
+
+  if (input_names.size() != input_values.size()) {
+    throw Ort::Exception("Number of input names must match number of input tensors", ORT_INVALID_ARGUMENT);
+  }
+
+  // The binding is shared state, so runs on the same session take turns; other sessions are unaffected
+  std::lock_guard<std::mutex> lock(session_info->binding_mutex);
+
+  Ort::IoBinding *io_binding = session_info->io_binding.get();
+  if (!io_binding) {
+    throw Ort::Exception("No outputs bound for this session, call bindOutputs first", ORT_INVALID_ARGUMENT);
+  }
+
+  // Create default run options if none provided
+  Ort::RunOptions default_run_options;
+  Ort::RunOptions *run_opts = run_options ? run_options : &default_run_options;
+
+  // The binding outlives the leases of the inputs, so they are unbound even if binding one of them fails
+  try {
+    for (size_t i = 0; i < input_values.size(); i++) {
+      Ort::ThrowOnError(Ort::GetApi().BindInput(*io_binding, input_names[i].c_str(), input_values[i]));
+    }
+
+    TraceScope run_trace("Session::Run with IoBinding");
+    uint64_t run_start = steadyNanos();
+    session_info->session->Run(*run_opts, *io_binding);
+    io_binding->SynchronizeOutputs();
+    run_trace.end();
+    std::vector<const OrtValue *> bound_values;
+    for (const TensorLease &output : session_info->bound_outputs) {
+      bound_values.push_back(output.get());
+    }
+    session_info->stats.recordRun(steadyNanos() - run_start, totalByteSize(input_values.data(), input_values.size()),
+                                  totalByteSize(bound_values.data(), bound_values.size()));
+  } catch (...) {
+    io_binding->ClearBoundInputs();
+    throw;
+  }
+
+  // Inputs are borrowed only for this run
+  io_binding->ClearBoundInputs();
+
+  std::vector<std::pair<std::string, TensorHandle>> bound_outputs;
+  bound_outputs.reserve(session_info->bound_outputs.size());
+  for (size_t i = 0; i < session_info->bound_outputs.size(); i++) {
+    bound_outputs.emplace_back(session_info->bound_output_names[i], session_info->bound_outputs[i].tensorId());
+  }
+  return bound_outputs;
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,383 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_SESSION_MANAGER_H_
+#define FLUTTER_ONNXRUNTIME_SESSION_MANAGER_H_
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "handle_table.h"
+#include "lru_cache.h"
+#include "quantization.h"
+#include "session_stats.h"
+#include "tensor_lease.h"
+#include "trace_recorder.h"
+
+namespace flutter_onnxruntime {
+
+// Forward declaration
+class TensorManager;
+
+// Quantization of the inputs and outputs of a model. A model file is only read for it the first time getInputInfo or
+// getOutputInfo asks, so loading a session does not parse the file a second time.
+struct LazyModelQuantization {
+  // Model file to read, empty for models created from bytes, whose quantization is read when they are created
+  std::filesystem::path model_path;
+  std::once_flag read;
+  ModelQuantization quantization;
+};
+
+// A loaded model, shared by the session cache and every session opened on it
+struct CachedModel {
+  // Weights prepacked by the kernels of every session of the same model file; it must outlive the session, so it is
+  // declared first and destroyed last
+  std::shared_ptr<Ort::PrepackedWeightsContainer> prepacked_weights;
+  std::shared_ptr<Ort::Session> session;
+  std::vector<std::string> input_names;
+  std::vector<std::string> output_names;
+  bool dynamic_batch = false;
+  // Scales and zero points of the quantized inputs and outputs, read from the model bytes
+  std::shared_ptr<LazyModelQuantization> quantization = std::make_shared<LazyModelQuantization>();
+};
+
+// Outputs of a session fed back as its inputs on the next run, e.g. the present key/values of a decoder that
+// become its past key/values, so that they stay in native memory between steps of a sequence
+struct SequenceState {
+  // (output name, input name) of each loop
+  std::vector<std::pair<std::string, std::string>> loops;
+
+  // Sizes of the dynamic dimensions of the initial values by symbolic name
+  std::map<std::string, int64_t> initial_dims;
+
+  // Value of each loop's input for the next run
+  std::vector<Ort::Value> values;
+};
+
+// Session information structure
+struct SessionInfo {
+  // Declared before session so that it outlives it, as in CachedModel
+  std::shared_ptr<Ort::PrepackedWeightsContainer> prepacked_weights;
+  // Shared with the session cache and the other sessions opened on the same cached model
+  std::shared_ptr<Ort::Session> session;
+  std::vector<std::string> input_names;
+  std::vector<std::string> output_names;
+
+  // Whether every input and output is a fixed-size tensor with a dynamic leading dimension,
+  // which lets runBatch stack requests along axis 0
+  bool dynamic_batch = false;
+
+  // Set once the outputs of a stacked run could not be split back along axis 0, e.g. because an output reduces over
+  // the batch; runBatch then runs the requests one by one from the start instead of wasting a stacked run each time
+  std::atomic<bool> unsplittable_outputs{false};
+
+  // Quantization of the inputs and outputs, shared with the CachedModel
+  std::shared_ptr<LazyModelQuantization> quantization;
+
+  // Preallocated outputs written in place by runWithBinding, set up by bindOutputs.
+  // The leases keep the output tensors alive while they are bound; io_binding is declared
+  // after them so it is destroyed first.
+  std::vector<std::string> bound_output_names;
+  std::vector<TensorLease> bound_outputs;
+  std::unique_ptr<Ort::IoBinding> io_binding;
+
+  // Serializes runs that share io_binding
+  std::mutex binding_mutex;
+
+  // Output-to-input loops set up by enableSequenceState, or null. Runs of a session with sequence state take turns
+  // under state_mutex, since each one consumes the state the previous one left.
+  std::unique_ptr<SequenceState> sequence_state;
+  std::mutex state_mutex;
+  // Bytes of the values of sequence_state, readable without state_mutex
+  std::atomic<uint64_t> state_bytes{0};
+
+  // Run counters and latency of this session
+  SessionStats stats;
+};
+
+// Model metadata structure
+struct ModelMetadata {
+  std::string producer_name;
+  std::string graph_name;
+  std::string domain;
+  std::string description;
+  int64_t version;
+  std::map<std::string, std::string> custom_metadata;
+};
+
+// Input/Output tensor info structure
+struct TensorInfo {
+  std::string name;
+  std::string type;
+  ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  std::vector<int64_t> shape;
+  // Scale and zero point of the QuantizeLinear or DequantizeLinear node at the input or output of a QDQ model
+  std::optional<QuantizationParams> quantization;
+};
+
+// Parse a graph optimization level name ("disabled", "basic", "extended" or "all"); returns false if it is unknown
+bool parseGraphOptimizationLevel(const std::string &name, GraphOptimizationLevel *level);
+
+// Thread pools shared by every session of a SessionManager
+struct ThreadPoolOptions {
+  // Number of intra-op and inter-op threads; 0 lets ONNX Runtime choose
+  int intra_op_threads = 0;
+  int inter_op_threads = 0;
+  // Whether idle threads spin before sleeping, trading CPU time for latency
+  bool allow_spinning = true;
+  // Processors of the intra-op threads in ONNX Runtime's syntax, e.g. "1,2;3,4"; empty for no affinity
+  std::string intra_op_affinity;
+
+  bool operator==(const ThreadPoolOptions &other) const {
+    return intra_op_threads == other.intra_op_threads && inter_op_threads == other.inter_op_threads &&
+           allow_spinning == other.allow_spinning && intra_op_affinity == other.intra_op_affinity;
+  }
+};
+
+// CPU arena shared by every session of a SessionManager
+struct ArenaOptions {
+  // Most bytes the arena reserves; 0 lets ONNX Runtime choose
+  size_t max_bytes = 0;
+  // 0 to grow the arena by powers of two, 1 to grow it by just the size requested; -1 lets ONNX Runtime choose
+  int extend_strategy = -1;
+  // Bytes of the first chunk the arena reserves; -1 lets ONNX Runtime choose
+  int initial_chunk_bytes = -1;
+  // Unused bytes in a chunk above which it is split; -1 lets ONNX Runtime choose
+  int max_dead_bytes_per_chunk = -1;
+
+  bool operator==(const ArenaOptions &other) const {
+    return max_bytes == other.max_bytes && extend_strategy == other.extend_strategy &&
+           initial_chunk_bytes == other.initial_chunk_bytes &&
+           max_dead_bytes_per_chunk == other.max_dead_bytes_per_chunk;
+  }
+};
+
+// Handle of a session stored in a SessionManager
+using SessionHandle = Handle;
+
+// Session Manager Class
+class SessionManager {
+public:
+  SessionManager();
+  ~SessionManager();
+
+  // Create a new session from a model file path.
+  // options_key is a canonical form of the options session_options were built from. With the session cache
+  // enabled, sessions of the same model file (path, modification time and size) and options_key share one
+  // loaded model instead of loading it again.
+  // If optimized_model_dir is not empty, the optimized graph is saved there on the first load and loaded
+  // without optimizing again next time, until the model file, ONNX Runtime version or options_key change.
+  // With map_model, the file is parsed from a read-only memory mapping instead of being read onto the heap.
+  // Sessions with profiling enabled in session_options must set profiling, so that they bypass the session
+  // cache and each profiles only its own runs.
+  SessionHandle createSession(const char *model_path, const Ort::SessionOptions &session_options,
+                              const std::string &options_key = "", const std::string &optimized_model_dir = "",
+                              bool map_model = false, bool profiling = false);
+
+  // Create a new session from the bytes of a model, which are only needed during the call.
+  // Such sessions bypass the session cache and the optimized model cache.
+  SessionHandle createSessionFromBuffer(const void *model_data, size_t model_size,
+                                        const Ort::SessionOptions &session_options);
+
+  // Close and remove a session; its model stays loaded while it is cached or other sessions still use it
+  bool closeSession(SessionHandle session_id);
+
+  // Limit the session cache to a number of models and a total model file size in bytes, 0 meaning no limit;
+  // both 0 disable the cache and drop the cached models
+  void configureSessionCache(size_t max_sessions, size_t max_bytes);
+
+  // Run every session on thread pools shared through the environment instead of pools of its own, which
+  // bounds the number of threads however many sessions are open. Per-session thread counts are then ignored.
+  // Only possible before the first session is created; throws std::runtime_error afterwards unless the
+  // options are the same as before.
+  void configureThreadPools(const ThreadPoolOptions &options);
+
+  // Register a CPU arena with the environment that every session created afterwards allocates from, instead of
+  // each reserving an arena of its own. configureThreadPools must come first, as this creates the environment.
+  // Throws std::runtime_error if an arena with other options is already registered.
+  void configureSharedArena(const ArenaOptions &options);
+
+  // Get session info
+  bool hasSession(SessionHandle session_id);
+
+  // Get input names for a session
+  std::vector<std::string> getInputNames(SessionHandle session_id);
+
+  // Get output names for a session
+  std::vector<std::string> getOutputNames(SessionHandle session_id);
+
+  // Get model metadata for a session
+  ModelMetadata getModelMetadata(SessionHandle session_id);
+
+  // Get input tensor info for a session
+  std::vector<TensorInfo> getInputInfo(SessionHandle session_id);
+
+  // Get output tensor info for a session
+  std::vector<TensorInfo> getOutputInfo(SessionHandle session_id);
+
+  // Run a session a number of times on zero-filled inputs shaped from its input info, so that kernels are
+  // initialized before the first real run. A dynamic dimension takes its size from dynamic_dims by symbolic
+  // name, or 1 if it is not listed. Models with non-tensor inputs are not run.
+  void warmupSession(SessionHandle session_id, int runs, const std::map<std::string, int64_t> &dynamic_dims);
+
+  // Stop profiling a session and return the path of its trace file, which is empty if profiling was not
+  // enabled; nothing if the session does not exist. Profiling cannot be restarted on the same session.
+  std::optional<std::string> endProfiling(SessionHandle session_id);
+
+  // Get the run counters and latency percentiles of a session, or nothing if it does not exist
+  std::optional<SessionStatsSnapshot> getSessionStats(SessionHandle session_id);
+
+  // Add the time a call spent borrowing its inputs and storing its outputs to the stats of a session.
+  // Session::Run itself is measured by the run methods.
+  void recordCall(SessionHandle session_id, uint64_t input_nanos, uint64_t output_nanos);
+
+  // Run inference with a session using provided input names
+  std::vector<Ort::Value> runInference(SessionHandle session_id, const std::vector<Ort::Value> &input_tensors,
+                                       const std::vector<std::string> &input_names,
+                                       Ort::RunOptions *run_options = nullptr);
+
+  // Run inference on borrowed input values; the caller keeps the inputs alive for the duration of the call.
+  // output_names selects the outputs to compute and return, in that order, so that ONNX Runtime can skip the
+  // nodes only the others need; empty for every output. On a session with sequence state the outputs it feeds
+  // back are computed even if not selected, and null in the result.
+  std::vector<Ort::Value> runInference(SessionHandle session_id, const std::vector<const OrtValue *> &input_values,
+                                       const std::vector<std::string> &input_names,
+                                       Ort::RunOptions *run_options = nullptr,
+                                       const std::vector<std::string> &output_names = {});
+
+  // Run inference writing into preallocated outputs, e.g. the slots of a FrameStream. outputs holds one value per
+  // output name; ONNX Runtime allocates the null ones, which the caller then owns, and writes the others in place.
+  void runIntoOutputs(SessionHandle session_id, const std::vector<const OrtValue *> &input_values,
+                      const std::vector<std::string> &input_names, const std::vector<std::string> &output_names,
+                      std::vector<OrtValue *> &outputs, Ort::RunOptions *run_options = nullptr);
+
+  // Run inference through an IoBinding that leaves the outputs in the memory of output_memory_info, e.g. on a CUDA
+  // device, so that they can be passed to another session without a round trip through host memory. Inputs may
+  // live in any memory; ONNX Runtime copies them to where the session needs them. output_names selects the
+  // outputs as for runInference.
+  std::vector<Ort::Value> runInferenceOnDevice(SessionHandle session_id,
+                                               const std::vector<const OrtValue *> &input_values,
+                                               const std::vector<std::string> &input_names,
+                                               const Ort::MemoryInfo &output_memory_info,
+                                               Ort::RunOptions *run_options = nullptr,
+                                               const std::vector<std::string> &output_names = {});
+
+  // Copy a tensor in device memory into a new tensor in host memory, through an identity model run by the
+  // provider of that device. Throws std::runtime_error if no provider of the plugin can read the memory.
+  Ort::Value copyToHost(const OrtValue *value);
+
+  // Run several requests on a session and return the outputs of each request in output name order.
+  // On a session with a dynamic batch dimension the requests are stacked along axis 0 and run once,
+  // then the outputs are split back; otherwise, or if the requests do not stack, each one runs on its own.
+  // With errors, requests that fail do not fail the others: errors gets one entry per request, the message of
+  // a failed request with no outputs, or empty. Without, the first failure throws.
+  std::vector<std::vector<Ort::Value>> runBatch(SessionHandle session_id,
+                                                const std::vector<std::vector<const OrtValue *>> &input_values,
+                                                const std::vector<std::vector<std::string>> &input_names,
+                                                Ort::RunOptions *run_options = nullptr,
+                                                std::vector<std::string> *errors = nullptr);
+
+  // Bind preallocated output tensors to a session for runWithBinding, replacing any previous binding
+  void bindOutputs(SessionHandle session_id, const std::vector<std::string> &output_names,
+                   std::vector<TensorLease> &&outputs);
+
+  // Drop the output binding of a session; the output tensors themselves stay alive until released
+  void unbindOutputs(SessionHandle session_id);
+
+  // Run inference writing into the bound outputs; returns (output name, tensor handle) pairs of the bound outputs
+  std::vector<std::pair<std::string, TensorHandle>> runWithBinding(SessionHandle session_id,
+                                                                   const std::vector<const OrtValue *> &input_values,
+                                                                   const std::vector<std::string> &input_names,
+                                                                   Ort::RunOptions *run_options = nullptr);
+
+  // Feed outputs of a session back as inputs of its next run, keeping them in native memory. loops pairs each output
+  // name with the input it feeds. The inputs start out as zero tensors shaped from the input info, with every
+  // dynamic dimension sized from initial_dims by symbolic name, or 0 (an empty sequence) if it is not listed.
+  // runInference then supplies these inputs unless the caller passes them, and returns null values in place of the
+  // looped outputs. Replaces any previous loops; throws Ort::Exception on an unknown name.
+  void enableSequenceState(SessionHandle session_id, const std::vector<std::pair<std::string, std::string>> &loops,
+                           const std::map<std::string, int64_t> &initial_dims);
+
+  // Start a new sequence from the initial values; returns false if the session has no sequence state
+  bool resetSequenceState(SessionHandle session_id);
+
+  // Drop the loops of a session and the values they hold
+  void disableSequenceState(SessionHandle session_id);
+
+  // Whether a session feeds outputs back through enableSequenceState
+  bool hasSequenceState(SessionHandle session_id);
+
+  // Bytes held by the sequence state of each session that has one, such as a key/value cache
+  std::vector<std::pair<SessionHandle, uint64_t>> getSequenceStateBytes();
+
+  // Helper method to get element type string
+  static const char *getElementTypeString(ONNXTensorElementDataType element_type);
+
+  // Size in bytes of one element of a fixed-size tensor type; 0 for strings and other types
+  static size_t getElementSize(ONNXTensorElementDataType element_type);
+
+private:
+  // Look up a session, holding mutex_ only for the map access
+  std::shared_ptr<SessionInfo> findSession(SessionHandle session_id);
+
+  // Stacked path of runBatch; returns no outputs if the requests cannot be stacked
+  std::vector<std::vector<Ort::Value>> runStacked(SessionHandle session_id, SessionInfo &session_info,
+                                                  const std::vector<std::vector<const OrtValue *>> &input_values,
+                                                  const std::vector<std::vector<std::string>> &input_names,
+                                                  Ort::RunOptions *run_options);
+
+  // Session info by handle; shared so that in-flight runs keep a closed session alive
+  HandleTable<std::shared_ptr<SessionInfo>> sessions_;
+
+  // Get the environment, creating it on first use, whether its thread pools are shared and, if shared_arena is
+  // not null, whether it has a shared arena
+  Ort::Env &acquireEnv(bool *global_thread_pools, bool *shared_arena = nullptr);
+
+  // Get the container of the weights prepacked by sessions of a model file, creating it if no session of the model
+  // is open; null for an empty identity
+  std::shared_ptr<Ort::PrepackedWeightsContainer> acquirePrepackedWeights(const std::string &identity);
+
+  // Store a new session of a loaded model
+  SessionHandle addSession(const CachedModel &model);
+
+  // Loaded models by model file identity and options, least recently used evicted first
+  LruCache<CachedModel> session_cache_;
+
+  // Mutex protecting sessions_ and session_cache_ (not held while a session runs or a model loads)
+  TracedMutex mutex_{"SessionManager lock wait"};
+
+  // ONNX Runtime environment, created by the first session or configureThreadPools and guarded by mutex_
+  std::unique_ptr<Ort::Env> env_;
+
+  // Options of the shared thread pools of env_, if it has any
+  std::optional<ThreadPoolOptions> thread_pools_;
+
+  // Options of the arena registered with env_, if there is one
+  std::optional<ArenaOptions> shared_arena_;
+
+  // Prepacked weights shared by the sessions of each model file, by model identity; guarded by mutex_
+  std::map<std::string, std::weak_ptr<Ort::PrepackedWeightsContainer>> prepacked_weights_;
+
+  // Get the identity session copying tensors of an element type from the memory of an allocator, creating it on
+  // first use
+  std::shared_ptr<Ort::Session> acquireCopySession(ONNXTensorElementDataType element_type,
+                                                   const std::string &allocator_name, int device_id);
+
+  // Identity sessions of copyToHost by element type, allocator name and device id; guarded by mutex_
+  std::map<std::tuple<int, std::string, int>, std::shared_ptr<Ort::Session>> copy_sessions_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_SESSION_MANAGER_H_
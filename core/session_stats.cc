@@ -0,0 +1,121 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "session_stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace flutter_onnxruntime {
+
+void LatencyHistogram::record(uint64_t micros) {
+  buckets_[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+  uint64_t total = 0;
+  for (const auto &bucket : buckets_) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+  // Work on a copy so that concurrent records cannot move the rank past the last bucket
+  std::array<uint64_t, kNumBuckets> counts;
+  uint64_t total = 0;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  q = std::min(std::max(q, 0.0), 1.0);
+  uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return bucketUpperBound(i);
+    }
+  }
+  return bucketUpperBound(kNumBuckets - 1);
+}
+
+void LatencyHistogram::reset() {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t micros) {
+  if (micros < kSubBuckets) {
+    return static_cast<size_t>(micros);
+  }
+  micros = std::min(micros, (uint64_t(1) << (kMaxExponent + 1)) - 1);
+
+  int exponent = 63;
+  while ((micros >> exponent) == 0) {
+    exponent--;
+  }
+  // The leading one and the kSubBucketBits bits below it
+  uint64_t sub_bucket = micros >> (exponent - kSubBucketBits);
+  return kSubBuckets + static_cast<size_t>(exponent - kSubBucketBits) * kSubBuckets +
+         static_cast<size_t>(sub_bucket - kSubBuckets);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  size_t offset = index - kSubBuckets;
+  int shift = static_cast<int>(offset / kSubBuckets);
+  uint64_t sub_bucket = kSubBuckets + offset % kSubBuckets;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+void SessionStats::recordRun(uint64_t run_nanos, uint64_t bytes_in, uint64_t bytes_out) {
+  runs_.fetch_add(1, std::memory_order_relaxed);
+  bytes_in_.fetch_add(bytes_in, std::memory_order_relaxed);
+  bytes_out_.fetch_add(bytes_out, std::memory_order_relaxed);
+  run_nanos_.fetch_add(run_nanos, std::memory_order_relaxed);
+  run_latency_.record(run_nanos / 1000);
+}
+
+void SessionStats::recordCall(uint64_t input_nanos, uint64_t output_nanos) {
+  calls_.fetch_add(1, std::memory_order_relaxed);
+  input_nanos_.fetch_add(input_nanos, std::memory_order_relaxed);
+  output_nanos_.fetch_add(output_nanos, std::memory_order_relaxed);
+}
+
+SessionStatsSnapshot SessionStats::snapshot() const {
+  SessionStatsSnapshot stats;
+  stats.runs = runs_.load(std::memory_order_relaxed);
+  stats.bytes_in = bytes_in_.load(std::memory_order_relaxed);
+  stats.bytes_out = bytes_out_.load(std::memory_order_relaxed);
+  stats.run_nanos = run_nanos_.load(std::memory_order_relaxed);
+  stats.calls = calls_.load(std::memory_order_relaxed);
+  stats.input_nanos = input_nanos_.load(std::memory_order_relaxed);
+  stats.output_nanos = output_nanos_.load(std::memory_order_relaxed);
+  stats.p50_micros = run_latency_.percentile(0.5);
+  stats.p90_micros = run_latency_.percentile(0.9);
+  stats.p99_micros = run_latency_.percentile(0.99);
+  return stats;
+}
+
+void SessionStats::reset() {
+  runs_.store(0, std::memory_order_relaxed);
+  bytes_in_.store(0, std::memory_order_relaxed);
+  bytes_out_.store(0, std::memory_order_relaxed);
+  run_nanos_.store(0, std::memory_order_relaxed);
+  calls_.store(0, std::memory_order_relaxed);
+  input_nanos_.store(0, std::memory_order_relaxed);
+  output_nanos_.store(0, std::memory_order_relaxed);
+  run_latency_.reset();
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,99 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_SESSION_STATS_H_
+#define FLUTTER_ONNXRUNTIME_SESSION_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace flutter_onnxruntime {
+
+// Nanoseconds on a steady clock, for measuring how long something took
+inline uint64_t steadyNanos() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+// Lock-free histogram of durations in microseconds, with log-linear buckets in the style of HDR histograms.
+// Values below 16 have a bucket each; larger values share a bucket with those of the same power of two and
+// the same 4 bits below the leading one, so percentiles are within about 6% of the recorded values.
+class LatencyHistogram {
+public:
+  // Record a duration; safe to call from any thread
+  void record(uint64_t micros);
+
+  // Number of recorded durations
+  uint64_t count() const;
+
+  // Upper bound of the bucket holding the duration at quantile q in [0, 1]; 0 if nothing was recorded
+  uint64_t percentile(double q) const;
+
+  // Forget every recorded duration
+  void reset();
+
+private:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+  // Durations are clamped to 2^(kMaxExponent + 1) - 1 microseconds (about 25 days)
+  static constexpr int kMaxExponent = 40;
+  static constexpr size_t kNumBuckets = kSubBuckets + (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+  static size_t bucketIndex(uint64_t micros);
+  static uint64_t bucketUpperBound(size_t index);
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+};
+
+// Counters read from SessionStats at one point in time
+struct SessionStatsSnapshot {
+  uint64_t runs = 0;
+  uint64_t bytes_in = 0;
+  uint64_t bytes_out = 0;
+  // Total time in Session::Run, in nanoseconds
+  uint64_t run_nanos = 0;
+  // Calls that reported their input and output handling, and the total time of each in nanoseconds
+  uint64_t calls = 0;
+  uint64_t input_nanos = 0;
+  uint64_t output_nanos = 0;
+  // Latency percentiles of Session::Run, in microseconds
+  uint64_t p50_micros = 0;
+  uint64_t p90_micros = 0;
+  uint64_t p99_micros = 0;
+};
+
+// Counters of the runs of one session, updated without locks from any thread
+class SessionStats {
+public:
+  // Record one Session::Run, with the tensor bytes it read and wrote
+  void recordRun(uint64_t run_nanos, uint64_t bytes_in, uint64_t bytes_out);
+
+  // Record the time a call spent borrowing its inputs and storing its outputs around its runs
+  void recordCall(uint64_t input_nanos, uint64_t output_nanos);
+
+  SessionStatsSnapshot snapshot() const;
+
+  // Zero every counter; records made at the same time may be partly kept
+  void reset();
+
+private:
+  std::atomic<uint64_t> runs_{0};
+  std::atomic<uint64_t> bytes_in_{0};
+  std::atomic<uint64_t> bytes_out_{0};
+  std::atomic<uint64_t> run_nanos_{0};
+  std::atomic<uint64_t> calls_{0};
+  std::atomic<uint64_t> input_nanos_{0};
+  std::atomic<uint64_t> output_nanos_{0};
+  LatencyHistogram run_latency_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_SESSION_STATS_H_
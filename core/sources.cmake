@@ -0,0 +1,21 @@
+# Sources of the platform-neutral core that the Linux and Windows plugins build into their libraries. Include this
+# file after setting CORE_DIR to this directory.
+set(CORE_SOURCES
+    "${CORE_DIR}/buffer_pool.cc"
+    "${CORE_DIR}/convert_kernels.cc"
+    "${CORE_DIR}/frame_stream.cc"
+    "${CORE_DIR}/generation.cc"
+    "${CORE_DIR}/identity_model.cc"
+    "${CORE_DIR}/image_preprocess.cc"
+    "${CORE_DIR}/inference_executor.cc"
+    "${CORE_DIR}/native_api.cc"
+    "${CORE_DIR}/pipeline.cc"
+    "${CORE_DIR}/pipeline_ops.cc"
+    "${CORE_DIR}/profile_summary.cc"
+    "${CORE_DIR}/quantization.cc"
+    "${CORE_DIR}/run_control.cc"
+    "${CORE_DIR}/session_manager.cc"
+    "${CORE_DIR}/session_stats.cc"
+    "${CORE_DIR}/tensor_manager.cc"
+    "${CORE_DIR}/token_sampler.cc"
+    "${CORE_DIR}/trace_recorder.cc")
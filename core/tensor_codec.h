@@ -0,0 +1,97 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_TENSOR_CODEC_H_
+#define FLUTTER_ONNXRUNTIME_TENSOR_CODEC_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <onnxruntime_cxx_api.h>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "convert_kernels.h"
+#include "element_types.h"
+
+namespace flutter_onnxruntime {
+
+// The tensor data of the method channel is encoded by a codec of the embedder, so that the core does not depend on
+// FlValue or flutter::EncodableValue. A codec is a struct with
+//   using Value = ...;                 // e.g. FlValue * or flutter::EncodableValue
+//   static Value null();
+//   static Value list(const T *data, size_t count);  // for float, double, int32_t, int64_t and uint8_t
+//   static Value list(const std::vector<bool> &data);
+//   static Value list(const std::vector<std::string> &data);
+//   static Value tensor(const std::vector<int64_t> &shape, const std::string &data_type, Value data);
+// where tensor builds the {shape, dataType, data} map Dart reads and takes ownership of data.
+
+namespace detail {
+
+// Encode the elements of one type: strings and bools as lists of their own, float16 and bfloat16 widened to
+// float32 by the conversion kernels, and integer types without a typed list on the method channel widened to
+// int32 or int64
+template <typename Codec, ONNXTensorElementDataType T>
+typename Codec::Value encodeAs(const Ort::Value &tensor, size_t count) {
+  using Traits = ElementTraits<T>;
+  using Type = typename Traits::type;
+  using Wire = typename Traits::wire;
+  if constexpr (T == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
+    std::vector<std::string> data;
+    data.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      data.push_back(tensor.GetStringTensorElement(i));
+    }
+    return Codec::list(data);
+  } else if constexpr (std::is_void_v<Type>) {
+    throw std::runtime_error(std::string("Unsupported tensor type: ") + Traits::kName);
+  } else if constexpr (std::is_same_v<Type, bool>) {
+    const bool *data = tensor.GetTensorData<bool>();
+    return Codec::list(std::vector<bool>(data, data + count));
+  } else if constexpr (std::is_same_v<Type, Wire>) {
+    return Codec::list(tensor.GetTensorData<Type>(), count);
+  } else if constexpr (std::is_same_v<Wire, float>) {
+    std::vector<float> widened(count);
+    convertElements(Traits::kConvertType, tensor.GetTensorRawData(), ConvertType::kFloat32, widened.data(), count);
+    return Codec::list(widened.data(), count);
+  } else {
+    // A plain cast, so uint64 values above INT64_MAX wrap around instead of saturating
+    const Type *data = tensor.GetTensorData<Type>();
+    std::vector<Wire> widened(data, data + count);
+    return Codec::list(widened.data(), count);
+  }
+}
+
+template <typename Codec> using EncodeKernel = typename Codec::Value (*)(const Ort::Value &tensor, size_t count);
+
+template <typename Codec, size_t... Types>
+constexpr std::array<EncodeKernel<Codec>, sizeof...(Types)> encodeKernels(std::index_sequence<Types...>) {
+  return {{encodeAs<Codec, static_cast<ONNXTensorElementDataType>(Types)>...}};
+}
+
+template <typename Codec>
+typename Codec::Value encodeElements(const Ort::Value &tensor, ONNXTensorElementDataType element_type, size_t count) {
+  static constexpr std::array<EncodeKernel<Codec>, kElementTypeCount> kKernels =
+      encodeKernels<Codec>(std::make_index_sequence<kElementTypeCount>{});
+  return kKernels[elementTypeIndex(element_type)](tensor, count);
+}
+
+} // namespace detail
+
+// Encode the shape, type and data of a host tensor through a codec
+template <typename Codec> typename Codec::Value encodeTensor(const Ort::Value &tensor) {
+  Ort::TensorTypeAndShapeInfo tensor_info = tensor.GetTensorTypeAndShapeInfo();
+  ONNXTensorElementDataType element_type = tensor_info.GetElementType();
+  typename Codec::Value data = detail::encodeElements<Codec>(tensor, element_type, tensor_info.GetElementCount());
+  return Codec::tensor(tensor_info.GetShape(), elementTypeInfo(element_type).name, std::move(data));
+}
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_TENSOR_CODEC_H_
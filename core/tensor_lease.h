@@ -0,0 +1,60 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_TENSOR_LEASE_H_
+#define FLUTTER_ONNXRUNTIME_TENSOR_LEASE_H_
+
+#include <onnxruntime_cxx_api.h>
+
+#include "handle_table.h"
+
+namespace flutter_onnxruntime {
+
+// Forward declare TensorManager
+class TensorManager;
+
+// Handle of a tensor stored in a TensorManager
+using TensorHandle = Handle;
+
+// Borrow of a stored tensor that can be handed straight to Session::Run (as an input or a bound output)
+// without copying.
+// Releasing a leased tensor only invalidates its handle; the Ort::Value and its backing buffer are freed once
+// the last lease is gone. Leases must not outlive the TensorManager that issued them.
+class TensorLease {
+public:
+  TensorLease() = default;
+  ~TensorLease();
+
+  TensorLease(TensorLease &&other) noexcept;
+  TensorLease &operator=(TensorLease &&other) noexcept;
+
+  // Disallow copy and assign
+  TensorLease(const TensorLease &) = delete;
+  TensorLease &operator=(const TensorLease &) = delete;
+
+  explicit operator bool() const { return value_ != nullptr; }
+
+  // Get the borrowed OrtValue
+  const OrtValue *get() const { return value_ ? static_cast<const OrtValue *>(*value_) : nullptr; }
+
+  // Get the handle of the borrowed tensor
+  TensorHandle tensorId() const { return tensor_id_; }
+
+private:
+  friend class TensorManager;
+  TensorLease(TensorManager *manager, TensorHandle tensor_id, Ort::Value *value);
+
+  // Give the lease back to the manager (no-op for an empty lease)
+  void reset();
+
+  TensorManager *manager_ = nullptr;
+  TensorHandle tensor_id_ = kInvalidHandle;
+  Ort::Value *value_ = nullptr;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_TENSOR_LEASE_H_
@@ -0,0 +1,846 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "tensor_manager.h"
+#include "convert_kernels.h"
+#include "element_types.h"
+#include "pipeline_ops.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <unordered_set>
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// Element type of the tensors createTensor makes from a std::vector<T>
+template <typename T> constexpr ONNXTensorElementDataType kElementType = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+template <> constexpr ONNXTensorElementDataType kElementType<float> = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+template <> constexpr ONNXTensorElementDataType kElementType<int32_t> = ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32;
+template <> constexpr ONNXTensorElementDataType kElementType<int64_t> = ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64;
+template <> constexpr ONNXTensorElementDataType kElementType<uint8_t> = ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+template <> constexpr ONNXTensorElementDataType kElementType<bool> = ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL;
+
+// A tensor over the memory of another one, which it keeps alive. Field order matters as in ClonedTensor.
+struct TensorView {
+  std::shared_ptr<Ort::Value> source;
+  Ort::Value value{nullptr};
+};
+
+size_t elementCount(const std::vector<int64_t> &shape) {
+  size_t count = 1;
+  for (int64_t dim : shape) {
+    count *= dim > 0 ? static_cast<size_t>(dim) : 0;
+  }
+  return count;
+}
+
+// Resolve an axis of a tensor of rank axes, counting negative values from the end
+size_t resolveAxis(int64_t axis, size_t rank) {
+  int64_t resolved = axis < 0 ? axis + static_cast<int64_t>(rank) : axis;
+  if (resolved < 0 || resolved >= static_cast<int64_t>(rank)) {
+    throw std::runtime_error("Axis " + std::to_string(axis) + " is out of range for a tensor of rank " +
+                             std::to_string(rank));
+  }
+  return static_cast<size_t>(resolved);
+}
+
+} // namespace
+
+TensorManager::TensorManager() : memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {}
+
+TensorManager::~TensorManager() {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  tensors_.clear();
+  lease_counts_.clear();
+  retired_tensors_.clear();
+}
+
+TensorHandle TensorManager::insertTensorLocked(Ort::Value &&value, PooledBuffer &&buffer,
+                                               ONNXTensorElementDataType element_type,
+                                               const std::vector<int64_t> &shape, bool on_device,
+                                               bool enforce_limit) {
+  uint64_t byte_size = 0;
+  if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
+    byte_size = value.GetStringTensorDataLength();
+  } else {
+    byte_size = elementTypeInfo(element_type).size;
+    for (int64_t dim : shape) {
+      byte_size *= dim > 0 ? static_cast<uint64_t>(dim) : 0;
+    }
+  }
+  if (enforce_limit && !on_device && hard_limit_bytes_ > 0 && host_bytes_ + byte_size > hard_limit_bytes_) {
+    throw std::runtime_error("A tensor of " + std::to_string(byte_size) + " bytes would exceed the memory limit of " +
+                             std::to_string(hard_limit_bytes_) + " bytes, " + std::to_string(host_bytes_) +
+                             " bytes are held by live tensors");
+  }
+  if (!on_device) {
+    host_bytes_ += byte_size;
+  }
+
+  auto owner = std::make_shared<ClonedTensor>();
+  owner->buffer = std::move(buffer);
+  owner->value = std::move(value);
+
+  TensorEntry entry;
+  entry.value = std::shared_ptr<Ort::Value>(owner, &owner->value);
+  entry.element_type = element_type;
+  entry.shape = shape;
+  entry.on_device = on_device;
+  entry.storage = std::make_shared<TensorStorage>();
+  entry.storage->byte_size = byte_size;
+  entry.storage->entry_count = 1;
+  return tensors_.insert(std::move(entry));
+}
+
+TensorHandle TensorManager::insertViewLocked(const TensorEntry &source, size_t byte_offset,
+                                             const std::vector<int64_t> &shape) {
+  const ElementTypeInfo &type_info = elementTypeInfo(source.element_type);
+  if (!type_info.convertible) {
+    throw std::runtime_error(std::string("Cannot make a view of a tensor of type ") + type_info.name);
+  }
+  if (source.on_device) {
+    throw std::runtime_error("Cannot make a view of a tensor in device memory");
+  }
+
+  auto view = std::make_shared<TensorView>();
+  view->source = source.value;
+  uint8_t *data = static_cast<uint8_t *>(source.value->GetTensorMutableRawData());
+  view->value = Ort::Value::CreateTensor(memory_info_, data + byte_offset, elementCount(shape) * type_info.size,
+                                         shape.data(), shape.size(), source.element_type);
+
+  // The view adds no bytes of its own; the shared storage stays counted until the source and every view are released
+  TensorEntry entry;
+  entry.value = std::shared_ptr<Ort::Value>(view, &view->value);
+  entry.element_type = source.element_type;
+  entry.shape = shape;
+  entry.storage = source.storage;
+  entry.storage->entry_count++;
+  return tensors_.insert(std::move(entry));
+}
+
+Ort::Value *TensorManager::hostValueLocked(TensorEntry &entry) {
+  if (!entry.on_device) {
+    return entry.value.get();
+  }
+  if (!entry.host_value) {
+    if (!host_copier_) {
+      throw std::runtime_error("Tensor is in device memory and cannot be copied to the host");
+    }
+    entry.host_value = std::make_unique<Ort::Value>(host_copier_(*entry.value));
+  }
+  return entry.host_value.get();
+}
+
+template <typename T>
+TensorHandle TensorManager::createTensor(const std::vector<T> &data, const std::vector<int64_t> &shape) {
+  static_assert(kElementType<T> != ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED, "No tensor type for these elements");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  // Store data in a managed buffer so it is freed when the tensor is released
+  size_t byte_size = data.size() * sizeof(T);
+  PooledBuffer buffer = buffer_pool_.acquire(byte_size);
+  if constexpr (std::is_same_v<T, bool>) {
+    // std::vector<bool> is specialized and can't be memcpy'd, so copy element by element
+    bool *tensor_data = reinterpret_cast<bool *>(buffer.data());
+    for (size_t i = 0; i < data.size(); i++) {
+      tensor_data[i] = data[i];
+    }
+  } else if (byte_size > 0) {
+    std::memcpy(buffer.data(), data.data(), byte_size);
+  }
+  // Create a new tensor with the buffer-backed data
+  auto tensor =
+      Ort::Value::CreateTensor(memory_info_, buffer.data(), byte_size, shape.data(), shape.size(), kElementType<T>);
+  // Store the tensor, its type, shape, and backing buffer
+  return insertTensorLocked(std::move(tensor), std::move(buffer), kElementType<T>, shape);
+}
+
+template TensorHandle TensorManager::createTensor(const std::vector<float> &, const std::vector<int64_t> &);
+template TensorHandle TensorManager::createTensor(const std::vector<int32_t> &, const std::vector<int64_t> &);
+template TensorHandle TensorManager::createTensor(const std::vector<int64_t> &, const std::vector<int64_t> &);
+template TensorHandle TensorManager::createTensor(const std::vector<uint8_t> &, const std::vector<int64_t> &);
+template TensorHandle TensorManager::createTensor(const std::vector<bool> &, const std::vector<int64_t> &);
+
+TensorHandle TensorManager::createEmptyTensor(ONNXTensorElementDataType element_type,
+                                              const std::vector<int64_t> &shape) {
+
+  const ElementTypeInfo &type_info = elementTypeInfo(element_type);
+  if (!type_info.convertible) {
+    throw std::runtime_error(std::string("Cannot preallocate a tensor of type ") + type_info.name);
+  }
+
+  size_t element_count = 1;
+  for (int64_t dim : shape) {
+    if (dim < 0) {
+      throw std::runtime_error("Cannot preallocate a tensor with a dynamic shape");
+    }
+    element_count *= static_cast<size_t>(dim);
+  }
+
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  // Store data in a managed buffer so it is freed when the tensor is released
+  PooledBuffer buffer = buffer_pool_.acquire(element_count * type_info.size);
+  if (!buffer.empty()) {
+    // Pooled blocks may hold data from a previous tensor
+    std::memset(buffer.data(), 0, buffer.size());
+  }
+  auto tensor = Ort::Value::CreateTensor(memory_info_, buffer.data(), buffer.size(), shape.data(), shape.size(),
+                                         element_type);
+  // Store the tensor, its type, shape, and backing buffer
+  return insertTensorLocked(std::move(tensor), std::move(buffer), element_type, shape);
+}
+
+TensorHandle TensorManager::createTensorFromBytes(ONNXTensorElementDataType element_type, const void *data,
+                                                  size_t byte_size, const std::vector<int64_t> &shape) {
+  TraceScope trace("TensorManager::createTensorFromBytes");
+  const ElementTypeInfo &type_info = elementTypeInfo(element_type);
+  if (!type_info.convertible) {
+    throw std::runtime_error(std::string("Cannot create a tensor of type ") + type_info.name + " from raw bytes");
+  }
+  size_t element_size = type_info.size;
+
+  size_t element_count = 1;
+  for (int64_t dim : shape) {
+    if (dim < 0) {
+      throw std::runtime_error("Shape contains a negative dimension");
+    }
+    element_count *= static_cast<size_t>(dim);
+  }
+  if (element_count * element_size != byte_size) {
+    throw std::runtime_error("Data has " + std::to_string(byte_size) + " bytes, but the shape requires " +
+                             std::to_string(element_count * element_size) + " bytes of " + type_info.name);
+  }
+
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  // Copy the data once, straight into a managed buffer that is freed when the tensor is released
+  PooledBuffer buffer = buffer_pool_.acquire(byte_size);
+  if (byte_size > 0) {
+    std::memcpy(buffer.data(), data, byte_size);
+  }
+  auto tensor =
+      Ort::Value::CreateTensor(memory_info_, buffer.data(), byte_size, shape.data(), shape.size(), element_type);
+  // Store the tensor, its type, shape, and backing buffer
+  return insertTensorLocked(std::move(tensor), std::move(buffer), element_type, shape);
+}
+
+TensorHandle TensorManager::createImageTensor(const ImageTensorOptions &options, const uint8_t *data,
+                                              size_t byte_size) {
+  if (options.width <= 0 || options.height <= 0 || options.target_width < 0 || options.target_height < 0) {
+    throw std::runtime_error("Image and target sizes must be positive");
+  }
+  for (int c = 0; c < 3; c++) {
+    if (options.std[c] == 0.0f) {
+      throw std::runtime_error("Standard deviations must not be zero");
+    }
+  }
+  size_t expected_size = imageByteSize(options.format, options.width, options.height);
+  if (byte_size != expected_size) {
+    throw std::runtime_error("Image has " + std::to_string(byte_size) + " bytes, but a " +
+                             std::to_string(options.width) + "x" + std::to_string(options.height) + " image requires " +
+                             std::to_string(expected_size) + " bytes");
+  }
+
+  int64_t out_width = options.target_width > 0 ? options.target_width : options.width;
+  int64_t out_height = options.target_height > 0 ? options.target_height : options.height;
+  std::vector<int64_t> shape = options.channels_first ? std::vector<int64_t>{1, 3, out_height, out_width}
+                                                      : std::vector<int64_t>{1, out_height, out_width, 3};
+  ONNXTensorElementDataType element_type =
+      options.half_precision ? ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16 : ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+  size_t element_size = options.half_precision ? sizeof(uint16_t) : sizeof(float);
+  size_t tensor_size = static_cast<size_t>(out_width * out_height * 3) * element_size;
+
+  // Write the tensor straight into a pooled buffer; only the insertion needs the lock
+  PooledBuffer buffer = buffer_pool_.acquire(tensor_size);
+  preprocessImage(options, data, buffer.data());
+
+  std::lock_guard<TracedMutex> lock(mutex_);
+  auto tensor =
+      Ort::Value::CreateTensor(memory_info_, buffer.data(), tensor_size, shape.data(), shape.size(), element_type);
+  // Store the tensor, its type, shape, and backing buffer
+  return insertTensorLocked(std::move(tensor), std::move(buffer), element_type, shape);
+}
+
+TensorHandle TensorManager::createStringTensor(const std::vector<std::string> &data,
+                                              const std::vector<int64_t> &shape) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  try {
+    // Create a C-style array of const char* for ONNX Runtime
+    const char **tensor_data = new const char *[data.size()];
+    for (size_t i = 0; i < data.size(); i++) {
+      tensor_data[i] = data[i].c_str();
+    }
+
+    OrtAllocator *allocator = nullptr;
+    // Follow the test at:
+    // https://github.com/microsoft/onnxruntime/blob/4adef01e741b2327188279dcd63bc55c5d2307e9/onnxruntime/test/shared_lib/test_inference.cc#L4278
+    // create allocator with default options
+    Ort::ThrowOnError(Ort::GetApi().GetAllocatorWithDefaultOptions(&allocator));
+    auto tensor = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+
+    // Fill the tensor with string data
+    Ort::ThrowOnError(Ort::GetApi().FillStringTensor(tensor, tensor_data, data.size()));
+
+    delete[] tensor_data;
+
+    // String tensors use ORT's allocator, no external buffer needed
+    return insertTensorLocked(std::move(tensor), PooledBuffer(), ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING, shape);
+  } catch (const Ort::Exception &) {
+    throw;
+  }
+}
+
+bool TensorManager::releaseTensor(TensorHandle tensor_id) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  return releaseTensorLocked(tensor_id);
+}
+
+size_t TensorManager::releaseTensors(const std::vector<TensorHandle> &tensor_ids) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  size_t released = 0;
+  for (TensorHandle tensor_id : tensor_ids) {
+    if (releaseTensorLocked(tensor_id)) {
+      released++;
+    }
+  }
+  return released;
+}
+
+bool TensorManager::releaseTensorLocked(TensorHandle tensor_id) {
+  std::optional<TensorEntry> entry = tensors_.take(tensor_id);
+  if (!entry) {
+    return false;
+  }
+  if (--entry->storage->entry_count == 0 && !entry->on_device) {
+    host_bytes_ -= entry->storage->byte_size;
+  }
+
+  // A run still borrows this tensor, so keep its value and buffer alive until the lease is returned.
+  // Moving the entry keeps the Ort::Value and the pooled block at their addresses, so the lease stays valid.
+  // The handle itself is invalid from now on, even if its slot is reused.
+  if (lease_counts_.find(tensor_id) != lease_counts_.end()) {
+    retired_tensors_[tensor_id] = std::move(*entry);
+  }
+  return true;
+}
+
+Ort::Value *TensorManager::getTensor(TensorHandle tensor_id) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *entry = tensors_.find(tensor_id);
+  if (entry == nullptr) {
+    return nullptr;
+  }
+
+  return entry->value.get();
+}
+
+TensorHandle TensorManager::storeTensor(Ort::Value &&tensor) {
+  TraceScope trace("TensorManager::storeTensor");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  try {
+    // Get tensor info to store type and shape
+    Ort::TensorTypeAndShapeInfo tensor_info = tensor.GetTensorTypeAndShapeInfo();
+    ONNXTensorElementDataType element_type = tensor_info.GetElementType();
+    std::vector<int64_t> shape = tensor_info.GetShape();
+
+    bool on_device = tensor.GetTensorMemoryInfo().GetDeviceType() != OrtMemoryInfoDeviceType_CPU;
+
+    // Store the tensor; its memory is owned by ONNX Runtime, so there is no backing buffer
+    return insertTensorLocked(std::move(tensor), PooledBuffer(), element_type, shape, on_device, false);
+  } catch (const std::exception &) {
+    // Not a tensor, nothing to store
+    return kInvalidHandle;
+  }
+}
+
+std::string TensorManager::getTensorType(TensorHandle tensor_id) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  return elementTypeInfo(tensors_.at(tensor_id).element_type).name;
+}
+
+std::vector<int64_t> TensorManager::getTensorShape(TensorHandle tensor_id) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  return tensors_.at(tensor_id).shape;
+}
+
+TensorHandle TensorManager::convertTensor(TensorHandle tensor_id, ONNXTensorElementDataType target_type) {
+
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  // Check if the tensor exists
+  TensorEntry *tensor_entry = tensors_.find(tensor_id);
+
+  if (tensor_entry == nullptr) {
+    throw std::runtime_error("Tensor not found");
+  }
+  ONNXTensorElementDataType source_type = tensor_entry->element_type;
+
+  // If the target type is the same as the source type, just clone the tensor
+  if (source_type == target_type) {
+
+    // Clone the tensor (returns ClonedTensor with managed buffer)
+    auto cloned = cloneTensorLocked(tensor_id);
+    // Copy the shape before inserting, the insertion may grow the table
+    std::vector<int64_t> shape = tensor_entry->shape;
+    return insertTensorLocked(std::move(cloned.value), std::move(cloned.buffer), source_type, shape);
+  }
+
+  const ElementTypeInfo &source_info = elementTypeInfo(source_type);
+  const ElementTypeInfo &target_info = elementTypeInfo(target_type);
+  if (!source_info.convertible || !target_info.convertible) {
+    throw std::runtime_error(std::string("Unsupported type conversion: ") + source_info.name + " to " +
+                             target_info.name);
+  }
+
+  // Copy the shape before inserting, the insertion may grow the table
+  std::vector<int64_t> shape = tensor_entry->shape;
+  size_t elem_count = tensor_entry->value->GetTensorTypeAndShapeInfo().GetElementCount();
+  size_t byte_size = elem_count * target_info.size;
+
+  // Convert with the vectorized kernels straight into a pooled buffer
+  PooledBuffer buffer = buffer_pool_.acquire(byte_size);
+  convertElements(source_info.convert_type, hostValueLocked(*tensor_entry)->GetTensorRawData(),
+                  target_info.convert_type, buffer.data(), elem_count);
+  auto new_tensor =
+      Ort::Value::CreateTensor(memory_info_, buffer.data(), byte_size, shape.data(), shape.size(), target_type);
+  return insertTensorLocked(std::move(new_tensor), std::move(buffer), target_type, shape);
+}
+
+TensorHandle TensorManager::quantizeTensor(TensorHandle tensor_id, const QuantizationParams &params) {
+  TraceScope trace("TensorManager::quantizeTensor");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *tensor_entry = tensors_.find(tensor_id);
+  if (tensor_entry == nullptr) {
+    throw std::runtime_error("Tensor not found");
+  }
+  const ElementTypeInfo &source_info = elementTypeInfo(tensor_entry->element_type);
+  if (!source_info.convertible) {
+    throw std::runtime_error(std::string("Cannot quantize a tensor of type ") + source_info.name);
+  }
+
+  // Copy the shape before inserting, the insertion may grow the table
+  std::vector<int64_t> shape = tensor_entry->shape;
+  size_t elem_count = tensor_entry->value->GetTensorTypeAndShapeInfo().GetElementCount();
+  const void *data = hostValueLocked(*tensor_entry)->GetTensorRawData();
+  std::vector<float> widened;
+  if (tensor_entry->element_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+    widened.resize(elem_count);
+    convertElements(source_info.convert_type, data, ConvertType::kFloat32, widened.data(), elem_count);
+    data = widened.data();
+  }
+
+  PooledBuffer buffer = buffer_pool_.acquire(elem_count);
+  quantizeElements(static_cast<const float *>(data), shape, params, buffer.data());
+  auto new_tensor = Ort::Value::CreateTensor(memory_info_, buffer.data(), elem_count, shape.data(), shape.size(),
+                                             params.element_type);
+  return insertTensorLocked(std::move(new_tensor), std::move(buffer), params.element_type, shape);
+}
+
+TensorHandle TensorManager::dequantizeTensor(TensorHandle tensor_id, const QuantizationParams &params) {
+  TraceScope trace("TensorManager::dequantizeTensor");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *tensor_entry = tensors_.find(tensor_id);
+  if (tensor_entry == nullptr) {
+    throw std::runtime_error("Tensor not found");
+  }
+  ONNXTensorElementDataType source_type = tensor_entry->element_type;
+  if (source_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8 && source_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8) {
+    throw std::runtime_error(std::string("Cannot dequantize a tensor of type ") + elementTypeInfo(source_type).name);
+  }
+  QuantizationParams source_params = params;
+  source_params.element_type = source_type;
+
+  std::vector<int64_t> shape = tensor_entry->shape;
+  size_t elem_count = tensor_entry->value->GetTensorTypeAndShapeInfo().GetElementCount();
+  size_t byte_size = elem_count * sizeof(float);
+
+  PooledBuffer buffer = buffer_pool_.acquire(byte_size);
+  dequantizeElements(hostValueLocked(*tensor_entry)->GetTensorRawData(), shape, source_params,
+                     reinterpret_cast<float *>(buffer.data()));
+  auto new_tensor = Ort::Value::CreateTensor(memory_info_, buffer.data(), byte_size, shape.data(), shape.size(),
+                                             ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  return insertTensorLocked(std::move(new_tensor), std::move(buffer), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, shape);
+}
+
+TensorHandle TensorManager::reshapeTensor(TensorHandle tensor_id, const std::vector<int64_t> &shape) {
+  TraceScope trace("TensorManager::reshapeTensor");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *tensor_entry = tensors_.find(tensor_id);
+  if (tensor_entry == nullptr) {
+    throw std::runtime_error("Tensor not found");
+  }
+  std::vector<int64_t> resolved;
+  try {
+    resolved = resolveReshape(tensor_entry->shape, shape);
+  } catch (const std::invalid_argument &e) {
+    throw std::runtime_error(e.what());
+  }
+  return insertViewLocked(*tensor_entry, 0, resolved);
+}
+
+TensorHandle TensorManager::sliceTensor(TensorHandle tensor_id, int64_t axis, int64_t start, int64_t end) {
+  TraceScope trace("TensorManager::sliceTensor");
+  std::lock_guard<TracedMutex> lock(mutex_);
+  return sliceTensorLocked(tensor_id, axis, start, end, true);
+}
+
+TensorHandle TensorManager::selectTensor(TensorHandle tensor_id, int64_t axis, int64_t index) {
+  TraceScope trace("TensorManager::selectTensor");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *tensor_entry = tensors_.find(tensor_id);
+  if (tensor_entry == nullptr) {
+    throw std::runtime_error("Tensor not found");
+  }
+  int64_t dim = tensor_entry->shape[resolveAxis(axis, tensor_entry->shape.size())];
+  int64_t resolved = index < 0 ? index + dim : index;
+  if (resolved < 0 || resolved >= dim) {
+    throw std::runtime_error("Index " + std::to_string(index) + " is out of range for an axis of size " +
+                             std::to_string(dim));
+  }
+  return sliceTensorLocked(tensor_id, axis, resolved, resolved + 1, false);
+}
+
+TensorHandle TensorManager::sliceTensorLocked(TensorHandle tensor_id, int64_t axis, int64_t start, int64_t end,
+                                              bool keep_axis) {
+  TensorEntry *tensor_entry = tensors_.find(tensor_id);
+  if (tensor_entry == nullptr) {
+    throw std::runtime_error("Tensor not found");
+  }
+  const ElementTypeInfo &type_info = elementTypeInfo(tensor_entry->element_type);
+  if (!type_info.convertible) {
+    throw std::runtime_error(std::string("Cannot slice a tensor of type ") + type_info.name);
+  }
+
+  // Copy the shape before inserting, the insertion may grow the table
+  std::vector<int64_t> shape = tensor_entry->shape;
+  size_t resolved_axis = resolveAxis(axis, shape.size());
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> sizes;
+  resolveSlice(shape, {start}, {end}, {static_cast<int64_t>(resolved_axis)}, &offsets, &sizes);
+  std::vector<int64_t> result_shape = sizes;
+  if (!keep_axis) {
+    result_shape.erase(result_shape.begin() + static_cast<std::ptrdiff_t>(resolved_axis));
+  }
+
+  // With only axes of size 1 before the sliced one, the slice is one contiguous run of the source
+  bool contiguous = std::all_of(shape.begin(), shape.begin() + static_cast<std::ptrdiff_t>(resolved_axis),
+                                [](int64_t dim) { return dim == 1; });
+  if (contiguous && !tensor_entry->on_device) {
+    size_t inner = elementCount(std::vector<int64_t>(shape.begin() + resolved_axis + 1, shape.end()));
+    size_t byte_offset = static_cast<size_t>(offsets[resolved_axis]) * inner * type_info.size;
+    return insertViewLocked(*tensor_entry, byte_offset, result_shape);
+  }
+
+  size_t byte_size = elementCount(sizes) * type_info.size;
+  PooledBuffer buffer = buffer_pool_.acquire(byte_size);
+  if (byte_size > 0) {
+    sliceElements(hostValueLocked(*tensor_entry)->GetTensorRawData(), type_info.size, shape, offsets, sizes,
+                  buffer.data());
+  }
+  auto new_tensor = Ort::Value::CreateTensor(memory_info_, buffer.data(), byte_size, result_shape.data(),
+                                             result_shape.size(), tensor_entry->element_type);
+  return insertTensorLocked(std::move(new_tensor), std::move(buffer), tensor_entry->element_type, result_shape);
+}
+
+TensorHandle TensorManager::transposeTensor(TensorHandle tensor_id, const std::vector<int64_t> &perm) {
+  TraceScope trace("TensorManager::transposeTensor");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *tensor_entry = tensors_.find(tensor_id);
+  if (tensor_entry == nullptr) {
+    throw std::runtime_error("Tensor not found");
+  }
+  ONNXTensorElementDataType element_type = tensor_entry->element_type;
+  const ElementTypeInfo &type_info = elementTypeInfo(element_type);
+  if (!type_info.convertible) {
+    throw std::runtime_error(std::string("Cannot transpose a tensor of type ") + type_info.name);
+  }
+
+  std::vector<int64_t> shape = tensor_entry->shape;
+  std::vector<int64_t> resolved;
+  try {
+    resolved = resolvePermutation(shape.size(), perm);
+  } catch (const std::invalid_argument &e) {
+    throw std::runtime_error(e.what());
+  }
+  std::vector<int64_t> result_shape(shape.size());
+  for (size_t i = 0; i < shape.size(); i++) {
+    result_shape[i] = shape[resolved[i]];
+  }
+
+  size_t byte_size = elementCount(shape) * type_info.size;
+  PooledBuffer buffer = buffer_pool_.acquire(byte_size);
+  if (byte_size > 0) {
+    transposeElements(hostValueLocked(*tensor_entry)->GetTensorRawData(), type_info.size, shape, resolved,
+                      buffer.data());
+  }
+  auto new_tensor = Ort::Value::CreateTensor(memory_info_, buffer.data(), byte_size, result_shape.data(),
+                                             result_shape.size(), element_type);
+  return insertTensorLocked(std::move(new_tensor), std::move(buffer), element_type, result_shape);
+}
+
+TensorHandle TensorManager::concatTensors(const std::vector<TensorHandle> &tensor_ids, int64_t axis) {
+  TraceScope trace("TensorManager::concatTensors");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  if (tensor_ids.empty()) {
+    throw std::runtime_error("Concat needs at least one tensor");
+  }
+  std::vector<const void *> srcs;
+  std::vector<std::vector<int64_t>> shapes;
+  ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  for (TensorHandle tensor_id : tensor_ids) {
+    TensorEntry *tensor_entry = tensors_.find(tensor_id);
+    if (tensor_entry == nullptr) {
+      throw std::runtime_error("Tensor not found");
+    }
+    if (srcs.empty()) {
+      element_type = tensor_entry->element_type;
+    } else if (tensor_entry->element_type != element_type) {
+      throw std::runtime_error("Cannot concatenate tensors of different types");
+    }
+    srcs.push_back(hostValueLocked(*tensor_entry)->GetTensorRawData());
+    shapes.push_back(tensor_entry->shape);
+  }
+  const ElementTypeInfo &type_info = elementTypeInfo(element_type);
+  if (!type_info.convertible) {
+    throw std::runtime_error(std::string("Cannot concatenate tensors of type ") + type_info.name);
+  }
+
+  size_t resolved_axis = resolveAxis(axis, shapes[0].size());
+  std::vector<int64_t> result_shape = shapes[0];
+  result_shape[resolved_axis] = 0;
+  for (const std::vector<int64_t> &shape : shapes) {
+    bool matches = shape.size() == result_shape.size();
+    for (size_t d = 0; matches && d < shape.size(); d++) {
+      matches = d == resolved_axis || shape[d] == shapes[0][d];
+    }
+    if (!matches) {
+      throw std::runtime_error("Tensors to concatenate must match in every dimension but the axis");
+    }
+    result_shape[resolved_axis] += shape[resolved_axis];
+  }
+
+  size_t byte_size = elementCount(result_shape) * type_info.size;
+  PooledBuffer buffer = buffer_pool_.acquire(byte_size);
+  if (byte_size > 0) {
+    concatElements(srcs, shapes, type_info.size, resolved_axis, buffer.data());
+  }
+  auto new_tensor = Ort::Value::CreateTensor(memory_info_, buffer.data(), byte_size, result_shape.data(),
+                                             result_shape.size(), element_type);
+  return insertTensorLocked(std::move(new_tensor), std::move(buffer), element_type, result_shape);
+}
+
+ClonedTensor TensorManager::cloneTensor(TensorHandle tensor_id) {
+  TraceScope trace("TensorManager::cloneTensor");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  return cloneTensorLocked(tensor_id);
+}
+
+ClonedTensor TensorManager::cloneTensorLocked(TensorHandle tensor_id) {
+  // Find the tensor
+  TensorEntry *tensor_entry = tensors_.find(tensor_id);
+
+  if (tensor_entry == nullptr) {
+    throw std::runtime_error("Tensor not found: " + std::to_string(tensor_id));
+  }
+
+  Ort::Value *tensor_ptr = hostValueLocked(*tensor_entry);
+  ONNXTensorElementDataType element_type = tensor_entry->element_type;
+  const std::vector<int64_t> &shape = tensor_entry->shape;
+
+  // Get tensor info
+  Ort::TensorTypeAndShapeInfo tensor_info = tensor_ptr->GetTensorTypeAndShapeInfo();
+  size_t element_count = tensor_info.GetElementCount();
+
+  if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
+    // Extract strings from the tensor
+    std::vector<std::string> data_vec;
+    data_vec.reserve(element_count);
+    for (size_t i = 0; i < element_count; i++) {
+      std::string s = tensor_ptr->GetStringTensorElement(i);
+      data_vec.push_back(s);
+    }
+
+    // Create a C-style array of const char* for ONNX Runtime
+    const char **new_tensor_data = new const char *[data_vec.size()];
+    for (size_t i = 0; i < data_vec.size(); i++) {
+      new_tensor_data[i] = data_vec[i].c_str();
+    }
+    OrtAllocator *allocator = nullptr;
+    // Follow the test at:
+    // https://github.com/microsoft/onnxruntime/blob/4adef01e741b2327188279dcd63bc55c5d2307e9/onnxruntime/test/shared_lib/test_inference.cc#L4278
+    // create allocator with default options
+    Ort::ThrowOnError(Ort::GetApi().GetAllocatorWithDefaultOptions(&allocator));
+    auto new_tensor =
+        Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+    // Fill the tensor with string data
+    Ort::ThrowOnError(Ort::GetApi().FillStringTensor(new_tensor, new_tensor_data, data_vec.size()));
+    delete[] new_tensor_data;
+
+    // String tensors use ORT's allocator, no external buffer needed
+    ClonedTensor result;
+    result.value = std::move(new_tensor);
+    return result;
+  }
+
+  size_t element_size = elementTypeInfo(element_type).size;
+  if (element_size == 0) {
+    throw std::runtime_error(std::string("Unsupported tensor type: ") + elementTypeInfo(element_type).name);
+  }
+
+  // Any fixed-size tensor is copied as raw bytes into a managed buffer
+  size_t byte_size = element_count * element_size;
+  PooledBuffer buffer = buffer_pool_.acquire(byte_size);
+  if (byte_size > 0) {
+    std::memcpy(buffer.data(), tensor_ptr->GetTensorRawData(), byte_size);
+  }
+
+  ClonedTensor result;
+  result.value =
+      Ort::Value::CreateTensor(memory_info_, buffer.data(), byte_size, shape.data(), shape.size(), element_type);
+  result.buffer = std::move(buffer);
+  return result;
+}
+
+BufferPoolStats TensorManager::getBufferPoolStats() { return buffer_pool_.getStats(); }
+
+void TensorManager::setBufferPoolMaxRetainedBytes(size_t max_retained_bytes) {
+  buffer_pool_.setMaxRetainedBytes(max_retained_bytes);
+}
+
+TensorMemoryStats TensorManager::getMemoryStats() {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  TensorMemoryStats stats;
+  // Memory shared by a tensor and its views is counted once; views keep the element type of their source
+  std::unordered_set<const TensorStorage *> counted;
+  tensors_.forEach([&stats, &counted](TensorHandle, TensorEntry &entry) {
+    stats.tensor_count++;
+    if (!counted.insert(entry.storage.get()).second) {
+      return;
+    }
+    if (entry.on_device) {
+      stats.device_bytes += entry.storage->byte_size;
+    } else {
+      stats.host_bytes_by_type[elementTypeInfo(entry.element_type).name] += entry.storage->byte_size;
+    }
+  });
+  stats.host_bytes = host_bytes_;
+  stats.retired_count = retired_tensors_.size();
+  stats.hard_limit_bytes = hard_limit_bytes_;
+  return stats;
+}
+
+void TensorManager::setHardMemoryLimit(uint64_t hard_limit_bytes) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  hard_limit_bytes_ = hard_limit_bytes;
+}
+
+void TensorManager::setHostCopier(std::function<Ort::Value(const OrtValue *)> host_copier) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+  host_copier_ = std::move(host_copier);
+}
+
+TensorLease TensorManager::acquireTensor(TensorHandle tensor_id) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *entry = tensors_.find(tensor_id);
+  if (entry == nullptr) {
+    return TensorLease();
+  }
+
+  lease_counts_[tensor_id]++;
+  return TensorLease(this, tensor_id, entry->value.get());
+}
+
+TensorLease TensorManager::acquireHostTensor(TensorHandle tensor_id) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *entry = tensors_.find(tensor_id);
+  if (entry == nullptr) {
+    return TensorLease();
+  }
+
+  Ort::Value *host_value = hostValueLocked(*entry);
+  lease_counts_[tensor_id]++;
+  return TensorLease(this, tensor_id, host_value);
+}
+
+TensorLease TensorManager::acquireTensorData(TensorHandle tensor_id, void **data, size_t *byte_size) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *entry = tensors_.find(tensor_id);
+  if (entry == nullptr || !elementTypeInfo(entry->element_type).convertible) {
+    return TensorLease();
+  }
+
+  size_t element_count = 1;
+  for (int64_t dim : entry->shape) {
+    element_count *= static_cast<size_t>(dim);
+  }
+
+  *data = hostValueLocked(*entry)->GetTensorMutableRawData();
+  *byte_size = element_count * elementTypeInfo(entry->element_type).size;
+  lease_counts_[tensor_id]++;
+  return TensorLease(this, tensor_id, entry->value.get());
+}
+
+void TensorManager::returnLease(TensorHandle tensor_id) {
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  auto count_it = lease_counts_.find(tensor_id);
+  if (count_it == lease_counts_.end() || --count_it->second > 0) {
+    return;
+  }
+
+  lease_counts_.erase(count_it);
+  // Free the tensor now if it was released while leased
+  retired_tensors_.erase(tensor_id);
+}
+
+TensorLease::TensorLease(TensorManager *manager, TensorHandle tensor_id, Ort::Value *value)
+    : manager_(manager), tensor_id_(tensor_id), value_(value) {}
+
+TensorLease::~TensorLease() { reset(); }
+
+TensorLease::TensorLease(TensorLease &&other) noexcept
+    : manager_(other.manager_), tensor_id_(other.tensor_id_), value_(other.value_) {
+  other.manager_ = nullptr;
+  other.value_ = nullptr;
+}
+
+TensorLease &TensorLease::operator=(TensorLease &&other) noexcept {
+  if (this != &other) {
+    reset();
+    manager_ = other.manager_;
+    tensor_id_ = other.tensor_id_;
+    value_ = other.value_;
+    other.manager_ = nullptr;
+    other.value_ = nullptr;
+  }
+  return *this;
+}
+
+void TensorLease::reset() {
+  if (manager_ != nullptr) {
+    manager_->returnLease(tensor_id_);
+  }
+  manager_ = nullptr;
+  value_ = nullptr;
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,251 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_TENSOR_MANAGER_H_
+#define FLUTTER_ONNXRUNTIME_TENSOR_MANAGER_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer_pool.h"
+#include "handle_table.h"
+#include "image_preprocess.h"
+#include "quantization.h"
+#include "tensor_codec.h"
+#include "tensor_lease.h"
+#include "trace_recorder.h"
+
+namespace flutter_onnxruntime {
+
+// Holds a cloned Ort::Value together with its backing data buffer.
+// When this struct goes out of scope, both the tensor and its memory are freed.
+// Field order matters: buffer is declared first so that value (declared second)
+// is destroyed first, ensuring the Ort::Value is released before its backing memory.
+struct ClonedTensor {
+  PooledBuffer buffer;
+  Ort::Value value{nullptr};
+};
+
+// Live tensors of a TensorManager and the memory they hold
+struct TensorMemoryStats {
+  size_t tensor_count = 0;
+  // Bytes of tensor data in host memory, in total and by element type name; strings count their characters
+  uint64_t host_bytes = 0;
+  std::map<std::string, uint64_t> host_bytes_by_type;
+  // Bytes of tensors kept in device memory, e.g. outputs of SessionManager::runInferenceOnDevice
+  uint64_t device_bytes = 0;
+  // Released tensors whose memory is still borrowed by a lease
+  size_t retired_count = 0;
+  // Limit set by setHardMemoryLimit, 0 for none
+  uint64_t hard_limit_bytes = 0;
+};
+
+// Class to manage tensor data
+class TensorManager {
+public:
+  TensorManager();
+  ~TensorManager();
+
+  // Disallow copy and assign
+  TensorManager(const TensorManager &) = delete;
+  TensorManager &operator=(const TensorManager &) = delete;
+
+  // Create a tensor from the elements of a Float32List, Int32List, Int64List, Uint8List or list of bools; T is
+  // float, int32_t, int64_t, uint8_t or bool
+  template <typename T> TensorHandle createTensor(const std::vector<T> &data, const std::vector<int64_t> &shape);
+
+  // Create a tensor from String data
+  TensorHandle createStringTensor(const std::vector<std::string> &data, const std::vector<int64_t> &shape);
+
+  // Create a tensor of any fixed-size element type (e.g. float16) from its raw element bytes,
+  // copied once straight into a pooled buffer
+  TensorHandle createTensorFromBytes(ONNXTensorElementDataType element_type, const void *data, size_t byte_size,
+                                     const std::vector<int64_t> &shape);
+
+  // Create a normalized 3-channel RGB float32 or float16 tensor from an image in one pass over its pixels
+  TensorHandle createImageTensor(const ImageTensorOptions &options, const uint8_t *data, size_t byte_size);
+
+  // Create a zero-filled tensor of a fixed shape, e.g. to preallocate a bound output
+  TensorHandle createEmptyTensor(ONNXTensorElementDataType element_type, const std::vector<int64_t> &shape);
+
+  // Convert between tensor formats; every fixed-size type converts into every other one, see convertElements
+  TensorHandle convertTensor(TensorHandle tensor_id, ONNXTensorElementDataType target_type);
+
+  // Quantize a tensor into a new int8 or uint8 tensor, see quantizeElements. Tensors of other convertible types than
+  // float32 are widened to float32 first.
+  TensorHandle quantizeTensor(TensorHandle tensor_id, const QuantizationParams &params);
+
+  // Dequantize an int8 or uint8 tensor into a new float32 tensor; the element type of params is taken from the tensor
+  TensorHandle dequantizeTensor(TensorHandle tensor_id, const QuantizationParams &params);
+
+  // Reshape a tensor, as in the ONNX Reshape op, see resolveReshape. The new tensor is a view that shares the memory
+  // of the source and keeps it alive after the source is released; the shared memory is counted once in
+  // getMemoryStats and the hard memory limit for as long as the source or any of its views is stored.
+  TensorHandle reshapeTensor(TensorHandle tensor_id, const std::vector<int64_t> &shape);
+
+  // Slice a tensor along one axis from start to end, clamped as in the ONNX Slice op. The slice is a view when it is
+  // contiguous in the source, i.e. every axis before axis has size 1, and a copy otherwise.
+  TensorHandle sliceTensor(TensorHandle tensor_id, int64_t axis, int64_t start, int64_t end);
+
+  // Take one index along an axis, dropping the axis; a view or a copy as in sliceTensor
+  TensorHandle selectTensor(TensorHandle tensor_id, int64_t axis, int64_t index);
+
+  // Permute the axes of a tensor into a new tensor, see resolvePermutation and transposeElements
+  TensorHandle transposeTensor(TensorHandle tensor_id, const std::vector<int64_t> &perm);
+
+  // Concatenate tensors of one type along an axis into a new tensor
+  TensorHandle concatTensors(const std::vector<TensorHandle> &tensor_ids, int64_t axis);
+
+  // Store a tensor and return its handle (used for output tensors)
+  TensorHandle storeTensor(Ort::Value &&tensor);
+
+  // Get the shape, type and data of a tensor encoded by an embedder's codec, or the codec's null if the tensor does
+  // not exist; a tensor in device memory is copied to the host first. A host tensor that is not stored, such as an
+  // output returned inline, is encoded with encodeTensor.
+  template <typename Codec> typename Codec::Value getTensorData(TensorHandle tensor_id);
+
+  // Release a tensor
+  bool releaseTensor(TensorHandle tensor_id);
+
+  // Release several tensors under one lock, e.g. every tensor of a frame at once; unknown handles are skipped.
+  // Returns how many tensors were released.
+  size_t releaseTensors(const std::vector<TensorHandle> &tensor_ids);
+
+  // Get the OrtValue for a tensor handle
+  Ort::Value *getTensor(TensorHandle tensor_id);
+
+  // Get the type of a tensor
+  std::string getTensorType(TensorHandle tensor_id);
+
+  // Get the shape of a tensor
+  std::vector<int64_t> getTensorShape(TensorHandle tensor_id);
+
+  // Clone a tensor, returning both the Ort::Value and its backing buffer
+  ClonedTensor cloneTensor(TensorHandle tensor_id);
+
+  // Borrow a tensor without copying it; returns an empty lease if the tensor does not exist
+  TensorLease acquireTensor(TensorHandle tensor_id);
+
+  // Borrow a tensor whose data can be read on the CPU: tensors in device memory are copied to the host first, see
+  // setHostCopier. Returns an empty lease if the tensor does not exist; throws if it cannot be copied.
+  TensorLease acquireHostTensor(TensorHandle tensor_id);
+
+  // Borrow a tensor and get the address and size in bytes of its data, e.g. to hand it to Dart without a copy.
+  // Returns an empty lease if the tensor does not exist or holds strings.
+  TensorLease acquireTensorData(TensorHandle tensor_id, void **data, size_t *byte_size);
+
+  // Get hit/miss counters and retained memory of the buffer pool backing tensor data
+  BufferPoolStats getBufferPoolStats();
+
+  // Set how many bytes of released tensor buffers are kept for reuse
+  void setBufferPoolMaxRetainedBytes(size_t max_retained_bytes);
+
+  // Count the live tensors and the bytes they hold
+  TensorMemoryStats getMemoryStats();
+
+  // Reject new tensors that would take the host bytes of the live tensors above hard_limit_bytes, 0 for no limit.
+  // Outputs of runs are always stored, so only tensors created from Dart are rejected, with a std::runtime_error.
+  void setHardMemoryLimit(uint64_t hard_limit_bytes);
+
+  // Set how tensors stored in device memory, e.g. outputs of SessionManager::runInferenceOnDevice, are copied to
+  // the host when their data is read, cloned or converted. The copy is made once per tensor and kept with it.
+  void setHostCopier(std::function<Ort::Value(const OrtValue *)> host_copier);
+
+private:
+  friend class TensorLease;
+
+  // Size of the memory of a stored tensor, shared with the views made of it
+  struct TensorStorage {
+    uint64_t byte_size = 0;
+    // Entries in tensors_ over this memory; its bytes are counted in host_bytes_ while there are any
+    size_t entry_count = 0;
+  };
+
+  // Everything stored for one tensor.
+  // The value is kept behind a pointer so that leases stay valid when the entry is moved to retired_tensors_. It
+  // shares ownership of its backing memory: the ClonedTensor holding the value and its buffer (empty when the memory
+  // is owned by ONNX Runtime), or for a view, the value of the tensor it was made of.
+  struct TensorEntry {
+    std::shared_ptr<Ort::Value> value;
+    ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+    std::vector<int64_t> shape;
+    // Whether value lives in device memory, and its host copy once one was needed
+    bool on_device = false;
+    std::unique_ptr<Ort::Value> host_value;
+    // Memory of value, shared with the tensor a view was made of; counted in host_bytes_ unless on_device
+    std::shared_ptr<TensorStorage> storage;
+  };
+
+  ClonedTensor cloneTensorLocked(TensorHandle tensor_id);
+
+  // Release a tensor; the caller holds mutex_
+  bool releaseTensorLocked(TensorHandle tensor_id);
+
+  // The value of an entry whose data can be read on the host, copying a device tensor on first use; the caller
+  // holds mutex_
+  Ort::Value *hostValueLocked(TensorEntry &entry);
+
+  // Store a tensor and return its new handle; the caller holds mutex_. Throws std::runtime_error if a host tensor
+  // would exceed the hard memory limit, unless enforce_limit is false.
+  TensorHandle insertTensorLocked(Ort::Value &&value, PooledBuffer &&buffer, ONNXTensorElementDataType element_type,
+                                  const std::vector<int64_t> &shape, bool on_device = false, bool enforce_limit = true);
+
+  // Store a view of the memory of a host tensor from byte_offset on, with a new shape, sharing the storage of the
+  // tensor; the caller holds mutex_. Throws std::runtime_error if the tensor does not live in a plain host buffer.
+  TensorHandle insertViewLocked(const TensorEntry &source, size_t byte_offset, const std::vector<int64_t> &shape);
+
+  // Slice along an axis for sliceTensor and selectTensor, dropping the axis unless keep_axis; the caller holds mutex_
+  TensorHandle sliceTensorLocked(TensorHandle tensor_id, int64_t axis, int64_t start, int64_t end, bool keep_axis);
+
+  // Called by TensorLease when it goes out of scope
+  void returnLease(TensorHandle tensor_id);
+
+  // Pool backing tensor data buffers; declared before the maps below so it outlives them
+  BufferPool buffer_pool_;
+
+  // Value, type, shape and backing buffer of every stored tensor
+  HandleTable<TensorEntry> tensors_;
+
+  // Number of outstanding leases per tensor handle
+  std::unordered_map<TensorHandle, int> lease_counts_;
+
+  // Released tensors kept alive until their last lease is returned
+  std::unordered_map<TensorHandle, TensorEntry> retired_tensors_;
+
+  // Mutex for thread safety
+  TracedMutex mutex_{"TensorManager lock wait"};
+
+  // Memory info for CPU memory
+  Ort::MemoryInfo memory_info_{nullptr};
+
+  // Copies device tensors to the host; unset, their data cannot be read
+  std::function<Ort::Value(const OrtValue *)> host_copier_;
+
+  // Bytes of the storage of the host tensors in tensors_, and the limit set by setHardMemoryLimit
+  uint64_t host_bytes_ = 0;
+  uint64_t hard_limit_bytes_ = 0;
+};
+
+template <typename Codec> typename Codec::Value TensorManager::getTensorData(TensorHandle tensor_id) {
+  TraceScope trace("TensorManager::getTensorData");
+  std::lock_guard<TracedMutex> lock(mutex_);
+
+  TensorEntry *tensor_entry = tensors_.find(tensor_id);
+  if (tensor_entry == nullptr) {
+    return Codec::null();
+  }
+  return encodeTensor<Codec>(*hostValueLocked(*tensor_entry));
+}
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_TENSOR_MANAGER_H_
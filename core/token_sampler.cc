@@ -0,0 +1,103 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "token_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flutter_onnxruntime {
+
+int64_t argmaxToken(const float *logits, size_t vocab_size) {
+  // The maximum is reduced in independent lanes first, which compilers turn into SIMD max instructions, and only
+  // then looked up for its first index
+  constexpr size_t kLanes = 8;
+  float lanes[kLanes];
+  std::fill(lanes, lanes + kLanes, logits[0]);
+  size_t i = 0;
+  for (; i + kLanes <= vocab_size; i += kLanes) {
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      lanes[lane] = std::max(lanes[lane], logits[i + lane]);
+    }
+  }
+  float best = *std::max_element(lanes, lanes + kLanes);
+  for (; i < vocab_size; i++) {
+    best = std::max(best, logits[i]);
+  }
+
+  for (size_t token = 0; token < vocab_size; token++) {
+    if (logits[token] == best) {
+      return static_cast<int64_t>(token);
+    }
+  }
+  return 0;
+}
+
+TokenSampler::TokenSampler(const SamplingOptions &options, uint64_t seed) : options_(options), random_(seed) {}
+
+int64_t TokenSampler::sample(const float *logits, size_t vocab_size) {
+  if (options_.temperature <= 0.0f || options_.top_k == 1) {
+    return argmaxToken(logits, vocab_size);
+  }
+
+  candidates_.resize(vocab_size);
+  for (size_t token = 0; token < vocab_size; token++) {
+    candidates_[token] = {logits[token], static_cast<int64_t>(token)};
+  }
+
+  // Only the candidates that top_k or top_p can keep need to be ordered
+  auto by_logit = [](const std::pair<float, int64_t> &a, const std::pair<float, int64_t> &b) {
+    return a.first > b.first;
+  };
+  size_t count = vocab_size;
+  bool sorted = false;
+  if (options_.top_k > 0 && static_cast<size_t>(options_.top_k) < vocab_size) {
+    count = static_cast<size_t>(options_.top_k);
+    std::partial_sort(candidates_.begin(), candidates_.begin() + count, candidates_.end(), by_logit);
+    sorted = true;
+  } else if (options_.top_p < 1.0f) {
+    std::sort(candidates_.begin(), candidates_.end(), by_logit);
+    sorted = true;
+  }
+
+  // Softmax relative to the largest logit, so that exp cannot overflow; the probabilities replace the logits
+  float max_logit = sorted ? candidates_[0].first
+                           : std::max_element(candidates_.begin(), candidates_.end(), [](const auto &a, const auto &b) {
+                               return a.first < b.first;
+                             })->first;
+  double total = 0.0;
+  for (size_t i = 0; i < count; i++) {
+    candidates_[i].first = std::exp((candidates_[i].first - max_logit) / options_.temperature);
+    total += candidates_[i].first;
+  }
+
+  // The nucleus is the shortest prefix of the sorted candidates that holds top_p of the probability
+  if (sorted && options_.top_p < 1.0f) {
+    double cut = options_.top_p * total;
+    double kept_total = 0.0;
+    size_t kept = 0;
+    while (kept < count) {
+      kept_total += candidates_[kept].first;
+      kept++;
+      if (kept_total >= cut) {
+        break;
+      }
+    }
+    count = kept;
+    total = kept_total;
+  }
+
+  double target = std::uniform_real_distribution<double>(0.0, total)(random_);
+  for (size_t i = 0; i < count; i++) {
+    target -= candidates_[i].first;
+    if (target < 0.0) {
+      return candidates_[i].second;
+    }
+  }
+  return candidates_[count - 1].second;
+}
+
+} // namespace flutter_onnxruntime
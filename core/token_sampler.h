@@ -0,0 +1,51 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_TOKEN_SAMPLER_H_
+#define FLUTTER_ONNXRUNTIME_TOKEN_SAMPLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace flutter_onnxruntime {
+
+// How the next token of a generation is picked from the logits of the vocabulary
+struct SamplingOptions {
+  // Logits are divided by the temperature before the softmax; 0 or below picks the most likely token
+  float temperature = 0.0f;
+  // Only the top_k most likely tokens are sampled from, 0 for no limit
+  int64_t top_k = 0;
+  // Only the most likely tokens whose probabilities add up to top_p are sampled from, 1 for no limit
+  float top_p = 1.0f;
+};
+
+// Index of the largest of vocab_size logits; ties keep the first index. vocab_size must be positive.
+int64_t argmaxToken(const float *logits, size_t vocab_size);
+
+// Picks tokens from logits as SamplingOptions specify, with a seeded random generator so that a generation can
+// be repeated. Not thread safe; each generation has its own sampler.
+class TokenSampler {
+public:
+  TokenSampler(const SamplingOptions &options, uint64_t seed);
+
+  // Pick a token from vocab_size logits: greedily without a temperature or with a top_k of 1, otherwise by sampling
+  // the temperature-scaled softmax of the top_k and top_p most likely tokens
+  int64_t sample(const float *logits, size_t vocab_size);
+
+private:
+  SamplingOptions options_;
+  std::mt19937_64 random_;
+
+  // (logit, token) of the tokens sampled from, reused across calls
+  std::vector<std::pair<float, int64_t>> candidates_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_TOKEN_SAMPLER_H_
@@ -0,0 +1,173 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "trace_recorder.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace flutter_onnxruntime {
+
+namespace {
+
+// Ids the operating system gives the calling thread and process, as shown by profilers
+uint64_t currentThreadId() {
+#ifdef _WIN32
+  return static_cast<uint64_t>(GetCurrentThreadId());
+#else
+  return static_cast<uint64_t>(syscall(SYS_gettid));
+#endif
+}
+
+uint64_t currentProcessId() {
+#ifdef _WIN32
+  return static_cast<uint64_t>(GetCurrentProcessId());
+#else
+  return static_cast<uint64_t>(getpid());
+#endif
+}
+
+// Span of a thread copied out of its ring buffer
+struct CopiedSpan {
+  uint64_t index;
+  const char *name;
+  uint64_t start_nanos;
+  uint64_t duration_nanos;
+};
+
+// Format nanoseconds as the fractional microseconds of Chrome trace timestamps
+void writeMicros(std::ostream &out, uint64_t nanos) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%llu.%03llu", static_cast<unsigned long long>(nanos / 1000),
+                static_cast<unsigned long long>(nanos % 1000));
+  out << text;
+}
+
+// Write a span name as a JSON string
+void writeName(std::ostream &out, const char *name) {
+  out << '"';
+  for (const char *c = name; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\';
+    }
+    out << *c;
+  }
+  out << '"';
+}
+
+} // namespace
+
+TraceRecorder &TraceRecorder::instance() {
+  static TraceRecorder recorder;
+  return recorder;
+}
+
+void TraceRecorder::start() {
+  // Thread buffers of an earlier generation are emptied by their thread on its next record
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+  enabled_.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::stop() { enabled_.store(false, std::memory_order_release); }
+
+TraceRecorder::ThreadBuffer *TraceRecorder::threadBuffer() {
+  thread_local ThreadBuffer *buffer = nullptr;
+  if (buffer == nullptr) {
+    auto new_buffer = std::make_unique<ThreadBuffer>();
+    new_buffer->thread_id = currentThreadId();
+    buffer = new_buffer.get();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.push_back(std::move(new_buffer));
+  }
+  return buffer;
+}
+
+void TraceRecorder::record(const char *name, uint64_t start_nanos, uint64_t end_nanos) {
+  if (!enabled()) {
+    return;
+  }
+
+  ThreadBuffer *buffer = threadBuffer();
+  uint64_t generation = generation_.load(std::memory_order_acquire);
+  if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+    buffer->begun.store(0, std::memory_order_relaxed);
+    buffer->written.store(0, std::memory_order_relaxed);
+    buffer->generation.store(generation, std::memory_order_release);
+  }
+
+  // Announce the slot before overwriting it, so that a reader copying it at the same time drops it
+  uint64_t index = buffer->written.load(std::memory_order_relaxed);
+  buffer->begun.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  Slot &slot = buffer->slots[index % kSpansPerThread];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.start_nanos.store(start_nanos, std::memory_order_relaxed);
+  slot.duration_nanos.store(end_nanos > start_nanos ? end_nanos - start_nanos : 0, std::memory_order_relaxed);
+  buffer->written.store(index + 1, std::memory_order_release);
+}
+
+size_t TraceRecorder::writeChromeTrace(std::ostream &out) {
+  std::vector<ThreadBuffer *> buffers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &buffer : buffers_) {
+      buffers.push_back(buffer.get());
+    }
+  }
+
+  uint64_t generation = generation_.load(std::memory_order_acquire);
+  uint64_t pid = currentProcessId();
+  size_t count = 0;
+  out << "{\"traceEvents\":[";
+  for (ThreadBuffer *buffer : buffers) {
+    if (buffer->generation.load(std::memory_order_acquire) != generation) {
+      continue;
+    }
+
+    uint64_t written = buffer->written.load(std::memory_order_acquire);
+    uint64_t first = written > kSpansPerThread ? written - kSpansPerThread : 0;
+    std::vector<CopiedSpan> spans;
+    spans.reserve(written - first);
+    for (uint64_t i = first; i < written; i++) {
+      const Slot &slot = buffer->slots[i % kSpansPerThread];
+      spans.push_back({i, slot.name.load(std::memory_order_relaxed), slot.start_nanos.load(std::memory_order_relaxed),
+                       slot.duration_nanos.load(std::memory_order_relaxed)});
+    }
+
+    // Spans whose slots were being overwritten during the copy may be torn
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t begun = buffer->begun.load(std::memory_order_relaxed);
+    uint64_t valid = begun > kSpansPerThread ? begun - kSpansPerThread : 0;
+    if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+      continue;
+    }
+
+    for (const CopiedSpan &span : spans) {
+      if (span.index < valid || span.name == nullptr) {
+        continue;
+      }
+      out << (count == 0 ? "\n" : ",\n") << "{\"name\":";
+      writeName(out, span.name);
+      out << ",\"cat\":\"flutter_onnxruntime\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << buffer->thread_id
+          << ",\"ts\":";
+      writeMicros(out, span.start_nanos);
+      out << ",\"dur\":";
+      writeMicros(out, span.duration_nanos);
+      out << '}';
+      count++;
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return count;
+}
+
+} // namespace flutter_onnxruntime
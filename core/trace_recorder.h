@@ -0,0 +1,126 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_TRACE_RECORDER_H_
+#define FLUTTER_ONNXRUNTIME_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "session_stats.h"
+
+namespace flutter_onnxruntime {
+
+// Records the spans of the plugin's trace points into a ring buffer per thread, from which they are written in the
+// Chrome trace format that Perfetto and chrome://tracing read. Spans are timed on the steady clock, the clock of the
+// Dart timeline, so they line up with the frames shown in Flutter DevTools.
+// Recording takes no lock; a thread only locks once to register its buffer, the first time it records.
+class TraceRecorder {
+public:
+  // Spans kept per thread; older spans are overwritten
+  static constexpr size_t kSpansPerThread = 16384;
+
+  // The recorder shared by every trace point of the process
+  static TraceRecorder &instance();
+
+  // Start recording, dropping the spans recorded before
+  void start();
+
+  // Stop recording; the recorded spans stay available to writeChromeTrace
+  void stop();
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Record a span of a thread; name must outlive the recorder, e.g. be a string literal
+  void record(const char *name, uint64_t start_nanos, uint64_t end_nanos);
+
+  // Write the spans recorded since the last start as a Chrome trace JSON object; returns the number of spans
+  size_t writeChromeTrace(std::ostream &out);
+
+private:
+  TraceRecorder() = default;
+
+  struct Slot {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<uint64_t> start_nanos{0};
+    std::atomic<uint64_t> duration_nanos{0};
+  };
+
+  // Ring buffer written only by its thread and read by writeChromeTrace
+  struct ThreadBuffer {
+    uint64_t thread_id = 0;
+    // Recording session the spans belong to; a buffer of an earlier session is emptied on its next record
+    std::atomic<uint64_t> generation{0};
+    // Number of spans begun and finished in this session; slot i % kSpansPerThread holds span i.
+    // A reader drops the spans that a writer may have begun to overwrite while they were copied.
+    std::atomic<uint64_t> begun{0};
+    std::atomic<uint64_t> written{0};
+    std::unique_ptr<Slot[]> slots{new Slot[kSpansPerThread]};
+  };
+
+  ThreadBuffer *threadBuffer();
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<uint64_t> generation_{0};
+
+  // Guards buffers_, which grows by one buffer per thread that ever recorded; buffers are never freed
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+// Records a span from its construction to its destruction, or to end(), while the recorder is enabled
+class TraceScope {
+public:
+  explicit TraceScope(const char *name)
+      : name_(TraceRecorder::instance().enabled() ? name : nullptr), start_nanos_(name_ ? steadyNanos() : 0) {}
+  ~TraceScope() { end(); }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+  // End the span early
+  void end() {
+    if (name_ != nullptr) {
+      TraceRecorder::instance().record(name_, start_nanos_, steadyNanos());
+      name_ = nullptr;
+    }
+  }
+
+private:
+  const char *name_;
+  uint64_t start_nanos_;
+};
+
+// Mutex that records the time spent waiting for it as a span, when the lock is contended and tracing is enabled
+class TracedMutex {
+public:
+  explicit TracedMutex(const char *wait_name) : wait_name_(wait_name) {}
+
+  void lock() {
+    if (mutex_.try_lock()) {
+      return;
+    }
+    TraceScope wait(wait_name_);
+    mutex_.lock();
+  }
+
+  bool try_lock() { return mutex_.try_lock(); }
+
+  void unlock() { mutex_.unlock(); }
+
+private:
+  std::mutex mutex_;
+  const char *wait_name_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_TRACE_RECORDER_H_
@@ -0,0 +1,202 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+// End-to-end benchmarks of the plugin on the platform it runs on
+//
+// The same measurements run on every platform backend, so the Kotlin, Swift, C++ and web paths can be compared
+// side by side:
+// * Cold createSession: the first session of a model in the process, including loading its asset
+// * First run: the first inference of a new session
+// * Steady state: p50/p99 of the inferences after warming up
+// * Channel overhead: a getPlatformVersion round trip, and an inference of the tiny Bool Not model
+// * Tensor transfer: Dart→native and native→Dart bandwidth of float32 tensors from 1 KB to 64 MB
+//
+// The report is printed as one JSON line prefixed with BENCHMARK_REPORT, and is also the response data of the test,
+// which `flutter drive` writes to build/integration_response_data.json:
+//   flutter drive --driver=test_driver/integration_test.dart --target=integration_test/benchmark_test.dart \
+//     --profile -d <device_id>
+// Pass --dart-define=BENCHMARK_RUNS=<n> to change the number of steady-state runs.
+
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:flutter/foundation.dart' show defaultTargetPlatform, kIsWeb;
+import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:integration_test/integration_test.dart';
+
+// Number of steady-state runs of each model
+const int _steadyStateRuns = int.fromEnvironment('BENCHMARK_RUNS', defaultValue: 200);
+
+// Runs before the steady-state runs, which are not measured
+const int _warmupRuns = 10;
+
+// Payload sizes of the transfer benchmark, in bytes
+const List<int> _transferSizes = [1 << 10, 16 << 10, 256 << 10, 4 << 20, 64 << 20];
+
+void main() {
+  final binding = IntegrationTestWidgetsFlutterBinding.ensureInitialized();
+
+  testWidgets('Benchmark report', (WidgetTester tester) async {
+    final onnxRuntime = OnnxRuntime();
+    final report = <String, dynamic>{
+      'platform': kIsWeb ? 'web' : defaultTargetPlatform.name,
+      'platformVersion': await onnxRuntime.getPlatformVersion(),
+      'timestamp': DateTime.now().toUtc().toIso8601String(),
+      'steadyStateRuns': _steadyStateRuns,
+    };
+
+    report['models'] = [
+      await _benchmarkModel(onnxRuntime, 'assets/models/transpose_and_avg_model_fp32.onnx', () async {
+        return {
+          'A': await OrtValue.fromList(Float32List.fromList(List.filled(6, 1.0)), [1, 2, 3]),
+          'B': await OrtValue.fromList(Float32List.fromList(List.filled(6, 2.0)), [1, 3, 2]),
+        };
+      }),
+      await _benchmarkModel(onnxRuntime, 'assets/models/bool_not_model.onnx', () async {
+        return {'input': await OrtValue.fromList([true, false, false, true], [2, 2])};
+      }),
+    ];
+    report['channel'] = await _benchmarkChannel(onnxRuntime);
+    report['transfer'] = [for (final size in _transferSizes) await _benchmarkTransfer(size)];
+
+    binding.reportData = report;
+    // ignore: avoid_print
+    print('BENCHMARK_REPORT ${jsonEncode(report)}');
+
+    // The benchmark makes no assertions on the timings themselves
+    expect((report['models'] as List).length, 2);
+    expect((report['transfer'] as List).length, _transferSizes.length);
+  });
+}
+
+/// Measures the cold session creation, first run and steady-state latency of a model
+Future<Map<String, dynamic>> _benchmarkModel(
+  OnnxRuntime onnxRuntime,
+  String assetKey,
+  Future<Map<String, OrtValue>> Function() createInputs,
+) async {
+  final createWatch = Stopwatch()..start();
+  final session = await onnxRuntime.createSessionFromAsset(assetKey);
+  createWatch.stop();
+
+  final inputs = await createInputs();
+  try {
+    final firstRunWatch = Stopwatch()..start();
+    await _disposeAll(await session.run(inputs));
+    firstRunWatch.stop();
+
+    for (var i = 0; i < _warmupRuns; i++) {
+      await _disposeAll(await session.run(inputs));
+    }
+
+    final latencies = <int>[];
+    for (var i = 0; i < _steadyStateRuns; i++) {
+      final watch = Stopwatch()..start();
+      final outputs = await session.run(inputs);
+      watch.stop();
+      latencies.add(watch.elapsedMicroseconds);
+      await _disposeAll(outputs);
+    }
+
+    return {
+      'model': assetKey.split('/').last,
+      'coldCreateSessionMicros': createWatch.elapsedMicroseconds,
+      'firstRunMicros': firstRunWatch.elapsedMicroseconds,
+      ..._latencySummary(latencies),
+    };
+  } finally {
+    await _disposeAll(inputs);
+    await session.close();
+  }
+}
+
+/// Measures the round trip of a plugin call that does no work
+Future<Map<String, dynamic>> _benchmarkChannel(OnnxRuntime onnxRuntime) async {
+  for (var i = 0; i < _warmupRuns; i++) {
+    await onnxRuntime.getPlatformVersion();
+  }
+
+  final latencies = <int>[];
+  for (var i = 0; i < _steadyStateRuns; i++) {
+    final watch = Stopwatch()..start();
+    await onnxRuntime.getPlatformVersion();
+    watch.stop();
+    latencies.add(watch.elapsedMicroseconds);
+  }
+  return {'method': 'getPlatformVersion', ..._latencySummary(latencies)};
+}
+
+/// Measures the bandwidth of creating a float32 tensor of a payload size and of reading its data back
+Future<Map<String, dynamic>> _benchmarkTransfer(int bytes) async {
+  final data = Float32List(bytes ~/ Float32List.bytesPerElement);
+  for (var i = 0; i < data.length; i++) {
+    data[i] = i % 255 / 255;
+  }
+  // Fewer repeats of the large payloads, which take long enough to time on their own
+  final repeats = bytes <= (1 << 20) ? 20 : 3;
+
+  final uploads = <int>[];
+  final downloads = <int>[];
+  for (var i = 0; i < repeats; i++) {
+    final uploadWatch = Stopwatch()..start();
+    final tensor = await OrtValue.fromList(data, [data.length]);
+    uploadWatch.stop();
+
+    final downloadWatch = Stopwatch()..start();
+    final readBack = await tensor.asTypedData();
+    downloadWatch.stop();
+    expect(readBack.lengthInBytes, bytes);
+
+    await tensor.dispose();
+    uploads.add(uploadWatch.elapsedMicroseconds);
+    downloads.add(downloadWatch.elapsedMicroseconds);
+  }
+
+  final uploadMicros = _percentile(uploads, 50);
+  final downloadMicros = _percentile(downloads, 50);
+  return {
+    'bytes': bytes,
+    'uploadP50Micros': uploadMicros,
+    'downloadP50Micros': downloadMicros,
+    'uploadMBps': _megabytesPerSecond(bytes, uploadMicros),
+    'downloadMBps': _megabytesPerSecond(bytes, downloadMicros),
+  };
+}
+
+Map<String, dynamic> _latencySummary(List<int> latencies) {
+  final total = latencies.fold<int>(0, (sum, latency) => sum + latency);
+  return {
+    'runs': latencies.length,
+    'meanMicros': latencies.isEmpty ? 0 : total ~/ latencies.length,
+    'p50Micros': _percentile(latencies, 50),
+    'p99Micros': _percentile(latencies, 99),
+  };
+}
+
+/// Nearest-rank percentile of a list of samples
+int _percentile(List<int> samples, int percent) {
+  if (samples.isEmpty) {
+    return 0;
+  }
+  final sorted = List<int>.from(samples)..sort();
+  final rank = ((percent / 100) * sorted.length).ceil().clamp(1, sorted.length);
+  return sorted[rank - 1];
+}
+
+double _megabytesPerSecond(int bytes, int micros) {
+  // Below the timer resolution, e.g. on web, the bandwidth cannot be told
+  if (micros <= 0) {
+    return 0;
+  }
+  return bytes / micros * 1e6 / (1 << 20);
+}
+
+Future<void> _disposeAll(Map<String, OrtValue> values) async {
+  for (final value in values.values) {
+    await value.dispose();
+  }
+}
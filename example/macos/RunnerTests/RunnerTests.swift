@@ -25,4 +25,17 @@ class RunnerTests: XCTestCase {
     waitForExpectations(timeout: 1)
   }
 
+  func testRunInferenceOnUnknownSessionFails() {
+    let plugin = FlutterOnnxruntimePlugin()
+
+    let call = FlutterMethodCall(methodName: "runInference", arguments: ["sessionId": "unknown", "inputs": [:]])
+
+    let resultExpectation = expectation(description: "result block must be called.")
+    plugin.handle(call) { result in
+      XCTAssertEqual((result as? FlutterError)?.code, "INVALID_SESSION")
+      resultExpectation.fulfill()
+    }
+    waitForExpectations(timeout: 1)
+  }
+
 }
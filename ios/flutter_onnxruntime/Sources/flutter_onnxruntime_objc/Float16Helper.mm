@@ -112,7 +112,7 @@ static float float16ToFloat(uint16_t float16Bits) {
             float16Ptr[i] = floatToFloat16(float32Values[i].floatValue);
         }
 
-        return [self createFloat16TensorFromRawData:float16Data shape:shape error:error];
+        return [self wrapFloat16Data:float16Data shape:shape error:error];
     } @catch (NSException *exception) {
         if (error) {
             *error = [NSError errorWithDomain:@"com.masicai.flutter_onnxruntime"
@@ -123,9 +123,36 @@ static float float16ToFloat(uint16_t float16Bits) {
     }
 }
 
++ (nullable ORTValue *)createFloat16TensorFromFloat32Data:(NSData *)float32Data
+                                                    shape:(NSArray<NSNumber *> *)shape
+                                                    error:(NSError **)error {
+    NSUInteger count = float32Data.length / sizeof(float);
+    const uint8_t *float32Bytes = (const uint8_t *)float32Data.bytes;
+
+    // Convert from the bytes straight into the tensor's buffer; memcpy because the bytes of a message need not
+    // be aligned
+    NSMutableData *float16Data = [NSMutableData dataWithLength:count * sizeof(uint16_t)];
+    uint16_t *float16Ptr = (uint16_t *)float16Data.mutableBytes;
+    for (NSUInteger i = 0; i < count; i++) {
+        float value;
+        memcpy(&value, float32Bytes + i * sizeof(float), sizeof(float));
+        float16Ptr[i] = floatToFloat16(value);
+    }
+
+    return [self wrapFloat16Data:float16Data shape:shape error:error];
+}
+
 + (nullable ORTValue *)createFloat16TensorFromRawData:(NSData *)rawData
                                                 shape:(NSArray<NSNumber *> *)shape
                                                 error:(NSError **)error {
+    // Copy raw data into a mutable buffer that will be kept alive by externalTensorData
+    return [self wrapFloat16Data:[NSMutableData dataWithData:rawData] shape:shape error:error];
+}
+
+/// Wraps float16 data into an ORTValue that uses the buffer in place and keeps it alive.
++ (nullable ORTValue *)wrapFloat16Data:(NSMutableData *)mutableData
+                                 shape:(NSArray<NSNumber *> *)shape
+                                 error:(NSError **)error {
     try {
         // Build shape vector
         std::vector<int64_t> shapeVec;
@@ -134,9 +161,6 @@ static float float16ToFloat(uint16_t float16Bits) {
             shapeVec.push_back(dim.longLongValue);
         }
 
-        // Copy raw data into a mutable buffer that will be kept alive by externalTensorData
-        NSMutableData *mutableData = [NSMutableData dataWithData:rawData];
-
         // Create C++ Ort::Value with float16 element type
         auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
         Ort::Value ortValue = Ort::Value::CreateTensor(
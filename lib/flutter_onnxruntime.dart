@@ -7,7 +7,24 @@
 library;
 
 export 'src/onnxruntime.dart' show OnnxRuntime;
-export 'src/ort_session.dart' show OrtSession, OrtSessionOptions, OrtRunOptions;
+export 'src/ort_session.dart'
+    show
+        OrtSession,
+        OrtSessionOptions,
+        OrtRunOptions,
+        OrtRunPriority,
+        OrtRunHandle,
+        OrtGraphOptimizationLevel,
+        OrtArenaExtendStrategy;
 export 'src/ort_model_metadata.dart' show OrtModelMetadata;
-export 'src/ort_value.dart' show OrtValue, OrtDataType;
-export 'src/ort_provider.dart' show OrtProvider;
+export 'src/ort_memory_stats.dart' show OrtMemoryStats, OrtBufferPoolStats;
+export 'src/ort_ops.dart' show OrtOps;
+export 'src/ort_pipeline.dart' show OrtPipeline, OrtPipelineStage;
+export 'src/ort_batching_stats.dart' show OrtBatchingStats;
+export 'src/ort_profile.dart' show OrtProfile, OrtProfileEntry;
+export 'src/ort_quantization.dart' show OrtQuantization;
+export 'src/ort_queue_stats.dart' show OrtQueueStats;
+export 'src/ort_session_stats.dart' show OrtSessionStats;
+export 'src/ort_stream.dart' show OrtStream, OrtStreamFrame;
+export 'src/ort_value.dart' show OrtValue, OrtValueScope, OrtDataType, OrtImageFormat, OrtTensorLayout;
+export 'src/ort_provider.dart' show OrtProvider, OrtDevice;
@@ -16,6 +16,23 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
   @visibleForTesting
   final methodChannel = const MethodChannel('flutter_onnxruntime');
 
+  /// The event channel over which native streams send the outputs of their frames.
+  @visibleForTesting
+  final streamEventChannel = const EventChannel('flutter_onnxruntime/streams');
+
+  // One subscription to the event channel shared by every stream, as cancelling a listener stops the native events
+  late final Stream<Map<String, dynamic>> _streamEvents = streamEventChannel
+      .receiveBroadcastStream()
+      .map((event) => _convertMapToStringDynamic(event as Map<Object?, Object?>));
+
+  /// The event channel over which native generations send their tokens.
+  @visibleForTesting
+  final generationEventChannel = const EventChannel('flutter_onnxruntime/generation');
+
+  late final Stream<Map<String, dynamic>> _generationEvents = generationEventChannel
+      .receiveBroadcastStream()
+      .map((event) => _convertMapToStringDynamic(event as Map<Object?, Object?>));
+
   @override
   Future<String?> getPlatformVersion() async {
     return await methodChannel.invokeMethod<String>('getPlatformVersion');
@@ -40,6 +57,26 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
     return _convertMapToStringDynamic(result ?? {});
   }
 
+  @override
+  Future<Map<String, dynamic>> createSessionFromBuffer(Uint8List modelData, {Map<String, dynamic>? sessionOptions}) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('createSessionFromBuffer', {
+      'modelData': modelData,
+      'sessionOptions': sessionOptions ?? {},
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  /// Platforms that cannot map models ignore mapModel and read the file.
+  @override
+  Future<Map<String, dynamic>> createSessionFromMappedFile(String modelPath, {Map<String, dynamic>? sessionOptions}) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('createSession', {
+      'modelPath': modelPath,
+      'sessionOptions': sessionOptions ?? {},
+      'mapModel': true,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
   /// Get the available providers
   @override
   Future<List<String>> getAvailableProviders() async {
@@ -57,43 +94,424 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('runInference', {
+      'sessionId': _idToPlatform(sessionId),
+      'inputs': _inputsToPlatform(inputs),
+      'runOptions': runOptions ?? {},
+      if (outputNames != null) 'outputNames': outputNames,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  /// Run inference on a session for several independent requests in one channel message
+  ///
+  /// Platforms without a native batch path answer with [MissingPluginException],
+  /// in which case the requests are run one by one.
+  @override
+  Future<List<Map<String, dynamic>>> runBatch(
+    String sessionId,
+    List<Map<String, OrtValue>> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) async {
+    try {
+      final result = await methodChannel.invokeMethod<List<Object?>>('runBatch', {
+        'sessionId': _idToPlatform(sessionId),
+        'inputs': inputs.map(_inputsToPlatform).toList(),
+        'runOptions': runOptions ?? {},
+      });
+      return result?.map((item) => _convertMapToStringDynamic(item as Map<Object?, Object?>)).toList() ?? [];
+    } on MissingPluginException {
+      return [for (final request in inputs) await runInference(sessionId, request, runOptions: runOptions)];
+    }
+  }
+
+  @override
+  Future<Map<String, dynamic>> bindOutputs(String sessionId, {List<String>? outputNames}) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('bindOutputs', {
+      'sessionId': _idToPlatform(sessionId),
+      if (outputNames != null) 'outputNames': outputNames,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<Map<String, dynamic>> runWithBinding(
+    String sessionId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
   }) async {
-    // Convert OrtValue objects to valueId maps for platform channel
-    final processedInputs = <String, dynamic>{};
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('runWithBinding', {
+      'sessionId': _idToPlatform(sessionId),
+      'inputs': _inputsToPlatform(inputs),
+      'runOptions': runOptions ?? {},
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<void> unbindOutputs(String sessionId) async {
+    await methodChannel.invokeMethod<void>('unbindOutputs', {'sessionId': _idToPlatform(sessionId)});
+  }
 
-    for (final entry in inputs.entries) {
-      // Convert each OrtValue to its valueId for the platform channel
-      processedInputs[entry.key] = {'valueId': entry.value.id};
+  /// Only Linux and Windows keep sequence state; other platforms answer with [MissingPluginException], reported as
+  /// an [UnsupportedError].
+  @override
+  Future<void> enableSequenceState(
+    String sessionId,
+    Map<String, String> loops, {
+    Map<String, int> initialDimensions = const {},
+  }) async {
+    try {
+      await methodChannel.invokeMethod<void>('enableSequenceState', {
+        'sessionId': _idToPlatform(sessionId),
+        'loops': loops,
+        'initialDimensions': initialDimensions,
+      });
+    } on MissingPluginException {
+      throw UnsupportedError('Sequence state is only supported on Linux and Windows');
     }
+  }
 
-    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('runInference', {
-      'sessionId': sessionId,
-      'inputs': processedInputs,
+  @override
+  Future<void> resetSequenceState(String sessionId) async {
+    await methodChannel.invokeMethod<void>('resetSequenceState', {'sessionId': _idToPlatform(sessionId)});
+  }
+
+  @override
+  Future<void> disableSequenceState(String sessionId) async {
+    await methodChannel.invokeMethod<void>('disableSequenceState', {'sessionId': _idToPlatform(sessionId)});
+  }
+
+  /// Only Linux and Windows generate natively; other platforms answer with [MissingPluginException], which is
+  /// turned into an [UnsupportedError].
+  @override
+  Future<Map<String, dynamic>> generate(String sessionId, List<int> prompt, {Map<String, dynamic>? options}) async {
+    try {
+      final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('generate', {
+        'sessionId': _idToPlatform(sessionId),
+        'prompt': Int64List.fromList(prompt),
+        'options': options ?? {},
+      });
+      return _convertMapToStringDynamic(result ?? {});
+    } on MissingPluginException {
+      throw UnsupportedError('Native generation is only supported on Linux and Windows');
+    }
+  }
+
+  @override
+  Future<void> cancelGeneration(String generationId) async {
+    await methodChannel.invokeMethod<void>('cancelGeneration', {'generationId': _idToPlatform(generationId)});
+  }
+
+  @override
+  Stream<Map<String, dynamic>> get generationEvents => _generationEvents;
+
+  /// Only Linux and Windows run pipelines; other platforms answer with [MissingPluginException], reported as an
+  /// [UnsupportedError].
+  @override
+  Future<Map<String, dynamic>> createPipeline(List<Map<String, dynamic>> stages, Map<String, String> outputs) async {
+    try {
+      final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('createPipeline', {
+        'stages': [
+          for (final stage in stages)
+            {
+              ...stage,
+              if (stage['sessionId'] is String) 'sessionId': _idToPlatform(stage['sessionId'] as String),
+            },
+        ],
+        'outputs': outputs,
+      });
+      return _convertMapToStringDynamic(result ?? {});
+    } on MissingPluginException {
+      throw UnsupportedError('Pipelines are only supported on Linux and Windows');
+    }
+  }
+
+  @override
+  Future<Map<String, dynamic>> runPipeline(
+    String pipelineId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('runPipeline', {
+      'pipelineId': _idToPlatform(pipelineId),
+      'inputs': _inputsToPlatform(inputs),
+      'runOptions': runOptions ?? {},
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<void> closePipeline(String pipelineId) async {
+    await methodChannel.invokeMethod<void>('closePipeline', {'pipelineId': _idToPlatform(pipelineId)});
+  }
+
+  /// Only Linux and Windows run glue ops natively; other platforms answer with [MissingPluginException], reported as
+  /// an [UnsupportedError].
+  @override
+  Future<Map<String, dynamic>> runTensorOp(
+    String op,
+    Map<String, OrtValue> inputs, {
+    Map<String, Object> params = const {},
+  }) async {
+    try {
+      final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('runTensorOp', {
+        'op': op,
+        'inputs': _inputsToPlatform(inputs),
+        'params': params,
+      });
+      return _convertMapToStringDynamic(result ?? {});
+    } on MissingPluginException {
+      throw UnsupportedError('Tensor ops are only supported on Linux and Windows');
+    }
+  }
+
+  /// Only Linux and Windows stream frames natively; other platforms answer with [MissingPluginException], which is
+  /// turned into an [UnsupportedError].
+  @override
+  Future<Map<String, dynamic>> openStream(String sessionId, {int depth = 2}) async {
+    try {
+      final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('openStream', {
+        'sessionId': _idToPlatform(sessionId),
+        'depth': depth,
+      });
+      return _convertMapToStringDynamic(result ?? {});
+    } on MissingPluginException {
+      throw UnsupportedError('Frame streams are only supported natively on Linux and Windows');
+    }
+  }
+
+  @override
+  Future<Map<String, dynamic>> submitStreamFrame(
+    String streamId,
+    Map<String, TypedData> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('submitStreamFrame', {
+      'streamId': _idToPlatform(streamId),
+      'inputs': inputs.map((name, data) => MapEntry(name, _typedDataToPlatform(data))),
       'runOptions': runOptions ?? {},
     });
     return _convertMapToStringDynamic(result ?? {});
   }
 
+  @override
+  Future<void> closeStream(String streamId) async {
+    await methodChannel.invokeMethod<void>('closeStream', {'streamId': _idToPlatform(streamId)});
+  }
+
+  @override
+  Stream<Map<String, dynamic>> get streamEvents => _streamEvents;
+
+  @override
+  Future<void> setInferenceThreads(int numThreads) async {
+    await methodChannel.invokeMethod<void>('setInferenceThreads', {'numThreads': numThreads});
+  }
+
+  /// Platforms without priority queues answer with [MissingPluginException], reported as an [UnsupportedError].
+  @override
+  Future<Map<String, dynamic>> getQueueStats() async {
+    try {
+      final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getQueueStats');
+      return _convertMapToStringDynamic(result ?? {});
+    } on MissingPluginException {
+      throw UnsupportedError('Queue statistics are only supported on Linux and Windows');
+    }
+  }
+
+  /// Platforms without priority queues answer with [MissingPluginException]; they have nothing to cancel.
+  @override
+  Future<int> cancelLowPriorityRuns() async {
+    try {
+      return await methodChannel.invokeMethod<int>('cancelLowPriorityRuns') ?? 0;
+    } on MissingPluginException {
+      return 0;
+    }
+  }
+
+  /// Platforms that cannot cancel calls answer with [MissingPluginException]; the calls then run to completion.
+  @override
+  Future<bool> cancelRun(String runTag) async {
+    try {
+      return await methodChannel.invokeMethod<bool>('cancelRun', {'runTag': runTag}) ?? false;
+    } on MissingPluginException {
+      return false;
+    }
+  }
+
+  @override
+  Future<void> setIntegerHandles(bool enabled) async {
+    await methodChannel.invokeMethod<void>('setIntegerHandles', {'enabled': enabled});
+  }
+
+  /// Platforms without a session cache answer with [MissingPluginException], which is ignored.
+  @override
+  Future<void> configureSessionCache({required int maxSessions, required int maxBytes}) async {
+    try {
+      await methodChannel.invokeMethod<void>('configureSessionCache', {
+        'maxSessions': maxSessions,
+        'maxBytes': maxBytes,
+      });
+    } on MissingPluginException {
+      return;
+    }
+  }
+
+  /// Platforms without shared thread pools answer with [MissingPluginException], which is ignored.
+  @override
+  Future<void> configureThreadPools({
+    required int intraOpNumThreads,
+    required int interOpNumThreads,
+    bool allowSpinning = true,
+    String? intraOpThreadAffinity,
+  }) async {
+    try {
+      await methodChannel.invokeMethod<void>('configureThreadPools', {
+        'intraOpNumThreads': intraOpNumThreads,
+        'interOpNumThreads': interOpNumThreads,
+        'allowSpinning': allowSpinning,
+        if (intraOpThreadAffinity != null) 'intraOpThreadAffinity': intraOpThreadAffinity,
+      });
+    } on MissingPluginException {
+      return;
+    }
+  }
+
+  /// Platforms without a shared arena answer with [MissingPluginException], which is ignored.
+  @override
+  Future<void> configureSharedArena({
+    int maxBytes = 0,
+    String? extendStrategy,
+    int? initialChunkBytes,
+    int? maxDeadBytesPerChunk,
+  }) async {
+    try {
+      await methodChannel.invokeMethod<void>('configureSharedArena', {
+        'maxBytes': maxBytes,
+        if (extendStrategy != null) 'extendStrategy': extendStrategy,
+        if (initialChunkBytes != null) 'initialChunkBytes': initialChunkBytes,
+        if (maxDeadBytesPerChunk != null) 'maxDeadBytesPerChunk': maxDeadBytesPerChunk,
+      });
+    } on MissingPluginException {
+      return;
+    }
+  }
+
+  @override
+  Future<void> configureBatching(String sessionId, {required int windowMicros, required int maxBatchSize}) async {
+    await methodChannel.invokeMethod<void>('configureBatching', {
+      'sessionId': _idToPlatform(sessionId),
+      'windowMicros': windowMicros,
+      'maxBatchSize': maxBatchSize,
+    });
+  }
+
+  @override
+  Future<Map<String, dynamic>> getBatchingStats(String sessionId) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getBatchingStats', {
+      'sessionId': _idToPlatform(sessionId),
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  /// Platforms without session stats answer with [MissingPluginException], reported as an empty map.
+  @override
+  Future<Map<String, dynamic>> getSessionStats(String sessionId) async {
+    try {
+      final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getSessionStats', {
+        'sessionId': _idToPlatform(sessionId),
+      });
+      return _convertMapToStringDynamic(result ?? {});
+    } on MissingPluginException {
+      return {};
+    }
+  }
+
+  /// Only Linux and Windows account for native memory; other platforms answer with [MissingPluginException],
+  /// reported as an [UnsupportedError].
+  @override
+  Future<Map<String, dynamic>> getMemoryStats() async {
+    try {
+      final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getMemoryStats');
+      return _convertMapToStringDynamic(result ?? {});
+    } on MissingPluginException {
+      throw UnsupportedError('Memory statistics are only supported on Linux and Windows');
+    }
+  }
+
+  @override
+  Future<void> setMemoryLimit(int hardLimitBytes) async {
+    try {
+      await methodChannel.invokeMethod<void>('setMemoryLimit', {'hardLimitBytes': hardLimitBytes});
+    } on MissingPluginException {
+      throw UnsupportedError('Memory limits are only supported on Linux and Windows');
+    }
+  }
+
+  @override
+  Future<Map<String, dynamic>> endProfiling(String sessionId) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('endProfiling', {
+      'sessionId': _idToPlatform(sessionId),
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  /// Platforms without native trace points answer with [MissingPluginException], which is ignored.
+  @override
+  Future<void> startTracing() async {
+    try {
+      await methodChannel.invokeMethod<void>('startTracing');
+    } on MissingPluginException {
+      return;
+    }
+  }
+
+  /// Platforms without native trace points answer with [MissingPluginException], reported as an empty map.
+  @override
+  Future<Map<String, dynamic>> stopTracing({String? path}) async {
+    try {
+      final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('stopTracing', {
+        if (path != null) 'path': path,
+      });
+      return _convertMapToStringDynamic(result ?? {});
+    } on MissingPluginException {
+      return {};
+    }
+  }
+
+  /// Platforms without a dart:ffi data plane answer with [MissingPluginException], reported as an empty map.
+  @override
+  Future<Map<String, dynamic>> getNativeContext() async {
+    try {
+      final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getNativeContext');
+      return _convertMapToStringDynamic(result ?? {});
+    } on MissingPluginException {
+      return {};
+    }
+  }
+
   @override
   Future<void> closeSession(String sessionId) async {
-    await methodChannel.invokeMethod<void>('closeSession', {'sessionId': sessionId});
+    await methodChannel.invokeMethod<void>('closeSession', {'sessionId': _idToPlatform(sessionId)});
   }
 
   @override
   Future<Map<String, dynamic>> getMetadata(String sessionId) async {
-    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getMetadata', {'sessionId': sessionId});
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getMetadata', {'sessionId': _idToPlatform(sessionId)});
     return _convertMapToStringDynamic(result ?? {});
   }
 
   @override
   Future<List<Map<String, dynamic>>> getInputInfo(String sessionId) async {
-    final result = await methodChannel.invokeMethod<List<Object?>>('getInputInfo', {'sessionId': sessionId});
+    final result = await methodChannel.invokeMethod<List<Object?>>('getInputInfo', {'sessionId': _idToPlatform(sessionId)});
     return result?.map((item) => _convertMapToStringDynamic(item as Map<Object?, Object?>)).toList() ?? [];
   }
 
   @override
   Future<List<Map<String, dynamic>>> getOutputInfo(String sessionId) async {
-    final result = await methodChannel.invokeMethod<List<Object?>>('getOutputInfo', {'sessionId': sessionId});
+    final result = await methodChannel.invokeMethod<List<Object?>>('getOutputInfo', {'sessionId': _idToPlatform(sessionId)});
     return result?.map((item) => _convertMapToStringDynamic(item as Map<Object?, Object?>)).toList() ?? [];
   }
 
@@ -109,24 +527,146 @@ class MethodChannelFlutterOnnxruntime extends FlutterOnnxruntimePlatform {
     return _convertMapToStringDynamic(result ?? {});
   }
 
+  @override
+  Future<Map<String, dynamic>> createImageTensor(
+    Uint8List data, {
+    required String format,
+    required int width,
+    required int height,
+    int? targetWidth,
+    int? targetHeight,
+    List<double>? mean,
+    List<double>? std,
+    required String layout,
+    required String dataType,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('createImageTensor', {
+      'data': data,
+      'format': format,
+      'width': width,
+      'height': height,
+      'targetWidth': targetWidth,
+      'targetHeight': targetHeight,
+      'mean': mean,
+      'std': std,
+      'layout': layout,
+      'dataType': dataType,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
   @override
   Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) async {
     final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('convertOrtValue', {
-      'valueId': valueId,
+      'valueId': _idToPlatform(valueId),
       'targetType': targetType,
     });
     return _convertMapToStringDynamic(result ?? {});
   }
 
+  @override
+  Future<Map<String, dynamic>> quantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+    required String dataType,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('quantizeOrtValue', {
+      'valueId': _idToPlatform(valueId),
+      'scales': scales,
+      'zeroPoints': zeroPoints,
+      'axis': axis,
+      'dataType': dataType,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<Map<String, dynamic>> dequantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('dequantizeOrtValue', {
+      'valueId': _idToPlatform(valueId),
+      'scales': scales,
+      'zeroPoints': zeroPoints,
+      'axis': axis,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<Map<String, dynamic>> reshapeOrtValue(String valueId, List<int> shape) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('reshapeOrtValue', {
+      'valueId': _idToPlatform(valueId),
+      'shape': shape,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<Map<String, dynamic>> sliceOrtValue(String valueId, int axis, int start, [int? end]) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('sliceOrtValue', {
+      'valueId': _idToPlatform(valueId),
+      'axis': axis,
+      'start': start,
+      'end': end,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<Map<String, dynamic>> transposeOrtValue(String valueId, [List<int>? perm]) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('transposeOrtValue', {
+      'valueId': _idToPlatform(valueId),
+      'perm': perm,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
+  @override
+  Future<Map<String, dynamic>> concatOrtValues(List<String> valueIds, int axis) async {
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('concatOrtValues', {
+      'valueIds': valueIds.map(_idToPlatform).toList(),
+      'axis': axis,
+    });
+    return _convertMapToStringDynamic(result ?? {});
+  }
+
   @override
   Future<Map<String, dynamic>> getOrtValueData(String valueId) async {
-    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getOrtValueData', {'valueId': valueId});
+    final result = await methodChannel.invokeMethod<Map<Object?, Object?>>('getOrtValueData', {'valueId': _idToPlatform(valueId)});
     return _convertMapToStringDynamic(result ?? {});
   }
 
   @override
   Future<void> releaseOrtValue(String valueId) async {
-    await methodChannel.invokeMethod<void>('releaseOrtValue', {'valueId': valueId});
+    await methodChannel.invokeMethod<void>('releaseOrtValue', {'valueId': _idToPlatform(valueId)});
+  }
+
+  @override
+  Future<void> releaseOrtValues(List<String> valueIds) async {
+    await methodChannel.invokeMethod<void>('releaseOrtValues', {'valueIds': valueIds.map(_idToPlatform).toList()});
+  }
+
+  // IDs are Strings in Dart; integer handles arrive as ints and are sent back as ints.
+  // String IDs generated by the platforms are never purely numeric.
+  Object _idToPlatform(String id) => int.tryParse(id) ?? id;
+
+  // Convert OrtValue objects to the valueId maps sent over the platform channel
+  Map<String, dynamic> _inputsToPlatform(Map<String, OrtValue> inputs) {
+    return inputs.map((name, value) => MapEntry(name, {'valueId': _idToPlatform(value.id)}));
+  }
+
+  // Typed lists the standard codec carries as they are, and the element bytes of any other typed data
+  Object _typedDataToPlatform(TypedData data) {
+    if (data is Uint8List || data is Int32List || data is Int64List || data is Float32List || data is Float64List) {
+      return data;
+    }
+    return data.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes);
   }
 
   Map<String, dynamic> _convertMapToStringDynamic(Map<Object?, Object?> map) {
@@ -4,6 +4,8 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:typed_data';
+
 import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_method_channel.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
@@ -39,6 +41,20 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
     throw UnimplementedError('createSession() has not been implemented.');
   }
 
+  /// Create a session from the bytes of a model instead of a file
+  ///
+  /// [modelData] is the serialized model, only needed until the call completes
+  Future<Map<String, dynamic>> createSessionFromBuffer(Uint8List modelData, {Map<String, dynamic>? sessionOptions}) {
+    throw UnimplementedError('createSessionFromBuffer() has not been implemented.');
+  }
+
+  /// Create a session from a model file parsed from a read-only memory mapping instead of being read
+  ///
+  /// [modelPath] is the path of the model file
+  Future<Map<String, dynamic>> createSessionFromMappedFile(String modelPath, {Map<String, dynamic>? sessionOptions}) {
+    throw UnimplementedError('createSessionFromMappedFile() has not been implemented.');
+  }
+
   /// Get the available providers
   Future<List<String>> getAvailableProviders() {
     throw UnimplementedError('getAvailableProviders() has not been implemented.');
@@ -49,14 +65,340 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
   /// [sessionId] is the ID of the session to run inference on
   /// [inputs] is a map of input names to OrtValue objects
   /// [runOptions] is an optional map of run options
+  /// [outputNames] is an optional list of the outputs to compute and return, all outputs if omitted
   Future<Map<String, dynamic>> runInference(
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
   }) {
     throw UnimplementedError('runInference() has not been implemented.');
   }
 
+  /// Run inference on a session for several independent requests
+  ///
+  /// [sessionId] is the ID of the session to run inference on
+  /// [inputs] is a list of maps of input names to OrtValue objects, one per request
+  /// [runOptions] is an optional map of run options applied to every request
+  ///
+  /// Returns one outputs map per request, in request order
+  Future<List<Map<String, dynamic>>> runBatch(
+    String sessionId,
+    List<Map<String, OrtValue>> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) {
+    throw UnimplementedError('runBatch() has not been implemented.');
+  }
+
+  /// Preallocate output tensors and bind them to a session
+  ///
+  /// [sessionId] is the ID of the session to bind outputs for
+  /// [outputNames] is an optional list of outputs to bind, all outputs are bound if omitted
+  Future<Map<String, dynamic>> bindOutputs(String sessionId, {List<String>? outputNames}) {
+    throw UnimplementedError('bindOutputs() has not been implemented.');
+  }
+
+  /// Run inference on a session, writing the outputs into the bound output tensors
+  ///
+  /// [sessionId] is the ID of the session to run inference on
+  /// [inputs] is a map of input names to OrtValue objects
+  /// [runOptions] is an optional map of run options
+  Future<Map<String, dynamic>> runWithBinding(
+    String sessionId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) {
+    throw UnimplementedError('runWithBinding() has not been implemented.');
+  }
+
+  /// Drop the output binding of a session
+  ///
+  /// [sessionId] is the ID of the session to unbind outputs for
+  Future<void> unbindOutputs(String sessionId) {
+    throw UnimplementedError('unbindOutputs() has not been implemented.');
+  }
+
+  /// Feed outputs of a session back as its inputs on the next run, keeping them in native memory
+  ///
+  /// [sessionId] is the ID of the session
+  /// [loops] maps each output name to the name of the input it feeds, e.g. 'present.0.key' to 'past_key_values.0.key'
+  /// [initialDimensions] sizes the dynamic dimensions of the initial inputs by symbolic name; the others start at 0
+  Future<void> enableSequenceState(
+    String sessionId,
+    Map<String, String> loops, {
+    Map<String, int> initialDimensions = const {},
+  }) {
+    throw UnimplementedError('enableSequenceState() has not been implemented.');
+  }
+
+  /// Start a new sequence on a session with sequence state, from the initial inputs
+  ///
+  /// [sessionId] is the ID of the session
+  Future<void> resetSequenceState(String sessionId) {
+    throw UnimplementedError('resetSequenceState() has not been implemented.');
+  }
+
+  /// Stop feeding outputs of a session back and release the state it holds
+  ///
+  /// [sessionId] is the ID of the session
+  Future<void> disableSequenceState(String sessionId) {
+    throw UnimplementedError('disableSequenceState() has not been implemented.');
+  }
+
+  /// Start a native decode loop that generates tokens from a prompt
+  ///
+  /// [sessionId] is the ID of a decoder session
+  /// [prompt] holds the token ids of the prompt
+  /// [options] may hold 'maxTokens', 'stopTokens', 'temperature', 'topK', 'topP', 'seed' and the names
+  /// 'inputIdsName', 'attentionMaskName', 'positionIdsName' and 'logitsName'
+  ///
+  /// Returns a map with the ID of the generation under 'generationId'; its tokens follow on [generationEvents]
+  Future<Map<String, dynamic>> generate(String sessionId, List<int> prompt, {Map<String, dynamic>? options}) {
+    throw UnimplementedError('generate() has not been implemented.');
+  }
+
+  /// Stop a generation before its next token; it still sends its final event
+  ///
+  /// [generationId] is the ID of the generation
+  Future<void> cancelGeneration(String generationId) {
+    throw UnimplementedError('cancelGeneration() has not been implemented.');
+  }
+
+  /// Events of every generation: 'generationId' and either 'token', or 'done' with the 'reason' the generation
+  /// ended ('stop', 'length' or 'cancelled'), or 'error'
+  Stream<Map<String, dynamic>> get generationEvents {
+    throw UnimplementedError('generationEvents has not been implemented.');
+  }
+
+  /// Create a pipeline of sessions and glue ops that runs natively in one call
+  ///
+  /// [stages] are the maps of [OrtPipelineStage.toMap], in any order
+  /// [outputs] maps each pipeline output name to the "stage/output" value it returns
+  ///
+  /// Returns a map with the ID of the pipeline under 'pipelineId'
+  Future<Map<String, dynamic>> createPipeline(List<Map<String, dynamic>> stages, Map<String, String> outputs) {
+    throw UnimplementedError('createPipeline() has not been implemented.');
+  }
+
+  /// Run every stage of a pipeline and return its outputs only
+  ///
+  /// [pipelineId] is the ID of the pipeline to run
+  /// [inputs] is a map of pipeline input names to OrtValue objects
+  /// [runOptions] is an optional map of run options applied to every session of the pipeline
+  Future<Map<String, dynamic>> runPipeline(
+    String pipelineId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) {
+    throw UnimplementedError('runPipeline() has not been implemented.');
+  }
+
+  /// Close a pipeline; its sessions stay open
+  ///
+  /// [pipelineId] is the ID of the pipeline to close
+  Future<void> closePipeline(String pipelineId) {
+    throw UnimplementedError('closePipeline() has not been implemented.');
+  }
+
+  /// Run a built-in glue op of a pipeline on its own on stored tensors and return its outputs only
+  ///
+  /// [op] is one of 'softmax', 'sigmoid', 'argmax', 'topK', 'nms', 'slice' or 'cropResize'
+  /// [inputs] is a map of op input names to OrtValue objects
+  /// [params] are the parameters of the op, as in [OrtPipelineStage.params]
+  ///
+  /// Returns a map of op output names to [valueId, dataType, shape] lists
+  Future<Map<String, dynamic>> runTensorOp(
+    String op,
+    Map<String, OrtValue> inputs, {
+    Map<String, Object> params = const {},
+  }) {
+    throw UnimplementedError('runTensorOp() has not been implemented.');
+  }
+
+  /// Open a stream of frames through a session, with [depth] preallocated slots of inputs and outputs
+  ///
+  /// [sessionId] is the ID of the session, whose inputs must have fixed shapes
+  ///
+  /// Returns a map with the ID of the stream under 'streamId'
+  Future<Map<String, dynamic>> openStream(String sessionId, {int depth = 2}) {
+    throw UnimplementedError('openStream() has not been implemented.');
+  }
+
+  /// Copy the inputs of a frame into a free slot of a stream and queue its run
+  ///
+  /// [streamId] is the ID of the stream
+  /// [inputs] maps every input name to the element data of the input
+  /// [runOptions] is an optional map of run options
+  ///
+  /// Returns a map with the number of the frame under 'frame'; its outputs follow on [streamEvents]
+  Future<Map<String, dynamic>> submitStreamFrame(
+    String streamId,
+    Map<String, TypedData> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) {
+    throw UnimplementedError('submitStreamFrame() has not been implemented.');
+  }
+
+  /// Close a stream; frames in flight still deliver their events
+  ///
+  /// [streamId] is the ID of the stream to close
+  Future<void> closeStream(String streamId) {
+    throw UnimplementedError('closeStream() has not been implemented.');
+  }
+
+  /// Events of every open stream, one per frame: 'streamId', 'frame' and either 'outputs', mapping output names to
+  /// maps of 'data', 'dataType' and 'shape', or 'error'
+  Stream<Map<String, dynamic>> get streamEvents {
+    throw UnimplementedError('streamEvents has not been implemented.');
+  }
+
+  /// Set the number of native worker threads that run inference
+  ///
+  /// [numThreads] is the number of inferences that can run concurrently off
+  /// the platform thread
+  Future<void> setInferenceThreads(int numThreads) {
+    throw UnimplementedError('setInferenceThreads() has not been implemented.');
+  }
+
+  /// Get the counters of the queues of inference calls waiting for a worker thread
+  ///
+  /// Returns a map from each priority name ('high', 'normal' and 'low') to a map of its counters
+  Future<Map<String, dynamic>> getQueueStats() {
+    throw UnimplementedError('getQueueStats() has not been implemented.');
+  }
+
+  /// Terminate the running and queued inference calls of low priority
+  ///
+  /// Returns the number of calls terminated
+  Future<int> cancelLowPriorityRuns() {
+    throw UnimplementedError('cancelLowPriorityRuns() has not been implemented.');
+  }
+
+  /// Stop the inference calls in flight that were submitted with a run tag
+  ///
+  /// [runTag] is the runTag entry of the run options of the calls
+  ///
+  /// Returns false if no call with the tag is in flight
+  Future<bool> cancelRun(String runTag) {
+    throw UnimplementedError('cancelRun() has not been implemented.');
+  }
+
+  /// Choose how the platform sends new session and value IDs
+  ///
+  /// [enabled] selects integer handles instead of string IDs
+  Future<void> setIntegerHandles(bool enabled) {
+    throw UnimplementedError('setIntegerHandles() has not been implemented.');
+  }
+
+  /// Limit the cache of loaded models shared by sessions created with the same model and options
+  ///
+  /// [maxSessions] is the number of models to keep loaded, 0 for no limit
+  /// [maxBytes] is the total model file size to keep loaded, 0 for no limit; both 0 disable the cache
+  Future<void> configureSessionCache({required int maxSessions, required int maxBytes}) {
+    throw UnimplementedError('configureSessionCache() has not been implemented.');
+  }
+
+  /// Run every session on thread pools shared by all sessions instead of pools of their own
+  ///
+  /// [intraOpNumThreads] and [interOpNumThreads] size the shared pools, 0 letting ONNX Runtime choose
+  /// [allowSpinning] lets idle threads spin before sleeping
+  /// [intraOpThreadAffinity] pins the intra-op threads to processors in ONNX Runtime's affinity syntax
+  Future<void> configureThreadPools({
+    required int intraOpNumThreads,
+    required int interOpNumThreads,
+    bool allowSpinning = true,
+    String? intraOpThreadAffinity,
+  }) {
+    throw UnimplementedError('configureThreadPools() has not been implemented.');
+  }
+
+  /// Register a CPU arena that every session created afterwards allocates from instead of an arena of its own
+  ///
+  /// [maxBytes] is the most the arena reserves, 0 letting ONNX Runtime choose
+  /// [extendStrategy] is 'nextPowerOfTwo' or 'sameAsRequested', null letting ONNX Runtime choose
+  /// [initialChunkBytes] is the size of the first chunk the arena reserves
+  /// [maxDeadBytesPerChunk] is the unused bytes in a chunk above which it is split
+  Future<void> configureSharedArena({
+    int maxBytes = 0,
+    String? extendStrategy,
+    int? initialChunkBytes,
+    int? maxDeadBytesPerChunk,
+  }) {
+    throw UnimplementedError('configureSharedArena() has not been implemented.');
+  }
+
+  /// Gather concurrent inference calls of a session into batches
+  ///
+  /// [sessionId] is the ID of the session to batch
+  /// [windowMicros] is the longest time in microseconds a call waits for others to join its batch
+  /// [maxBatchSize] is the number of calls after which a batch runs at once, below 2 disables batching
+  Future<void> configureBatching(String sessionId, {required int windowMicros, required int maxBatchSize}) {
+    throw UnimplementedError('configureBatching() has not been implemented.');
+  }
+
+  /// Get the micro-batching statistics of a session
+  ///
+  /// [sessionId] is the ID of the session to get statistics for
+  ///
+  /// Returns the queue depth, the number of batched requests and batches, and a histogram of batch sizes
+  Future<Map<String, dynamic>> getBatchingStats(String sessionId) {
+    throw UnimplementedError('getBatchingStats() has not been implemented.');
+  }
+
+  /// Get the run counters and latency percentiles of a session
+  ///
+  /// [sessionId] is the ID of the session
+  Future<Map<String, dynamic>> getSessionStats(String sessionId) {
+    throw UnimplementedError('getSessionStats() has not been implemented.');
+  }
+
+  /// Get the memory held by live native tensors, the buffer pool and the sequence state of sessions
+  ///
+  /// Returns the tensor count, host bytes in total and by data type, device bytes, the hard limit, the buffer pool
+  /// occupancy under 'bufferPool' and a list of {sessionId, sequenceStateBytes} maps under 'sessions'
+  Future<Map<String, dynamic>> getMemoryStats() {
+    throw UnimplementedError('getMemoryStats() has not been implemented.');
+  }
+
+  /// Set the host bytes of live tensors above which creating a tensor from Dart fails
+  ///
+  /// [hardLimitBytes] is the limit, 0 for none
+  Future<void> setMemoryLimit(int hardLimitBytes) {
+    throw UnimplementedError('setMemoryLimit() has not been implemented.');
+  }
+
+  /// Stop profiling a session and summarize its trace
+  ///
+  /// [sessionId] is the ID of a session created with profiling enabled
+  ///
+  /// Returns a map with the trace file path under 'profilePath', the total kernel time under 'totalMicros',
+  /// and lists of per-node and per-operator entries under 'nodes' and 'ops'
+  Future<Map<String, dynamic>> endProfiling(String sessionId) {
+    throw UnimplementedError('endProfiling() has not been implemented.');
+  }
+
+  /// Start recording the spans of the native trace points, dropping those recorded before
+  Future<void> startTracing() {
+    throw UnimplementedError('startTracing() has not been implemented.');
+  }
+
+  /// Stop recording native trace spans and write them to a Chrome trace file
+  ///
+  /// [path] is the file to write, a new file in an app cache directory if null
+  ///
+  /// Returns a map with the file path under 'tracePath' and the number of spans under 'spans'
+  Future<Map<String, dynamic>> stopTracing({String? path}) {
+    throw UnimplementedError('stopTracing() has not been implemented.');
+  }
+
+  /// Get the native addresses used to read tensor memory over dart:ffi
+  ///
+  /// Returns a map with the address of the native tensor manager under 'tensorManager' on Linux and Windows,
+  /// and an empty map on platforms without a dart:ffi data plane
+  Future<Map<String, dynamic>> getNativeContext() {
+    throw UnimplementedError('getNativeContext() has not been implemented.');
+  }
+
   /// Close a session
   ///
   /// [sessionId] is the ID of the session to close
@@ -103,6 +445,28 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
     throw UnimplementedError('createOrtValue() has not been implemented.');
   }
 
+  /// Creates a normalized 3-channel RGB tensor from an image in one native pass
+  ///
+  /// [data] holds the pixels in [format] ('rgba', 'bgra', 'rgb', 'bgr' or 'nv21')
+  /// [width] and [height] are the size of the image
+  /// [targetWidth] and [targetHeight] resize the image with bilinear filtering when given
+  /// [mean] and [std] are the per-channel mean and standard deviation of pixel values scaled to [0, 1]
+  /// [layout] is 'nchw' or 'nhwc' and [dataType] 'float32' or 'float16'
+  Future<Map<String, dynamic>> createImageTensor(
+    Uint8List data, {
+    required String format,
+    required int width,
+    required int height,
+    int? targetWidth,
+    int? targetHeight,
+    List<double>? mean,
+    List<double>? std,
+    required String layout,
+    required String dataType,
+  }) {
+    throw UnimplementedError('createImageTensor() has not been implemented.');
+  }
+
   /// Converts an OrtValue to a different data type
   ///
   /// [valueId] is the ID of the OrtValue to convert
@@ -111,6 +475,67 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
     throw UnimplementedError('convertOrtValue() has not been implemented.');
   }
 
+  /// Quantizes an OrtValue into a new int8 or uint8 OrtValue
+  ///
+  /// [valueId] is the ID of the OrtValue to quantize
+  /// [scales] holds one scale for the whole tensor, or one per index along [axis]
+  /// [zeroPoints] holds the zero point of each scale, or nothing for zero points of 0
+  /// [dataType] is the quantized data type, 'int8' or 'uint8'
+  Future<Map<String, dynamic>> quantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+    required String dataType,
+  }) {
+    throw UnimplementedError('quantizeOrtValue() has not been implemented.');
+  }
+
+  /// Dequantizes an int8 or uint8 OrtValue into a new float32 OrtValue
+  ///
+  /// The arguments are those of [quantizeOrtValue]; the quantized type is the type of the OrtValue
+  Future<Map<String, dynamic>> dequantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+  }) {
+    throw UnimplementedError('dequantizeOrtValue() has not been implemented.');
+  }
+
+  /// Reshapes an OrtValue into a new OrtValue that shares its data
+  ///
+  /// [valueId] is the ID of the OrtValue to reshape
+  /// [shape] is the new shape, where 0 keeps a dimension and one -1 is inferred as in the ONNX Reshape op
+  Future<Map<String, dynamic>> reshapeOrtValue(String valueId, List<int> shape) {
+    throw UnimplementedError('reshapeOrtValue() has not been implemented.');
+  }
+
+  /// Slices an OrtValue along one axis into a new OrtValue
+  ///
+  /// [valueId] is the ID of the OrtValue to slice
+  /// [axis] is the axis to slice, negative values counting from the end
+  /// [start] and [end] bound the slice as in the ONNX Slice op; without [end], the single index [start] is taken and
+  /// the axis is dropped
+  Future<Map<String, dynamic>> sliceOrtValue(String valueId, int axis, int start, [int? end]) {
+    throw UnimplementedError('sliceOrtValue() has not been implemented.');
+  }
+
+  /// Permutes the axes of an OrtValue into a new OrtValue
+  ///
+  /// [valueId] is the ID of the OrtValue to transpose
+  /// [perm] gives the source axis of every axis of the result, or reverses the axes if null
+  Future<Map<String, dynamic>> transposeOrtValue(String valueId, [List<int>? perm]) {
+    throw UnimplementedError('transposeOrtValue() has not been implemented.');
+  }
+
+  /// Concatenates OrtValues of one type along an axis into a new OrtValue
+  ///
+  /// [valueIds] are the IDs of the OrtValues to concatenate, which match in every dimension but [axis]
+  Future<Map<String, dynamic>> concatOrtValues(List<String> valueIds, int axis) {
+    throw UnimplementedError('concatOrtValues() has not been implemented.');
+  }
+
   /// Gets the data from an OrtValue
   ///
   /// [valueId] is the ID of the OrtValue to get data from
@@ -124,4 +549,11 @@ abstract class FlutterOnnxruntimePlatform extends PlatformInterface {
   Future<void> releaseOrtValue(String valueId) {
     throw UnimplementedError('releaseOrtValue() has not been implemented.');
   }
+
+  /// Releases native resources associated with several OrtValues in one call
+  ///
+  /// [valueIds] are the IDs of the OrtValues to release; unknown IDs are skipped
+  Future<void> releaseOrtValues(List<String> valueIds) {
+    throw UnimplementedError('releaseOrtValues() has not been implemented.');
+  }
 }
@@ -6,22 +6,44 @@
 
 // ignore_for_file: constant_identifier_names
 
+import 'dart:async';
 import 'dart:io';
 import 'package:flutter/services.dart';
 import 'package:flutter/foundation.dart';
 import 'package:path_provider/path_provider.dart';
 
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_isolate_stub.dart'
+    if (dart.library.ffi) 'package:flutter_onnxruntime/src/ort_isolate.dart';
+import 'package:flutter_onnxruntime/src/ort_memory_stats.dart';
+import 'package:flutter_onnxruntime/src/ort_pipeline.dart';
 import 'package:flutter_onnxruntime/src/ort_provider.dart';
+import 'package:flutter_onnxruntime/src/ort_provider_selector.dart';
+import 'package:flutter_onnxruntime/src/ort_queue_stats.dart';
 import 'package:flutter_onnxruntime/src/ort_session.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart';
 
 class OnnxRuntime {
+  // Shared by every instance so that providers chosen for a model are remembered for the whole app
+  static final OrtProviderSelector _providerSelector = OrtProviderSelector();
+
   Future<String?> getPlatformVersion() {
     return FlutterOnnxruntimePlatform.instance.getPlatformVersion();
   }
 
   /// Create an ONNX Runtime session with the given model path
+  ///
+  /// With [OrtProvider.AUTO] in [OrtSessionOptions.providers], the first session of a model times a few runs on
+  /// every available provider and uses the fastest one whose outputs match the CPU provider's. The choice is
+  /// remembered per model content and device, across app launches except on web.
   Future<OrtSession> createSession(String modelPath, {OrtSessionOptions? options}) async {
+    if (_isAutoProvider(options)) {
+      Future<OrtSession> create(OrtSessionOptions resolved) => createSession(modelPath, options: resolved);
+      return kIsWeb
+          ? _providerSelector.createSessionFromAssetKey(modelPath, options!, create)
+          : _providerSelector.createSessionFromFile(modelPath, options!, create);
+    }
+
     final result = await FlutterOnnxruntimePlatform.instance.createSession(
       modelPath,
       sessionOptions: options?.toMap() ?? {},
@@ -39,6 +61,25 @@ class OnnxRuntime {
       // The web implementation will handle loading from asset properly
       return createSession(assetKey, options: options);
     } else {
+      // Linux and Windows bundles keep assets as plain files, which are memory-mapped instead of copied
+      if (Platform.isLinux || Platform.isWindows) {
+        final bundledFile = File(_bundledAssetPath(assetKey));
+        if (await bundledFile.exists()) {
+          Future<OrtSession> create(OrtSessionOptions? resolved) async {
+            final result = await FlutterOnnxruntimePlatform.instance.createSessionFromMappedFile(
+              bundledFile.path,
+              sessionOptions: resolved?.toMap() ?? {},
+            );
+            return OrtSession.fromMap(result);
+          }
+
+          if (_isAutoProvider(options)) {
+            return _providerSelector.createSessionFromFile(bundledFile.path, options!, create);
+          }
+          return create(options);
+        }
+      }
+
       // Native platforms implementation (iOS, Android, etc)
       // Get the temporary directory
       final directory = await getTemporaryDirectory();
@@ -73,6 +114,58 @@ class OnnxRuntime {
     }
   }
 
+  /// Create an ONNX Runtime session from the bytes of a model
+  ///
+  /// Linux and Windows build the session directly from [modelData], for
+  /// example a model downloaded or decrypted in memory. Other platforms write
+  /// it to a temporary file that is deleted once the session is created.
+  /// Sessions created this way are not kept in the session cache and do not
+  /// cache their optimized graph.
+  Future<OrtSession> createSessionFromBuffer(Uint8List modelData, {OrtSessionOptions? options}) async {
+    if (_isAutoProvider(options)) {
+      return _providerSelector.createSessionFromBuffer(
+        modelData,
+        options!,
+        (resolved) => createSessionFromBuffer(modelData, options: resolved),
+      );
+    }
+
+    try {
+      final result = await FlutterOnnxruntimePlatform.instance.createSessionFromBuffer(
+        modelData,
+        sessionOptions: options?.toMap() ?? {},
+      );
+      return OrtSession.fromMap(result);
+    } on MissingPluginException {
+      final directory = await getTemporaryDirectory();
+      final file = File(
+        '${directory.path}${Platform.pathSeparator}flutter_onnxruntime_${DateTime.now().microsecondsSinceEpoch}.onnx',
+      );
+      await file.writeAsBytes(modelData, flush: true);
+      try {
+        return await createSession(file.path, options: options);
+      } finally {
+        await file.delete();
+      }
+    }
+  }
+
+  /// Forget the providers chosen by [OrtProvider.AUTO], so that they are measured again for the next session
+  Future<void> clearProviderSelectionCache() async {
+    await _providerSelector.clearCache();
+  }
+
+  static bool _isAutoProvider(OrtSessionOptions? options) {
+    return options?.providers?.contains(OrtProvider.AUTO) ?? false;
+  }
+
+  /// Path of an asset in the flutter_assets directory next to a Linux or Windows executable
+  String _bundledAssetPath(String assetKey) {
+    final separator = Platform.pathSeparator;
+    final bundleDirectory = File(Platform.resolvedExecutable).parent.path;
+    return '$bundleDirectory${separator}data${separator}flutter_assets$separator${assetKey.replaceAll('/', separator)}';
+  }
+
   /// Extracts a bundled asset to [destination] atomically.
   ///
   /// The bytes are written to a sibling temporary file first and then renamed
@@ -98,6 +191,278 @@ class OnnxRuntime {
     }
   }
 
+  /// Set the number of native worker threads used to run inference
+  ///
+  /// On Linux, Windows and Android, [OrtSession.run] executes on a pool of
+  /// worker threads so the platform thread stays responsive. [numThreads]
+  /// bounds how many runs can execute concurrently (default 2). iOS and macOS
+  /// run each session on a concurrent queue of its own and ignore this setting.
+  Future<void> setInferenceThreads(int numThreads) async {
+    if (numThreads < 1) {
+      throw ArgumentError.value(numThreads, 'numThreads', 'must be a positive integer');
+    }
+    await FlutterOnnxruntimePlatform.instance.setInferenceThreads(numThreads);
+  }
+
+  /// Get how long inference calls of each [OrtRunPriority] waited for a worker thread
+  ///
+  /// Calls given an [OrtRunOptions.priority] wait in the queue of that priority until one of the
+  /// [setInferenceThreads] workers is free. Only Linux and Windows queue calls by priority; other
+  /// platforms throw an [UnsupportedError].
+  Future<Map<OrtRunPriority, OrtQueueStats>> getQueueStats() async {
+    final statsMap = await FlutterOnnxruntimePlatform.instance.getQueueStats();
+    return {
+      for (final priority in OrtRunPriority.values)
+        priority: OrtQueueStats.fromMap(Map<String, dynamic>.from(statsMap[priority.name] as Map? ?? {})),
+    };
+  }
+
+  /// Terminate every inference call of [OrtRunPriority.low], running or queued
+  ///
+  /// Running calls stop as if [OrtRunOptions.terminate] had been set, and each call fails with a
+  /// `PlatformException` of code `RUN_PREEMPTED`. Returns the number of calls terminated, always 0
+  /// on platforms other than Linux and Windows.
+  Future<int> cancelLowPriorityRuns() async {
+    return FlutterOnnxruntimePlatform.instance.cancelLowPriorityRuns();
+  }
+
+  /// Let a background isolate call the plugin, given the `RootIsolateToken.instance` of the root isolate
+  ///
+  /// Call this once at the start of an isolate spawned with `Isolate.spawn`, before any other call. The sessions and
+  /// tensors live in native memory shared by every isolate, so [OrtSession]s and [OrtValue]s sent from another
+  /// isolate work right away; see [OrtValue.transfer] for moving the duty of releasing a value along with it.
+  /// `OrtStream`s and [OrtSession.generate] deliver their outputs to the root isolate only. Not available on web.
+  static void initializeBackgroundIsolate(RootIsolateToken token) {
+    BackgroundIsolateBinaryMessenger.ensureInitialized(token);
+  }
+
+  /// Run [computation] on a new background isolate that can call the plugin, and return its result
+  ///
+  /// Keeps pre-processing, inference and post-processing off the root isolate, so that it only does UI:
+  ///
+  /// ```dart
+  /// final labels = await OnnxRuntime.runInBackground(() async {
+  ///   final input = await OrtValue.fromList(preprocess(image), [1, 3, 224, 224]);
+  ///   final outputs = await session.run({'input': input});
+  ///   return decode(await outputs['logits']!.asTypedData());
+  /// });
+  /// ```
+  ///
+  /// Must be called from the root isolate. [computation] is sent to the new isolate and its result sent back, so
+  /// both may only hold sendable objects, such as sessions, OrtValues, lists and typed data. OrtValues sent to the
+  /// isolate stay owned by this one, which must keep them reachable until [computation] completes. OrtValues in the
+  /// result, on their own or in lists, sets and maps, are handed over to this isolate with [OrtValue.transfer] and
+  /// [OrtValue.adopt]; every other value [computation] creates is released when it completes. Not available on
+  /// web.
+  static Future<R> runInBackground<R>(FutureOr<R> Function() computation, {String? debugName}) async {
+    if (kIsWeb) {
+      throw UnsupportedError('Background isolates are not available on the web');
+    }
+    final token = RootIsolateToken.instance;
+    if (token == null) {
+      throw StateError('runInBackground() must be called from the root isolate');
+    }
+    final result = await runInIsolate(() async {
+      initializeBackgroundIsolate(token);
+      // Garbage collection does not release the values of an isolate that exits, so the scope releases them
+      final scope = OrtValue.beginScope();
+      final R value;
+      try {
+        value = await computation();
+      } catch (_) {
+        await scope.end();
+        rethrow;
+      }
+      final returnedIds = <String>{};
+      visitOrtValues(value, (ortValue) => returnedIds.add(ortValue.transfer().id));
+      for (final ortValue in scope.values) {
+        if (returnedIds.contains(ortValue.id)) {
+          scope.keep(ortValue);
+        }
+      }
+      await scope.end();
+      return value;
+    }, debugName: debugName);
+    visitOrtValues(result, (ortValue) => ortValue.adopt());
+    return result;
+  }
+
+  /// Send session and value IDs between Dart and the platform as integer handles
+  ///
+  /// By default the platforms identify sessions and [OrtValue]s with string
+  /// IDs that are hashed on every call. With integer handles enabled, newly
+  /// created sessions and values get 64-bit handles that Linux and Windows
+  /// look up directly in a slot table, which makes each call cheaper. The
+  /// Dart API is unchanged: [OrtSession.id] and [OrtValue.id] stay Strings.
+  /// Existing IDs keep working after switching, so this can be called at any
+  /// time, though calling it once at startup is recommended.
+  Future<void> setIntegerHandles(bool enabled) async {
+    await FlutterOnnxruntimePlatform.instance.setIntegerHandles(enabled);
+  }
+
+  /// Keep loaded models around so that creating a session again is instant
+  ///
+  /// On Linux and Windows, sessions created from the same model file with the
+  /// same [OrtSessionOptions] share one loaded model while it is cached. A
+  /// model is identified by its path, modification time and size, so a model
+  /// file that changes on disk is loaded again. Closing a session only drops
+  /// its reference; the model stays loaded while it is cached or used by other
+  /// sessions. The least recently used models are dropped beyond [maxSessions]
+  /// models or, if given, [maxBytes] bytes of model files. Other platforms
+  /// ignore this setting.
+  Future<void> enableSessionCache({int maxSessions = 4, int? maxBytes}) async {
+    if (maxSessions < 1) {
+      throw ArgumentError.value(maxSessions, 'maxSessions', 'must be a positive integer');
+    }
+    if (maxBytes != null && maxBytes < 1) {
+      throw ArgumentError.value(maxBytes, 'maxBytes', 'must be a positive integer');
+    }
+    await FlutterOnnxruntimePlatform.instance.configureSessionCache(maxSessions: maxSessions, maxBytes: maxBytes ?? 0);
+  }
+
+  /// Stop caching loaded models and drop those no session uses anymore
+  Future<void> disableSessionCache() async {
+    await FlutterOnnxruntimePlatform.instance.configureSessionCache(maxSessions: 0, maxBytes: 0);
+  }
+
+  /// Share one set of thread pools between all sessions
+  ///
+  /// On Linux and Windows, every session normally starts intra-op and
+  /// inter-op thread pools of its own, so several open sessions can run many
+  /// more threads than there are cores. After this call, sessions run on
+  /// pools shared through the ONNX Runtime environment instead, sized by
+  /// [intraOpNumThreads] and [interOpNumThreads] (0 lets ONNX Runtime choose)
+  /// and ignoring [OrtSessionOptions.intraOpNumThreads] and
+  /// [OrtSessionOptions.interOpNumThreads]. [allowSpinning] lets idle threads
+  /// spin briefly before sleeping, trading CPU time for latency.
+  /// [intraOpThreadAffinity] pins the intra-op threads to processors using
+  /// ONNX Runtime's syntax, for example `"1,2;3,4"` for two threads besides
+  /// the calling one.
+  ///
+  /// Must be called before the first session is created; calling it again
+  /// later with the same settings does nothing, and with other settings
+  /// throws. Other platforms ignore this setting.
+  Future<void> configureThreadPools({
+    int intraOpNumThreads = 0,
+    int interOpNumThreads = 0,
+    bool allowSpinning = true,
+    String? intraOpThreadAffinity,
+  }) async {
+    if (intraOpNumThreads < 0) {
+      throw ArgumentError.value(intraOpNumThreads, 'intraOpNumThreads', 'must not be negative');
+    }
+    if (interOpNumThreads < 0) {
+      throw ArgumentError.value(interOpNumThreads, 'interOpNumThreads', 'must not be negative');
+    }
+    await FlutterOnnxruntimePlatform.instance.configureThreadPools(
+      intraOpNumThreads: intraOpNumThreads,
+      interOpNumThreads: interOpNumThreads,
+      allowSpinning: allowSpinning,
+      intraOpThreadAffinity: intraOpThreadAffinity,
+    );
+  }
+
+  /// Let every session allocate from one CPU arena instead of each reserving an arena of its own
+  ///
+  /// On Linux and Windows, every session normally keeps an arena that holds on to the most memory its runs ever
+  /// needed, so several open sessions can hold several peaks at once. After this call, sessions share an arena
+  /// registered with the ONNX Runtime environment instead, and ignore [OrtSessionOptions.useArena].
+  /// [maxBytes] bounds what it reserves (0 lets ONNX Runtime choose), [extendStrategy] sets how it grows, and
+  /// [initialChunkBytes] and [maxDeadBytesPerChunk] tune its chunks.
+  ///
+  /// Must be called before the sessions that should share the arena are created, and after
+  /// [configureThreadPools] if both are used. Calling it again with the same settings does nothing, and with other
+  /// settings throws. Other platforms ignore this setting.
+  Future<void> configureSharedArena({
+    int maxBytes = 0,
+    OrtArenaExtendStrategy? extendStrategy,
+    int? initialChunkBytes,
+    int? maxDeadBytesPerChunk,
+  }) async {
+    if (maxBytes < 0) {
+      throw ArgumentError.value(maxBytes, 'maxBytes', 'must not be negative');
+    }
+    await FlutterOnnxruntimePlatform.instance.configureSharedArena(
+      maxBytes: maxBytes,
+      extendStrategy: extendStrategy?.name,
+      initialChunkBytes: initialChunkBytes,
+      maxDeadBytesPerChunk: maxDeadBytesPerChunk,
+    );
+  }
+
+  /// Start recording the plugin's native trace points
+  ///
+  /// On Linux and Windows, the plugin's hot path (decoding and encoding
+  /// tensors on the method channel, `Session::Run`, storing and cloning
+  /// tensors, and waits for the locks of the session and tensor managers) is
+  /// instrumented with trace points that cost a single check while tracing is
+  /// off. Spans recorded before are dropped. Other platforms ignore this call.
+  Future<void> startNativeTracing() async {
+    await FlutterOnnxruntimePlatform.instance.startTracing();
+  }
+
+  /// Stop recording native trace points and write the spans to a file
+  ///
+  /// The file is in the Chrome trace format read by Perfetto and
+  /// chrome://tracing, and is written to [path] or to a new file in an app
+  /// cache directory. Each thread keeps its latest 16384 spans. Returns the
+  /// path of the file, or null on platforms without native trace points.
+  Future<String?> stopNativeTracing({String? path}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.stopTracing(path: path);
+    return result['tracePath'] as String?;
+  }
+
+  /// Get the memory held by native tensors and the sequence state of sessions
+  ///
+  /// Counts every live tensor of the plugin, whether created from Dart or returned by a run, along with the pool of
+  /// buffers behind tensors created from Dart and the sequence state, such as a key/value cache, of each session.
+  /// The arenas ONNX Runtime runs models in are not included, as ONNX Runtime does not report how much of them is
+  /// in use. Only Linux and Windows keep these statistics; other platforms throw an [UnsupportedError].
+  /// [OrtValue.trackedBytes] counts the tensors Dart still refers to on every platform.
+  Future<OrtMemoryStats> getMemoryStats() async {
+    return OrtMemoryStats.fromMap(await FlutterOnnxruntimePlatform.instance.getMemoryStats());
+  }
+
+  /// Make creating tensors fail once live tensors hold [hardLimitBytes] of host memory
+  ///
+  /// Creating a tensor with [OrtValue.fromList], [OrtValue.fromBytes], [OrtValue.fromImage] or [OrtValue.to] then
+  /// throws if it would take the host bytes of all live tensors above the limit. Outputs of runs are never rejected,
+  /// as failing a run would not free anything. A null limit removes it. Only Linux and Windows enforce a limit;
+  /// other platforms throw an [UnsupportedError]. See [OrtValue.setSoftMemoryLimit] for a limit that only warns.
+  Future<void> setMemoryLimit(int? hardLimitBytes) async {
+    if (hardLimitBytes != null && hardLimitBytes < 1) {
+      throw ArgumentError.value(hardLimitBytes, 'hardLimitBytes', 'must be a positive integer');
+    }
+    await FlutterOnnxruntimePlatform.instance.setMemoryLimit(hardLimitBytes ?? 0);
+  }
+
+  /// Create a pipeline that runs several sessions and glue ops natively in one call
+  ///
+  /// [stages] may be listed in any order; each runs once the stages it reads from have run.
+  /// [outputs] maps each pipeline output name to the `'stage/output'` value it returns.
+  /// Only Linux and Windows run pipelines; other platforms throw an [UnsupportedError].
+  ///
+  /// Example:
+  /// ```dart
+  /// final pipeline = await onnxRuntime.createPipeline(
+  ///   [
+  ///     OrtPipelineStage.session('detect', detector, inputs: {'images': 'image'}),
+  ///     OrtPipelineStage.nms('nms', boxes: 'detect/boxes', scores: 'detect/scores', maxDetections: 10),
+  ///     OrtPipelineStage.cropResize('crop', image: 'image', boxes: 'nms/boxes', height: 64, width: 64),
+  ///     OrtPipelineStage.session('classify', classifier, inputs: {'input': 'crop/output'}),
+  ///     OrtPipelineStage.argmax('label', input: 'classify/logits'),
+  ///   ],
+  ///   outputs: {'boxes': 'nms/boxes', 'labels': 'label/output'},
+  /// );
+  /// final outputs = await pipeline.run({'image': imageTensor});
+  /// ```
+  Future<OrtPipeline> createPipeline(List<OrtPipelineStage> stages, {required Map<String, String> outputs}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.createPipeline([
+      for (final stage in stages) stage.toMap(),
+    ], outputs);
+    return OrtPipeline.fromMap(result);
+  }
+
   /// Get the available providers
   ///
   /// Returns a list of the available providers
@@ -0,0 +1,56 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+class OrtBatchingStats {
+  /// Number of requests currently waiting for their batch
+  final int queueDepth;
+
+  /// Largest number of requests that were waiting at once
+  final int maxQueueDepth;
+
+  /// Number of requests that ran in a batch so far
+  final int requests;
+
+  /// Number of batches that ran so far
+  final int batches;
+
+  /// `batchSizeHistogram[n]` is the number of batches that ran with `n` requests
+  final List<int> batchSizeHistogram;
+
+  OrtBatchingStats({
+    required this.queueDepth,
+    required this.maxQueueDepth,
+    required this.requests,
+    required this.batches,
+    required this.batchSizeHistogram,
+  });
+
+  factory OrtBatchingStats.fromMap(Map<String, dynamic> map) {
+    return OrtBatchingStats(
+      queueDepth: map['queueDepth'] as int? ?? 0,
+      maxQueueDepth: map['maxQueueDepth'] as int? ?? 0,
+      requests: map['requests'] as int? ?? 0,
+      batches: map['batches'] as int? ?? 0,
+      batchSizeHistogram: List<int>.from(map['batchSizeHistogram'] ?? []),
+    );
+  }
+
+  /// Average number of requests per batch, 0 if no batch ran yet
+  double get averageBatchSize => batches == 0 ? 0 : requests / batches;
+
+  /// Converts the statistics to a Map
+  ///
+  /// Returns a map representation of the batching statistics
+  Map<String, dynamic> toMap() {
+    return {
+      'queueDepth': queueDepth,
+      'maxQueueDepth': maxQueueDepth,
+      'requests': requests,
+      'batches': batches,
+      'batchSizeHistogram': batchSizeHistogram,
+    };
+  }
+}
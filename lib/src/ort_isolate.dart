@@ -0,0 +1,13 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:async';
+import 'dart:isolate';
+
+/// Run [computation] on a new isolate and return its result, see `Isolate.run`
+Future<R> runInIsolate<R>(FutureOr<R> Function() computation, {String? debugName}) {
+  return Isolate.run(computation, debugName: debugName);
+}
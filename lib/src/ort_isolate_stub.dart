@@ -0,0 +1,13 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:async';
+
+// Counterpart of ort_isolate.dart on the web, which has no isolates to run computations on
+
+Future<R> runInIsolate<R>(FutureOr<R> Function() computation, {String? debugName}) async {
+  throw UnsupportedError('Background isolates are not available on the web');
+}
@@ -0,0 +1,127 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+/// Occupancy of the pool of buffers that back tensors created from Dart
+class OrtBufferPoolStats {
+  /// Buffers served from a retained block
+  final int hits;
+
+  /// Buffers that had to be allocated
+  final int misses;
+
+  /// Bytes of freed blocks kept for reuse
+  final int retainedBytes;
+
+  /// Number of freed blocks kept for reuse
+  final int retainedBuffers;
+
+  /// Most bytes the pool keeps for reuse
+  final int maxRetainedBytes;
+
+  OrtBufferPoolStats({
+    required this.hits,
+    required this.misses,
+    required this.retainedBytes,
+    required this.retainedBuffers,
+    required this.maxRetainedBytes,
+  });
+
+  factory OrtBufferPoolStats.fromMap(Map<String, dynamic> map) {
+    return OrtBufferPoolStats(
+      hits: map['hits'] as int? ?? 0,
+      misses: map['misses'] as int? ?? 0,
+      retainedBytes: map['retainedBytes'] as int? ?? 0,
+      retainedBuffers: map['retainedBuffers'] as int? ?? 0,
+      maxRetainedBytes: map['maxRetainedBytes'] as int? ?? 0,
+    );
+  }
+
+  /// Converts the statistics to a Map
+  Map<String, dynamic> toMap() {
+    return {
+      'hits': hits,
+      'misses': misses,
+      'retainedBytes': retainedBytes,
+      'retainedBuffers': retainedBuffers,
+      'maxRetainedBytes': maxRetainedBytes,
+    };
+  }
+}
+
+class OrtMemoryStats {
+  /// Number of live native tensors, whether created from Dart or returned by runs
+  final int tensorCount;
+
+  /// Bytes of the live tensors in host memory, string tensors counted by the length of their strings
+  final int hostBytes;
+
+  /// [hostBytes] split by data type, keyed by names such as `float32`
+  final Map<String, int> hostBytesByType;
+
+  /// Bytes of the live tensors in device memory, e.g. outputs kept on a GPU
+  final int deviceBytes;
+
+  /// Number of released tensors whose memory is still borrowed, e.g. by a view of `OrtValue.asTypedData`
+  final int retiredCount;
+
+  /// Host bytes above which creating a tensor from Dart fails, 0 for no limit
+  final int hardLimitBytes;
+
+  /// Occupancy of the buffer pool
+  final OrtBufferPoolStats bufferPool;
+
+  /// Bytes of the sequence state, such as a key/value cache, of each session that has one, keyed by session ID
+  final Map<String, int> sequenceStateBytes;
+
+  OrtMemoryStats({
+    required this.tensorCount,
+    required this.hostBytes,
+    required this.hostBytesByType,
+    required this.deviceBytes,
+    required this.retiredCount,
+    required this.hardLimitBytes,
+    required this.bufferPool,
+    required this.sequenceStateBytes,
+  });
+
+  factory OrtMemoryStats.fromMap(Map<String, dynamic> map) {
+    final bytesByType = map['hostBytesByType'] as Map<Object?, Object?>? ?? {};
+    final sessions = map['sessions'] as List<Object?>? ?? [];
+    return OrtMemoryStats(
+      tensorCount: map['tensorCount'] as int? ?? 0,
+      hostBytes: map['hostBytes'] as int? ?? 0,
+      hostBytesByType: {for (final entry in bytesByType.entries) entry.key.toString(): entry.value as int},
+      deviceBytes: map['deviceBytes'] as int? ?? 0,
+      retiredCount: map['retiredCount'] as int? ?? 0,
+      hardLimitBytes: map['hardLimitBytes'] as int? ?? 0,
+      bufferPool: OrtBufferPoolStats.fromMap(
+        Map<String, dynamic>.from(map['bufferPool'] as Map<Object?, Object?>? ?? {}),
+      ),
+      sequenceStateBytes: {
+        for (final session in sessions.cast<Map<Object?, Object?>>())
+          (session['sessionId'] as Object).toString(): session['sequenceStateBytes'] as int,
+      },
+    );
+  }
+
+  /// Converts the statistics to a Map
+  ///
+  /// Returns a map representation of the memory statistics
+  Map<String, dynamic> toMap() {
+    return {
+      'tensorCount': tensorCount,
+      'hostBytes': hostBytes,
+      'hostBytesByType': hostBytesByType,
+      'deviceBytes': deviceBytes,
+      'retiredCount': retiredCount,
+      'hardLimitBytes': hardLimitBytes,
+      'bufferPool': bufferPool.toMap(),
+      'sessions': [
+        for (final entry in sequenceStateBytes.entries) {'sessionId': entry.key, 'sequenceStateBytes': entry.value},
+      ],
+    };
+  }
+}
@@ -0,0 +1,399 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:async';
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+
+typedef _LastErrorNative = Pointer<Uint8> Function();
+typedef _TensorCreateNative =
+    Uint64 Function(
+      Pointer<Void> context,
+      Int32 elementType,
+      Pointer<Uint8> data,
+      Size byteSize,
+      Pointer<Int64> shape,
+      Size rank,
+    );
+typedef _TensorCreate =
+    int Function(
+      Pointer<Void> context,
+      int elementType,
+      Pointer<Uint8> data,
+      int byteSize,
+      Pointer<Int64> shape,
+      int rank,
+    );
+typedef _TensorReleaseNative = Int32 Function(Pointer<Void> context, Uint64 tensorId);
+typedef _TensorRelease = int Function(Pointer<Void> context, int tensorId);
+typedef _TensorReleaseManyNative = Size Function(Pointer<Void> context, Pointer<Uint64> tensorIds, Size count);
+typedef _TensorReleaseMany = int Function(Pointer<Void> context, Pointer<Uint64> tensorIds, int count);
+typedef _TensorAcquireNative = Pointer<Void> Function(Pointer<Void> context, Uint64 tensorId);
+typedef _TensorAcquire = Pointer<Void> Function(Pointer<Void> context, int tensorId);
+typedef _LeaseDataNative = Pointer<Uint8> Function(Pointer<Void> lease);
+typedef _LeaseByteSizeNative = Size Function(Pointer<Void> lease);
+typedef _LeaseByteSize = int Function(Pointer<Void> lease);
+typedef _ReleaseNative = Void Function(Pointer<Void> handle);
+typedef _Release = void Function(Pointer<Void> handle);
+typedef _RunCallbackNative = Void Function(Uint64 tag, Pointer<Void> result);
+typedef _SessionRunAsyncNative =
+    Void Function(
+      Pointer<Void> context,
+      Uint64 sessionId,
+      Pointer<Uint32> inputIndices,
+      Pointer<Uint64> inputIds,
+      Size inputCount,
+      Pointer<Uint32> outputIndices,
+      Size outputCount,
+      Uint64 tag,
+      Pointer<NativeFunction<_RunCallbackNative>> callback,
+    );
+typedef _SessionRunAsync =
+    void Function(
+      Pointer<Void> context,
+      int sessionId,
+      Pointer<Uint32> inputIndices,
+      Pointer<Uint64> inputIds,
+      int inputCount,
+      Pointer<Uint32> outputIndices,
+      int outputCount,
+      int tag,
+      Pointer<NativeFunction<_RunCallbackNative>> callback,
+    );
+typedef _RunErrorNative = Pointer<Uint8> Function(Pointer<Void> result);
+typedef _RunCountNative = Size Function(Pointer<Void> result);
+typedef _RunCount = int Function(Pointer<Void> result);
+typedef _RunOutputIdNative = Uint64 Function(Pointer<Void> result, Size index);
+typedef _RunOutputTypeNative = Int32 Function(Pointer<Void> result, Size index);
+typedef _RunOutputRankNative = Size Function(Pointer<Void> result, Size index);
+typedef _RunOutputValue = int Function(Pointer<Void> result, int index);
+typedef _RunOutputShapeNative = Pointer<Int64> Function(Pointer<Void> result, Size index);
+typedef _RunOutputShape = Pointer<Int64> Function(Pointer<Void> result, int index);
+
+/// ONNXTensorElementDataType values of the OrtDataType names used on the method channel
+const Map<String, int> _elementTypes = {
+  'float32': 1,
+  'uint8': 2,
+  'int8': 3,
+  'uint16': 4,
+  'int16': 5,
+  'int32': 6,
+  'int64': 7,
+  'string': 8,
+  'bool': 9,
+  'float16': 10,
+  'float64': 11,
+  'uint32': 12,
+  'uint64': 13,
+  'complex64': 14,
+  'complex128': 15,
+  'bfloat16': 16,
+};
+
+final Map<int, String> _elementTypeNames = _elementTypes.map((name, type) => MapEntry(type, name));
+
+/// Bindings to the fort_* functions that the Linux and Windows plugins export (see native_api.h)
+class _NativeApi {
+  _NativeApi(DynamicLibrary library, this.context)
+    : lastError = library.lookupFunction<_LastErrorNative, _LastErrorNative>('fort_last_error', isLeaf: true),
+      tensorCreate = library.lookupFunction<_TensorCreateNative, _TensorCreate>('fort_tensor_create', isLeaf: true),
+      tensorRelease = library.lookupFunction<_TensorReleaseNative, _TensorRelease>('fort_tensor_release'),
+      tensorReleaseMany = library.lookupFunction<_TensorReleaseManyNative, _TensorReleaseMany>(
+        'fort_tensor_release_many',
+        isLeaf: true,
+      ),
+      tensorAcquire = library.lookupFunction<_TensorAcquireNative, _TensorAcquire>('fort_tensor_acquire'),
+      leaseData = library.lookupFunction<_LeaseDataNative, _LeaseDataNative>('fort_lease_data', isLeaf: true),
+      leaseByteSize = library.lookupFunction<_LeaseByteSizeNative, _LeaseByteSize>(
+        'fort_lease_byte_size',
+        isLeaf: true,
+      ),
+      leaseRelease = library.lookupFunction<_ReleaseNative, _Release>('fort_lease_release'),
+      leaseFinalizer = library.lookup<NativeFunction<_ReleaseNative>>('fort_lease_release'),
+      sessionRunAsync = library.lookupFunction<_SessionRunAsyncNative, _SessionRunAsync>(
+        'fort_session_run_async',
+        isLeaf: true,
+      ),
+      runError = library.lookupFunction<_RunErrorNative, _RunErrorNative>('fort_run_error', isLeaf: true),
+      runOutputCount = library.lookupFunction<_RunCountNative, _RunCount>('fort_run_output_count', isLeaf: true),
+      runOutputId = library.lookupFunction<_RunOutputIdNative, _RunOutputValue>('fort_run_output_id', isLeaf: true),
+      runOutputType = library.lookupFunction<_RunOutputTypeNative, _RunOutputValue>(
+        'fort_run_output_type',
+        isLeaf: true,
+      ),
+      runOutputRank = library.lookupFunction<_RunOutputRankNative, _RunOutputValue>(
+        'fort_run_output_rank',
+        isLeaf: true,
+      ),
+      runOutputShape = library.lookupFunction<_RunOutputShapeNative, _RunOutputShape>(
+        'fort_run_output_shape',
+        isLeaf: true,
+      ),
+      runRelease = library.lookupFunction<_ReleaseNative, _Release>('fort_run_release', isLeaf: true);
+
+  final Pointer<Void> context;
+  final _LastErrorNative lastError;
+  final _TensorCreate tensorCreate;
+  final _TensorRelease tensorRelease;
+  final _TensorReleaseMany tensorReleaseMany;
+  final _TensorAcquire tensorAcquire;
+  final _LeaseDataNative leaseData;
+  final _LeaseByteSize leaseByteSize;
+  final _Release leaseRelease;
+  final Pointer<NativeFinalizerFunction> leaseFinalizer;
+  final _SessionRunAsync sessionRunAsync;
+  final _RunErrorNative runError;
+  final _RunCount runOutputCount;
+  final _RunOutputValue runOutputId;
+  final _RunOutputValue runOutputType;
+  final _RunOutputValue runOutputRank;
+  final _RunOutputShape runOutputShape;
+  final _Release runRelease;
+
+  // Runs waiting for their result, by the tag passed to fort_session_run_async
+  final Map<int, Completer<Pointer<Void>>> pendingRuns = {};
+  int nextRunTag = 0;
+
+  // Receives run results from the native worker threads; created on the first run
+  late final NativeCallable<_RunCallbackNative> runCallback = NativeCallable<_RunCallbackNative>.listener((
+    int tag,
+    Pointer<Void> result,
+  ) {
+    pendingRuns.remove(tag)?.complete(result);
+  })..keepIsolateAlive = false;
+}
+
+Future<_NativeApi?>? _api;
+
+Future<_NativeApi?> _loadApi() async {
+  if (!Platform.isLinux && !Platform.isWindows) {
+    return null;
+  }
+
+  final nativeContext = await FlutterOnnxruntimePlatform.instance.getNativeContext();
+  final address = nativeContext['context'];
+  if (address is! int || address == 0) {
+    return null;
+  }
+
+  try {
+    final library = DynamicLibrary.open(
+      Platform.isWindows ? 'flutter_onnxruntime_plugin.dll' : 'libflutter_onnxruntime_plugin.so',
+    );
+    return _NativeApi(library, Pointer<Void>.fromAddress(address));
+  } on ArgumentError {
+    // The plugin library could not be opened or is too old to export the fort_* functions
+    return null;
+  }
+}
+
+// Parse a session or value ID sent by the plugin, either an integer handle or a prefixed string ID
+int? _parseHandle(String id, String prefix) => int.tryParse(id.startsWith(prefix) ? id.substring(prefix.length) : id);
+
+String? _readCString(Pointer<Uint8> string) {
+  if (string == nullptr) {
+    return null;
+  }
+  var length = 0;
+  while (string[length] != 0) {
+    length++;
+  }
+  return utf8.decode(string.asTypedList(length));
+}
+
+/// Create a tensor from typed data with a single copy into native memory
+///
+/// Returns a map shaped like the result of createOrtValue, or null if the platform has no dart:ffi data plane
+Future<Map<String, dynamic>?> createNativeTensor(String dataType, TypedData data, List<int> shape) async {
+  final api = await (_api ??= _loadApi());
+  final elementType = _elementTypes[dataType];
+  if (api == null || elementType == null) {
+    return null;
+  }
+
+  final bytes = data.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes);
+  final nativeShape = Int64List.fromList(shape);
+  final tensorId = api.tensorCreate(
+    api.context,
+    elementType,
+    bytes.address,
+    bytes.lengthInBytes,
+    nativeShape.address,
+    shape.length,
+  );
+  if (tensorId == 0) {
+    throw PlatformException(code: 'TENSOR_CREATION_ERROR', message: _readCString(api.lastError()));
+  }
+  return {'valueId': '$tensorId', 'dataType': dataType, 'shape': shape};
+}
+
+/// Release a tensor without a method channel round trip
+///
+/// Returns false if the platform has no dart:ffi data plane
+Future<bool> releaseNativeTensor(String valueId) async {
+  final api = await (_api ??= _loadApi());
+  final tensorId = _parseHandle(valueId, 'tensor_');
+  if (api == null || tensorId == null) {
+    return false;
+  }
+
+  // Like releaseOrtValue, releasing an unknown tensor is not an error
+  api.tensorRelease(api.context, tensorId);
+  return true;
+}
+
+/// Release several tensors in one native call that takes the tensor lock once
+///
+/// Returns false if the platform has no dart:ffi data plane
+Future<bool> releaseNativeTensors(List<String> valueIds) async {
+  final api = await (_api ??= _loadApi());
+  if (api == null) {
+    return false;
+  }
+
+  // IDs that are not handles become the invalid handle 0, which is skipped like any unknown tensor
+  final tensorIds = Uint64List.fromList([for (final valueId in valueIds) _parseHandle(valueId, 'tensor_') ?? 0]);
+  api.tensorReleaseMany(api.context, tensorIds.address, tensorIds.length);
+  return true;
+}
+
+/// Borrow the bytes of a tensor without copying them
+///
+/// The returned list is a view over the tensor memory that keeps it alive until the list is garbage collected,
+/// even if the tensor is released first. Returns null if the platform offers no such view or the tensor cannot be
+/// borrowed (unknown ID or string data), in which case the caller should read the data over the method channel.
+Future<Uint8List?> borrowTensorBytes(String valueId) async {
+  final api = await (_api ??= _loadApi());
+  final tensorId = _parseHandle(valueId, 'tensor_');
+  if (api == null || tensorId == null) {
+    return null;
+  }
+
+  final lease = api.tensorAcquire(api.context, tensorId);
+  if (lease == nullptr) {
+    return null;
+  }
+
+  final byteSize = api.leaseByteSize(lease);
+  if (byteSize == 0) {
+    api.leaseRelease(lease);
+    return Uint8List(0);
+  }
+  return api.leaseData(lease).asTypedList(byteSize, finalizer: api.leaseFinalizer, token: lease);
+}
+
+/// Copy the bytes of a tensor out of native memory; returns null under the same conditions as [borrowTensorBytes]
+Future<Uint8List?> copyTensorBytes(String valueId) async {
+  final api = await (_api ??= _loadApi());
+  final tensorId = _parseHandle(valueId, 'tensor_');
+  if (api == null || tensorId == null) {
+    return null;
+  }
+
+  final lease = api.tensorAcquire(api.context, tensorId);
+  if (lease == nullptr) {
+    return null;
+  }
+
+  try {
+    final byteSize = api.leaseByteSize(lease);
+    return byteSize == 0 ? Uint8List(0) : Uint8List.fromList(api.leaseData(lease).asTypedList(byteSize));
+  } finally {
+    api.leaseRelease(lease);
+  }
+}
+
+/// Run a session on the native worker pool without a method channel round trip
+///
+/// [sessionInputNames] and [sessionOutputNames] are the input and output names of the session, in model order,
+/// and [inputs] maps input names to value IDs. [outputNames] selects the outputs to compute, all of them if null.
+/// Returns a map shaped like the result of runInference, or null if the platform has no dart:ffi data plane or an
+/// input or output name is unknown.
+Future<Map<String, dynamic>?> runNativeSession(
+  String sessionId,
+  List<String> sessionInputNames,
+  List<String> sessionOutputNames,
+  Map<String, String> inputs, {
+  List<String>? outputNames,
+}) async {
+  final api = await (_api ??= _loadApi());
+  final handle = _parseHandle(sessionId, 'session_');
+  if (api == null || handle == null) {
+    return null;
+  }
+
+  final inputIndices = Uint32List(inputs.length);
+  final inputIds = Uint64List(inputs.length);
+  var i = 0;
+  for (final entry in inputs.entries) {
+    final index = sessionInputNames.indexOf(entry.key);
+    final tensorId = _parseHandle(entry.value, 'tensor_');
+    if (index < 0 || tensorId == null) {
+      return null;
+    }
+    inputIndices[i] = index;
+    inputIds[i] = tensorId;
+    i++;
+  }
+
+  final resultNames = outputNames ?? sessionOutputNames;
+  final outputIndices = Uint32List(outputNames?.length ?? 0);
+  for (var o = 0; o < outputIndices.length; o++) {
+    final index = sessionOutputNames.indexOf(resultNames[o]);
+    if (index < 0) {
+      return null;
+    }
+    outputIndices[o] = index;
+  }
+
+  final tag = api.nextRunTag++;
+  final completer = Completer<Pointer<Void>>();
+  api.pendingRuns[tag] = completer;
+  api.sessionRunAsync(
+    api.context,
+    handle,
+    inputIndices.address,
+    inputIds.address,
+    inputs.length,
+    outputIndices.address,
+    outputIndices.length,
+    tag,
+    api.runCallback.nativeFunction,
+  );
+
+  final result = await completer.future;
+  try {
+    final error = _readCString(api.runError(result));
+    if (error != null) {
+      throw PlatformException(code: 'INFERENCE_ERROR', message: error);
+    }
+
+    final outputs = <String, dynamic>{};
+    final count = api.runOutputCount(result);
+    for (var index = 0; index < count && index < resultNames.length; index++) {
+      // Outputs kept as sequence state of the session have no tensor
+      final outputId = api.runOutputId(result, index);
+      if (outputId == 0) {
+        continue;
+      }
+      final rank = api.runOutputRank(result, index);
+      final shape = rank == 0 ? <int>[] : List<int>.from(api.runOutputShape(result, index).asTypedList(rank));
+      outputs[resultNames[index]] = [
+        '$outputId',
+        _elementTypeNames[api.runOutputType(result, index)] ?? 'undefined',
+        shape,
+      ];
+    }
+    return outputs;
+  } finally {
+    api.runRelease(result);
+  }
+}
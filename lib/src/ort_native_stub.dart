@@ -0,0 +1,28 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:typed_data';
+
+// Counterparts of the functions of ort_native.dart where dart:ffi is not available; every call reports that there
+// is no native data plane, so the callers fall back to the method channel.
+
+Future<Map<String, dynamic>?> createNativeTensor(String dataType, TypedData data, List<int> shape) async => null;
+
+Future<bool> releaseNativeTensor(String valueId) async => false;
+
+Future<bool> releaseNativeTensors(List<String> valueIds) async => false;
+
+Future<Uint8List?> borrowTensorBytes(String valueId) async => null;
+
+Future<Uint8List?> copyTensorBytes(String valueId) async => null;
+
+Future<Map<String, dynamic>?> runNativeSession(
+  String sessionId,
+  List<String> sessionInputNames,
+  List<String> sessionOutputNames,
+  Map<String, String> inputs, {
+  List<String>? outputNames,
+}) async => null;
@@ -0,0 +1,83 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart';
+
+/// Post-processing ops that run natively on stored float32 tensors, such as the outputs of `OrtSession.run`
+///
+/// Only the results, which are new tensors, are returned, so a detection or classification output can be reduced to
+/// a few kilobytes before its data is read. These are the glue ops of `OrtPipelineStage`, run on their own; large
+/// tensors are split across several threads and exp runs SIMD kernels. Available on Linux and Windows.
+class OrtOps {
+  OrtOps._();
+
+  /// Softmax along [axis], as in the ONNX Softmax op
+  static Future<OrtValue> softmax(OrtValue input, {int axis = -1}) async {
+    final outputs = await _run('softmax', {'input': input}, {'axis': axis});
+    return outputs['output']!;
+  }
+
+  /// Logistic sigmoid `1 / (1 + exp(-x))` of every element
+  static Future<OrtValue> sigmoid(OrtValue input) async {
+    final outputs = await _run('sigmoid', {'input': input}, {});
+    return outputs['output']!;
+  }
+
+  /// Index of the largest element along [axis], keeping the first of ties; an int64 tensor without that axis
+  static Future<OrtValue> argmax(OrtValue input, {int axis = -1}) async {
+    final outputs = await _run('argmax', {'input': input}, {'axis': axis});
+    return outputs['output']!;
+  }
+
+  /// The [k] largest elements along the last axis and their int64 indices, in descending order
+  static Future<({OrtValue values, OrtValue indices})> topK(OrtValue input, int k) async {
+    final outputs = await _run('topK', {'input': input}, {'k': k});
+    return (values: outputs['values']!, indices: outputs['indices']!);
+  }
+
+  /// Greedy non-maximum suppression of (x1, y1, x2, y2) [boxes] of shape [N, 4] with [scores] of shape [N]
+  ///
+  /// Boxes scoring below [scoreThreshold] or overlapping a better box by more than [iouThreshold] are dropped, and
+  /// at most [maxDetections] are kept if it is not 0. Returns the kept boxes, their scores and their int64 indices,
+  /// by descending score.
+  static Future<({OrtValue boxes, OrtValue scores, OrtValue indices})> nms(
+    OrtValue boxes,
+    OrtValue scores, {
+    double iouThreshold = 0.5,
+    double? scoreThreshold,
+    int maxDetections = 0,
+  }) async {
+    final outputs = await _run(
+      'nms',
+      {'boxes': boxes, 'scores': scores},
+      {
+        'iouThreshold': iouThreshold,
+        if (scoreThreshold != null) 'scoreThreshold': scoreThreshold,
+        'maxDetections': maxDetections,
+      },
+    );
+    return (boxes: outputs['boxes']!, scores: outputs['scores']!, indices: outputs['indices']!);
+  }
+
+  static Future<Map<String, OrtValue>> _run(String op, Map<String, OrtValue> inputs, Map<String, Object> params) async {
+    for (final input in inputs.values) {
+      if (input.isInline) {
+        throw StateError('An inline OrtValue has no native tensor to run $op on, create one with fromList()');
+      }
+    }
+    final result = await FlutterOnnxruntimePlatform.instance.runTensorOp(op, inputs, params: params);
+    final outputs = <String, OrtValue>{};
+    for (final entry in result.entries) {
+      outputs[entry.key] = OrtValue.fromMap({
+        'valueId': entry.value[0],
+        'dataType': entry.value[1],
+        'shape': entry.value[2],
+      });
+    }
+    return outputs;
+  }
+}
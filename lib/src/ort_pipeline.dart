@@ -0,0 +1,166 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_session.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart';
+
+/// A stage of an [OrtPipeline]: a session run or a built-in glue op
+///
+/// Every input of a stage names the value it reads, either `'stage/output'` for an output of another stage or the
+/// name of a pipeline input passed to [OrtPipeline.run]. Glue ops read float32 tensors, except
+/// [OrtPipelineStage.slice], which takes any numeric or bool type.
+class OrtPipelineStage {
+  /// Name of the stage, by which other stages read its outputs
+  final String name;
+
+  /// Kind of the stage: 'session', 'slice', 'cropResize', 'argmax', 'softmax', 'sigmoid', 'topK' or 'nms'
+  final String op;
+
+  /// Session run by a 'session' stage
+  final OrtSession? session;
+
+  /// Value read by each input of the stage
+  final Map<String, String> inputs;
+
+  /// Parameters of a glue op
+  final Map<String, Object> params;
+
+  const OrtPipelineStage._(this.name, this.op, {this.session, required this.inputs, this.params = const {}});
+
+  /// Run a session, feeding each model input from [inputs]; its outputs are named after the model outputs
+  factory OrtPipelineStage.session(String name, OrtSession session, {required Map<String, String> inputs}) {
+    return OrtPipelineStage._(name, 'session', session: session, inputs: inputs);
+  }
+
+  /// Slice [input] along [axes] (all leading axes if omitted) as in the ONNX Slice op with unit steps; output
+  /// 'output'
+  factory OrtPipelineStage.slice(
+    String name, {
+    required String input,
+    required List<int> starts,
+    required List<int> ends,
+    List<int>? axes,
+  }) {
+    return OrtPipelineStage._(
+      name,
+      'slice',
+      inputs: {'input': input},
+      params: {'starts': starts, 'ends': ends, if (axes != null) 'axes': axes},
+    );
+  }
+
+  /// Crop the (x1, y1, x2, y2) pixel [boxes] of shape [K, 4] out of a [1, C, H, W] [image] and resize each to
+  /// [height] x [width] bilinearly; output 'output' of shape [K, C, height, width]
+  factory OrtPipelineStage.cropResize(
+    String name, {
+    required String image,
+    required String boxes,
+    required int height,
+    required int width,
+  }) {
+    return OrtPipelineStage._(
+      name,
+      'cropResize',
+      inputs: {'image': image, 'boxes': boxes},
+      params: {'height': height, 'width': width},
+    );
+  }
+
+  /// Index of the largest element along [axis]; int64 output 'output' without that axis
+  factory OrtPipelineStage.argmax(String name, {required String input, int axis = -1}) {
+    return OrtPipelineStage._(name, 'argmax', inputs: {'input': input}, params: {'axis': axis});
+  }
+
+  /// Softmax along [axis], as in the ONNX Softmax op; output 'output' of the same shape
+  factory OrtPipelineStage.softmax(String name, {required String input, int axis = -1}) {
+    return OrtPipelineStage._(name, 'softmax', inputs: {'input': input}, params: {'axis': axis});
+  }
+
+  /// Logistic sigmoid of every element; output 'output' of the same shape
+  factory OrtPipelineStage.sigmoid(String name, {required String input}) {
+    return OrtPipelineStage._(name, 'sigmoid', inputs: {'input': input});
+  }
+
+  /// The [k] largest elements along the last axis, in descending order; outputs 'values' and int64 'indices'
+  factory OrtPipelineStage.topK(String name, {required String input, required int k}) {
+    return OrtPipelineStage._(name, 'topK', inputs: {'input': input}, params: {'k': k});
+  }
+
+  /// Greedy non-maximum suppression of (x1, y1, x2, y2) [boxes] of shape [N, 4] with [scores] of shape [N].
+  /// Boxes scoring below [scoreThreshold] or overlapping a better box by more than [iouThreshold] are dropped, and
+  /// at most [maxDetections] are kept if it is not 0. Outputs 'boxes', 'scores' and int64 'indices' of the kept
+  /// boxes, by descending score.
+  factory OrtPipelineStage.nms(
+    String name, {
+    required String boxes,
+    required String scores,
+    double iouThreshold = 0.5,
+    double? scoreThreshold,
+    int maxDetections = 0,
+  }) {
+    return OrtPipelineStage._(
+      name,
+      'nms',
+      inputs: {'boxes': boxes, 'scores': scores},
+      params: {
+        'iouThreshold': iouThreshold,
+        if (scoreThreshold != null) 'scoreThreshold': scoreThreshold,
+        'maxDetections': maxDetections,
+      },
+    );
+  }
+
+  Map<String, dynamic> toMap() {
+    return {
+      'name': name,
+      'op': op,
+      if (session != null) 'sessionId': session!.id,
+      'inputs': inputs,
+      'params': params,
+    };
+  }
+}
+
+/// A DAG of sessions and glue ops that runs natively in one call
+///
+/// Intermediate values are handed from stage to stage in native memory and freed after their last reader, so only
+/// the pipeline outputs cross the platform channel. Create one with `OnnxRuntime.createPipeline`; available on
+/// Linux and Windows.
+class OrtPipeline {
+  final String id;
+
+  OrtPipeline._(this.id);
+
+  factory OrtPipeline.fromMap(Map<String, dynamic> map) {
+    return OrtPipeline._((map['pipelineId'] as Object).toString());
+  }
+
+  /// Run every stage on [inputs] and return the pipeline outputs by name
+  ///
+  /// [options] apply to every session of the pipeline.
+  Future<Map<String, OrtValue>> run(Map<String, OrtValue> inputs, {OrtRunOptions? options}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.runPipeline(
+      id,
+      inputs,
+      runOptions: options?.toMap() ?? {},
+    );
+    final outputs = <String, OrtValue>{};
+    for (final entry in result.entries) {
+      outputs[entry.key] = OrtValue.fromMap({
+        'valueId': entry.value[0],
+        'dataType': entry.value[1],
+        'shape': entry.value[2],
+      });
+    }
+    return outputs;
+  }
+
+  /// Close the pipeline; its sessions stay open and must be closed on their own
+  Future<void> close() async {
+    await FlutterOnnxruntimePlatform.instance.closePipeline(id);
+  }
+}
@@ -0,0 +1,93 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+class OrtProfileEntry {
+  /// Node name, or the operator type for an operator entry
+  final String name;
+
+  /// Operator type, e.g. 'Conv'
+  final String opType;
+
+  /// Execution provider that ran the kernels, e.g. 'CPUExecutionProvider'
+  final String provider;
+
+  /// Total time spent in the kernels
+  final Duration totalTime;
+
+  /// Number of kernel runs
+  final int calls;
+
+  OrtProfileEntry({
+    required this.name,
+    required this.opType,
+    required this.provider,
+    required this.totalTime,
+    required this.calls,
+  });
+
+  factory OrtProfileEntry.fromMap(Map<String, dynamic> map) {
+    return OrtProfileEntry(
+      name: map['name'] as String? ?? '',
+      opType: map['opType'] as String? ?? '',
+      provider: map['provider'] as String? ?? '',
+      totalTime: Duration(microseconds: map['totalMicros'] as int? ?? 0),
+      calls: map['calls'] as int? ?? 0,
+    );
+  }
+
+  /// Average time of one kernel run, zero if the kernel never ran
+  Duration get averageTime => calls == 0 ? Duration.zero : totalTime ~/ calls;
+
+  Map<String, dynamic> toMap() {
+    return {
+      'name': name,
+      'opType': opType,
+      'provider': provider,
+      'totalMicros': totalTime.inMicroseconds,
+      'calls': calls,
+    };
+  }
+}
+
+class OrtProfile {
+  /// Path of the trace file written by ONNX Runtime, in the Chrome trace format
+  final String path;
+
+  /// Total kernel time of every node
+  final Duration totalTime;
+
+  /// Kernel time of each node, longest first
+  final List<OrtProfileEntry> nodes;
+
+  /// Kernel time of each operator type and execution provider, longest first
+  final List<OrtProfileEntry> ops;
+
+  OrtProfile({required this.path, required this.totalTime, required this.nodes, required this.ops});
+
+  factory OrtProfile.fromMap(Map<String, dynamic> map) {
+    List<OrtProfileEntry> entries(String key) => (map[key] as List<dynamic>? ?? [])
+        .map((entry) => OrtProfileEntry.fromMap(Map<String, dynamic>.from(entry as Map)))
+        .toList();
+    return OrtProfile(
+      path: map['profilePath'] as String? ?? '',
+      totalTime: Duration(microseconds: map['totalMicros'] as int? ?? 0),
+      nodes: entries('nodes'),
+      ops: entries('ops'),
+    );
+  }
+
+  /// Converts the profile to a Map
+  ///
+  /// Returns a map representation of the profile
+  Map<String, dynamic> toMap() {
+    return {
+      'profilePath': path,
+      'totalMicros': totalTime.inMicroseconds,
+      'nodes': nodes.map((entry) => entry.toMap()).toList(),
+      'ops': ops.map((entry) => entry.toMap()).toList(),
+    };
+  }
+}
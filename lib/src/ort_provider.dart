@@ -11,6 +11,9 @@
 /// Following the name of the execution provider in the ONNX Runtime Java API at:
 /// https://onnxruntime.ai/docs/api/java/ai/onnxruntime/OrtProvider.html
 enum OrtProvider {
+  /// Not a provider itself: pick the fastest available provider for the model by timing a few runs on each, and
+  /// remember the choice per model and device. Replaces the rest of the providers list.
+  AUTO,
   ACL,
   ARM_NN,
   AZURE,
@@ -30,3 +33,21 @@ enum OrtProvider {
   WEB_GPU,
   WEB_NN,
 }
+
+/// Device memory that OrtSession.run keeps its outputs in when it is set as OrtRunOptions.outputDevice
+///
+/// Outputs kept on a device can be passed to another session on the same device without a copy through host memory,
+/// and are only copied to the host when their data is read.
+class OrtDevice {
+  /// Kind of memory: 'cuda' (Linux and Windows) or 'directml' (Windows)
+  final String type;
+
+  /// Index of the device, as for OrtSessionOptions.deviceId
+  final int id;
+
+  /// Memory of a CUDA device, for sessions with the CUDA or TensorRT provider
+  const OrtDevice.cuda([this.id = 0]) : type = 'cuda';
+
+  /// Memory of a DirectML adapter, for sessions with the DirectML provider
+  const OrtDevice.directML([this.id = 0]) : type = 'directml';
+}
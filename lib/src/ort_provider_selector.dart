@@ -0,0 +1,371 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:flutter/foundation.dart';
+import 'package:path_provider/path_provider.dart';
+
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_provider.dart';
+import 'package:flutter_onnxruntime/src/ort_session.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart';
+
+/// Creates a session with the providers of [options]
+typedef OrtSessionFactory = Future<OrtSession> Function(OrtSessionOptions options);
+
+/// Picks the fastest execution provider for a model by timing a few runs on each available provider
+///
+/// The choice is remembered per model content and device, in memory and in a JSON file in the app support
+/// directory, so only the first session of a model pays for the measurement. The content hash of a model file is
+/// remembered there too, by path, size and modification time, so later launches do not read the model again.
+/// A provider is only chosen if its outputs are numerically close to those of the CPU provider.
+class OrtProviderSelector {
+  /// Runs of each provider before the timed runs
+  static const int warmupRuns = 2;
+
+  /// Timed runs of each provider, of which the median is compared
+  static const int timedRuns = 5;
+
+  /// Relative and absolute tolerance of the outputs compared to the CPU provider; loose enough for providers that
+  /// compute in reduced precision, e.g. float16 on TensorRT or CoreML
+  static const double relativeTolerance = 1e-2;
+  static const double absoluteTolerance = 1e-3;
+
+  static const String _cacheFileName = 'provider_selection.json';
+
+  // Prefix of the cache entries that hold the content hash of a model file, keyed by its path
+  static const String _fileHashPrefix = 'file:';
+
+  // Choices by cache key and '$size:$modified:$hash' of model files by _fileHashPrefix and path, loaded from the
+  // cache file on first use
+  Map<String, String>? _choices;
+
+  /// Create a session of a model file with the fastest provider, measuring the providers on first use
+  Future<OrtSession> createSessionFromFile(
+    String modelPath,
+    OrtSessionOptions options,
+    OrtSessionFactory create,
+  ) async {
+    return _createSession(await _fileHash(modelPath), options, create);
+  }
+
+  /// Create a session of a model held in memory with the fastest provider, measuring the providers on first use
+  Future<OrtSession> createSessionFromBuffer(Uint8List modelData, OrtSessionOptions options, OrtSessionFactory create) {
+    return _createSession(_hashBytes(modelData), options, create);
+  }
+
+  /// Create a session of an asset on web, where models are identified by their asset key
+  Future<OrtSession> createSessionFromAssetKey(String assetKey, OrtSessionOptions options, OrtSessionFactory create) {
+    return _createSession('asset:$assetKey', options, create);
+  }
+
+  /// Forget every remembered choice, so that providers are measured again
+  Future<void> clearCache() async {
+    _choices = {};
+    final file = await _cacheFile();
+    if (file != null && await file.exists()) {
+      await file.delete();
+    }
+  }
+
+  Future<OrtSession> _createSession(String modelHash, OrtSessionOptions options, OrtSessionFactory create) async {
+    final device = await _deviceKey();
+    final key = '$modelHash@$device';
+    final choices = await _loadChoices();
+
+    final remembered = choices[key];
+    if (remembered != null) {
+      final provider = OrtProvider.values.where((p) => p.name == remembered).firstOrNull;
+      if (provider != null) {
+        try {
+          return await create(options.withProviders(_withCpuFallback(provider)));
+        } catch (_) {
+          // The provider may be gone, e.g. after a driver update; measure again
+        }
+      }
+    }
+
+    final (session, provider) = await _measure(options, create);
+    choices[key] = provider.name;
+    await _saveChoices(choices);
+    return session;
+  }
+
+  // Time every candidate provider and return the session of the fastest one that matches the CPU outputs
+  Future<(OrtSession, OrtProvider)> _measure(OrtSessionOptions options, OrtSessionFactory create) async {
+    OrtSession best = await create(options.withProviders(const [OrtProvider.CPU]));
+    OrtProvider bestProvider = OrtProvider.CPU;
+    final inputs = await _tryCreateInputs(best);
+    if (inputs == null) {
+      // Inputs of this model cannot be made up, e.g. non-tensor inputs; keep the CPU provider
+      return (best, bestProvider);
+    }
+
+    try {
+      final reference = await _timeRuns(best, inputs);
+      int bestMicros = reference.$1;
+
+      for (final provider in await _candidates()) {
+        OrtSession? candidate;
+        try {
+          candidate = await create(options.withProviders(_withCpuFallback(provider)));
+          final (micros, outputs) = await _timeRuns(candidate, inputs);
+          if (micros < bestMicros && _outputsMatch(reference.$2, outputs)) {
+            await best.close();
+            best = candidate;
+            bestProvider = provider;
+            bestMicros = micros;
+            candidate = null;
+          }
+        } catch (_) {
+          // A provider that fails to create a session or to run the model is not a candidate
+        } finally {
+          await candidate?.close();
+        }
+      }
+    } catch (_) {
+      await best.close();
+      rethrow;
+    } finally {
+      await _disposeValues(inputs);
+    }
+    return (best, bestProvider);
+  }
+
+  // Available providers other than CPU that can run a model on this device
+  Future<List<OrtProvider>> _candidates() async {
+    final available = await FlutterOnnxruntimePlatform.instance.getAvailableProviders();
+    return [
+      for (final name in available)
+        if (OrtProvider.values.where((p) => p.name == name).firstOrNull case final provider?)
+          if (provider != OrtProvider.CPU && provider != OrtProvider.AZURE && provider != OrtProvider.AUTO) provider,
+    ];
+  }
+
+  static List<OrtProvider> _withCpuFallback(OrtProvider provider) {
+    return provider == OrtProvider.CPU ? const [OrtProvider.CPU] : [provider, OrtProvider.CPU];
+  }
+
+  // Run a session and return the median time of the timed runs and the flattened outputs of the last run
+  Future<(int, Map<String, List<dynamic>>)> _timeRuns(OrtSession session, Map<String, OrtValue> inputs) async {
+    for (var i = 0; i < warmupRuns; i++) {
+      await _disposeValues(await session.run(inputs));
+    }
+
+    final micros = <int>[];
+    Map<String, List<dynamic>> outputs = {};
+    for (var i = 0; i < timedRuns; i++) {
+      final watch = Stopwatch()..start();
+      final values = await session.run(inputs);
+      watch.stop();
+      micros.add(watch.elapsedMicroseconds);
+      if (i == timedRuns - 1) {
+        outputs = {for (final entry in values.entries) entry.key: await entry.value.asFlattenedList()};
+      }
+      await _disposeValues(values);
+    }
+    micros.sort();
+    return (micros[micros.length ~/ 2], outputs);
+  }
+
+  static bool _outputsMatch(Map<String, List<dynamic>> reference, Map<String, List<dynamic>> outputs) {
+    if (reference.length != outputs.length) {
+      return false;
+    }
+    for (final entry in reference.entries) {
+      final actual = outputs[entry.key];
+      if (actual == null || actual.length != entry.value.length) {
+        return false;
+      }
+      for (var i = 0; i < actual.length; i++) {
+        final expected = entry.value[i];
+        final value = actual[i];
+        if (expected is num && value is num) {
+          if ((expected - value).abs() > absoluteTolerance + relativeTolerance * expected.abs()) {
+            return false;
+          }
+        } else if (expected != value) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Deterministic inputs shaped from the input info of a session, with dynamic dimensions of size 1, or null if
+  // an input has a type that cannot be made up
+  static Future<Map<String, OrtValue>?> _tryCreateInputs(OrtSession session) async {
+    final inputs = <String, OrtValue>{};
+    try {
+      for (final info in await session.getInputInfo()) {
+        final name = info['name'] as String;
+        final shape = [for (final dim in (info['shape'] as List? ?? [])) (dim is int && dim > 0) ? dim : 1];
+        final count = shape.fold<int>(1, (a, b) => a * b);
+        inputs[name] = await _createInput(info['type'] as String? ?? '', count, shape);
+      }
+    } catch (_) {
+      await _disposeValues(inputs);
+      return null;
+    }
+    return inputs;
+  }
+
+  static Future<OrtValue> _createInput(String type, int count, List<int> shape) async {
+    switch (type) {
+      case 'float32':
+        return OrtValue.fromList(Float32List.fromList([for (var i = 0; i < count; i++) (i % 17) / 17]), shape);
+      case 'float16':
+        final values = await OrtValue.fromList(
+          Float32List.fromList([for (var i = 0; i < count; i++) (i % 17) / 17]),
+          shape,
+        );
+        try {
+          return await values.to(OrtDataType.float16);
+        } finally {
+          await values.dispose();
+        }
+      case 'float64':
+        return OrtValue.fromList(Float64List.fromList([for (var i = 0; i < count; i++) (i % 17) / 17]), shape);
+      case 'int32':
+        return OrtValue.fromList(Int32List.fromList([for (var i = 0; i < count; i++) i % 17]), shape);
+      case 'int64':
+        return OrtValue.fromList(Int64List.fromList([for (var i = 0; i < count; i++) i % 17]), shape);
+      case 'uint8':
+        return OrtValue.fromList(Uint8List.fromList([for (var i = 0; i < count; i++) i % 17]), shape);
+      case 'bool':
+        return OrtValue.fromList([for (var i = 0; i < count; i++) i.isEven], shape);
+      case 'string':
+        return OrtValue.fromList([for (var i = 0; i < count; i++) 'input$i'], shape);
+      default:
+        throw UnsupportedError('Cannot make up an input of type $type');
+    }
+  }
+
+  static Future<void> _disposeValues(Map<String, OrtValue> values) async {
+    for (final value in values.values) {
+      await value.dispose();
+    }
+  }
+
+  // Content hash of a model file, hashed again only if its size or modification time changed since it was last
+  // hashed, in this process or an earlier one
+  Future<String> _fileHash(String modelPath) async {
+    final stat = await File(modelPath).stat();
+    final identity = '${stat.size}:${stat.modified.microsecondsSinceEpoch}:';
+    final choices = await _loadChoices();
+    final cached = choices['$_fileHashPrefix$modelPath'];
+    if (cached != null && cached.startsWith(identity)) {
+      return cached.substring(identity.length);
+    }
+    final hash = await compute(_hashFile, modelPath);
+    // Replaces the hash of an earlier version of the file
+    choices['$_fileHashPrefix$modelPath'] = '$identity$hash';
+    await _saveChoices(choices);
+    return hash;
+  }
+
+  // Device the choices were measured on; a different OS version or build may change the fastest provider
+  static Future<String> _deviceKey() async {
+    final platform = kIsWeb ? 'web' : defaultTargetPlatform.name;
+    final version = await FlutterOnnxruntimePlatform.instance.getPlatformVersion();
+    return '$platform/${version ?? ''}';
+  }
+
+  Future<Map<String, String>> _loadChoices() async {
+    if (_choices != null) {
+      return _choices!;
+    }
+    _choices = {};
+    try {
+      final file = await _cacheFile();
+      if (file != null && await file.exists()) {
+        final decoded = jsonDecode(await file.readAsString());
+        if (decoded is Map) {
+          decoded.forEach((key, value) {
+            if (key is String && value is String) {
+              _choices![key] = value;
+            }
+          });
+        }
+      }
+    } catch (_) {
+      // A corrupt cache file only costs measuring again
+    }
+    return _choices!;
+  }
+
+  Future<void> _saveChoices(Map<String, String> choices) async {
+    try {
+      final file = await _cacheFile();
+      if (file == null) {
+        return;
+      }
+      await file.parent.create(recursive: true);
+      // Write a sibling file and rename it over the cache, so an interrupted write never leaves a partial file
+      final tempFile = File('${file.path}.tmp');
+      await tempFile.writeAsString(jsonEncode(choices), flush: true);
+      if (await file.exists()) {
+        await file.delete();
+      }
+      await tempFile.rename(file.path);
+    } catch (_) {
+      // The choice is still remembered in memory for this process
+    }
+  }
+
+  // The cache file, or null on web, which keeps the choices in memory only
+  static Future<File?> _cacheFile() async {
+    if (kIsWeb) {
+      return null;
+    }
+    final directory = await getApplicationSupportDirectory();
+    final separator = Platform.pathSeparator;
+    return File('${directory.path}${separator}flutter_onnxruntime$separator$_cacheFileName');
+  }
+}
+
+// 64-bit FNV-1a hash of the bytes of a model, fed in chunks. Computed on 32-bit halves so that every intermediate
+// value stays below 2^53 and the hash is the same on web, where integers are doubles.
+class _ModelHash {
+  static const _twoTo32 = 0x100000000;
+
+  int _low = 0x84222325;
+  int _high = 0xcbf29ce4;
+  int _length = 0;
+
+  void add(List<int> bytes) {
+    int low = _low;
+    int high = _high;
+    for (final byte in bytes) {
+      low ^= byte;
+      // Multiply by the FNV prime 2^40 + 0x1b3 modulo 2^64; the 2^40 term only adds low * 2^8 to the high half
+      final lowProduct = low * 0x1b3;
+      high = (high * 0x1b3 + low * 0x100 + lowProduct ~/ _twoTo32) % _twoTo32;
+      low = lowProduct % _twoTo32;
+    }
+    _low = low;
+    _high = high;
+    _length += bytes.length;
+  }
+
+  // The hash as a hex string followed by the number of bytes
+  @override
+  String toString() => '${_high.toRadixString(16).padLeft(8, '0')}${_low.toRadixString(16).padLeft(8, '0')}-$_length';
+}
+
+String _hashBytes(Uint8List bytes) => (_ModelHash()..add(bytes)).toString();
+
+// Hash of a model file, read in chunks so that the whole model is never held in memory at once
+Future<String> _hashFile(String modelPath) async {
+  final hash = _ModelHash();
+  await for (final chunk in File(modelPath).openRead()) {
+    hash.add(chunk);
+  }
+  return hash.toString();
+}
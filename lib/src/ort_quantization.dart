@@ -0,0 +1,59 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'package:flutter_onnxruntime/src/ort_value.dart';
+
+/// Linear quantization of a tensor, as in the ONNX QuantizeLinear and DequantizeLinear ops
+///
+/// A quantized element `q` stands for `(q - zeroPoint) * scale`.
+class OrtQuantization {
+  /// One scale for the whole tensor, or one per index along [axis]
+  final List<double> scales;
+
+  /// Zero point of each scale; empty for zero points of 0
+  final List<int> zeroPoints;
+
+  /// Axis of per-channel scales; negative values count from the end
+  final int axis;
+
+  /// Type of the quantized elements, [OrtDataType.int8] or [OrtDataType.uint8]
+  final OrtDataType dataType;
+
+  OrtQuantization({
+    required this.scales,
+    this.zeroPoints = const [],
+    this.axis = 1,
+    this.dataType = OrtDataType.uint8,
+  }) {
+    if (dataType != OrtDataType.int8 && dataType != OrtDataType.uint8) {
+      throw ArgumentError('Quantized tensors must be int8 or uint8, got ${dataType.name}');
+    }
+    if (scales.isEmpty) {
+      throw ArgumentError('Quantization needs at least one scale');
+    }
+    if (zeroPoints.isNotEmpty && zeroPoints.length != scales.length) {
+      throw ArgumentError('Quantization needs one zero point per scale');
+    }
+  }
+
+  factory OrtQuantization.fromMap(Map<String, dynamic> map) {
+    final dataType = map['dataType'] as String? ?? 'uint8';
+    return OrtQuantization(
+      scales: [for (final scale in map['scales'] as List<Object?>) (scale as num).toDouble()],
+      zeroPoints: List<int>.from(map['zeroPoints'] as List<Object?>? ?? []),
+      axis: map['axis'] as int? ?? 1,
+      dataType: OrtDataType.values.firstWhere(
+        (type) => type.name == dataType,
+        orElse: () => throw ArgumentError('Invalid data type: $dataType'),
+      ),
+    );
+  }
+
+  /// Converts the quantization to a Map
+  Map<String, dynamic> toMap() {
+    return {'scales': scales, 'zeroPoints': zeroPoints, 'axis': axis, 'dataType': dataType.name};
+  }
+}
@@ -0,0 +1,82 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+/// Counters of the inference calls of one [OrtRunPriority] queued for a worker thread
+class OrtQueueStats {
+  /// Calls waiting for a worker
+  final int queued;
+
+  /// Calls submitted to the queue
+  final int submitted;
+
+  /// Calls a worker started
+  final int started;
+
+  /// Calls terminated to make room for a higher-priority call or by `OnnxRuntime.cancelLowPriorityRuns`
+  final int preempted;
+
+  /// Total time the started calls waited in the queue
+  final Duration waitTime;
+
+  /// Longest time a call waited in the queue
+  final Duration maxWait;
+
+  /// Median time a call waited in the queue, within about 6%
+  final Duration p50;
+
+  /// 90th percentile time a call waited in the queue, within about 6%
+  final Duration p90;
+
+  /// 99th percentile time a call waited in the queue, within about 6%
+  final Duration p99;
+
+  OrtQueueStats({
+    required this.queued,
+    required this.submitted,
+    required this.started,
+    required this.preempted,
+    required this.waitTime,
+    required this.maxWait,
+    required this.p50,
+    required this.p90,
+    required this.p99,
+  });
+
+  factory OrtQueueStats.fromMap(Map<String, dynamic> map) {
+    Duration micros(String key) => Duration(microseconds: map[key] as int? ?? 0);
+    return OrtQueueStats(
+      queued: map['queued'] as int? ?? 0,
+      submitted: map['submitted'] as int? ?? 0,
+      started: map['started'] as int? ?? 0,
+      preempted: map['preempted'] as int? ?? 0,
+      waitTime: micros('waitMicros'),
+      maxWait: micros('maxWaitMicros'),
+      p50: micros('p50WaitMicros'),
+      p90: micros('p90WaitMicros'),
+      p99: micros('p99WaitMicros'),
+    );
+  }
+
+  /// Average time a started call waited in the queue, zero if none started
+  Duration get averageWait => started == 0 ? Duration.zero : waitTime ~/ started;
+
+  /// Converts the statistics to a Map
+  ///
+  /// Returns a map representation of the queue statistics
+  Map<String, dynamic> toMap() {
+    return {
+      'queued': queued,
+      'submitted': submitted,
+      'started': started,
+      'preempted': preempted,
+      'waitMicros': waitTime.inMicroseconds,
+      'maxWaitMicros': maxWait.inMicroseconds,
+      'p50WaitMicros': p50.inMicroseconds,
+      'p90WaitMicros': p90.inMicroseconds,
+      'p99WaitMicros': p99.inMicroseconds,
+    };
+  }
+}
@@ -4,9 +4,19 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:async';
+import 'dart:math';
+
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_batching_stats.dart';
 import 'package:flutter_onnxruntime/src/ort_model_metadata.dart';
+import 'package:flutter_onnxruntime/src/ort_native_stub.dart'
+    if (dart.library.ffi) 'package:flutter_onnxruntime/src/ort_native.dart';
+import 'package:flutter_onnxruntime/src/ort_profile.dart';
 import 'package:flutter_onnxruntime/src/ort_provider.dart';
+import 'package:flutter_onnxruntime/src/ort_quantization.dart';
+import 'package:flutter_onnxruntime/src/ort_session_stats.dart';
+import 'package:flutter_onnxruntime/src/ort_stream.dart';
 import 'package:flutter_onnxruntime/src/ort_value.dart';
 
 class OrtSession {
@@ -14,13 +24,16 @@ class OrtSession {
   final List<String> inputNames;
   final List<String> outputNames;
 
+  // Whether run() calls are gathered by the native micro-batcher, which only the method channel path feeds
+  bool _microBatching = false;
+
   // Private constructor
   OrtSession._({required this.id, required this.inputNames, required this.outputNames});
 
   // Public factory constructor to create from map
   factory OrtSession.fromMap(Map<String, dynamic> map) {
     return OrtSession._(
-      id: map['sessionId'] as String,
+      id: (map['sessionId'] as Object).toString(),
       inputNames: List<String>.from(map['inputNames'] ?? []),
       outputNames: List<String>.from(map['outputNames'] ?? []),
     );
@@ -30,6 +43,9 @@ class OrtSession {
   ///
   /// [inputs] is a map of input names to OrtValue objects
   /// [options] is an optional map of run options
+  /// [outputNames] is an optional list of the outputs to compute, all outputs if omitted. Only these outputs are
+  /// returned, and ONNX Runtime skips the nodes that only the others need, e.g. large auxiliary feature maps or
+  /// attention weights.
   ///
   /// Returns a map of output names to OrtValue objects if successful, otherwise throws an exception
   ///
@@ -44,14 +60,346 @@ class OrtSession {
   /// };
   /// final outputs = await session.run(inputs);
   /// ```
-  Future<Map<String, OrtValue>> run(Map<String, OrtValue> inputs, {OrtRunOptions? options}) async {
+  Future<Map<String, OrtValue>> run(
+    Map<String, OrtValue> inputs, {
+    OrtRunOptions? options,
+    List<String>? outputNames,
+  }) async {
+    // On Linux and Windows a plain run goes straight to the native worker pool through dart:ffi
+    if (options == null && (!_microBatching || outputNames != null)) {
+      final nativeResult = await runNativeSession(
+        id,
+        inputNames,
+        this.outputNames,
+        inputs.map((name, value) => MapEntry(name, value.id)),
+        outputNames: outputNames,
+      );
+      if (nativeResult != null) {
+        return _toOrtValues(nativeResult);
+      }
+    }
+
     final result = await FlutterOnnxruntimePlatform.instance.runInference(
       id,
       inputs,
       runOptions: options?.toMap() ?? {},
+      outputNames: outputNames,
+    );
+    return _toOrtValues(result);
+  }
+
+  /// Run inference on several independent inputs in a single call
+  ///
+  /// [inputs] is a list of input maps, one per request, each shaped like the inputs of [run]
+  /// [options] is an optional map of run options applied to every request
+  ///
+  /// Returns one map of output names to OrtValue objects per request, in request order.
+  ///
+  /// On Linux and Windows, if every input and output of the model has a dynamic batch dimension
+  /// (a leading `-1` in [getInputInfo] / [getOutputInfo]), the requests are stacked along that
+  /// dimension, run once and the outputs split back per request. Otherwise the requests still run
+  /// one after another within a single platform call. Other platforms run them one by one.
+  ///
+  /// Example:
+  /// ```dart
+  /// final results = await session.runBatch([
+  ///   {'input_name': firstTensor},
+  ///   {'input_name': secondTensor},
+  /// ]);
+  /// final firstScores = await results[0]['output_name']!.asList();
+  /// ```
+  Future<List<Map<String, OrtValue>>> runBatch(List<Map<String, OrtValue>> inputs, {OrtRunOptions? options}) async {
+    final results = await FlutterOnnxruntimePlatform.instance.runBatch(
+      id,
+      inputs,
+      runOptions: options?.toMap() ?? {},
+    );
+    return results.map(_toOrtValues).toList();
+  }
+
+  /// Preallocate output tensors and bind them to this session
+  ///
+  /// [outputNames] is an optional list of outputs to bind, all outputs are bound if omitted.
+  /// Only outputs with a fixed shape and a numeric or bool type can be bound.
+  ///
+  /// Returns a map of output names to the bound OrtValue objects. [runWithBinding] writes its results
+  /// into these tensors in place, so the same OrtValue objects hold the latest outputs after each run.
+  /// Do not dispose them while the binding is in use, call [unbindOutputs] first.
+  ///
+  /// Example:
+  /// ```dart
+  /// final outputs = await session.bindOutputs();
+  /// for (final frame in frames) {
+  ///   await session.runWithBinding({'input_name': frame});
+  ///   final data = await outputs['output_name']!.asList();
+  /// }
+  /// await session.unbindOutputs();
+  /// ```
+  Future<Map<String, OrtValue>> bindOutputs({List<String>? outputNames}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.bindOutputs(id, outputNames: outputNames);
+    return _toOrtValues(result);
+  }
+
+  /// Run inference on the session using the outputs bound by [bindOutputs]
+  ///
+  /// [inputs] is a map of input names to OrtValue objects
+  /// [options] is an optional map of run options
+  ///
+  /// Returns a map of output names to the bound OrtValue objects, no new output tensors are allocated
+  Future<Map<String, OrtValue>> runWithBinding(Map<String, OrtValue> inputs, {OrtRunOptions? options}) async {
+    final result = await FlutterOnnxruntimePlatform.instance.runWithBinding(
+      id,
+      inputs,
+      runOptions: options?.toMap() ?? {},
     );
+    return _toOrtValues(result);
+  }
+
+  /// Drop the output binding created by [bindOutputs]
+  ///
+  /// The bound OrtValue objects stay valid and still need to be disposed by the caller.
+  Future<void> unbindOutputs() async {
+    await FlutterOnnxruntimePlatform.instance.unbindOutputs(id);
+  }
+
+  /// Keep the recurrent state or key/value cache of this session in native memory between runs (Linux and Windows)
+  ///
+  /// [loops] maps each output name to the name of the input it feeds on the next run, e.g. every `present.*`
+  /// output of a decoder to its `past_key_values.*` input. [run] then supplies these inputs itself, unless they
+  /// are passed, and leaves the looped outputs out of its result, so only the tokens or logits cross to Dart.
+  /// The inputs start out as zero tensors shaped from [getInputInfo], with each dynamic dimension sized from
+  /// [initialDimensions] by its symbolic name, or 0 (an empty sequence) if it is not listed.
+  ///
+  /// Runs of the session take turns, each one fed the state the previous one left, and [runBatch] is not
+  /// available while the state is enabled. Throws an [UnsupportedError] on other platforms.
+  ///
+  /// Example:
+  /// ```dart
+  /// await session.enableSequenceState({
+  ///   for (var i = 0; i < layers; i++) ...{
+  ///     'present.$i.key': 'past_key_values.$i.key',
+  ///     'present.$i.value': 'past_key_values.$i.value',
+  ///   },
+  /// }, initialDimensions: {'batch_size': 1});
+  /// for (var step = 0; step < maxTokens; step++) {
+  ///   final outputs = await session.run({'input_ids': token, 'attention_mask': mask});
+  ///   final logits = await outputs['logits']!.asFlattenedList();
+  ///   // pick the next token and mask
+  /// }
+  /// await session.resetSequenceState();
+  /// ```
+  Future<void> enableSequenceState(Map<String, String> loops, {Map<String, int> initialDimensions = const {}}) async {
+    await FlutterOnnxruntimePlatform.instance.enableSequenceState(id, loops, initialDimensions: initialDimensions);
+  }
+
+  /// Start a new sequence, e.g. the next prompt, from the initial inputs of [enableSequenceState]
+  Future<void> resetSequenceState() async {
+    await FlutterOnnxruntimePlatform.instance.resetSequenceState(id);
+  }
+
+  /// Stop feeding outputs back, release the state and return every output from [run] again
+  Future<void> disableSequenceState() async {
+    await FlutterOnnxruntimePlatform.instance.disableSequenceState(id);
+  }
+
+  /// Generate tokens from [prompt] with a native decode loop (Linux and Windows), so that a whole generation costs
+  /// one platform call instead of a [run] per token
+  ///
+  /// Each step feeds the token ids to the [inputIdsName] input, with an attention mask of ones and the position
+  /// ids if the session has inputs named [attentionMaskName] and [positionIdsName], and picks the next token from
+  /// the last row of the [logitsName] output (float32 or float16). A [temperature] of 0 picks the most likely
+  /// token; otherwise the token is sampled from the [topK] most likely tokens, 0 for all of them, whose
+  /// probabilities add up to [topP], with a random generator seeded by [seed]. The generation ends after
+  /// [maxTokens] tokens or with the first of [stopTokens], which is still emitted.
+  ///
+  /// With [enableSequenceState] the state is reset first and only the new token is fed at each step after the
+  /// prompt; otherwise the whole sequence is fed again. Only one generation at a time may use a session.
+  ///
+  /// The tokens are emitted as soon as they are picked; cancelling the subscription stops the loop. Throws an
+  /// [UnsupportedError] on other platforms.
+  Stream<int> generate(
+    List<int> prompt, {
+    int maxTokens = 128,
+    List<int> stopTokens = const [],
+    double temperature = 0.0,
+    int topK = 0,
+    double topP = 1.0,
+    int seed = 0,
+    String inputIdsName = 'input_ids',
+    String attentionMaskName = 'attention_mask',
+    String positionIdsName = 'position_ids',
+    String logitsName = 'logits',
+  }) {
+    final platform = FlutterOnnxruntimePlatform.instance;
+    final options = {
+      'maxTokens': maxTokens,
+      'stopTokens': stopTokens,
+      'temperature': temperature,
+      'topK': topK,
+      'topP': topP,
+      'seed': seed,
+      'inputIdsName': inputIdsName,
+      'attentionMaskName': attentionMaskName,
+      'positionIdsName': positionIdsName,
+      'logitsName': logitsName,
+    };
+
+    late final StreamController<int> controller;
+    StreamSubscription<Map<String, dynamic>>? events;
+    String? generationId;
+    var finished = false;
+    var cancelled = false;
+    // Events can arrive before generate() returns the ID they carry, so they wait here until it is known
+    final early = <Map<String, dynamic>>[];
+
+    void onEvent(Map<String, dynamic> event) {
+      if (event['generationId']?.toString() != generationId) {
+        return;
+      }
+      final token = event['token'];
+      if (token is int) {
+        controller.add(token);
+        return;
+      }
+      finished = true;
+      final error = event['error'];
+      if (error != null) {
+        controller.addError(StateError(error.toString()));
+      }
+      events?.cancel();
+      controller.close();
+    }
+
+    controller = StreamController<int>(
+      onListen: () async {
+        events = platform.generationEvents.listen((event) {
+          if (generationId == null) {
+            early.add(event);
+          } else {
+            onEvent(event);
+          }
+        });
+        try {
+          final result = await platform.generate(id, prompt, options: options);
+          generationId = (result['generationId'] as Object).toString();
+          if (cancelled) {
+            await platform.cancelGeneration(generationId!);
+            return;
+          }
+        } catch (e, stackTrace) {
+          finished = true;
+          await events?.cancel();
+          controller.addError(e, stackTrace);
+          await controller.close();
+          return;
+        }
+        for (final event in early) {
+          if (!finished) {
+            onEvent(event);
+          }
+        }
+        early.clear();
+      },
+      onCancel: () async {
+        cancelled = true;
+        await events?.cancel();
+        final generation = generationId;
+        if (!finished && generation != null) {
+          finished = true;
+          await platform.cancelGeneration(generation);
+        }
+      },
+    );
+    return controller.stream;
+  }
+
+  /// Open a pipelined stream of frames through this session, e.g. for camera or video input
+  ///
+  /// [depth] is the number of frames in flight at once, 2 for double buffering. Every input of the model must have
+  /// a fixed shape. See [OrtStream].
+  ///
+  /// Example:
+  /// ```dart
+  /// final stream = await session.openStream();
+  /// stream.frames.listen((frame) => draw(frame.outputs['output_name']!));
+  /// await for (final image in camera) {
+  ///   await stream.submit({'input_name': image});
+  /// }
+  /// await stream.close();
+  /// ```
+  Future<OrtStream> openStream({int depth = 2}) {
+    return OrtStream.open(this, depth: depth);
+  }
+
+  /// Gather concurrent [run] calls of this session into batches (Linux and Windows)
+  ///
+  /// [window] is the longest time a call waits for others to join its batch
+  /// [maxBatchSize] is the number of calls after which a batch runs at once
+  ///
+  /// A batch runs like [runBatch]: stacked along the batch dimension when the model allows it.
+  /// Calls that pass [OrtRunOptions] are never batched. Other platforms ignore this setting.
+  ///
+  /// Example:
+  /// ```dart
+  /// await session.enableMicroBatching(window: const Duration(milliseconds: 2), maxBatchSize: 8);
+  /// final results = await Future.wait(frames.map((frame) => session.run({'input_name': frame})));
+  /// ```
+  Future<void> enableMicroBatching({Duration window = const Duration(milliseconds: 2), int maxBatchSize = 16}) async {
+    await FlutterOnnxruntimePlatform.instance.configureBatching(
+      id,
+      windowMicros: window.inMicroseconds,
+      maxBatchSize: maxBatchSize,
+    );
+    _microBatching = maxBatchSize >= 2;
+  }
+
+  /// Stop batching [run] calls of this session; calls still waiting run right away
+  Future<void> disableMicroBatching() async {
+    await FlutterOnnxruntimePlatform.instance.configureBatching(id, windowMicros: 0, maxBatchSize: 0);
+    _microBatching = false;
+  }
+
+  /// Get the micro-batching statistics of this session
+  ///
+  /// Returns zeros if micro-batching is not enabled.
+  Future<OrtBatchingStats> getBatchingStats() async {
+    final statsMap = await FlutterOnnxruntimePlatform.instance.getBatchingStats(id);
+    return OrtBatchingStats.fromMap(statsMap);
+  }
+
+  /// Get the run counters and latency of this session measured natively
+  ///
+  /// On Linux and Windows, every `Session::Run` of the session is timed
+  /// without the method channel or `dart:ffi` call around it, so comparing
+  /// [OrtSessionStats.averageRunTime] with [OrtSessionStats.averageOverhead]
+  /// tells whether the model or the plumbing dominates. Warmup runs are not
+  /// counted. Other platforms report zeros.
+  Future<OrtSessionStats> getStats() async {
+    final statsMap = await FlutterOnnxruntimePlatform.instance.getSessionStats(id);
+    return OrtSessionStats.fromMap(statsMap);
+  }
+
+  /// Stop profiling this session and summarize the trace
+  ///
+  /// The session must have been created with [OrtSessionOptions.enableProfiling].
+  /// The returned [OrtProfile] holds the path of the trace file, which can be
+  /// opened in chrome://tracing or Perfetto, and the kernel time of each node
+  /// and operator type with the execution provider that ran it. Profiling
+  /// cannot be started again on the same session. Linux and Windows only.
+  Future<OrtProfile> endProfiling() async {
+    final profileMap = await FlutterOnnxruntimePlatform.instance.endProfiling(id);
+    return OrtProfile.fromMap(profileMap);
+  }
+
+  // Convert the (valueId, dataType, shape) entries returned by the platform into OrtValue objects; outputs returned
+  // inline are {data, dataType, shape} maps instead
+  Map<String, OrtValue> _toOrtValues(Map<String, dynamic> result) {
     final outputs = <String, OrtValue>{};
     for (final entry in result.entries) {
+      if (entry.value is Map) {
+        outputs[entry.key] = OrtValue.fromMap(Map<String, dynamic>.from(entry.value as Map));
+        continue;
+      }
       final tensorMap = {'valueId': entry.value[0], 'dataType': entry.value[1], 'shape': entry.value[2]};
       outputs[entry.key] = OrtValue.fromMap(tensorMap);
     }
@@ -74,34 +422,149 @@ class OrtSession {
   /// Get input info about the model
   ///
   /// Returns information about the model's inputs such as name, type, and shape.
+  /// On Linux and Windows, an input of a QDQ model that a QuantizeLinear or DequantizeLinear node reads also has a
+  /// `quantization` entry, the [OrtQuantization] to pass to [OrtValue.quantize].
   Future<List<Map<String, dynamic>>> getInputInfo() async {
     final inputInfoMap = await FlutterOnnxruntimePlatform.instance.getInputInfo(id);
-    return inputInfoMap.map((info) => Map<String, dynamic>.from(info)).toList();
+    return inputInfoMap.map(_readTensorInfo).toList();
   }
 
   /// Get output info about the model
   ///
   /// Returns information about the model's outputs such as name, type, and shape.
+  /// On Linux and Windows, an output of a QDQ model written by a QuantizeLinear or DequantizeLinear node also has a
+  /// `quantization` entry, the [OrtQuantization] to pass to [OrtValue.dequantize].
   Future<List<Map<String, dynamic>>> getOutputInfo() async {
     final outputInfoMap = await FlutterOnnxruntimePlatform.instance.getOutputInfo(id);
-    return outputInfoMap.map((info) => Map<String, dynamic>.from(info)).toList();
+    return outputInfoMap.map(_readTensorInfo).toList();
+  }
+
+  static Map<String, dynamic> _readTensorInfo(Map<String, dynamic> info) {
+    final tensorInfo = Map<String, dynamic>.from(info);
+    final quantization = tensorInfo['quantization'];
+    if (quantization is Map) {
+      tensorInfo['quantization'] = OrtQuantization.fromMap(Map<String, dynamic>.from(quantization));
+    }
+    return tensorInfo;
   }
 }
 
+/// How much ONNX Runtime optimizes a model's graph when a session is created
+enum OrtGraphOptimizationLevel {
+  /// No graph optimizations
+  disabled,
+
+  /// Semantics-preserving rewrites such as constant folding and redundant node elimination
+  basic,
+
+  /// Basic optimizations plus node fusions
+  extended,
+
+  /// Extended optimizations plus layout optimizations, the ONNX Runtime default
+  all,
+}
+
+/// How an arena grows when it runs out of memory
+enum OrtArenaExtendStrategy {
+  /// Reserve chunks twice as large each time, which suits allocations of the same sizes run after run
+  nextPowerOfTwo,
+
+  /// Reserve just the size requested, which keeps memory low when shapes vary
+  sameAsRequested,
+}
+
+/// Scheduling class of an inference call on Linux and Windows
+///
+/// Calls wait for a worker thread in one queue per priority, and a worker always takes the oldest call of the highest
+/// priority first. A [high] call that finds every worker busy terminates a running [low] call, which then fails with
+/// a `PlatformException` of code `RUN_PREEMPTED` and can be submitted again.
+enum OrtRunPriority {
+  /// Interactive work, e.g. answering a tap
+  high,
+
+  /// The default
+  normal,
+
+  /// Background work that may be preempted, e.g. indexing a photo library
+  low,
+}
+
 class OrtSessionOptions {
   // Sets the number of threads used to parallelize the execution within nodes
   final int? intraOpNumThreads;
   // Sets the number of threads used to parallelize the execution of the graph (across nodes)
   final int? interOpNumThreads;
   // set a list of providers, if one provider is not available, ORT will fallback to the next provider in the list
-  // for example: [OrtProvider.CUDA, OrtProvider.CPU]
+  // for example: [OrtProvider.CUDA, OrtProvider.CPU]; [OrtProvider.AUTO] picks the fastest available provider
   final List<OrtProvider>? providers;
-  // arena allocator for memory management, default is true
+  // arena allocator for memory management, default is true; models whose shapes vary from run to run can peak
+  // lower without one
   final bool? useArena;
+  // plan the memory of a run from the shapes of the previous runs and allocate it in one block, default is true;
+  // helps models with fixed input shapes (Linux, Windows and Android)
+  final bool? enableMemPattern;
+  // allocate initializers with the device allocator instead of the arena, so that they do not enlarge the arena
+  // (Linux, Windows and Android)
+  final bool? useDeviceAllocatorForInitializers;
   // set the device id for the session, default is 0
   final int? deviceId;
+  // how much the graph is optimized, default is OrtGraphOptimizationLevel.all (Linux, Windows and web)
+  final OrtGraphOptimizationLevel? graphOptimizationLevel;
+  // save the optimized graph in an app cache directory on the first load and load it without optimizing again
+  // next time, until the model file, ONNX Runtime version or options change (Linux and Windows)
+  final bool? cacheOptimizedModel;
+  // run the session this many times on zero-filled inputs before it is returned, so that the first real run
+  // does not pay for lazy kernel initialization (Linux and Windows)
+  final int? warmupRuns;
+  // sizes of the dynamic input dimensions used by the warmup runs, by symbolic dimension name; unlisted
+  // dynamic dimensions are 1
+  final Map<String, int>? warmupDimensions;
+  // write a trace of every run of the session until OrtSession.endProfiling() is called (Linux and Windows)
+  final bool? enableProfiling;
+  // directory of the trace file, an app cache directory by default
+  final String? profilingDirectory;
+  // options of an execution provider by provider, passed as key-value pairs to ONNX Runtime, e.g.
+  // {OrtProvider.TENSOR_RT: {'trt_fp16_enable': true, 'trt_engine_cache_enable': true}}; an enabled TensorRT
+  // engine or timing cache is kept in an app cache directory unless its path is given (CUDA and TensorRT on Linux
+  // and Windows, CoreML on iOS and macOS)
+  final Map<OrtProvider, Map<String, Object>>? providerOptions;
+
+  OrtSessionOptions({
+    this.intraOpNumThreads,
+    this.interOpNumThreads,
+    this.providers,
+    this.useArena,
+    this.enableMemPattern,
+    this.useDeviceAllocatorForInitializers,
+    this.deviceId,
+    this.graphOptimizationLevel,
+    this.cacheOptimizedModel,
+    this.warmupRuns,
+    this.warmupDimensions,
+    this.enableProfiling,
+    this.profilingDirectory,
+    this.providerOptions,
+  });
 
-  OrtSessionOptions({this.intraOpNumThreads, this.interOpNumThreads, this.providers, this.useArena, this.deviceId});
+  /// Copy of these options with another list of providers
+  OrtSessionOptions withProviders(List<OrtProvider> providers) {
+    return OrtSessionOptions(
+      intraOpNumThreads: intraOpNumThreads,
+      interOpNumThreads: interOpNumThreads,
+      providers: providers,
+      useArena: useArena,
+      enableMemPattern: enableMemPattern,
+      useDeviceAllocatorForInitializers: useDeviceAllocatorForInitializers,
+      deviceId: deviceId,
+      graphOptimizationLevel: graphOptimizationLevel,
+      cacheOptimizedModel: cacheOptimizedModel,
+      warmupRuns: warmupRuns,
+      warmupDimensions: warmupDimensions,
+      enableProfiling: enableProfiling,
+      profilingDirectory: profilingDirectory,
+      providerOptions: providerOptions,
+    );
+  }
 
   Map<String, dynamic> toMap() {
     return {
@@ -109,9 +572,56 @@ class OrtSessionOptions {
       if (interOpNumThreads != null) 'interOpNumThreads': interOpNumThreads,
       if (providers != null && providers!.isNotEmpty) 'providers': providers!.map((p) => p.name).toList(),
       if (useArena != null) 'useArena': useArena,
+      if (enableMemPattern != null) 'enableMemPattern': enableMemPattern,
+      if (useDeviceAllocatorForInitializers != null)
+        'useDeviceAllocatorForInitializers': useDeviceAllocatorForInitializers,
       if (deviceId != null) 'deviceId': deviceId,
+      if (graphOptimizationLevel != null) 'graphOptimizationLevel': graphOptimizationLevel!.name,
+      if (cacheOptimizedModel != null) 'cacheOptimizedModel': cacheOptimizedModel,
+      if (warmupRuns != null) 'warmupRuns': warmupRuns,
+      if (warmupDimensions != null) 'warmupDimensions': warmupDimensions,
+      if (enableProfiling != null) 'enableProfiling': enableProfiling,
+      if (profilingDirectory != null) 'profilingDirectory': profilingDirectory,
+      if (providerOptions != null)
+        'providerOptions': {
+          for (final entry in providerOptions!.entries)
+            entry.key.name: {
+              for (final option in entry.value.entries) option.key: _providerOptionValue(option.value),
+            },
+        },
     };
   }
+
+  // ONNX Runtime parses every provider option from a string, and flags from "1" and "0"
+  static String _providerOptionValue(Object value) {
+    if (value is bool) {
+      return value ? '1' : '0';
+    }
+    return value.toString();
+  }
+}
+
+/// Handle of inference calls, for cancelling them after they were submitted
+///
+/// Pass the handle to [OrtRunOptions.handle] of one or more calls, then call [cancel] to stop the calls still in
+/// flight, e.g. when the user navigates away from the screen that needs their results. A cancelled call fails with
+/// a `PlatformException` of code `RUN_CANCELLED`. Only Linux and Windows cancel calls.
+class OrtRunHandle {
+  static int _nextId = 0;
+
+  // Tells apart the handles of isolates, whose counters all start at 0 but share the native run registry
+  static final String _isolateTag = Random().nextInt(1 << 32).toRadixString(36);
+
+  /// Tag the platform knows the calls of this handle by
+  final String id = 'run_${_isolateTag}_${_nextId++}';
+
+  /// Stop the calls of this handle that are queued or running
+  ///
+  /// Running calls stop as if [OrtRunOptions.terminate] had been set; queued calls fail as soon as they start.
+  /// Returns false if no call of this handle is in flight, e.g. because they have all finished.
+  Future<bool> cancel() {
+    return FlutterOnnxruntimePlatform.instance.cancelRun(id);
+  }
 }
 
 class OrtRunOptions {
@@ -125,14 +635,45 @@ class OrtRunOptions {
   final int? logVerbosityLevel;
   // terminate all incomplete inference using this instance as soon as possible
   final bool? terminate;
+  // keep the outputs of OrtSession.run in the memory of a device instead of copying them to the host, e.g. to pass
+  // them to the next session of a pipeline (Linux and Windows)
+  final OrtDevice? outputDevice;
+  // return the outputs of OrtSession.run of at most this many bytes as data instead of registering them as native
+  // tensors, saving a getOrtValueData and a releaseOrtValue call per output; string outputs and larger ones stay
+  // native tensors (Linux and Windows)
+  final int? returnDataMaxBytes;
+  // queue the call by this priority for a worker thread; low-priority calls may be terminated in favor of high-priority
+  // ones (Linux and Windows)
+  final OrtRunPriority? priority;
+  // cancel the call through this handle (Linux and Windows)
+  final OrtRunHandle? handle;
+  // cancel the call if it has not finished this long after it was submitted, time in the queue included; it then
+  // fails with a PlatformException of code RUN_TIMEOUT (Linux and Windows)
+  final Duration? timeout;
 
-  OrtRunOptions({this.logSeverityLevel, this.logVerbosityLevel, this.terminate});
+  OrtRunOptions({
+    this.logSeverityLevel,
+    this.logVerbosityLevel,
+    this.terminate,
+    this.outputDevice,
+    this.returnDataMaxBytes,
+    this.priority,
+    this.handle,
+    this.timeout,
+  });
 
   Map<String, dynamic> toMap() {
     return {
       if (logSeverityLevel != null) 'logSeverityLevel': logSeverityLevel,
       if (logVerbosityLevel != null) 'logVerbosityLevel': logVerbosityLevel,
       if (terminate != null) 'terminate': terminate,
+      if (outputDevice != null) 'outputDevice': outputDevice!.type,
+      if (outputDevice != null) 'outputDeviceId': outputDevice!.id,
+      if (returnDataMaxBytes != null) 'returnDataMaxBytes': returnDataMaxBytes,
+      if (priority != null) 'priority': priority!.name,
+      if (handle != null) 'runTag': handle!.id,
+      // Rounded up, so that a timeout below a millisecond still sets a deadline
+      if (timeout != null) 'timeoutMs': (timeout!.inMicroseconds + 999) ~/ 1000,
     };
   }
 }
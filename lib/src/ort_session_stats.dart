@@ -0,0 +1,90 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+class OrtSessionStats {
+  /// Number of times `Session::Run` ran
+  final int runs;
+
+  /// Total time spent in `Session::Run`
+  final Duration runTime;
+
+  /// Median latency of `Session::Run`, within about 6%
+  final Duration p50;
+
+  /// 90th percentile latency of `Session::Run`, within about 6%
+  final Duration p90;
+
+  /// 99th percentile latency of `Session::Run`, within about 6%
+  final Duration p99;
+
+  /// Number of calls that reported the time spent around their runs
+  final int calls;
+
+  /// Total time those calls spent borrowing their input tensors
+  final Duration inputTime;
+
+  /// Total time those calls spent storing and describing their output tensors
+  final Duration outputTime;
+
+  /// Total bytes of the fixed-size input tensors of all runs, string tensors not included
+  final int bytesIn;
+
+  /// Total bytes of the fixed-size output tensors of all runs, string tensors not included
+  final int bytesOut;
+
+  OrtSessionStats({
+    required this.runs,
+    required this.runTime,
+    required this.p50,
+    required this.p90,
+    required this.p99,
+    required this.calls,
+    required this.inputTime,
+    required this.outputTime,
+    required this.bytesIn,
+    required this.bytesOut,
+  });
+
+  factory OrtSessionStats.fromMap(Map<String, dynamic> map) {
+    Duration micros(String key) => Duration(microseconds: map[key] as int? ?? 0);
+    return OrtSessionStats(
+      runs: map['runs'] as int? ?? 0,
+      runTime: micros('runMicros'),
+      p50: micros('p50Micros'),
+      p90: micros('p90Micros'),
+      p99: micros('p99Micros'),
+      calls: map['calls'] as int? ?? 0,
+      inputTime: micros('inputMicros'),
+      outputTime: micros('outputMicros'),
+      bytesIn: map['bytesIn'] as int? ?? 0,
+      bytesOut: map['bytesOut'] as int? ?? 0,
+    );
+  }
+
+  /// Average time of one `Session::Run`, zero if the session never ran
+  Duration get averageRunTime => runs == 0 ? Duration.zero : runTime ~/ runs;
+
+  /// Average time a call spent on its inputs and outputs outside `Session::Run`, zero if nothing was reported
+  Duration get averageOverhead => calls == 0 ? Duration.zero : (inputTime + outputTime) ~/ calls;
+
+  /// Converts the statistics to a Map
+  ///
+  /// Returns a map representation of the session statistics
+  Map<String, dynamic> toMap() {
+    return {
+      'runs': runs,
+      'runMicros': runTime.inMicroseconds,
+      'p50Micros': p50.inMicroseconds,
+      'p90Micros': p90.inMicroseconds,
+      'p99Micros': p99.inMicroseconds,
+      'calls': calls,
+      'inputMicros': inputTime.inMicroseconds,
+      'outputMicros': outputTime.inMicroseconds,
+      'bytesIn': bytesIn,
+      'bytesOut': bytesOut,
+    };
+  }
+}
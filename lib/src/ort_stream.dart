@@ -0,0 +1,227 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+import 'dart:async';
+import 'dart:collection';
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+
+import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_session.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart';
+
+/// Outputs of one frame run by an [OrtStream]
+class OrtStreamFrame {
+  /// Number of the frame, counting the frames submitted to the stream from 0
+  final int frame;
+
+  /// Flattened data of each output by name, as returned by [OrtValue.asFlattenedList]
+  final Map<String, List<dynamic>> outputs;
+
+  /// Shape of each output by name
+  final Map<String, List<int>> shapes;
+
+  OrtStreamFrame({required this.frame, required this.outputs, required this.shapes});
+
+  factory OrtStreamFrame.fromMap(int frame, Map<Object?, Object?> outputs) {
+    final data = <String, List<dynamic>>{};
+    final shapes = <String, List<int>>{};
+    outputs.forEach((name, value) {
+      final output = value as Map<Object?, Object?>;
+      final rawData = output['data'];
+      data[name.toString()] = rawData is List ? rawData : List<dynamic>.from(rawData as Iterable);
+      shapes[name.toString()] = List<int>.from(output['shape'] as List);
+    });
+    return OrtStreamFrame(frame: frame, outputs: data, shapes: shapes);
+  }
+}
+
+/// A pipelined stream of frames through a session, opened by [OrtSession.openStream]
+///
+/// Up to [depth] frames are in flight at once: while one frame runs, the inputs of the next are copied into a free
+/// slot and the outputs of the previous one are read back. [submit] waits only for a free slot, and the outputs
+/// arrive on [frames] in submission order.
+///
+/// On Linux and Windows the slots are tensors preallocated natively and each frame costs a single platform call,
+/// with its outputs sent back as an event. Other platforms emulate the stream with [OrtValue] calls, keeping the
+/// same number of frames in flight.
+class OrtStream {
+  /// ID of the native stream, or null if the stream is emulated
+  final String? id;
+
+  /// Number of frames that can be in flight at once
+  final int depth;
+
+  final OrtSession _session;
+
+  // Input info of the session, only needed to shape the inputs of an emulated stream
+  final List<Map<String, dynamic>> _inputInfo;
+
+  final StreamController<OrtStreamFrame> _frames = StreamController<OrtStreamFrame>();
+  StreamSubscription<Map<String, dynamic>>? _events;
+
+  // Frames submitted and not delivered yet, and the callers of submit waiting for one of them to finish
+  int _inFlight = 0;
+  final Queue<Completer<void>> _slotWaiters = Queue<Completer<void>>();
+
+  // Results that arrived ahead of an earlier frame, delivered once the frames before them are
+  final Map<int, Object> _completed = {};
+  int _nextDelivered = 0;
+  int _nextEmulatedFrame = 0;
+
+  bool _closed = false;
+  Completer<void>? _drained;
+
+  OrtStream._(this.id, this.depth, this._session, this._inputInfo) {
+    final streamId = id;
+    if (streamId != null) {
+      _events = FlutterOnnxruntimePlatform.instance.streamEvents
+          .where((event) => event['streamId']?.toString() == streamId)
+          .listen(_onEvent);
+    }
+  }
+
+  /// Open a stream through [session], natively where the platform supports it
+  static Future<OrtStream> open(OrtSession session, {int depth = 2}) async {
+    if (depth < 1) {
+      throw ArgumentError.value(depth, 'depth', 'must be positive');
+    }
+    try {
+      final result = await FlutterOnnxruntimePlatform.instance.openStream(session.id, depth: depth);
+      return OrtStream._((result['streamId'] as Object).toString(), depth, session, const []);
+    } on UnsupportedError {
+      return OrtStream._(null, depth, session, await session.getInputInfo());
+    }
+  }
+
+  /// Outputs of every frame in submission order; a frame that failed to run is delivered as an error
+  Stream<OrtStreamFrame> get frames => _frames.stream;
+
+  /// Submit the inputs of the next frame, waiting while [depth] frames are in flight
+  ///
+  /// [inputs] maps every input of the session to data of the input's element type and exact size; other typed
+  /// data is sent as its raw element bytes, e.g. a Uint16List holding float16 values.
+  ///
+  /// Returns the number of the frame, which its [OrtStreamFrame] carries.
+  Future<int> submit(Map<String, TypedData> inputs, {OrtRunOptions? options}) async {
+    while (!_closed && _inFlight >= depth) {
+      final waiter = Completer<void>();
+      _slotWaiters.add(waiter);
+      await waiter.future;
+    }
+    if (_closed) {
+      throw StateError('Stream is closed');
+    }
+
+    _inFlight++;
+    final streamId = id;
+    if (streamId == null) {
+      final frame = _nextEmulatedFrame++;
+      unawaited(_runEmulated(frame, inputs, options));
+      return frame;
+    }
+
+    try {
+      final result = await FlutterOnnxruntimePlatform.instance.submitStreamFrame(
+        streamId,
+        inputs,
+        runOptions: options?.toMap() ?? {},
+      );
+      return result['frame'] as int;
+    } catch (_) {
+      _finishFrame();
+      rethrow;
+    }
+  }
+
+  /// Close the stream after the frames in flight have been delivered
+  Future<void> close() async {
+    if (_closed) {
+      return;
+    }
+    _closed = true;
+    while (_slotWaiters.isNotEmpty) {
+      _slotWaiters.removeFirst().complete();
+    }
+    if (_inFlight > 0) {
+      _drained = Completer<void>();
+      await _drained!.future;
+    }
+    await _events?.cancel();
+    final streamId = id;
+    if (streamId != null) {
+      await FlutterOnnxruntimePlatform.instance.closeStream(streamId);
+    }
+    await _frames.close();
+  }
+
+  void _onEvent(Map<String, dynamic> event) {
+    final frame = event['frame'] as int;
+    final error = event['error'];
+    if (error != null) {
+      _complete(frame, PlatformException(code: 'INFERENCE_ERROR', message: error.toString()));
+    } else {
+      _complete(frame, OrtStreamFrame.fromMap(frame, event['outputs'] as Map<Object?, Object?>));
+    }
+  }
+
+  // Run a frame with OrtValue calls, on platforms without native streams
+  Future<void> _runEmulated(int frame, Map<String, TypedData> inputs, OrtRunOptions? options) async {
+    final values = <String, OrtValue>{};
+    Map<String, OrtValue> outputs = {};
+    try {
+      for (final info in _inputInfo) {
+        final name = info['name'] as String;
+        final data = inputs[name];
+        if (data is! List) {
+          throw ArgumentError('Input $name must be typed data of type ${info['type']}');
+        }
+        final shape = List<int>.from(info['shape'] as List? ?? const []);
+        values[name] = await OrtValue.fromList(data, shape);
+      }
+      outputs = await _session.run(values, options: options);
+      final data = <String, List<dynamic>>{};
+      final shapes = <String, List<int>>{};
+      for (final entry in outputs.entries) {
+        data[entry.key] = await entry.value.asFlattenedList();
+        shapes[entry.key] = entry.value.shape;
+      }
+      _complete(frame, OrtStreamFrame(frame: frame, outputs: data, shapes: shapes));
+    } catch (e) {
+      _complete(frame, e);
+    } finally {
+      for (final value in [...values.values, ...outputs.values]) {
+        await value.dispose();
+      }
+    }
+  }
+
+  // Deliver the result of a frame, and of the frames after it that finished first
+  void _complete(int frame, Object result) {
+    _completed[frame] = result;
+    while (_completed.containsKey(_nextDelivered)) {
+      final next = _completed.remove(_nextDelivered)!;
+      _nextDelivered++;
+      if (next is OrtStreamFrame) {
+        _frames.add(next);
+      } else {
+        _frames.addError(next);
+      }
+      _finishFrame();
+    }
+  }
+
+  void _finishFrame() {
+    _inFlight--;
+    if (_slotWaiters.isNotEmpty) {
+      _slotWaiters.removeFirst().complete();
+    }
+    if (_inFlight == 0 && _drained != null && !_drained!.isCompleted) {
+      _drained!.complete();
+    }
+  }
+}
@@ -4,15 +4,20 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:async';
 import 'dart:typed_data';
 
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_native_stub.dart'
+    if (dart.library.ffi) 'package:flutter_onnxruntime/src/ort_native.dart';
+import 'package:flutter_onnxruntime/src/ort_quantization.dart';
 
 /// Represents a data type in ONNX Runtime
 enum OrtDataType {
   // Numeric types
   float32,
   float16,
+  float64,
   int32,
   int64,
   int16,
@@ -34,6 +39,50 @@ enum OrtDataType {
   bfloat16,
 }
 
+/// Pixel layout of an image passed to [OrtValue.fromImage]
+enum OrtImageFormat {
+  /// 8-bit red, green, blue and alpha per pixel
+  rgba,
+
+  /// 8-bit blue, green, red and alpha per pixel
+  bgra,
+
+  /// 8-bit red, green and blue per pixel
+  rgb,
+
+  /// 8-bit blue, green and red per pixel
+  bgr,
+
+  /// Full-size Y plane followed by interleaved V/U at half resolution, as produced by Android cameras
+  nv21,
+}
+
+/// Dimension order of an image tensor
+enum OrtTensorLayout {
+  /// Batch, channels, height, width
+  nchw,
+
+  /// Batch, height, width, channels
+  nhwc,
+}
+
+/// Call [visit] on [object] if it is an OrtValue, and on every OrtValue in it if it is a list, set or map,
+/// e.g. on the result of a computation sent between isolates
+void visitOrtValues(Object? object, void Function(OrtValue value) visit) {
+  if (object is OrtValue) {
+    visit(object);
+  } else if (object is Iterable) {
+    for (final element in object) {
+      visitOrtValues(element, visit);
+    }
+  } else if (object is Map) {
+    for (final entry in object.entries) {
+      visitOrtValues(entry.key, visit);
+      visitOrtValues(entry.value, visit);
+    }
+  }
+}
+
 /// OrtValue represents a tensor or other data structure used for input/output in ONNX Runtime.
 ///
 /// This class manages memory for tensor data and provides methods for data type conversion.
@@ -49,27 +98,163 @@ class OrtValue {
   /// Shape of the tensor as a list of dimensions
   final List<int> shape;
 
+  // Data of a small output that runInference returned inline, or null for a value held by the native side
+  final List<dynamic>? _inlineData;
+
   /// Private constructor
-  OrtValue._({required this.id, required this.dataType, required this.shape});
+  OrtValue._({required this.id, required this.dataType, required this.shape, List<dynamic>? inlineData})
+    : _inlineData = inlineData {
+    OrtValueScope._current?._values.add(this);
+    if (inlineData == null) {
+      _track();
+    }
+  }
+
+  /// Whether native tensors are released once every OrtValue referring to them has been garbage collected
+  ///
+  /// On by default, so that a value never disposed does not hold its native tensor forever. The garbage collector
+  /// may take a long while to get to a value, so [dispose], [releaseAll] and scopes are still the way to release
+  /// tensors promptly. Only values created while this is on are released this way. The values returned by
+  /// `OrtSession.bindOutputs` must stay reachable while the binding is in use.
+  static bool autoRelease = true;
+
+  // Native tensors that OrtValues still refer to. Several OrtValues can share an ID, e.g. the outputs of every
+  // `OrtSession.runWithBinding` call, so a tensor is only released with the last of them.
+  static final Map<String, _TrackedTensor> _tracked = {};
+  static final Finalizer<String> _finalizer = Finalizer(_releaseUnreachable);
+  // Values counted in _tracked. An Expando rather than a field, as a value sent to another isolate arrives there as
+  // a copy that the other isolate does not count until it is adopted.
+  static final Expando<bool> _trackedHere = Expando('OrtValue tracking');
+  static int _trackedBytes = 0;
+  static int? _softLimitBytes;
+  static void Function(int trackedBytes)? _onSoftLimit;
+
+  /// Bytes of the native tensors that OrtValues refer to and that have not been released
+  ///
+  /// Only tensors of fixed-size types are counted. Tensors that native code holds on its own, such as the sequence
+  /// state of a session, are not; `OnnxRuntime.getMemoryStats` reports those on Linux and Windows.
+  static int get trackedBytes => _trackedBytes;
+
+  /// Call [onExceeded] whenever [trackedBytes] rises above [limitBytes]
+  ///
+  /// Dart cannot be told to collect garbage, so this is a hint to the app instead: [onExceeded] runs in a microtask
+  /// with the tracked bytes after each crossing of the limit, and can release caches, end scopes or dispose values
+  /// it no longer needs. A null limit removes it. `OnnxRuntime.setMemoryLimit` sets a limit that is enforced.
+  static void setSoftMemoryLimit(int? limitBytes, {void Function(int trackedBytes)? onExceeded}) {
+    if (limitBytes != null && limitBytes < 1) {
+      throw ArgumentError.value(limitBytes, 'limitBytes', 'must be a positive integer');
+    }
+    if (limitBytes != null && onExceeded == null) {
+      throw ArgumentError.notNull('onExceeded');
+    }
+    _softLimitBytes = limitBytes;
+    _onSoftLimit = onExceeded;
+  }
+
+  // Count this value as a reference to its native tensor
+  void _track() {
+    _trackedHere[this] = true;
+    final tracked = _tracked[id];
+    if (tracked != null) {
+      tracked.references++;
+    } else {
+      final bytes = _byteSize();
+      _tracked[id] = _TrackedTensor(bytes);
+      final limit = _softLimitBytes;
+      final onSoftLimit = _onSoftLimit;
+      if (limit != null && onSoftLimit != null && _trackedBytes <= limit && _trackedBytes + bytes > limit) {
+        scheduleMicrotask(() => onSoftLimit(_trackedBytes));
+      }
+      _trackedBytes += bytes;
+    }
+    if (autoRelease) {
+      _finalizer.attach(this, id, detach: this);
+    }
+  }
+
+  // Stop counting the native tensor of this value, which is being released
+  void _untrack() {
+    _trackedHere[this] = null;
+    _finalizer.detach(this);
+    final tracked = _tracked.remove(id);
+    if (tracked != null) {
+      _trackedBytes -= tracked.bytes;
+    }
+  }
+
+  // Bytes of the data of a fixed-size tensor, 0 for strings
+  int _byteSize() {
+    final elementSize = _elementSizes[dataType];
+    if (elementSize == null) {
+      return 0;
+    }
+    return shape.fold(elementSize, (bytes, dim) => bytes * (dim > 0 ? dim : 0));
+  }
+
+  // Called by the finalizer for each unreachable OrtValue; releases the tensor once none refers to it anymore
+  static void _releaseUnreachable(String valueId) {
+    final tracked = _tracked[valueId];
+    if (tracked == null || --tracked.references > 0) {
+      return;
+    }
+    _tracked.remove(valueId);
+    _trackedBytes -= tracked.bytes;
+    unawaited(_releaseById(valueId).catchError((Object _) {}));
+  }
+
+  static Future<void> _releaseById(String valueId) async {
+    if (await releaseNativeTensor(valueId)) {
+      return;
+    }
+    await FlutterOnnxruntimePlatform.instance.releaseOrtValue(valueId);
+  }
+
+  /// Whether this value holds its data in Dart instead of referring to a native tensor
+  ///
+  /// Outputs at most `OrtRunOptions.returnDataMaxBytes` in size come back inline. They have no native tensor, so
+  /// they cannot be passed as inputs or converted with [to], and [dispose] does nothing.
+  bool get isInline => _inlineData != null;
+
+  /// Size in bytes of one element of every type that [fromBytes] accepts
+  static const Map<OrtDataType, int> _elementSizes = {
+    OrtDataType.float32: 4,
+    OrtDataType.float16: 2,
+    OrtDataType.bfloat16: 2,
+    OrtDataType.float64: 8,
+    OrtDataType.int8: 1,
+    OrtDataType.uint8: 1,
+    OrtDataType.int16: 2,
+    OrtDataType.uint16: 2,
+    OrtDataType.int32: 4,
+    OrtDataType.uint32: 4,
+    OrtDataType.int64: 8,
+    OrtDataType.uint64: 8,
+    OrtDataType.bool: 1,
+  };
 
   /// Creates an OrtValue from a map returned by the platform interface
+  ///
+  /// A map holding `data` instead of a `valueId` is an output returned inline, whose data stays in Dart.
   factory OrtValue.fromMap(Map<String, dynamic> map) {
+    final data = map['data'];
     return OrtValue._(
-      id: map['valueId'] as String,
+      id: data != null ? '' : (map['valueId'] as Object).toString(),
       dataType: OrtDataType.values.firstWhere(
         (dt) => dt.toString() == 'OrtDataType.${map['dataType']}',
         // throw an exception if the data type is not found
         orElse: () => throw ArgumentError('Invalid data type: ${map['dataType']}'),
       ),
       shape: List<int>.from(map['shape'] ?? []),
+      inlineData: data != null ? List<dynamic>.from(data as List) : null,
     );
   }
 
   /// Creates an OrtValue from any supported list type
   ///
   /// This method detects the list type and converts it to the appropriate format.
-  /// Supported types include Float32List, Int32List, Int64List, Uint8List, List\<bool>,
-  /// List\<String>, and their corresponding Dart List\<num> types.
+  /// Supported types include Float32List, Float64List, Int32List, Int64List, Uint8List, List\<bool>,
+  /// List\<String>, and their corresponding Dart List\<num> types. Int8List, Int16List, Uint16List,
+  /// Uint32List and Uint64List are sent as raw bytes through [fromBytes] (Linux and Windows only).
   ///
   /// Note:
   /// - The shape of the list is not necessary to be in the correct shapes as they will be flattened in
@@ -83,11 +268,29 @@ class OrtValue {
   /// [shape] is the shape of the tensor
   static Future<OrtValue> fromList(dynamic data, List<int> shape) async {
     // If data is a regular List, convert it to the appropriate TypedData
-    if (data is List &&
-        !(data is Float32List || data is Int32List || data is Int64List || data is Uint8List || data is List<String>)) {
+    if (data is List && data is! TypedData && data is! List<String>) {
       data = _convertListToTypedData(data);
     }
 
+    // Typed lists without a counterpart on the method channel are sent as their raw bytes
+    OrtDataType? bytesType;
+    if (data is Int8List) {
+      bytesType = OrtDataType.int8;
+    } else if (data is Int16List) {
+      bytesType = OrtDataType.int16;
+    } else if (data is Uint16List) {
+      bytesType = OrtDataType.uint16;
+    } else if (data is Uint32List) {
+      bytesType = OrtDataType.uint32;
+    } else if (data is Uint64List) {
+      bytesType = OrtDataType.uint64;
+    }
+    if (bytesType != null) {
+      final typedData = data as TypedData;
+      final bytes = typedData.buffer.asUint8List(typedData.offsetInBytes, typedData.lengthInBytes);
+      return fromBytes(bytes, bytesType, shape);
+    }
+
     // Validate data length against shape
     int expectedElements = _calculateExpectedElements(shape);
     int actualElements = _getElementCount(data);
@@ -103,6 +306,8 @@ class OrtValue {
 
     if (data is Float32List) {
       sourceType = 'float32';
+    } else if (data is Float64List) {
+      sourceType = 'float64';
     } else if (data is Int32List) {
       sourceType = 'int32';
     } else if (data is Int64List) {
@@ -117,63 +322,445 @@ class OrtValue {
       throw ArgumentError('Unsupported data type: ${data.runtimeType}');
     }
 
+    // On Linux and Windows typed data is copied straight into the native tensor through dart:ffi
+    if (data is TypedData) {
+      final nativeResult = await createNativeTensor(sourceType, data, shape);
+      if (nativeResult != null) {
+        return OrtValue.fromMap(nativeResult);
+      }
+    }
+
     final result = await FlutterOnnxruntimePlatform.instance.createOrtValue(sourceType, data, shape);
     return OrtValue.fromMap(result);
   }
 
+  /// Creates an OrtValue from the raw element bytes of any fixed-size type (Linux and Windows)
+  ///
+  /// This is the way to create tensors of types that have no Dart list type, such as float16 and bfloat16,
+  /// without converting through float32. The bytes are copied once, straight into the native tensor.
+  ///
+  /// [bytes] holds the elements in native (little-endian) byte order, e.g. `halfValues.buffer.asUint8List()`
+  /// [dataType] is the element type; string and complex types are not supported
+  /// [shape] is the shape of the tensor, its element count times the element size must match [bytes]
+  ///
+  /// Example:
+  /// ```dart
+  /// final halfBits = Uint16List.fromList([0x3C00, 0x4000]); // 1.0 and 2.0 as float16
+  /// final tensor = await OrtValue.fromBytes(halfBits.buffer.asUint8List(), OrtDataType.float16, [2]);
+  /// ```
+  static Future<OrtValue> fromBytes(Uint8List bytes, OrtDataType dataType, List<int> shape) async {
+    final elementSize = _elementSizes[dataType];
+    if (elementSize == null) {
+      throw ArgumentError('Cannot create a ${dataType.toString().split('.').last} tensor from raw bytes');
+    }
+
+    final expectedBytes = _calculateExpectedElements(shape) * elementSize;
+    if (bytes.length != expectedBytes) {
+      throw ArgumentError(
+        'Shape/data size mismatch: data has ${bytes.length} bytes, '
+        'but shape $shape requires $expectedBytes bytes',
+      );
+    }
+
+    final typeName = dataType.toString().split('.').last;
+    final nativeResult = await createNativeTensor(typeName, bytes, shape);
+    if (nativeResult != null) {
+      return OrtValue.fromMap(nativeResult);
+    }
+
+    final result = await FlutterOnnxruntimePlatform.instance.createOrtValue(typeName, bytes, shape);
+    return OrtValue.fromMap(result);
+  }
+
+  /// Creates a normalized RGB image tensor from raw pixels in one native pass (Linux and Windows)
+  ///
+  /// The pixels are resized, converted to RGB, scaled to [0, 1], normalized as `(value - mean) / std` per channel
+  /// and laid out as a `[1, 3, height, width]` (NCHW) or `[1, height, width, 3]` (NHWC) tensor, on several threads
+  /// for large images. This replaces creating a uint8 tensor, converting it and transposing in Dart.
+  ///
+  /// [pixels] holds the image in [format]
+  /// [width] and [height] are the size of the image
+  /// [targetWidth] and [targetHeight] resize the image with bilinear filtering; they default to the image size
+  /// [mean] and [std] are the per-channel (R, G, B) mean and standard deviation, e.g. `[0.485, 0.456, 0.406]` and
+  /// `[0.229, 0.224, 0.225]` for ImageNet models; they default to 0 and 1
+  /// [layout] is the dimension order of the tensor
+  /// [dataType] is float32 or float16
+  ///
+  /// Example:
+  /// ```dart
+  /// final input = await OrtValue.fromImage(
+  ///   frame,
+  ///   format: OrtImageFormat.rgba,
+  ///   width: 1280,
+  ///   height: 720,
+  ///   targetWidth: 224,
+  ///   targetHeight: 224,
+  ///   mean: [0.485, 0.456, 0.406],
+  ///   std: [0.229, 0.224, 0.225],
+  /// );
+  /// ```
+  static Future<OrtValue> fromImage(
+    Uint8List pixels, {
+    required OrtImageFormat format,
+    required int width,
+    required int height,
+    int? targetWidth,
+    int? targetHeight,
+    List<double>? mean,
+    List<double>? std,
+    OrtTensorLayout layout = OrtTensorLayout.nchw,
+    OrtDataType dataType = OrtDataType.float32,
+  }) async {
+    if (dataType != OrtDataType.float32 && dataType != OrtDataType.float16) {
+      throw ArgumentError('Image tensors must be float32 or float16, got ${dataType.name}');
+    }
+    if ((mean != null && mean.length != 3) || (std != null && std.length != 3)) {
+      throw ArgumentError('mean and std must have one value per channel');
+    }
+
+    final result = await FlutterOnnxruntimePlatform.instance.createImageTensor(
+      pixels,
+      format: format.name,
+      width: width,
+      height: height,
+      targetWidth: targetWidth,
+      targetHeight: targetHeight,
+      mean: mean,
+      std: std,
+      layout: layout.name,
+      dataType: dataType.name,
+    );
+    return OrtValue.fromMap(result);
+  }
+
   /// Convert this tensor to a different data type
   ///
   /// [targetType] is the target data type to convert to
   Future<OrtValue> to(OrtDataType targetType) async {
+    if (isInline) {
+      throw StateError('An inline OrtValue has no native tensor to convert, create one with fromList()');
+    }
     final result = await FlutterOnnxruntimePlatform.instance.convertOrtValue(id, targetType.toString().split('.').last);
     return OrtValue.fromMap(result);
   }
 
+  /// Quantize this tensor into a new int8 or uint8 tensor (Linux and Windows)
+  ///
+  /// Each element becomes `round(x / scale) + zeroPoint`, rounded half to even and saturated, as in the ONNX
+  /// QuantizeLinear op. Tensors of other numeric types than float32 are widened to float32 first. For a QDQ model,
+  /// the `quantization` entry of an input in [OrtSession.getInputInfo] is the [quantization] the model expects.
+  Future<OrtValue> quantize(OrtQuantization quantization) async {
+    if (isInline) {
+      throw StateError('An inline OrtValue has no native tensor to quantize, create one with fromList()');
+    }
+    final result = await FlutterOnnxruntimePlatform.instance.quantizeOrtValue(
+      id,
+      scales: quantization.scales,
+      zeroPoints: quantization.zeroPoints,
+      axis: quantization.axis,
+      dataType: quantization.dataType.name,
+    );
+    return OrtValue.fromMap(result);
+  }
+
+  /// Dequantize this int8 or uint8 tensor into a new float32 tensor (Linux and Windows)
+  ///
+  /// Each element becomes `(q - zeroPoint) * scale`, as in the ONNX DequantizeLinear op; the data type of
+  /// [quantization] is ignored in favor of the type of this tensor.
+  Future<OrtValue> dequantize(OrtQuantization quantization) async {
+    if (isInline) {
+      throw StateError('An inline OrtValue has no native tensor to dequantize, create one with fromList()');
+    }
+    if (dataType != OrtDataType.int8 && dataType != OrtDataType.uint8) {
+      throw StateError('Only int8 and uint8 tensors can be dequantized, this one is ${dataType.name}');
+    }
+    final result = await FlutterOnnxruntimePlatform.instance.dequantizeOrtValue(
+      id,
+      scales: quantization.scales,
+      zeroPoints: quantization.zeroPoints,
+      axis: quantization.axis,
+    );
+    return OrtValue.fromMap(result);
+  }
+
+  /// Reshape this tensor into a new tensor that shares its data (Linux and Windows)
+  ///
+  /// A 0 in [shape] keeps the dimension at that index and one dimension may be -1, inferred from the others, as in
+  /// the ONNX Reshape op. No data is copied: the new tensor keeps the data alive after this one is disposed, and
+  /// writes to either through [asTypedData] show in both.
+  Future<OrtValue> reshape(List<int> shape) async {
+    _checkNative('reshape');
+    return OrtValue.fromMap(await FlutterOnnxruntimePlatform.instance.reshapeOrtValue(id, shape));
+  }
+
+  /// Slice this tensor along [axis] from [start] to [end] into a new tensor (Linux and Windows)
+  ///
+  /// Negative bounds count from the end of the axis and both are clamped to it, as in the ONNX Slice op. When every
+  /// axis before [axis] has size 1, e.g. slicing the batch axis, the slice shares the data of this tensor like
+  /// [reshape]; otherwise it is a copy.
+  Future<OrtValue> slice(int axis, int start, int end) async {
+    _checkNative('slice');
+    return OrtValue.fromMap(await FlutterOnnxruntimePlatform.instance.sliceOrtValue(id, axis, start, end));
+  }
+
+  /// Take the entry at [index] along [axis], dropping the axis, e.g. one image of a batch (Linux and Windows)
+  ///
+  /// The result shares data with this tensor or is a copy, as in [slice].
+  Future<OrtValue> select(int axis, int index) async {
+    _checkNative('select');
+    return OrtValue.fromMap(await FlutterOnnxruntimePlatform.instance.sliceOrtValue(id, axis, index));
+  }
+
+  /// Permute the axes of this tensor into a new tensor, e.g. NHWC to NCHW with `[0, 3, 1, 2]` (Linux and Windows)
+  ///
+  /// Axis i of the result is axis `perm[i]` of this tensor; without [perm] the axes are reversed, as in the ONNX
+  /// Transpose op.
+  Future<OrtValue> transpose([List<int>? perm]) async {
+    _checkNative('transpose');
+    return OrtValue.fromMap(await FlutterOnnxruntimePlatform.instance.transposeOrtValue(id, perm));
+  }
+
+  /// Concatenate tensors of one type along [axis] into a new tensor (Linux and Windows)
+  ///
+  /// The tensors must match in every dimension but [axis], e.g. to batch several inputs of shape `[1, ...]` on
+  /// axis 0.
+  static Future<OrtValue> concat(List<OrtValue> values, {int axis = 0}) async {
+    if (values.isEmpty) {
+      throw ArgumentError.value(values, 'values', 'must not be empty');
+    }
+    for (final value in values) {
+      value._checkNative('concatenate');
+    }
+    final result = await FlutterOnnxruntimePlatform.instance.concatOrtValues(values.map((v) => v.id).toList(), axis);
+    return OrtValue.fromMap(result);
+  }
+
+  void _checkNative(String action) {
+    if (isInline) {
+      throw StateError('An inline OrtValue has no native tensor to $action, create one with fromList()');
+    }
+  }
+
   /// Get the data from this tensor as a list
   ///
   /// Return a nested list following the shape if the tensor is multi-dimensional
   ///
   /// Returns the data in its original type:
-  /// - Float values for float32 and float16 tensors
+  /// - Float values for float32, float16, bfloat16 and float64 tensors
   /// - Int values for int32, int64, int16, int8, uint8, uint16, uint32, uint64 tensors
   /// - Boolean values for bool tensors
   /// - String values for string tensors
   ///
   Future<List<dynamic>> asList() async {
-    final data = await FlutterOnnxruntimePlatform.instance.getOrtValueData(id);
-    final rawData = data['data'];
-    var dataList1d = (rawData is List) ? rawData : List<dynamic>.from(rawData);
-    // On iOS/macOS, bool tensors are stored as uint8 internally,
-    // so convert 0/1 integers back to false/true
-    if (dataType == OrtDataType.bool && dataList1d.isNotEmpty && dataList1d.first is! bool) {
-      dataList1d = dataList1d.map((e) => e != 0).toList();
-    }
-    return _reshapeList(dataList1d, shape);
+    return _reshapeList(await asFlattenedList(), shape);
   }
 
   /// Get the data from this tensor as a flattened list (1D list)
   ///
   /// Returns the data in its original type:
-  /// - Float values for float32 and float16 tensors
+  /// - Float values for float32, float16, bfloat16 and float64 tensors
   /// - Int values for int32, int64, int16, int8, uint8, uint16, uint32, uint64 tensors
   /// - Boolean values for bool tensors
   /// - String values for string tensors
   ///
   Future<List<dynamic>> asFlattenedList() async {
+    final inlineData = _inlineData;
+    if (inlineData != null) {
+      return _boolsFromInts(inlineData);
+    }
+
+    // On Linux and Windows the bytes are copied straight out of the native tensor through dart:ffi.
+    // float16 and bfloat16 are widened to floats by the plugin, so they are read over the method channel.
+    if (_elementSizes.containsKey(dataType) && dataType != OrtDataType.float16 && dataType != OrtDataType.bfloat16) {
+      final bytes = await copyTensorBytes(id);
+      if (bytes != null) {
+        final values = _viewBytes(bytes);
+        return dataType == OrtDataType.bool ? [for (final value in values as Uint8List) value != 0] : values as List;
+      }
+    }
+
     final data = await FlutterOnnxruntimePlatform.instance.getOrtValueData(id);
     final rawData = data['data'];
-    final list = (rawData is List) ? rawData : List<dynamic>.from(rawData);
-    // On iOS/macOS, bool tensors are stored as uint8 internally,
-    // so convert 0/1 integers back to false/true
+    return _boolsFromInts((rawData is List) ? rawData : List<dynamic>.from(rawData));
+  }
+
+  // Bool tensors come back from some platforms as 0/1 integers, e.g. iOS/macOS store them as uint8 internally,
+  // so convert them back to false/true
+  List<dynamic> _boolsFromInts(List<dynamic> list) {
     if (dataType == OrtDataType.bool && list.isNotEmpty && list.first is! bool) {
       return list.map((e) => e != 0).toList();
     }
     return list;
   }
 
+  /// Get the data from this tensor as typed data laid out as in native memory
+  ///
+  /// On Linux and Windows the returned list is a view straight over the tensor memory, so large outputs are read
+  /// without a copy. The view keeps that memory alive until it is garbage collected, even if this value is disposed
+  /// first, and writes through it change the tensor. On other platforms the data is copied into a new list.
+  ///
+  /// Returns:
+  /// - Float32List or Float64List for float32 and float64 tensors
+  /// - Uint16List holding the raw bits for float16 and bfloat16 tensors
+  /// - The matching Int/Uint list for integer tensors
+  /// - Uint8List of 0/1 for bool tensors
+  ///
+  /// Throws [UnsupportedError] for string and complex tensors, and for float16 and bfloat16 tensors on platforms
+  /// without the native view or returned inline.
+  Future<TypedData> asTypedData() async {
+    final typeName = dataType.toString().split('.').last;
+    if (!_elementSizes.containsKey(dataType)) {
+      throw UnsupportedError('asTypedData() does not support $typeName tensors');
+    }
+
+    final bytes = isInline ? null : await borrowTensorBytes(id);
+    if (bytes != null) {
+      return _viewBytes(bytes);
+    }
+
+    if (dataType == OrtDataType.float16 || dataType == OrtDataType.bfloat16) {
+      throw UnsupportedError('Raw $typeName data is only available on Linux and Windows, use asFlattenedList()');
+    }
+    return _copyToTypedData(await asFlattenedList());
+  }
+
+  /// Release the native resources of several tensors at once
+  ///
+  /// The tensors are released in one call that takes the tensor lock once, instead of one call per tensor as with
+  /// [dispose]. Values already disposed and inline values are skipped.
+  static Future<void> releaseAll(Iterable<OrtValue> values) async {
+    final valueIds = <String>[];
+    for (final value in values) {
+      if (!value.isInline) {
+        value._untrack();
+        valueIds.add(value.id);
+      }
+    }
+    if (valueIds.isEmpty || await releaseNativeTensors(valueIds)) {
+      return;
+    }
+    await FlutterOnnxruntimePlatform.instance.releaseOrtValues(valueIds);
+  }
+
+  /// Open a scope that collects every OrtValue created until it is ended
+  ///
+  /// Tensors created with the factories of this class, outputs of `OrtSession.run` and `OrtSession.runBatch`, and
+  /// results of [to] all join the innermost open scope, and [OrtValueScope.end] releases them together with
+  /// [releaseAll]. This turns the clean-up of a frame into a single call:
+  ///
+  /// ```dart
+  /// final scope = OrtValue.beginScope();
+  /// final input = await OrtValue.fromList(pixels, [1, 3, 224, 224]);
+  /// final outputs = await session.run({'input': input});
+  /// final scores = await outputs['scores']!.asFlattenedList();
+  /// await scope.end(); // releases input and every output
+  /// ```
+  static OrtValueScope beginScope() {
+    final scope = OrtValueScope._();
+    OrtValueScope._open.add(scope);
+    return scope;
+  }
+
   /// Release native resources associated with this tensor
   Future<void> dispose() async {
-    await FlutterOnnxruntimePlatform.instance.releaseOrtValue(id);
+    if (isInline) {
+      return;
+    }
+    _untrack();
+    await _releaseById(id);
+  }
+
+  /// Hand this value over to another isolate
+  ///
+  /// Sessions and tensors live in native memory shared by every isolate, and an OrtValue sent to another isolate
+  /// arrives there as a copy of its ID, type and shape that can be used right away. The isolate that created the
+  /// value still releases the tensor once its own value is garbage collected, though. Call this before sending the
+  /// value, and [adopt] on the copy the other isolate receives, to move that duty over: this isolate then neither
+  /// counts the value in [trackedBytes] nor releases it. `OnnxRuntime.runInBackground` does both for the values it
+  /// returns. Returns this value.
+  OrtValue transfer() {
+    if (_trackedHere[this] != true) {
+      return this;
+    }
+    _trackedHere[this] = null;
+    _finalizer.detach(this);
+    final tracked = _tracked[id];
+    if (tracked != null && --tracked.references == 0) {
+      _tracked.remove(id);
+      _trackedBytes -= tracked.bytes;
+    }
+    return this;
+  }
+
+  /// Count a value received from another isolate as one of this isolate's own, see [transfer]
+  ///
+  /// The value is then released when garbage collected here if [autoRelease] is on. Values created in this
+  /// isolate, and values adopted already, are left as they are. Returns this value.
+  OrtValue adopt() {
+    if (!isInline && _trackedHere[this] != true) {
+      _track();
+    }
+    return this;
+  }
+
+  // View the raw bytes of a tensor as the typed list of its data type
+  TypedData _viewBytes(Uint8List bytes) {
+    final buffer = bytes.buffer;
+    final offset = bytes.offsetInBytes;
+    final length = bytes.lengthInBytes ~/ _elementSizes[dataType]!;
+    switch (dataType) {
+      case OrtDataType.float32:
+        return buffer.asFloat32List(offset, length);
+      case OrtDataType.float64:
+        return buffer.asFloat64List(offset, length);
+      case OrtDataType.float16:
+      case OrtDataType.bfloat16:
+      case OrtDataType.uint16:
+        return buffer.asUint16List(offset, length);
+      case OrtDataType.int8:
+        return buffer.asInt8List(offset, length);
+      case OrtDataType.int16:
+        return buffer.asInt16List(offset, length);
+      case OrtDataType.int32:
+        return buffer.asInt32List(offset, length);
+      case OrtDataType.uint32:
+        return buffer.asUint32List(offset, length);
+      case OrtDataType.int64:
+        return buffer.asInt64List(offset, length);
+      case OrtDataType.uint64:
+        return buffer.asUint64List(offset, length);
+      default:
+        return bytes;
+    }
+  }
+
+  // Copy the flattened data of a tensor into the typed list of its data type
+  TypedData _copyToTypedData(List<dynamic> data) {
+    List<int> ints() => data.map((e) => (e as num).toInt()).toList();
+    switch (dataType) {
+      case OrtDataType.float32:
+        return Float32List.fromList(data.map((e) => (e as num).toDouble()).toList());
+      case OrtDataType.float64:
+        return Float64List.fromList(data.map((e) => (e as num).toDouble()).toList());
+      case OrtDataType.bool:
+        return Uint8List.fromList(data.map((e) => e == true || e == 1 ? 1 : 0).toList());
+      case OrtDataType.int8:
+        return Int8List.fromList(ints());
+      case OrtDataType.uint8:
+        return Uint8List.fromList(ints());
+      case OrtDataType.int16:
+        return Int16List.fromList(ints());
+      case OrtDataType.uint16:
+        return Uint16List.fromList(ints());
+      case OrtDataType.int32:
+        return Int32List.fromList(ints());
+      case OrtDataType.uint32:
+        return Uint32List.fromList(ints());
+      case OrtDataType.uint64:
+        return Uint64List.fromList(ints());
+      default:
+        return Int64List.fromList(ints());
+    }
   }
 
   /// Converts a regular List to appropriate TypedData based on content
@@ -306,3 +893,61 @@ class OrtValue {
     return result;
   }
 }
+
+// A native tensor that OrtValues refer to
+class _TrackedTensor {
+  final int bytes;
+  int references = 1;
+
+  _TrackedTensor(this.bytes);
+}
+
+/// A set of OrtValues released together, opened with [OrtValue.beginScope]
+///
+/// Scopes follow the order of calls rather than zones: a value created by any code while the scope is the innermost
+/// one joins it, including code that runs in between the awaits of the code that opened it.
+class OrtValueScope {
+  // Open scopes, innermost last
+  static final List<OrtValueScope> _open = [];
+
+  static OrtValueScope? get _current => _open.isEmpty ? null : _open.last;
+
+  final List<OrtValue> _values = [];
+  bool _ended = false;
+
+  OrtValueScope._();
+
+  /// Values collected so far
+  List<OrtValue> get values => List.unmodifiable(_values);
+
+  /// Take a value out of this scope so that [end] does not release it, e.g. a result that outlives the frame
+  ///
+  /// The value is handed to the enclosing scope, if there is one.
+  OrtValue keep(OrtValue value) {
+    if (_values.remove(value)) {
+      final index = _open.indexOf(this);
+      if (index > 0) {
+        _open[index - 1]._values.add(value);
+      }
+    }
+    return value;
+  }
+
+  /// Close this scope and release every value it collected in one call
+  ///
+  /// Throws a [StateError] if the scope has already ended or another scope was opened inside it and is still
+  /// open.
+  Future<void> end() async {
+    if (_ended) {
+      throw StateError('This OrtValueScope has already ended');
+    }
+    if (!identical(_current, this)) {
+      throw StateError('A scope opened inside this OrtValueScope must be ended first');
+    }
+    _ended = true;
+    _open.removeLast();
+    final values = List.of(_values);
+    _values.clear();
+    await OrtValue.releaseAll(values);
+  }
+}
@@ -293,6 +293,7 @@ class FlutterOnnxruntimeWebPlugin extends FlutterOnnxruntimePlatform {
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
   }) async {
     try {
       // Check if the session exists
@@ -340,20 +341,20 @@ class FlutterOnnxruntimeWebPlugin extends FlutterOnnxruntimePlatform {
         }
       }
 
-      // Run inference
-      final runPromise =
-          jsRunOptions != null
-              ? callMethod(session, 'run', [jsInputs, jsRunOptions])
-              : callMethod(session, 'run', [jsInputs]);
+      // Run inference, fetching only the requested outputs if there are any
+      final runPromise = callMethod(session, 'run', [
+        jsInputs,
+        if (outputNames != null) jsArrayFrom(outputNames),
+        if (jsRunOptions != null) jsRunOptions,
+      ]);
 
       // Wait for the promise to resolve
       final jsOutputs = await promiseToFuture<JSObject>(runPromise);
 
       // Process outputs - create OrtValue objects for each output
       final outputMap = <String, dynamic>{};
-      final outputNames = getOutputNames(session);
 
-      for (final name in outputNames) {
+      for (final name in outputNames ?? getOutputNames(session)) {
         if (jsOutputs.has(name)) {
           final tensor = jsOutputs.getProperty(name.toJS) as JSObject;
 
@@ -409,6 +410,41 @@ class FlutterOnnxruntimeWebPlugin extends FlutterOnnxruntimePlatform {
     }
   }
 
+  @override
+  Future<List<Map<String, dynamic>>> runBatch(
+    String sessionId,
+    List<Map<String, OrtValue>> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) async {
+    // There is no channel round trip to save on web, so the requests simply run in order
+    return [for (final request in inputs) await runInference(sessionId, request, runOptions: runOptions)];
+  }
+
+  @override
+  Future<void> setInferenceThreads(int numThreads) async {
+    // onnxruntime-web schedules inference itself, so there is no native worker pool to resize
+  }
+
+  @override
+  Future<void> setIntegerHandles(bool enabled) async {
+    // IDs never cross a platform channel on web, so there is nothing to encode
+  }
+
+  @override
+  Future<void> configureBatching(String sessionId, {required int windowMicros, required int maxBatchSize}) async {
+    // onnxruntime-web runs on the main thread, so there are no concurrent calls to batch
+  }
+
+  @override
+  Future<Map<String, dynamic>> getBatchingStats(String sessionId) async {
+    return {};
+  }
+
+  @override
+  Future<Map<String, dynamic>> getNativeContext() async {
+    return {};
+  }
+
   @override
   Future<void> closeSession(String sessionId) async {
     try {
@@ -960,6 +996,14 @@ class FlutterOnnxruntimeWebPlugin extends FlutterOnnxruntimePlatform {
     }
   }
 
+  @override
+  Future<void> releaseOrtValues(List<String> valueIds) async {
+    // There is no channel round trip to save on the web, so each tensor is disposed as releaseOrtValue does it
+    for (final valueId in valueIds) {
+      await releaseOrtValue(valueId);
+    }
+  }
+
   @override
   Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) async {
     try {
@@ -0,0 +1,271 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+// Benchmarks of the native plugin core, without a Flutter engine.
+//
+// Run with --benchmark_out=results.json --benchmark_out_format=json to keep the results as JSON, e.g. to compare
+// two builds with the compare.py tool of Google Benchmark. The models are read from the example app's assets, or
+// from the directory in the FLUTTER_ONNXRUNTIME_BENCHMARK_MODELS environment variable.
+
+#include <benchmark/benchmark.h>
+#include <flutter_linux/flutter_linux.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/element_types.h"
+#include "core/session_manager.h"
+#include "core/tensor_manager.h"
+#include "src/value_conversion.h"
+
+using namespace flutter_onnxruntime;
+
+namespace {
+
+// Element counts of the tensor benchmarks: a small input, an image-sized input and a large activation
+constexpr int64_t kSmallElements = 1 << 10;
+constexpr int64_t kMediumElements = 1 << 16;
+constexpr int64_t kLargeElements = 1 << 20;
+
+std::string modelPath(const std::string &file_name) {
+  const char *models_dir = std::getenv("FLUTTER_ONNXRUNTIME_BENCHMARK_MODELS");
+  std::filesystem::path dir = models_dir != nullptr ? models_dir : FLUTTER_ONNXRUNTIME_BENCHMARK_MODELS_DIR;
+  return (dir / file_name).string();
+}
+
+int64_t elementCount(const std::vector<int64_t> &shape) {
+  int64_t count = 1;
+  for (int64_t dim : shape) {
+    count *= dim;
+  }
+  return count;
+}
+
+// Store a tensor of a type and shape with every element set from its index
+TensorHandle createTensor(TensorManager &manager, const std::string &data_type, const std::vector<int64_t> &shape) {
+  int64_t elements = elementCount(shape);
+  if (data_type == "float32") {
+    std::vector<float> data(elements);
+    for (int64_t i = 0; i < elements; i++) {
+      data[i] = static_cast<float>(i % 255) / 255.0f;
+    }
+    return manager.createTensor(data, shape);
+  }
+  if (data_type == "int32") {
+    return manager.createTensor(std::vector<int32_t>(elements, 7), shape);
+  }
+  if (data_type == "int64") {
+    return manager.createTensor(std::vector<int64_t>(elements, 7), shape);
+  }
+  if (data_type == "uint8") {
+    return manager.createTensor(std::vector<uint8_t>(elements, 7), shape);
+  }
+  if (data_type == "bool") {
+    return manager.createTensor(std::vector<bool>(elements, true), shape);
+  }
+  return manager.createStringTensor(std::vector<std::string>(elements, "benchmark"), shape);
+}
+
+size_t elementSize(const std::string &data_type) {
+  if (data_type == "float32" || data_type == "int32") {
+    return 4;
+  }
+  if (data_type == "int64") {
+    return 8;
+  }
+  if (data_type == "string") {
+    return sizeof("benchmark") - 1;
+  }
+  return 1;
+}
+
+void setProcessed(benchmark::State &state, const std::string &data_type, int64_t elements) {
+  state.SetItemsProcessed(state.iterations() * elements);
+  state.SetBytesProcessed(state.iterations() * elements * static_cast<int64_t>(elementSize(data_type)));
+}
+
+// Create a tensor from host data and release it, the round trip of every OrtValue.fromList call
+void BM_CreateReleaseTensor(benchmark::State &state, const std::string &data_type) {
+  TensorManager manager;
+  int64_t elements = state.range(0);
+  for (auto _ : state) {
+    TensorHandle tensor = createTensor(manager, data_type, {elements});
+    manager.releaseTensor(tensor);
+  }
+  setProcessed(state, data_type, elements);
+}
+
+// Create a tensor from raw element bytes, the path of typed data lists and float16
+void BM_CreateTensorFromBytes(benchmark::State &state, const std::string &data_type) {
+  TensorManager manager;
+  int64_t elements = state.range(0);
+  std::vector<uint8_t> bytes(elements * elementSize(data_type), 1);
+  std::vector<int64_t> shape = {elements};
+  ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  parseElementType(data_type, &element_type);
+  for (auto _ : state) {
+    TensorHandle tensor = manager.createTensorFromBytes(element_type, bytes.data(), bytes.size(), shape);
+    manager.releaseTensor(tensor);
+  }
+  setProcessed(state, data_type, elements);
+}
+
+// Release only, with the creation of each tensor left out of the timing
+void BM_ReleaseTensor(benchmark::State &state, const std::string &data_type) {
+  TensorManager manager;
+  int64_t elements = state.range(0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    TensorHandle tensor = createTensor(manager, data_type, {elements});
+    state.ResumeTiming();
+    manager.releaseTensor(tensor);
+  }
+  setProcessed(state, data_type, elements);
+}
+
+void BM_CloneTensor(benchmark::State &state, const std::string &data_type) {
+  TensorManager manager;
+  int64_t elements = state.range(0);
+  TensorHandle tensor = createTensor(manager, data_type, {elements});
+  for (auto _ : state) {
+    ClonedTensor clone = manager.cloneTensor(tensor);
+    benchmark::DoNotOptimize(clone.value);
+  }
+  setProcessed(state, data_type, elements);
+}
+
+void BM_ConvertTensor(benchmark::State &state, const std::string &source_type, const std::string &target_type) {
+  TensorManager manager;
+  int64_t elements = state.range(0);
+  TensorHandle tensor = createTensor(manager, source_type, {elements});
+  ONNXTensorElementDataType target_element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  parseElementType(target_type, &target_element_type);
+  for (auto _ : state) {
+    TensorHandle converted = manager.convertTensor(tensor, target_element_type);
+    manager.releaseTensor(converted);
+  }
+  setProcessed(state, source_type, elements);
+}
+
+// Encode the data of a tensor into the FlValue sent back over the method channel
+void BM_GetTensorData(benchmark::State &state, const std::string &data_type) {
+  TensorManager manager;
+  int64_t elements = state.range(0);
+  TensorHandle tensor = createTensor(manager, data_type, {elements});
+  for (auto _ : state) {
+    g_autoptr(FlValue) data = manager.getTensorData<FlValueCodec>(tensor);
+    benchmark::DoNotOptimize(data);
+  }
+  setProcessed(state, data_type, elements);
+}
+
+// An input of a model benchmark, filled by createTensor
+struct ModelInput {
+  std::string name;
+  std::string data_type;
+  std::vector<int64_t> shape;
+};
+
+// Run a session end to end as runInference does: borrow the stored inputs, run, store the outputs and release them.
+// The first shape dimension of every input is scaled by the benchmark's batch size.
+void BM_RunInference(benchmark::State &state, const std::string &model_file, const std::vector<ModelInput> &inputs) {
+  std::string path = modelPath(model_file);
+  if (!std::filesystem::exists(path)) {
+    state.SkipWithError(("Model not found: " + path).c_str());
+    return;
+  }
+
+  SessionManager session_manager;
+  TensorManager tensor_manager;
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(1);
+  SessionHandle session = session_manager.createSession(path.c_str(), session_options);
+
+  int64_t batch = state.range(0);
+  std::vector<TensorHandle> tensors;
+  std::vector<std::string> input_names;
+  for (const ModelInput &input : inputs) {
+    std::vector<int64_t> shape = input.shape;
+    shape[0] *= batch;
+    tensors.push_back(createTensor(tensor_manager, input.data_type, shape));
+    input_names.push_back(input.name);
+  }
+
+  for (auto _ : state) {
+    std::vector<TensorLease> leases;
+    std::vector<const OrtValue *> input_values;
+    for (TensorHandle tensor : tensors) {
+      leases.push_back(tensor_manager.acquireTensor(tensor));
+      input_values.push_back(leases.back().get());
+    }
+    std::vector<Ort::Value> outputs = session_manager.runInference(session, input_values, input_names);
+    leases.clear();
+    for (Ort::Value &output : outputs) {
+      tensor_manager.releaseTensor(tensor_manager.storeTensor(std::move(output)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+
+  for (TensorHandle tensor : tensors) {
+    tensor_manager.releaseTensor(tensor);
+  }
+  session_manager.closeSession(session);
+}
+
+} // namespace
+
+#define TENSOR_SIZES Arg(kSmallElements)->Arg(kMediumElements)->Arg(kLargeElements)
+
+BENCHMARK_CAPTURE(BM_CreateReleaseTensor, float32, std::string("float32"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_CreateReleaseTensor, int32, std::string("int32"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_CreateReleaseTensor, int64, std::string("int64"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_CreateReleaseTensor, uint8, std::string("uint8"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_CreateReleaseTensor, bool, std::string("bool"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_CreateReleaseTensor, string, std::string("string"))->Arg(kSmallElements)->Arg(kMediumElements);
+
+BENCHMARK_CAPTURE(BM_CreateTensorFromBytes, float32, std::string("float32"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_CreateTensorFromBytes, int64, std::string("int64"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_CreateTensorFromBytes, uint8, std::string("uint8"))->TENSOR_SIZES;
+
+BENCHMARK_CAPTURE(BM_ReleaseTensor, float32, std::string("float32"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_ReleaseTensor, string, std::string("string"))->Arg(kSmallElements)->Arg(kMediumElements);
+
+BENCHMARK_CAPTURE(BM_CloneTensor, float32, std::string("float32"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_CloneTensor, int64, std::string("int64"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_CloneTensor, string, std::string("string"))->Arg(kSmallElements)->Arg(kMediumElements);
+
+BENCHMARK_CAPTURE(BM_ConvertTensor, float32_to_float16, std::string("float32"), std::string("float16"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_ConvertTensor, float32_to_int32, std::string("float32"), std::string("int32"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_ConvertTensor, int64_to_float32, std::string("int64"), std::string("float32"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_ConvertTensor, uint8_to_float32, std::string("uint8"), std::string("float32"))->TENSOR_SIZES;
+
+BENCHMARK_CAPTURE(BM_GetTensorData, float32, std::string("float32"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_GetTensorData, int64, std::string("int64"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_GetTensorData, bool, std::string("bool"))->TENSOR_SIZES;
+BENCHMARK_CAPTURE(BM_GetTensorData, string, std::string("string"))->Arg(kSmallElements)->Arg(kMediumElements);
+
+BENCHMARK_CAPTURE(BM_RunInference, transpose_and_avg_fp32, std::string("transpose_and_avg_model_fp32.onnx"),
+                  std::vector<ModelInput>{{"A", "float32", {1, 2, 3}}, {"B", "float32", {1, 3, 2}}})
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024);
+BENCHMARK_CAPTURE(BM_RunInference, transpose_and_avg_int64, std::string("transpose_and_avg_model_int64.onnx"),
+                  std::vector<ModelInput>{{"A", "int64", {1, 2, 3}}, {"B", "int64", {1, 3, 2}}})
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024);
+BENCHMARK_CAPTURE(BM_RunInference, bool_not, std::string("bool_not_model.onnx"),
+                  std::vector<ModelInput>{{"input", "bool", {2, 2}}})
+    ->Arg(1);
+BENCHMARK_CAPTURE(BM_RunInference, string_concat, std::string("string_concat_model.onnx"),
+                  std::vector<ModelInput>{{"input1", "string", {1}}, {"input2", "string", {1}}})
+    ->Arg(1);
+
+BENCHMARK_MAIN();
@@ -10,10 +10,26 @@
 #include <gtk/gtk.h>
 #include <sys/utsname.h>
 
-#include "session_manager.h"
-#include "tensor_manager.h"
+#include "core/element_types.h"
+#include "core/frame_stream.h"
+#include "core/generation.h"
+#include "core/image_preprocess.h"
+#include "core/inference_executor.h"
+#include "core/micro_batcher.h"
+#include "core/native_api.h"
+#include "core/pipeline.h"
+#include "core/profile_summary.h"
+#include "core/quantization.h"
+#include "core/run_control.h"
+#include "core/session_manager.h"
+#include "core/tensor_codec.h"
+#include "core/tensor_manager.h"
+#include "core/trace_recorder.h"
 #include "value_conversion.h"
+#include <algorithm>
 #include <cstring>
+#include <fstream>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -21,9 +37,44 @@
 #include <string>
 #include <unordered_map>
 
+// The shared core of the Linux and Windows plugins
+using namespace flutter_onnxruntime;
+
 #define FLUTTER_ONNXRUNTIME_PLUGIN(obj)                                                                                \
   (G_TYPE_CHECK_INSTANCE_CAST((obj), flutter_onnxruntime_plugin_get_type(), FlutterOnnxruntimePlugin))
 
+// Pending inference response that is handed back to the main thread
+struct InferenceResponse {
+  FlutterOnnxruntimePlugin *self;
+  FlMethodCall *method_call;
+  FlMethodResponse *response;
+};
+
+// A runInference call waiting in the micro-batcher, with its inputs already borrowed
+struct BatchedInference {
+  InferenceResponse *pending;
+  std::vector<TensorLease> input_leases;
+  std::vector<const OrtValue *> input_values;
+  std::vector<std::string> input_names;
+};
+
+// Inputs of a call, borrowed on the platform thread when the call arrives so that Dart cannot release them before
+// its handler runs; one list of values and names per inputs map, so several for runBatch and one otherwise
+struct CallInputs {
+  std::vector<TensorLease> leases;
+  std::vector<std::vector<const OrtValue *>> values;
+  std::vector<std::vector<std::string>> names;
+  uint64_t nanos = 0;
+};
+
+// Event of a stream frame or a generation that is handed back to the main thread and sent on one of the event
+// channels, which live as long as the plugin the event keeps alive
+struct PluginEvent {
+  FlutterOnnxruntimePlugin *self;
+  FlEventChannel *channel;
+  FlValue *event;
+};
+
 struct _FlutterOnnxruntimePlugin {
   GObject parent_instance;
 
@@ -33,6 +84,36 @@ struct _FlutterOnnxruntimePlugin {
   // TensorManager for handling OrtValue objects
   TensorManager *tensor_manager;
 
+  // Worker pool that runs inference off the platform thread
+  InferenceExecutor *inference_executor;
+
+  // Worker that creates and warms up sessions off the platform thread
+  InferenceExecutor *session_loader;
+
+  // Calls in flight that Dart can cancel by run tag or that have a timeout
+  RunRegistry *run_registry;
+
+  // Pipelines of sessions and glue ops run natively by runPipeline
+  PipelineManager *pipeline_manager;
+
+  // Frame streams opened by openStream, whose results are sent over stream_channel
+  FrameStreamManager *stream_manager;
+  FlEventChannel *stream_channel;
+
+  // Generations started by generate, whose tokens are sent over generation_channel
+  GenerationManager *generation_manager;
+  FlEventChannel *generation_channel;
+
+  // Gathers concurrent runInference calls of sessions with micro-batching enabled into batches
+  MicroBatcher<BatchedInference> *micro_batcher;
+
+  // Addresses of the managers above, handed to Dart for the fort_* functions of native_api.h
+  NativeContext *native_context;
+
+  // Whether session and value IDs are sent to Dart as integer handles instead of strings.
+  // Read from the worker threads, so it is accessed with g_atomic_int_get/set.
+  gint integer_handles;
+
   // Maps to store value data
   std::map<std::string, void *> values;
 
@@ -47,23 +128,135 @@ static void flutter_onnxruntime_plugin_dispose(GObject *object);
 static void flutter_onnxruntime_plugin_handle_method_call(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call);
 static void method_call_handler(FlMethodChannel *channel, FlMethodCall *method_call, gpointer user_data);
 
+// Handler that turns method call arguments into a response
+using MethodHandler = std::function<FlMethodResponse *(FlutterOnnxruntimePlugin *self, FlValue *args)>;
+
+// Handler of a call that runs on tensors borrowed before it was queued
+typedef FlMethodResponse *(*InputsHandler)(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs);
+
+// Run a handler on a worker pool and respond from the main thread
+static void run_on_worker(FlutterOnnxruntimePlugin *self, InferenceExecutor *executor, FlMethodCall *method_call,
+                          MethodHandler handler);
+
+// Borrow the inputs of a call on the main thread, then run its handler on the inference worker pool; responds
+// right away if an input cannot be borrowed. Handlers that read the input data on the CPU borrow host copies of
+// tensors in device memory.
+static void run_with_inputs_on_worker(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call,
+                                      InputsHandler handler, bool host_memory = false);
+
+// Queue a runInference call in the micro-batcher; returns false if the call should run on its own
+static bool submit_batched_inference(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call);
+
+// Run a batch gathered by the micro-batcher on the inference worker pool
+static void dispatch_batch(FlutterOnnxruntimePlugin *self, SessionHandle session_id,
+                           std::vector<BatchedInference> &&batch);
+
 // Helper function to get platform version
 static FlMethodResponse *get_platform_version();
 
 // Session management
 static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *create_session_from_buffer(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *get_available_providers(FlutterOnnxruntimePlugin *self, FlValue *args);
-static FlMethodResponse *run_inference(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *run_inference(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs);
+static FlMethodResponse *run_batch(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs);
+static FlMethodResponse *bind_outputs(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *run_with_binding(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs);
+static FlMethodResponse *unbind_outputs(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *enable_sequence_state(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *reset_sequence_state(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *disable_sequence_state(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *set_inference_threads(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *get_queue_stats(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *cancel_low_priority_runs(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *cancel_run(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *set_integer_handles(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *configure_session_cache(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *configure_thread_pools(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *configure_shared_arena(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *configure_batching(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *get_batching_stats(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *get_session_stats(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *get_memory_stats(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *set_memory_limit(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *end_profiling(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *start_tracing(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *stop_tracing(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *get_native_context(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *close_session(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *create_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *run_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs);
+static FlMethodResponse *close_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *run_tensor_op(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs);
+static FlMethodResponse *open_stream(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *submit_stream_frame(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *close_stream(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *generate(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *cancel_generation(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *get_metadata(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *get_input_info(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *get_output_info(FlutterOnnxruntimePlugin *self, FlValue *args);
 
 // OrtValue operations
 static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *create_image_tensor(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *convert_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *quantize_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *dequantize_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *reshape_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *slice_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *transpose_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *concat_ort_values(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *get_ort_value_data(FlutterOnnxruntimePlugin *self, FlValue *args);
 static FlMethodResponse *release_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args);
+static FlMethodResponse *release_ort_values(FlutterOnnxruntimePlugin *self, FlValue *args);
+
+// Point at the element bytes of typed data from Dart
+static bool get_typed_data(FlValue *data_value, ONNXTensorElementDataType source_type, const void **data,
+                           size_t *byte_size);
+
+// Read the scales, zero points and axis of a quantization sent by Dart, and describe one for Dart
+static bool read_quantization_params(FlValue *args, QuantizationParams *params);
+static FlValue *quantization_to_fl_value(const QuantizationParams &params);
+
+// Describe a new tensor to Dart as {valueId, dataType, shape}
+static FlMethodResponse *new_ort_value_response(FlutterOnnxruntimePlugin *self, TensorHandle value_id);
+
+// Prefixes of the string IDs sent to Dart when integer handles are disabled
+static const char *kSessionIdPrefix = "session_";
+static const char *kTensorIdPrefix = "tensor_";
+static const char *kPipelineIdPrefix = "pipeline_";
+static const char *kStreamIdPrefix = "stream_";
+static const char *kGenerationIdPrefix = "generation_";
+
+// Read a session or value handle sent by Dart, either as an integer handle or as a string ID.
+// Returns false if the value is of another type. A string that is not a valid ID yields
+// kInvalidHandle, which the managers treat as not found.
+static bool value_to_handle(FlValue *value, const char *prefix, Handle *handle) {
+  if (fl_value_get_type(value) == FL_VALUE_TYPE_INT) {
+    *handle = static_cast<Handle>(fl_value_get_int(value));
+    return true;
+  }
+  if (fl_value_get_type(value) == FL_VALUE_TYPE_STRING) {
+    *handle = parseHandle(prefix, fl_value_get_string(value));
+    return true;
+  }
+  return false;
+}
+
+// Read the handle under a key of the arguments, like value_to_handle; returns false if the key is missing
+static bool lookup_handle(FlValue *map, const char *key, const char *prefix, Handle *handle) {
+  FlValue *value = fl_value_lookup_string(map, key);
+  return value != nullptr && value_to_handle(value, prefix, handle);
+}
+
+// Encode a handle for Dart: an integer in integer handle mode, otherwise a string ID
+static FlValue *handle_to_fl_value(FlutterOnnxruntimePlugin *self, const char *prefix, Handle handle) {
+  if (g_atomic_int_get(&self->integer_handles)) {
+    return fl_value_new_int(static_cast<int64_t>(handle));
+  }
+  return fl_value_new_string(formatHandle(prefix, handle).c_str());
+}
 
 // Helper function to map C++ API provider names to OrtProvider enum names
 static std::string mapProviderNameToEnumName(const std::string &providerName) {
@@ -102,12 +295,47 @@ static void flutter_onnxruntime_plugin_class_init(FlutterOnnxruntimePluginClass
 static void flutter_onnxruntime_plugin_init(FlutterOnnxruntimePlugin *self) {
   self->session_manager = new SessionManager();
   self->tensor_manager = new TensorManager();
+  // Outputs left in device memory are copied to the host only when Dart reads them
+  self->tensor_manager->setHostCopier(
+      [session_manager = self->session_manager](const OrtValue *value) { return session_manager->copyToHost(value); });
+  self->pipeline_manager = new PipelineManager();
+  self->stream_manager = new FrameStreamManager();
+  self->stream_channel = nullptr;
+  self->generation_manager = new GenerationManager();
+  self->generation_channel = nullptr;
+  self->inference_executor = new InferenceExecutor(kDefaultInferenceThreads);
+  self->session_loader = new InferenceExecutor(kSessionLoaderThreads);
+  self->run_registry = new RunRegistry();
+  self->micro_batcher = new MicroBatcher<BatchedInference>(
+      [self](SessionHandle session_id, std::vector<BatchedInference> &&batch) {
+        dispatch_batch(self, session_id, std::move(batch));
+      });
+  self->native_context = new NativeContext{self->session_manager, self->tensor_manager, self->inference_executor};
+  self->integer_handles = 0;
 }
 
 static void flutter_onnxruntime_plugin_dispose(GObject *object) {
   FlutterOnnxruntimePlugin *self = FLUTTER_ONNXRUNTIME_PLUGIN(object);
 
-  // Clean up session manager, tensor manager and values
+  // Hand the requests still waiting in the micro-batcher to the workers, then stop the workers,
+  // as queued jobs still use the managers
+  delete self->native_context;
+  self->native_context = nullptr;
+  delete self->micro_batcher;
+  self->micro_batcher = nullptr;
+  delete self->inference_executor;
+  self->inference_executor = nullptr;
+  delete self->session_loader;
+  self->session_loader = nullptr;
+  delete self->run_registry;
+  self->run_registry = nullptr;
+
+  // Clean up generations, streams, pipelines, session manager, tensor manager and values
+  g_clear_object(&self->generation_channel);
+  delete self->generation_manager;
+  g_clear_object(&self->stream_channel);
+  delete self->stream_manager;
+  delete self->pipeline_manager;
   delete self->session_manager;
   delete self->tensor_manager;
 
@@ -129,6 +357,13 @@ void flutter_onnxruntime_plugin_register_with_registrar(FlPluginRegistrar *regis
   // Setup method call handler
   fl_method_channel_set_method_call_handler(channel, method_call_handler, g_object_ref(plugin), g_object_unref);
 
+  // Results of stream frames and generated tokens are sent as events; no handlers are needed as every listener gets
+  // every event
+  plugin->stream_channel = fl_event_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                                                "flutter_onnxruntime/streams", FL_METHOD_CODEC(codec));
+  plugin->generation_channel = fl_event_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                                                    "flutter_onnxruntime/generation", FL_METHOD_CODEC(codec));
+
   g_object_unref(plugin);
 }
 
@@ -149,13 +384,99 @@ static void flutter_onnxruntime_plugin_handle_method_call(FlutterOnnxruntimePlug
   if (strcmp(method, "getPlatformVersion") == 0) {
     response = get_platform_version();
   } else if (strcmp(method, "createSession") == 0) {
-    response = create_session(self, args);
+    run_on_worker(self, self->session_loader, method_call, create_session);
+    return;
+  } else if (strcmp(method, "createSessionFromBuffer") == 0) {
+    run_on_worker(self, self->session_loader, method_call, create_session_from_buffer);
+    return;
   } else if (strcmp(method, "getAvailableProviders") == 0) {
     response = get_available_providers(self, args);
   } else if (strcmp(method, "runInference") == 0) {
-    response = run_inference(self, args);
+    // Inference responds asynchronously, from the micro-batcher or directly from the worker pool
+    if (!submit_batched_inference(self, method_call)) {
+      run_with_inputs_on_worker(self, method_call, run_inference);
+    }
+    return;
+  } else if (strcmp(method, "runBatch") == 0) {
+    run_with_inputs_on_worker(self, method_call, run_batch);
+    return;
+  } else if (strcmp(method, "bindOutputs") == 0) {
+    response = bind_outputs(self, args);
+  } else if (strcmp(method, "runWithBinding") == 0) {
+    run_with_inputs_on_worker(self, method_call, run_with_binding);
+    return;
+  } else if (strcmp(method, "unbindOutputs") == 0) {
+    response = unbind_outputs(self, args);
+  } else if (strcmp(method, "enableSequenceState") == 0) {
+    // Waits for a step of the session in flight, so it runs on the worker pool like the steps themselves
+    run_on_worker(self, self->inference_executor, method_call, enable_sequence_state);
+    return;
+  } else if (strcmp(method, "resetSequenceState") == 0) {
+    run_on_worker(self, self->inference_executor, method_call, reset_sequence_state);
+    return;
+  } else if (strcmp(method, "disableSequenceState") == 0) {
+    run_on_worker(self, self->inference_executor, method_call, disable_sequence_state);
+    return;
+  } else if (strcmp(method, "setInferenceThreads") == 0) {
+    response = set_inference_threads(self, args);
+  } else if (strcmp(method, "getQueueStats") == 0) {
+    response = get_queue_stats(self, args);
+  } else if (strcmp(method, "cancelLowPriorityRuns") == 0) {
+    response = cancel_low_priority_runs(self, args);
+  } else if (strcmp(method, "cancelRun") == 0) {
+    response = cancel_run(self, args);
+  } else if (strcmp(method, "configureSessionCache") == 0) {
+    response = configure_session_cache(self, args);
+  } else if (strcmp(method, "configureThreadPools") == 0) {
+    response = configure_thread_pools(self, args);
+  } else if (strcmp(method, "configureSharedArena") == 0) {
+    response = configure_shared_arena(self, args);
+  } else if (strcmp(method, "configureBatching") == 0) {
+    response = configure_batching(self, args);
+  } else if (strcmp(method, "getBatchingStats") == 0) {
+    response = get_batching_stats(self, args);
+  } else if (strcmp(method, "getSessionStats") == 0) {
+    response = get_session_stats(self, args);
+  } else if (strcmp(method, "getMemoryStats") == 0) {
+    response = get_memory_stats(self, args);
+  } else if (strcmp(method, "setMemoryLimit") == 0) {
+    response = set_memory_limit(self, args);
+  } else if (strcmp(method, "endProfiling") == 0) {
+    // Writing and parsing the trace can take a while
+    run_on_worker(self, self->session_loader, method_call, end_profiling);
+    return;
+  } else if (strcmp(method, "startTracing") == 0) {
+    response = start_tracing(self, args);
+  } else if (strcmp(method, "stopTracing") == 0) {
+    // The trace file is written off the main thread
+    run_on_worker(self, self->session_loader, method_call, stop_tracing);
+    return;
+  } else if (strcmp(method, "getNativeContext") == 0) {
+    response = get_native_context(self, args);
+  } else if (strcmp(method, "setIntegerHandles") == 0) {
+    response = set_integer_handles(self, args);
   } else if (strcmp(method, "closeSession") == 0) {
     response = close_session(self, args);
+  } else if (strcmp(method, "createPipeline") == 0) {
+    response = create_pipeline(self, args);
+  } else if (strcmp(method, "runPipeline") == 0) {
+    run_with_inputs_on_worker(self, method_call, run_pipeline);
+    return;
+  } else if (strcmp(method, "closePipeline") == 0) {
+    response = close_pipeline(self, args);
+  } else if (strcmp(method, "runTensorOp") == 0) {
+    run_with_inputs_on_worker(self, method_call, run_tensor_op, true);
+    return;
+  } else if (strcmp(method, "openStream") == 0) {
+    response = open_stream(self, args);
+  } else if (strcmp(method, "submitStreamFrame") == 0) {
+    response = submit_stream_frame(self, args);
+  } else if (strcmp(method, "closeStream") == 0) {
+    response = close_stream(self, args);
+  } else if (strcmp(method, "generate") == 0) {
+    response = generate(self, args);
+  } else if (strcmp(method, "cancelGeneration") == 0) {
+    response = cancel_generation(self, args);
   } else if (strcmp(method, "getMetadata") == 0) {
     response = get_metadata(self, args);
   } else if (strcmp(method, "getInputInfo") == 0) {
@@ -164,12 +485,28 @@ static void flutter_onnxruntime_plugin_handle_method_call(FlutterOnnxruntimePlug
     response = get_output_info(self, args);
   } else if (strcmp(method, "createOrtValue") == 0) {
     response = create_ort_value(self, args);
+  } else if (strcmp(method, "createImageTensor") == 0) {
+    response = create_image_tensor(self, args);
   } else if (strcmp(method, "convertOrtValue") == 0) {
     response = convert_ort_value(self, args);
+  } else if (strcmp(method, "quantizeOrtValue") == 0) {
+    response = quantize_ort_value(self, args);
+  } else if (strcmp(method, "dequantizeOrtValue") == 0) {
+    response = dequantize_ort_value(self, args);
+  } else if (strcmp(method, "reshapeOrtValue") == 0) {
+    response = reshape_ort_value(self, args);
+  } else if (strcmp(method, "sliceOrtValue") == 0) {
+    response = slice_ort_value(self, args);
+  } else if (strcmp(method, "transposeOrtValue") == 0) {
+    response = transpose_ort_value(self, args);
+  } else if (strcmp(method, "concatOrtValues") == 0) {
+    response = concat_ort_values(self, args);
   } else if (strcmp(method, "getOrtValueData") == 0) {
     response = get_ort_value_data(self, args);
   } else if (strcmp(method, "releaseOrtValue") == 0) {
     response = release_ort_value(self, args);
+  } else if (strcmp(method, "releaseOrtValues") == 0) {
+    response = release_ort_values(self, args);
   } else {
     response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
   }
@@ -191,19 +528,58 @@ static FlMethodResponse *get_platform_version() {
   return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_string(uname_data.version)));
 }
 
-static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *model_path_value = fl_value_lookup_string(args, "modelPath");
-
-  if (model_path_value == nullptr || fl_value_get_type(model_path_value) != FL_VALUE_TYPE_STRING) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Model path cannot be null", nullptr));
+// Whether a provider option value turns a flag on, as ONNX Runtime parses it
+static bool is_provider_flag_on(const std::string &value) { return value == "1" || value == "true" || value == "True"; }
+
+// Collect the options of an execution provider: device_id from deviceId, then the provider's entries of the
+// providerOptions map sent by Dart ({provider: {key: value}}), which may override it. An enabled TensorRT engine or
+// timing cache without a path of its own is placed in the user cache directory. Returns an error response or nullptr.
+static FlMethodResponse *collect_provider_options(const std::map<std::string, FlValue *> &options_map,
+                                                  const std::string &provider, const std::string &device_id,
+                                                  std::map<std::string, std::string> &provider_options) {
+  provider_options["device_id"] = device_id;
+
+  FlValue *entries = nullptr;
+  auto all_options_val = options_map.find("providerOptions");
+  if (all_options_val != options_map.end() && fl_value_get_type(all_options_val->second) == FL_VALUE_TYPE_MAP) {
+    entries = fl_value_lookup_string(all_options_val->second, provider.c_str());
+  }
+  if (entries != nullptr && fl_value_get_type(entries) == FL_VALUE_TYPE_MAP) {
+    for (size_t i = 0; i < fl_value_get_length(entries); i++) {
+      FlValue *key = fl_value_get_map_key(entries, i);
+      FlValue *value = fl_value_get_map_value(entries, i);
+      if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING || fl_value_get_type(value) != FL_VALUE_TYPE_STRING) {
+        std::string error_message = "Options of provider " + provider + " must map names to strings";
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", error_message.c_str(), nullptr));
+      }
+      provider_options[fl_value_get_string(key)] = fl_value_get_string(value);
+    }
   }
 
-  const char *model_path = fl_value_get_string(model_path_value);
-
-  FlValue *session_options_value = fl_value_lookup_string(args, "sessionOptions");
-
-  Ort::SessionOptions session_options;
+  if (provider == "TENSOR_RT") {
+    // Flags of the TensorRT caches and the options holding their directories
+    static const std::pair<const char *, const char *> kCaches[] = {
+        {"trt_engine_cache_enable", "trt_engine_cache_path"}, {"trt_timing_cache_enable", "trt_timing_cache_path"}};
+    const std::string cache_dir = std::string(g_get_user_cache_dir()) + "/flutter_onnxruntime/tensorrt_engines";
+    for (const auto &[flag, path] : kCaches) {
+      auto flag_it = provider_options.find(flag);
+      if (flag_it == provider_options.end() || !is_provider_flag_on(flag_it->second) || provider_options.count(path)) {
+        continue;
+      }
+      if (g_mkdir_with_parents(cache_dir.c_str(), 0700) != 0) {
+        std::string error_message = "Failed to create TensorRT cache directory: " + cache_dir;
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("PROVIDER_ERROR", error_message.c_str(), nullptr));
+      }
+      provider_options[path] = cache_dir;
+    }
+  }
+  return nullptr;
+}
 
+// Configure session options from the sessionOptions map sent by Dart; profiling is set if the options enable it.
+// Returns an error response, or nullptr on success.
+static FlMethodResponse *build_session_options(FlValue *session_options_value, Ort::SessionOptions &session_options,
+                                               std::string &optimized_model_dir, bool &profiling) {
   // Configure session options if provided
   if (session_options_value != nullptr && fl_value_get_type(session_options_value) == FL_VALUE_TYPE_MAP) {
     auto options_map = fl_value_to_map(session_options_value);
@@ -219,6 +595,68 @@ static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue
       session_options.SetInterOpNumThreads(fl_value_get_int(inter_threads_val->second));
     }
 
+    auto level_val = options_map.find("graphOptimizationLevel");
+    if (level_val != options_map.end() && fl_value_get_type(level_val->second) == FL_VALUE_TYPE_STRING) {
+      GraphOptimizationLevel level;
+      if (!parseGraphOptimizationLevel(fl_value_get_string(level_val->second), &level)) {
+        std::string error_message =
+            std::string("Unknown graph optimization level: ") + fl_value_get_string(level_val->second);
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", error_message.c_str(), nullptr));
+      }
+      session_options.SetGraphOptimizationLevel(level);
+    }
+
+    // Memory arena and allocation planning; both default to on in ONNX Runtime
+    auto arena_val = options_map.find("useArena");
+    if (arena_val != options_map.end() && fl_value_get_type(arena_val->second) == FL_VALUE_TYPE_BOOL) {
+      if (fl_value_get_bool(arena_val->second)) {
+        session_options.EnableCpuMemArena();
+      } else {
+        session_options.DisableCpuMemArena();
+      }
+    }
+
+    auto mem_pattern_val = options_map.find("enableMemPattern");
+    if (mem_pattern_val != options_map.end() && fl_value_get_type(mem_pattern_val->second) == FL_VALUE_TYPE_BOOL) {
+      if (fl_value_get_bool(mem_pattern_val->second)) {
+        session_options.EnableMemPattern();
+      } else {
+        session_options.DisableMemPattern();
+      }
+    }
+
+    auto initializers_val = options_map.find("useDeviceAllocatorForInitializers");
+    if (initializers_val != options_map.end() && fl_value_get_type(initializers_val->second) == FL_VALUE_TYPE_BOOL &&
+        fl_value_get_bool(initializers_val->second)) {
+      session_options.AddConfigEntry("session.use_device_allocator_for_initializers", "1");
+    }
+
+    // Save the optimized graph in the user cache directory and load it from there next time
+    auto cache_val = options_map.find("cacheOptimizedModel");
+    if (cache_val != options_map.end() && fl_value_get_type(cache_val->second) == FL_VALUE_TYPE_BOOL &&
+        fl_value_get_bool(cache_val->second)) {
+      optimized_model_dir = std::string(g_get_user_cache_dir()) + "/flutter_onnxruntime/optimized_models";
+    }
+
+    // Write a trace of every run to profilingDirectory, or to the user cache directory, until endProfiling
+    auto profiling_val = options_map.find("enableProfiling");
+    if (profiling_val != options_map.end() && fl_value_get_type(profiling_val->second) == FL_VALUE_TYPE_BOOL &&
+        fl_value_get_bool(profiling_val->second)) {
+      std::string profiling_dir = std::string(g_get_user_cache_dir()) + "/flutter_onnxruntime/profiles";
+      auto profiling_dir_val = options_map.find("profilingDirectory");
+      if (profiling_dir_val != options_map.end() &&
+          fl_value_get_type(profiling_dir_val->second) == FL_VALUE_TYPE_STRING) {
+        profiling_dir = fl_value_get_string(profiling_dir_val->second);
+      }
+      if (g_mkdir_with_parents(profiling_dir.c_str(), 0700) != 0) {
+        std::string error_message = "Failed to create profiling directory: " + profiling_dir;
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", error_message.c_str(), nullptr));
+      }
+      // ONNX Runtime appends the start time and ".json" to this prefix
+      session_options.EnableProfiling((profiling_dir + "/onnxruntime_profile").c_str());
+      profiling = true;
+    }
+
     // get the device id, if not provided, set to 0
     int device_id = 0;
     auto device_id_val = options_map.find("deviceId");
@@ -272,8 +710,18 @@ static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue
 
           // Follow the example at
           // https://onnxruntime.ai/docs/execution-providers/CUDA-ExecutionProvider.html#using-v2-provider-options-struct
-          std::vector<const char *> keys{"device_id"};
-          std::vector<const char *> values{device_id_str.c_str()};
+          std::map<std::string, std::string> provider_options;
+          FlMethodResponse *options_error =
+              collect_provider_options(options_map, provider, device_id_str, provider_options);
+          if (options_error != nullptr) {
+            return options_error;
+          }
+          std::vector<const char *> keys;
+          std::vector<const char *> values;
+          for (const auto &option : provider_options) {
+            keys.push_back(option.first.c_str());
+            values.push_back(option.second.c_str());
+          }
           status =
               Ort::GetApi().UpdateCUDAProviderOptions(cuda_options_ptr.get(), keys.data(), values.data(), keys.size());
           if (status != nullptr) {
@@ -300,8 +748,18 @@ static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue
           };
           std::unique_ptr<OrtTensorRTProviderOptionsV2, TensorRTOptionsDeleter> tensorrt_options_ptr(tensorrt_options);
 
-          std::vector<const char *> keys{"device_id"};
-          std::vector<const char *> values{device_id_str.c_str()};
+          std::map<std::string, std::string> provider_options;
+          FlMethodResponse *options_error =
+              collect_provider_options(options_map, provider, device_id_str, provider_options);
+          if (options_error != nullptr) {
+            return options_error;
+          }
+          std::vector<const char *> keys;
+          std::vector<const char *> values;
+          for (const auto &option : provider_options) {
+            keys.push_back(option.first.c_str());
+            values.push_back(option.second.c_str());
+          }
           status = Ort::GetApi().UpdateTensorRTProviderOptions(tensorrt_options_ptr.get(), keys.data(), values.data(),
                                                                keys.size());
           if (status != nullptr) {
@@ -326,18 +784,99 @@ static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue
     }
   }
 
+  return nullptr;
+}
+
+// Run the warmup inferences requested by the session options ("warmupRuns" and "warmupDimensions", which maps
+// symbolic dimension names to sizes); returns an error response or nullptr
+static FlMethodResponse *warm_up_session(FlutterOnnxruntimePlugin *self, SessionHandle session_id,
+                                         FlValue *session_options_value) {
+  if (session_options_value == nullptr || fl_value_get_type(session_options_value) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
+
+  FlValue *runs_value = fl_value_lookup_string(session_options_value, "warmupRuns");
+  if (runs_value == nullptr || fl_value_get_type(runs_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(runs_value) <= 0) {
+    return nullptr;
+  }
+
+  std::map<std::string, int64_t> dynamic_dims;
+  FlValue *dims_value = fl_value_lookup_string(session_options_value, "warmupDimensions");
+  if (dims_value != nullptr && fl_value_get_type(dims_value) == FL_VALUE_TYPE_MAP) {
+    for (size_t i = 0; i < fl_value_get_length(dims_value); i++) {
+      FlValue *key = fl_value_get_map_key(dims_value, i);
+      FlValue *size = fl_value_get_map_value(dims_value, i);
+      if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING || fl_value_get_type(size) != FL_VALUE_TYPE_INT ||
+          fl_value_get_int(size) < 0) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+            "INVALID_ARG", "Warmup dimensions must map names to non-negative integers", nullptr));
+      }
+      dynamic_dims[fl_value_get_string(key)] = fl_value_get_int(size);
+    }
+  }
+
   try {
-    std::string session_id = self->session_manager->createSession(model_path, session_options);
+    self->session_manager->warmupSession(session_id, static_cast<int>(fl_value_get_int(runs_value)), dynamic_dims);
+  } catch (const Ort::Exception &e) {
+    std::string error_message = std::string("Session warmup failed: ") + e.what();
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", error_message.c_str(), nullptr));
+  }
+  return nullptr;
+}
 
-    std::vector<std::string> input_names = self->session_manager->getInputNames(session_id);
-    std::vector<std::string> output_names = self->session_manager->getOutputNames(session_id);
+// Warm up a new session as its options request, then respond with its ID and input and output names.
+// A session that fails to warm up is closed again, as Dart never learns its ID.
+static FlMethodResponse *session_created_response(FlutterOnnxruntimePlugin *self, SessionHandle session_id,
+                                                  FlValue *session_options_value) {
+  FlMethodResponse *error = warm_up_session(self, session_id, session_options_value);
+  if (error != nullptr) {
+    self->session_manager->closeSession(session_id);
+    return error;
+  }
 
-    g_autoptr(FlValue) result = fl_value_new_map();
-    fl_value_set_string_take(result, "sessionId", fl_value_new_string(session_id.c_str()));
-    fl_value_set_string_take(result, "inputNames", vector_to_fl_value(input_names));
-    fl_value_set_string_take(result, "outputNames", vector_to_fl_value(output_names));
-    fl_value_set_string_take(result, "status", fl_value_new_string("success")); // Keep status for compatibility maybe?
-    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  std::vector<std::string> input_names = self->session_manager->getInputNames(session_id);
+  std::vector<std::string> output_names = self->session_manager->getOutputNames(session_id);
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "sessionId", handle_to_fl_value(self, kSessionIdPrefix, session_id));
+  fl_value_set_string_take(result, "inputNames", vector_to_fl_value(input_names));
+  fl_value_set_string_take(result, "outputNames", vector_to_fl_value(output_names));
+  fl_value_set_string_take(result, "status", fl_value_new_string("success")); // Keep status for compatibility maybe?
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *model_path_value = fl_value_lookup_string(args, "modelPath");
+
+  if (model_path_value == nullptr || fl_value_get_type(model_path_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Model path cannot be null", nullptr));
+  }
+
+  const char *model_path = fl_value_get_string(model_path_value);
+
+  FlValue *session_options_value = fl_value_lookup_string(args, "sessionOptions");
+
+  Ort::SessionOptions session_options;
+  std::string optimized_model_dir;
+  bool profiling = false;
+  FlMethodResponse *error =
+      build_session_options(session_options_value, session_options, optimized_model_dir, profiling);
+  if (error != nullptr) {
+    return error;
+  }
+
+  // Parse the model from a memory mapping of the file instead of reading it
+  FlValue *map_model_value = fl_value_lookup_string(args, "mapModel");
+  bool map_model = map_model_value != nullptr && fl_value_get_type(map_model_value) == FL_VALUE_TYPE_BOOL &&
+                   fl_value_get_bool(map_model_value);
+
+  try {
+    // Sessions opened with equal options share a cached model when the session cache is enabled
+    std::string options_key = fl_value_to_canonical_string(session_options_value);
+    SessionHandle session_id = self->session_manager->createSession(model_path, session_options, options_key,
+                                                                    optimized_model_dir, map_model, profiling);
+    return session_created_response(self, session_id, session_options_value);
   } catch (const Ort::Exception &e) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
   } catch (const std::exception &e) {
@@ -346,6 +885,37 @@ static FlMethodResponse *create_session(FlutterOnnxruntimePlugin *self, FlValue
   }
 }
 
+static FlMethodResponse *create_session_from_buffer(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *model_data_value = fl_value_lookup_string(args, "modelData");
+
+  if (model_data_value == nullptr || fl_value_get_type(model_data_value) != FL_VALUE_TYPE_UINT8_LIST ||
+      fl_value_get_length(model_data_value) == 0) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Model data must be a non-empty Uint8List", nullptr));
+  }
+
+  // Models in memory have no file to cache an optimized graph for
+  FlValue *session_options_value = fl_value_lookup_string(args, "sessionOptions");
+  Ort::SessionOptions session_options;
+  std::string optimized_model_dir;
+  bool profiling = false;
+  FlMethodResponse *error =
+      build_session_options(session_options_value, session_options, optimized_model_dir, profiling);
+  if (error != nullptr) {
+    return error;
+  }
+
+  try {
+    SessionHandle session_id = self->session_manager->createSessionFromBuffer(
+        fl_value_get_uint8_list(model_data_value), fl_value_get_length(model_data_value), session_options);
+    return session_created_response(self, session_id, session_options_value);
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
 static FlMethodResponse *get_available_providers(FlutterOnnxruntimePlugin *self, FlValue *args) {
   std::vector<std::string> providers = Ort::GetAvailableProviders();
 
@@ -358,176 +928,1718 @@ static FlMethodResponse *get_available_providers(FlutterOnnxruntimePlugin *self,
   return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
-static FlMethodResponse *run_inference(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
-  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
-    return FL_METHOD_RESPONSE(
-        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+// Borrow the tensors of an inputs map from Dart ({name: {valueId: id}}); returns an error response if one of them
+// was released or never existed, or cannot be copied to the host for host_memory.
+// Stored tensors are borrowed rather than cloned; the leases keep them alive during inference
+// even if Dart releases them in the meantime
+static FlMethodResponse *collect_inputs(FlutterOnnxruntimePlugin *self, FlValue *inputs_value,
+                                        std::vector<TensorLease> &input_leases,
+                                        std::vector<const OrtValue *> &input_values,
+                                        std::vector<std::string> &input_names, bool host_memory = false) {
+  TraceScope trace("collectInputs");
+  size_t num_inputs = fl_value_get_length(inputs_value);
+  for (size_t i = 0; i < num_inputs; i++) {
+    FlValue *key = fl_value_get_map_key(inputs_value, i);
+    FlValue *value = fl_value_get_map_value(inputs_value, i);
+
+    if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING || fl_value_get_type(value) != FL_VALUE_TYPE_MAP) {
+      continue;
+    }
+
+    // Extract the input name from the map key
+    std::string input_name = fl_value_get_string(key);
+
+    TensorHandle tensor_id;
+    if (!lookup_handle(value, "valueId", kTensorIdPrefix, &tensor_id)) {
+      continue;
+    }
+
+    // Borrow the tensor value
+    TensorLease lease;
+    try {
+      lease = host_memory ? self->tensor_manager->acquireHostTensor(tensor_id)
+                          : self->tensor_manager->acquireTensor(tensor_id);
+    } catch (const std::exception &e) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "INVALID_ORT_VALUE", ("OrtValue of input " + input_name + ": " + e.what()).c_str(), nullptr));
+    }
+    if (!lease) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "INVALID_ORT_VALUE", ("OrtValue of input " + input_name + " not found").c_str(), nullptr));
+    }
+    input_values.push_back(lease.get());
+    input_names.push_back(input_name);
+    input_leases.push_back(std::move(lease));
   }
-  const char *session_id = fl_value_get_string(session_id_value);
+  return nullptr;
+}
 
+// Borrow the inputs of a call: its inputs map, or every map of its list of inputs for runBatch. Inputs of the wrong
+// type are left for the handler to report; returns an error response if a tensor cannot be borrowed.
+static FlMethodResponse *borrow_call_inputs(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs,
+                                            bool host_memory) {
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
   FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
-  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) { // inputs is a map from Dart
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  if (inputs_value == nullptr) {
+    return nullptr;
   }
 
-  FlValue *run_options_value = fl_value_lookup_string(args, "runOptions");
+  uint64_t borrow_start = steadyNanos();
+  std::vector<FlValue *> input_maps;
+  if (fl_value_get_type(inputs_value) == FL_VALUE_TYPE_MAP) {
+    input_maps.push_back(inputs_value);
+  } else if (fl_value_get_type(inputs_value) == FL_VALUE_TYPE_LIST) {
+    for (size_t r = 0; r < fl_value_get_length(inputs_value); r++) {
+      input_maps.push_back(fl_value_get_list_value(inputs_value, r));
+    }
+  }
+  for (FlValue *input_map : input_maps) {
+    inputs.values.emplace_back();
+    inputs.names.emplace_back();
+    if (fl_value_get_type(input_map) != FL_VALUE_TYPE_MAP) {
+      continue;
+    }
+    FlMethodResponse *error =
+        collect_inputs(self, input_map, inputs.leases, inputs.values.back(), inputs.names.back(), host_memory);
+    if (error != nullptr) {
+      return error;
+    }
+  }
+  inputs.nanos = steadyNanos() - borrow_start;
+  return nullptr;
+}
 
-  // Check if session exists
-  if (!self->session_manager->hasSession(session_id)) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+// Configure run options from the runOptions map sent by Dart
+static void apply_run_options(FlValue *run_options_value, Ort::RunOptions &run_options) {
+  if (run_options_value == nullptr || fl_value_get_type(run_options_value) != FL_VALUE_TYPE_MAP) {
+    return;
   }
 
-  try {
-    // Get expected input names from the session
-    std::vector<std::string> output_names = self->session_manager->getOutputNames(session_id);
+  // Extract log severity level if provided
+  FlValue *log_severity_level_value = fl_value_lookup_string(run_options_value, "logSeverityLevel");
+  if (log_severity_level_value != nullptr && fl_value_get_type(log_severity_level_value) == FL_VALUE_TYPE_INT) {
+    run_options.SetRunLogSeverityLevel(fl_value_get_int(log_severity_level_value));
+  }
 
-    // Prepare input tensors and input names
-    // Use ClonedTensor to keep backing buffers alive during inference
-    std::vector<ClonedTensor> cloned_inputs;
-    std::vector<std::string> input_names;
+  // Extract log verbosity level if provided
+  FlValue *log_verbosity_level_value = fl_value_lookup_string(run_options_value, "logVerbosityLevel");
+  if (log_verbosity_level_value != nullptr && fl_value_get_type(log_verbosity_level_value) == FL_VALUE_TYPE_INT) {
+    run_options.SetRunLogVerbosityLevel(fl_value_get_int(log_verbosity_level_value));
+  }
 
-    // Iterate through each input
-    size_t num_inputs = fl_value_get_length(inputs_value);
-    for (size_t i = 0; i < num_inputs; i++) {
-      FlValue *key = fl_value_get_map_key(inputs_value, i);
-      FlValue *value = fl_value_get_map_value(inputs_value, i);
+  // Extract terminate option if provided
+  FlValue *terminate_value = fl_value_lookup_string(run_options_value, "terminate");
+  if (terminate_value != nullptr && fl_value_get_type(terminate_value) == FL_VALUE_TYPE_BOOL) {
+    if (fl_value_get_bool(terminate_value)) {
+      run_options.SetTerminate();
+    }
+  }
 
-      if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING || fl_value_get_type(value) != FL_VALUE_TYPE_MAP) {
-        continue;
-      }
+  // The tag a call can be cancelled by also names its run in the ONNX Runtime logs
+  FlValue *run_tag_value = fl_value_lookup_string(run_options_value, "runTag");
+  if (run_tag_value != nullptr && fl_value_get_type(run_tag_value) == FL_VALUE_TYPE_STRING) {
+    run_options.SetRunTag(fl_value_get_string(run_tag_value));
+  }
+}
 
-      // Extract the input name from the map key
-      std::string input_name = fl_value_get_string(key);
+// The runOptions map of the arguments of a call, or nullptr if there is none
+static FlValue *lookup_run_options(FlValue *args) {
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
+  FlValue *run_options_value = fl_value_lookup_string(args, "runOptions");
+  if (run_options_value == nullptr || fl_value_get_type(run_options_value) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
+  return run_options_value;
+}
 
-      FlValue *tensor_id_map = fl_value_lookup_string(value, "valueId");
+// Scheduling priority of a call from the priority entry of its runOptions map, normal if there is none
+static JobPriority lookup_run_priority(FlValue *args) {
+  FlValue *run_options_value = lookup_run_options(args);
+  if (run_options_value == nullptr) {
+    return JobPriority::kNormal;
+  }
+  FlValue *priority_value = fl_value_lookup_string(run_options_value, "priority");
+  if (priority_value == nullptr || fl_value_get_type(priority_value) != FL_VALUE_TYPE_STRING) {
+    return JobPriority::kNormal;
+  }
+  const char *priority = fl_value_get_string(priority_value);
+  if (strcmp(priority, "high") == 0) {
+    return JobPriority::kHigh;
+  }
+  if (strcmp(priority, "low") == 0) {
+    return JobPriority::kLow;
+  }
+  return JobPriority::kNormal;
+}
 
-      if (tensor_id_map == nullptr || fl_value_get_type(tensor_id_map) != FL_VALUE_TYPE_STRING) {
-        continue;
-      }
+// Track a call in the run registry if its runOptions map has a runTag to cancel it by or a timeoutMs, and return
+// the control to submit it with; nullptr if it has neither
+static std::shared_ptr<RunControl> track_run(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *run_options_value = lookup_run_options(args);
+  if (run_options_value == nullptr) {
+    return nullptr;
+  }
+  std::string tag;
+  FlValue *tag_value = fl_value_lookup_string(run_options_value, "runTag");
+  if (tag_value != nullptr && fl_value_get_type(tag_value) == FL_VALUE_TYPE_STRING) {
+    tag = fl_value_get_string(tag_value);
+  }
+  uint64_t timeout_nanos = 0;
+  FlValue *timeout_value = fl_value_lookup_string(run_options_value, "timeoutMs");
+  if (timeout_value != nullptr && fl_value_get_type(timeout_value) == FL_VALUE_TYPE_INT &&
+      fl_value_get_int(timeout_value) > 0) {
+    timeout_nanos = static_cast<uint64_t>(fl_value_get_int(timeout_value)) * 1000000;
+  }
+  if (tag.empty() && timeout_nanos == 0) {
+    return nullptr;
+  }
 
-      std::string tensor_id = fl_value_get_string(tensor_id_map);
+  auto run = std::make_shared<RunControl>();
+  self->run_registry->track(run, tag, timeout_nanos);
+  return run;
+}
 
-      // Get the tensor value
-      Ort::Value *tensor_ptr = self->tensor_manager->getTensor(tensor_id);
-      if (tensor_ptr != nullptr) {
-        try {
-          // Clone the tensor — ClonedTensor owns both the Ort::Value and its backing buffer
-          ClonedTensor cloned = self->tensor_manager->cloneTensor(tensor_id);
-          cloned_inputs.push_back(std::move(cloned));
-          input_names.push_back(input_name);
-        } catch (const std::exception &e) {
-          g_warning("Failed to clone tensor %s: %s", tensor_id.c_str(), e.what());
-          // Continue with the next tensor
-        }
-      }
-    }
+// Error response of a failed run, which tells Dart apart runs that were stopped before they finished
+static FlMethodResponse *inference_error_response(const Ort::Exception &e) {
+  switch (RunScope::stopReason()) {
+  case RunStop::kPreempted:
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("RUN_PREEMPTED", e.what(), nullptr));
+  case RunStop::kCancelled:
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("RUN_CANCELLED", e.what(), nullptr));
+  case RunStop::kTimedOut:
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("RUN_TIMEOUT", e.what(), nullptr));
+  default:
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INFERENCE_ERROR", e.what(), nullptr));
+  }
+}
 
-    // Build a vector of Ort::Value references for Session::Run
-    std::vector<Ort::Value> input_tensors;
-    input_tensors.reserve(cloned_inputs.size());
-    for (auto &ci : cloned_inputs) {
-      input_tensors.push_back(std::move(ci.value));
+// Throw if one of the outputs is a sequence or a map: the tensor manager only stores tensors, so these cannot be
+// returned to Dart. Checked before any output is stored so that a failing call leaves no tensors behind.
+static void check_tensor_outputs(const std::vector<std::string> &names, const std::vector<Ort::Value> &outputs) {
+  for (size_t i = 0; i < outputs.size() && i < names.size(); i++) {
+    // Outputs kept as sequence state are empty and stay in the session
+    if (outputs[i] && !outputs[i].IsTensor()) {
+      throw std::runtime_error("Output " + names[i] + " is a sequence or map, only tensor outputs can be returned");
     }
+  }
+}
 
-    // Create and configure run options
-    Ort::RunOptions run_options;
-
-    // Configure run options if provided
-    if (run_options_value != nullptr && fl_value_get_type(run_options_value) == FL_VALUE_TYPE_MAP) {
-      // Extract log severity level if provided
-      FlValue *log_severity_level_value = fl_value_lookup_string(run_options_value, "logSeverityLevel");
-      if (log_severity_level_value != nullptr && fl_value_get_type(log_severity_level_value) == FL_VALUE_TYPE_INT) {
-        run_options.SetRunLogSeverityLevel(fl_value_get_int(log_severity_level_value));
-      }
-
-      // Extract log verbosity level if provided
-      FlValue *log_verbosity_level_value = fl_value_lookup_string(run_options_value, "logVerbosityLevel");
-      if (log_verbosity_level_value != nullptr && fl_value_get_type(log_verbosity_level_value) == FL_VALUE_TYPE_INT) {
-        run_options.SetRunLogVerbosityLevel(fl_value_get_int(log_verbosity_level_value));
-      }
-
-      // Extract terminate option if provided
-      FlValue *terminate_value = fl_value_lookup_string(run_options_value, "terminate");
-      if (terminate_value != nullptr && fl_value_get_type(terminate_value) == FL_VALUE_TYPE_BOOL) {
-        if (fl_value_get_bool(terminate_value)) {
-          run_options.SetTerminate();
-        }
-      }
+static void check_tensor_outputs(const std::vector<std::pair<std::string, Ort::Value>> &outputs) {
+  for (const auto &[name, value] : outputs) {
+    if (value && !value.IsTensor()) {
+      throw std::runtime_error("Output " + name + " is a sequence or map, only tensor outputs can be returned");
     }
+  }
+}
 
-    // Run inference using SessionManager with input names
-    // Note: cloned_inputs (with backing buffers) stays alive through this scope
-    std::vector<Ort::Value> output_tensors;
-    if (!input_tensors.empty()) {
-      output_tensors = self->session_manager->runInference(session_id, input_tensors, input_names, &run_options);
-    }
+// Build the [valueId, dataType, shape] entry that Dart expects for an output tensor
+static FlValue *output_info_to_fl_value(FlutterOnnxruntimePlugin *self, TensorHandle value_id) {
+  // get the tensor type and shape from tensor manager
+  std::string tensor_type = self->tensor_manager->getTensorType(value_id);
+  std::vector<int64_t> shape = self->tensor_manager->getTensorShape(value_id);
 
-    // Process outputs
-    g_autoptr(FlValue) outputs_map = fl_value_new_map();
+  FlValue *shape_list = fl_value_new_list();
+  for (const auto &dim : shape) {
+    fl_value_append_take(shape_list, fl_value_new_int(dim));
+  }
 
-    // For each output tensor, directly store it using TensorManager's storeTensor
-    for (size_t i = 0; i < output_tensors.size(); i++) {
-      // Create a tensor ID
-      std::string value_id = self->tensor_manager->generateTensorId();
+  // Note: Flutter does not allow return a nested map, so we have to use list here to keep the output_info format
+  FlValue *output_info = fl_value_new_list();
+  fl_value_append_take(output_info, handle_to_fl_value(self, kTensorIdPrefix, value_id));
+  fl_value_append_take(output_info, fl_value_new_string(tensor_type.c_str()));
+  fl_value_append_take(output_info, shape_list);
+  return output_info;
+}
 
-      // Store the tensor directly using storeTensor - this transfers ownership
-      self->tensor_manager->storeTensor(value_id, std::move(output_tensors[i]));
+// Largest output, in bytes, that runInference returns as data instead of storing it, from the returnDataMaxBytes run
+// option; 0 if every output is stored
+static uint64_t lookup_return_data_max_bytes(FlValue *run_options_value) {
+  if (run_options_value == nullptr || fl_value_get_type(run_options_value) != FL_VALUE_TYPE_MAP) {
+    return 0;
+  }
+  FlValue *max_bytes_value = fl_value_lookup_string(run_options_value, "returnDataMaxBytes");
+  if (max_bytes_value == nullptr || fl_value_get_type(max_bytes_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(max_bytes_value) <= 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(fl_value_get_int(max_bytes_value));
+}
 
-      // get the tensor type and shape from tensor manager
-      // Note: only do this after storeTensor get the tensor registered in tensor manager
-      std::string tensor_type = self->tensor_manager->getTensorType(value_id);
-      std::vector<int64_t> shape = self->tensor_manager->getTensorShape(value_id);
+// Whether a host output is small enough to return as data; string tensors are always stored
+static bool is_inline_output(Ort::Value &output, uint64_t max_bytes) {
+  if (max_bytes == 0 || !output.IsTensor()) {
+    return false;
+  }
+  Ort::TensorTypeAndShapeInfo info = output.GetTensorTypeAndShapeInfo();
+  size_t element_size = SessionManager::getElementSize(info.GetElementType());
+  return element_size > 0 && info.GetElementCount() * element_size <= max_bytes;
+}
 
-      // Add the value ID to the outputs map
-      FlValue *shape_list = fl_value_new_list();
-      for (const auto &dim : shape) {
-        fl_value_append_take(shape_list, fl_value_new_int(dim));
-      }
+// Look up the memory that runInference leaves its outputs in, from the outputDevice ("cuda") and outputDeviceId
+// run options. Leaves memory_info null and returns nullptr without an outputDevice; returns an error response if it
+// is invalid.
+static FlMethodResponse *lookup_output_device(FlValue *run_options_value, Ort::MemoryInfo &memory_info) {
+  if (run_options_value == nullptr || fl_value_get_type(run_options_value) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
+  FlValue *device_value = fl_value_lookup_string(run_options_value, "outputDevice");
+  if (device_value == nullptr || fl_value_get_type(device_value) == FL_VALUE_TYPE_NULL) {
+    return nullptr;
+  }
+  if (fl_value_get_type(device_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Output device must be a string", nullptr));
+  }
 
-      // Note: Flutter does not allow return a nested map, so we have to use list here to keep the output_info format
-      FlValue *output_info = fl_value_new_list();
-      fl_value_append_take(output_info, fl_value_new_string(value_id.c_str()));
-      fl_value_append_take(output_info, fl_value_new_string(tensor_type.c_str()));
-      fl_value_append_take(output_info, shape_list);
+  int device_id = 0;
+  FlValue *device_id_value = fl_value_lookup_string(run_options_value, "outputDeviceId");
+  if (device_id_value != nullptr && fl_value_get_type(device_id_value) == FL_VALUE_TYPE_INT) {
+    device_id = static_cast<int>(fl_value_get_int(device_id_value));
+  }
 
-      fl_value_set_string_take(outputs_map, output_names[i].c_str(), output_info);
-    }
-    return FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
-  } catch (const Ort::Exception &e) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INFERENCE_ERROR", e.what(), nullptr));
-  } catch (const std::exception &e) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  std::string device = fl_value_get_string(device_value);
+  if (device != "cuda") {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARG", ("Outputs cannot be kept on device " + device + " on Linux").c_str(), nullptr));
   }
+  memory_info = Ort::MemoryInfo("Cuda", OrtDeviceAllocator, device_id, OrtMemTypeDefault);
+  return nullptr;
 }
 
-static FlMethodResponse *close_session(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  // Get session ID
-  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
-
-  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
-    // Similar to closeSession, return success even if ID is invalid.
-    // Alternatively, return an error:
+static FlMethodResponse *run_inference(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs) {
+  TraceScope trace("runInference");
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
     return FL_METHOD_RESPONSE(
         fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
   }
 
-  const char *session_id = fl_value_get_string(session_id_value);
-
-  self->session_manager->closeSession(session_id);
-
-  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
-}
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) { // inputs is a map from Dart
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  }
 
-static FlMethodResponse *get_metadata(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
+  FlValue *run_options_value = fl_value_lookup_string(args, "runOptions");
 
-  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
+  Ort::MemoryInfo output_memory_info{nullptr};
+  FlMethodResponse *device_error = lookup_output_device(run_options_value, output_memory_info);
+  if (device_error != nullptr) {
+    return device_error;
+  }
+
+  // Check if session exists
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    // Compute only the requested outputs, or all outputs if no names are given
+    std::vector<std::string> requested_names;
+    FlValue *output_names_value = fl_value_lookup_string(args, "outputNames");
+    if (output_names_value != nullptr && fl_value_get_type(output_names_value) == FL_VALUE_TYPE_LIST) {
+      for (size_t i = 0; i < fl_value_get_length(output_names_value); i++) {
+        FlValue *name_value = fl_value_get_list_value(output_names_value, i);
+        if (fl_value_get_type(name_value) == FL_VALUE_TYPE_STRING) {
+          requested_names.push_back(fl_value_get_string(name_value));
+        }
+      }
+    }
+    std::vector<std::string> output_names =
+        requested_names.empty() ? self->session_manager->getOutputNames(session_id) : requested_names;
+
+    // The inputs were borrowed when the call arrived
+    const std::vector<const OrtValue *> &input_values = inputs.values[0];
+    const std::vector<std::string> &input_names = inputs.names[0];
+
+    // Create and configure run options
+    Ort::RunOptions run_options;
+    apply_run_options(run_options_value, run_options);
+    // The run stops early if it is cancelled, times out or a high-priority run needs its worker
+    RunScope run_scope([&run_options] { run_options.SetTerminate(); });
+
+    // Run inference using SessionManager with input names
+    // Note: the leases of the inputs stay alive until the call has been answered
+    std::vector<Ort::Value> output_tensors;
+    if (!input_values.empty() && output_memory_info) {
+      output_tensors = self->session_manager->runInferenceOnDevice(session_id, input_values, input_names,
+                                                                   output_memory_info, &run_options, requested_names);
+    } else if (!input_values.empty()) {
+      output_tensors =
+          self->session_manager->runInference(session_id, input_values, input_names, &run_options, requested_names);
+    }
+
+    // Process outputs
+    check_tensor_outputs(output_names, output_tensors);
+    uint64_t output_start = steadyNanos();
+    g_autoptr(FlValue) outputs_map = fl_value_new_map();
+    uint64_t return_data_max_bytes = output_memory_info ? 0 : lookup_return_data_max_bytes(run_options_value);
+
+    // For each output tensor, directly store it using TensorManager's storeTensor
+    for (size_t i = 0; i < output_tensors.size(); i++) {
+      // Outputs kept as sequence state stay in the session
+      if (!output_tensors[i]) {
+        continue;
+      }
+
+      // Small outputs come back as a {data, dataType, shape} map and are never stored
+      if (is_inline_output(output_tensors[i], return_data_max_bytes)) {
+        fl_value_set_string_take(outputs_map, output_names[i].c_str(), encodeTensor<FlValueCodec>(output_tensors[i]));
+        continue;
+      }
+
+      // Store the tensor directly using storeTensor - this transfers ownership
+      TensorHandle value_id = self->tensor_manager->storeTensor(std::move(output_tensors[i]));
+
+      // Add the value ID to the outputs map
+      // Note: only do this after storeTensor get the tensor registered in tensor manager
+      fl_value_set_string_take(outputs_map, output_names[i].c_str(), output_info_to_fl_value(self, value_id));
+    }
+    self->session_manager->recordCall(session_id, inputs.nanos, steadyNanos() - output_start);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
+  } catch (const Ort::Exception &e) {
+    return inference_error_response(e);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *run_batch(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_LIST) { // one inputs map per request
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null list", nullptr));
+  }
+
+  FlValue *run_options_value = fl_value_lookup_string(args, "runOptions");
+
+  // Check if session exists
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    std::vector<std::string> output_names = self->session_manager->getOutputNames(session_id);
+
+    // The inputs of every request were borrowed when the call arrived
+    for (size_t r = 0; r < fl_value_get_length(inputs_value); r++) {
+      if (fl_value_get_type(fl_value_get_list_value(inputs_value, r)) != FL_VALUE_TYPE_MAP) {
+        return FL_METHOD_RESPONSE(
+            fl_method_error_response_new("INVALID_ARG", "Each batch entry must be a map of inputs", nullptr));
+      }
+    }
+
+    // Create and configure run options
+    Ort::RunOptions run_options;
+    apply_run_options(run_options_value, run_options);
+    // The run stops early if it is cancelled, times out or a high-priority run needs its worker
+    RunScope run_scope([&run_options] { run_options.SetTerminate(); });
+
+    std::vector<std::vector<Ort::Value>> batch_outputs =
+        self->session_manager->runBatch(session_id, inputs.values, inputs.names, &run_options);
+
+    for (const auto &output_tensors : batch_outputs) {
+      check_tensor_outputs(output_names, output_tensors);
+    }
+
+    // One outputs map per request, in request order
+    uint64_t output_start = steadyNanos();
+    g_autoptr(FlValue) results = fl_value_new_list();
+    for (auto &output_tensors : batch_outputs) {
+      FlValue *outputs_map = fl_value_new_map();
+      for (size_t i = 0; i < output_tensors.size(); i++) {
+        TensorHandle value_id = self->tensor_manager->storeTensor(std::move(output_tensors[i]));
+        fl_value_set_string_take(outputs_map, output_names[i].c_str(), output_info_to_fl_value(self, value_id));
+      }
+      fl_value_append_take(results, outputs_map);
+    }
+    self->session_manager->recordCall(session_id, inputs.nanos, steadyNanos() - output_start);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(results));
+  } catch (const Ort::Exception &e) {
+    return inference_error_response(e);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *bind_outputs(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  // Check if session exists
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  std::vector<TensorInfo> output_info = self->session_manager->getOutputInfo(session_id);
+
+  // Bind the requested outputs, or all outputs if no names are given
+  std::vector<std::string> output_names;
+  FlValue *output_names_value = fl_value_lookup_string(args, "outputNames");
+  if (output_names_value != nullptr && fl_value_get_type(output_names_value) == FL_VALUE_TYPE_LIST) {
+    for (size_t i = 0; i < fl_value_get_length(output_names_value); i++) {
+      FlValue *name_value = fl_value_get_list_value(output_names_value, i);
+      if (fl_value_get_type(name_value) == FL_VALUE_TYPE_STRING) {
+        output_names.push_back(fl_value_get_string(name_value));
+      }
+    }
+  } else {
+    for (const auto &info : output_info) {
+      output_names.push_back(info.name);
+    }
+  }
+
+  // Preallocate one tensor per output; they are released again if any of them cannot be created
+  std::vector<TensorHandle> value_ids;
+  std::vector<TensorLease> outputs;
+  try {
+    for (const auto &name : output_names) {
+      auto info_it = std::find_if(output_info.begin(), output_info.end(),
+                                  [&name](const TensorInfo &info) { return info.name == name; });
+      if (info_it == output_info.end()) {
+        throw std::runtime_error("Unknown output name: " + name);
+      }
+
+      try {
+        value_ids.push_back(self->tensor_manager->createEmptyTensor(info_it->element_type, info_it->shape));
+      } catch (const std::exception &e) {
+        throw std::runtime_error("Cannot bind output " + name + ": " + e.what());
+      }
+      outputs.push_back(self->tensor_manager->acquireTensor(value_ids.back()));
+    }
+
+    self->session_manager->bindOutputs(session_id, output_names, std::move(outputs));
+  } catch (const std::exception &e) {
+    outputs.clear();
+    for (const auto &value_id : value_ids) {
+      self->tensor_manager->releaseTensor(value_id);
+    }
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  }
+
+  g_autoptr(FlValue) outputs_map = fl_value_new_map();
+  for (size_t i = 0; i < output_names.size(); i++) {
+    fl_value_set_string_take(outputs_map, output_names[i].c_str(), output_info_to_fl_value(self, value_ids[i]));
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
+}
+
+static FlMethodResponse *run_with_binding(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  }
+
+  // Check if session exists
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    Ort::RunOptions run_options;
+    apply_run_options(fl_value_lookup_string(args, "runOptions"), run_options);
+    // The run stops early if it is cancelled, times out or a high-priority run needs its worker
+    RunScope run_scope([&run_options] { run_options.SetTerminate(); });
+
+    // Outputs are written in place into the tensors created by bindOutputs
+    std::vector<std::pair<std::string, TensorHandle>> bound_outputs =
+        self->session_manager->runWithBinding(session_id, inputs.values[0], inputs.names[0], &run_options);
+
+    uint64_t output_start = steadyNanos();
+    g_autoptr(FlValue) outputs_map = fl_value_new_map();
+    for (const auto &bound_output : bound_outputs) {
+      if (self->tensor_manager->getTensor(bound_output.second) == nullptr) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+            "INVALID_VALUE", ("Bound output " + bound_output.first + " was released, call bindOutputs again").c_str(),
+            nullptr));
+      }
+      fl_value_set_string_take(outputs_map, bound_output.first.c_str(),
+                               output_info_to_fl_value(self, bound_output.second));
+    }
+    self->session_manager->recordCall(session_id, inputs.nanos, steadyNanos() - output_start);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
+  } catch (const Ort::Exception &e) {
+    return inference_error_response(e);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *unbind_outputs(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  self->session_manager->unbindOutputs(session_id);
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *enable_sequence_state(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  // Loops map output names to the input names they feed
+  FlValue *loops_value = fl_value_lookup_string(args, "loops");
+  if (loops_value == nullptr || fl_value_get_type(loops_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Loops must be a non-null map", nullptr));
+  }
+  std::vector<std::pair<std::string, std::string>> loops;
+  for (size_t i = 0; i < fl_value_get_length(loops_value); i++) {
+    FlValue *output = fl_value_get_map_key(loops_value, i);
+    FlValue *input = fl_value_get_map_value(loops_value, i);
+    if (fl_value_get_type(output) != FL_VALUE_TYPE_STRING || fl_value_get_type(input) != FL_VALUE_TYPE_STRING) {
+      return FL_METHOD_RESPONSE(
+          fl_method_error_response_new("INVALID_ARG", "Loops must map output names to input names", nullptr));
+    }
+    loops.emplace_back(fl_value_get_string(output), fl_value_get_string(input));
+  }
+
+  std::map<std::string, int64_t> initial_dims;
+  FlValue *dims_value = fl_value_lookup_string(args, "initialDimensions");
+  if (dims_value != nullptr && fl_value_get_type(dims_value) == FL_VALUE_TYPE_MAP) {
+    for (size_t i = 0; i < fl_value_get_length(dims_value); i++) {
+      FlValue *key = fl_value_get_map_key(dims_value, i);
+      FlValue *size = fl_value_get_map_value(dims_value, i);
+      if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING || fl_value_get_type(size) != FL_VALUE_TYPE_INT ||
+          fl_value_get_int(size) < 0) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+            "INVALID_ARG", "Initial dimensions must map names to non-negative integers", nullptr));
+      }
+      initial_dims[fl_value_get_string(key)] = fl_value_get_int(size);
+    }
+  }
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  try {
+    self->session_manager->enableSequenceState(session_id, loops, initial_dims);
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *reset_sequence_state(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  try {
+    if (!self->session_manager->resetSequenceState(session_id)) {
+      return FL_METHOD_RESPONSE(
+          fl_method_error_response_new("INVALID_SESSION", "Session not found or without sequence state", nullptr));
+    }
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *disable_sequence_state(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  self->session_manager->disableSequenceState(session_id);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+// Respond to a method call on the main thread, where the Flutter engine expects it
+static gboolean respond_on_main_thread(gpointer user_data) {
+  InferenceResponse *pending = static_cast<InferenceResponse *>(user_data);
+
+  fl_method_call_respond(pending->method_call, pending->response, nullptr);
+
+  g_object_unref(pending->response);
+  g_object_unref(pending->method_call);
+  g_object_unref(pending->self);
+  delete pending;
+  return G_SOURCE_REMOVE;
+}
+
+static void run_on_worker(FlutterOnnxruntimePlugin *self, InferenceExecutor *executor, FlMethodCall *method_call,
+                          MethodHandler handler) {
+  // Keep the plugin and the method call alive until the response has been sent
+  InferenceResponse *pending =
+      new InferenceResponse{FLUTTER_ONNXRUNTIME_PLUGIN(g_object_ref(self)), FL_METHOD_CALL(g_object_ref(method_call)),
+                            nullptr};
+
+  FlValue *args = fl_method_call_get_args(method_call);
+  std::shared_ptr<RunControl> run = track_run(self, args);
+  executor->submit(
+      [pending, handler, run]() {
+        FlMethodResponse *response = nullptr;
+        try {
+          response = handler(pending->self, fl_method_call_get_args(pending->method_call));
+        } catch (const std::exception &e) {
+          response = FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+        }
+        if (response == nullptr) {
+          response = FL_METHOD_RESPONSE(
+              fl_method_error_response_new("INTERNAL_ERROR", "Failed to process method call", nullptr));
+        }
+        if (run) {
+          pending->self->run_registry->untrack(run);
+        }
+        pending->response = response;
+        g_idle_add(respond_on_main_thread, pending);
+      },
+      lookup_run_priority(args), run);
+}
+
+static void run_with_inputs_on_worker(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call,
+                                      InputsHandler handler, bool host_memory) {
+  // std::function needs a copyable callable, hence the shared_ptr around the inputs
+  auto inputs = std::make_shared<CallInputs>();
+  g_autoptr(FlMethodResponse) error =
+      borrow_call_inputs(self, fl_method_call_get_args(method_call), *inputs, host_memory);
+  if (error != nullptr) {
+    fl_method_call_respond(method_call, error, nullptr);
+    return;
+  }
+  run_on_worker(self, self->inference_executor, method_call,
+                [handler, inputs](FlutterOnnxruntimePlugin *plugin, FlValue *args) {
+                  return handler(plugin, args, *inputs);
+                });
+}
+
+static bool submit_batched_inference(FlutterOnnxruntimePlugin *self, FlMethodCall *method_call) {
+  FlValue *args = fl_method_call_get_args(method_call);
+  SessionHandle session_id;
+  if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP ||
+      !lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id) || !self->micro_batcher->isEnabled(session_id)) {
+    return false;
+  }
+
+  // Invalid calls run on their own so that run_inference reports the error
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return false;
+  }
+
+  // A batch runs with default run options, so calls with their own options are not batched
+  FlValue *run_options_value = fl_value_lookup_string(args, "runOptions");
+  if (run_options_value != nullptr && fl_value_get_type(run_options_value) == FL_VALUE_TYPE_MAP &&
+      fl_value_get_length(run_options_value) > 0) {
+    return false;
+  }
+
+  // Batches return every output, so calls that select some of them are not batched either
+  FlValue *output_names_value = fl_value_lookup_string(args, "outputNames");
+  if (output_names_value != nullptr && fl_value_get_type(output_names_value) == FL_VALUE_TYPE_LIST &&
+      fl_value_get_length(output_names_value) > 0) {
+    return false;
+  }
+
+  // Calls with inputs that cannot be borrowed run on their own as well, which reports the error
+  BatchedInference request;
+  g_autoptr(FlMethodResponse) error =
+      collect_inputs(self, inputs_value, request.input_leases, request.input_values, request.input_names);
+  if (error != nullptr || request.input_values.empty()) {
+    return false;
+  }
+
+  // Keep the plugin and the method call alive until the response has been sent
+  request.pending = new InferenceResponse{FLUTTER_ONNXRUNTIME_PLUGIN(g_object_ref(self)),
+                                          FL_METHOD_CALL(g_object_ref(method_call)), nullptr};
+  InferenceResponse *pending = request.pending;
+  if (!self->micro_batcher->submit(session_id, std::move(request))) {
+    // Batching was disabled in the meantime
+    g_object_unref(pending->method_call);
+    g_object_unref(pending->self);
+    delete pending;
+    return false;
+  }
+  return true;
+}
+
+static void dispatch_batch(FlutterOnnxruntimePlugin *self, SessionHandle session_id,
+                           std::vector<BatchedInference> &&batch) {
+  // std::function needs a copyable callable, hence the shared_ptr around the batch
+  auto requests = std::make_shared<std::vector<BatchedInference>>(std::move(batch));
+
+  self->inference_executor->submit([self, session_id, requests]() {
+    std::vector<FlMethodResponse *> responses(requests->size(), nullptr);
+    try {
+      std::vector<std::vector<const OrtValue *>> input_values;
+      std::vector<std::vector<std::string>> input_names;
+      for (const auto &request : *requests) {
+        input_values.push_back(request.input_values);
+        input_names.push_back(request.input_names);
+      }
+
+      // The requests come from unrelated calls, so one that fails is answered with its own error
+      std::vector<std::string> output_names = self->session_manager->getOutputNames(session_id);
+      std::vector<std::string> errors;
+      std::vector<std::vector<Ort::Value>> batch_outputs =
+          self->session_manager->runBatch(session_id, input_values, input_names, nullptr, &errors);
+
+      // The inputs were borrowed when each request was queued, so only the outputs are timed
+      uint64_t output_start = steadyNanos();
+      for (size_t r = 0; r < batch_outputs.size(); r++) {
+        if (!errors[r].empty()) {
+          responses[r] =
+              FL_METHOD_RESPONSE(fl_method_error_response_new("INFERENCE_ERROR", errors[r].c_str(), nullptr));
+          continue;
+        }
+        std::vector<TensorHandle> stored_ids;
+        try {
+          check_tensor_outputs(output_names, batch_outputs[r]);
+          g_autoptr(FlValue) outputs_map = fl_value_new_map();
+          for (size_t i = 0; i < batch_outputs[r].size(); i++) {
+            stored_ids.push_back(self->tensor_manager->storeTensor(std::move(batch_outputs[r][i])));
+            fl_value_set_string_take(outputs_map, output_names[i].c_str(),
+                                     output_info_to_fl_value(self, stored_ids.back()));
+          }
+          responses[r] = FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
+        } catch (const std::exception &e) {
+          // Dart never learns the IDs of the outputs stored before the failure, so they are released here
+          self->tensor_manager->releaseTensors(stored_ids);
+          responses[r] = FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+        }
+      }
+      self->session_manager->recordCall(session_id, 0, steadyNanos() - output_start);
+    } catch (const Ort::Exception &e) {
+      for (auto &response : responses) {
+        g_clear_object(&response);
+        response = FL_METHOD_RESPONSE(fl_method_error_response_new("INFERENCE_ERROR", e.what(), nullptr));
+      }
+    } catch (const std::exception &e) {
+      for (auto &response : responses) {
+        g_clear_object(&response);
+        response = FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+      }
+    }
+
+    // Every request of the batch gets its own response on the main thread
+    for (size_t r = 0; r < requests->size(); r++) {
+      InferenceResponse *pending = (*requests)[r].pending;
+      pending->response = responses[r] != nullptr ? responses[r]
+                                                  : FL_METHOD_RESPONSE(fl_method_error_response_new(
+                                                        "INTERNAL_ERROR", "Failed to process method call", nullptr));
+      g_idle_add(respond_on_main_thread, pending);
+    }
+  });
+}
+
+static FlMethodResponse *set_inference_threads(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *num_threads_value = fl_value_lookup_string(args, "numThreads");
+  if (num_threads_value == nullptr || fl_value_get_type(num_threads_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(num_threads_value) < 1) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Number of threads must be a positive integer", nullptr));
+  }
+
+  self->inference_executor->setNumThreads(static_cast<size_t>(fl_value_get_int(num_threads_value)));
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *get_queue_stats(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  static const char *kPriorityNames[kJobPriorityCount] = {"high", "normal", "low"};
+  std::array<JobQueueStats, kJobPriorityCount> stats = self->inference_executor->getQueueStats();
+
+  // Durations are sent in microseconds
+  g_autoptr(FlValue) result = fl_value_new_map();
+  for (size_t i = 0; i < kJobPriorityCount; i++) {
+    FlValue *queue = fl_value_new_map();
+    fl_value_set_string_take(queue, "queued", fl_value_new_int(static_cast<int64_t>(stats[i].queued)));
+    fl_value_set_string_take(queue, "submitted", fl_value_new_int(static_cast<int64_t>(stats[i].submitted)));
+    fl_value_set_string_take(queue, "started", fl_value_new_int(static_cast<int64_t>(stats[i].started)));
+    fl_value_set_string_take(queue, "preempted", fl_value_new_int(static_cast<int64_t>(stats[i].preempted)));
+    fl_value_set_string_take(queue, "waitMicros", fl_value_new_int(static_cast<int64_t>(stats[i].wait_micros)));
+    fl_value_set_string_take(queue, "maxWaitMicros", fl_value_new_int(static_cast<int64_t>(stats[i].max_wait_micros)));
+    fl_value_set_string_take(queue, "p50WaitMicros", fl_value_new_int(static_cast<int64_t>(stats[i].p50_wait_micros)));
+    fl_value_set_string_take(queue, "p90WaitMicros", fl_value_new_int(static_cast<int64_t>(stats[i].p90_wait_micros)));
+    fl_value_set_string_take(queue, "p99WaitMicros", fl_value_new_int(static_cast<int64_t>(stats[i].p99_wait_micros)));
+    fl_value_set_string_take(result, kPriorityNames[i], queue);
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *cancel_low_priority_runs(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  size_t count = self->inference_executor->cancelLowPriority();
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_int(static_cast<int64_t>(count))));
+}
+
+static FlMethodResponse *cancel_run(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *tag_value = fl_value_lookup_string(args, "runTag");
+  if (tag_value == nullptr || fl_value_get_type(tag_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Run tag must be a non-null string", nullptr));
+  }
+
+  // False if no call with the tag is in flight, e.g. because it has already finished
+  bool cancelled = self->run_registry->cancel(fl_value_get_string(tag_value));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_bool(cancelled)));
+}
+
+static FlMethodResponse *set_integer_handles(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *enabled_value = fl_value_lookup_string(args, "enabled");
+  if (enabled_value == nullptr || fl_value_get_type(enabled_value) != FL_VALUE_TYPE_BOOL) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Enabled must be a boolean", nullptr));
+  }
+
+  // Only changes how IDs are sent from now on; both forms are always accepted from Dart
+  g_atomic_int_set(&self->integer_handles, fl_value_get_bool(enabled_value) ? 1 : 0);
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *configure_session_cache(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *max_sessions_value = fl_value_lookup_string(args, "maxSessions");
+  FlValue *max_bytes_value = fl_value_lookup_string(args, "maxBytes");
+  if (max_sessions_value == nullptr || fl_value_get_type(max_sessions_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(max_sessions_value) < 0 || max_bytes_value == nullptr ||
+      fl_value_get_type(max_bytes_value) != FL_VALUE_TYPE_INT || fl_value_get_int(max_bytes_value) < 0) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARG", "Session and byte limits must be non-negative integers", nullptr));
+  }
+
+  // Both limits 0 disable the cache
+  self->session_manager->configureSessionCache(static_cast<size_t>(fl_value_get_int(max_sessions_value)),
+                                               static_cast<size_t>(fl_value_get_int(max_bytes_value)));
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *configure_thread_pools(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *intra_value = fl_value_lookup_string(args, "intraOpNumThreads");
+  FlValue *inter_value = fl_value_lookup_string(args, "interOpNumThreads");
+  if (intra_value == nullptr || fl_value_get_type(intra_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(intra_value) < 0 || inter_value == nullptr ||
+      fl_value_get_type(inter_value) != FL_VALUE_TYPE_INT || fl_value_get_int(inter_value) < 0) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Thread counts must be non-negative integers", nullptr));
+  }
+
+  ThreadPoolOptions options;
+  options.intra_op_threads = static_cast<int>(fl_value_get_int(intra_value));
+  options.inter_op_threads = static_cast<int>(fl_value_get_int(inter_value));
+
+  FlValue *spinning_value = fl_value_lookup_string(args, "allowSpinning");
+  if (spinning_value != nullptr && fl_value_get_type(spinning_value) == FL_VALUE_TYPE_BOOL) {
+    options.allow_spinning = fl_value_get_bool(spinning_value);
+  }
+
+  FlValue *affinity_value = fl_value_lookup_string(args, "intraOpThreadAffinity");
+  if (affinity_value != nullptr && fl_value_get_type(affinity_value) == FL_VALUE_TYPE_STRING) {
+    options.intra_op_affinity = fl_value_get_string(affinity_value);
+  }
+
+  try {
+    self->session_manager->configureThreadPools(options);
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *configure_shared_arena(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  ArenaOptions options;
+  FlValue *max_bytes_value = fl_value_lookup_string(args, "maxBytes");
+  if (max_bytes_value != nullptr && fl_value_get_type(max_bytes_value) == FL_VALUE_TYPE_INT) {
+    if (fl_value_get_int(max_bytes_value) < 0) {
+      return FL_METHOD_RESPONSE(
+          fl_method_error_response_new("INVALID_ARG", "maxBytes must be a non-negative integer", nullptr));
+    }
+    options.max_bytes = static_cast<size_t>(fl_value_get_int(max_bytes_value));
+  }
+
+  FlValue *strategy_value = fl_value_lookup_string(args, "extendStrategy");
+  if (strategy_value != nullptr && fl_value_get_type(strategy_value) == FL_VALUE_TYPE_STRING) {
+    const char *strategy = fl_value_get_string(strategy_value);
+    if (strcmp(strategy, "nextPowerOfTwo") == 0) {
+      options.extend_strategy = 0;
+    } else if (strcmp(strategy, "sameAsRequested") == 0) {
+      options.extend_strategy = 1;
+    } else {
+      std::string error_message = std::string("Unknown arena extend strategy: ") + strategy;
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", error_message.c_str(), nullptr));
+    }
+  }
+
+  FlValue *chunk_value = fl_value_lookup_string(args, "initialChunkBytes");
+  if (chunk_value != nullptr && fl_value_get_type(chunk_value) == FL_VALUE_TYPE_INT) {
+    options.initial_chunk_bytes = static_cast<int>(fl_value_get_int(chunk_value));
+  }
+
+  FlValue *dead_bytes_value = fl_value_lookup_string(args, "maxDeadBytesPerChunk");
+  if (dead_bytes_value != nullptr && fl_value_get_type(dead_bytes_value) == FL_VALUE_TYPE_INT) {
+    options.max_dead_bytes_per_chunk = static_cast<int>(fl_value_get_int(dead_bytes_value));
+  }
+
+  try {
+    self->session_manager->configureSharedArena(options);
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *configure_batching(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  FlValue *max_batch_size_value = fl_value_lookup_string(args, "maxBatchSize");
+  FlValue *window_value = fl_value_lookup_string(args, "windowMicros");
+  if (max_batch_size_value == nullptr || fl_value_get_type(max_batch_size_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(max_batch_size_value) < 0 || window_value == nullptr ||
+      fl_value_get_type(window_value) != FL_VALUE_TYPE_INT || fl_value_get_int(window_value) < 0) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARG", "Batch size and window must be non-negative integers", nullptr));
+  }
+
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  // A batch size below 2 disables batching
+  self->micro_batcher->configure(session_id, std::chrono::microseconds(fl_value_get_int(window_value)),
+                                 static_cast<size_t>(fl_value_get_int(max_batch_size_value)));
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *get_batching_stats(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  BatchingStats stats = self->micro_batcher->getStats(session_id);
+
+  g_autoptr(FlValue) histogram = fl_value_new_list();
+  for (uint64_t count : stats.batch_size_histogram) {
+    fl_value_append_take(histogram, fl_value_new_int(static_cast<int64_t>(count)));
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "queueDepth", fl_value_new_int(static_cast<int64_t>(stats.queue_depth)));
+  fl_value_set_string_take(result, "maxQueueDepth", fl_value_new_int(static_cast<int64_t>(stats.max_queue_depth)));
+  fl_value_set_string_take(result, "requests", fl_value_new_int(static_cast<int64_t>(stats.requests)));
+  fl_value_set_string_take(result, "batches", fl_value_new_int(static_cast<int64_t>(stats.batches)));
+  fl_value_set_string(result, "batchSizeHistogram", histogram);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *get_session_stats(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  std::optional<SessionStatsSnapshot> stats = self->session_manager->getSessionStats(session_id);
+  if (!stats) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  // Durations are sent in microseconds
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "runs", fl_value_new_int(static_cast<int64_t>(stats->runs)));
+  fl_value_set_string_take(result, "runMicros", fl_value_new_int(static_cast<int64_t>(stats->run_nanos / 1000)));
+  fl_value_set_string_take(result, "p50Micros", fl_value_new_int(static_cast<int64_t>(stats->p50_micros)));
+  fl_value_set_string_take(result, "p90Micros", fl_value_new_int(static_cast<int64_t>(stats->p90_micros)));
+  fl_value_set_string_take(result, "p99Micros", fl_value_new_int(static_cast<int64_t>(stats->p99_micros)));
+  fl_value_set_string_take(result, "calls", fl_value_new_int(static_cast<int64_t>(stats->calls)));
+  fl_value_set_string_take(result, "inputMicros", fl_value_new_int(static_cast<int64_t>(stats->input_nanos / 1000)));
+  fl_value_set_string_take(result, "outputMicros", fl_value_new_int(static_cast<int64_t>(stats->output_nanos / 1000)));
+  fl_value_set_string_take(result, "bytesIn", fl_value_new_int(static_cast<int64_t>(stats->bytes_in)));
+  fl_value_set_string_take(result, "bytesOut", fl_value_new_int(static_cast<int64_t>(stats->bytes_out)));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *get_memory_stats(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TensorMemoryStats stats = self->tensor_manager->getMemoryStats();
+  BufferPoolStats pool = self->tensor_manager->getBufferPoolStats();
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "tensorCount", fl_value_new_int(static_cast<int64_t>(stats.tensor_count)));
+  fl_value_set_string_take(result, "hostBytes", fl_value_new_int(static_cast<int64_t>(stats.host_bytes)));
+  FlValue *bytes_by_type = fl_value_new_map();
+  for (const auto &entry : stats.host_bytes_by_type) {
+    fl_value_set_string_take(bytes_by_type, entry.first.c_str(), fl_value_new_int(static_cast<int64_t>(entry.second)));
+  }
+  fl_value_set_string_take(result, "hostBytesByType", bytes_by_type);
+  fl_value_set_string_take(result, "deviceBytes", fl_value_new_int(static_cast<int64_t>(stats.device_bytes)));
+  fl_value_set_string_take(result, "retiredCount", fl_value_new_int(static_cast<int64_t>(stats.retired_count)));
+  fl_value_set_string_take(result, "hardLimitBytes", fl_value_new_int(static_cast<int64_t>(stats.hard_limit_bytes)));
+
+  FlValue *pool_map = fl_value_new_map();
+  fl_value_set_string_take(pool_map, "hits", fl_value_new_int(static_cast<int64_t>(pool.hits)));
+  fl_value_set_string_take(pool_map, "misses", fl_value_new_int(static_cast<int64_t>(pool.misses)));
+  fl_value_set_string_take(pool_map, "retainedBytes", fl_value_new_int(static_cast<int64_t>(pool.retained_bytes)));
+  fl_value_set_string_take(pool_map, "retainedBuffers", fl_value_new_int(static_cast<int64_t>(pool.retained_buffers)));
+  fl_value_set_string_take(pool_map, "maxRetainedBytes",
+                           fl_value_new_int(static_cast<int64_t>(pool.max_retained_bytes)));
+  fl_value_set_string_take(result, "bufferPool", pool_map);
+
+  // Only sessions holding sequence state, such as a key/value cache, are listed
+  FlValue *sessions = fl_value_new_list();
+  for (const auto &entry : self->session_manager->getSequenceStateBytes()) {
+    FlValue *session = fl_value_new_map();
+    fl_value_set_string_take(session, "sessionId", handle_to_fl_value(self, kSessionIdPrefix, entry.first));
+    fl_value_set_string_take(session, "sequenceStateBytes", fl_value_new_int(static_cast<int64_t>(entry.second)));
+    fl_value_append_take(sessions, session);
+  }
+  fl_value_set_string_take(result, "sessions", sessions);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *set_memory_limit(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *limit_value = fl_value_lookup_string(args, "hardLimitBytes");
+  if (limit_value == nullptr || fl_value_get_type(limit_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_int(limit_value) < 0) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "hardLimitBytes must be a non-negative integer", nullptr));
+  }
+
+  self->tensor_manager->setHardMemoryLimit(static_cast<uint64_t>(fl_value_get_int(limit_value)));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
+
+// Convert profile entries to a list of {name, opType, provider, totalMicros, calls} maps
+static FlValue *profile_entries_to_fl_value(const std::vector<ProfileEntry> &entries) {
+  FlValue *list = fl_value_new_list();
+  for (const auto &entry : entries) {
+    FlValue *map = fl_value_new_map();
+    fl_value_set_string_take(map, "name", fl_value_new_string(entry.name.c_str()));
+    fl_value_set_string_take(map, "opType", fl_value_new_string(entry.op_type.c_str()));
+    fl_value_set_string_take(map, "provider", fl_value_new_string(entry.provider.c_str()));
+    fl_value_set_string_take(map, "totalMicros", fl_value_new_int(static_cast<int64_t>(entry.total_micros)));
+    fl_value_set_string_take(map, "calls", fl_value_new_int(static_cast<int64_t>(entry.calls)));
+    fl_value_append_take(list, map);
+  }
+  return list;
+}
+
+static FlMethodResponse *end_profiling(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  try {
+    std::optional<std::string> profile_path = self->session_manager->endProfiling(session_id);
+    if (!profile_path) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+    }
+    if (profile_path->empty()) {
+      return FL_METHOD_RESPONSE(
+          fl_method_error_response_new("INVALID_ARG", "Profiling is not enabled for this session", nullptr));
+    }
+
+    ProfileSummary summary = summarizeProfileFile(*profile_path);
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "profilePath", fl_value_new_string(profile_path->c_str()));
+    fl_value_set_string_take(result, "totalMicros", fl_value_new_int(static_cast<int64_t>(summary.total_micros)));
+    fl_value_set_string_take(result, "nodes", profile_entries_to_fl_value(summary.nodes));
+    fl_value_set_string_take(result, "ops", profile_entries_to_fl_value(summary.ops));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const Ort::Exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("ORT_ERROR", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *start_tracing(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TraceRecorder::instance().start();
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
+
+static FlMethodResponse *stop_tracing(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TraceRecorder::instance().stop();
+
+  // Write to the given path, or to a new file in the user cache directory
+  std::string trace_path;
+  FlValue *path_value = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                            ? fl_value_lookup_string(args, "path")
+                            : nullptr;
+  if (path_value != nullptr && fl_value_get_type(path_value) == FL_VALUE_TYPE_STRING) {
+    trace_path = fl_value_get_string(path_value);
+  } else {
+    std::string trace_dir = std::string(g_get_user_cache_dir()) + "/flutter_onnxruntime/traces";
+    g_mkdir_with_parents(trace_dir.c_str(), 0700);
+    trace_path = trace_dir + "/plugin_trace_" + std::to_string(g_get_real_time() / 1000) + ".json";
+  }
+
+  std::ofstream trace_file(trace_path, std::ios::binary);
+  if (!trace_file) {
+    std::string error_message = "Failed to open trace file: " + trace_path;
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", error_message.c_str(), nullptr));
+  }
+  size_t spans = TraceRecorder::instance().writeChromeTrace(trace_file);
+  trace_file.close();
+  if (!trace_file) {
+    std::string error_message = "Failed to write trace file: " + trace_path;
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", error_message.c_str(), nullptr));
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "tracePath", fl_value_new_string(trace_path.c_str()));
+  fl_value_set_string_take(result, "spans", fl_value_new_int(static_cast<int64_t>(spans)));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *get_native_context(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  // The address that Dart passes back to the fort_* functions of native_api.h over dart:ffi
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "context",
+                           fl_value_new_int(static_cast<int64_t>(reinterpret_cast<intptr_t>(self->native_context))));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *close_session(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  // Get session ID
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    // Similar to closeSession, return success even if ID is invalid.
+    // Alternatively, return an error:
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+
+  // Requests still waiting for their batch are run now and fail once the session is gone
+  self->micro_batcher->remove(session_id);
+  self->session_manager->closeSession(session_id);
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+// Read the params of a glue op sent by Dart, which map to numbers or lists of integers, into a stage. Returns an
+// error response if a list holds anything else.
+static FlMethodResponse *parse_stage_params(FlValue *params_value, PipelineStage &stage) {
+  if (params_value != nullptr && fl_value_get_type(params_value) == FL_VALUE_TYPE_MAP) {
+    for (size_t i = 0; i < fl_value_get_length(params_value); i++) {
+      FlValue *key = fl_value_get_map_key(params_value, i);
+      FlValue *value = fl_value_get_map_value(params_value, i);
+      if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING) {
+        continue;
+      }
+      std::string param = fl_value_get_string(key);
+      switch (fl_value_get_type(value)) {
+      case FL_VALUE_TYPE_INT:
+        stage.scalars[param] = static_cast<double>(fl_value_get_int(value));
+        break;
+      case FL_VALUE_TYPE_FLOAT:
+        stage.scalars[param] = fl_value_get_float(value);
+        break;
+      case FL_VALUE_TYPE_INT64_LIST: {
+        const int64_t *elements = fl_value_get_int64_list(value);
+        stage.lists[param].assign(elements, elements + fl_value_get_length(value));
+        break;
+      }
+      case FL_VALUE_TYPE_LIST: {
+        std::vector<int64_t> &list = stage.lists[param];
+        for (size_t j = 0; j < fl_value_get_length(value); j++) {
+          FlValue *element = fl_value_get_list_value(value, j);
+          if (fl_value_get_type(element) != FL_VALUE_TYPE_INT) {
+            return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                "INVALID_ARG", ("List parameter " + param + " must hold integers").c_str(), nullptr));
+          }
+          list.push_back(fl_value_get_int(element));
+        }
+        break;
+      }
+      default:
+        break;
+      }
+    }
+  }
+  return nullptr;
+}
+
+// Read a stage of a pipeline description sent by Dart: {name, op, sessionId, inputs, params}, where params maps to
+// numbers or lists of integers. Returns an error response if it is malformed.
+static FlMethodResponse *parse_pipeline_stage(FlValue *stage_value, PipelineStage &stage) {
+  if (fl_value_get_type(stage_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Pipeline stages must be maps", nullptr));
+  }
+  FlValue *name_value = fl_value_lookup_string(stage_value, "name");
+  FlValue *op_value = fl_value_lookup_string(stage_value, "op");
+  if (name_value == nullptr || fl_value_get_type(name_value) != FL_VALUE_TYPE_STRING || op_value == nullptr ||
+      fl_value_get_type(op_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Pipeline stages need a name and an op", nullptr));
+  }
+  stage.name = fl_value_get_string(name_value);
+  stage.op = fl_value_get_string(op_value);
+  if (stage.op == "session" && !lookup_handle(stage_value, "sessionId", kSessionIdPrefix, &stage.session)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARG", ("Session stage " + stage.name + " needs a session ID").c_str(), nullptr));
+  }
+
+  FlValue *inputs_value = fl_value_lookup_string(stage_value, "inputs");
+  if (inputs_value != nullptr && fl_value_get_type(inputs_value) == FL_VALUE_TYPE_MAP) {
+    for (size_t i = 0; i < fl_value_get_length(inputs_value); i++) {
+      FlValue *key = fl_value_get_map_key(inputs_value, i);
+      FlValue *value = fl_value_get_map_value(inputs_value, i);
+      if (fl_value_get_type(key) == FL_VALUE_TYPE_STRING && fl_value_get_type(value) == FL_VALUE_TYPE_STRING) {
+        stage.inputs[fl_value_get_string(key)] = fl_value_get_string(value);
+      }
+    }
+  }
+
+  return parse_stage_params(fl_value_lookup_string(stage_value, "params"), stage);
+}
+
+static FlMethodResponse *create_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *stages_value = fl_value_lookup_string(args, "stages");
+  FlValue *outputs_value = fl_value_lookup_string(args, "outputs");
+  if (stages_value == nullptr || fl_value_get_type(stages_value) != FL_VALUE_TYPE_LIST || outputs_value == nullptr ||
+      fl_value_get_type(outputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Pipeline needs a list of stages and a map of outputs", nullptr));
+  }
+
+  PipelineDescription description;
+  for (size_t i = 0; i < fl_value_get_length(stages_value); i++) {
+    PipelineStage stage;
+    FlMethodResponse *error = parse_pipeline_stage(fl_value_get_list_value(stages_value, i), stage);
+    if (error != nullptr) {
+      return error;
+    }
+    description.stages.push_back(std::move(stage));
+  }
+  for (size_t i = 0; i < fl_value_get_length(outputs_value); i++) {
+    FlValue *key = fl_value_get_map_key(outputs_value, i);
+    FlValue *value = fl_value_get_map_value(outputs_value, i);
+    if (fl_value_get_type(key) == FL_VALUE_TYPE_STRING && fl_value_get_type(value) == FL_VALUE_TYPE_STRING) {
+      description.outputs[fl_value_get_string(key)] = fl_value_get_string(value);
+    }
+  }
+
+  try {
+    auto pipeline = std::make_shared<Pipeline>(std::move(description), *self->session_manager);
+    PipelineHandle pipeline_id = self->pipeline_manager->addPipeline(std::move(pipeline));
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "pipelineId", handle_to_fl_value(self, kPipelineIdPrefix, pipeline_id));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const std::invalid_argument &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *run_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs) {
+  PipelineHandle pipeline_id;
+  if (!lookup_handle(args, "pipelineId", kPipelineIdPrefix, &pipeline_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Pipeline ID must be provided", nullptr));
+  }
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  }
+
+  std::shared_ptr<Pipeline> pipeline = self->pipeline_manager->findPipeline(pipeline_id);
+  if (!pipeline) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_PIPELINE", "Pipeline not found", nullptr));
+  }
+
+  try {
+    std::map<std::string, const OrtValue *> named_inputs;
+    for (size_t i = 0; i < inputs.values[0].size(); i++) {
+      named_inputs[inputs.names[0][i]] = inputs.values[0][i];
+    }
+
+    Ort::RunOptions run_options;
+    apply_run_options(fl_value_lookup_string(args, "runOptions"), run_options);
+    // The run stops early if it is cancelled, times out or a high-priority run needs its worker
+    RunScope run_scope([&run_options] { run_options.SetTerminate(); });
+    std::vector<std::pair<std::string, Ort::Value>> outputs =
+        pipeline->run(*self->session_manager, named_inputs, &run_options);
+    check_tensor_outputs(outputs);
+
+    g_autoptr(FlValue) outputs_map = fl_value_new_map();
+    for (auto &[name, value] : outputs) {
+      TensorHandle value_id = self->tensor_manager->storeTensor(std::move(value));
+      fl_value_set_string_take(outputs_map, name.c_str(), output_info_to_fl_value(self, value_id));
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
+  } catch (const std::invalid_argument &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  } catch (const Ort::Exception &e) {
+    return inference_error_response(e);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *close_pipeline(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  PipelineHandle pipeline_id;
+  if (!lookup_handle(args, "pipelineId", kPipelineIdPrefix, &pipeline_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Pipeline ID must be provided", nullptr));
+  }
+  self->pipeline_manager->closePipeline(pipeline_id);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *run_tensor_op(FlutterOnnxruntimePlugin *self, FlValue *args, CallInputs &inputs) {
+  FlValue *op_value = fl_value_lookup_string(args, "op");
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (op_value == nullptr || fl_value_get_type(op_value) != FL_VALUE_TYPE_STRING || inputs_value == nullptr ||
+      fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Op needs a name and a map of inputs", nullptr));
+  }
+
+  PipelineStage stage;
+  stage.op = fl_value_get_string(op_value);
+  stage.name = stage.op;
+  FlMethodResponse *error = parse_stage_params(fl_value_lookup_string(args, "params"), stage);
+  if (error != nullptr) {
+    return error;
+  }
+
+  try {
+    std::map<std::string, const OrtValue *> named_inputs;
+    for (size_t i = 0; i < inputs.values[0].size(); i++) {
+      named_inputs[inputs.names[0][i]] = inputs.values[0][i];
+    }
+
+    std::vector<std::pair<std::string, Ort::Value>> outputs = runGlueOp(stage, named_inputs);
+    check_tensor_outputs(outputs);
+    g_autoptr(FlValue) outputs_map = fl_value_new_map();
+    for (auto &[name, value] : outputs) {
+      TensorHandle value_id = self->tensor_manager->storeTensor(std::move(value));
+      fl_value_set_string_take(outputs_map, name.c_str(), output_info_to_fl_value(self, value_id));
+    }
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(outputs_map));
+  } catch (const std::invalid_argument &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+static FlMethodResponse *open_stream(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
+  }
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  int64_t depth = 2;
+  FlValue *depth_value = fl_value_lookup_string(args, "depth");
+  if (depth_value != nullptr && fl_value_get_type(depth_value) == FL_VALUE_TYPE_INT) {
+    depth = fl_value_get_int(depth_value);
+  }
+  if (depth < 1) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Stream depth must be positive", nullptr));
+  }
+
+  try {
+    auto stream = std::make_shared<FrameStream>(session_id, static_cast<size_t>(depth), *self->session_manager,
+                                                *self->tensor_manager);
+    StreamHandle stream_id = self->stream_manager->addStream(std::move(stream));
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "streamId", handle_to_fl_value(self, kStreamIdPrefix, stream_id));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } catch (const std::invalid_argument &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("PLUGIN_ERROR", e.what(), nullptr));
+  }
+}
+
+// Send an event on the main thread, where the Flutter engine expects it
+static gboolean send_event_on_main_thread(gpointer user_data) {
+  PluginEvent *pending = static_cast<PluginEvent *>(user_data);
+
+  if (pending->channel != nullptr) {
+    fl_event_channel_send(pending->channel, pending->event, nullptr, nullptr);
+  }
+
+  fl_value_unref(pending->event);
+  g_object_unref(pending->self);
+  delete pending;
+  return G_SOURCE_REMOVE;
+}
+
+// Copy the inputs of a frame into a free slot of its stream on the main thread and run it on the inference workers.
+// The call returns as soon as the frame is queued; its outputs follow as an event of stream_channel.
+static FlMethodResponse *submit_stream_frame(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  StreamHandle stream_id;
+  if (!lookup_handle(args, "streamId", kStreamIdPrefix, &stream_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Stream ID must be provided", nullptr));
+  }
+  FlValue *inputs_value = fl_value_lookup_string(args, "inputs");
+  if (inputs_value == nullptr || fl_value_get_type(inputs_value) != FL_VALUE_TYPE_MAP) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Inputs must be a non-null map", nullptr));
+  }
+
+  std::shared_ptr<FrameStream> stream = self->stream_manager->findStream(stream_id);
+  if (!stream) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_STREAM", "Stream not found", nullptr));
+  }
+
+  std::optional<size_t> slot = stream->acquireSlot();
+  if (!slot) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("STREAM_FULL", "Every slot of the stream holds a frame in flight", nullptr));
+  }
+
+  auto run_options = std::make_shared<Ort::RunOptions>();
+  try {
+    for (const TensorInfo &input : stream->inputs()) {
+      FlValue *data_value = fl_value_lookup_string(inputs_value, input.name.c_str());
+      const void *data = nullptr;
+      size_t byte_size = 0;
+      if (data_value == nullptr || !get_typed_data(data_value, input.element_type, &data, &byte_size)) {
+        throw std::invalid_argument("Input " + input.name + " must be typed data of type " + input.type);
+      }
+      stream->writeInput(*slot, input.name, data, byte_size);
+    }
+    apply_run_options(fl_value_lookup_string(args, "runOptions"), *run_options);
+  } catch (const std::exception &e) {
+    stream->releaseSlot(*slot);
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  }
+  uint64_t frame = stream->numberFrame();
+
+  // Keep the plugin alive until the event has been sent
+  PluginEvent *pending =
+      new PluginEvent{FLUTTER_ONNXRUNTIME_PLUGIN(g_object_ref(self)), self->stream_channel, nullptr};
+  self->inference_executor->submit([pending, stream, slot = *slot, frame, stream_id, run_options]() {
+    FlutterOnnxruntimePlugin *self = pending->self;
+    FlValue *event = fl_value_new_map();
+    fl_value_set_string_take(event, "streamId", handle_to_fl_value(self, kStreamIdPrefix, stream_id));
+    fl_value_set_string_take(event, "frame", fl_value_new_int(static_cast<int64_t>(frame)));
+    try {
+      std::vector<TensorHandle> outputs = stream->run(slot, run_options.get());
+      g_autoptr(FlValue) outputs_map = fl_value_new_map();
+      for (size_t i = 0; i < outputs.size(); i++) {
+        fl_value_set_string_take(outputs_map, stream->outputs()[i].name.c_str(),
+                                 self->tensor_manager->getTensorData<FlValueCodec>(outputs[i]));
+      }
+      fl_value_set_string(event, "outputs", outputs_map);
+    } catch (const std::exception &e) {
+      fl_value_set_string_take(event, "error", fl_value_new_string(e.what()));
+    }
+    stream->releaseSlot(slot);
+    pending->event = event;
+    g_idle_add(send_event_on_main_thread, pending);
+  });
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "frame", fl_value_new_int(static_cast<int64_t>(frame)));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *close_stream(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  StreamHandle stream_id;
+  if (!lookup_handle(args, "streamId", kStreamIdPrefix, &stream_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Stream ID must be provided", nullptr));
+  }
+  self->stream_manager->closeStream(stream_id);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+// Read a list of token ids sent from Dart as an Int64List or a list of integers
+static bool read_tokens(FlValue *value, std::vector<int64_t> *tokens) {
+  if (value == nullptr) {
+    return false;
+  }
+  if (fl_value_get_type(value) == FL_VALUE_TYPE_INT64_LIST) {
+    const int64_t *elements = fl_value_get_int64_list(value);
+    tokens->assign(elements, elements + fl_value_get_length(value));
+    return true;
+  }
+  if (fl_value_get_type(value) != FL_VALUE_TYPE_LIST) {
+    return false;
+  }
+  for (size_t i = 0; i < fl_value_get_length(value); i++) {
+    FlValue *element = fl_value_get_list_value(value, i);
+    if (fl_value_get_type(element) != FL_VALUE_TYPE_INT) {
+      return false;
+    }
+    tokens->push_back(fl_value_get_int(element));
+  }
+  return true;
+}
+
+// Fill generation options from the options map sent by Dart, keeping the defaults of the keys it does not hold
+static void read_generation_options(FlValue *options_value, GenerationOptions &options) {
+  if (options_value == nullptr || fl_value_get_type(options_value) != FL_VALUE_TYPE_MAP) {
+    return;
+  }
+  auto lookup = [options_value](const char *key, FlValueType type) -> FlValue * {
+    FlValue *value = fl_value_lookup_string(options_value, key);
+    return value != nullptr && fl_value_get_type(value) == type ? value : nullptr;
+  };
+
+  if (FlValue *value = lookup("maxTokens", FL_VALUE_TYPE_INT)) {
+    options.max_tokens = static_cast<size_t>(std::max<int64_t>(fl_value_get_int(value), 0));
+  }
+  read_tokens(fl_value_lookup_string(options_value, "stopTokens"), &options.stop_tokens);
+  if (FlValue *value = lookup("temperature", FL_VALUE_TYPE_FLOAT)) {
+    options.sampling.temperature = static_cast<float>(fl_value_get_float(value));
+  }
+  if (FlValue *value = lookup("topK", FL_VALUE_TYPE_INT)) {
+    options.sampling.top_k = fl_value_get_int(value);
+  }
+  if (FlValue *value = lookup("topP", FL_VALUE_TYPE_FLOAT)) {
+    options.sampling.top_p = static_cast<float>(fl_value_get_float(value));
+  }
+  if (FlValue *value = lookup("seed", FL_VALUE_TYPE_INT)) {
+    options.seed = static_cast<uint64_t>(fl_value_get_int(value));
+  }
+  if (FlValue *value = lookup("inputIdsName", FL_VALUE_TYPE_STRING)) {
+    options.input_ids_name = fl_value_get_string(value);
+  }
+  if (FlValue *value = lookup("attentionMaskName", FL_VALUE_TYPE_STRING)) {
+    options.attention_mask_name = fl_value_get_string(value);
+  }
+  if (FlValue *value = lookup("positionIdsName", FL_VALUE_TYPE_STRING)) {
+    options.position_ids_name = fl_value_get_string(value);
+  }
+  if (FlValue *value = lookup("logitsName", FL_VALUE_TYPE_STRING)) {
+    options.logits_name = fl_value_get_string(value);
+  }
+}
+
+// Name of the reason a generation ended, as Dart reads it
+static const char *generation_end_name(GenerationEnd end) {
+  switch (end) {
+  case GenerationEnd::kStopToken:
+    return "stop";
+  case GenerationEnd::kMaxTokens:
+    return "length";
+  case GenerationEnd::kCancelled:
+    return "cancelled";
+  }
+  return "cancelled";
+}
+
+// Queue an event of a generation on the main thread
+static void send_generation_event(FlutterOnnxruntimePlugin *self, FlValue *event) {
+  PluginEvent *pending =
+      new PluginEvent{FLUTTER_ONNXRUNTIME_PLUGIN(g_object_ref(self)), self->generation_channel, event};
+  g_idle_add(send_event_on_main_thread, pending);
+}
+
+// Start a generation and respond with its ID at once. The decode loop runs on one inference worker and sends each
+// token as an event of generation_channel, followed by an event that is done, with the reason the loop ended, or
+// that holds an error.
+static FlMethodResponse *generate(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new("INVALID_ARG", "Session ID must be a non-null string", nullptr));
+  }
+  std::vector<int64_t> prompt;
+  if (!read_tokens(fl_value_lookup_string(args, "prompt"), &prompt)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Prompt must be a list of tokens", nullptr));
+  }
+  if (!self->session_manager->hasSession(session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
+  }
+
+  GenerationOptions options;
+  read_generation_options(fl_value_lookup_string(args, "options"), options);
+
+  std::shared_ptr<Generation> generation;
+  try {
+    generation = std::make_shared<Generation>(session_id, std::move(prompt), std::move(options),
+                                              *self->session_manager);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  }
+  GenerationHandle generation_id = self->generation_manager->addGeneration(generation);
+
+  g_object_ref(self);
+  self->inference_executor->submit([self, generation, generation_id]() {
+    auto new_event = [self, generation_id]() {
+      FlValue *event = fl_value_new_map();
+      fl_value_set_string_take(event, "generationId", handle_to_fl_value(self, kGenerationIdPrefix, generation_id));
+      return event;
+    };
+
+    FlValue *end_event = new_event();
+    try {
+      GenerationEnd end = generation->run([self, &new_event](int64_t token) {
+        FlValue *event = new_event();
+        fl_value_set_string_take(event, "token", fl_value_new_int(token));
+        send_generation_event(self, event);
+      });
+      fl_value_set_string_take(end_event, "done", fl_value_new_bool(true));
+      fl_value_set_string_take(end_event, "reason", fl_value_new_string(generation_end_name(end)));
+    } catch (const std::exception &e) {
+      fl_value_set_string_take(end_event, "error", fl_value_new_string(e.what()));
+    }
+    self->generation_manager->removeGeneration(generation_id);
+    send_generation_event(self, end_event);
+    g_object_unref(self);
+  });
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "generationId", handle_to_fl_value(self, kGenerationIdPrefix, generation_id));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *cancel_generation(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  GenerationHandle generation_id;
+  if (!lookup_handle(args, "generationId", kGenerationIdPrefix, &generation_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Generation ID must be provided", nullptr));
+  }
+  // A generation that already finished has nothing left to cancel
+  std::shared_ptr<Generation> generation = self->generation_manager->findGeneration(generation_id);
+  if (generation) {
+    generation->cancel();
+  }
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
+
+static FlMethodResponse *get_metadata(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
   }
 
-  const char *session_id = fl_value_get_string(session_id_value);
-
   if (!self->session_manager->hasSession(session_id)) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
   }
@@ -554,14 +2666,11 @@ static FlMethodResponse *get_metadata(FlutterOnnxruntimePlugin *self, FlValue *a
 }
 
 static FlMethodResponse *get_input_info(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
-
-  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
   }
 
-  const char *session_id = fl_value_get_string(session_id_value);
-
   if (!self->session_manager->hasSession(session_id)) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
   }
@@ -585,6 +2694,10 @@ static FlMethodResponse *get_input_info(FlutterOnnxruntimePlugin *self, FlValue
       // Add type
       fl_value_set_string_take(info_map, "type", fl_value_new_string(info.type.c_str()));
 
+      if (info.quantization) {
+        fl_value_set_string_take(info_map, "quantization", quantization_to_fl_value(*info.quantization));
+      }
+
       fl_value_append_take(result, info_map);
     }
     return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
@@ -596,14 +2709,11 @@ static FlMethodResponse *get_input_info(FlutterOnnxruntimePlugin *self, FlValue
 }
 
 static FlMethodResponse *get_output_info(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *session_id_value = fl_value_lookup_string(args, "sessionId");
-
-  if (session_id_value == nullptr || fl_value_get_type(session_id_value) != FL_VALUE_TYPE_STRING) {
+  SessionHandle session_id;
+  if (!lookup_handle(args, "sessionId", kSessionIdPrefix, &session_id)) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Invalid session ID", nullptr));
   }
 
-  const char *session_id = fl_value_get_string(session_id_value);
-
   if (!self->session_manager->hasSession(session_id)) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_SESSION", "Session not found", nullptr));
   }
@@ -627,6 +2737,10 @@ static FlMethodResponse *get_output_info(FlutterOnnxruntimePlugin *self, FlValue
       // Add type
       fl_value_set_string_take(info_map, "type", fl_value_new_string(info.type.c_str()));
 
+      if (info.quantization) {
+        fl_value_set_string_take(info_map, "quantization", quantization_to_fl_value(*info.quantization));
+      }
+
       fl_value_append_take(result, info_map);
     }
     return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
@@ -637,7 +2751,53 @@ static FlMethodResponse *get_output_info(FlutterOnnxruntimePlugin *self, FlValue
   }
 }
 
+// Point at the element bytes of typed data from Dart: a typed list matching the source type, or a Uint8List
+// holding the little-endian element bytes of any fixed-size type (e.g. float16). Returns false for other data.
+static bool get_typed_data(FlValue *data_value, ONNXTensorElementDataType source_type, const void **data,
+                           size_t *byte_size) {
+  switch (fl_value_get_type(data_value)) {
+  case FL_VALUE_TYPE_UINT8_LIST:
+    if (!elementTypeInfo(source_type).convertible) {
+      return false;
+    }
+    *data = fl_value_get_uint8_list(data_value);
+    *byte_size = fl_value_get_length(data_value);
+    return true;
+  case FL_VALUE_TYPE_INT32_LIST:
+    if (source_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32) {
+      return false;
+    }
+    *data = fl_value_get_int32_list(data_value);
+    *byte_size = fl_value_get_length(data_value) * sizeof(int32_t);
+    return true;
+  case FL_VALUE_TYPE_INT64_LIST:
+    if (source_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64) {
+      return false;
+    }
+    *data = fl_value_get_int64_list(data_value);
+    *byte_size = fl_value_get_length(data_value) * sizeof(int64_t);
+    return true;
+  case FL_VALUE_TYPE_FLOAT32_LIST:
+    if (source_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+      return false;
+    }
+    *data = fl_value_get_float32_list(data_value);
+    *byte_size = fl_value_get_length(data_value) * sizeof(float);
+    return true;
+  case FL_VALUE_TYPE_FLOAT_LIST:
+    if (source_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE) {
+      return false;
+    }
+    *data = fl_value_get_float_list(data_value);
+    *byte_size = fl_value_get_length(data_value) * sizeof(double);
+    return true;
+  default:
+    return false;
+  }
+}
+
 static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TraceScope trace("createOrtValue");
   FlValue *source_type_value = fl_value_lookup_string(args, "sourceType");
   FlValue *data_value = fl_value_lookup_string(args, "data");
   FlValue *shape_value = fl_value_lookup_string(args, "shape");
@@ -650,6 +2810,12 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
   }
 
   const char *source_type = fl_value_get_string(source_type_value);
+  ONNXTensorElementDataType element_type;
+  if (!parseElementType(source_type, &element_type)) {
+    std::string error_message = "Unsupported source data type: ";
+    error_message += source_type;
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("UNSUPPORTED_TYPE", error_message.c_str(), nullptr));
+  }
 
   // Convert shape values to vector of int64_t
   size_t shape_size = fl_value_get_length(shape_value);
@@ -662,19 +2828,19 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
     shape.push_back(fl_value_get_int(dim));
   }
 
-  std::string valueId;
+  TensorHandle valueId = kInvalidHandle;
 
   try {
-    // Handle data according to source type
-    if (strcmp(source_type, "float32") == 0) {
+    const void *typed_data = nullptr;
+    size_t typed_data_size = 0;
+    if (get_typed_data(data_value, element_type, &typed_data, &typed_data_size)) {
+      // Typed data is copied once, straight into the tensor's pooled buffer
+      valueId = self->tensor_manager->createTensorFromBytes(element_type, typed_data, typed_data_size, shape);
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
       std::vector<float> data_vec;
 
       // Convert data to vector of floats
-      if (fl_value_get_type(data_value) == FL_VALUE_TYPE_FLOAT32_LIST) {
-        size_t data_size = fl_value_get_length(data_value);
-        const float *float_array = fl_value_get_float32_list(data_value);
-        data_vec.assign(float_array, float_array + data_size);
-      } else if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) { // regular float list array
+      if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) { // regular float list array
         size_t length = fl_value_get_length(data_value);
         data_vec.reserve(length);
         for (size_t i = 0; i < length; i++) {
@@ -690,14 +2856,31 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for float32 type", nullptr));
       }
-      valueId = self->tensor_manager->createFloat32Tensor(data_vec, shape);
-    } else if (strcmp(source_type, "int32") == 0) {
+      valueId = self->tensor_manager->createTensor(data_vec, shape);
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE) {
+      if (fl_value_get_type(data_value) != FL_VALUE_TYPE_LIST) {
+        return FL_METHOD_RESPONSE(
+            fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for float64 type", nullptr));
+      }
+      size_t length = fl_value_get_length(data_value);
+      std::vector<double> data_vec;
+      data_vec.reserve(length);
+      for (size_t i = 0; i < length; i++) {
+        FlValue *val = fl_value_get_list_value(data_value, i);
+        if (fl_value_get_type(val) == FL_VALUE_TYPE_FLOAT) {
+          data_vec.push_back(fl_value_get_float(val));
+        } else if (fl_value_get_type(val) == FL_VALUE_TYPE_INT) {
+          data_vec.push_back(static_cast<double>(fl_value_get_int(val)));
+        } else {
+          return FL_METHOD_RESPONSE(
+              fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for float64 type", nullptr));
+        }
+      }
+      valueId = self->tensor_manager->createTensorFromBytes(element_type, data_vec.data(),
+                                                            data_vec.size() * sizeof(double), shape);
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32) {
       std::vector<int32_t> data_vec;
-      if (fl_value_get_type(data_value) == FL_VALUE_TYPE_INT32_LIST) {
-        size_t data_size = fl_value_get_length(data_value);
-        const int32_t *int_array = fl_value_get_int32_list(data_value);
-        data_vec.assign(int_array, int_array + data_size);
-      } else if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) {
+      if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) {
         size_t length = fl_value_get_length(data_value);
         data_vec.reserve(length);
         for (size_t i = 0; i < length; i++) {
@@ -712,14 +2895,10 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for int32 type", nullptr));
       }
-      valueId = self->tensor_manager->createInt32Tensor(data_vec, shape);
-    } else if (strcmp(source_type, "int64") == 0) {
+      valueId = self->tensor_manager->createTensor(data_vec, shape);
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64) {
       std::vector<int64_t> data_vec;
-      if (fl_value_get_type(data_value) == FL_VALUE_TYPE_INT64_LIST) {
-        size_t data_size = fl_value_get_length(data_value);
-        const int64_t *int_array = fl_value_get_int64_list(data_value);
-        data_vec.assign(int_array, int_array + data_size);
-      } else if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) {
+      if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) {
         size_t length = fl_value_get_length(data_value);
         data_vec.reserve(length);
         for (size_t i = 0; i < length; i++) {
@@ -734,14 +2913,10 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for int64 type", nullptr));
       }
-      valueId = self->tensor_manager->createInt64Tensor(data_vec, shape);
-    } else if (strcmp(source_type, "uint8") == 0) {
+      valueId = self->tensor_manager->createTensor(data_vec, shape);
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8) {
       std::vector<uint8_t> data_vec;
-      if (fl_value_get_type(data_value) == FL_VALUE_TYPE_UINT8_LIST) {
-        size_t data_size = fl_value_get_length(data_value);
-        const uint8_t *uint_array = fl_value_get_uint8_list(data_value);
-        data_vec.assign(uint_array, uint_array + data_size);
-      } else if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) { // regular int list array
+      if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) { // regular int list array
         size_t length = fl_value_get_length(data_value);
         data_vec.reserve(length);
         for (size_t i = 0; i < length; i++) {
@@ -756,8 +2931,8 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of numbers for int8 type", nullptr));
       }
-      valueId = self->tensor_manager->createUint8Tensor(data_vec, shape);
-    } else if (strcmp(source_type, "bool") == 0) {
+      valueId = self->tensor_manager->createTensor(data_vec, shape);
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL) {
       std::vector<bool> data_vec;
       if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) {
         size_t length = fl_value_get_length(data_value);
@@ -774,8 +2949,8 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
         return FL_METHOD_RESPONSE(
             fl_method_error_response_new("INVALID_DATA", "Data must be a list of booleans for bool type", nullptr));
       }
-      valueId = self->tensor_manager->createBoolTensor(data_vec, shape);
-    } else if (strcmp(source_type, "string") == 0) {
+      valueId = self->tensor_manager->createTensor(data_vec, shape);
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
       std::vector<std::string> data_vec;
       if (fl_value_get_type(data_value) == FL_VALUE_TYPE_LIST) {
         size_t length = fl_value_get_length(data_value);
@@ -803,7 +2978,7 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
   }
 
   g_autoptr(FlValue) result = fl_value_new_map();
-  fl_value_set_string_take(result, "valueId", fl_value_new_string(valueId.c_str()));
+  fl_value_set_string_take(result, "valueId", handle_to_fl_value(self, kTensorIdPrefix, valueId));
   fl_value_set_string_take(result, "dataType", fl_value_new_string(source_type));
 
   // Add shape to response
@@ -815,26 +2990,144 @@ static FlMethodResponse *create_ort_value(FlutterOnnxruntimePlugin *self, FlValu
   return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
+// Read an optional integer argument; returns false if it is present with another type
+static bool lookup_optional_int(FlValue *map, const char *key, int *value) {
+  FlValue *entry = fl_value_lookup_string(map, key);
+  if (entry == nullptr || fl_value_get_type(entry) == FL_VALUE_TYPE_NULL) {
+    return true;
+  }
+  if (fl_value_get_type(entry) != FL_VALUE_TYPE_INT) {
+    return false;
+  }
+  *value = static_cast<int>(fl_value_get_int(entry));
+  return true;
+}
+
+// Read an optional list of three per-channel numbers; returns false if it is present with another shape
+static bool lookup_channel_values(FlValue *map, const char *key, float *values) {
+  FlValue *entry = fl_value_lookup_string(map, key);
+  if (entry == nullptr || fl_value_get_type(entry) == FL_VALUE_TYPE_NULL) {
+    return true;
+  }
+  if ((fl_value_get_type(entry) != FL_VALUE_TYPE_LIST && fl_value_get_type(entry) != FL_VALUE_TYPE_FLOAT_LIST) ||
+      fl_value_get_length(entry) != 3) {
+    return false;
+  }
+  if (fl_value_get_type(entry) == FL_VALUE_TYPE_FLOAT_LIST) {
+    const double *list = fl_value_get_float_list(entry);
+    for (int c = 0; c < 3; c++) {
+      values[c] = static_cast<float>(list[c]);
+    }
+    return true;
+  }
+  for (int c = 0; c < 3; c++) {
+    FlValue *value = fl_value_get_list_value(entry, c);
+    if (fl_value_get_type(value) == FL_VALUE_TYPE_FLOAT) {
+      values[c] = static_cast<float>(fl_value_get_float(value));
+    } else if (fl_value_get_type(value) == FL_VALUE_TYPE_INT) {
+      values[c] = static_cast<float>(fl_value_get_int(value));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+static FlMethodResponse *create_image_tensor(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *data_value = fl_value_lookup_string(args, "data");
+  FlValue *format_value = fl_value_lookup_string(args, "format");
+  FlValue *width_value = fl_value_lookup_string(args, "width");
+  FlValue *height_value = fl_value_lookup_string(args, "height");
+  FlValue *layout_value = fl_value_lookup_string(args, "layout");
+  FlValue *data_type_value = fl_value_lookup_string(args, "dataType");
+
+  // Check if all required arguments are provided
+  if (data_value == nullptr || format_value == nullptr || width_value == nullptr || height_value == nullptr ||
+      layout_value == nullptr || data_type_value == nullptr ||
+      fl_value_get_type(data_value) != FL_VALUE_TYPE_UINT8_LIST ||
+      fl_value_get_type(format_value) != FL_VALUE_TYPE_STRING || fl_value_get_type(width_value) != FL_VALUE_TYPE_INT ||
+      fl_value_get_type(height_value) != FL_VALUE_TYPE_INT || fl_value_get_type(layout_value) != FL_VALUE_TYPE_STRING ||
+      fl_value_get_type(data_type_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Missing required arguments", nullptr));
+  }
+
+  ImageTensorOptions options;
+  options.width = static_cast<int>(fl_value_get_int(width_value));
+  options.height = static_cast<int>(fl_value_get_int(height_value));
+  if (!lookup_optional_int(args, "targetWidth", &options.target_width) ||
+      !lookup_optional_int(args, "targetHeight", &options.target_height) ||
+      !lookup_channel_values(args, "mean", options.mean) || !lookup_channel_values(args, "std", options.std)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARG", "Target sizes must be integers and mean/std lists of three numbers", nullptr));
+  }
+
+  const char *format = fl_value_get_string(format_value);
+  const char *layout = fl_value_get_string(layout_value);
+  const char *data_type = fl_value_get_string(data_type_value);
+  if (!parseImageFormat(format, &options.format)) {
+    std::string error_message = std::string("Unsupported image format: ") + format;
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("UNSUPPORTED_TYPE", error_message.c_str(), nullptr));
+  }
+  if (strcmp(layout, "nchw") != 0 && strcmp(layout, "nhwc") != 0) {
+    std::string error_message = std::string("Unsupported tensor layout: ") + layout;
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", error_message.c_str(), nullptr));
+  }
+  ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  parseElementType(data_type, &element_type);
+  if (element_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT && element_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+    std::string error_message = std::string("Image tensors must be float32 or float16, got ") + data_type;
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("UNSUPPORTED_TYPE", error_message.c_str(), nullptr));
+  }
+  options.channels_first = strcmp(layout, "nchw") == 0;
+  options.half_precision = element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+
+  TensorHandle value_id = kInvalidHandle;
+  try {
+    value_id = self->tensor_manager->createImageTensor(options, fl_value_get_uint8_list(data_value),
+                                                       fl_value_get_length(data_value));
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("TENSOR_CREATION_ERROR", e.what(), nullptr));
+  }
+
+  std::vector<int64_t> shape = self->tensor_manager->getTensorShape(value_id);
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "valueId", handle_to_fl_value(self, kTensorIdPrefix, value_id));
+  fl_value_set_string_take(result, "dataType", fl_value_new_string(data_type));
+
+  // Add shape to response
+  FlValue *shape_list = fl_value_new_list();
+  for (const auto &dim : shape) {
+    fl_value_append_take(shape_list, fl_value_new_int(dim));
+  }
+  fl_value_set_string_take(result, "shape", shape_list);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
 static FlMethodResponse *convert_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *value_id_value = fl_value_lookup_string(args, "valueId");
+  TensorHandle value_id;
   FlValue *target_type_value = fl_value_lookup_string(args, "targetType");
 
   // Check if required arguments are provided
-  if (value_id_value == nullptr || target_type_value == nullptr ||
-      fl_value_get_type(value_id_value) != FL_VALUE_TYPE_STRING ||
+  if (!lookup_handle(args, "valueId", kTensorIdPrefix, &value_id) || target_type_value == nullptr ||
       fl_value_get_type(target_type_value) != FL_VALUE_TYPE_STRING) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Missing required arguments", nullptr));
   }
 
-  // Get valueId and targetType
-  const char *value_id = fl_value_get_string(value_id_value);
+  // Get targetType
   const char *target_type = fl_value_get_string(target_type_value);
 
-  std::string new_tensor_id;
+  ONNXTensorElementDataType target_element_type;
+  if (!parseElementType(target_type, &target_element_type)) {
+    std::string error_message = std::string("Unsupported type: ") + target_type;
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("CONVERSION_ERROR", error_message.c_str(), nullptr));
+  }
+
+  TensorHandle new_tensor_id = kInvalidHandle;
   try {
     std::lock_guard<std::mutex> lock(self->mutex);
 
-    new_tensor_id = self->tensor_manager->convertTensor(value_id, target_type);
+    new_tensor_id = self->tensor_manager->convertTensor(value_id, target_element_type);
   } catch (const std::exception &e) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("CONVERSION_ERROR", e.what(), nullptr));
   }
@@ -842,7 +3135,7 @@ static FlMethodResponse *convert_ort_value(FlutterOnnxruntimePlugin *self, FlVal
   std::vector<int64_t> shape = self->tensor_manager->getTensorShape(new_tensor_id);
 
   g_autoptr(FlValue) result = fl_value_new_map();
-  fl_value_set_string_take(result, "valueId", fl_value_new_string(new_tensor_id.c_str()));
+  fl_value_set_string_take(result, "valueId", handle_to_fl_value(self, kTensorIdPrefix, new_tensor_id));
   fl_value_set_string_take(result, "dataType", fl_value_new_string(target_type)); // Use target type
 
   // Add shape
@@ -855,18 +3148,250 @@ static FlMethodResponse *convert_ort_value(FlutterOnnxruntimePlugin *self, FlVal
   return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
-static FlMethodResponse *get_ort_value_data(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *value_id_value = fl_value_lookup_string(args, "valueId");
+static bool read_quantization_params(FlValue *args, QuantizationParams *params) {
+  FlValue *scales_value = fl_value_lookup_string(args, "scales");
+  if (scales_value == nullptr) {
+    return false;
+  }
+  if (fl_value_get_type(scales_value) == FL_VALUE_TYPE_FLOAT_LIST) {
+    const double *scales = fl_value_get_float_list(scales_value);
+    for (size_t i = 0; i < fl_value_get_length(scales_value); i++) {
+      params->scales.push_back(static_cast<float>(scales[i]));
+    }
+  } else if (fl_value_get_type(scales_value) == FL_VALUE_TYPE_LIST) {
+    for (size_t i = 0; i < fl_value_get_length(scales_value); i++) {
+      FlValue *scale = fl_value_get_list_value(scales_value, i);
+      if (fl_value_get_type(scale) == FL_VALUE_TYPE_FLOAT) {
+        params->scales.push_back(static_cast<float>(fl_value_get_float(scale)));
+      } else if (fl_value_get_type(scale) == FL_VALUE_TYPE_INT) {
+        params->scales.push_back(static_cast<float>(fl_value_get_int(scale)));
+      } else {
+        return false;
+      }
+    }
+  } else {
+    return false;
+  }
 
-  if (value_id_value == nullptr || fl_value_get_type(value_id_value) != FL_VALUE_TYPE_STRING) {
-    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Invalid value ID", nullptr));
+  std::vector<int64_t> zero_points;
+  FlValue *zero_points_value = fl_value_lookup_string(args, "zeroPoints");
+  if (zero_points_value != nullptr && fl_value_get_type(zero_points_value) != FL_VALUE_TYPE_NULL &&
+      !read_tokens(zero_points_value, &zero_points)) {
+    return false;
+  }
+  for (int64_t zero_point : zero_points) {
+    // Values out of range of the quantized type stay out of range, and are rejected by the kernels
+    params->zero_points.push_back(static_cast<int32_t>(std::clamp<int64_t>(zero_point, INT32_MIN, INT32_MAX)));
+  }
+
+  int axis = 1;
+  if (!lookup_optional_int(args, "axis", &axis)) {
+    return false;
+  }
+  params->axis = axis;
+  return true;
+}
+
+static FlValue *quantization_to_fl_value(const QuantizationParams &params) {
+  FlValue *map = fl_value_new_map();
+  FlValue *scales = fl_value_new_list();
+  for (float scale : params.scales) {
+    fl_value_append_take(scales, fl_value_new_float(scale));
+  }
+  fl_value_set_string_take(map, "scales", scales);
+  FlValue *zero_points = fl_value_new_list();
+  for (size_t i = 0; i < params.scales.size(); i++) {
+    fl_value_append_take(zero_points, fl_value_new_int(params.zero_points.empty() ? 0 : params.zero_points[i]));
+  }
+  fl_value_set_string_take(map, "zeroPoints", zero_points);
+  fl_value_set_string_take(map, "axis", fl_value_new_int(params.axis));
+  fl_value_set_string_take(map, "dataType", fl_value_new_string(elementTypeInfo(params.element_type).name));
+  return map;
+}
+
+static FlMethodResponse *quantize_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TensorHandle value_id;
+  QuantizationParams params;
+  FlValue *data_type_value = fl_value_lookup_string(args, "dataType");
+  if (!lookup_handle(args, "valueId", kTensorIdPrefix, &value_id) || !read_quantization_params(args, &params) ||
+      data_type_value == nullptr || fl_value_get_type(data_type_value) != FL_VALUE_TYPE_STRING) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Missing required arguments", nullptr));
+  }
+  const char *data_type = fl_value_get_string(data_type_value);
+  if (!parseElementType(data_type, &params.element_type)) {
+    std::string error_message = std::string("Unsupported type: ") + data_type;
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("CONVERSION_ERROR", error_message.c_str(), nullptr));
+  }
+
+  TensorHandle new_tensor_id = kInvalidHandle;
+  try {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    new_tensor_id = self->tensor_manager->quantizeTensor(value_id, params);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("CONVERSION_ERROR", e.what(), nullptr));
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "valueId", handle_to_fl_value(self, kTensorIdPrefix, new_tensor_id));
+  fl_value_set_string_take(result, "dataType", fl_value_new_string(data_type));
+  FlValue *shape_list = fl_value_new_list();
+  for (const auto &dim : self->tensor_manager->getTensorShape(new_tensor_id)) {
+    fl_value_append_take(shape_list, fl_value_new_int(dim));
+  }
+  fl_value_set_string_take(result, "shape", shape_list);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *dequantize_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TensorHandle value_id;
+  QuantizationParams params;
+  if (!lookup_handle(args, "valueId", kTensorIdPrefix, &value_id) || !read_quantization_params(args, &params)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Missing required arguments", nullptr));
+  }
+
+  TensorHandle new_tensor_id = kInvalidHandle;
+  try {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    new_tensor_id = self->tensor_manager->dequantizeTensor(value_id, params);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("CONVERSION_ERROR", e.what(), nullptr));
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "valueId", handle_to_fl_value(self, kTensorIdPrefix, new_tensor_id));
+  fl_value_set_string_take(result, "dataType", fl_value_new_string("float32"));
+  FlValue *shape_list = fl_value_new_list();
+  for (const auto &dim : self->tensor_manager->getTensorShape(new_tensor_id)) {
+    fl_value_append_take(shape_list, fl_value_new_int(dim));
+  }
+  fl_value_set_string_take(result, "shape", shape_list);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse *new_ort_value_response(FlutterOnnxruntimePlugin *self, TensorHandle value_id) {
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "valueId", handle_to_fl_value(self, kTensorIdPrefix, value_id));
+  fl_value_set_string_take(result, "dataType",
+                           fl_value_new_string(self->tensor_manager->getTensorType(value_id).c_str()));
+  FlValue *shape_list = fl_value_new_list();
+  for (const auto &dim : self->tensor_manager->getTensorShape(value_id)) {
+    fl_value_append_take(shape_list, fl_value_new_int(dim));
+  }
+  fl_value_set_string_take(result, "shape", shape_list);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Read a required integer argument
+static bool lookup_int64(FlValue *map, const char *key, int64_t *value) {
+  FlValue *entry = fl_value_lookup_string(map, key);
+  if (entry == nullptr || fl_value_get_type(entry) != FL_VALUE_TYPE_INT) {
+    return false;
+  }
+  *value = fl_value_get_int(entry);
+  return true;
+}
+
+static FlMethodResponse *reshape_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TensorHandle value_id;
+  std::vector<int64_t> shape;
+  if (!lookup_handle(args, "valueId", kTensorIdPrefix, &value_id) ||
+      !read_tokens(fl_value_lookup_string(args, "shape"), &shape)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Missing required arguments", nullptr));
+  }
+
+  TensorHandle new_tensor_id = kInvalidHandle;
+  try {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    new_tensor_id = self->tensor_manager->reshapeTensor(value_id, shape);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  }
+  return new_ort_value_response(self, new_tensor_id);
+}
+
+static FlMethodResponse *slice_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TensorHandle value_id;
+  int64_t axis = 0;
+  int64_t start = 0;
+  int64_t end = 0;
+  if (!lookup_handle(args, "valueId", kTensorIdPrefix, &value_id) || !lookup_int64(args, "axis", &axis) ||
+      !lookup_int64(args, "start", &start)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Missing required arguments", nullptr));
+  }
+  // Without an end, take the single index start and drop the axis
+  FlValue *end_value = fl_value_lookup_string(args, "end");
+  bool take_index = end_value == nullptr || fl_value_get_type(end_value) == FL_VALUE_TYPE_NULL;
+  if (!take_index && !lookup_int64(args, "end", &end)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "End must be an integer", nullptr));
+  }
+
+  TensorHandle new_tensor_id = kInvalidHandle;
+  try {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    new_tensor_id = take_index ? self->tensor_manager->selectTensor(value_id, axis, start)
+                               : self->tensor_manager->sliceTensor(value_id, axis, start, end);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  }
+  return new_ort_value_response(self, new_tensor_id);
+}
+
+static FlMethodResponse *transpose_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TensorHandle value_id;
+  std::vector<int64_t> perm;
+  FlValue *perm_value = fl_value_lookup_string(args, "perm");
+  if (!lookup_handle(args, "valueId", kTensorIdPrefix, &value_id) ||
+      (perm_value != nullptr && fl_value_get_type(perm_value) != FL_VALUE_TYPE_NULL &&
+       !read_tokens(perm_value, &perm))) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Missing required arguments", nullptr));
+  }
+
+  TensorHandle new_tensor_id = kInvalidHandle;
+  try {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    new_tensor_id = self->tensor_manager->transposeTensor(value_id, perm);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
+  }
+  return new_ort_value_response(self, new_tensor_id);
+}
+
+static FlMethodResponse *concat_ort_values(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *value_ids_value = fl_value_lookup_string(args, "valueIds");
+  int64_t axis = 0;
+  if (value_ids_value == nullptr || fl_value_get_type(value_ids_value) != FL_VALUE_TYPE_LIST ||
+      !lookup_int64(args, "axis", &axis)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Missing required arguments", nullptr));
+  }
+  std::vector<TensorHandle> value_ids;
+  for (size_t i = 0; i < fl_value_get_length(value_ids_value); i++) {
+    TensorHandle value_id;
+    if (!value_to_handle(fl_value_get_list_value(value_ids_value, i), kTensorIdPrefix, &value_id)) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Invalid value ID", nullptr));
+    }
+    value_ids.push_back(value_id);
+  }
+
+  TensorHandle new_tensor_id = kInvalidHandle;
+  try {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    new_tensor_id = self->tensor_manager->concatTensors(value_ids, axis);
+  } catch (const std::exception &e) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", e.what(), nullptr));
   }
+  return new_ort_value_response(self, new_tensor_id);
+}
 
-  const char *value_id = fl_value_get_string(value_id_value);
+static FlMethodResponse *get_ort_value_data(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  TraceScope trace("getOrtValueData");
+  TensorHandle value_id;
+  if (!lookup_handle(args, "valueId", kTensorIdPrefix, &value_id)) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Invalid value ID", nullptr));
+  }
 
   FlValue *tensor_data = nullptr;
   try {
-    tensor_data = self->tensor_manager->getTensorData(value_id);
+    tensor_data = self->tensor_manager->getTensorData<FlValueCodec>(value_id);
 
     // If tensor_data is null, it means tensor wasn't found or is invalid
     if (tensor_data == nullptr || fl_value_get_type(tensor_data) == FL_VALUE_TYPE_NULL) {
@@ -886,15 +3411,33 @@ static FlMethodResponse *get_ort_value_data(FlutterOnnxruntimePlugin *self, FlVa
 }
 
 static FlMethodResponse *release_ort_value(FlutterOnnxruntimePlugin *self, FlValue *args) {
-  FlValue *value_id_value = fl_value_lookup_string(args, "valueId");
-
-  if (value_id_value == nullptr || fl_value_get_type(value_id_value) != FL_VALUE_TYPE_STRING) {
+  TensorHandle value_id;
+  if (!lookup_handle(args, "valueId", kTensorIdPrefix, &value_id)) {
     return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Invalid value ID", nullptr));
   }
 
-  const char *value_id = fl_value_get_string(value_id_value);
-
   self->tensor_manager->releaseTensor(value_id);
 
   return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
 }
+
+static FlMethodResponse *release_ort_values(FlutterOnnxruntimePlugin *self, FlValue *args) {
+  FlValue *value_ids_value = fl_value_lookup_string(args, "valueIds");
+  if (value_ids_value == nullptr || fl_value_get_type(value_ids_value) != FL_VALUE_TYPE_LIST) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Value IDs must be a list", nullptr));
+  }
+
+  std::vector<TensorHandle> value_ids;
+  for (size_t i = 0; i < fl_value_get_length(value_ids_value); i++) {
+    TensorHandle value_id;
+    if (!value_to_handle(fl_value_get_list_value(value_ids_value, i), kTensorIdPrefix, &value_id)) {
+      return FL_METHOD_RESPONSE(fl_method_error_response_new("INVALID_ARG", "Invalid value ID", nullptr));
+    }
+    value_ids.push_back(value_id);
+  }
+
+  // One lock for the whole list; unknown IDs are skipped like in release_ort_value
+  self->tensor_manager->releaseTensors(value_ids);
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(fl_value_new_null()));
+}
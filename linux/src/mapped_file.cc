@@ -0,0 +1,51 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "core/mapped_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace flutter_onnxruntime {
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open " + path.string() + ": " + std::strerror(errno));
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    close(fd);
+    throw std::runtime_error("Failed to map " + path.string() + ": the file is empty or cannot be read");
+  }
+  size_ = static_cast<size_t>(file_stat.st_size);
+
+  // The mapping stays valid after the descriptor is closed
+  void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  int map_error = errno;
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("Failed to map " + path.string() + ": " + std::strerror(map_error));
+  }
+  data_ = data;
+
+  // The model is parsed front to back right away
+  madvise(data_, size_, MADV_SEQUENTIAL | MADV_WILLNEED);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+} // namespace flutter_onnxruntime
@@ -93,4 +93,73 @@ std::map<std::string, FlValue *> fl_value_to_map(FlValue *map_value) {
   }
 
   return result;
-}
\ No newline at end of file
+}
+
+// Implementation of fl_value_to_canonical_string
+std::string fl_value_to_canonical_string(FlValue *value) {
+  if (value == nullptr) {
+    return "null";
+  }
+
+  switch (fl_value_get_type(value)) {
+  case FL_VALUE_TYPE_NULL:
+    return "null";
+  case FL_VALUE_TYPE_BOOL:
+    return fl_value_get_bool(value) ? "true" : "false";
+  case FL_VALUE_TYPE_INT:
+    return std::to_string(fl_value_get_int(value));
+  case FL_VALUE_TYPE_FLOAT:
+    return std::to_string(fl_value_get_float(value));
+  case FL_VALUE_TYPE_STRING:
+    return fl_value_get_string(value);
+  case FL_VALUE_TYPE_LIST: {
+    std::string result = "[";
+    size_t size = fl_value_get_length(value);
+    for (size_t i = 0; i < size; i++) {
+      result += fl_value_to_canonical_string(fl_value_get_list_value(value, i)) + ",";
+    }
+    return result + "]";
+  }
+  case FL_VALUE_TYPE_MAP: {
+    std::string result = "{";
+    for (const auto &entry : fl_value_to_map(value)) {
+      result += entry.first + ":" + fl_value_to_canonical_string(entry.second) + ",";
+    }
+    return result + "}";
+  }
+  default: {
+    // Typed lists do not occur in options; fall back to the generic representation
+    g_autofree gchar *text = fl_value_to_string(value);
+    return text;
+  }
+  }
+}
+
+FlValue *FlValueCodec::null() { return fl_value_new_null(); }
+
+FlValue *FlValueCodec::list(const float *data, size_t count) { return fl_value_new_float32_list(data, count); }
+
+FlValue *FlValueCodec::list(const double *data, size_t count) { return fl_value_new_float_list(data, count); }
+
+FlValue *FlValueCodec::list(const int32_t *data, size_t count) { return fl_value_new_int32_list(data, count); }
+
+FlValue *FlValueCodec::list(const int64_t *data, size_t count) { return fl_value_new_int64_list(data, count); }
+
+FlValue *FlValueCodec::list(const uint8_t *data, size_t count) { return fl_value_new_uint8_list(data, count); }
+
+FlValue *FlValueCodec::list(const std::vector<bool> &data) { return vector_to_fl_value(data); }
+
+FlValue *FlValueCodec::list(const std::vector<std::string> &data) { return vector_to_fl_value(data); }
+
+FlValue *FlValueCodec::tensor(const std::vector<int64_t> &shape, const std::string &data_type, FlValue *data) {
+  FlValue *shape_list = fl_value_new_list();
+  for (int64_t dim : shape) {
+    fl_value_append_take(shape_list, fl_value_new_int(dim));
+  }
+
+  FlValue *result = fl_value_new_map();
+  fl_value_set_string_take(result, "shape", shape_list);
+  fl_value_set_string_take(result, "dataType", fl_value_new_string(data_type.c_str()));
+  fl_value_set_string_take(result, "data", data);
+  return result;
+}
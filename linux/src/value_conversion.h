@@ -7,6 +7,8 @@
 #ifndef VALUE_CONVERSION_H
 #define VALUE_CONVERSION_H
 
+#include <cstddef>
+#include <cstdint>
 #include <flutter_linux/flutter_linux.h>
 #include <map>
 #include <string>
@@ -39,4 +41,22 @@ template <> FlValue *vector_to_fl_value<bool>(const std::vector<bool> &vec);
 // Convert a FlValue map to a C++ map
 std::map<std::string, FlValue *> fl_value_to_map(FlValue *map_value);
 
+// Serialize a FlValue with map entries sorted by key, so that equal values give equal strings
+std::string fl_value_to_canonical_string(FlValue *value);
+
+// Codec that encodes tensor data as FlValue for core/tensor_codec.h; every value returned is owned by the caller
+struct FlValueCodec {
+  using Value = FlValue *;
+
+  static FlValue *null();
+  static FlValue *list(const float *data, size_t count);
+  static FlValue *list(const double *data, size_t count);
+  static FlValue *list(const int32_t *data, size_t count);
+  static FlValue *list(const int64_t *data, size_t count);
+  static FlValue *list(const uint8_t *data, size_t count);
+  static FlValue *list(const std::vector<bool> &data);
+  static FlValue *list(const std::vector<std::string> &data);
+  static FlValue *tensor(const std::vector<int64_t> &shape, const std::string &data_type, FlValue *data);
+};
+
 #endif // VALUE_CONVERSION_H
\ No newline at end of file
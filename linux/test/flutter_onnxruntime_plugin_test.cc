@@ -8,7 +8,41 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 #include "include/flutter_onnxruntime/flutter_onnxruntime_plugin.h"
+#include "core/buffer_pool.h"
+#include "core/convert_kernels.h"
+#include "core/element_types.h"
+#include "core/handle_table.h"
+#include "core/identity_model.h"
+#include "core/image_preprocess.h"
+#include "core/inference_executor.h"
+#include "core/lru_cache.h"
+#include "core/mapped_file.h"
+#include "core/micro_batcher.h"
+#include "core/profile_summary.h"
+#include "core/native_api.h"
+#include "core/pipeline_ops.h"
+#include "core/quantization.h"
+#include "core/session_stats.h"
+#include "core/trace_recorder.h"
+#include "core/tensor_manager.h"
+#include "core/token_sampler.h"
+
+using namespace flutter_onnxruntime;
 
 // Define the macro for casting to the plugin type
 #define FLUTTER_ONNXRUNTIME_PLUGIN(obj)                                                                                \
@@ -37,3 +71,1286 @@ TEST(FlutterOnnxruntimePlugin, GetPlatformVersion) {
   EXPECT_NE(plugin, nullptr);
   g_object_unref(plugin);
 }
+
+// Test that the executor runs every queued job, including across a resize.
+TEST(InferenceExecutor, RunsAllJobsAcrossResize) {
+  std::atomic<int> completed{0};
+  {
+    InferenceExecutor executor(2);
+    for (int i = 0; i < 50; i++) {
+      executor.submit([&completed]() { completed++; });
+    }
+    executor.setNumThreads(1);
+    EXPECT_EQ(executor.getNumThreads(), 1u);
+    for (int i = 0; i < 50; i++) {
+      executor.submit([&completed]() { completed++; });
+    }
+    // The destructor drains the queue before joining
+  }
+  EXPECT_EQ(completed.load(), 100);
+}
+
+// Test that workers retired by shrinking the pool are joined when it grows again, while jobs keep running.
+TEST(InferenceExecutor, JoinsRetiredWorkersOnResize) {
+  std::atomic<int> completed{0};
+  {
+    InferenceExecutor executor(4);
+    for (int cycle = 0; cycle < 20; cycle++) {
+      executor.setNumThreads(1);
+      for (int i = 0; i < 5; i++) {
+        executor.submit([&completed]() { completed++; });
+      }
+      // Give the surplus workers a chance to retire before the pool grows again
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      executor.setNumThreads(4);
+    }
+    EXPECT_EQ(executor.getNumThreads(), 4u);
+  }
+  EXPECT_EQ(completed.load(), 100);
+}
+
+// Test that a slow job does not hold up jobs on other workers.
+TEST(InferenceExecutor, RunsJobsConcurrently) {
+  std::atomic<bool> release{false};
+  std::atomic<bool> fast_done{false};
+  InferenceExecutor executor(2);
+
+  executor.submit([&release]() {
+    while (!release.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  executor.submit([&fast_done]() { fast_done = true; });
+
+  for (int i = 0; i < 1000 && !fast_done.load(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(fast_done.load());
+  release = true;
+}
+
+// Test that queued jobs start in priority order and that each priority counts its queueing latency.
+TEST(InferenceExecutor, RunsHigherPrioritiesFirst) {
+  std::atomic<bool> release{false};
+  std::mutex order_mutex;
+  std::vector<int> order;
+  auto record = [&order_mutex, &order](int job) {
+    std::lock_guard<std::mutex> lock(order_mutex);
+    order.push_back(job);
+  };
+  std::array<JobQueueStats, kJobPriorityCount> stats;
+  {
+    InferenceExecutor executor(1);
+    std::atomic<bool> started{false};
+    executor.submit([&started, &release]() {
+      started = true;
+      while (!release.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+    while (!started.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    executor.submit([&record]() { record(3); }, JobPriority::kLow);
+    executor.submit([&record]() { record(2); });
+    executor.submit([&record]() { record(1); }, JobPriority::kHigh);
+    stats = executor.getQueueStats();
+    EXPECT_EQ(stats[static_cast<size_t>(JobPriority::kLow)].queued, 1u);
+    release = true;
+  }
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(stats[static_cast<size_t>(JobPriority::kNormal)].submitted, 2u);
+  EXPECT_EQ(stats[static_cast<size_t>(JobPriority::kNormal)].started, 1u);
+}
+
+// Test that a high-priority job preempts a running low-priority one and that queued low-priority jobs can be
+// cancelled.
+TEST(InferenceExecutor, PreemptsLowPriorityJobs) {
+  InferenceExecutor executor(1);
+  std::atomic<bool> started{false};
+  std::atomic<bool> terminated{false};
+  std::atomic<bool> preempted{false};
+  std::atomic<bool> high_done{false};
+  executor.submit(
+      [&]() {
+        RunScope scope([&terminated]() { terminated = true; });
+        started = true;
+        while (!terminated.load()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        preempted = RunScope::stopReason() == RunStop::kPreempted;
+      },
+      JobPriority::kLow);
+  while (!started.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  executor.submit([&high_done]() { high_done = RunScope::stopReason() == RunStop::kNone; }, JobPriority::kHigh);
+  for (int i = 0; i < 1000 && !high_done.load(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(high_done.load());
+  EXPECT_TRUE(preempted.load());
+
+  std::atomic<bool> release{false};
+  std::atomic<int> cancelled{0};
+  std::atomic<int> finished{0};
+  executor.submit([&release, &finished]() {
+    while (!release.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    finished++;
+  });
+  for (int i = 0; i < 3; i++) {
+    executor.submit(
+        [&cancelled, &finished]() {
+          RunScope scope([&cancelled]() { cancelled++; });
+          finished++;
+        },
+        JobPriority::kLow);
+  }
+  EXPECT_EQ(executor.cancelLowPriority(), 3u);
+  release = true;
+  for (int i = 0; i < 1000 && finished.load() < 4; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(cancelled.load(), 3);
+  EXPECT_EQ(executor.getQueueStats()[static_cast<size_t>(JobPriority::kLow)].preempted, 4u);
+}
+
+// Test that runs are cancelled by tag and stopped at their deadline, and that finished runs are forgotten.
+TEST(RunRegistry, CancelsByTagAndStopsAtDeadline) {
+  RunRegistry registry;
+  auto tagged = std::make_shared<RunControl>();
+  auto timed = std::make_shared<RunControl>();
+  std::atomic<bool> terminated{false};
+  registry.track(tagged, "run_1", 0);
+  registry.track(timed, "", 20 * 1000 * 1000);
+  timed->attach([&terminated]() { terminated = true; });
+
+  EXPECT_FALSE(registry.cancel("run_2"));
+  EXPECT_TRUE(registry.cancel("run_1"));
+  EXPECT_EQ(tagged->reason(), RunStop::kCancelled);
+  registry.untrack(tagged);
+  EXPECT_FALSE(registry.cancel("run_1"));
+
+  for (int i = 0; i < 1000 && !terminated.load(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(terminated.load());
+  EXPECT_EQ(timed->reason(), RunStop::kTimedOut);
+  timed->detach();
+  registry.untrack(timed);
+
+  // A run stopped before its terminate function is attached is terminated as soon as it is
+  auto queued = std::make_shared<RunControl>();
+  EXPECT_TRUE(queued->stop(RunStop::kCancelled));
+  EXPECT_FALSE(queued->stop(RunStop::kTimedOut));
+  bool queued_terminated = false;
+  queued->attach([&queued_terminated]() { queued_terminated = true; });
+  EXPECT_TRUE(queued_terminated);
+}
+
+// Test that released buffers are reused for requests of the same size class.
+TEST(BufferPool, ReusesReleasedBuffers) {
+  BufferPool pool;
+  uint8_t *first_data = nullptr;
+  {
+    PooledBuffer buffer = pool.acquire(1000);
+    first_data = buffer.data();
+    EXPECT_EQ(buffer.size(), 1000u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.data()) % BufferPool::kAlignment, 0u);
+  }
+
+  PooledBuffer buffer = pool.acquire(1010);
+  EXPECT_EQ(buffer.data(), first_data);
+
+  BufferPoolStats stats = pool.getStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.retained_buffers, 0u);
+}
+
+// Test that the pool never retains more than its cap.
+TEST(BufferPool, RespectsRetentionCap) {
+  BufferPool pool(8192);
+  {
+    PooledBuffer small = pool.acquire(4096);
+    PooledBuffer large = pool.acquire(1 << 20);
+  }
+
+  BufferPoolStats stats = pool.getStats();
+  EXPECT_EQ(stats.retained_buffers, 1u);
+  EXPECT_EQ(stats.retained_bytes, 4096u);
+
+  pool.setMaxRetainedBytes(0);
+  EXPECT_EQ(pool.getStats().retained_bytes, 0u);
+}
+
+// Test that the vector paths round and saturate exactly like the scalar rules, on lengths with scalar tails.
+TEST(ConvertKernels, MatchScalarRules) {
+  const float infinity = std::numeric_limits<float>::infinity();
+  const float specials[] = {0.0f,   -0.0f,  0.49f,  0.5f,  -0.5f,   1.5f,     -1.5f,    2.5f,
+                            254.4f, 254.5f, 254.6f, 255.0f, 255.5f, 256.0f,   -1.0f,    1e9f,
+                            -1e9f,  3e9f,   -3e9f,  1e-30f, -1e-30f, infinity, -infinity};
+  std::vector<float> floats;
+  for (int i = 0; i < 7; i++) {
+    floats.insert(floats.end(), std::begin(specials), std::end(specials));
+  }
+  std::vector<int32_t> ints;
+  for (size_t i = 0; i < floats.size(); i++) {
+    ints.push_back(static_cast<int32_t>(i * 37) - 300);
+  }
+  ints.push_back(INT32_MAX);
+  ints.push_back(INT32_MIN);
+
+  std::vector<int32_t> float_to_int(floats.size());
+  std::vector<uint8_t> float_to_uint8(floats.size());
+  ASSERT_TRUE(convertElements(ConvertType::kFloat32, floats.data(), ConvertType::kInt32, float_to_int.data(),
+                              floats.size()));
+  ASSERT_TRUE(convertElements(ConvertType::kFloat32, floats.data(), ConvertType::kUint8, float_to_uint8.data(),
+                              floats.size()));
+  for (size_t i = 0; i < floats.size(); i++) {
+    float v = floats[i];
+    if (std::fabs(v) < 2e9f) {
+      EXPECT_EQ(float_to_int[i], static_cast<int32_t>(v + (v >= 0 ? 0.5f : -0.5f))) << v;
+    }
+    float clamped = v < 0 ? 0 : (v > 255 ? 255 : v + 0.5f);
+    EXPECT_EQ(float_to_uint8[i], static_cast<uint8_t>(clamped)) << v;
+  }
+
+  std::vector<uint8_t> int_to_uint8(ints.size());
+  std::vector<float> int_to_float(ints.size());
+  ASSERT_TRUE(
+      convertElements(ConvertType::kInt32, ints.data(), ConvertType::kUint8, int_to_uint8.data(), ints.size()));
+  ASSERT_TRUE(
+      convertElements(ConvertType::kInt32, ints.data(), ConvertType::kFloat32, int_to_float.data(), ints.size()));
+  for (size_t i = 0; i < ints.size(); i++) {
+    EXPECT_EQ(int_to_uint8[i], static_cast<uint8_t>(ints[i] < 0 ? 0 : (ints[i] > 255 ? 255 : ints[i])));
+    EXPECT_EQ(int_to_float[i], static_cast<float>(ints[i]));
+  }
+
+  std::vector<float> uint8_to_float(int_to_uint8.size());
+  ASSERT_TRUE(convertElements(ConvertType::kUint8, int_to_uint8.data(), ConvertType::kFloat32, uint8_to_float.data(),
+                              int_to_uint8.size()));
+  for (size_t i = 0; i < int_to_uint8.size(); i++) {
+    EXPECT_EQ(uint8_to_float[i], static_cast<float>(int_to_uint8[i]));
+  }
+
+  int64_t wide[] = {INT64_MAX, INT64_MIN, -7, 300};
+  int32_t narrow[4];
+  ASSERT_TRUE(convertElements(ConvertType::kInt64, wide, ConvertType::kInt32, narrow, 4));
+  EXPECT_EQ(narrow[0], INT32_MAX);
+  EXPECT_EQ(narrow[1], INT32_MIN);
+  EXPECT_EQ(narrow[2], -7);
+  EXPECT_EQ(narrow[3], 300);
+
+  // Same-type pairs copy
+  ASSERT_TRUE(convertElements(ConvertType::kInt32, ints.data(), ConvertType::kInt32, float_to_int.data(), 4));
+  EXPECT_TRUE(std::equal(ints.begin(), ints.begin() + 4, float_to_int.begin()));
+}
+
+// Test the pairs beyond float32, int32, int64, uint8 and bool: half-precision sources, float64 and the narrow
+// and unsigned integers round, saturate and widen by the same rules.
+TEST(ConvertKernels, ConvertEveryPair) {
+  const uint16_t halves[] = {0x3c00, 0xc000, 0x0001, 0x7bff, 0x7c00, 0x8000};
+  float widened[6];
+  ASSERT_TRUE(convertElements(ConvertType::kFloat16, halves, ConvertType::kFloat32, widened, 6));
+  EXPECT_EQ(widened[0], 1.0f);
+  EXPECT_EQ(widened[1], -2.0f);
+  EXPECT_EQ(widened[2], std::ldexp(1.0f, -24));
+  EXPECT_EQ(widened[3], 65504.0f);
+  EXPECT_EQ(widened[4], std::numeric_limits<float>::infinity());
+  EXPECT_TRUE(std::signbit(widened[5]));
+  for (uint32_t bits = 0; bits < 0x7c00; bits++) {
+    ASSERT_EQ(floatToFloat16Bits(float16BitsToFloat(static_cast<uint16_t>(bits))), bits);
+  }
+  EXPECT_EQ(bfloat16BitsToFloat(0x3f80), 1.0f);
+
+  bool flags[2];
+  ASSERT_TRUE(convertElements(ConvertType::kFloat16, halves + 4, ConvertType::kBool, flags, 2));
+  EXPECT_TRUE(flags[0]);
+  EXPECT_FALSE(flags[1]); // -0 is false
+
+  const double doubles[] = {1.5, -1.5, 1e20, -1e20, std::nan(""), 126.4};
+  int8_t narrow[6];
+  ASSERT_TRUE(convertElements(ConvertType::kFloat64, doubles, ConvertType::kInt8, narrow, 6));
+  EXPECT_THAT(narrow, ::testing::ElementsAre(2, -2, 127, -128, 0, 126));
+  uint16_t rounded[6];
+  ASSERT_TRUE(convertElements(ConvertType::kFloat64, doubles, ConvertType::kUint16, rounded, 6));
+  EXPECT_THAT(rounded, ::testing::ElementsAre(2, 0, 65535, 0, 0, 126));
+
+  const uint64_t large[] = {UINT64_MAX, 5};
+  int32_t clamped[2];
+  ASSERT_TRUE(convertElements(ConvertType::kUint64, large, ConvertType::kInt32, clamped, 2));
+  EXPECT_THAT(clamped, ::testing::ElementsAre(INT32_MAX, 5));
+  const int16_t shorts[] = {-1, 300};
+  uint32_t unsigned_ints[2];
+  ASSERT_TRUE(convertElements(ConvertType::kInt16, shorts, ConvertType::kUint32, unsigned_ints, 2));
+  EXPECT_THAT(unsigned_ints, ::testing::ElementsAre(0u, 300u));
+  double back[2];
+  ASSERT_TRUE(convertElements(ConvertType::kUint32, unsigned_ints, ConvertType::kFloat64, back, 2));
+  EXPECT_THAT(back, ::testing::ElementsAre(0.0, 300.0));
+
+  EXPECT_EQ(convertTypeSize(ConvertType::kFloat64), 8u);
+  EXPECT_EQ(convertTypeSize(ConvertType::kInt16), 2u);
+  EXPECT_FALSE(convertElements(static_cast<ConvertType>(kConvertTypeCount), halves, ConvertType::kFloat32, widened, 1));
+}
+
+// Test that the element type table is indexed by the ONNX enum and parses the Dart names.
+TEST(ElementTypes, IndexesByEnumAndParsesNames) {
+  static_assert(elementTypeInfo(ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE).size == sizeof(double));
+  EXPECT_STREQ(elementTypeInfo(ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT).name, "float32");
+  EXPECT_STREQ(elementTypeInfo(ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16).name, "bfloat16");
+  EXPECT_EQ(elementTypeInfo(ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX128).size, 16u);
+  EXPECT_FALSE(elementTypeInfo(ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING).convertible);
+  EXPECT_STREQ(elementTypeInfo(static_cast<ONNXTensorElementDataType>(100)).name, "unknown");
+
+  size_t convertible = 0;
+  for (size_t i = 1; i < kElementTypeCount; i++) {
+    ONNXTensorElementDataType parsed;
+    ASSERT_TRUE(parseElementType(kElementTypes[i].name, &parsed));
+    EXPECT_EQ(static_cast<size_t>(parsed), i);
+    if (kElementTypes[i].convertible) {
+      EXPECT_EQ(convertTypeSize(kElementTypes[i].convert_type), kElementTypes[i].size);
+      convertible++;
+    }
+  }
+  EXPECT_EQ(convertible, kConvertTypeCount);
+  ONNXTensorElementDataType parsed;
+  EXPECT_FALSE(parseElementType("float", &parsed));
+  EXPECT_FALSE(parseElementType("unknown", &parsed));
+}
+
+// Test float16/bfloat16 rounding and the multi-threaded path.
+TEST(ConvertKernels, ConvertsToHalfPrecisionAndInParallel) {
+  EXPECT_EQ(floatToFloat16Bits(1.0f), 0x3c00);
+  EXPECT_EQ(floatToFloat16Bits(-2.0f), 0xc000);
+  EXPECT_EQ(floatToFloat16Bits(65504.0f), 0x7bff);
+  EXPECT_EQ(floatToFloat16Bits(65520.0f), 0x7c00);
+  EXPECT_EQ(floatToFloat16Bits(1.0f + 1.0f / 2048), 0x3c00); // tie rounds to even
+  EXPECT_EQ(floatToFloat16Bits(1.0f + 3.0f / 2048), 0x3c02);
+  EXPECT_EQ(floatToFloat16Bits(std::ldexp(1.0f, -24)), 0x0001); // smallest subnormal
+  EXPECT_EQ(floatToFloat16Bits(std::ldexp(1.0f, -25)), 0x0000); // tie rounds to even
+  EXPECT_EQ(floatToFloat16Bits(std::numeric_limits<float>::quiet_NaN()) & 0x7e00, 0x7e00);
+  EXPECT_EQ(floatToBFloat16Bits(1.0f), 0x3f80);
+  EXPECT_EQ(floatToBFloat16Bits(-0.0f), 0x8000);
+  EXPECT_EQ(floatToBFloat16Bits(1.0f + 1.0f / 256), 0x3f80); // tie rounds to even
+  EXPECT_EQ(floatToBFloat16Bits(std::numeric_limits<float>::quiet_NaN()) & 0x7fc0, 0x7fc0);
+
+  std::vector<int64_t> source(kParallelConvertThreshold + 1001);
+  for (size_t i = 0; i < source.size(); i++) {
+    source[i] = static_cast<int64_t>(i % 600) - 100;
+  }
+  std::vector<uint8_t> target(source.size());
+  ASSERT_TRUE(convertElements(ConvertType::kInt64, source.data(), ConvertType::kUint8, target.data(), source.size()));
+  for (size_t i = 0; i < source.size(); i++) {
+    ASSERT_EQ(target[i], static_cast<uint8_t>(source[i] < 0 ? 0 : (source[i] > 255 ? 255 : source[i])));
+  }
+}
+
+// Test quantization per tensor and per channel: ties round to even, values saturate and NaN maps to the zero point,
+// on both the vector paths and the scalar tail.
+TEST(Quantization, QuantizesAndDequantizes) {
+  const float pattern[] = {0.25f, 0.75f, -0.25f, std::nanf(""), 1000.0f, -1000.0f, 10.0f, -3.5f};
+  const uint8_t expected_uint8[] = {128, 130, 128, 128, 255, 0, 148, 121};
+  std::vector<float> src;
+  for (int i = 0; i < 5; i++) {
+    src.insert(src.end(), std::begin(pattern), std::end(pattern));
+  }
+  QuantizationParams params;
+  params.scales = {0.5f};
+  params.zero_points = {128};
+  std::vector<uint8_t> quantized(src.size());
+  quantizeElements(src.data(), {static_cast<int64_t>(src.size())}, params, quantized.data());
+  for (size_t i = 0; i < src.size(); i++) {
+    ASSERT_EQ(quantized[i], expected_uint8[i % 8]) << i;
+  }
+  std::vector<float> dequantized(src.size());
+  dequantizeElements(quantized.data(), {static_cast<int64_t>(src.size())}, params, dequantized.data());
+  EXPECT_EQ(dequantized[1], 1.0f);
+  EXPECT_EQ(dequantized[4], 63.5f);
+  EXPECT_EQ(dequantized[37], -64.0f);
+
+  // Per channel along axis 1 of [2, 3, 8], in int8
+  params.scales = {1.0f, 2.0f, 4.0f};
+  params.zero_points = {0, -3, 10};
+  params.element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8;
+  std::vector<float> channels(48);
+  for (size_t i = 0; i < channels.size(); i++) {
+    channels[i] = static_cast<float>(i) * 5.0f - 100.0f;
+  }
+  std::vector<int8_t> quantized_int8(channels.size());
+  quantizeElements(channels.data(), {2, 3, 8}, params, quantized_int8.data());
+  for (size_t i = 0; i < channels.size(); i++) {
+    size_t channel = (i / 8) % 3;
+    float scaled = std::nearbyint(channels[i] / params.scales[channel]) + params.zero_points[channel];
+    ASSERT_EQ(quantized_int8[i], static_cast<int8_t>(std::min(std::max(scaled, -128.0f), 127.0f))) << i;
+  }
+  std::vector<float> restored(channels.size());
+  dequantizeElements(quantized_int8.data(), {2, 3, 8}, params, restored.data());
+  EXPECT_EQ(restored[8], channels[8]); // -60 in the second channel
+  EXPECT_EQ(restored[47], 136.0f);      // 135 to the nearest step of the third channel
+  params.axis = -2;
+  dequantizeElements(quantized_int8.data(), {2, 3, 8}, params, restored.data());
+  EXPECT_EQ(restored[8], channels[8]);
+
+  EXPECT_THROW(quantizeElements(channels.data(), {2, 4, 6}, params, quantized_int8.data()), std::invalid_argument);
+  params.axis = 3;
+  EXPECT_THROW(quantizeElements(channels.data(), {2, 3, 8}, params, quantized_int8.data()), std::invalid_argument);
+  params = QuantizationParams{};
+  params.scales = {0.0f};
+  EXPECT_THROW(quantizeElements(src.data(), {1}, params, quantized.data()), std::invalid_argument);
+  params.scales = {1.0f};
+  params.zero_points = {256};
+  EXPECT_THROW(quantizeElements(src.data(), {1}, params, quantized.data()), std::invalid_argument);
+}
+
+// Test that the scales and zero points of the QuantizeLinear and DequantizeLinear nodes at the inputs and outputs of
+// a model are read from its initializers and Constant nodes.
+TEST(Quantization, ReadsModelQuantization) {
+  auto varint = [](std::string &out, uint64_t value) {
+    for (; value >= 0x80; value >>= 7) {
+      out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    }
+    out.push_back(static_cast<char>(value));
+  };
+  auto bytes = [&](std::string &out, uint32_t field, const std::string &value) {
+    varint(out, (field << 3) | 2);
+    varint(out, value.size());
+    out += value;
+  };
+  auto integer = [&](std::string &out, uint32_t field, uint64_t value) {
+    varint(out, field << 3);
+    varint(out, value);
+  };
+  auto node = [&](const char *op_type, std::vector<std::string> inputs, const char *output, int64_t axis) {
+    std::string node;
+    for (const std::string &input : inputs) {
+      bytes(node, 1, input);
+    }
+    bytes(node, 2, output);
+    bytes(node, 4, op_type);
+    std::string attribute;
+    bytes(attribute, 1, "axis");
+    integer(attribute, 3, static_cast<uint64_t>(axis));
+    bytes(node, 5, attribute);
+    return node;
+  };
+  auto value_info = [&](const char *name) {
+    std::string info;
+    bytes(info, 1, name);
+    return info;
+  };
+
+  std::string graph;
+  bytes(graph, 11, value_info("x"));
+  bytes(graph, 11, value_info("w"));
+  bytes(graph, 11, value_info("plain"));
+  bytes(graph, 12, value_info("y"));
+  bytes(graph, 1, node("QuantizeLinear", {"x", "x_scale", "x_zero_point"}, "x_quantized", 1));
+  bytes(graph, 1, node("DequantizeLinear", {"x_quantized", "x_scale", "x_zero_point"}, "x_float", 1));
+  bytes(graph, 1, node("DequantizeLinear", {"w", "w_scale"}, "w_float", 0));
+  bytes(graph, 1, node("QuantizeLinear", {"z", "y_scale", "y_zero_point"}, "y", -1));
+
+  std::string x_scale; // float_data, packed
+  bytes(x_scale, 8, "x_scale");
+  integer(x_scale, 2, 1);
+  float half = 0.5f;
+  bytes(x_scale, 4, std::string(reinterpret_cast<const char *>(&half), sizeof(half)));
+  bytes(graph, 5, x_scale);
+  std::string x_zero_point; // int32_data, packed
+  integer(x_zero_point, 2, 2);
+  bytes(x_zero_point, 5, std::string(1, static_cast<char>(100)));
+  bytes(x_zero_point, 8, "x_zero_point");
+  bytes(graph, 5, x_zero_point);
+  std::string w_scale; // raw_data of two floats
+  integer(w_scale, 1, 2);
+  integer(w_scale, 2, 1);
+  const float w_scales[] = {0.25f, 0.125f};
+  bytes(w_scale, 9, std::string(reinterpret_cast<const char *>(w_scales), sizeof(w_scales)));
+  bytes(w_scale, 8, "w_scale");
+  bytes(graph, 5, w_scale);
+  std::string y_zero_point; // raw_data of an int8
+  bytes(y_zero_point, 8, "y_zero_point");
+  integer(y_zero_point, 2, 3);
+  bytes(y_zero_point, 9, std::string(1, static_cast<char>(-5)));
+  bytes(graph, 5, y_zero_point);
+  std::string y_scale; // a Constant node
+  integer(y_scale, 2, 1);
+  float quarter = 0.25f;
+  bytes(y_scale, 9, std::string(reinterpret_cast<const char *>(&quarter), sizeof(quarter)));
+  std::string value;
+  bytes(value, 1, "value");
+  bytes(value, 5, y_scale);
+  std::string constant;
+  bytes(constant, 2, "y_scale");
+  bytes(constant, 4, "Constant");
+  bytes(constant, 5, value);
+  bytes(graph, 1, constant);
+
+  std::string model;
+  integer(model, 1, 7);
+  bytes(model, 7, graph);
+
+  ModelQuantization quantization = readModelQuantization(model.data(), model.size());
+  ASSERT_EQ(quantization.inputs.size(), 2u);
+  const QuantizationParams &x = quantization.inputs.at("x");
+  EXPECT_THAT(x.scales, ::testing::ElementsAre(0.5f));
+  EXPECT_THAT(x.zero_points, ::testing::ElementsAre(100));
+  EXPECT_EQ(x.element_type, ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8);
+  const QuantizationParams &w = quantization.inputs.at("w");
+  EXPECT_THAT(w.scales, ::testing::ElementsAre(0.25f, 0.125f));
+  EXPECT_TRUE(w.zero_points.empty());
+  EXPECT_EQ(w.axis, 0);
+  ASSERT_EQ(quantization.outputs.size(), 1u);
+  const QuantizationParams &y = quantization.outputs.at("y");
+  EXPECT_THAT(y.scales, ::testing::ElementsAre(0.25f));
+  EXPECT_THAT(y.zero_points, ::testing::ElementsAre(-5));
+  EXPECT_EQ(y.axis, -1);
+  EXPECT_EQ(y.element_type, ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8);
+
+  // Models without quantization nodes and truncated models have no quantization
+  std::string identity = buildIdentityModel(ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  EXPECT_TRUE(readModelQuantization(identity.data(), identity.size()).inputs.empty());
+  ModelQuantization truncated = readModelQuantization(model.data(), model.size() - 3);
+  EXPECT_TRUE(truncated.inputs.empty() && truncated.outputs.empty());
+}
+
+// Test that an image is swizzled, normalized and laid out in NCHW and NHWC.
+TEST(ImagePreprocess, NormalizesAndLaysOutPixels) {
+  // 2x1 BGRA image: a red pixel and a blue pixel
+  const uint8_t bgra[] = {0, 0, 255, 7, 255, 0, 0, 7};
+  ImageTensorOptions options;
+  options.format = ImageFormat::kBgra;
+  options.width = 2;
+  options.height = 1;
+  options.mean[0] = 0.5f;
+  options.std[0] = 0.5f;
+  ASSERT_EQ(imageByteSize(options.format, options.width, options.height), sizeof(bgra));
+
+  float nchw[6];
+  preprocessImage(options, bgra, nchw);
+  const float expected_nchw[] = {1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+  for (int i = 0; i < 6; i++) {
+    EXPECT_FLOAT_EQ(nchw[i], expected_nchw[i]) << i;
+  }
+
+  options.channels_first = false;
+  float nhwc[6];
+  preprocessImage(options, bgra, nhwc);
+  const float expected_nhwc[] = {1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f};
+  for (int i = 0; i < 6; i++) {
+    EXPECT_FLOAT_EQ(nhwc[i], expected_nhwc[i]) << i;
+  }
+
+  options.half_precision = true;
+  uint16_t half[6];
+  preprocessImage(options, bgra, half);
+  EXPECT_EQ(half[0], 0x3c00);
+  EXPECT_EQ(half[3], 0xbc00);
+}
+
+// Test NV21 conversion and bilinear resizing, on an image large enough to be split across threads.
+TEST(ImagePreprocess, ConvertsNv21AndResizes) {
+  // Grey NV21 image with neutral chroma, and a brighter right half
+  const int width = 512;
+  const int height = 512;
+  ImageTensorOptions options;
+  options.format = ImageFormat::kNv21;
+  options.width = width;
+  options.height = height;
+  std::vector<uint8_t> nv21(imageByteSize(options.format, width, height), 128);
+  for (int y = 0; y < height; y++) {
+    std::fill(nv21.begin() + y * width + width / 2, nv21.begin() + (y + 1) * width, 255);
+  }
+
+  std::vector<float> full(3 * width * height);
+  preprocessImage(options, nv21.data(), full.data());
+  for (int c = 0; c < 3; c++) {
+    EXPECT_FLOAT_EQ(full[c * width * height], 128.0f / 255.0f);
+    EXPECT_FLOAT_EQ(full[c * width * height + width - 1], 1.0f);
+  }
+
+  options.target_width = 4;
+  options.target_height = 2;
+  float resized[3 * 4 * 2];
+  preprocessImage(options, nv21.data(), resized);
+  EXPECT_FLOAT_EQ(resized[0], 128.0f / 255.0f);
+  EXPECT_FLOAT_EQ(resized[3], 1.0f);
+  EXPECT_FLOAT_EQ(resized[2 * 8 + 4], 128.0f / 255.0f);
+}
+
+// Test slicing with negative and clamped bounds, and argmax and top-k along the last axis.
+TEST(PipelineOps, SlicesAndReduces) {
+  // 2x3x4 tensor holding its own element indices
+  std::vector<float> src(24);
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = static_cast<float>(i);
+  }
+
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> sizes;
+  resolveSlice({2, 3, 4}, {1, -2}, {100, 4}, {1, 2}, &offsets, &sizes);
+  EXPECT_EQ(offsets, (std::vector<int64_t>{0, 1, 2}));
+  EXPECT_EQ(sizes, (std::vector<int64_t>{2, 2, 2}));
+  std::vector<float> slice(8);
+  sliceElements(src.data(), sizeof(float), {2, 3, 4}, offsets, sizes, slice.data());
+  EXPECT_EQ(slice, (std::vector<float>{6, 7, 10, 11, 18, 19, 22, 23}));
+  EXPECT_THROW(resolveSlice({2, 3}, {0}, {1}, {2}, &offsets, &sizes), std::invalid_argument);
+
+  std::vector<float> scores = {0.1f, 0.7f, 0.7f, 0.2f, 0.9f, 0.3f};
+  int64_t argmax[2];
+  argmaxAxis(scores.data(), {2, 3}, 1, argmax);
+  EXPECT_EQ(argmax[0], 1);
+  EXPECT_EQ(argmax[1], 1);
+
+  float values[4];
+  int64_t indices[4];
+  topKRows(scores.data(), 2, 3, 2, values, indices);
+  EXPECT_EQ((std::vector<int64_t>(indices, indices + 4)), (std::vector<int64_t>{1, 2, 1, 2}));
+  EXPECT_FLOAT_EQ(values[2], 0.9f);
+  EXPECT_FLOAT_EQ(values[3], 0.3f);
+}
+
+// Test that NMS drops overlapping and low-scoring boxes, and that crops are resized bilinearly.
+TEST(PipelineOps, SuppressesBoxesAndCropsRegions) {
+  std::vector<float> boxes = {0, 0, 10, 10, 1, 1, 11, 11, 20, 20, 30, 30, 0, 0, 5, 5};
+  std::vector<float> scores = {0.8f, 0.9f, 0.6f, 0.1f};
+  EXPECT_EQ(nonMaxSuppression(boxes.data(), scores.data(), 4, 0.5f, 0.2f, 0), (std::vector<int64_t>{1, 2}));
+  EXPECT_EQ(nonMaxSuppression(boxes.data(), scores.data(), 4, 0.5f, 0.0f, 1), (std::vector<int64_t>{1}));
+
+  // One-channel 4x4 image whose pixels are their column index
+  std::vector<float> image(16);
+  for (int i = 0; i < 16; i++) {
+    image[i] = static_cast<float>(i % 4);
+  }
+  std::vector<float> crop_box = {0, 0, 4, 4, 2, 0, 4, 2};
+  std::vector<float> crops(2 * 2 * 2);
+  cropResize(image.data(), 1, 4, 4, crop_box.data(), 2, 2, 2, crops.data());
+  EXPECT_FLOAT_EQ(crops[0], 0.5f);
+  EXPECT_FLOAT_EQ(crops[1], 2.5f);
+  EXPECT_FLOAT_EQ(crops[4], 2.0f);
+  EXPECT_FLOAT_EQ(crops[5], 3.0f);
+  EXPECT_THROW(cropResize(image.data(), 1, 4, 4, crop_box.data(), 2, 0, 2, crops.data()), std::invalid_argument);
+  EXPECT_THROW(cropResize(image.data(), 1, 0, 4, crop_box.data(), 2, 2, 2, crops.data()), std::invalid_argument);
+}
+
+// Test exp against std::exp, softmax along inner and outer axes, sigmoid, and argmax and top-k split across threads.
+TEST(PipelineOps, ComputesSoftmaxAndSigmoid) {
+  // NaN and -inf lead so that they go through the vector path
+  std::vector<float> inputs = {std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::infinity()};
+  for (float x = -90.0f; x <= 90.0f; x += 0.0137f) {
+    inputs.push_back(x);
+  }
+  std::vector<float> exps(inputs.size());
+  expElements(inputs.data(), inputs.size(), exps.data());
+  for (size_t i = 0; i < inputs.size(); i++) {
+    float x = inputs[i];
+    if (std::isnan(x)) {
+      EXPECT_TRUE(std::isnan(exps[i]));
+    } else if (x < -87.3f) {
+      EXPECT_EQ(exps[i], 0.0f) << x;
+    } else {
+      float expected = std::exp(std::min(x, 88.0f));
+      EXPECT_NEAR(exps[i], expected, expected * 3e-7f) << x;
+    }
+  }
+
+  // Softmax of a 2x3 tensor along its last and first axes
+  std::vector<float> logits = {1.0f, 2.0f, 3.0f, 1.0f, 1.0f, -std::numeric_limits<float>::infinity()};
+  std::vector<float> rows(6);
+  softmaxAxis(logits.data(), {2, 3}, 1, rows.data());
+  EXPECT_NEAR(rows[0], 0.09003057f, 1e-6f);
+  EXPECT_NEAR(rows[2], 0.66524096f, 1e-6f);
+  EXPECT_FLOAT_EQ(rows[3], 0.5f);
+  EXPECT_EQ(rows[5], 0.0f);
+  std::vector<float> columns(6);
+  softmaxAxis(logits.data(), {2, 3}, 0, columns.data());
+  EXPECT_FLOAT_EQ(columns[0], 0.5f);
+  EXPECT_NEAR(columns[1], 0.7310586f, 1e-6f);
+  EXPECT_FLOAT_EQ(columns[2], 1.0f);
+  EXPECT_FLOAT_EQ(columns[5], 0.0f);
+
+  std::vector<float> sigmoids(3);
+  std::vector<float> sigmoid_inputs = {0.0f, 2.0f, -100.0f};
+  sigmoidElements(sigmoid_inputs.data(), 3, sigmoids.data());
+  EXPECT_FLOAT_EQ(sigmoids[0], 0.5f);
+  EXPECT_NEAR(sigmoids[1], 0.8807971f, 1e-6f);
+  EXPECT_NEAR(sigmoids[2], 0.0f, 1e-30f);
+
+  // A [1, 4, 128, 256] map is split across threads by columns; channel c wins where the column index mod 4 is c
+  const int64_t plane = 128 * 256;
+  std::vector<float> map(4 * plane);
+  for (int64_t c = 0; c < 4; c++) {
+    for (int64_t i = 0; i < plane; i++) {
+      map[c * plane + i] = (i % 4 == c) ? 1.0f : 0.0f;
+    }
+  }
+  std::vector<int64_t> classes(plane);
+  argmaxAxis(map.data(), {1, 4, 128, 256}, 1, classes.data());
+  for (int64_t i = 0; i < plane; i++) {
+    ASSERT_EQ(classes[i], i % 4);
+  }
+  std::vector<float> probabilities(map.size());
+  softmaxAxis(map.data(), {1, 4, 128, 256}, 1, probabilities.data());
+  EXPECT_NEAR(probabilities[5], 0.17487770f, 1e-6f);
+  EXPECT_NEAR(probabilities[plane + 5], 0.47536689f, 1e-6f);
+
+  // Rows of 8 elements of the same map, ones at 0 and 4 in channel 0 and at 3 and 7 in channel 3
+  std::vector<float> top_values(plane);
+  std::vector<int64_t> top_indices(plane);
+  topKRows(map.data(), plane / 2, 8, 2, top_values.data(), top_indices.data());
+  EXPECT_EQ(top_indices[0], 0);
+  EXPECT_EQ(top_indices[1], 4);
+  EXPECT_EQ(top_indices[plane - 2], 3);
+  EXPECT_EQ(top_indices[plane - 1], 7);
+  EXPECT_FLOAT_EQ(top_values[plane - 1], 1.0f);
+}
+
+// Test reshape resolution, tiled transposes against index arithmetic, and concatenation along inner and outer axes.
+TEST(PipelineOps, ReshapesTransposesAndConcatenates) {
+  EXPECT_EQ(resolveReshape({2, 3, 4}, {0, -1}), (std::vector<int64_t>{2, 12}));
+  EXPECT_EQ(resolveReshape({2, 3, 4}, {4, 0, 2}), (std::vector<int64_t>{4, 3, 2}));
+  EXPECT_THROW(resolveReshape({2, 3, 4}, {5, -1}), std::invalid_argument);
+  EXPECT_THROW(resolveReshape({2, 3, 4}, {-1, -1}), std::invalid_argument);
+  EXPECT_EQ(resolvePermutation(3, {}), (std::vector<int64_t>{2, 1, 0}));
+  EXPECT_EQ(resolvePermutation(3, {0, -1, 1}), (std::vector<int64_t>{0, 2, 1}));
+  EXPECT_THROW(resolvePermutation(3, {0, 0, 1}), std::invalid_argument);
+
+  // A 3x70x45 tensor spans several tiles and partial ones at the edges
+  const std::vector<int64_t> shape = {3, 70, 45};
+  std::vector<int32_t> src(3 * 70 * 45);
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = static_cast<int32_t>(i);
+  }
+  for (const std::vector<int64_t> &perm : std::vector<std::vector<int64_t>>{{2, 0, 1}, {1, 0, 2}, {0, 2, 1}}) {
+    std::vector<int32_t> dst(src.size());
+    transposeElements(src.data(), sizeof(int32_t), shape, perm, dst.data());
+    std::vector<int64_t> out_shape = {shape[perm[0]], shape[perm[1]], shape[perm[2]]};
+    for (int64_t i = 0; i < out_shape[0]; i++) {
+      for (int64_t j = 0; j < out_shape[1]; j++) {
+        for (int64_t k = 0; k < out_shape[2]; k++) {
+          int64_t index[3];
+          index[perm[0]] = i;
+          index[perm[1]] = j;
+          index[perm[2]] = k;
+          ASSERT_EQ(dst[(i * out_shape[1] + j) * out_shape[2] + k], (index[0] * 70 + index[1]) * 45 + index[2]);
+        }
+      }
+    }
+  }
+  std::vector<uint16_t> halves = {1, 2, 3, 4, 5, 6};
+  std::vector<uint16_t> transposed(6);
+  transposeElements(halves.data(), sizeof(uint16_t), {2, 3}, {1, 0}, transposed.data());
+  EXPECT_EQ(transposed, (std::vector<uint16_t>{1, 4, 2, 5, 3, 6}));
+
+  // [2, 1] and [2, 2] joined along axis 1, then [1, 3] and [2, 3] along axis 0
+  std::vector<float> left = {1, 2};
+  std::vector<float> right = {3, 4, 5, 6};
+  std::vector<float> joined(6);
+  concatElements({left.data(), right.data()}, {{2, 1}, {2, 2}}, sizeof(float), 1, joined.data());
+  EXPECT_EQ(joined, (std::vector<float>{1, 3, 4, 2, 5, 6}));
+  concatElements({left.data(), right.data()}, {{1, 2}, {2, 2}}, sizeof(float), 0, joined.data());
+  EXPECT_EQ(joined, (std::vector<float>{1, 2, 3, 4, 5, 6}));
+}
+
+// Test that argmax keeps the first of tied maxima past the SIMD lanes, and that greedy settings ignore the seed.
+TEST(TokenSampler, PicksGreedily) {
+  std::vector<float> logits(37, -1.0f);
+  logits[20] = 3.0f;
+  logits[29] = 3.0f;
+  EXPECT_EQ(argmaxToken(logits.data(), logits.size()), 20);
+  logits[36] = 4.0f;
+  EXPECT_EQ(argmaxToken(logits.data(), logits.size()), 36);
+
+  TokenSampler greedy(SamplingOptions{}, 1);
+  EXPECT_EQ(greedy.sample(logits.data(), logits.size()), 36);
+  TokenSampler top_one({1.0f, 1, 1.0f}, 2);
+  EXPECT_EQ(top_one.sample(logits.data(), logits.size()), 36);
+}
+
+// Test that sampling stays within top-k and the nucleus, and repeats with the same seed.
+TEST(TokenSampler, SamplesWithinTopKAndTopP) {
+  std::vector<float> logits = {2.0f, 0.0f, 1.9f, -5.0f, 1.8f, 0.1f};
+
+  TokenSampler top_k({1.0f, 2, 1.0f}, 7);
+  TokenSampler nucleus({1.0f, 0, 0.5f}, 7);
+  std::vector<int> top_k_counts(logits.size());
+  for (int i = 0; i < 2000; i++) {
+    top_k_counts[top_k.sample(logits.data(), logits.size())]++;
+    int64_t token = nucleus.sample(logits.data(), logits.size());
+    EXPECT_TRUE(token == 0 || token == 2) << token;
+  }
+  EXPECT_GT(top_k_counts[0], 0);
+  EXPECT_GT(top_k_counts[2], 0);
+  EXPECT_EQ(top_k_counts[0] + top_k_counts[2], 2000);
+
+  TokenSampler first({0.8f, 0, 1.0f}, 42);
+  TokenSampler second({0.8f, 0, 1.0f}, 42);
+  for (int i = 0; i < 20; i++) {
+    EXPECT_EQ(first.sample(logits.data(), logits.size()), second.sample(logits.data(), logits.size()));
+  }
+}
+
+// Test that a handle stops resolving once its slot has been freed and reused.
+TEST(HandleTable, DetectsStaleHandles) {
+  HandleTable<int> table;
+  Handle first = table.insert(1);
+  ASSERT_NE(first, kInvalidHandle);
+  EXPECT_TRUE(table.erase(first));
+
+  Handle second = table.insert(2);
+  EXPECT_NE(second, first);
+  EXPECT_EQ(table.find(first), nullptr);
+  ASSERT_NE(table.find(second), nullptr);
+  EXPECT_EQ(*table.find(second), 2);
+  EXPECT_FALSE(table.erase(first));
+  EXPECT_EQ(table.size(), 1u);
+}
+
+// Test that string IDs round-trip and malformed ones are rejected.
+TEST(HandleTable, ParsesStringIds) {
+  HandleTable<int> table;
+  Handle handle = table.insert(1);
+
+  EXPECT_EQ(parseHandle("tensor_", formatHandle("tensor_", handle)), handle);
+  EXPECT_EQ(parseHandle("tensor_", formatHandle("session_", handle)), kInvalidHandle);
+  EXPECT_EQ(parseHandle("tensor_", "tensor_12abc"), kInvalidHandle);
+  EXPECT_EQ(parseHandle("tensor_", "tensor_"), kInvalidHandle);
+}
+
+// Test that the least recently used values are evicted by count and by size.
+TEST(LruCache, EvictsLeastRecentlyUsed) {
+  LruCache<int> cache;
+  EXPECT_FALSE(cache.enabled());
+  EXPECT_TRUE(cache.insert("a", std::make_shared<int>(1), 10).empty());
+  EXPECT_EQ(cache.find("a"), nullptr);
+
+  cache.setLimits(2, 0);
+  cache.insert("a", std::make_shared<int>(1), 10);
+  cache.insert("b", std::make_shared<int>(2), 10);
+  ASSERT_NE(cache.find("a"), nullptr);
+  std::vector<std::shared_ptr<int>> evicted = cache.insert("c", std::make_shared<int>(3), 10);
+  ASSERT_EQ(evicted.size(), 1u);
+  EXPECT_EQ(*evicted[0], 2);
+  EXPECT_EQ(cache.find("b"), nullptr);
+
+  evicted = cache.setLimits(0, 15);
+  ASSERT_EQ(evicted.size(), 1u);
+  EXPECT_EQ(*evicted[0], 1);
+  ASSERT_NE(cache.find("c"), nullptr);
+  EXPECT_EQ(*cache.find("c"), 3);
+
+  LruCacheStats stats = cache.getStats();
+  EXPECT_EQ(stats.entries, 1u);
+  EXPECT_EQ(stats.bytes, 10u);
+  EXPECT_EQ(stats.hits, 3u);
+  EXPECT_EQ(stats.misses, 2u);
+  EXPECT_EQ(stats.evictions, 2u);
+}
+
+// Test that replacing a key hands back the old value and disabling the cache drops everything.
+TEST(LruCache, ReplacesAndClears) {
+  LruCache<int> cache;
+  cache.setLimits(4, 0);
+  cache.insert("a", std::make_shared<int>(1), 10);
+  std::vector<std::shared_ptr<int>> evicted = cache.insert("a", std::make_shared<int>(2), 20);
+  ASSERT_EQ(evicted.size(), 1u);
+  EXPECT_EQ(*evicted[0], 1);
+  EXPECT_EQ(*cache.find("a"), 2);
+  EXPECT_EQ(cache.getStats().bytes, 20u);
+
+  cache.insert("b", std::make_shared<int>(3), 5);
+  EXPECT_EQ(cache.setLimits(0, 0).size(), 2u);
+  EXPECT_FALSE(cache.enabled());
+  EXPECT_EQ(cache.getStats().entries, 0u);
+  EXPECT_EQ(cache.find("b"), nullptr);
+}
+
+// Test that a mapped file exposes the file's bytes and that unreadable files are rejected.
+TEST(MappedFile, MapsWholeFile) {
+  std::filesystem::path path = std::filesystem::temp_directory_path() / "flutter_onnxruntime_mapped_file_test.bin";
+  std::string contents = "not really a model";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+  }
+
+  {
+    MappedFile mapped(path);
+    ASSERT_EQ(mapped.size(), contents.size());
+    EXPECT_EQ(std::string(static_cast<const char *>(mapped.data()), mapped.size()), contents);
+  }
+
+  std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+  EXPECT_THROW(MappedFile empty(path), std::runtime_error);
+  std::filesystem::remove(path);
+  EXPECT_THROW(MappedFile missing(path), std::runtime_error);
+}
+
+// Test that latency percentiles land within a bucket of the recorded values, from any number of threads.
+TEST(SessionStats, TracksLatencyPercentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.percentile(0.5), 0u);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&histogram]() {
+      for (uint64_t micros = 1; micros <= 1000; micros++) {
+        histogram.record(micros);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(histogram.count(), 4000u);
+  EXPECT_NEAR(static_cast<double>(histogram.percentile(0.5)), 500.0, 500.0 / 16);
+  EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 990.0, 990.0 / 16);
+  EXPECT_GE(histogram.percentile(1.0), 1000u);
+
+  histogram.record(5);
+  histogram.reset();
+  EXPECT_EQ(histogram.count(), 0u);
+}
+
+// Test that session stats add up runs and calls and forget them on reset.
+TEST(SessionStats, AccumulatesRunsAndCalls) {
+  SessionStats stats;
+  stats.recordRun(2000000, 64, 16);
+  stats.recordRun(4000000, 64, 16);
+  stats.recordCall(1000, 3000);
+
+  SessionStatsSnapshot snapshot = stats.snapshot();
+  EXPECT_EQ(snapshot.runs, 2u);
+  EXPECT_EQ(snapshot.bytes_in, 128u);
+  EXPECT_EQ(snapshot.bytes_out, 32u);
+  EXPECT_EQ(snapshot.run_nanos, 6000000u);
+  EXPECT_EQ(snapshot.calls, 1u);
+  EXPECT_EQ(snapshot.input_nanos, 1000u);
+  EXPECT_EQ(snapshot.output_nanos, 3000u);
+  EXPECT_NEAR(static_cast<double>(snapshot.p99_micros), 4000.0, 4000.0 / 16);
+
+  stats.reset();
+  EXPECT_EQ(stats.snapshot().runs, 0u);
+  EXPECT_EQ(stats.snapshot().p50_micros, 0u);
+}
+
+// Test that kernel times of a trace are summed per node and per operator type, ignoring other events.
+TEST(ProfileSummary, SumsKernelTimesByNodeAndOp) {
+  const std::string trace = R"([
+{"cat" : "Session","pid" :1,"tid" :1,"dur" :900,"ts" :1,"ph" : "X","name" :"model_run","args" : {}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :5,"ts" :2,"ph" : "X","name" :"conv1_fence_before",
+ "args" : {"op_name" : "Conv"}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :300,"ts" :3,"ph" : "X","name" :"conv1_kernel_time",
+ "args" : {"op_name" : "Conv","provider" : "CPUExecutionProvider","output_size" : "4096"}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :100,"ts" :4,"ph" : "X","name" :"conv2_kernel_time",
+ "args" : {"op_name" : "Conv","provider" : "CPUExecutionProvider",
+           "sub_stats" : {"main_thread" : [1, 2.5e1, true, null]}}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :50,"ts" :5,"ph" : "X","name" :"relu\u00e9_kernel_time",
+ "args" : {"op_name" : "Relu","provider" : "CPUExecutionProvider"}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :250,"ts" :6,"ph" : "X","name" :"conv2_kernel_time",
+ "args" : {"op_name" : "Conv","provider" : "CPUExecutionProvider"}}
+]
+)";
+
+  ProfileSummary summary = summarizeProfile(trace);
+  EXPECT_EQ(summary.total_micros, 700u);
+
+  ASSERT_EQ(summary.nodes.size(), 3u);
+  EXPECT_EQ(summary.nodes[0].name, "conv2");
+  EXPECT_EQ(summary.nodes[0].total_micros, 350u);
+  EXPECT_EQ(summary.nodes[0].calls, 2u);
+  EXPECT_EQ(summary.nodes[0].op_type, "Conv");
+  EXPECT_EQ(summary.nodes[1].name, "conv1");
+  EXPECT_EQ(summary.nodes[1].provider, "CPUExecutionProvider");
+  EXPECT_EQ(summary.nodes[2].name, "relu\xc3\xa9");
+
+  ASSERT_EQ(summary.ops.size(), 2u);
+  EXPECT_EQ(summary.ops[0].name, "Conv");
+  EXPECT_EQ(summary.ops[0].total_micros, 650u);
+  EXPECT_EQ(summary.ops[0].calls, 3u);
+  EXPECT_EQ(summary.ops[1].name, "Relu");
+
+  EXPECT_TRUE(summarizeProfile("[]").nodes.empty());
+  EXPECT_THROW(summarizeProfile("{\"cat\": \"Node\"}"), std::runtime_error);
+  EXPECT_THROW(summarizeProfile("[{\"dur\": 1"), std::runtime_error);
+}
+
+// Test that trace points record spans of every thread only while tracing is enabled.
+TEST(TraceRecorder, RecordsSpansWhileEnabled) {
+  TraceRecorder &recorder = TraceRecorder::instance();
+  { TraceScope ignored("before start"); }
+
+  recorder.start();
+  { TraceScope span("main thread \"span\""); }
+  std::thread worker([]() {
+    TraceScope outer("worker span");
+    TraceScope inner("ended early");
+    inner.end();
+  });
+  worker.join();
+
+  // A contended lock records its wait
+  TracedMutex mutex("lock wait");
+  mutex.lock();
+  std::thread waiter([&mutex]() {
+    mutex.lock();
+    mutex.unlock();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  mutex.unlock();
+  waiter.join();
+  recorder.stop();
+  { TraceScope ignored("after stop"); }
+
+  std::ostringstream trace;
+  EXPECT_EQ(recorder.writeChromeTrace(trace), 4u);
+  std::string json = trace.str();
+  EXPECT_EQ(json.find("before start"), std::string::npos);
+  EXPECT_EQ(json.find("after stop"), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"main thread \\\"span\\\"\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"worker span\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"ended early\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"lock wait\",\"cat\":\"flutter_onnxruntime\",\"ph\":\"X\""), std::string::npos);
+
+  // Starting again drops the earlier spans
+  recorder.start();
+  recorder.stop();
+  std::ostringstream empty;
+  EXPECT_EQ(recorder.writeChromeTrace(empty), 0u);
+}
+
+// Test that a thread keeps only its latest spans once its ring buffer is full.
+TEST(TraceRecorder, OverwritesOldestSpans) {
+  TraceRecorder &recorder = TraceRecorder::instance();
+  recorder.start();
+  for (size_t i = 0; i < TraceRecorder::kSpansPerThread + 10; i++) {
+    recorder.record(i < 10 ? "oldest" : "latest", i * 1000, i * 1000 + 1500);
+  }
+  recorder.stop();
+
+  std::ostringstream trace;
+  EXPECT_EQ(recorder.writeChromeTrace(trace), TraceRecorder::kSpansPerThread);
+  EXPECT_EQ(trace.str().find("oldest"), std::string::npos);
+  EXPECT_NE(trace.str().find("\"ts\":10.000,\"dur\":1.500"), std::string::npos);
+}
+
+// Test that a full batch is dispatched at once and the rest after the window.
+TEST(MicroBatcher, DispatchesFullBatchesAndExpiredWindows) {
+  std::mutex mutex;
+  std::vector<std::vector<int>> batches;
+  {
+    MicroBatcher<int> batcher([&](uint64_t, std::vector<int> &&batch) {
+      std::lock_guard<std::mutex> lock(mutex);
+      batches.push_back(std::move(batch));
+    });
+    EXPECT_FALSE(batcher.submit(1, 0));
+
+    batcher.configure(1, std::chrono::milliseconds(20), 3);
+    for (int i = 0; i < 4; i++) {
+      EXPECT_TRUE(batcher.submit(1, int(i)));
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ASSERT_EQ(batches.size(), 1u);
+      EXPECT_EQ(batches[0], (std::vector<int>{0, 1, 2}));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[1], (std::vector<int>{3}));
+  }
+}
+
+// Test that the statistics count batches by size and that removing a key flushes it.
+TEST(MicroBatcher, TracksStatsAndFlushesOnRemove) {
+  std::atomic<int> dispatched{0};
+  MicroBatcher<int> batcher([&](uint64_t, std::vector<int> &&batch) { dispatched += static_cast<int>(batch.size()); });
+  batcher.configure(7, std::chrono::seconds(10), 2);
+  batcher.submit(7, 1);
+  batcher.submit(7, 2);
+  batcher.submit(7, 3);
+
+  BatchingStats stats = batcher.getStats(7);
+  EXPECT_EQ(stats.queue_depth, 1u);
+  EXPECT_EQ(stats.max_queue_depth, 2u);
+  EXPECT_EQ(stats.batches, 1u);
+  EXPECT_EQ(stats.requests, 2u);
+  ASSERT_EQ(stats.batch_size_histogram.size(), 3u);
+  EXPECT_EQ(stats.batch_size_histogram[2], 1u);
+
+  batcher.remove(7);
+  EXPECT_EQ(dispatched.load(), 3);
+  EXPECT_FALSE(batcher.isEnabled(7));
+}
+
+// Test that a view keeps its data and its bytes counted after its source is released, and that the shared memory is
+// counted once.
+TEST(TensorManager, ViewOutlivesReleasedSource) {
+  TensorManager manager;
+  TensorHandle source_id = manager.createTensor(std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8}, {4, 2});
+  TensorHandle view_id = manager.sliceTensor(source_id, 0, 1, 3);
+  TensorHandle reshaped_id = manager.reshapeTensor(source_id, {8});
+  EXPECT_EQ(manager.getMemoryStats().host_bytes, 8 * sizeof(float));
+  EXPECT_EQ(manager.getMemoryStats().host_bytes_by_type["float32"], 8 * sizeof(float));
+
+  EXPECT_TRUE(manager.releaseTensor(source_id));
+  EXPECT_TRUE(manager.releaseTensor(reshaped_id));
+  TensorMemoryStats stats = manager.getMemoryStats();
+  EXPECT_EQ(stats.tensor_count, 1u);
+  EXPECT_EQ(stats.host_bytes, 8 * sizeof(float));
+  EXPECT_EQ(manager.getTensorShape(view_id), std::vector<int64_t>({2, 2}));
+  const float *data = manager.getTensor(view_id)->GetTensorData<float>();
+  EXPECT_EQ(std::vector<float>(data, data + 4), std::vector<float>({3, 4, 5, 6}));
+
+  EXPECT_TRUE(manager.releaseTensor(view_id));
+  EXPECT_EQ(manager.getMemoryStats().host_bytes, 0u);
+}
+
+// Test that a tensor released while leased is retired, keeps its data until the lease is returned and is freed then.
+TEST(TensorManager, RetiresLeasedTensorUntilReturned) {
+  TensorManager manager;
+  TensorHandle tensor_id = manager.createTensor(std::vector<int32_t>{1, 2, 3}, {3});
+  {
+    TensorLease lease = manager.acquireTensor(tensor_id);
+    ASSERT_TRUE(lease);
+    EXPECT_TRUE(manager.releaseTensor(tensor_id));
+    EXPECT_FALSE(manager.acquireTensor(tensor_id));
+    EXPECT_EQ(manager.getTensor(tensor_id), nullptr);
+
+    TensorMemoryStats stats = manager.getMemoryStats();
+    EXPECT_EQ(stats.tensor_count, 0u);
+    EXPECT_EQ(stats.retired_count, 1u);
+    const int32_t *data = Ort::ConstValue(lease.get()).GetTensorData<int32_t>();
+    EXPECT_EQ(std::vector<int32_t>(data, data + 3), std::vector<int32_t>({1, 2, 3}));
+  }
+  EXPECT_EQ(manager.getMemoryStats().retired_count, 0u);
+  EXPECT_FALSE(manager.releaseTensor(tensor_id));
+}
+
+// Test that the hard memory limit rejects tensors created past it, admits them again once memory is released and
+// still stores outputs of runs.
+TEST(TensorManager, EnforcesHardMemoryLimit) {
+  TensorManager manager;
+  manager.setHardMemoryLimit(16);
+  TensorHandle first_id = manager.createTensor(std::vector<float>{1, 2, 3}, {3});
+  EXPECT_THROW(manager.createTensor(std::vector<float>{1, 2}, {2}), std::runtime_error);
+  TensorHandle fitting_id = manager.createTensor(std::vector<uint8_t>{1, 2, 3, 4}, {4});
+  EXPECT_EQ(manager.getMemoryStats().host_bytes, 16u);
+  EXPECT_EQ(manager.getMemoryStats().hard_limit_bytes, 16u);
+
+  // Views add no memory of their own, so they fit even at the limit
+  TensorHandle view_id = manager.reshapeTensor(first_id, {1, 3});
+  EXPECT_EQ(manager.getMemoryStats().host_bytes, 16u);
+
+  // Outputs of runs are stored past the limit
+  Ort::AllocatorWithDefaultOptions allocator;
+  const int64_t shape[] = {4};
+  TensorHandle output_id =
+      manager.storeTensor(Ort::Value::CreateTensor(allocator, shape, 1, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT));
+  EXPECT_EQ(manager.getMemoryStats().host_bytes, 32u);
+
+  manager.releaseTensors({first_id, view_id, output_id});
+  EXPECT_NO_THROW(manager.createTensor(std::vector<float>{1, 2}, {2}));
+  manager.releaseTensor(fitting_id);
+
+  manager.setHardMemoryLimit(0);
+  EXPECT_NO_THROW(manager.createTensor(std::vector<float>(64, 0.0f), {64}));
+}
+
+// Test that releasing several tensors counts only those that were still stored.
+TEST(TensorManager, ReleasesSeveralTensors) {
+  TensorManager manager;
+  TensorHandle first_id = manager.createTensor(std::vector<float>{1}, {1});
+  TensorHandle second_id = manager.createTensor(std::vector<float>{2}, {1});
+  TensorHandle third_id = manager.createTensor(std::vector<float>{3}, {1});
+  EXPECT_TRUE(manager.releaseTensor(second_id));
+
+  EXPECT_EQ(manager.releaseTensors({first_id, second_id, kInvalidHandle, third_id}), 2u);
+  EXPECT_EQ(manager.releaseTensors({first_id, third_id}), 0u);
+  TensorMemoryStats stats = manager.getMemoryStats();
+  EXPECT_EQ(stats.tensor_count, 0u);
+  EXPECT_EQ(stats.host_bytes, 0u);
+}
+
+// Test that quantizing a tensor and dequantizing the result gives back the values on the quantization grid.
+TEST(TensorManager, QuantizesAndDequantizesTensors) {
+  TensorManager manager;
+  TensorHandle float_id = manager.createTensor(std::vector<float>{-1.0f, 0.0f, 0.5f, 1.26f}, {2, 2});
+
+  QuantizationParams params;
+  params.scales = {0.5f};
+  params.zero_points = {10};
+  params.element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+  TensorHandle quantized_id = manager.quantizeTensor(float_id, params);
+  EXPECT_EQ(manager.getTensorType(quantized_id), "uint8");
+  EXPECT_EQ(manager.getTensorShape(quantized_id), std::vector<int64_t>({2, 2}));
+  const uint8_t *quantized = manager.getTensor(quantized_id)->GetTensorData<uint8_t>();
+  EXPECT_EQ(std::vector<uint8_t>(quantized, quantized + 4), std::vector<uint8_t>({8, 10, 11, 13}));
+
+  TensorHandle dequantized_id = manager.dequantizeTensor(quantized_id, params);
+  EXPECT_EQ(manager.getTensorType(dequantized_id), "float32");
+  const float *dequantized = manager.getTensor(dequantized_id)->GetTensorData<float>();
+  EXPECT_EQ(std::vector<float>(dequantized, dequantized + 4), std::vector<float>({-1.0f, 0.0f, 0.5f, 1.5f}));
+
+  EXPECT_THROW(manager.dequantizeTensor(float_id, params), std::runtime_error);
+}
+
+// Test that a native lease exposes the tensor bytes and keeps them alive after the tensor is released.
+TEST(NativeApi, LeaseOutlivesReleasedTensor) {
+  TensorManager manager;
+  NativeContext context{nullptr, &manager, nullptr};
+  const std::vector<float> values = {1.0f, 2.0f, 3.0f};
+  const int64_t shape[] = {3};
+  uint64_t tensor_id = fort_tensor_create(&context, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, values.data(),
+                                          values.size() * sizeof(float), shape, 1);
+  ASSERT_NE(tensor_id, kInvalidHandle);
+
+  void *lease = fort_tensor_acquire(&context, tensor_id);
+  ASSERT_NE(lease, nullptr);
+  ASSERT_EQ(fort_lease_byte_size(lease), values.size() * sizeof(float));
+
+  EXPECT_EQ(fort_tensor_release(&context, tensor_id), 1);
+  EXPECT_EQ(fort_tensor_acquire(&context, tensor_id), nullptr);
+
+  const float *data = static_cast<const float *>(fort_lease_data(lease));
+  EXPECT_EQ(std::vector<float>(data, data + values.size()), values);
+  fort_lease_release(lease);
+
+  TensorHandle string_id = manager.createStringTensor({"a"}, {1});
+  EXPECT_EQ(fort_tensor_acquire(&context, string_id), nullptr);
+}
+
+// Test that a size mismatch fails without throwing across the C ABI.
+TEST(NativeApi, CreateReportsErrors) {
+  TensorManager manager;
+  NativeContext context{nullptr, &manager, nullptr};
+  const float value = 1.0f;
+  const int64_t shape[] = {2};
+  EXPECT_EQ(fort_tensor_create(&context, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &value, sizeof(value), shape, 1),
+            kInvalidHandle);
+  EXPECT_STRNE(fort_last_error(), "");
+}
+
+// Test that the identity model behind device-to-host copies loads and passes a tensor through unchanged.
+TEST(IdentityModel, PassesTensorThrough) {
+  Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "IdentityModelTest");
+  std::string model = buildIdentityModel(ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  Ort::Session session(env, model.data(), model.size(), Ort::SessionOptions());
+
+  std::vector<float> values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const int64_t shape[] = {2, 3};
+  Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, values.data(), values.size(), shape, 2);
+
+  const char *input_names[] = {kIdentityInputName};
+  const char *output_names[] = {kIdentityOutputName};
+  std::vector<Ort::Value> outputs = session.Run(Ort::RunOptions(), input_names, &input, 1, output_names, 1);
+  ASSERT_EQ(outputs.size(), 1u);
+  EXPECT_EQ(outputs[0].GetTensorTypeAndShapeInfo().GetShape(), std::vector<int64_t>({2, 3}));
+  const float *data = outputs[0].GetTensorData<float>();
+  EXPECT_EQ(std::vector<float>(data, data + values.size()), values);
+}
@@ -26,9 +26,17 @@ enum OrtError: Error {
 // swiftlint:disable:next type_body_length
 public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
   private var sessions = [String: ORTSession]()
+  // Concurrent queue of each session, by session ID. Runs go on the queue of their session instead of the channel's
+  // task queue, so that tensor calls and runs of other sessions are not stuck behind them; closing a session is a
+  // barrier that waits for its runs in flight.
+  private var sessionQueues = [String: DispatchQueue]()
   private var env: ORTEnv?
   // Lock to serialize method handler and cleanup to prevent use-after-close races
   private let lock = NSLock()
+  // Whether new session and value IDs are sent to Dart as integer handles instead of UUID strings
+  private var integerHandles = false
+  // Integer handles come from a counter and are never reused, so a stale handle cannot reach a newer object
+  private var nextHandle: Int64 = 1
 
   public static func register(with registrar: FlutterPluginRegistrar) {
     let messenger = registrar.messenger
@@ -69,6 +77,7 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
 
     // Clear all sessions (they depend on env)
     sessions.removeAll()
+    sessionQueues.removeAll()
 
     // Release the environment
     env = nil
@@ -100,11 +109,25 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
       Reference: https://onnxruntime.ai/docs/api/objectivec/Classes/ORTSession.html
     */
     case "createSession":
-      handleCreateSession(call: call, result: result)
+      // Loading a model, and compiling it for CoreML in particular, can take seconds
+      DispatchQueue.global(qos: .userInitiated).async {
+        self.handleCreateSession(call: call, result: result)
+      }
     case "getAvailableProviders":
       handleGetAvailableProviders(call: call, result: result)
     case "runInference":
-      handleRunInference(call: call, result: result)
+      dispatchRunInference(call: call, result: result)
+    case "setInferenceThreads":
+      // Runs go on a concurrent queue of their session, whose threads GCD manages
+      result(nil)
+    case "setIntegerHandles":
+      guard let args = call.arguments as? [String: Any], let enabled = args["enabled"] as? Bool else {
+        result(FlutterError(code: "INVALID_ARG", message: "Enabled must be a boolean", details: nil))
+        return
+      }
+      // Only changes how new IDs are generated; both forms are always accepted from Dart
+      integerHandles = enabled
+      result(nil)
     case "closeSession":
       handleCloseSession(call: call, result: result)
     case "getMetadata":
@@ -121,11 +144,34 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
       handleGetOrtValueData(call, result: result)
     case "releaseOrtValue":
       handleReleaseOrtValue(call, result: result)
+    case "releaseOrtValues":
+      handleReleaseOrtValues(call, result: result)
     default:
       result(FlutterMethodNotImplemented)
     }
   }
 
+  // Run a body with the lock held, for work that runs outside of handle(_:result:)
+  private func locked<T>(_ body: () throws -> T) rethrows -> T {
+    lock.lock()
+    defer { lock.unlock() }
+    return try body()
+  }
+
+  // Read the options of the CoreML provider from the providerOptions map sent by Dart, e.g. MLComputeUnits,
+  // EnableOnSubgraphs and ModelCacheDirectory, which ONNX Runtime parses from strings
+  private func coreMLProviderOptions(_ options: [String: Any]) -> [String: String] {
+    guard let allOptions = options["providerOptions"] as? [String: Any],
+          let coreMLOptions = allOptions["CORE_ML"] as? [String: Any] else {
+      return [:]
+    }
+    var providerOptions: [String: String] = [:]
+    for (key, value) in coreMLOptions {
+      providerOptions[key] = "\(value)"
+    }
+    return providerOptions
+  }
+
   // swiftlint:disable:next cyclomatic_complexity
   private func handleCreateSession(call: FlutterMethodCall, result: @escaping FlutterResult) {
     guard let args = call.arguments as? [String: Any],
@@ -161,7 +207,16 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
               continue
             case "CORE_ML":
               do {
-                try sessionOptions.appendCoreMLExecutionProvider()
+                let coreMLOptions = coreMLProviderOptions(options)
+                if coreMLOptions.isEmpty {
+                  try sessionOptions.appendCoreMLExecutionProvider()
+                } else {
+                  // Create the model cache directory with its parents, so that any path in the app cache can be given
+                  if let cacheDirectory = coreMLOptions["ModelCacheDirectory"] {
+                    try FileManager.default.createDirectory(atPath: cacheDirectory, withIntermediateDirectories: true)
+                  }
+                  try sessionOptions.appendCoreMLExecutionProvider(withOptionsV2: coreMLOptions)
+                }
               } catch {
                 result(FlutterError(code: "SESSION_OPTIONS_ERROR",
                   message: "Failed to append CoreML execution provider: \(error.localizedDescription)", details: nil))
@@ -191,14 +246,19 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
       }
 
       // Create session from file path
-      guard let safeEnv = env else {
+      guard let safeEnv = locked({ env }) else {
         result(FlutterError(code: "ENV_NOT_INITIALIZED", message: "ONNX Runtime environment not initialized", details: nil))
         return
       }
 
       let session = try ORTSession(env: safeEnv, modelPath: modelPath, sessionOptions: sessionOptions)
-      let sessionId = UUID().uuidString
-      sessions[sessionId] = session
+      let sessionId = locked { () -> String in
+        let sessionId = newId()
+        sessions[sessionId] = session
+        sessionQueues[sessionId] = DispatchQueue(
+          label: "flutter_onnxruntime.session.\(sessionId)", qos: .userInitiated, attributes: .concurrent)
+        return sessionId
+      }
 
       // Get input and output names
       var inputNames: [String] = []
@@ -215,7 +275,7 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
       }
 
       let responseMap: [String: Any] = [
-        "sessionId": sessionId,
+        "sessionId": idToDart(sessionId),
         "inputNames": inputNames,
         "outputNames": outputNames
       ]
@@ -239,10 +299,27 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
     result(providers)
   }
 
-  // swiftlint:disable:next cyclomatic_complexity
+  // Queue a run on the queue of its session; called from handle(_:result:) with the lock held
+  private func dispatchRunInference(call: FlutterMethodCall, result: @escaping FlutterResult) {
+    guard let args = call.arguments as? [String: Any],
+          let sessionId = idArgument(args, "sessionId"),
+          args["inputs"] is [String: Any] else {
+      result(FlutterError(code: "INVALID_ARG", message: "Missing required arguments", details: nil))
+      return
+    }
+    guard let queue = sessionQueues[sessionId] else {
+      result(FlutterError(code: "INVALID_SESSION", message: "Session not found", details: nil))
+      return
+    }
+    queue.async {
+      self.handleRunInference(call: call, result: result)
+    }
+  }
+
+  // swiftlint:disable:next cyclomatic_complexity function_body_length
   private func handleRunInference(call: FlutterMethodCall, result: @escaping FlutterResult) {
     guard let args = call.arguments as? [String: Any],
-          let sessionId = args["sessionId"] as? String,
+          let sessionId = idArgument(args, "sessionId"),
           let inputs = args["inputs"] as? [String: Any] else {
       result(FlutterError(code: "INVALID_ARG", message: "Missing required arguments", details: nil))
       return
@@ -277,31 +354,35 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
         try runOptions?.setLogSeverityLevel(loggingLevel)
       }
 
-      // Get session
-      guard let session = sessions[sessionId] else {
-        throw OrtError.flutterError(FlutterError(code: "INVALID_SESSION", message: "Session not found", details: nil))
-      }
+      // Get the session and inputs; the run holds references to them, so releasing them meanwhile is safe
+      let (session, ortInputs) = try locked { () throws -> (ORTSession, [String: ORTValue]) in
+        guard let session = sessions[sessionId] else {
+          throw OrtError.flutterError(FlutterError(code: "INVALID_SESSION", message: "Session not found", details: nil))
+        }
 
-      // Process inputs - validate OrtValue references directly here
-      var ortInputs: [String: ORTValue] = [:]
+        // Process inputs - validate OrtValue references directly here
+        var ortInputs: [String: ORTValue] = [:]
 
-      for (name, value) in inputs {
-        // Only process OrtValue references (sent as dictionary with valueId)
-        if let valueDict = value as? [String: Any], let valueId = valueDict["valueId"] as? String {
-          if let existingValue = ortValues[valueId] {
-            ortInputs[name] = existingValue
+        for (name, value) in inputs {
+          // Only process OrtValue references (sent as dictionary with valueId)
+          if let valueDict = value as? [String: Any], let valueId = idArgument(valueDict, "valueId") {
+            if let existingValue = ortValues[valueId] {
+              ortInputs[name] = existingValue
+            } else {
+              throw OrtError.flutterError(FlutterError(code: "INVALID_ORT_VALUE", message: "OrtValue with ID \(valueId) not found", details: nil))
+            }
           } else {
-            throw OrtError.flutterError(FlutterError(code: "INVALID_ORT_VALUE", message: "OrtValue with ID \(valueId) not found", details: nil))
+            throw OrtError.flutterError(FlutterError(code: "INVALID_INPUT_FORMAT",
+              message: "Input for '\(name)' must be an OrtValue reference with valueId",
+              details: nil))
           }
-        } else {
-          throw OrtError.flutterError(FlutterError(code: "INVALID_INPUT_FORMAT",
-            message: "Input for '\(name)' must be an OrtValue reference with valueId",
-            details: nil))
         }
+        return (session, ortInputs)
       }
 
-      // Get output names
-      let outputNames = try session.outputNames()
+      // Compute only the requested outputs, or all outputs if no names are given
+      let requestedNames = args["outputNames"] as? [String] ?? []
+      let outputNames = requestedNames.isEmpty ? try session.outputNames() : requestedNames
 
       // Run inference with prepared output containers and run options if available
       let outputs = try session.run(withInputs: ortInputs, outputNames: Set(outputNames), runOptions: runOptions)
@@ -309,20 +390,23 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
       // store outputs in ortValues dictionary and return metadata in Flutter format
       var flutterOutputs: [String: Any] = [:]
       for (outputName, outputTensor) in outputs {
-        let valueId = UUID().uuidString
-        ortValues[valueId] = outputTensor
+        let valueId = locked { () -> String in
+          let valueId = newId()
+          ortValues[valueId] = outputTensor
+          return valueId
+        }
 
         // Check if output is float16 or bool (ObjC enum doesn't support them, use C++ API)
         if Float16Helper.isFloat16Tensor(outputTensor) || BoolHelper.isBoolTensor(outputTensor) {
           let shapeArr = try Float16Helper.getTensorShape(outputTensor)
           let shape = shapeArr.map { Int(truncating: $0) }
           let typeName = Float16Helper.getElementTypeName(outputTensor)
-          flutterOutputs[outputName] = [valueId, typeName, shape]
+          flutterOutputs[outputName] = [idToDart(valueId), typeName, shape]
         } else {
           let tensorInfo = try outputTensor.tensorTypeAndShapeInfo()
           let shape = tensorInfo.shape.map { Int(truncating: $0) }
           let typeName = _getDataTypeName(from: tensorInfo.elementType)
-          flutterOutputs[outputName] = [valueId, typeName, shape]
+          flutterOutputs[outputName] = [idToDart(valueId), typeName, shape]
         }
       }
       // Return result
@@ -336,21 +420,31 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
 
   private func handleCloseSession(call: FlutterMethodCall, result: @escaping FlutterResult) {
     guard let args = call.arguments as? [String: Any],
-          let sessionId = args["sessionId"] as? String else {
+          let sessionId = idArgument(args, "sessionId") else {
       result(FlutterError(code: "INVALID_ARG", message: "Session ID is required", details: nil))
       return
     }
 
-    if sessions.removeValue(forKey: sessionId) != nil {
-      result(nil)
-    } else {
+    guard let session = sessions.removeValue(forKey: sessionId) else {
       result(FlutterError(code: "INVALID_SESSION", message: "Session not found", details: nil))
+      return
+    }
+    guard let queue = sessionQueues.removeValue(forKey: sessionId) else {
+      result(nil)
+      return
+    }
+
+    // Reply once the runs in flight have finished; the session is released with the last of them
+    queue.async(flags: .barrier) {
+      withExtendedLifetime(session) {
+        result(nil)
+      }
     }
   }
 
   private func handleGetMetadata(call: FlutterMethodCall, result: @escaping FlutterResult) {
     guard let args = call.arguments as? [String: Any],
-          let sessionId = args["sessionId"] as? String else {
+          let sessionId = idArgument(args, "sessionId") else {
       result(FlutterError(code: "INVALID_ARG", message: "Session ID is required", details: nil))
       return
     }
@@ -366,7 +460,7 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
 
   private func handleGetInputInfo(call: FlutterMethodCall, result: @escaping FlutterResult) {
     guard let args = call.arguments as? [String: Any],
-          let sessionId = args["sessionId"] as? String else {
+          let sessionId = idArgument(args, "sessionId") else {
       result(FlutterError(code: "INVALID_ARG", message: "Session ID is required", details: nil))
       return
     }
@@ -394,7 +488,7 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
 
   private func handleGetOutputInfo(call: FlutterMethodCall, result: @escaping FlutterResult) {
     guard let args = call.arguments as? [String: Any],
-          let sessionId = args["sessionId"] as? String else {
+          let sessionId = idArgument(args, "sessionId") else {
       result(FlutterError(code: "INVALID_ARG", message: "Session ID is required", details: nil))
       return
     }
@@ -420,6 +514,36 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
     }
   }
 
+  // MARK: - IDs
+
+  // Generate the ID of a new session or OrtValue
+  private func newId() -> String {
+    guard integerHandles else {
+      return UUID().uuidString
+    }
+    defer { nextHandle += 1 }
+    return String(nextHandle)
+  }
+
+  // Convert an ID to the form sent to Dart
+  private func idToDart(_ id: String) -> Any {
+    if integerHandles, let handle = Int64(id) {
+      return handle
+    }
+    return id
+  }
+
+  // Read an ID sent by Dart, which is either an integer handle or a string ID
+  private func idArgument(_ args: [String: Any], _ key: String) -> String? {
+    if let id = args[key] as? String {
+      return id
+    }
+    if let handle = args[key] as? NSNumber {
+      return handle.stringValue
+    }
+    return nil
+  }
+
   // MARK: - OrtValue Management
 
   private var ortValues: [String: ORTValue] = [:]
@@ -443,6 +567,8 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
 
       switch sourceType {
       case "float32":
+        // Tensors use their NSMutableData in place, so typed data sent by Dart is copied into one once, without
+        // intermediate Swift arrays
         if let floatArray = data as? [Float] {
           // Create float tensor
           let data = NSMutableData(bytes: floatArray, length: floatArray.count * MemoryLayout<Float>.stride)
@@ -472,17 +598,16 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
             // Could be Float64 data, convert to Float32
             let float64Count = typedData.data.count / 8
 
-            var float32Array = [Float](repeating: 0.0, count: float64Count)
-
-            // Extract Float64 values and convert to Float32
+            // Extract Float64 values and convert them to Float32 in the tensor's buffer
+            let float32Data = NSMutableData(length: float64Count * MemoryLayout<Float>.stride) ?? NSMutableData()
+            let float32Buffer = float32Data.mutableBytes.bindMemory(to: Float.self, capacity: float64Count)
             typedData.data.withUnsafeBytes { (buffer: UnsafeRawBufferPointer) in
               let float64Buffer = buffer.bindMemory(to: Float64.self)
               for index in 0..<float64Count {
-                float32Array[index] = Float(float64Buffer[index])
+                float32Buffer[index] = Float(float64Buffer[index])
               }
             }
 
-            let float32Data = NSMutableData(bytes: float32Array, length: float32Array.count * MemoryLayout<Float>.stride)
             tensor = try ORTValue(tensorData: float32Data, elementType: .float, shape: shapeNumbers)
           } else {
             result(FlutterError(code: "INVALID_DATA_TYPE",
@@ -508,17 +633,7 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
         } else if let typedData = data as? FlutterStandardTypedData {
           // Handle FlutterStandardTypedData for Int32
           if typedData.data.count % 4 == 0 {
-            let int32Count = typedData.data.count / 4
-            var int32Array = [Int32](repeating: 0, count: int32Count)
-
-            typedData.data.withUnsafeBytes { (buffer: UnsafeRawBufferPointer) in
-              let int32Buffer = buffer.bindMemory(to: Int32.self)
-              for index in 0..<int32Count {
-                int32Array[index] = int32Buffer[index]
-              }
-            }
-
-            let int32Data = NSMutableData(bytes: int32Array, length: int32Array.count * MemoryLayout<Int32>.stride)
+            let int32Data = NSMutableData(data: typedData.data)
             tensor = try ORTValue(tensorData: int32Data, elementType: .int32, shape: shapeNumbers)
           } else {
             result(FlutterError(code: "INVALID_DATA_TYPE",
@@ -544,17 +659,7 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
         } else if let typedData = data as? FlutterStandardTypedData {
           // Handle FlutterStandardTypedData for Int64
           if typedData.data.count % 8 == 0 {
-            let int64Count = typedData.data.count / 8
-            var int64Array = [Int64](repeating: 0, count: int64Count)
-
-            typedData.data.withUnsafeBytes { (buffer: UnsafeRawBufferPointer) in
-              let int64Buffer = buffer.bindMemory(to: Int64.self)
-              for index in 0..<int64Count {
-                int64Array[index] = int64Buffer[index]
-              }
-            }
-
-            let int64Data = NSMutableData(bytes: int64Array, length: int64Array.count * MemoryLayout<Int64>.stride)
+            let int64Data = NSMutableData(data: typedData.data)
             tensor = try ORTValue(tensorData: int64Data, elementType: .int64, shape: shapeNumbers)
           } else {
             result(FlutterError(code: "INVALID_DATA_TYPE",
@@ -616,6 +721,11 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
 
       case "float16":
         // Float16 tensors: accept float32 data and convert to float16 via C++ API
+        if let typedData = data as? FlutterStandardTypedData, typedData.type == .float32 {
+          // Convert straight from the bytes sent by Dart, without boxing each value
+          tensor = try Float16Helper.createFloat16Tensor(fromFloat32Data: typedData.data, shape: shapeNumbers)
+          break
+        }
         var float32Numbers: [NSNumber] = []
         if let doubleArray = data as? [Double] {
           float32Numbers = doubleArray.map { NSNumber(value: Float($0)) }
@@ -671,12 +781,12 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
       }
 
       // Generate unique ID for the tensor
-      let valueId = UUID().uuidString
+      let valueId = newId()
       ortValues[valueId] = tensor
 
       // Return tensor information
       let tensorInfo: [String: Any] = [
-        "valueId": valueId,
+        "valueId": idToDart(valueId),
         "dataType": sourceType,
         "shape": shape
       ]
@@ -690,7 +800,7 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
   // swiftlint:disable:next cyclomatic_complexity function_body_length
   private func handleConvertOrtValue(_ call: FlutterMethodCall, result: @escaping FlutterResult) {
     guard let args = call.arguments as? [String: Any],
-          let valueId = args["valueId"] as? String,
+          let valueId = idArgument(args, "valueId"),
           let targetType = args["targetType"] as? String else {
       result(FlutterError(code: "INVALID_ARG", message: "Missing required arguments", details: nil))
       return
@@ -725,12 +835,12 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
       // If source and target types are the same, just clone the tensor
       if sourceType == targetType {
         // Create a new tensor ID and store reference
-        let newValueId = UUID().uuidString
+        let newValueId = newId()
         ortValues[newValueId] = tensor
 
         // Return tensor information
         let resultInfo: [String: Any] = [
-          "valueId": newValueId,
+          "valueId": idToDart(newValueId),
           "dataType": targetType,
           "shape": shape
         ]
@@ -750,9 +860,9 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
         let newData = NSMutableData(bytes: floatArray, length: floatArray.count * MemoryLayout<Float>.stride)
         newTensor = try ORTValue(tensorData: newData, elementType: .float, shape: shape.map { NSNumber(value: $0) })
 
-        let newValueId = UUID().uuidString
+        let newValueId = newId()
         ortValues[newValueId] = newTensor
-        result(["valueId": newValueId, "dataType": targetType, "shape": shape] as [String: Any])
+        result(["valueId": idToDart(newValueId), "dataType": targetType, "shape": shape] as [String: Any])
         return
       }
 
@@ -766,9 +876,9 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
         let fp16Tensor = try Float16Helper.createFloat16Tensor(fromFloat32: float32Numbers,
                                                                shape: shape.map { NSNumber(value: $0) })
 
-        let newValueId = UUID().uuidString
+        let newValueId = newId()
         ortValues[newValueId] = fp16Tensor
-        result(["valueId": newValueId, "dataType": targetType, "shape": shape] as [String: Any])
+        result(["valueId": idToDart(newValueId), "dataType": targetType, "shape": shape] as [String: Any])
         return
       }
 
@@ -820,9 +930,9 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
           return
         }
 
-        let newValueId = UUID().uuidString
+        let newValueId = newId()
         ortValues[newValueId] = converted
-        result(["valueId": newValueId, "dataType": targetType, "shape": shape] as [String: Any])
+        result(["valueId": idToDart(newValueId), "dataType": targetType, "shape": shape] as [String: Any])
         return
       }
 
@@ -838,9 +948,9 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
         let bytes = Data(bytes: srcPtr.bytes, count: elementCount)
         let boolTensor = try BoolHelper.createBoolTensor(fromBytes: bytes, shape: shape.map { NSNumber(value: $0) })
 
-        let newValueId = UUID().uuidString
+        let newValueId = newId()
         ortValues[newValueId] = boolTensor
-        result(["valueId": newValueId, "dataType": "bool", "shape": shape] as [String: Any])
+        result(["valueId": idToDart(newValueId), "dataType": "bool", "shape": shape] as [String: Any])
         return
       }
 
@@ -975,12 +1085,12 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
       }
 
       // Generate unique ID for the new tensor
-      let newValueId = UUID().uuidString
+      let newValueId = newId()
       ortValues[newValueId] = newTensor
 
       // Return tensor information
       let resultInfo: [String: Any] = [
-        "valueId": newValueId,
+        "valueId": idToDart(newValueId),
         "dataType": targetType,
         "shape": shape
       ]
@@ -994,7 +1104,7 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
   // swiftlint:disable:next cyclomatic_complexity
   private func handleGetOrtValueData(_ call: FlutterMethodCall, result: @escaping FlutterResult) {
     guard let args = call.arguments as? [String: Any],
-          let valueId = args["valueId"] as? String else {
+          let valueId = idArgument(args, "valueId") else {
       result(FlutterError(code: "INVALID_ARG", message: "Missing valueId", details: nil))
       return
     }
@@ -1123,7 +1233,7 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
 
   private func handleReleaseOrtValue(_ call: FlutterMethodCall, result: @escaping FlutterResult) {
     guard let args = call.arguments as? [String: Any],
-          let valueId = args["valueId"] as? String else {
+          let valueId = idArgument(args, "valueId") else {
       result(FlutterError(code: "INVALID_ARG", message: "Missing value ID", details: nil))
       return
     }
@@ -1134,6 +1244,21 @@ public class FlutterOnnxruntimePlugin: NSObject, FlutterPlugin {
     result(nil)
   }
 
+  private func handleReleaseOrtValues(_ call: FlutterMethodCall, result: @escaping FlutterResult) {
+    guard let args = call.arguments as? [String: Any],
+          let valueIds = args["valueIds"] as? [Any] else {
+      result(FlutterError(code: "INVALID_ARG", message: "Missing value IDs", details: nil))
+      return
+    }
+
+    // Unknown IDs are skipped, as in handleReleaseOrtValue
+    for valueId in valueIds {
+      ortValues.removeValue(forKey: "\(valueId)")
+    }
+
+    result(nil)
+  }
+
   // Helper function to convert ORTTensorElementDataType to string
   private func _getDataTypeName(from type: ORTTensorElementDataType) -> String {
     switch type {
@@ -25,6 +25,12 @@ NS_ASSUME_NONNULL_BEGIN
                                                 shape:(NSArray<NSNumber *> *)shape
                                                 error:(NSError **)error;
 
+/// Creates a float16 ORTValue from the bytes of float32 values, such as a Float32List
+/// sent by Dart, converting them without boxing each value in an NSNumber.
++ (nullable ORTValue *)createFloat16TensorFromFloat32Data:(NSData *)float32Data
+                                                    shape:(NSArray<NSNumber *> *)shape
+                                                    error:(NSError **)error;
+
 /// Creates a float16 ORTValue from raw UInt16 data (already in float16 format).
 + (nullable ORTValue *)createFloat16TensorFromRawData:(NSData *)rawData
                                                 shape:(NSArray<NSNumber *> *)shape
@@ -56,6 +56,12 @@ class _FileValidatingPlatform extends FlutterOnnxruntimePlatform with MockPlatfo
     };
   }
 
+  /// Like Android and iOS, which have no in-memory handler.
+  @override
+  Future<Map<String, dynamic>> createSessionFromBuffer(Uint8List modelData, {Map<String, dynamic>? sessionOptions}) {
+    throw MissingPluginException();
+  }
+
   static bool _bytesEqual(List<int> a, List<int> b) {
     if (a.length != b.length) return false;
     for (var i = 0; i < a.length; i++) {
@@ -175,4 +181,14 @@ void main() {
       expect(await leftoverTmp.exists(), isFalse);
     });
   });
+
+  group('createSessionFromBuffer', () {
+    test('falls back to a temporary file that is deleted afterwards', () async {
+      final session = await OnnxRuntime().createSessionFromBuffer(assetBytes);
+
+      expect(session.id, 'session_ok');
+      expect(fakeOrt.observedFileSizes, [assetBytes.length]);
+      expect(await tempDir.list().isEmpty, isTrue);
+    });
+  });
 }
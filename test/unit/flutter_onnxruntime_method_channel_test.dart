@@ -4,6 +4,8 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:typed_data';
+
 import 'package:flutter/services.dart';
 import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_test/flutter_test.dart';
@@ -276,6 +278,68 @@ void main() {
       expect(result['output1'][2], [2]);
     });
 
+    test('runBatch sends one inputs map per request', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return [
+          {
+            'output1': ['out_1', 'float32', [1]],
+          },
+          {
+            'output1': ['out_2', 'float32', [1]],
+          },
+        ];
+      });
+
+      final first = OrtValue.fromMap({'valueId': 'test_value_1', 'dataType': 'float32', 'shape': [1]});
+      final second = OrtValue.fromMap({'valueId': 'test_value_2', 'dataType': 'float32', 'shape': [1]});
+      final results = await platform.runBatch('test_session_id', [
+        {'input1': first},
+        {'input1': second},
+      ]);
+
+      expect(capturedCall?.method, 'runBatch');
+      final args = capturedCall?.arguments as Map;
+      expect(args['sessionId'], 'test_session_id');
+      expect(args['inputs'], [
+        {
+          'input1': {'valueId': 'test_value_1'},
+        },
+        {
+          'input1': {'valueId': 'test_value_2'},
+        },
+      ]);
+      expect(results.length, 2);
+      expect(results[1]['output1'][0], 'out_2');
+    });
+
+    test('runBatch falls back to runInference when the platform has no batch path', () async {
+      final methods = <String>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        methods.add(methodCall.method);
+        if (methodCall.method == 'runBatch') {
+          throw MissingPluginException();
+        }
+        return {
+          'output1': ['out', 'float32', [1]],
+        };
+      });
+
+      final value = OrtValue.fromMap({'valueId': 'test_value_1', 'dataType': 'float32', 'shape': [1]});
+      final results = await platform.runBatch('test_session_id', [
+        {'input1': value},
+        {'input1': value},
+      ]);
+
+      expect(methods, ['runBatch', 'runInference', 'runInference']);
+      expect(results.length, 2);
+    });
+
     test('getAvailableProviders returns list of providers', () async {
       // Set up a mock implementation for the method channel
       TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
@@ -294,5 +358,758 @@ void main() {
       expect(providers.length, 3);
       expect(providers, containsAll(['CPU', 'CUDA', 'CoreML']));
     });
+
+    test('setInferenceThreads sends the thread count', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return null;
+      });
+
+      await platform.setInferenceThreads(4);
+
+      expect(capturedCall?.method, 'setInferenceThreads');
+      expect(capturedCall?.arguments, {'numThreads': 4});
+    });
+
+    test('queue statistics and cancelling low-priority runs degrade on platforms without priority queues', () async {
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        return methodCall.method == 'cancelLowPriorityRuns' ? 3 : {'low': {'queued': 1}};
+      });
+
+      expect(await platform.cancelLowPriorityRuns(), 3);
+      expect((await platform.getQueueStats())['low'], {'queued': 1});
+
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      expect(await platform.cancelLowPriorityRuns(), 0);
+      expect(() => platform.getQueueStats(), throwsUnsupportedError);
+    });
+
+    test('cancelRun sends the run tag and reports false on platforms that cannot cancel', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return true;
+      });
+
+      expect(await platform.cancelRun('run_7'), true);
+      expect(capturedCall?.method, 'cancelRun');
+      expect(capturedCall?.arguments, {'runTag': 'run_7'});
+
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      expect(await platform.cancelRun('run_7'), false);
+    });
+
+    test('integer handles are returned as String IDs and sent back as ints', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        if (methodCall.method == 'createOrtValue') {
+          return {'valueId': 4294967297, 'dataType': 'float32', 'shape': [1]};
+        }
+        return null;
+      });
+
+      await platform.setIntegerHandles(true);
+      final value = OrtValue.fromMap(await platform.createOrtValue('float32', [1.0], [1]));
+      await platform.releaseOrtValue(value.id);
+
+      expect(calls[0].method, 'setIntegerHandles');
+      expect(calls[0].arguments, {'enabled': true});
+      expect(value.id, '4294967297');
+      expect(calls[2].arguments, {'valueId': 4294967297});
+    });
+
+    test('createImageTensor sends the image and preprocessing options', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return {
+          'valueId': 'tensor_1',
+          'dataType': 'float32',
+          'shape': [1, 2, 2, 3],
+        };
+      });
+
+      final pixels = Uint8List(2 * 2 * 3);
+      final result = await platform.createImageTensor(
+        pixels,
+        format: 'rgb',
+        width: 2,
+        height: 2,
+        layout: 'nhwc',
+        dataType: 'float32',
+      );
+
+      expect(capturedCall?.method, 'createImageTensor');
+      expect(capturedCall?.arguments, {
+        'data': pixels,
+        'format': 'rgb',
+        'width': 2,
+        'height': 2,
+        'targetWidth': null,
+        'targetHeight': null,
+        'mean': null,
+        'std': null,
+        'layout': 'nhwc',
+        'dataType': 'float32',
+      });
+      expect(result['shape'], [1, 2, 2, 3]);
+    });
+
+    test('createSessionFromBuffer and createSessionFromMappedFile send the model and options', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        return {
+          'sessionId': 'session_1',
+          'inputNames': ['input'],
+          'outputNames': ['output'],
+        };
+      });
+
+      final modelData = Uint8List.fromList([8, 1, 18, 0]);
+      final result = await platform.createSessionFromBuffer(modelData, sessionOptions: {'intraOpNumThreads': 2});
+      await platform.createSessionFromMappedFile('data/flutter_assets/model.onnx');
+
+      expect(calls[0].method, 'createSessionFromBuffer');
+      expect(calls[0].arguments, {
+        'modelData': modelData,
+        'sessionOptions': {'intraOpNumThreads': 2},
+      });
+      expect(result['sessionId'], 'session_1');
+      expect(calls[1].method, 'createSession');
+      expect(calls[1].arguments, {'modelPath': 'data/flutter_assets/model.onnx', 'sessionOptions': {}, 'mapModel': true});
+    });
+
+    test('configureSessionCache sends the limits and tolerates platforms without a cache', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return null;
+      });
+
+      await platform.configureSessionCache(maxSessions: 4, maxBytes: 0);
+
+      expect(capturedCall?.method, 'configureSessionCache');
+      expect(capturedCall?.arguments, {'maxSessions': 4, 'maxBytes': 0});
+
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      await platform.configureSessionCache(maxSessions: 0, maxBytes: 0);
+    });
+
+    test('configureThreadPools sends the pool settings and tolerates platforms without shared pools', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return null;
+      });
+
+      await platform.configureThreadPools(
+        intraOpNumThreads: 4,
+        interOpNumThreads: 1,
+        allowSpinning: false,
+        intraOpThreadAffinity: '1;2;3',
+      );
+
+      expect(capturedCall?.method, 'configureThreadPools');
+      expect(capturedCall?.arguments, {
+        'intraOpNumThreads': 4,
+        'interOpNumThreads': 1,
+        'allowSpinning': false,
+        'intraOpThreadAffinity': '1;2;3',
+      });
+
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      await platform.configureThreadPools(intraOpNumThreads: 0, interOpNumThreads: 0);
+    });
+
+    test('configureSharedArena sends the arena settings and tolerates platforms without one', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return null;
+      });
+
+      await platform.configureSharedArena(maxBytes: 1 << 28, extendStrategy: 'sameAsRequested');
+
+      expect(capturedCall?.method, 'configureSharedArena');
+      expect(capturedCall?.arguments, {'maxBytes': 1 << 28, 'extendStrategy': 'sameAsRequested'});
+
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      await platform.configureSharedArena();
+    });
+
+    test('configureBatching and getBatchingStats send the session and settings', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        if (methodCall.method == 'getBatchingStats') {
+          return {
+            'queueDepth': 1,
+            'maxQueueDepth': 4,
+            'requests': 6,
+            'batches': 2,
+            'batchSizeHistogram': [0, 0, 1, 0, 1],
+          };
+        }
+        return null;
+      });
+
+      await platform.configureBatching('test_session_id', windowMicros: 2000, maxBatchSize: 4);
+      final stats = OrtBatchingStats.fromMap(await platform.getBatchingStats('test_session_id'));
+
+      expect(calls[0].method, 'configureBatching');
+      expect(calls[0].arguments, {'sessionId': 'test_session_id', 'windowMicros': 2000, 'maxBatchSize': 4});
+      expect(calls[1].arguments, {'sessionId': 'test_session_id'});
+      expect(stats.maxQueueDepth, 4);
+      expect(stats.averageBatchSize, 3);
+      expect(stats.batchSizeHistogram, [0, 0, 1, 0, 1]);
+    });
+
+    test('getSessionStats reads the session counters and tolerates platforms without stats', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return {
+          'runs': 4,
+          'runMicros': 8000,
+          'p50Micros': 1900,
+          'p90Micros': 2500,
+          'p99Micros': 2600,
+          'calls': 4,
+          'inputMicros': 200,
+          'outputMicros': 600,
+          'bytesIn': 4096,
+          'bytesOut': 40,
+        };
+      });
+
+      final stats = OrtSessionStats.fromMap(await platform.getSessionStats('test_session_id'));
+
+      expect(capturedCall?.method, 'getSessionStats');
+      expect(capturedCall?.arguments, {'sessionId': 'test_session_id'});
+      expect(stats.runs, 4);
+      expect(stats.p99, const Duration(microseconds: 2600));
+      expect(stats.averageRunTime, const Duration(milliseconds: 2));
+      expect(stats.averageOverhead, const Duration(microseconds: 200));
+      expect(stats.bytesIn, 4096);
+
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      expect(OrtSessionStats.fromMap(await platform.getSessionStats('test_session_id')).runs, 0);
+    });
+
+    test('endProfiling returns the trace path and kernel times', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return {
+          'profilePath': '/tmp/onnxruntime_profile_2026.json',
+          'totalMicros': 650,
+          'nodes': [
+            {'name': 'conv2', 'opType': 'Conv', 'provider': 'CPUExecutionProvider', 'totalMicros': 350, 'calls': 2},
+            {'name': 'conv1', 'opType': 'Conv', 'provider': 'CPUExecutionProvider', 'totalMicros': 300, 'calls': 1},
+          ],
+          'ops': [
+            {'name': 'Conv', 'opType': 'Conv', 'provider': 'CPUExecutionProvider', 'totalMicros': 650, 'calls': 3},
+          ],
+        };
+      });
+
+      final profile = OrtProfile.fromMap(await platform.endProfiling('test_session_id'));
+
+      expect(capturedCall?.method, 'endProfiling');
+      expect(capturedCall?.arguments, {'sessionId': 'test_session_id'});
+      expect(profile.path, '/tmp/onnxruntime_profile_2026.json');
+      expect(profile.totalTime, const Duration(microseconds: 650));
+      expect(profile.nodes.map((node) => node.name), ['conv2', 'conv1']);
+      expect(profile.nodes.first.averageTime, const Duration(microseconds: 175));
+      expect(profile.ops.single.calls, 3);
+      expect(profile.ops.single.provider, 'CPUExecutionProvider');
+    });
+
+    test('startTracing and stopTracing send the trace path and tolerate platforms without tracing', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        if (methodCall.method == 'stopTracing') {
+          return {'tracePath': '/tmp/trace.json', 'spans': 12};
+        }
+        return null;
+      });
+
+      await platform.startTracing();
+      final result = await platform.stopTracing(path: '/tmp/trace.json');
+
+      expect(calls.map((call) => call.method), ['startTracing', 'stopTracing']);
+      expect(calls.last.arguments, {'path': '/tmp/trace.json'});
+      expect(result, {'tracePath': '/tmp/trace.json', 'spans': 12});
+
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      await platform.startTracing();
+      expect(await platform.stopTracing(), isEmpty);
+    });
+
+    test('getNativeContext returns an empty map when the platform does not implement it', () async {
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      expect(await platform.getNativeContext(), isEmpty);
+    });
+
+    test('bindOutputs and runWithBinding send the session and inputs', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        if (methodCall.method == 'unbindOutputs') {
+          return null;
+        }
+        return {
+          'output1': [
+            'bound_value_1',
+            'float32',
+            [1, 3],
+          ],
+        };
+      });
+
+      final input = OrtValue.fromMap({
+        'valueId': 'test_value_1',
+        'dataType': 'float32',
+        'shape': [1, 3],
+      });
+
+      final bound = await platform.bindOutputs('test_session_id', outputNames: ['output1']);
+      final result = await platform.runWithBinding('test_session_id', {'input1': input});
+      await platform.unbindOutputs('test_session_id');
+
+      expect(calls.map((call) => call.method), ['bindOutputs', 'runWithBinding', 'unbindOutputs']);
+      expect(calls[0].arguments, {
+        'sessionId': 'test_session_id',
+        'outputNames': ['output1'],
+      });
+      final runArgs = calls[1].arguments as Map<Object?, Object?>;
+      expect((runArgs['inputs'] as Map)['input1'], {'valueId': 'test_value_1'});
+      expect(calls[2].arguments, {'sessionId': 'test_session_id'});
+
+      // The same bound tensor is reported by both calls
+      expect(bound['output1'][0], 'bound_value_1');
+      expect(result['output1'][0], 'bound_value_1');
+    });
+
+    test('createPipeline and runPipeline send the stages and inputs', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        if (methodCall.method == 'createPipeline') {
+          return {'pipelineId': 7};
+        }
+        return {
+          'labels': [
+            'label_value',
+            'int64',
+            [2],
+          ],
+        };
+      });
+
+      final session = OrtSession.fromMap({
+        'sessionId': 3,
+        'inputNames': ['input'],
+        'outputNames': ['logits'],
+      });
+      final stages = [
+        OrtPipelineStage.session('classify', session, inputs: {'input': 'image'}),
+        OrtPipelineStage.topK('top', input: 'classify/logits', k: 2),
+      ];
+      final created = await platform.createPipeline([for (final stage in stages) stage.toMap()], {
+        'labels': 'top/indices',
+      });
+      final pipeline = OrtPipeline.fromMap(created);
+      final image = OrtValue.fromMap({
+        'valueId': 'test_value_1',
+        'dataType': 'float32',
+        'shape': [1, 3],
+      });
+      final result = await platform.runPipeline(pipeline.id, {'image': image});
+
+      final createArgs = calls[0].arguments as Map<Object?, Object?>;
+      final sentStages = createArgs['stages'] as List;
+      expect(sentStages[0], {
+        'name': 'classify',
+        'op': 'session',
+        'sessionId': 3,
+        'inputs': {'input': 'image'},
+        'params': {},
+      });
+      expect((sentStages[1] as Map)['params'], {'k': 2});
+      expect(createArgs['outputs'], {'labels': 'top/indices'});
+
+      final runArgs = calls[1].arguments as Map<Object?, Object?>;
+      expect(runArgs['pipelineId'], 7);
+      expect((runArgs['inputs'] as Map)['image'], {'valueId': 'test_value_1'});
+      expect(result['labels'][0], 'label_value');
+    });
+
+    test('runTensorOp sends the op, its inputs and its params', () async {
+      MethodCall? call;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        call = methodCall;
+        return {
+          'values': [
+            'values_value',
+            'float32',
+            [1, 5],
+          ],
+          'indices': [
+            'indices_value',
+            'int64',
+            [1, 5],
+          ],
+        };
+      });
+
+      final logits = OrtValue.fromMap({
+        'valueId': 'test_value_1',
+        'dataType': 'float32',
+        'shape': [1, 1000],
+      });
+      final result = await platform.runTensorOp('topK', {'input': logits}, params: {'k': 5});
+
+      expect(call?.method, 'runTensorOp');
+      final args = call?.arguments as Map<Object?, Object?>;
+      expect(args['op'], 'topK');
+      expect((args['inputs'] as Map)['input'], {'valueId': 'test_value_1'});
+      expect(args['params'], {'k': 5});
+      expect(result['indices'][0], 'indices_value');
+    });
+
+    test('submitStreamFrame sends typed lists as they are and other typed data as bytes', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        if (methodCall.method == 'openStream') {
+          return {'streamId': 4};
+        }
+        return {'frame': 0};
+      });
+
+      final opened = await platform.openStream('3', depth: 3);
+      final streamId = (opened['streamId'] as Object).toString();
+      final result = await platform.submitStreamFrame(streamId, {
+        'image': Float32List.fromList([1, 2]),
+        'mask': Uint16List.fromList([0x3c00]),
+      });
+      await platform.closeStream(streamId);
+
+      expect(calls[0].arguments, {'sessionId': 3, 'depth': 3});
+      final inputs = (calls[1].arguments as Map)['inputs'] as Map;
+      expect((calls[1].arguments as Map)['streamId'], 4);
+      expect(inputs['image'], isA<Float32List>());
+      expect(inputs['mask'], Uint8List.fromList([0x00, 0x3c]));
+      expect(result['frame'], 0);
+      expect(calls[2].method, 'closeStream');
+    });
+
+    test('openStream is unsupported without a native implementation', () async {
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      expect(platform.openStream('3'), throwsUnsupportedError);
+    });
+
+    test('createPipeline is unsupported without a native implementation', () async {
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      expect(platform.createPipeline([], {}), throwsUnsupportedError);
+    });
+
+    test('enableSequenceState sends the loops and initial dimensions', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        return null;
+      });
+
+      await platform.enableSequenceState(
+        'test_session_id',
+        {'present.0.key': 'past_key_values.0.key'},
+        initialDimensions: {'batch_size': 1},
+      );
+      await platform.resetSequenceState('test_session_id');
+      await platform.disableSequenceState('test_session_id');
+
+      expect(calls.map((call) => call.method), ['enableSequenceState', 'resetSequenceState', 'disableSequenceState']);
+      expect(calls[0].arguments, {
+        'sessionId': 'test_session_id',
+        'loops': {'present.0.key': 'past_key_values.0.key'},
+        'initialDimensions': {'batch_size': 1},
+      });
+      expect(calls[1].arguments, {'sessionId': 'test_session_id'});
+    });
+
+    test('enableSequenceState is unsupported without a native implementation', () async {
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      expect(platform.enableSequenceState('3', {'present': 'past'}), throwsUnsupportedError);
+    });
+
+    test('runInference sends the selected output names', () async {
+      MethodCall? call;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        call = methodCall;
+        return <String, Object?>{};
+      });
+      final input = OrtValue.fromMap({
+        'valueId': 'test_value_1',
+        'dataType': 'float32',
+        'shape': [1],
+      });
+
+      await platform.runInference('test_session_id', {'input1': input});
+      expect((call!.arguments as Map).containsKey('outputNames'), false);
+
+      await platform.runInference('test_session_id', {'input1': input}, outputNames: ['logits']);
+      expect(call!.arguments['outputNames'], ['logits']);
+    });
+
+    test('generate sends the prompt as an Int64List and returns the generation ID', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        return methodCall.method == 'generate' ? {'generationId': 'generation_4'} : null;
+      });
+
+      final result = await platform.generate('test_session_id', [1, 2], options: {'maxTokens': 8});
+      await platform.cancelGeneration(result['generationId'] as String);
+
+      expect(result['generationId'], 'generation_4');
+      expect(calls[0].arguments['sessionId'], 'test_session_id');
+      expect(calls[0].arguments['prompt'], isA<Int64List>());
+      expect(calls[0].arguments['prompt'], [1, 2]);
+      expect(calls[0].arguments['options'], {'maxTokens': 8});
+      expect(calls[1].method, 'cancelGeneration');
+      expect(calls[1].arguments, {'generationId': 'generation_4'});
+    });
+
+    test('generate is unsupported without a native implementation', () async {
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      expect(platform.generate('3', [1]), throwsUnsupportedError);
+    });
+
+    test('releaseOrtValues sends every ID in one call', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        return null;
+      });
+
+      await platform.releaseOrtValues(['tensor_1', '4294967297']);
+
+      expect(calls.length, 1);
+      expect(calls[0].method, 'releaseOrtValues');
+      expect(calls[0].arguments, {
+        'valueIds': ['tensor_1', 4294967297],
+      });
+    });
+
+    test('quantizeOrtValue and dequantizeOrtValue send the scales, zero points and axis', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        return {
+          'valueId': 'tensor_2',
+          'dataType': methodCall.method == 'quantizeOrtValue' ? 'uint8' : 'float32',
+          'shape': [4],
+        };
+      });
+
+      final quantized = await platform.quantizeOrtValue(
+        'tensor_1',
+        scales: [0.5],
+        zeroPoints: [128],
+        axis: 0,
+        dataType: 'uint8',
+      );
+      expect(quantized['dataType'], 'uint8');
+      await platform.dequantizeOrtValue('tensor_2', scales: [0.5, 0.25]);
+
+      expect(calls[0].method, 'quantizeOrtValue');
+      expect(calls[0].arguments, {
+        'valueId': 'tensor_1',
+        'scales': [0.5],
+        'zeroPoints': [128],
+        'axis': 0,
+        'dataType': 'uint8',
+      });
+      expect(calls[1].method, 'dequantizeOrtValue');
+      expect(calls[1].arguments, {
+        'valueId': 'tensor_2',
+        'scales': [0.5, 0.25],
+        'zeroPoints': [],
+        'axis': 1,
+      });
+    });
+
+    test('reshape, slice, transpose and concat send their arguments', () async {
+      final calls = <MethodCall>[];
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        calls.add(methodCall);
+        return {
+          'valueId': 'tensor_3',
+          'dataType': 'float32',
+          'shape': [4],
+        };
+      });
+
+      final reshaped = await platform.reshapeOrtValue('tensor_1', [0, -1]);
+      expect(reshaped['valueId'], 'tensor_3');
+      await platform.sliceOrtValue('tensor_1', 1, 0, 2);
+      await platform.sliceOrtValue('tensor_1', 0, 3);
+      await platform.transposeOrtValue('tensor_1');
+      await platform.concatOrtValues(['tensor_1', 'tensor_2'], 1);
+
+      expect(calls.map((call) => call.method), [
+        'reshapeOrtValue',
+        'sliceOrtValue',
+        'sliceOrtValue',
+        'transposeOrtValue',
+        'concatOrtValues',
+      ]);
+      expect(calls[0].arguments, {
+        'valueId': 'tensor_1',
+        'shape': [0, -1],
+      });
+      expect(calls[1].arguments, {'valueId': 'tensor_1', 'axis': 1, 'start': 0, 'end': 2});
+      expect(calls[2].arguments, {'valueId': 'tensor_1', 'axis': 0, 'start': 3, 'end': null});
+      expect(calls[3].arguments, {'valueId': 'tensor_1', 'perm': null});
+      expect(calls[4].arguments, {
+        'valueIds': ['tensor_1', 'tensor_2'],
+        'axis': 1,
+      });
+    });
+
+    test('memory statistics and limits are unsupported without a native implementation', () async {
+      MethodCall? capturedCall;
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        capturedCall = methodCall;
+        return null;
+      });
+
+      await platform.setMemoryLimit(1 << 20);
+      expect(capturedCall?.method, 'setMemoryLimit');
+      expect(capturedCall?.arguments, {'hardLimitBytes': 1 << 20});
+
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger.setMockMethodCallHandler(channel, (
+        MethodCall methodCall,
+      ) async {
+        throw MissingPluginException();
+      });
+
+      expect(platform.getMemoryStats(), throwsUnsupportedError);
+      expect(platform.setMemoryLimit(0), throwsUnsupportedError);
+    });
   });
 }
@@ -4,6 +4,8 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:typed_data';
+
 import 'package:flutter_test/flutter_test.dart';
 import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
@@ -28,6 +30,7 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
   }) {
     // Return mock output with the same structure as expected from the real implementation
     return Future.value({
@@ -94,6 +97,35 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   @override
   Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) => Future.value({});
 
+  @override
+  Future<Map<String, dynamic>> quantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+    required String dataType,
+  }) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> dequantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+  }) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> reshapeOrtValue(String valueId, List<int> shape) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> sliceOrtValue(String valueId, int axis, int start, [int? end]) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> transposeOrtValue(String valueId, [List<int>? perm]) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> concatOrtValues(List<String> valueIds, int axis) => Future.value({});
+
   @override
   Future<Map<String, dynamic>> createOrtValue(String sourceType, dynamic data, List<int> shape) => Future.value({});
 
@@ -106,8 +138,200 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   @override
   Future<void> releaseOrtValue(String valueId) => Future.value();
 
+  @override
+  Future<void> releaseOrtValues(List<String> valueIds) => Future.value();
+
   @override
   Future<List<String>> getAvailableProviders() => Future.value(['CPU']);
+
+  @override
+  Future<void> setInferenceThreads(int numThreads) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> getQueueStats() => Future.value({
+    'high': {'queued': 0, 'submitted': 4, 'started': 4, 'waitMicros': 400, 'maxWaitMicros': 250, 'p50WaitMicros': 50},
+    'low': {'queued': 2, 'submitted': 5, 'started': 3, 'preempted': 1, 'waitMicros': 9000},
+  });
+
+  @override
+  Future<int> cancelLowPriorityRuns() => Future.value(2);
+
+  final cancelledRunTags = <String>[];
+
+  @override
+  Future<bool> cancelRun(String runTag) {
+    cancelledRunTags.add(runTag);
+    return Future.value(true);
+  }
+
+  @override
+  Future<void> setIntegerHandles(bool enabled) => Future.value();
+
+  @override
+  Future<void> configureBatching(String sessionId, {required int windowMicros, required int maxBatchSize}) =>
+      Future.value();
+
+  @override
+  Future<Map<String, dynamic>> getBatchingStats(String sessionId) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getNativeContext() => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getSessionStats(String sessionId) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getMemoryStats() => Future.value({
+    'tensorCount': 3,
+    'hostBytes': 1040,
+    'hostBytesByType': {'float32': 1024, 'int64': 16},
+    'deviceBytes': 0,
+    'retiredCount': 1,
+    'hardLimitBytes': 4096,
+    'bufferPool': {'hits': 5, 'misses': 2, 'retainedBytes': 512, 'retainedBuffers': 1, 'maxRetainedBytes': 65536},
+    'sessions': [
+      {'sessionId': 'test_session_id', 'sequenceStateBytes': 2048},
+    ],
+  });
+
+  int? lastHardLimitBytes;
+
+  @override
+  Future<void> setMemoryLimit(int hardLimitBytes) {
+    lastHardLimitBytes = hardLimitBytes;
+    return Future.value();
+  }
+
+  @override
+  Future<Map<String, dynamic>> endProfiling(String sessionId) => Future.value({});
+
+  @override
+  Future<void> startTracing() => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> stopTracing({String? path}) => Future.value({});
+
+  @override
+  Future<void> configureThreadPools({
+    required int intraOpNumThreads,
+    required int interOpNumThreads,
+    bool allowSpinning = true,
+    String? intraOpThreadAffinity,
+  }) => Future.value();
+
+  @override
+  Future<void> configureSharedArena({
+    int maxBytes = 0,
+    String? extendStrategy,
+    int? initialChunkBytes,
+    int? maxDeadBytesPerChunk,
+  }) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createSessionFromBuffer(Uint8List modelData, {Map<String, dynamic>? sessionOptions}) =>
+      Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> createSessionFromMappedFile(String modelPath, {Map<String, dynamic>? sessionOptions}) =>
+      Future.value({});
+
+  @override
+  Future<void> configureSessionCache({required int maxSessions, required int maxBytes}) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createImageTensor(
+    Uint8List data, {
+    required String format,
+    required int width,
+    required int height,
+    int? targetWidth,
+    int? targetHeight,
+    List<double>? mean,
+    List<double>? std,
+    required String layout,
+    required String dataType,
+  }) => Future.value({});
+
+  @override
+  Future<List<Map<String, dynamic>>> runBatch(
+    String sessionId,
+    List<Map<String, OrtValue>> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value([]);
+
+  @override
+  Future<Map<String, dynamic>> bindOutputs(String sessionId, {List<String>? outputNames}) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> runWithBinding(
+    String sessionId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({});
+
+  @override
+  Future<void> unbindOutputs(String sessionId) => Future.value();
+
+  @override
+  Future<void> enableSequenceState(
+    String sessionId,
+    Map<String, String> loops, {
+    Map<String, int> initialDimensions = const {},
+  }) => Future.value();
+
+  @override
+  Future<void> resetSequenceState(String sessionId) => Future.value();
+
+  @override
+  Future<void> disableSequenceState(String sessionId) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createPipeline(List<Map<String, dynamic>> stages, Map<String, String> outputs) =>
+      Future.value({'pipelineId': 'test_pipeline_id'});
+
+  @override
+  Future<Map<String, dynamic>> runPipeline(
+    String pipelineId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({});
+
+  @override
+  Future<void> closePipeline(String pipelineId) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> runTensorOp(
+    String op,
+    Map<String, OrtValue> inputs, {
+    Map<String, Object> params = const {},
+  }) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> openStream(String sessionId, {int depth = 2}) =>
+      Future.value({'streamId': 'test_stream_id'});
+
+  @override
+  Future<Map<String, dynamic>> submitStreamFrame(
+    String streamId,
+    Map<String, TypedData> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({'frame': 0});
+
+  @override
+  Future<void> closeStream(String streamId) => Future.value();
+
+  @override
+  Stream<Map<String, dynamic>> get streamEvents => const Stream.empty();
+
+  @override
+  Future<Map<String, dynamic>> generate(String sessionId, List<int> prompt, {Map<String, dynamic>? options}) =>
+      Future.value({'generationId': 'test_generation_id'});
+
+  @override
+  Future<void> cancelGeneration(String generationId) => Future.value();
+
+  @override
+  Stream<Map<String, dynamic>> get generationEvents => const Stream.empty();
 }
 
 void main() {
@@ -162,6 +386,55 @@ void main() {
       expect(providers, isA<List<OrtProvider>>());
       expect(providers, contains(OrtProvider.CPU));
     });
+
+    test('getMemoryStats returns native memory statistics', () async {
+      final stats = await onnxRuntime.getMemoryStats();
+
+      expect(stats.tensorCount, 3);
+      expect(stats.hostBytes, 1040);
+      expect(stats.hostBytesByType, {'float32': 1024, 'int64': 16});
+      expect(stats.retiredCount, 1);
+      expect(stats.hardLimitBytes, 4096);
+      expect(stats.bufferPool.hits, 5);
+      expect(stats.bufferPool.retainedBytes, 512);
+      expect(stats.sequenceStateBytes, {'test_session_id': 2048});
+      expect(OrtMemoryStats.fromMap(stats.toMap()).sequenceStateBytes, {'test_session_id': 2048});
+    });
+
+    test('getQueueStats returns the queue statistics of every priority', () async {
+      final stats = await onnxRuntime.getQueueStats();
+
+      expect(stats.keys, OrtRunPriority.values);
+      expect(stats[OrtRunPriority.high]!.started, 4);
+      expect(stats[OrtRunPriority.high]!.averageWait, const Duration(microseconds: 100));
+      expect(stats[OrtRunPriority.high]!.maxWait, const Duration(microseconds: 250));
+      expect(stats[OrtRunPriority.low]!.queued, 2);
+      expect(stats[OrtRunPriority.low]!.preempted, 1);
+      expect(stats[OrtRunPriority.normal]!.submitted, 0);
+      expect(stats[OrtRunPriority.normal]!.averageWait, Duration.zero);
+      expect(OrtQueueStats.fromMap(stats[OrtRunPriority.low]!.toMap()).waitTime, const Duration(microseconds: 9000));
+    });
+
+    test('cancelLowPriorityRuns returns the number of calls terminated', () async {
+      expect(await onnxRuntime.cancelLowPriorityRuns(), 2);
+    });
+
+    test('OrtRunHandle cancels the calls tagged with its ID', () async {
+      final handle = OrtRunHandle();
+      expect(handle.id, isNot(OrtRunHandle().id));
+      expect(await handle.cancel(), true);
+      expect(mockPlatform.cancelledRunTags, [handle.id]);
+    });
+
+    test('setMemoryLimit passes the hard limit, with 0 for none', () async {
+      await onnxRuntime.setMemoryLimit(1 << 20);
+      expect(mockPlatform.lastHardLimitBytes, 1 << 20);
+
+      await onnxRuntime.setMemoryLimit(null);
+      expect(mockPlatform.lastHardLimitBytes, 0);
+
+      expect(() => onnxRuntime.setMemoryLimit(0), throwsArgumentError);
+    });
   });
 
   group('OrtSession', () {
@@ -300,6 +573,85 @@ void main() {
       expect(map['providers'], ['CUDA', 'CPU']);
     });
 
+    test('OrtSessionOptions toMap includes graph optimization settings', () {
+      final options = OrtSessionOptions(
+        graphOptimizationLevel: OrtGraphOptimizationLevel.extended,
+        cacheOptimizedModel: true,
+      );
+
+      final map = options.toMap();
+
+      expect(map['graphOptimizationLevel'], 'extended');
+      expect(map['cacheOptimizedModel'], true);
+    });
+
+    test('OrtSessionOptions toMap includes warmup settings', () {
+      final options = OrtSessionOptions(warmupRuns: 2, warmupDimensions: {'batch': 1, 'sequence': 128});
+
+      final map = options.toMap();
+
+      expect(map['warmupRuns'], 2);
+      expect(map['warmupDimensions'], {'batch': 1, 'sequence': 128});
+    });
+
+    test('OrtSessionOptions toMap includes memory settings', () {
+      final options = OrtSessionOptions(
+        useArena: false,
+        enableMemPattern: true,
+        useDeviceAllocatorForInitializers: true,
+      );
+
+      expect(options.toMap(), {
+        'useArena': false,
+        'enableMemPattern': true,
+        'useDeviceAllocatorForInitializers': true,
+      });
+      expect(options.withProviders([OrtProvider.CPU]).toMap()['enableMemPattern'], true);
+    });
+
+    test('OrtSessionOptions toMap includes profiling settings', () {
+      final options = OrtSessionOptions(enableProfiling: true, profilingDirectory: '/tmp/profiles');
+
+      final map = options.toMap();
+
+      expect(map['enableProfiling'], true);
+      expect(map['profilingDirectory'], '/tmp/profiles');
+    });
+
+    test('OrtSessionOptions withProviders only replaces the providers', () {
+      final options = OrtSessionOptions(
+        intraOpNumThreads: 2,
+        providers: [OrtProvider.AUTO],
+        warmupRuns: 1,
+        enableProfiling: true,
+      );
+
+      final map = options.withProviders([OrtProvider.CUDA, OrtProvider.CPU]).toMap();
+
+      expect(map['providers'], ['CUDA', 'CPU']);
+      expect(map['intraOpNumThreads'], 2);
+      expect(map['warmupRuns'], 1);
+      expect(map['enableProfiling'], true);
+    });
+
+    test('OrtSessionOptions toMap passes provider options as strings', () {
+      final options = OrtSessionOptions(
+        providers: [OrtProvider.TENSOR_RT, OrtProvider.CUDA],
+        providerOptions: {
+          OrtProvider.TENSOR_RT: {'trt_fp16_enable': true, 'trt_max_workspace_size': 1 << 30},
+          OrtProvider.CUDA: {'cudnn_conv_algo_search': 'HEURISTIC', 'do_copy_in_default_stream': false},
+        },
+      );
+
+      final map = options.toMap();
+
+      expect(map['providerOptions'], {
+        'TENSOR_RT': {'trt_fp16_enable': '1', 'trt_max_workspace_size': '1073741824'},
+        'CUDA': {'cudnn_conv_algo_search': 'HEURISTIC', 'do_copy_in_default_stream': '0'},
+      });
+      expect(options.withProviders([OrtProvider.CUDA]).toMap()['providerOptions'], map['providerOptions']);
+    });
+
     test('OrtRunOptions toMap converts options to map correctly', () {
       final options = OrtRunOptions(logSeverityLevel: 1, logVerbosityLevel: 2, terminate: false);
 
@@ -310,12 +662,48 @@ void main() {
       expect(map['terminate'], false);
     });
 
+    test('OrtRunOptions toMap passes the output device', () {
+      expect(OrtRunOptions(outputDevice: const OrtDevice.cuda(1)).toMap(), {
+        'outputDevice': 'cuda',
+        'outputDeviceId': 1,
+      });
+      expect(OrtRunOptions(outputDevice: const OrtDevice.directML()).toMap(), {
+        'outputDevice': 'directml',
+        'outputDeviceId': 0,
+      });
+      expect(OrtRunOptions().toMap().containsKey('outputDevice'), false);
+    });
+
+    test('OrtRunOptions toMap passes the inline output threshold', () {
+      expect(OrtRunOptions(returnDataMaxBytes: 4096).toMap(), {'returnDataMaxBytes': 4096});
+      expect(OrtRunOptions().toMap().containsKey('returnDataMaxBytes'), false);
+    });
+
+    test('OrtRunOptions toMap passes the run tag and the timeout in milliseconds rounded up', () {
+      final handle = OrtRunHandle();
+      expect(OrtRunOptions(handle: handle, timeout: const Duration(milliseconds: 250)).toMap(), {
+        'runTag': handle.id,
+        'timeoutMs': 250,
+      });
+      expect(OrtRunOptions(timeout: const Duration(microseconds: 1500)).toMap(), {'timeoutMs': 2});
+      expect(OrtRunOptions().toMap().containsKey('timeoutMs'), false);
+    });
+
+    test('OrtRunOptions toMap passes the priority by name', () {
+      expect(OrtRunOptions(priority: OrtRunPriority.low).toMap(), {'priority': 'low'});
+      expect(OrtRunOptions().toMap().containsKey('priority'), false);
+    });
+
     test('OrtSessionOptions handles null values correctly', () {
       final options = OrtSessionOptions();
       final map = options.toMap();
 
       expect(map.containsKey('intraOpNumThreads'), false);
       expect(map.containsKey('interOpNumThreads'), false);
+      expect(map.containsKey('graphOptimizationLevel'), false);
+      expect(map.containsKey('cacheOptimizedModel'), false);
+      expect(map.containsKey('warmupRuns'), false);
+      expect(map.containsKey('enableProfiling'), false);
     });
   });
 }
@@ -4,6 +4,9 @@
 // This source code is licensed under the license found in the
 // LICENSE file in the root directory of this source tree.
 
+import 'dart:async';
+import 'dart:typed_data';
+
 import 'package:flutter_test/flutter_test.dart';
 import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
@@ -26,12 +29,14 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   String? lastSessionIdForRun;
   Map<String, dynamic>? lastInputsForRun;
   Map<String, dynamic>? lastRunOptions;
+  List<String>? lastOutputNames;
 
   @override
   Future<Map<String, dynamic>> runInference(
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
   }) {
     // Track the invocation for verification
     lastSessionIdForRun = sessionId;
@@ -39,6 +44,7 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
       for (final entry in inputs.entries) entry.key: {'valueId': entry.value.id},
     };
     lastRunOptions = runOptions;
+    lastOutputNames = outputNames;
 
     // Return mock output - simulate the new output format with OrtValue properties
     return Future.value({
@@ -47,11 +53,18 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
         'float32',
         [1, 3],
       ],
-      'output2': [
-        'test_output_value_2',
-        'float32',
-        [2, 2],
-      ],
+      // Small outputs come back as data when the run asks for it
+      'output2': runOptions?['returnDataMaxBytes'] != null
+          ? {
+              'data': Float32List.fromList([1.0, 2.0, 3.0, 4.0]),
+              'dataType': 'float32',
+              'shape': [2, 2],
+            }
+          : [
+              'test_output_value_2',
+              'float32',
+              [2, 2],
+            ],
     });
   }
 
@@ -116,6 +129,35 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   @override
   Future<Map<String, dynamic>> convertOrtValue(String valueId, String targetType) => Future.value({});
 
+  @override
+  Future<Map<String, dynamic>> quantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+    required String dataType,
+  }) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> dequantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+  }) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> reshapeOrtValue(String valueId, List<int> shape) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> sliceOrtValue(String valueId, int axis, int start, [int? end]) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> transposeOrtValue(String valueId, [List<int>? perm]) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> concatOrtValues(List<String> valueIds, int axis) => Future.value({});
+
   @override
   Future<Map<String, dynamic>> getOrtValueData(String valueId) => Future.value({
     'data': [1.0, 2.0, 3.0, 4.0],
@@ -125,8 +167,178 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   @override
   Future<void> releaseOrtValue(String valueId) => Future.value();
 
+  @override
+  Future<void> releaseOrtValues(List<String> valueIds) => Future.value();
+
   @override
   Future<List<String>> getAvailableProviders() => Future.value(['CPU']);
+
+  @override
+  Future<void> setInferenceThreads(int numThreads) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> getQueueStats() => Future.value({});
+
+  @override
+  Future<int> cancelLowPriorityRuns() => Future.value(0);
+
+  @override
+  Future<bool> cancelRun(String runTag) => Future.value(false);
+
+  @override
+  Future<void> setIntegerHandles(bool enabled) => Future.value();
+
+  @override
+  Future<void> configureBatching(String sessionId, {required int windowMicros, required int maxBatchSize}) =>
+      Future.value();
+
+  @override
+  Future<Map<String, dynamic>> getBatchingStats(String sessionId) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getNativeContext() => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getSessionStats(String sessionId) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getMemoryStats() => Future.value({});
+
+  @override
+  Future<void> setMemoryLimit(int hardLimitBytes) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> endProfiling(String sessionId) => Future.value({});
+
+  @override
+  Future<void> startTracing() => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> stopTracing({String? path}) => Future.value({});
+
+  @override
+  Future<void> configureThreadPools({
+    required int intraOpNumThreads,
+    required int interOpNumThreads,
+    bool allowSpinning = true,
+    String? intraOpThreadAffinity,
+  }) => Future.value();
+
+  @override
+  Future<void> configureSharedArena({
+    int maxBytes = 0,
+    String? extendStrategy,
+    int? initialChunkBytes,
+    int? maxDeadBytesPerChunk,
+  }) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createSessionFromBuffer(Uint8List modelData, {Map<String, dynamic>? sessionOptions}) =>
+      Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> createSessionFromMappedFile(String modelPath, {Map<String, dynamic>? sessionOptions}) =>
+      Future.value({});
+
+  @override
+  Future<void> configureSessionCache({required int maxSessions, required int maxBytes}) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createImageTensor(
+    Uint8List data, {
+    required String format,
+    required int width,
+    required int height,
+    int? targetWidth,
+    int? targetHeight,
+    List<double>? mean,
+    List<double>? std,
+    required String layout,
+    required String dataType,
+  }) => Future.value({});
+
+  @override
+  Future<List<Map<String, dynamic>>> runBatch(
+    String sessionId,
+    List<Map<String, OrtValue>> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) async {
+    return [for (final request in inputs) await runInference(sessionId, request, runOptions: runOptions)];
+  }
+
+  @override
+  Future<Map<String, dynamic>> bindOutputs(String sessionId, {List<String>? outputNames}) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> runWithBinding(
+    String sessionId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({});
+
+  @override
+  Future<void> unbindOutputs(String sessionId) => Future.value();
+
+  @override
+  Future<void> enableSequenceState(
+    String sessionId,
+    Map<String, String> loops, {
+    Map<String, int> initialDimensions = const {},
+  }) => Future.value();
+
+  @override
+  Future<void> resetSequenceState(String sessionId) => Future.value();
+
+  @override
+  Future<void> disableSequenceState(String sessionId) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createPipeline(List<Map<String, dynamic>> stages, Map<String, String> outputs) =>
+      Future.value({'pipelineId': 'test_pipeline_id'});
+
+  @override
+  Future<Map<String, dynamic>> runPipeline(
+    String pipelineId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({});
+
+  @override
+  Future<void> closePipeline(String pipelineId) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> runTensorOp(
+    String op,
+    Map<String, OrtValue> inputs, {
+    Map<String, Object> params = const {},
+  }) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> openStream(String sessionId, {int depth = 2}) =>
+      Future.value({'streamId': 'test_stream_id'});
+
+  @override
+  Future<Map<String, dynamic>> submitStreamFrame(
+    String streamId,
+    Map<String, TypedData> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({'frame': 0});
+
+  @override
+  Future<void> closeStream(String streamId) => Future.value();
+
+  @override
+  Stream<Map<String, dynamic>> get streamEvents => const Stream.empty();
+
+  @override
+  Future<Map<String, dynamic>> generate(String sessionId, List<int> prompt, {Map<String, dynamic>? options}) =>
+      Future.value({'generationId': 'test_generation_id'});
+
+  @override
+  Future<void> cancelGeneration(String generationId) => Future.value();
+
+  @override
+  Stream<Map<String, dynamic>> get generationEvents => const Stream.empty();
 }
 
 class CustomDataMockFlutterOnnxruntimePlatform extends MockFlutterOnnxruntimePlatform {
@@ -163,6 +375,7 @@ class CustomDataMockFlutterOnnxruntimePlatform extends MockFlutterOnnxruntimePla
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
   }) {
     return Future.value({
       'output1': [
@@ -201,6 +414,7 @@ class InferenceOutputsMock extends MockFlutterOnnxruntimePlatform {
     String sessionId,
     Map<String, dynamic> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
   }) {
     // Track the call
     lastInputsForRun = {};
@@ -242,6 +456,105 @@ class InferenceOutputsMock extends MockFlutterOnnxruntimePlatform {
   }
 }
 
+// Streams frames like the native plugins: frames are numbered as they are submitted and their events are sent
+// whenever the test chooses, possibly out of order
+class StreamMock extends MockFlutterOnnxruntimePlatform {
+  final StreamController<Map<String, dynamic>> events = StreamController<Map<String, dynamic>>.broadcast();
+  final List<Map<String, TypedData>> submitted = [];
+  int? openedDepth;
+  bool closed = false;
+
+  @override
+  Future<Map<String, dynamic>> openStream(String sessionId, {int depth = 2}) {
+    openedDepth = depth;
+    return Future.value({'streamId': 5});
+  }
+
+  @override
+  Future<Map<String, dynamic>> submitStreamFrame(
+    String streamId,
+    Map<String, TypedData> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) {
+    submitted.add(inputs);
+    return Future.value({'frame': submitted.length - 1});
+  }
+
+  @override
+  Future<void> closeStream(String streamId) {
+    closed = true;
+    return Future.value();
+  }
+
+  @override
+  Stream<Map<String, dynamic>> get streamEvents => events.stream;
+
+  void sendFrame(int frame, double value) {
+    events.add({
+      'streamId': 5,
+      'frame': frame,
+      'outputs': {
+        'output1': {
+          'data': Float32List.fromList([value]),
+          'dataType': 'float32',
+          'shape': [1],
+        },
+      },
+    });
+  }
+}
+
+// Generates like the native plugins: the ID is returned at once and the events of the tokens are sent whenever
+// the test chooses, possibly before generate() has returned
+class QuantizedModelMock extends MockFlutterOnnxruntimePlatform {
+  @override
+  Future<List<Map<String, dynamic>>> getInputInfo(String sessionId) {
+    return Future.value([
+      {
+        'name': 'input1',
+        'type': 'FLOAT',
+        'shape': [1, 3],
+      },
+      {
+        'name': 'input2',
+        'type': 'uint8',
+        'shape': [1, 3],
+        'quantization': {
+          'scales': [0.5],
+          'zeroPoints': [128],
+          'axis': 1,
+          'dataType': 'uint8',
+        },
+      },
+    ]);
+  }
+}
+
+class GenerationMock extends MockFlutterOnnxruntimePlatform {
+  final StreamController<Map<String, dynamic>> events = StreamController<Map<String, dynamic>>.broadcast();
+  List<int>? prompt;
+  Map<String, dynamic>? options;
+  final List<String> cancelled = [];
+
+  @override
+  Future<Map<String, dynamic>> generate(String sessionId, List<int> prompt, {Map<String, dynamic>? options}) async {
+    this.prompt = prompt;
+    this.options = options;
+    // The first token overtakes the response, as it can on the platform thread
+    events.add({'generationId': 9, 'token': 11});
+    return {'generationId': 9};
+  }
+
+  @override
+  Future<void> cancelGeneration(String generationId) {
+    cancelled.add(generationId);
+    return Future.value();
+  }
+
+  @override
+  Stream<Map<String, dynamic>> get generationEvents => events.stream;
+}
+
 void main() {
   TestWidgetsFlutterBinding.ensureInitialized();
 
@@ -310,6 +623,68 @@ void main() {
       expect(mockPlatform.lastInputsForRun!['input1'], {'valueId': 'test_value_1'});
       expect(mockPlatform.lastInputsForRun!['input2'], {'valueId': 'test_value_2'});
       expect(mockPlatform.lastRunOptions, runOptions.toMap());
+      expect(mockPlatform.lastOutputNames, isNull);
+    });
+
+    test('run passes the selected output names to platform', () async {
+      final ortValue = OrtValue.fromMap({
+        'valueId': 'test_value_1',
+        'dataType': 'float32',
+        'shape': [1, 3],
+      });
+
+      await session.run({'input1': ortValue}, outputNames: ['output2']);
+
+      expect(mockPlatform.lastOutputNames, ['output2']);
+    });
+
+    test('run returns small outputs inline with returnDataMaxBytes', () async {
+      final ortValue = OrtValue.fromMap({
+        'valueId': 'test_value_1',
+        'dataType': 'float32',
+        'shape': [1, 3],
+      });
+
+      final outputs = await session.run({'input1': ortValue}, options: OrtRunOptions(returnDataMaxBytes: 64));
+
+      expect(mockPlatform.lastRunOptions, {'returnDataMaxBytes': 64});
+      expect(outputs['output1']!.isInline, false);
+      expect(outputs['output1']!.id, 'test_output_value_1');
+
+      final inline = outputs['output2']!;
+      expect(inline.isInline, true);
+      expect(inline.dataType, OrtDataType.float32);
+      expect(inline.shape, [2, 2]);
+      expect(await inline.asList(), [
+        [1.0, 2.0],
+        [3.0, 4.0],
+      ]);
+      expect(await inline.asTypedData(), Float32List.fromList([1.0, 2.0, 3.0, 4.0]));
+      await inline.dispose();
+      await expectLater(inline.to(OrtDataType.int32), throwsStateError);
+    });
+
+    test('runBatch returns one outputs map per request', () async {
+      final first = OrtValue.fromMap({
+        'valueId': 'batch_value_1',
+        'dataType': 'float32',
+        'shape': [1, 3],
+      });
+      final second = OrtValue.fromMap({
+        'valueId': 'batch_value_2',
+        'dataType': 'float32',
+        'shape': [1, 3],
+      });
+
+      final results = await session.runBatch([
+        {'input1': first},
+        {'input1': second},
+      ]);
+
+      expect(results.length, 2);
+      expect(results[0].keys, containsAll(['output1', 'output2']));
+      expect(results[1]['output1']!.shape, [1, 3]);
+      expect(mockPlatform.lastInputsForRun!['input1'], {'valueId': 'batch_value_2'});
     });
 
     test('run returns OrtValue outputs in new format', () async {
@@ -487,6 +862,105 @@ void main() {
     });
   });
 
+  group('OrtSession openStream', () {
+    test('submit waits for a free slot and frames arrive in submission order', () async {
+      final streamMock = StreamMock();
+      FlutterOnnxruntimePlatform.instance = streamMock;
+
+      final stream = await session.openStream(depth: 2);
+      expect(stream.id, '5');
+      expect(streamMock.openedDepth, 2);
+
+      final frames = <OrtStreamFrame>[];
+      stream.frames.listen(frames.add);
+      expect(await stream.submit({'input1': Float32List.fromList([1])}), 0);
+      expect(await stream.submit({'input1': Float32List.fromList([2])}), 1);
+
+      // Both slots are in flight, so the third frame waits until one is delivered
+      var thirdSubmitted = false;
+      final third = stream.submit({'input1': Float32List.fromList([3])}).then((frame) {
+        thirdSubmitted = true;
+        return frame;
+      });
+      await Future<void>.delayed(Duration.zero);
+      expect(thirdSubmitted, false);
+
+      // A frame that finishes early is held back until the frames before it are delivered
+      streamMock.sendFrame(1, 20);
+      await Future<void>.delayed(Duration.zero);
+      expect(frames, isEmpty);
+      expect(thirdSubmitted, false);
+
+      streamMock.sendFrame(0, 10);
+      expect(await third, 2);
+      await Future<void>.delayed(Duration.zero);
+      expect(frames.map((frame) => frame.frame), [0, 1]);
+      expect(frames[0].outputs['output1'], [10]);
+      expect(frames[1].shapes['output1'], [1]);
+
+      streamMock.sendFrame(2, 30);
+      await stream.close();
+      expect(frames.map((frame) => frame.frame), [0, 1, 2]);
+      expect(streamMock.closed, true);
+      expect(stream.submit({'input1': Float32List.fromList([4])}), throwsStateError);
+
+      FlutterOnnxruntimePlatform.instance = mockPlatform;
+    });
+  });
+
+  group('OrtSession generate', () {
+    test('emits tokens in order, including those sent before the ID, until the generation is done', () async {
+      final generationMock = GenerationMock();
+      FlutterOnnxruntimePlatform.instance = generationMock;
+
+      final tokens = <int>[];
+      final done = session.generate([1, 2, 3], maxTokens: 4, stopTokens: [2], temperature: 0.7, topK: 5).listen(
+        tokens.add,
+      );
+      await Future<void>.delayed(Duration.zero);
+      generationMock.events.add({'generationId': 8, 'token': 99});
+      generationMock.events.add({'generationId': 9, 'token': 12});
+      generationMock.events.add({'generationId': 9, 'done': true, 'reason': 'length'});
+      await done.asFuture<void>();
+
+      expect(tokens, [11, 12]);
+      expect(generationMock.prompt, [1, 2, 3]);
+      expect(generationMock.options?['maxTokens'], 4);
+      expect(generationMock.options?['stopTokens'], [2]);
+      expect(generationMock.options?['temperature'], 0.7);
+      expect(generationMock.options?['topK'], 5);
+      expect(generationMock.options?['logitsName'], 'logits');
+      expect(generationMock.cancelled, isEmpty);
+
+      FlutterOnnxruntimePlatform.instance = mockPlatform;
+    });
+
+    test('cancelling the subscription cancels the generation', () async {
+      final generationMock = GenerationMock();
+      FlutterOnnxruntimePlatform.instance = generationMock;
+
+      final first = await session.generate([1]).first;
+
+      expect(first, 11);
+      expect(generationMock.cancelled, ['9']);
+
+      FlutterOnnxruntimePlatform.instance = mockPlatform;
+    });
+
+    test('reports an error event as a stream error', () async {
+      final generationMock = GenerationMock();
+      FlutterOnnxruntimePlatform.instance = generationMock;
+
+      final tokens = session.generate([1]).toList();
+      await Future<void>.delayed(Duration.zero);
+      generationMock.events.add({'generationId': 9, 'error': 'Session has no output logits'});
+
+      await expectLater(tokens, throwsStateError);
+
+      FlutterOnnxruntimePlatform.instance = mockPlatform;
+    });
+  });
+
   group('OrtSession metadata methods', () {
     test('getMetadata returns properly structured metadata', () async {
       final metadata = await session.getMetadata();
@@ -510,6 +984,20 @@ void main() {
       expect(inputInfo[0]['shape'], [1, 3, 224, 224]);
     });
 
+    test('getInputInfo reads the quantization of inputs of QDQ models', () async {
+      FlutterOnnxruntimePlatform.instance = QuantizedModelMock();
+
+      final inputInfo = await session.getInputInfo();
+
+      expect(inputInfo[0].containsKey('quantization'), false);
+      final quantization = inputInfo[1]['quantization'] as OrtQuantization;
+      expect(quantization.scales, [0.5]);
+      expect(quantization.zeroPoints, [128]);
+      expect(quantization.dataType, OrtDataType.uint8);
+
+      FlutterOnnxruntimePlatform.instance = mockPlatform;
+    });
+
     test('getOutputInfo returns output tensor information', () async {
       final outputInfo = await session.getOutputInfo();
 
@@ -32,6 +32,7 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     String sessionId,
     Map<String, OrtValue> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
   }) {
     // Store the inputs for later assertions
     lastRunInputs = {
@@ -114,6 +115,35 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     });
   }
 
+  @override
+  Future<Map<String, dynamic>> quantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+    required String dataType,
+  }) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> dequantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+  }) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> reshapeOrtValue(String valueId, List<int> shape) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> sliceOrtValue(String valueId, int axis, int start, [int? end]) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> transposeOrtValue(String valueId, [List<int>? perm]) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> concatOrtValues(List<String> valueIds, int axis) => Future.value({});
+
   @override
   Future<Map<String, dynamic>> getOrtValueData(String valueId) {
     return Future.value({
@@ -125,8 +155,176 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   @override
   Future<void> releaseOrtValue(String valueId) => Future.value();
 
+  @override
+  Future<void> releaseOrtValues(List<String> valueIds) => Future.value();
+
   @override
   Future<List<String>> getAvailableProviders() => Future.value(['CPU']);
+
+  @override
+  Future<void> setInferenceThreads(int numThreads) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> getQueueStats() => Future.value({});
+
+  @override
+  Future<int> cancelLowPriorityRuns() => Future.value(0);
+
+  @override
+  Future<bool> cancelRun(String runTag) => Future.value(false);
+
+  @override
+  Future<void> setIntegerHandles(bool enabled) => Future.value();
+
+  @override
+  Future<void> configureBatching(String sessionId, {required int windowMicros, required int maxBatchSize}) =>
+      Future.value();
+
+  @override
+  Future<Map<String, dynamic>> getBatchingStats(String sessionId) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getNativeContext() => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getSessionStats(String sessionId) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getMemoryStats() => Future.value({});
+
+  @override
+  Future<void> setMemoryLimit(int hardLimitBytes) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> endProfiling(String sessionId) => Future.value({});
+
+  @override
+  Future<void> startTracing() => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> stopTracing({String? path}) => Future.value({});
+
+  @override
+  Future<void> configureThreadPools({
+    required int intraOpNumThreads,
+    required int interOpNumThreads,
+    bool allowSpinning = true,
+    String? intraOpThreadAffinity,
+  }) => Future.value();
+
+  @override
+  Future<void> configureSharedArena({
+    int maxBytes = 0,
+    String? extendStrategy,
+    int? initialChunkBytes,
+    int? maxDeadBytesPerChunk,
+  }) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createSessionFromBuffer(Uint8List modelData, {Map<String, dynamic>? sessionOptions}) =>
+      Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> createSessionFromMappedFile(String modelPath, {Map<String, dynamic>? sessionOptions}) =>
+      Future.value({});
+
+  @override
+  Future<void> configureSessionCache({required int maxSessions, required int maxBytes}) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createImageTensor(
+    Uint8List data, {
+    required String format,
+    required int width,
+    required int height,
+    int? targetWidth,
+    int? targetHeight,
+    List<double>? mean,
+    List<double>? std,
+    required String layout,
+    required String dataType,
+  }) => Future.value({});
+
+  @override
+  Future<List<Map<String, dynamic>>> runBatch(
+    String sessionId,
+    List<Map<String, OrtValue>> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value([]);
+
+  @override
+  Future<Map<String, dynamic>> bindOutputs(String sessionId, {List<String>? outputNames}) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> runWithBinding(
+    String sessionId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({});
+
+  @override
+  Future<void> unbindOutputs(String sessionId) => Future.value();
+
+  @override
+  Future<void> enableSequenceState(
+    String sessionId,
+    Map<String, String> loops, {
+    Map<String, int> initialDimensions = const {},
+  }) => Future.value();
+
+  @override
+  Future<void> resetSequenceState(String sessionId) => Future.value();
+
+  @override
+  Future<void> disableSequenceState(String sessionId) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createPipeline(List<Map<String, dynamic>> stages, Map<String, String> outputs) =>
+      Future.value({'pipelineId': 'test_pipeline_id'});
+
+  @override
+  Future<Map<String, dynamic>> runPipeline(
+    String pipelineId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({});
+
+  @override
+  Future<void> closePipeline(String pipelineId) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> runTensorOp(
+    String op,
+    Map<String, OrtValue> inputs, {
+    Map<String, Object> params = const {},
+  }) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> openStream(String sessionId, {int depth = 2}) =>
+      Future.value({'streamId': 'test_stream_id'});
+
+  @override
+  Future<Map<String, dynamic>> submitStreamFrame(
+    String streamId,
+    Map<String, TypedData> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({'frame': 0});
+
+  @override
+  Future<void> closeStream(String streamId) => Future.value();
+
+  @override
+  Stream<Map<String, dynamic>> get streamEvents => const Stream.empty();
+
+  @override
+  Future<Map<String, dynamic>> generate(String sessionId, List<int> prompt, {Map<String, dynamic>? options}) =>
+      Future.value({'generationId': 'test_generation_id'});
+
+  @override
+  Future<void> cancelGeneration(String generationId) => Future.value();
+
+  @override
+  Stream<Map<String, dynamic>> get generationEvents => const Stream.empty();
 }
 
 class ConversionTrackingMock extends MockFlutterOnnxruntimePlatform {
@@ -10,6 +10,7 @@ import 'package:flutter/foundation.dart' show kIsWeb;
 import 'package:flutter_test/flutter_test.dart';
 import 'package:flutter_onnxruntime/flutter_onnxruntime.dart';
 import 'package:flutter_onnxruntime/src/flutter_onnxruntime_platform_interface.dart';
+import 'package:flutter_onnxruntime/src/ort_value.dart' show visitOrtValues;
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 
 class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements FlutterOnnxruntimePlatform {
@@ -19,7 +20,9 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
   List<int>? lastShape;
   String? lastValueIdForConversion;
   String? lastValueIdForRelease;
+  List<String>? lastValueIdsForRelease;
   String? lastValueIdForData;
+  Map<String, dynamic>? lastImageArguments;
 
   @override
   Future<String?> getPlatformVersion() => Future.value('42');
@@ -38,6 +41,7 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     String sessionId,
     Map<String, dynamic> inputs, {
     Map<String, dynamic>? runOptions,
+    List<String>? outputNames,
   }) {
     return Future.value({
       'outputs': {
@@ -76,6 +80,77 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     });
   }
 
+  Map<String, dynamic>? lastQuantizeArguments;
+
+  @override
+  Future<Map<String, dynamic>> quantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+    required String dataType,
+  }) {
+    lastQuantizeArguments = {'valueId': valueId, 'scales': scales, 'zeroPoints': zeroPoints, 'axis': axis};
+    return Future.value({
+      'valueId': 'quantized_$valueId',
+      'dataType': dataType,
+      'shape': [2, 2],
+    });
+  }
+
+  @override
+  Future<Map<String, dynamic>> dequantizeOrtValue(
+    String valueId, {
+    required List<double> scales,
+    List<int> zeroPoints = const [],
+    int axis = 1,
+  }) {
+    lastQuantizeArguments = {'valueId': valueId, 'scales': scales, 'zeroPoints': zeroPoints, 'axis': axis};
+    return Future.value({
+      'valueId': 'dequantized_$valueId',
+      'dataType': 'float32',
+      'shape': [2, 2],
+    });
+  }
+
+  Map<String, dynamic>? lastViewArguments;
+
+  @override
+  Future<Map<String, dynamic>> reshapeOrtValue(String valueId, List<int> shape) {
+    lastViewArguments = {'method': 'reshape', 'valueId': valueId, 'shape': shape};
+    return Future.value({'valueId': 'reshaped_$valueId', 'dataType': 'float32', 'shape': shape});
+  }
+
+  @override
+  Future<Map<String, dynamic>> sliceOrtValue(String valueId, int axis, int start, [int? end]) {
+    lastViewArguments = {'method': 'slice', 'valueId': valueId, 'axis': axis, 'start': start, 'end': end};
+    return Future.value({
+      'valueId': 'sliced_$valueId',
+      'dataType': 'float32',
+      'shape': end == null ? [2] : [end - start, 2],
+    });
+  }
+
+  @override
+  Future<Map<String, dynamic>> transposeOrtValue(String valueId, [List<int>? perm]) {
+    lastViewArguments = {'method': 'transpose', 'valueId': valueId, 'perm': perm};
+    return Future.value({
+      'valueId': 'transposed_$valueId',
+      'dataType': 'float32',
+      'shape': [2, 2],
+    });
+  }
+
+  @override
+  Future<Map<String, dynamic>> concatOrtValues(List<String> valueIds, int axis) {
+    lastViewArguments = {'method': 'concat', 'valueIds': valueIds, 'axis': axis};
+    return Future.value({
+      'valueId': 'concatenated',
+      'dataType': 'float32',
+      'shape': [2 * valueIds.length, 2],
+    });
+  }
+
   @override
   Future<Map<String, dynamic>> getOrtValueData(String valueId) {
     // Track the call
@@ -94,6 +169,12 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
     return Future.value();
   }
 
+  @override
+  Future<void> releaseOrtValues(List<String> valueIds) {
+    lastValueIdsForRelease = valueIds;
+    return Future.value();
+  }
+
   @override
   Future<void> closeSession(String sessionId) => Future.value();
 
@@ -114,6 +195,208 @@ class MockFlutterOnnxruntimePlatform with MockPlatformInterfaceMixin implements
 
   @override
   Future<List<String>> getAvailableProviders() => Future.value(['CPU']);
+
+  @override
+  Future<void> setInferenceThreads(int numThreads) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> getQueueStats() => Future.value({});
+
+  @override
+  Future<int> cancelLowPriorityRuns() => Future.value(0);
+
+  @override
+  Future<bool> cancelRun(String runTag) => Future.value(false);
+
+  @override
+  Future<void> setIntegerHandles(bool enabled) => Future.value();
+
+  @override
+  Future<void> configureBatching(String sessionId, {required int windowMicros, required int maxBatchSize}) =>
+      Future.value();
+
+  @override
+  Future<Map<String, dynamic>> getBatchingStats(String sessionId) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getNativeContext() => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getSessionStats(String sessionId) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> getMemoryStats() => Future.value({});
+
+  @override
+  Future<void> setMemoryLimit(int hardLimitBytes) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> endProfiling(String sessionId) => Future.value({});
+
+  @override
+  Future<void> startTracing() => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> stopTracing({String? path}) => Future.value({});
+
+  @override
+  Future<void> configureThreadPools({
+    required int intraOpNumThreads,
+    required int interOpNumThreads,
+    bool allowSpinning = true,
+    String? intraOpThreadAffinity,
+  }) => Future.value();
+
+  @override
+  Future<void> configureSharedArena({
+    int maxBytes = 0,
+    String? extendStrategy,
+    int? initialChunkBytes,
+    int? maxDeadBytesPerChunk,
+  }) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createSessionFromBuffer(Uint8List modelData, {Map<String, dynamic>? sessionOptions}) =>
+      Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> createSessionFromMappedFile(String modelPath, {Map<String, dynamic>? sessionOptions}) =>
+      Future.value({});
+
+  @override
+  Future<void> configureSessionCache({required int maxSessions, required int maxBytes}) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createImageTensor(
+    Uint8List data, {
+    required String format,
+    required int width,
+    required int height,
+    int? targetWidth,
+    int? targetHeight,
+    List<double>? mean,
+    List<double>? std,
+    required String layout,
+    required String dataType,
+  }) {
+    lastImageArguments = {
+      'data': data,
+      'format': format,
+      'width': width,
+      'height': height,
+      'targetWidth': targetWidth,
+      'targetHeight': targetHeight,
+      'mean': mean,
+      'std': std,
+      'layout': layout,
+      'dataType': dataType,
+    };
+    final outWidth = targetWidth ?? width;
+    final outHeight = targetHeight ?? height;
+    return Future.value({
+      'valueId': 'test_image_id',
+      'dataType': dataType,
+      'shape': layout == 'nchw' ? [1, 3, outHeight, outWidth] : [1, outHeight, outWidth, 3],
+    });
+  }
+
+  @override
+  Future<List<Map<String, dynamic>>> runBatch(
+    String sessionId,
+    List<Map<String, OrtValue>> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value([]);
+
+  @override
+  Future<Map<String, dynamic>> bindOutputs(String sessionId, {List<String>? outputNames}) => Future.value({});
+
+  @override
+  Future<Map<String, dynamic>> runWithBinding(
+    String sessionId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({});
+
+  @override
+  Future<void> unbindOutputs(String sessionId) => Future.value();
+
+  @override
+  Future<void> enableSequenceState(
+    String sessionId,
+    Map<String, String> loops, {
+    Map<String, int> initialDimensions = const {},
+  }) => Future.value();
+
+  @override
+  Future<void> resetSequenceState(String sessionId) => Future.value();
+
+  @override
+  Future<void> disableSequenceState(String sessionId) => Future.value();
+
+  @override
+  Future<Map<String, dynamic>> createPipeline(List<Map<String, dynamic>> stages, Map<String, String> outputs) =>
+      Future.value({'pipelineId': 'test_pipeline_id'});
+
+  @override
+  Future<Map<String, dynamic>> runPipeline(
+    String pipelineId,
+    Map<String, OrtValue> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({});
+
+  @override
+  Future<void> closePipeline(String pipelineId) => Future.value();
+
+  Map<String, dynamic>? lastTensorOp;
+
+  @override
+  Future<Map<String, dynamic>> runTensorOp(
+    String op,
+    Map<String, OrtValue> inputs, {
+    Map<String, Object> params = const {},
+  }) {
+    lastTensorOp = {'op': op, 'inputs': inputs.map((name, value) => MapEntry(name, value.id)), 'params': params};
+    final outputNames = switch (op) {
+      'topK' => ['values', 'indices'],
+      'nms' => ['boxes', 'scores', 'indices'],
+      _ => ['output'],
+    };
+    return Future.value({
+      for (final name in outputNames)
+        name: [
+          '${op}_$name',
+          name == 'indices' || op == 'argmax' ? 'int64' : 'float32',
+          [2],
+        ],
+    });
+  }
+
+  @override
+  Future<Map<String, dynamic>> openStream(String sessionId, {int depth = 2}) =>
+      Future.value({'streamId': 'test_stream_id'});
+
+  @override
+  Future<Map<String, dynamic>> submitStreamFrame(
+    String streamId,
+    Map<String, TypedData> inputs, {
+    Map<String, dynamic>? runOptions,
+  }) => Future.value({'frame': 0});
+
+  @override
+  Future<void> closeStream(String streamId) => Future.value();
+
+  @override
+  Stream<Map<String, dynamic>> get streamEvents => const Stream.empty();
+
+  @override
+  Future<Map<String, dynamic>> generate(String sessionId, List<int> prompt, {Map<String, dynamic>? options}) =>
+      Future.value({'generationId': 'test_generation_id'});
+
+  @override
+  Future<void> cancelGeneration(String generationId) => Future.value();
+
+  @override
+  Stream<Map<String, dynamic>> get generationEvents => const Stream.empty();
 }
 
 class MockFlutterOnnxruntimePlatformWithShapedData extends MockFlutterOnnxruntimePlatform {
@@ -330,6 +613,104 @@ void main() {
 
       expect(() => OrtValue.fromList(testData, testShape), throwsArgumentError);
     });
+
+    test('fromList with Float64List should create a float64 OrtValue', () async {
+      final testData = Float64List.fromList([1.0, 2.0, 3.0, 4.0]);
+
+      final tensor = await OrtValue.fromList(testData, [2, 2]);
+
+      expect(mockPlatform.lastSourceType, 'float64');
+      expect(mockPlatform.lastSourceData, testData);
+      expect(tensor.dataType, OrtDataType.float64);
+    });
+
+    test('fromList with Int16List should send its raw bytes', () async {
+      final testData = Int16List.fromList([1, -2, 3, -4]);
+
+      final tensor = await OrtValue.fromList(testData, [4]);
+
+      expect(mockPlatform.lastSourceType, 'int16');
+      expect(mockPlatform.lastSourceData, isA<Uint8List>());
+      expect((mockPlatform.lastSourceData as Uint8List).length, 8);
+      expect(tensor.dataType, OrtDataType.int16);
+    });
+  });
+
+  group('OrtValue creation with fromBytes', () {
+    test('fromBytes forwards float16 bytes unchanged', () async {
+      final halfBits = Uint16List.fromList([0x3C00, 0x4000, 0x4200, 0x4400]);
+      final bytes = halfBits.buffer.asUint8List();
+
+      final tensor = await OrtValue.fromBytes(bytes, OrtDataType.float16, [2, 2]);
+
+      expect(mockPlatform.lastSourceType, 'float16');
+      expect(mockPlatform.lastSourceData, bytes);
+      expect(mockPlatform.lastShape, [2, 2]);
+      expect(tensor.dataType, OrtDataType.float16);
+    });
+
+    test('fromBytes with a size mismatch should throw ArgumentError', () async {
+      final bytes = Uint8List(6);
+
+      expect(() => OrtValue.fromBytes(bytes, OrtDataType.float32, [2]), throwsArgumentError);
+    });
+
+    test('fromBytes with string type should throw ArgumentError', () async {
+      expect(() => OrtValue.fromBytes(Uint8List(4), OrtDataType.string, [1]), throwsArgumentError);
+    });
+  });
+
+  group('OrtValue creation with fromImage', () {
+    test('fromImage forwards the image and preprocessing options', () async {
+      final pixels = Uint8List(4 * 4 * 4);
+
+      final tensor = await OrtValue.fromImage(
+        pixels,
+        format: OrtImageFormat.bgra,
+        width: 4,
+        height: 4,
+        targetWidth: 2,
+        targetHeight: 2,
+        mean: [0.5, 0.5, 0.5],
+        std: [0.25, 0.25, 0.25],
+        dataType: OrtDataType.float16,
+      );
+
+      expect(mockPlatform.lastImageArguments, {
+        'data': pixels,
+        'format': 'bgra',
+        'width': 4,
+        'height': 4,
+        'targetWidth': 2,
+        'targetHeight': 2,
+        'mean': [0.5, 0.5, 0.5],
+        'std': [0.25, 0.25, 0.25],
+        'layout': 'nchw',
+        'dataType': 'float16',
+      });
+      expect(tensor.dataType, OrtDataType.float16);
+      expect(tensor.shape, [1, 3, 2, 2]);
+    });
+
+    test('fromImage with an integer data type should throw ArgumentError', () async {
+      expect(
+        () => OrtValue.fromImage(
+          Uint8List(3),
+          format: OrtImageFormat.rgb,
+          width: 1,
+          height: 1,
+          dataType: OrtDataType.uint8,
+        ),
+        throwsArgumentError,
+      );
+    });
+
+    test('fromImage with a mean of the wrong length should throw ArgumentError', () async {
+      expect(
+        () => OrtValue.fromImage(Uint8List(3), format: OrtImageFormat.rgb, width: 1, height: 1, mean: [0.5]),
+        throwsArgumentError,
+      );
+    });
   });
 
   group('OrtValue conversion', () {
@@ -348,6 +729,145 @@ void main() {
       expect(convertedTensor.dataType, OrtDataType.int32);
       expect(convertedTensor.shape, [2, 2]);
     });
+
+    test('quantize() and dequantize() pass the scales, zero points and axis', () async {
+      final tensor = await OrtValue.fromList(Float32List.fromList([1.0, 2.0, 3.0, 4.0]), [2, 2]);
+      final quantization = OrtQuantization(
+        scales: [0.5, 0.25],
+        zeroPoints: [3, -4],
+        axis: 0,
+        dataType: OrtDataType.int8,
+      );
+
+      final quantized = await tensor.quantize(quantization);
+      expect(mockPlatform.lastQuantizeArguments, {
+        'valueId': tensor.id,
+        'scales': [0.5, 0.25],
+        'zeroPoints': [3, -4],
+        'axis': 0,
+      });
+      expect(quantized.dataType, OrtDataType.int8);
+
+      final dequantized = await quantized.dequantize(quantization);
+      expect(mockPlatform.lastQuantizeArguments?['valueId'], quantized.id);
+      expect(dequantized.dataType, OrtDataType.float32);
+
+      expect(() => tensor.dequantize(quantization), throwsStateError);
+    });
+
+    test('reshape(), slice(), select() and transpose() pass their arguments', () async {
+      final tensor = await OrtValue.fromList(Float32List.fromList([1.0, 2.0, 3.0, 4.0]), [2, 2]);
+
+      final flat = await tensor.reshape([-1]);
+      expect(mockPlatform.lastViewArguments, {
+        'method': 'reshape',
+        'valueId': tensor.id,
+        'shape': [-1],
+      });
+      expect(flat.id, 'reshaped_${tensor.id}');
+
+      final rows = await tensor.slice(0, 1, 2);
+      expect(mockPlatform.lastViewArguments, {
+        'method': 'slice',
+        'valueId': tensor.id,
+        'axis': 0,
+        'start': 1,
+        'end': 2,
+      });
+      expect(rows.shape, [1, 2]);
+
+      final row = await tensor.select(0, -1);
+      expect(mockPlatform.lastViewArguments?['end'], isNull);
+      expect(mockPlatform.lastViewArguments?['start'], -1);
+      expect(row.shape, [2]);
+
+      await tensor.transpose();
+      expect(mockPlatform.lastViewArguments?['perm'], isNull);
+      await tensor.transpose([1, 0]);
+      expect(mockPlatform.lastViewArguments?['perm'], [1, 0]);
+    });
+
+    test('concat() joins native tensors and rejects inline and empty lists', () async {
+      final first = await OrtValue.fromList(Float32List.fromList([1.0, 2.0, 3.0, 4.0]), [2, 2]);
+      final second = await OrtValue.fromList(Float32List.fromList([5.0, 6.0, 7.0, 8.0]), [2, 2]);
+
+      final joined = await OrtValue.concat([first, second], axis: -2);
+      expect(mockPlatform.lastViewArguments, {
+        'method': 'concat',
+        'valueIds': [first.id, second.id],
+        'axis': -2,
+      });
+      expect(joined.shape, [4, 2]);
+
+      final inline = OrtValue.fromMap({
+        'data': [1.0, 2.0],
+        'dataType': 'float32',
+        'shape': [1, 2],
+      });
+      expect(() => OrtValue.concat([first, inline]), throwsStateError);
+      expect(() => OrtValue.concat([]), throwsArgumentError);
+      expect(() => inline.reshape([2]), throwsStateError);
+    });
+
+    test('OrtQuantization checks its type and zero points and round-trips through a map', () {
+      expect(() => OrtQuantization(scales: [1.0], dataType: OrtDataType.int32), throwsArgumentError);
+      expect(() => OrtQuantization(scales: [1.0, 2.0], zeroPoints: [0]), throwsArgumentError);
+      final quantization = OrtQuantization.fromMap({
+        'scales': [0.5, 1],
+        'zeroPoints': [128, 128],
+        'axis': -1,
+        'dataType': 'uint8',
+      });
+      expect(quantization.scales, [0.5, 1.0]);
+      expect(quantization.toMap(), {
+        'scales': [0.5, 1.0],
+        'zeroPoints': [128, 128],
+        'axis': -1,
+        'dataType': 'uint8',
+      });
+    });
+  });
+
+  group('OrtOps', () {
+    test('softmax(), sigmoid() and argmax() run the op on the tensor with its axis', () async {
+      final tensor = await OrtValue.fromList(Float32List.fromList([1.0, 2.0, 3.0, 4.0]), [2, 2]);
+
+      final probabilities = await OrtOps.softmax(tensor, axis: 0);
+      expect(mockPlatform.lastTensorOp, {
+        'op': 'softmax',
+        'inputs': {'input': tensor.id},
+        'params': {'axis': 0},
+      });
+      expect(probabilities.id, 'softmax_output');
+      expect(probabilities.dataType, OrtDataType.float32);
+
+      await OrtOps.sigmoid(tensor);
+      expect(mockPlatform.lastTensorOp?['op'], 'sigmoid');
+
+      final labels = await OrtOps.argmax(tensor);
+      expect(mockPlatform.lastTensorOp?['params'], {'axis': -1});
+      expect(labels.dataType, OrtDataType.int64);
+    });
+
+    test('topK() and nms() return every output of the op', () async {
+      final boxes = await OrtValue.fromList(Float32List.fromList([0, 0, 1, 1, 0, 0, 2, 2]), [2, 4]);
+      final scores = await OrtValue.fromList(Float32List.fromList([0.9, 0.8]), [2]);
+
+      final top = await OrtOps.topK(scores, 1);
+      expect(mockPlatform.lastTensorOp?['params'], {'k': 1});
+      expect(top.values.id, 'topK_values');
+      expect(top.indices.dataType, OrtDataType.int64);
+
+      final kept = await OrtOps.nms(boxes, scores, iouThreshold: 0.4, maxDetections: 5);
+      expect(mockPlatform.lastTensorOp, {
+        'op': 'nms',
+        'inputs': {'boxes': boxes.id, 'scores': scores.id},
+        'params': {'iouThreshold': 0.4, 'maxDetections': 5},
+      });
+      expect(kept.boxes.id, 'nms_boxes');
+      expect(kept.scores.id, 'nms_scores');
+      expect(kept.indices.dataType, OrtDataType.int64);
+    });
   });
 
   group('OrtValue data extraction', () {
@@ -397,6 +917,22 @@ void main() {
       expect(data[2], 3.0);
       expect(data[3], 4.0);
     });
+
+    test('asTypedData() falls back to a typed copy without a native context', () async {
+      final tensor = await OrtValue.fromList(Float32List.fromList([1.0, 2.0, 3.0, 4.0]), [2, 2]);
+
+      final data = await tensor.asTypedData();
+
+      expect(mockPlatform.lastValueIdForData, tensor.id);
+      expect(data, isA<Float32List>());
+      expect(data as Float32List, [1.0, 2.0, 3.0, 4.0]);
+    });
+
+    test('asTypedData() should throw UnsupportedError for string tensors', () async {
+      final tensor = await OrtValue.fromList(['a', 'b'], [2]);
+
+      expect(() => tensor.asTypedData(), throwsUnsupportedError);
+    });
   });
 
   group('OrtValue memory management', () {
@@ -412,6 +948,143 @@ void main() {
       // Verify release was called with the correct ID
       expect(mockPlatform.lastValueIdForRelease, valueId);
     });
+
+    OrtValue valueFromId(String valueId) =>
+        OrtValue.fromMap({'valueId': valueId, 'dataType': 'float32', 'shape': [1]});
+
+    test('releaseAll releases every value in one call and skips inline values', () async {
+      final inline = OrtValue.fromMap({
+        'data': [1.0],
+        'dataType': 'float32',
+        'shape': [1],
+      });
+
+      await OrtValue.releaseAll([valueFromId('value_a'), inline, valueFromId('value_b')]);
+
+      expect(mockPlatform.lastValueIdsForRelease, ['value_a', 'value_b']);
+      expect(mockPlatform.lastValueIdForRelease, isNull);
+    });
+
+    test('a scope releases the values created inside it when it ends', () async {
+      final before = valueFromId('before');
+      final scope = OrtValue.beginScope();
+      final first = valueFromId('first');
+      final kept = scope.keep(valueFromId('kept'));
+      final converted = await first.to(OrtDataType.int32);
+      expect(scope.values, [first, converted]);
+
+      await scope.end();
+
+      expect(mockPlatform.lastValueIdsForRelease, ['first', converted.id]);
+      expect(mockPlatform.lastValueIdsForRelease, isNot(contains(before.id)));
+      expect(mockPlatform.lastValueIdsForRelease, isNot(contains(kept.id)));
+      await expectLater(scope.end(), throwsStateError);
+    });
+
+    test('nested scopes end innermost first', () async {
+      final outer = OrtValue.beginScope();
+      final inner = OrtValue.beginScope();
+      final kept = inner.keep(valueFromId('inner_kept'));
+
+      await expectLater(outer.end(), throwsStateError);
+      await inner.end();
+      expect(outer.values, [kept]);
+
+      await outer.end();
+      expect(mockPlatform.lastValueIdsForRelease, ['inner_kept']);
+    });
+
+    test('trackedBytes counts each native tensor once until it is released', () async {
+      final start = OrtValue.trackedBytes;
+      final value = OrtValue.fromMap({
+        'valueId': 'tracked',
+        'dataType': 'float32',
+        'shape': [2, 8],
+      });
+      expect(OrtValue.trackedBytes, start + 64);
+
+      // Another wrapper of the same tensor, such as a repeated bound output, is not counted again
+      OrtValue.fromMap({
+        'valueId': 'tracked',
+        'dataType': 'float32',
+        'shape': [2, 8],
+      });
+      expect(OrtValue.trackedBytes, start + 64);
+
+      await value.dispose();
+      expect(OrtValue.trackedBytes, start);
+    });
+
+    test('transfer() stops counting a value and adopt() counts it again', () async {
+      final start = OrtValue.trackedBytes;
+      final value = OrtValue.fromMap({
+        'valueId': 'transferred',
+        'dataType': 'float32',
+        'shape': [4],
+      });
+      expect(OrtValue.trackedBytes, start + 16);
+
+      expect(value.transfer(), same(value));
+      expect(OrtValue.trackedBytes, start);
+      value.transfer();
+      expect(OrtValue.trackedBytes, start);
+
+      value.adopt().adopt();
+      expect(OrtValue.trackedBytes, start + 16);
+      await value.dispose();
+      expect(OrtValue.trackedBytes, start);
+      expect(mockPlatform.lastValueIdForRelease, 'transferred');
+    });
+
+    test('visitOrtValues finds the values in nested lists and maps', () async {
+      OrtValue valueFromId(String valueId) =>
+          OrtValue.fromMap({'valueId': valueId, 'dataType': 'float32', 'shape': [1]});
+      final first = valueFromId('visit_a');
+      final second = valueFromId('visit_b');
+      final third = valueFromId('visit_c');
+
+      final visited = <OrtValue>[];
+      visitOrtValues({
+        'outputs': [
+          first,
+          {'nested': second},
+        ],
+        'score': 0.5,
+        'last': {third},
+      }, visited.add);
+      expect(visited, [first, second, third]);
+      await OrtValue.releaseAll(visited);
+    });
+
+    test('rising above the soft memory limit calls its callback once', () async {
+      final reported = <int>[];
+      OrtValue.setSoftMemoryLimit(OrtValue.trackedBytes + 100, onExceeded: reported.add);
+      addTearDown(() => OrtValue.setSoftMemoryLimit(null));
+
+      final small = OrtValue.fromMap({
+        'valueId': 'soft_small',
+        'dataType': 'float32',
+        'shape': [10],
+      });
+      await Future<void>.delayed(Duration.zero);
+      expect(reported, isEmpty);
+
+      final large = OrtValue.fromMap({
+        'valueId': 'soft_large',
+        'dataType': 'float32',
+        'shape': [20],
+      });
+      final third = OrtValue.fromMap({
+        'valueId': 'soft_third',
+        'dataType': 'uint8',
+        'shape': [4],
+      });
+      await Future<void>.delayed(Duration.zero);
+      expect(reported, [OrtValue.trackedBytes]);
+
+      await OrtValue.releaseAll([small, large, third]);
+      expect(() => OrtValue.setSoftMemoryLimit(100), throwsArgumentError);
+    });
   });
 
   group('OrtValue creation from map', () {
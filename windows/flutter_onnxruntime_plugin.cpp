@@ -12,17 +12,44 @@
 // For getPlatformVersion; remove unless needed for your plugin implementation.
 #include <VersionHelpers.h>
 
+#include <flutter/event_channel.h>
+#include <flutter/event_stream_handler_functions.h>
 #include <flutter/method_channel.h>
 #include <flutter/plugin_registrar.h>
 #include <flutter/plugin_registrar_windows.h>
 #include <flutter/standard_method_codec.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
+
+#ifdef FLUTTER_ONNXRUNTIME_DIRECTML
+#include <dml_provider_factory.h>
+#endif
 
 // Include our implementation headers
-#include "src/session_manager.h"
-#include "src/tensor_manager.h"
+#include "core/element_types.h"
+#include "core/frame_stream.h"
+#include "core/generation.h"
+#include "core/image_preprocess.h"
+#include "core/inference_executor.h"
+#include "core/micro_batcher.h"
+#include "core/native_api.h"
+#include "core/pipeline.h"
+#include "core/profile_summary.h"
+#include "core/quantization.h"
+#include "core/run_control.h"
+#include "core/session_manager.h"
+#include "core/tensor_codec.h"
+#include "core/tensor_manager.h"
+#include "core/trace_recorder.h"
+#include "src/platform_task_runner.h"
 #include "src/value_conversion.h"
 #include "src/windows_utils.h"
 
@@ -30,23 +57,617 @@
 
 namespace flutter_onnxruntime {
 
+// A runInference call waiting in the micro-batcher, with its inputs already borrowed
+struct BatchedInference {
+  std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> result;
+  std::vector<TensorLease> input_leases;
+  std::vector<const OrtValue *> input_values;
+  std::vector<std::string> input_names;
+};
+
+// Inputs of a call, borrowed on the platform thread when the call arrives so that Dart cannot release them before
+// its handler runs; one list of values and names per inputs map, so several for runBatch and one otherwise
+struct CallInputs {
+  std::vector<TensorLease> leases;
+  std::vector<std::vector<const OrtValue *>> values;
+  std::vector<std::vector<std::string>> names;
+  uint64_t nanos = 0;
+};
+
 // Private implementation class to hold managers
 class FlutterOnnxruntimePluginImpl {
 public:
-  FlutterOnnxruntimePluginImpl()
-      : sessionManager_(std::make_unique<SessionManager>()), tensorManager_(std::make_unique<TensorManager>()) {}
+  explicit FlutterOnnxruntimePluginImpl(flutter::PluginRegistrarWindows *registrar)
+      : tensorManager_(std::make_unique<TensorManager>()), sessionManager_(std::make_unique<SessionManager>()),
+        pipelineManager_(std::make_unique<PipelineManager>()), streamManager_(std::make_unique<FrameStreamManager>()),
+        streamChannel_(std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
+            registrar->messenger(), "flutter_onnxruntime/streams", &flutter::StandardMethodCodec::GetInstance())),
+        generationManager_(std::make_unique<GenerationManager>()),
+        generationChannel_(std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
+            registrar->messenger(), "flutter_onnxruntime/generation", &flutter::StandardMethodCodec::GetInstance())),
+        platformTaskRunner_(std::make_unique<PlatformTaskRunner>(registrar)),
+        runRegistry_(std::make_unique<RunRegistry>()),
+        inferenceExecutor_(std::make_unique<InferenceExecutor>(kDefaultInferenceThreads)),
+        sessionLoader_(std::make_unique<InferenceExecutor>(kSessionLoaderThreads)),
+        microBatcher_(std::make_unique<MicroBatcher<BatchedInference>>(
+            [this](SessionHandle session_id, std::vector<BatchedInference> &&batch) {
+              DispatchBatch(session_id, std::move(batch));
+            })),
+        nativeContext_{sessionManager_.get(), tensorManager_.get(), inferenceExecutor_.get()} {
+    // Outputs left in device memory are copied to the host only when Dart reads them
+    SessionManager *session_manager = sessionManager_.get();
+    tensorManager_->setHostCopier(
+        [session_manager](const OrtValue *value) { return session_manager->copyToHost(value); });
+
+    // Results of stream frames and generated tokens go to the one sink of the Dart broadcast stream listening to
+    // each channel
+    ListenWithSink(*streamChannel_, &streamSink_);
+    ListenWithSink(*generationChannel_, &generationSink_);
+  }
 
-  // Manager instances
-  std::unique_ptr<SessionManager> sessionManager_;
+  ~FlutterOnnxruntimePluginImpl() {
+    // Generations would otherwise keep running to their token limit while the workers are joined
+    generationManager_->cancelAll();
+    streamChannel_->SetStreamHandler(nullptr);
+    generationChannel_->SetStreamHandler(nullptr);
+  }
+
+  // Encode a handle for Dart: an integer in integer handle mode, otherwise a prefixed string ID
+  flutter::EncodableValue EncodeHandle(const char *prefix, Handle handle) const {
+    if (integerHandles_.load()) {
+      return flutter::EncodableValue(static_cast<int64_t>(handle));
+    }
+    return flutter::EncodableValue(formatHandle(prefix, handle));
+  }
+
+  // Manager instances. Sessions hold leases on bound output tensors, so the session manager
+  // is declared after the tensor manager to be destroyed before it.
   std::unique_ptr<TensorManager> tensorManager_;
+  std::unique_ptr<SessionManager> sessionManager_;
+
+  // Pipelines of sessions and glue ops run natively by runPipeline
+  std::unique_ptr<PipelineManager> pipelineManager_;
+
+  // Frame streams opened by openStream, destroyed before the managers whose tensors their slots hold
+  std::unique_ptr<FrameStreamManager> streamManager_;
+
+  // Sends the results of stream frames to Dart; the sink is only used on the platform thread
+  std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>> streamChannel_;
+  std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> streamSink_;
+
+  // Generations started by generate, whose tokens are sent to Dart over generationChannel_ from the platform thread
+  std::unique_ptr<GenerationManager> generationManager_;
+  std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>> generationChannel_;
+  std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> generationSink_;
+
+  // Delivers results from worker threads back to the platform thread
+  std::unique_ptr<PlatformTaskRunner> platformTaskRunner_;
+
+  // Whether handles are sent to Dart as integers; read from worker threads
+  std::atomic<bool> integerHandles_{false};
+
+  // Calls in flight that Dart can cancel by run tag or that have a timeout; the workers untrack the calls they run,
+  // so it is declared before them to be destroyed after them
+  std::unique_ptr<RunRegistry> runRegistry_;
+
+  // Worker pool that runs inference off the platform thread.
+  // Declared after the managers so it is destroyed first, joining workers before the managers go away.
+  std::unique_ptr<InferenceExecutor> inferenceExecutor_;
+
+  // Worker that creates and warms up sessions off the platform thread, destroyed before the managers likewise
+  std::unique_ptr<InferenceExecutor> sessionLoader_;
+
+  // Gathers concurrent runInference calls of sessions with micro-batching enabled into batches.
+  // Declared after the worker pool so the requests still waiting are handed to the workers before they are joined.
+  std::unique_ptr<MicroBatcher<BatchedInference>> microBatcher_;
+
+  // Addresses of the managers above, handed to Dart for the fort_* functions of native_api.h
+  NativeContext nativeContext_;
+
+private:
+  // Run a batch gathered by the micro-batcher on the inference worker pool
+  void DispatchBatch(SessionHandle session_id, std::vector<BatchedInference> &&batch);
+
+  // Keep the sink of the Dart stream listening to a channel in *sink while it listens
+  void ListenWithSink(flutter::EventChannel<flutter::EncodableValue> &channel,
+                      std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> *sink) {
+    channel.SetStreamHandler(std::make_unique<flutter::StreamHandlerFunctions<flutter::EncodableValue>>(
+        [sink](const flutter::EncodableValue *arguments,
+               std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> &&events)
+            -> std::unique_ptr<flutter::StreamHandlerError<flutter::EncodableValue>> {
+          *sink = std::move(events);
+          return nullptr;
+        },
+        [sink](const flutter::EncodableValue *arguments)
+            -> std::unique_ptr<flutter::StreamHandlerError<flutter::EncodableValue>> {
+          sink->reset();
+          return nullptr;
+        }));
+  }
 };
 
+namespace {
+
+// Prefixes of the string IDs used when integer handles are disabled
+constexpr char kSessionIdPrefix[] = "session_";
+constexpr char kTensorIdPrefix[] = "tensor_";
+constexpr char kPipelineIdPrefix[] = "pipeline_";
+constexpr char kStreamIdPrefix[] = "stream_";
+constexpr char kGenerationIdPrefix[] = "generation_";
+
+// Read a session or value ID sent as either an integer handle or a string ID.
+// Returns false if the value is not an ID; unknown IDs yield kInvalidHandle.
+bool ToHandle(const flutter::EncodableValue &value, const char *prefix, Handle *handle) {
+  if (std::holds_alternative<int64_t>(value)) {
+    *handle = static_cast<Handle>(std::get<int64_t>(value));
+    return true;
+  }
+  if (std::holds_alternative<int32_t>(value)) {
+    *handle = static_cast<Handle>(std::get<int32_t>(value));
+    return true;
+  }
+  if (std::holds_alternative<std::string>(value)) {
+    *handle = parseHandle(prefix, std::get<std::string>(value));
+    return true;
+  }
+  return false;
+}
+
+// Read the ID under a key of the arguments, like ToHandle; returns false if the key is missing
+bool LookupHandle(const flutter::EncodableMap &map, const char *key, const char *prefix, Handle *handle) {
+  auto it = map.find(flutter::EncodableValue(key));
+  return it != map.end() && ToHandle(it->second, prefix, handle);
+}
+
+// Read an integer argument sent as either a 32 or 64-bit value; returns false if the key is missing or not an integer
+bool LookupInt(const flutter::EncodableMap &map, const char *key, int64_t *value) {
+  auto it = map.find(flutter::EncodableValue(key));
+  if (it == map.end()) {
+    return false;
+  }
+  if (std::holds_alternative<int64_t>(it->second)) {
+    *value = std::get<int64_t>(it->second);
+    return true;
+  }
+  if (std::holds_alternative<int32_t>(it->second)) {
+    *value = std::get<int32_t>(it->second);
+    return true;
+  }
+  return false;
+}
+
+// Read a list of token ids or dimensions sent from Dart as an Int64List or a list of integers
+bool ReadTokens(const flutter::EncodableValue &value, std::vector<int64_t> *tokens) {
+  if (const auto *elements = std::get_if<std::vector<int64_t>>(&value)) {
+    tokens->assign(elements->begin(), elements->end());
+    return true;
+  }
+  if (const auto *elements = std::get_if<std::vector<int32_t>>(&value)) {
+    tokens->assign(elements->begin(), elements->end());
+    return true;
+  }
+  const auto *list = std::get_if<flutter::EncodableList>(&value);
+  if (list == nullptr) {
+    return false;
+  }
+  for (const auto &element : *list) {
+    if (const auto *int32_element = std::get_if<int32_t>(&element)) {
+      tokens->push_back(*int32_element);
+    } else if (const auto *int64_element = std::get_if<int64_t>(&element)) {
+      tokens->push_back(*int64_element);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Point at the element bytes of typed data from Dart: a typed list matching the source type, or a Uint8List
+// holding the little-endian element bytes of any fixed-size type (e.g. float16). Returns false for other data.
+bool GetTypedData(const flutter::EncodableValue &data_value, ONNXTensorElementDataType source_type, const void **data,
+                  size_t *byte_size) {
+  if (const auto *bytes = std::get_if<std::vector<uint8_t>>(&data_value)) {
+    if (!elementTypeInfo(source_type).convertible) {
+      return false;
+    }
+    *data = bytes->data();
+    *byte_size = bytes->size();
+    return true;
+  }
+  if (const auto *values = std::get_if<std::vector<int32_t>>(&data_value);
+      values && source_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32) {
+    *data = values->data();
+    *byte_size = values->size() * sizeof(int32_t);
+    return true;
+  }
+  if (const auto *values = std::get_if<std::vector<int64_t>>(&data_value);
+      values && source_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64) {
+    *data = values->data();
+    *byte_size = values->size() * sizeof(int64_t);
+    return true;
+  }
+  if (const auto *values = std::get_if<std::vector<float>>(&data_value);
+      values && source_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+    *data = values->data();
+    *byte_size = values->size() * sizeof(float);
+    return true;
+  }
+  if (const auto *values = std::get_if<std::vector<double>>(&data_value);
+      values && source_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE) {
+    *data = values->data();
+    *byte_size = values->size() * sizeof(double);
+    return true;
+  }
+  return false;
+}
+
+// Read an optional list of three per-channel numbers; returns false if it is present with another shape
+bool LookupChannelValues(const flutter::EncodableMap &map, const char *key, float *values) {
+  auto it = map.find(flutter::EncodableValue(key));
+  if (it == map.end() || std::holds_alternative<std::monostate>(it->second)) {
+    return true;
+  }
+  if (const auto *list = std::get_if<std::vector<double>>(&it->second)) {
+    if (list->size() != 3) {
+      return false;
+    }
+    for (int c = 0; c < 3; c++) {
+      values[c] = static_cast<float>((*list)[c]);
+    }
+    return true;
+  }
+  const auto *list = std::get_if<flutter::EncodableList>(&it->second);
+  if (list == nullptr || list->size() != 3) {
+    return false;
+  }
+  for (int c = 0; c < 3; c++) {
+    const flutter::EncodableValue &value = (*list)[c];
+    if (std::holds_alternative<double>(value)) {
+      values[c] = static_cast<float>(std::get<double>(value));
+    } else if (std::holds_alternative<int32_t>(value)) {
+      values[c] = static_cast<float>(std::get<int32_t>(value));
+    } else if (std::holds_alternative<int64_t>(value)) {
+      values[c] = static_cast<float>(std::get<int64_t>(value));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Read the scales, zero points and axis of a quantization sent by Dart; returns false if the scales are missing or
+// an entry has another type
+bool ReadQuantizationParams(const flutter::EncodableMap &args, QuantizationParams *params) {
+  auto scales_it = args.find(flutter::EncodableValue("scales"));
+  if (scales_it == args.end()) {
+    return false;
+  }
+  if (const auto *float_list = std::get_if<std::vector<double>>(&scales_it->second)) {
+    for (double scale : *float_list) {
+      params->scales.push_back(static_cast<float>(scale));
+    }
+  } else if (const auto *list = std::get_if<flutter::EncodableList>(&scales_it->second)) {
+    for (const auto &scale : *list) {
+      if (std::holds_alternative<double>(scale)) {
+        params->scales.push_back(static_cast<float>(std::get<double>(scale)));
+      } else if (std::holds_alternative<int32_t>(scale)) {
+        params->scales.push_back(static_cast<float>(std::get<int32_t>(scale)));
+      } else {
+        return false;
+      }
+    }
+  } else {
+    return false;
+  }
+
+  auto zero_points_it = args.find(flutter::EncodableValue("zeroPoints"));
+  if (zero_points_it != args.end() && !std::holds_alternative<std::monostate>(zero_points_it->second)) {
+    const auto *zero_points = std::get_if<flutter::EncodableList>(&zero_points_it->second);
+    if (zero_points == nullptr) {
+      return false;
+    }
+    for (const auto &zero_point : *zero_points) {
+      if (std::holds_alternative<int32_t>(zero_point)) {
+        params->zero_points.push_back(std::get<int32_t>(zero_point));
+      } else if (std::holds_alternative<int64_t>(zero_point)) {
+        // Values out of range of the quantized type stay out of range, and are rejected by the kernels
+        params->zero_points.push_back(
+            static_cast<int32_t>(std::clamp<int64_t>(std::get<int64_t>(zero_point), INT32_MIN, INT32_MAX)));
+      } else {
+        return false;
+      }
+    }
+  }
+
+  auto axis_it = args.find(flutter::EncodableValue("axis"));
+  if (axis_it != args.end() && !std::holds_alternative<std::monostate>(axis_it->second)) {
+    int64_t axis;
+    if (!LookupInt(args, "axis", &axis)) {
+      return false;
+    }
+    params->axis = axis;
+  }
+  return true;
+}
+
+// Describe the quantization of an input or output for Dart
+flutter::EncodableValue QuantizationToEncodable(const QuantizationParams &params) {
+  flutter::EncodableList scales;
+  flutter::EncodableList zero_points;
+  for (size_t i = 0; i < params.scales.size(); i++) {
+    scales.push_back(flutter::EncodableValue(static_cast<double>(params.scales[i])));
+    zero_points.push_back(flutter::EncodableValue(params.zero_points.empty() ? 0 : params.zero_points[i]));
+  }
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("scales")] = flutter::EncodableValue(scales);
+  map[flutter::EncodableValue("zeroPoints")] = flutter::EncodableValue(zero_points);
+  map[flutter::EncodableValue("axis")] = flutter::EncodableValue(params.axis);
+  map[flutter::EncodableValue("dataType")] = flutter::EncodableValue(elementTypeInfo(params.element_type).name);
+  return flutter::EncodableValue(map);
+}
+
+// Describe a tensor made by a plugin method to Dart as {valueId, dataType, shape}
+flutter::EncodableValue NewOrtValueToEncodable(const FlutterOnnxruntimePluginImpl &impl, TensorHandle value_id) {
+  flutter::EncodableList shape_list;
+  for (const auto &dim : impl.tensorManager_->getTensorShape(value_id)) {
+    shape_list.push_back(static_cast<int64_t>(dim));
+  }
+  flutter::EncodableMap response;
+  response[flutter::EncodableValue("valueId")] = impl.EncodeHandle(kTensorIdPrefix, value_id);
+  response[flutter::EncodableValue("dataType")] = flutter::EncodableValue(impl.tensorManager_->getTensorType(value_id));
+  response[flutter::EncodableValue("shape")] = flutter::EncodableValue(shape_list);
+  return flutter::EncodableValue(response);
+}
+
+// Whether a provider option value turns a flag on, as ONNX Runtime parses it
+bool IsProviderFlagOn(const std::string &value) { return value == "1" || value == "true" || value == "True"; }
+
+// Collect the options of an execution provider: device_id from deviceId, then the provider's entries of the
+// providerOptions map sent by Dart ({provider: {key: value}}), which may override it. An enabled TensorRT engine or
+// timing cache without a path of its own is placed in the app temp directory.
+// Returns false if the provider's options are not a map of strings; throws std::runtime_error if the cache directory
+// cannot be created.
+bool CollectProviderOptions(const flutter::EncodableMap &options_map, const std::string &provider,
+                            const std::string &device_id, std::map<std::string, std::string> *provider_options) {
+  (*provider_options)["device_id"] = device_id;
+
+  auto all_options_it = options_map.find(flutter::EncodableValue("providerOptions"));
+  const auto *all_options =
+      all_options_it != options_map.end() ? std::get_if<flutter::EncodableMap>(&all_options_it->second) : nullptr;
+  if (all_options) {
+    auto entries_it = all_options->find(flutter::EncodableValue(provider));
+    if (entries_it != all_options->end()) {
+      const auto *entries = std::get_if<flutter::EncodableMap>(&entries_it->second);
+      if (!entries) {
+        return false;
+      }
+      for (const auto &entry : *entries) {
+        const auto *key = std::get_if<std::string>(&entry.first);
+        const auto *value = std::get_if<std::string>(&entry.second);
+        if (!key || !value) {
+          return false;
+        }
+        (*provider_options)[*key] = *value;
+      }
+    }
+  }
+
+  if (provider == "TENSOR_RT") {
+    // Flags of the TensorRT caches and the options holding their directories
+    static const std::pair<const char *, const char *> kCaches[] = {
+        {"trt_engine_cache_enable", "trt_engine_cache_path"}, {"trt_timing_cache_enable", "trt_timing_cache_path"}};
+    const std::string cache_dir = WindowsUtils::getAppTempDirectory() + "tensorrt_engines";
+    for (const auto &[flag, path] : kCaches) {
+      auto flag_it = provider_options->find(flag);
+      if (flag_it == provider_options->end() || !IsProviderFlagOn(flag_it->second) || provider_options->count(path)) {
+        continue;
+      }
+      std::error_code error;
+      if (!std::filesystem::create_directories(std::filesystem::u8path(cache_dir), error) && error) {
+        throw std::runtime_error("Failed to create TensorRT cache directory: " + cache_dir);
+      }
+      (*provider_options)[path] = cache_dir;
+    }
+  }
+  return true;
+}
+
+// Look up the memory that runInference leaves its outputs in, from the outputDevice ("cuda" or "directml") and
+// outputDeviceId run options. Leaves memory_info null without an outputDevice; returns false if it is invalid.
+bool LookupOutputDevice(const flutter::EncodableMap &arguments, Ort::MemoryInfo *memory_info,
+                        std::string *error_message) {
+  auto run_options_it = arguments.find(flutter::EncodableValue("runOptions"));
+  if (run_options_it == arguments.end() || !std::holds_alternative<flutter::EncodableMap>(run_options_it->second)) {
+    return true;
+  }
+  const auto &run_options = std::get<flutter::EncodableMap>(run_options_it->second);
+  auto device_it = run_options.find(flutter::EncodableValue("outputDevice"));
+  if (device_it == run_options.end() || device_it->second.IsNull()) {
+    return true;
+  }
+  const auto *device = std::get_if<std::string>(&device_it->second);
+  if (!device) {
+    *error_message = "Output device must be a string";
+    return false;
+  }
+
+  int64_t device_id = 0;
+  LookupInt(run_options, "outputDeviceId", &device_id);
+
+  if (*device == "cuda") {
+    *memory_info = Ort::MemoryInfo("Cuda", OrtDeviceAllocator, static_cast<int>(device_id), OrtMemTypeDefault);
+    return true;
+  }
+  if (*device == "directml") {
+    *memory_info = Ort::MemoryInfo("DML", OrtDeviceAllocator, static_cast<int>(device_id), OrtMemTypeDefault);
+    return true;
+  }
+  *error_message = "Outputs cannot be kept on device " + *device;
+  return false;
+}
+
+// Largest output, in bytes, that runInference returns as data instead of storing it, from the returnDataMaxBytes run
+// option; 0 if every output is stored
+uint64_t LookupReturnDataMaxBytes(const flutter::EncodableMap &arguments) {
+  auto run_options_it = arguments.find(flutter::EncodableValue("runOptions"));
+  if (run_options_it == arguments.end() || !std::holds_alternative<flutter::EncodableMap>(run_options_it->second)) {
+    return 0;
+  }
+  int64_t max_bytes = 0;
+  LookupInt(std::get<flutter::EncodableMap>(run_options_it->second), "returnDataMaxBytes", &max_bytes);
+  return max_bytes > 0 ? static_cast<uint64_t>(max_bytes) : 0;
+}
+
+// Whether a host output is small enough to return as data; string tensors are always stored
+bool IsInlineOutput(Ort::Value &output, uint64_t max_bytes) {
+  if (max_bytes == 0 || !output.IsTensor()) {
+    return false;
+  }
+  Ort::TensorTypeAndShapeInfo info = output.GetTensorTypeAndShapeInfo();
+  size_t element_size = SessionManager::getElementSize(info.GetElementType());
+  return element_size > 0 && info.GetElementCount() * element_size <= max_bytes;
+}
+
+// Read the params of a glue op sent by Dart, which map to numbers or lists of integers, into a stage. Returns false if
+// a list holds anything else.
+bool ParseStageParams(const flutter::EncodableValue &params_value, PipelineStage *stage, std::string *error_message) {
+  if (const auto *params = std::get_if<flutter::EncodableMap>(&params_value)) {
+    for (const auto &[key, value] : *params) {
+      if (!std::holds_alternative<std::string>(key)) {
+        continue;
+      }
+      const std::string &param = std::get<std::string>(key);
+      if (const auto *int32_value = std::get_if<int32_t>(&value)) {
+        stage->scalars[param] = *int32_value;
+      } else if (const auto *int64_value = std::get_if<int64_t>(&value)) {
+        stage->scalars[param] = static_cast<double>(*int64_value);
+      } else if (const auto *double_value = std::get_if<double>(&value)) {
+        stage->scalars[param] = *double_value;
+      } else if (const auto *int64_list = std::get_if<std::vector<int64_t>>(&value)) {
+        stage->lists[param] = *int64_list;
+      } else if (const auto *list = std::get_if<flutter::EncodableList>(&value)) {
+        std::vector<int64_t> &elements = stage->lists[param];
+        for (const auto &element : *list) {
+          if (const auto *int32_element = std::get_if<int32_t>(&element)) {
+            elements.push_back(*int32_element);
+          } else if (const auto *int64_element = std::get_if<int64_t>(&element)) {
+            elements.push_back(*int64_element);
+          } else {
+            *error_message = "List parameter " + param + " must hold integers";
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Read a stage of a pipeline description sent by Dart: {name, op, sessionId, inputs, params}, where params maps to
+// numbers or lists of integers. Returns false if it is malformed.
+bool ParsePipelineStage(const flutter::EncodableValue &stage_value, PipelineStage *stage, std::string *error_message) {
+  const auto *stage_map = std::get_if<flutter::EncodableMap>(&stage_value);
+  if (!stage_map) {
+    *error_message = "Pipeline stages must be maps";
+    return false;
+  }
+  auto name_it = stage_map->find(flutter::EncodableValue("name"));
+  auto op_it = stage_map->find(flutter::EncodableValue("op"));
+  if (name_it == stage_map->end() || !std::holds_alternative<std::string>(name_it->second) ||
+      op_it == stage_map->end() || !std::holds_alternative<std::string>(op_it->second)) {
+    *error_message = "Pipeline stages need a name and an op";
+    return false;
+  }
+  stage->name = std::get<std::string>(name_it->second);
+  stage->op = std::get<std::string>(op_it->second);
+  if (stage->op == "session" && !LookupHandle(*stage_map, "sessionId", kSessionIdPrefix, &stage->session)) {
+    *error_message = "Session stage " + stage->name + " needs a session ID";
+    return false;
+  }
+
+  auto inputs_it = stage_map->find(flutter::EncodableValue("inputs"));
+  if (inputs_it != stage_map->end()) {
+    if (const auto *inputs = std::get_if<flutter::EncodableMap>(&inputs_it->second)) {
+      for (const auto &[key, value] : *inputs) {
+        if (std::holds_alternative<std::string>(key) && std::holds_alternative<std::string>(value)) {
+          stage->inputs[std::get<std::string>(key)] = std::get<std::string>(value);
+        }
+      }
+    }
+  }
+
+  auto params_it = stage_map->find(flutter::EncodableValue("params"));
+  return params_it == stage_map->end() || ParseStageParams(params_it->second, stage, error_message);
+}
+
+// Scheduling priority of a call from the priority entry of its runOptions map, normal if there is none
+JobPriority LookupRunPriority(const flutter::EncodableMap &args) {
+  auto run_options_it = args.find(flutter::EncodableValue("runOptions"));
+  if (run_options_it == args.end() || !std::holds_alternative<flutter::EncodableMap>(run_options_it->second)) {
+    return JobPriority::kNormal;
+  }
+  const auto &options_map = std::get<flutter::EncodableMap>(run_options_it->second);
+  auto priority_it = options_map.find(flutter::EncodableValue("priority"));
+  if (priority_it == options_map.end() || !std::holds_alternative<std::string>(priority_it->second)) {
+    return JobPriority::kNormal;
+  }
+  const std::string &priority = std::get<std::string>(priority_it->second);
+  if (priority == "high") {
+    return JobPriority::kHigh;
+  }
+  if (priority == "low") {
+    return JobPriority::kLow;
+  }
+  return JobPriority::kNormal;
+}
+
+// Track a call in the run registry if its runOptions map has a runTag to cancel it by or a timeoutMs, and return
+// the control to submit it with; nullptr if it has neither
+std::shared_ptr<RunControl> TrackRun(RunRegistry &registry, const flutter::EncodableMap &args) {
+  auto run_options_it = args.find(flutter::EncodableValue("runOptions"));
+  if (run_options_it == args.end() || !std::holds_alternative<flutter::EncodableMap>(run_options_it->second)) {
+    return nullptr;
+  }
+  const auto &options_map = std::get<flutter::EncodableMap>(run_options_it->second);
+  std::string tag;
+  auto tag_it = options_map.find(flutter::EncodableValue("runTag"));
+  if (tag_it != options_map.end() && std::holds_alternative<std::string>(tag_it->second)) {
+    tag = std::get<std::string>(tag_it->second);
+  }
+  int64_t timeout_ms = 0;
+  LookupInt(options_map, "timeoutMs", &timeout_ms);
+  uint64_t timeout_nanos = timeout_ms > 0 ? static_cast<uint64_t>(timeout_ms) * 1000000 : 0;
+  if (tag.empty() && timeout_nanos == 0) {
+    return nullptr;
+  }
+
+  auto run = std::make_shared<RunControl>();
+  registry.track(run, tag, timeout_nanos);
+  return run;
+}
+
+// Error code of a failed run, which tells Dart apart runs that were stopped before they finished
+const char *InferenceErrorCode() {
+  switch (RunScope::stopReason()) {
+  case RunStop::kPreempted:
+    return "RUN_PREEMPTED";
+  case RunStop::kCancelled:
+    return "RUN_CANCELLED";
+  case RunStop::kTimedOut:
+    return "RUN_TIMEOUT";
+  default:
+    return "INFERENCE_ERROR";
+  }
+}
+
+} // namespace
+
 // static
 void FlutterOnnxruntimePlugin::RegisterWithRegistrar(flutter::PluginRegistrarWindows *registrar) {
   auto channel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
       registrar->messenger(), "flutter_onnxruntime", &flutter::StandardMethodCodec::GetInstance());
 
-  auto plugin = std::make_unique<FlutterOnnxruntimePlugin>();
+  auto plugin = std::make_unique<FlutterOnnxruntimePlugin>(registrar);
 
   channel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
     plugin_pointer->HandleMethodCall(call, std::move(result));
@@ -55,7 +676,8 @@ void FlutterOnnxruntimePlugin::RegisterWithRegistrar(flutter::PluginRegistrarWin
   registrar->AddPlugin(std::move(plugin));
 }
 
-FlutterOnnxruntimePlugin::FlutterOnnxruntimePlugin() : impl_(std::make_unique<FlutterOnnxruntimePluginImpl>()) {}
+FlutterOnnxruntimePlugin::FlutterOnnxruntimePlugin(flutter::PluginRegistrarWindows *registrar)
+    : impl_(std::make_unique<FlutterOnnxruntimePluginImpl>(registrar)) {}
 
 FlutterOnnxruntimePlugin::~FlutterOnnxruntimePlugin() {}
 
@@ -81,19 +703,43 @@ void FlutterOnnxruntimePlugin::HandleMethodCall(
   if (method_name == "createOrtValue") {
     HandleCreateOrtValue(method_call, std::move(result));
     return;
+  } else if (method_name == "createImageTensor") {
+    HandleCreateImageTensor(method_call, std::move(result));
+    return;
   } else if (method_name == "convertOrtValue") {
     HandleConvertOrtValue(method_call, std::move(result));
     return;
+  } else if (method_name == "quantizeOrtValue") {
+    HandleQuantizeOrtValue(method_call, std::move(result));
+    return;
+  } else if (method_name == "dequantizeOrtValue") {
+    HandleDequantizeOrtValue(method_call, std::move(result));
+    return;
+  } else if (method_name == "reshapeOrtValue") {
+    HandleReshapeOrtValue(method_call, std::move(result));
+    return;
+  } else if (method_name == "sliceOrtValue") {
+    HandleSliceOrtValue(method_call, std::move(result));
+    return;
+  } else if (method_name == "transposeOrtValue") {
+    HandleTransposeOrtValue(method_call, std::move(result));
+    return;
+  } else if (method_name == "concatOrtValues") {
+    HandleConcatOrtValues(method_call, std::move(result));
+    return;
   } else if (method_name == "getOrtValueData") {
     HandleGetOrtValueData(method_call, std::move(result));
     return;
   } else if (method_name == "releaseOrtValue") {
     HandleReleaseOrtValue(method_call, std::move(result));
     return;
+  } else if (method_name == "releaseOrtValues") {
+    HandleReleaseOrtValues(method_call, std::move(result));
+    return;
   }
 
   // Session-related methods
-  if (method_name == "createSession") {
+  if (method_name == "createSession" || method_name == "createSessionFromBuffer") {
     HandleCreateSession(method_call, std::move(result));
     return;
   } else if (method_name == "getAvailableProviders") {
@@ -102,9 +748,110 @@ void FlutterOnnxruntimePlugin::HandleMethodCall(
   } else if (method_name == "runInference") {
     HandleRunInference(method_call, std::move(result));
     return;
+  } else if (method_name == "runBatch") {
+    HandleRunBatch(method_call, std::move(result));
+    return;
+  } else if (method_name == "bindOutputs") {
+    HandleBindOutputs(method_call, std::move(result));
+    return;
+  } else if (method_name == "runWithBinding") {
+    HandleRunWithBinding(method_call, std::move(result));
+    return;
+  } else if (method_name == "unbindOutputs") {
+    HandleUnbindOutputs(method_call, std::move(result));
+    return;
+  } else if (method_name == "enableSequenceState") {
+    RunOnWorker(*impl_->inferenceExecutor_, method_call, std::move(result),
+                &FlutterOnnxruntimePlugin::EnableSequenceState);
+    return;
+  } else if (method_name == "resetSequenceState") {
+    RunOnWorker(*impl_->inferenceExecutor_, method_call, std::move(result),
+                &FlutterOnnxruntimePlugin::ResetSequenceState);
+    return;
+  } else if (method_name == "disableSequenceState") {
+    RunOnWorker(*impl_->inferenceExecutor_, method_call, std::move(result),
+                &FlutterOnnxruntimePlugin::DisableSequenceState);
+    return;
+  } else if (method_name == "setInferenceThreads") {
+    HandleSetInferenceThreads(method_call, std::move(result));
+    return;
+  } else if (method_name == "getQueueStats") {
+    HandleGetQueueStats(method_call, std::move(result));
+    return;
+  } else if (method_name == "cancelLowPriorityRuns") {
+    HandleCancelLowPriorityRuns(method_call, std::move(result));
+    return;
+  } else if (method_name == "cancelRun") {
+    HandleCancelRun(method_call, std::move(result));
+    return;
+  } else if (method_name == "setIntegerHandles") {
+    HandleSetIntegerHandles(method_call, std::move(result));
+    return;
+  } else if (method_name == "configureSessionCache") {
+    HandleConfigureSessionCache(method_call, std::move(result));
+    return;
+  } else if (method_name == "configureThreadPools") {
+    HandleConfigureThreadPools(method_call, std::move(result));
+    return;
+  } else if (method_name == "configureSharedArena") {
+    HandleConfigureSharedArena(method_call, std::move(result));
+    return;
+  } else if (method_name == "configureBatching") {
+    HandleConfigureBatching(method_call, std::move(result));
+    return;
+  } else if (method_name == "getBatchingStats") {
+    HandleGetBatchingStats(method_call, std::move(result));
+    return;
+  } else if (method_name == "getSessionStats") {
+    HandleGetSessionStats(method_call, std::move(result));
+    return;
+  } else if (method_name == "getMemoryStats") {
+    HandleGetMemoryStats(method_call, std::move(result));
+    return;
+  } else if (method_name == "setMemoryLimit") {
+    HandleSetMemoryLimit(method_call, std::move(result));
+    return;
+  } else if (method_name == "endProfiling") {
+    HandleEndProfiling(method_call, std::move(result));
+    return;
+  } else if (method_name == "startTracing") {
+    HandleStartTracing(method_call, std::move(result));
+    return;
+  } else if (method_name == "stopTracing") {
+    HandleStopTracing(method_call, std::move(result));
+    return;
+  } else if (method_name == "getNativeContext") {
+    HandleGetNativeContext(method_call, std::move(result));
+    return;
   } else if (method_name == "closeSession") {
     HandleCloseSession(method_call, std::move(result));
     return;
+  } else if (method_name == "createPipeline") {
+    HandleCreatePipeline(method_call, std::move(result));
+    return;
+  } else if (method_name == "runPipeline") {
+    RunWithInputsOnWorker(method_call, std::move(result), &FlutterOnnxruntimePlugin::RunPipeline);
+    return;
+  } else if (method_name == "closePipeline") {
+    HandleClosePipeline(method_call, std::move(result));
+  } else if (method_name == "runTensorOp") {
+    RunWithInputsOnWorker(method_call, std::move(result), &FlutterOnnxruntimePlugin::RunTensorOp, true);
+    return;
+  } else if (method_name == "openStream") {
+    HandleOpenStream(method_call, std::move(result));
+    return;
+  } else if (method_name == "submitStreamFrame") {
+    HandleSubmitStreamFrame(method_call, std::move(result));
+    return;
+  } else if (method_name == "closeStream") {
+    HandleCloseStream(method_call, std::move(result));
+    return;
+  } else if (method_name == "generate") {
+    HandleGenerate(method_call, std::move(result));
+    return;
+  } else if (method_name == "cancelGeneration") {
+    HandleCancelGeneration(method_call, std::move(result));
+    return;
   } else if (method_name == "getMetadata") {
     HandleGetMetadata(method_call, std::move(result));
     return;
@@ -122,6 +869,7 @@ void FlutterOnnxruntimePlugin::HandleMethodCall(
 void FlutterOnnxruntimePlugin::HandleCreateOrtValue(
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  TraceScope trace("createOrtValue");
 
   // Extract parameters
   const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
@@ -139,6 +887,11 @@ void FlutterOnnxruntimePlugin::HandleCreateOrtValue(
       return;
     }
     std::string source_type = std::get<std::string>(source_type_it->second);
+    ONNXTensorElementDataType element_type;
+    if (!parseElementType(source_type, &element_type)) {
+      result->Error("UNSUPPORTED_TYPE", "Unsupported source data type: " + source_type, nullptr);
+      return;
+    }
 
     // Extract data
     auto data_it = args->find(flutter::EncodableValue("data"));
@@ -175,36 +928,13 @@ void FlutterOnnxruntimePlugin::HandleCreateOrtValue(
     // Note: Typed list in Dart is EncodableValue type
     // List<T> in Dart is EncodableList type
     // Dart always pass typed list except for bool
-    std::string tensor_id;
-    if (source_type == "float32") {
-      if (!std::holds_alternative<std::vector<float>>(data_value)) {
-        result->Error("INVALID_ARG", "Float32 data must be a list", nullptr);
-        return;
-      }
-      std::vector<float> float_data = std::get<std::vector<float>>(data_value);
-      tensor_id = impl_->tensorManager_->createFloat32Tensor(float_data, shape);
-    } else if (source_type == "int32") {
-      if (!std::holds_alternative<std::vector<int32_t>>(data_value)) {
-        result->Error("INVALID_ARG", "Int32 data must be a list", nullptr);
-        return;
-      }
-      std::vector<int32_t> int32_data = std::get<std::vector<int32_t>>(data_value);
-      tensor_id = impl_->tensorManager_->createInt32Tensor(int32_data, shape);
-    } else if (source_type == "int64") {
-      if (!std::holds_alternative<std::vector<int64_t>>(data_value)) {
-        result->Error("INVALID_ARG", "Int64 data must be a list", nullptr);
-        return;
-      }
-      std::vector<int64_t> int64_data = std::get<std::vector<int64_t>>(data_value);
-      tensor_id = impl_->tensorManager_->createInt64Tensor(int64_data, shape);
-    } else if (source_type == "uint8") {
-      if (!std::holds_alternative<std::vector<uint8_t>>(data_value)) {
-        result->Error("INVALID_ARG", "Uint8 data must be a list", nullptr);
-        return;
-      }
-      std::vector<uint8_t> uint8_data = std::get<std::vector<uint8_t>>(data_value);
-      tensor_id = impl_->tensorManager_->createUint8Tensor(uint8_data, shape);
-    } else if (source_type == "bool") {
+    TensorHandle tensor_id = kInvalidHandle;
+    const void *typed_data = nullptr;
+    size_t typed_data_size = 0;
+    if (GetTypedData(data_value, element_type, &typed_data, &typed_data_size)) {
+      // Typed data is copied once, straight into the tensor's pooled buffer
+      tensor_id = impl_->tensorManager_->createTensorFromBytes(element_type, typed_data, typed_data_size, shape);
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL) {
       // Note: for bool values, Dart always pass a List<bool>, not a typed list
       if (!std::holds_alternative<flutter::EncodableList>(data_value)) {
         result->Error("INVALID_ARG", "Bool data must be a list", nullptr);
@@ -221,8 +951,8 @@ void FlutterOnnxruntimePlugin::HandleCreateOrtValue(
           bool_data.push_back(std::get<int32_t>(item) != 0);
         }
       }
-      tensor_id = impl_->tensorManager_->createBoolTensor(bool_data, shape);
-    } else if (source_type == "string") {
+      tensor_id = impl_->tensorManager_->createTensor(bool_data, shape);
+    } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
       if (!std::holds_alternative<flutter::EncodableList>(data_value)) {
         result->Error("INVALID_ARG", "String data must be a list of strings", nullptr);
         return;
@@ -238,13 +968,13 @@ void FlutterOnnxruntimePlugin::HandleCreateOrtValue(
       }
       tensor_id = impl_->tensorManager_->createStringTensor(string_data, shape);
     } else {
-      result->Error("INVALID_ARG", "Unsupported data type: " + source_type, nullptr);
+      result->Error("INVALID_ARG", "Data for " + source_type + " must be a matching typed list or raw bytes", nullptr);
       return;
     }
 
     // Return success with the tensor ID
     flutter::EncodableMap response;
-    response[flutter::EncodableValue("valueId")] = flutter::EncodableValue(tensor_id);
+    response[flutter::EncodableValue("valueId")] = impl_->EncodeHandle(kTensorIdPrefix, tensor_id);
     response[flutter::EncodableValue("dataType")] = flutter::EncodableValue(source_type);
 
     // Convert shape to Flutter list
@@ -264,7 +994,7 @@ void FlutterOnnxruntimePlugin::HandleCreateOrtValue(
   }
 }
 
-void FlutterOnnxruntimePlugin::HandleConvertOrtValue(
+void FlutterOnnxruntimePlugin::HandleCreateImageTensor(
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
 
@@ -277,44 +1007,75 @@ void FlutterOnnxruntimePlugin::HandleConvertOrtValue(
   }
 
   try {
-    // Extract value ID
-    auto value_id_it = args->find(flutter::EncodableValue("valueId"));
-    if (value_id_it == args->end() || !std::holds_alternative<std::string>(value_id_it->second)) {
-      result->Error("INVALID_ARG", "Value ID must be a non-null string", nullptr);
+    auto data_it = args->find(flutter::EncodableValue("data"));
+    auto format_it = args->find(flutter::EncodableValue("format"));
+    auto layout_it = args->find(flutter::EncodableValue("layout"));
+    auto data_type_it = args->find(flutter::EncodableValue("dataType"));
+    int64_t width = 0;
+    int64_t height = 0;
+    if (data_it == args->end() || !std::holds_alternative<std::vector<uint8_t>>(data_it->second) ||
+        format_it == args->end() || !std::holds_alternative<std::string>(format_it->second) ||
+        layout_it == args->end() || !std::holds_alternative<std::string>(layout_it->second) ||
+        data_type_it == args->end() || !std::holds_alternative<std::string>(data_type_it->second) ||
+        !LookupInt(*args, "width", &width) || !LookupInt(*args, "height", &height)) {
+      result->Error("INVALID_ARG", "Missing required arguments", nullptr);
       return;
     }
-    std::string value_id = std::get<std::string>(value_id_it->second);
 
-    // Extract target type
-    auto target_type_it = args->find(flutter::EncodableValue("targetType"));
-    if (target_type_it == args->end() || !std::holds_alternative<std::string>(target_type_it->second)) {
-      result->Error("INVALID_ARG", "Target type must be a non-null string", nullptr);
+    ImageTensorOptions options;
+    options.width = static_cast<int>(width);
+    options.height = static_cast<int>(height);
+    int64_t target_width = 0;
+    int64_t target_height = 0;
+    if (LookupInt(*args, "targetWidth", &target_width)) {
+      options.target_width = static_cast<int>(target_width);
+    }
+    if (LookupInt(*args, "targetHeight", &target_height)) {
+      options.target_height = static_cast<int>(target_height);
+    }
+    if (!LookupChannelValues(*args, "mean", options.mean) || !LookupChannelValues(*args, "std", options.std)) {
+      result->Error("INVALID_ARG", "Mean and std must be lists of three numbers", nullptr);
       return;
     }
-    std::string target_type = std::get<std::string>(target_type_it->second);
 
-    std::string new_tensor_id;
+    const std::string &format = std::get<std::string>(format_it->second);
+    const std::string &layout = std::get<std::string>(layout_it->second);
+    const std::string &data_type = std::get<std::string>(data_type_it->second);
+    if (!parseImageFormat(format, &options.format)) {
+      result->Error("UNSUPPORTED_TYPE", "Unsupported image format: " + format, nullptr);
+      return;
+    }
+    if (layout != "nchw" && layout != "nhwc") {
+      result->Error("INVALID_ARG", "Unsupported tensor layout: " + layout, nullptr);
+      return;
+    }
+    ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+    parseElementType(data_type, &element_type);
+    if (element_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT && element_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+      result->Error("UNSUPPORTED_TYPE", "Image tensors must be float32 or float16, got " + data_type, nullptr);
+      return;
+    }
+    options.channels_first = layout == "nchw";
+    options.half_precision = element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+
+    const auto &data = std::get<std::vector<uint8_t>>(data_it->second);
+    TensorHandle tensor_id = kInvalidHandle;
     try {
-      // Convert the tensor
-      new_tensor_id = impl_->tensorManager_->convertTensor(value_id, target_type);
+      tensor_id = impl_->tensorManager_->createImageTensor(options, data.data(), data.size());
     } catch (const std::exception &e) {
-      result->Error("CONVERSION_ERROR", e.what(), nullptr);
+      result->Error("TENSOR_CREATION_ERROR", e.what(), nullptr);
       return;
     }
 
-    // Get the tensor shape
-    std::vector<int64_t> shape = impl_->tensorManager_->getTensorShape(new_tensor_id);
-
     // Convert shape to Flutter list
     flutter::EncodableList shape_list;
-    for (const auto &dim : shape) {
+    for (const auto &dim : impl_->tensorManager_->getTensorShape(tensor_id)) {
       shape_list.push_back(static_cast<int64_t>(dim));
     }
 
-    // Return success with the new tensor ID
     flutter::EncodableMap response;
-    response[flutter::EncodableValue("valueId")] = flutter::EncodableValue(new_tensor_id);
-    response[flutter::EncodableValue("dataType")] = flutter::EncodableValue(target_type);
+    response[flutter::EncodableValue("valueId")] = impl_->EncodeHandle(kTensorIdPrefix, tensor_id);
+    response[flutter::EncodableValue("dataType")] = flutter::EncodableValue(data_type);
     response[flutter::EncodableValue("shape")] = flutter::EncodableValue(shape_list);
 
     result->Success(flutter::EncodableValue(response));
@@ -327,7 +1088,7 @@ void FlutterOnnxruntimePlugin::HandleConvertOrtValue(
   }
 }
 
-void FlutterOnnxruntimePlugin::HandleGetOrtValueData(
+void FlutterOnnxruntimePlugin::HandleConvertOrtValue(
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
 
@@ -341,25 +1102,50 @@ void FlutterOnnxruntimePlugin::HandleGetOrtValueData(
 
   try {
     // Extract value ID
-    auto value_id_it = args->find(flutter::EncodableValue("valueId"));
-    if (value_id_it == args->end() || !std::holds_alternative<std::string>(value_id_it->second)) {
+    TensorHandle value_id = kInvalidHandle;
+    if (!LookupHandle(*args, "valueId", kTensorIdPrefix, &value_id)) {
       result->Error("INVALID_ARG", "Value ID must be a non-null string", nullptr);
       return;
     }
-    std::string value_id = std::get<std::string>(value_id_it->second);
 
-    // check if the tensor exists
-    Ort::Value *tensor = impl_->tensorManager_->getTensor(value_id);
-    if (!tensor) {
-      result->Error("INVALID_VALUE", "Tensor not found or already being disposed", nullptr);
+    // Extract target type
+    auto target_type_it = args->find(flutter::EncodableValue("targetType"));
+    if (target_type_it == args->end() || !std::holds_alternative<std::string>(target_type_it->second)) {
+      result->Error("INVALID_ARG", "Target type must be a non-null string", nullptr);
+      return;
+    }
+    std::string target_type = std::get<std::string>(target_type_it->second);
+    ONNXTensorElementDataType target_element_type;
+    if (!parseElementType(target_type, &target_element_type)) {
+      result->Error("CONVERSION_ERROR", "Unsupported type: " + target_type, nullptr);
       return;
     }
 
-    // Get the tensor data
-    flutter::EncodableValue tensor_data = impl_->tensorManager_->getTensorData(value_id);
+    TensorHandle new_tensor_id = kInvalidHandle;
+    try {
+      // Convert the tensor
+      new_tensor_id = impl_->tensorManager_->convertTensor(value_id, target_element_type);
+    } catch (const std::exception &e) {
+      result->Error("CONVERSION_ERROR", e.what(), nullptr);
+      return;
+    }
 
-    // Return success with the tensor data
-    result->Success(tensor_data);
+    // Get the tensor shape
+    std::vector<int64_t> shape = impl_->tensorManager_->getTensorShape(new_tensor_id);
+
+    // Convert shape to Flutter list
+    flutter::EncodableList shape_list;
+    for (const auto &dim : shape) {
+      shape_list.push_back(static_cast<int64_t>(dim));
+    }
+
+    // Return success with the new tensor ID
+    flutter::EncodableMap response;
+    response[flutter::EncodableValue("valueId")] = impl_->EncodeHandle(kTensorIdPrefix, new_tensor_id);
+    response[flutter::EncodableValue("dataType")] = flutter::EncodableValue(target_type);
+    response[flutter::EncodableValue("shape")] = flutter::EncodableValue(shape_list);
+
+    result->Success(flutter::EncodableValue(response));
   } catch (const Ort::Exception &e) {
     result->Error("ORT_ERROR", e.what(), nullptr);
   } catch (const std::exception &e) {
@@ -369,10 +1155,307 @@ void FlutterOnnxruntimePlugin::HandleGetOrtValueData(
   }
 }
 
-void FlutterOnnxruntimePlugin::HandleReleaseOrtValue(
+void FlutterOnnxruntimePlugin::HandleQuantizeOrtValue(
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  try {
+    TensorHandle value_id = kInvalidHandle;
+    QuantizationParams params;
+    auto data_type_it = args->find(flutter::EncodableValue("dataType"));
+    if (!LookupHandle(*args, "valueId", kTensorIdPrefix, &value_id) || !ReadQuantizationParams(*args, &params) ||
+        data_type_it == args->end() || !std::holds_alternative<std::string>(data_type_it->second)) {
+      result->Error("INVALID_ARG", "Missing required arguments", nullptr);
+      return;
+    }
+    std::string data_type = std::get<std::string>(data_type_it->second);
+    if (!parseElementType(data_type, &params.element_type)) {
+      result->Error("CONVERSION_ERROR", "Unsupported type: " + data_type, nullptr);
+      return;
+    }
+
+    TensorHandle new_tensor_id = kInvalidHandle;
+    try {
+      new_tensor_id = impl_->tensorManager_->quantizeTensor(value_id, params);
+    } catch (const std::exception &e) {
+      result->Error("CONVERSION_ERROR", e.what(), nullptr);
+      return;
+    }
+
+    flutter::EncodableList shape_list;
+    for (const auto &dim : impl_->tensorManager_->getTensorShape(new_tensor_id)) {
+      shape_list.push_back(static_cast<int64_t>(dim));
+    }
+    flutter::EncodableMap response;
+    response[flutter::EncodableValue("valueId")] = impl_->EncodeHandle(kTensorIdPrefix, new_tensor_id);
+    response[flutter::EncodableValue("dataType")] = flutter::EncodableValue(data_type);
+    response[flutter::EncodableValue("shape")] = flutter::EncodableValue(shape_list);
+    result->Success(flutter::EncodableValue(response));
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleDequantizeOrtValue(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  try {
+    TensorHandle value_id = kInvalidHandle;
+    QuantizationParams params;
+    if (!LookupHandle(*args, "valueId", kTensorIdPrefix, &value_id) || !ReadQuantizationParams(*args, &params)) {
+      result->Error("INVALID_ARG", "Missing required arguments", nullptr);
+      return;
+    }
+
+    TensorHandle new_tensor_id = kInvalidHandle;
+    try {
+      new_tensor_id = impl_->tensorManager_->dequantizeTensor(value_id, params);
+    } catch (const std::exception &e) {
+      result->Error("CONVERSION_ERROR", e.what(), nullptr);
+      return;
+    }
+
+    flutter::EncodableList shape_list;
+    for (const auto &dim : impl_->tensorManager_->getTensorShape(new_tensor_id)) {
+      shape_list.push_back(static_cast<int64_t>(dim));
+    }
+    flutter::EncodableMap response;
+    response[flutter::EncodableValue("valueId")] = impl_->EncodeHandle(kTensorIdPrefix, new_tensor_id);
+    response[flutter::EncodableValue("dataType")] = flutter::EncodableValue("float32");
+    response[flutter::EncodableValue("shape")] = flutter::EncodableValue(shape_list);
+    result->Success(flutter::EncodableValue(response));
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleReshapeOrtValue(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  try {
+    TensorHandle value_id = kInvalidHandle;
+    std::vector<int64_t> shape;
+    auto shape_it = args->find(flutter::EncodableValue("shape"));
+    if (!LookupHandle(*args, "valueId", kTensorIdPrefix, &value_id) || shape_it == args->end() ||
+        !ReadTokens(shape_it->second, &shape)) {
+      result->Error("INVALID_ARG", "Missing required arguments", nullptr);
+      return;
+    }
+
+    TensorHandle new_tensor_id = kInvalidHandle;
+    try {
+      new_tensor_id = impl_->tensorManager_->reshapeTensor(value_id, shape);
+    } catch (const std::exception &e) {
+      result->Error("INVALID_ARG", e.what(), nullptr);
+      return;
+    }
+    result->Success(NewOrtValueToEncodable(*impl_, new_tensor_id));
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleSliceOrtValue(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  try {
+    TensorHandle value_id = kInvalidHandle;
+    int64_t axis = 0;
+    int64_t start = 0;
+    int64_t end = 0;
+    if (!LookupHandle(*args, "valueId", kTensorIdPrefix, &value_id) || !LookupInt(*args, "axis", &axis) ||
+        !LookupInt(*args, "start", &start)) {
+      result->Error("INVALID_ARG", "Missing required arguments", nullptr);
+      return;
+    }
+    // Without an end, take the single index start and drop the axis
+    auto end_it = args->find(flutter::EncodableValue("end"));
+    bool take_index = end_it == args->end() || std::holds_alternative<std::monostate>(end_it->second);
+    if (!take_index && !LookupInt(*args, "end", &end)) {
+      result->Error("INVALID_ARG", "End must be an integer", nullptr);
+      return;
+    }
+
+    TensorHandle new_tensor_id = kInvalidHandle;
+    try {
+      new_tensor_id = take_index ? impl_->tensorManager_->selectTensor(value_id, axis, start)
+                                 : impl_->tensorManager_->sliceTensor(value_id, axis, start, end);
+    } catch (const std::exception &e) {
+      result->Error("INVALID_ARG", e.what(), nullptr);
+      return;
+    }
+    result->Success(NewOrtValueToEncodable(*impl_, new_tensor_id));
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleTransposeOrtValue(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  try {
+    TensorHandle value_id = kInvalidHandle;
+    std::vector<int64_t> perm;
+    auto perm_it = args->find(flutter::EncodableValue("perm"));
+    if (!LookupHandle(*args, "valueId", kTensorIdPrefix, &value_id) ||
+        (perm_it != args->end() && !std::holds_alternative<std::monostate>(perm_it->second) &&
+         !ReadTokens(perm_it->second, &perm))) {
+      result->Error("INVALID_ARG", "Missing required arguments", nullptr);
+      return;
+    }
+
+    TensorHandle new_tensor_id = kInvalidHandle;
+    try {
+      new_tensor_id = impl_->tensorManager_->transposeTensor(value_id, perm);
+    } catch (const std::exception &e) {
+      result->Error("INVALID_ARG", e.what(), nullptr);
+      return;
+    }
+    result->Success(NewOrtValueToEncodable(*impl_, new_tensor_id));
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleConcatOrtValues(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  try {
+    auto value_ids_it = args->find(flutter::EncodableValue("valueIds"));
+    int64_t axis = 0;
+    if (value_ids_it == args->end() || !std::holds_alternative<flutter::EncodableList>(value_ids_it->second) ||
+        !LookupInt(*args, "axis", &axis)) {
+      result->Error("INVALID_ARG", "Missing required arguments", nullptr);
+      return;
+    }
+    std::vector<TensorHandle> value_ids;
+    for (const auto &value_id_value : std::get<flutter::EncodableList>(value_ids_it->second)) {
+      TensorHandle value_id = kInvalidHandle;
+      if (!ToHandle(value_id_value, kTensorIdPrefix, &value_id)) {
+        result->Error("INVALID_ARG", "Value IDs must be non-null strings", nullptr);
+        return;
+      }
+      value_ids.push_back(value_id);
+    }
+
+    TensorHandle new_tensor_id = kInvalidHandle;
+    try {
+      new_tensor_id = impl_->tensorManager_->concatTensors(value_ids, axis);
+    } catch (const std::exception &e) {
+      result->Error("INVALID_ARG", e.what(), nullptr);
+      return;
+    }
+    result->Success(NewOrtValueToEncodable(*impl_, new_tensor_id));
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleGetOrtValueData(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  TraceScope trace("getOrtValueData");
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  try {
+    // Extract value ID
+    TensorHandle value_id = kInvalidHandle;
+    if (!LookupHandle(*args, "valueId", kTensorIdPrefix, &value_id)) {
+      result->Error("INVALID_ARG", "Value ID must be a non-null string", nullptr);
+      return;
+    }
+
+    // check if the tensor exists
+    Ort::Value *tensor = impl_->tensorManager_->getTensor(value_id);
+    if (!tensor) {
+      result->Error("INVALID_VALUE", "Tensor not found or already being disposed", nullptr);
+      return;
+    }
+
+    // Get the tensor data
+    flutter::EncodableValue tensor_data = impl_->tensorManager_->getTensorData<EncodableValueCodec>(value_id);
+
+    // Return success with the tensor data
+    result->Success(tensor_data);
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleReleaseOrtValue(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
   // Extract parameters
   const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
 
@@ -383,12 +1466,11 @@ void FlutterOnnxruntimePlugin::HandleReleaseOrtValue(
 
   try {
     // Extract value ID
-    auto value_id_it = args->find(flutter::EncodableValue("valueId"));
-    if (value_id_it == args->end() || !std::holds_alternative<std::string>(value_id_it->second)) {
+    TensorHandle value_id = kInvalidHandle;
+    if (!LookupHandle(*args, "valueId", kTensorIdPrefix, &value_id)) {
       result->Error("INVALID_ARG", "Value ID must be a non-null string", nullptr);
       return;
     }
-    std::string value_id = std::get<std::string>(value_id_it->second);
 
     // Release the tensor
     bool success = impl_->tensorManager_->releaseTensor(value_id);
@@ -408,29 +1490,96 @@ void FlutterOnnxruntimePlugin::HandleReleaseOrtValue(
   }
 }
 
-void FlutterOnnxruntimePlugin::HandleCreateSession(
+void FlutterOnnxruntimePlugin::HandleReleaseOrtValues(
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-
-  // Extract parameters
   const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
-
   if (!args) {
     result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
     return;
   }
 
-  try {
-    // Extract model path
-    auto model_path_it = args->find(flutter::EncodableValue("modelPath"));
-    if (model_path_it == args->end() || !std::holds_alternative<std::string>(model_path_it->second)) {
-      result->Error("INVALID_ARG", "Model path must be a non-null string", nullptr);
+  auto value_ids_it = args->find(flutter::EncodableValue("valueIds"));
+  if (value_ids_it == args->end() || !std::holds_alternative<flutter::EncodableList>(value_ids_it->second)) {
+    result->Error("INVALID_ARG", "Value IDs must be a list", nullptr);
+    return;
+  }
+
+  std::vector<TensorHandle> value_ids;
+  for (const auto &value_id_value : std::get<flutter::EncodableList>(value_ids_it->second)) {
+    TensorHandle value_id = kInvalidHandle;
+    if (!ToHandle(value_id_value, kTensorIdPrefix, &value_id)) {
+      result->Error("INVALID_ARG", "Value IDs must be non-null strings", nullptr);
       return;
     }
-    std::string model_path = std::get<std::string>(model_path_it->second);
+    value_ids.push_back(value_id);
+  }
+
+  try {
+    // One lock for the whole list; unlike releaseOrtValue, tensors already released are skipped, since a scope
+    // may hold values that were also disposed on their own
+    impl_->tensorManager_->releaseTensors(value_ids);
+    result->Success(nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleCreateSession(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  // Loading and optimizing a model can take seconds, so it never runs on the platform thread
+  WorkerHandler handler = method_call.method_name() == "createSessionFromBuffer"
+                              ? &FlutterOnnxruntimePlugin::CreateSessionFromBuffer
+                              : &FlutterOnnxruntimePlugin::CreateSession;
+  RunOnWorker(*impl_->sessionLoader_, method_call, std::move(result), handler);
+}
+
+void FlutterOnnxruntimePlugin::CreateSession(const flutter::EncodableMap &arguments,
+                                             std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  CreateSessionFrom(arguments, false, std::move(result));
+}
+
+void FlutterOnnxruntimePlugin::CreateSessionFromBuffer(
+    const flutter::EncodableMap &arguments, std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  CreateSessionFrom(arguments, true, std::move(result));
+}
+
+void FlutterOnnxruntimePlugin::CreateSessionFrom(
+    const flutter::EncodableMap &arguments, bool from_buffer,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = &arguments;
+
+  try {
+    // createSessionFromBuffer passes the bytes of the model instead of its path
+    const std::vector<uint8_t> *model_data = nullptr;
+    std::string model_path;
+    if (from_buffer) {
+      auto model_data_it = args->find(flutter::EncodableValue("modelData"));
+      if (model_data_it == args->end() || !std::holds_alternative<std::vector<uint8_t>>(model_data_it->second) ||
+          std::get<std::vector<uint8_t>>(model_data_it->second).empty()) {
+        result->Error("INVALID_ARG", "Model data must be a non-empty Uint8List", nullptr);
+        return;
+      }
+      model_data = &std::get<std::vector<uint8_t>>(model_data_it->second);
+    } else {
+      // Extract model path
+      auto model_path_it = args->find(flutter::EncodableValue("modelPath"));
+      if (model_path_it == args->end() || !std::holds_alternative<std::string>(model_path_it->second)) {
+        result->Error("INVALID_ARG", "Model path must be a non-null string", nullptr);
+        return;
+      }
+      model_path = std::get<std::string>(model_path_it->second);
+    }
 
     // Create session options
     Ort::SessionOptions session_options;
+    std::string optimized_model_dir;
+    bool profiling = false;
+
+    // Dummy runs before the session is reported ready, with sizes of dynamic dimensions by symbolic name
+    int64_t warmup_runs = 0;
+    std::map<std::string, int64_t> warmup_dims;
 
     // Configure session options if provided
     auto session_options_it = args->find(flutter::EncodableValue("sessionOptions"));
@@ -450,11 +1599,92 @@ void FlutterOnnxruntimePlugin::HandleCreateSession(
         session_options.SetInterOpNumThreads(std::get<int32_t>(inter_threads_it->second));
       }
 
-      // Get the device ID, if not provided, set to 0
-      int device_id = 0;
-      auto device_id_it = options_map.find(flutter::EncodableValue("deviceId"));
-      if (device_id_it != options_map.end() && std::holds_alternative<int32_t>(device_id_it->second)) {
-        device_id = std::get<int32_t>(device_id_it->second);
+      auto level_it = options_map.find(flutter::EncodableValue("graphOptimizationLevel"));
+      if (level_it != options_map.end() && std::holds_alternative<std::string>(level_it->second)) {
+        GraphOptimizationLevel level;
+        if (!parseGraphOptimizationLevel(std::get<std::string>(level_it->second), &level)) {
+          std::string error_message = "Unknown graph optimization level: " + std::get<std::string>(level_it->second);
+          result->Error("INVALID_ARG", error_message.c_str(), nullptr);
+          return;
+        }
+        session_options.SetGraphOptimizationLevel(level);
+      }
+
+      // Memory arena and allocation planning; both default to on in ONNX Runtime
+      auto arena_it = options_map.find(flutter::EncodableValue("useArena"));
+      if (arena_it != options_map.end() && std::holds_alternative<bool>(arena_it->second)) {
+        if (std::get<bool>(arena_it->second)) {
+          session_options.EnableCpuMemArena();
+        } else {
+          session_options.DisableCpuMemArena();
+        }
+      }
+
+      auto mem_pattern_it = options_map.find(flutter::EncodableValue("enableMemPattern"));
+      if (mem_pattern_it != options_map.end() && std::holds_alternative<bool>(mem_pattern_it->second)) {
+        if (std::get<bool>(mem_pattern_it->second)) {
+          session_options.EnableMemPattern();
+        } else {
+          session_options.DisableMemPattern();
+        }
+      }
+
+      auto initializers_it = options_map.find(flutter::EncodableValue("useDeviceAllocatorForInitializers"));
+      if (initializers_it != options_map.end() && std::holds_alternative<bool>(initializers_it->second) &&
+          std::get<bool>(initializers_it->second)) {
+        session_options.AddConfigEntry("session.use_device_allocator_for_initializers", "1");
+      }
+
+      // Save the optimized graph in the app temp directory and load it from there next time
+      auto cache_it = options_map.find(flutter::EncodableValue("cacheOptimizedModel"));
+      if (cache_it != options_map.end() && std::holds_alternative<bool>(cache_it->second) &&
+          std::get<bool>(cache_it->second)) {
+        optimized_model_dir = WindowsUtils::getAppTempDirectory() + "optimized_models";
+      }
+
+      // Write a trace of every run to profilingDirectory, or to the app temp directory, until endProfiling
+      auto profiling_it = options_map.find(flutter::EncodableValue("enableProfiling"));
+      if (profiling_it != options_map.end() && std::holds_alternative<bool>(profiling_it->second) &&
+          std::get<bool>(profiling_it->second)) {
+        std::string profiling_dir = WindowsUtils::getAppTempDirectory() + "profiles";
+        auto profiling_dir_it = options_map.find(flutter::EncodableValue("profilingDirectory"));
+        if (profiling_dir_it != options_map.end() && std::holds_alternative<std::string>(profiling_dir_it->second)) {
+          profiling_dir = std::get<std::string>(profiling_dir_it->second);
+        }
+        std::error_code error;
+        std::filesystem::path profiling_path = std::filesystem::u8path(profiling_dir);
+        if (!std::filesystem::create_directories(profiling_path, error) && error) {
+          std::string error_message = "Failed to create profiling directory: " + profiling_dir;
+          result->Error("INVALID_ARG", error_message.c_str(), nullptr);
+          return;
+        }
+        // ONNX Runtime appends the start time and ".json" to this prefix
+        session_options.EnableProfiling((profiling_path / L"onnxruntime_profile").c_str());
+        profiling = true;
+      }
+
+      LookupInt(options_map, "warmupRuns", &warmup_runs);
+      auto warmup_dims_it = options_map.find(flutter::EncodableValue("warmupDimensions"));
+      const auto *dims_map = warmup_dims_it != options_map.end()
+                                 ? std::get_if<flutter::EncodableMap>(&warmup_dims_it->second)
+                                 : nullptr;
+      if (dims_map) {
+        for (const auto &dim : *dims_map) {
+          const auto *name = std::get_if<std::string>(&dim.first);
+          int64_t size;
+          if (!name || !LookupInt(*dims_map, name->c_str(), &size) || size < 0) {
+            result->Error("INVALID_ARG", "Warmup dimensions must map names to non-negative integers", nullptr);
+            return;
+          }
+          warmup_dims[*name] = size;
+        }
+      }
+
+      // Get the device ID, if not provided, set to 0
+      int device_id = 0;
+      auto device_id_it = options_map.find(flutter::EncodableValue("deviceId"));
+      if (device_id_it != options_map.end() && std::holds_alternative<int32_t>(device_id_it->second)) {
+        device_id = std::get<int32_t>(device_id_it->second);
       }
 
       // Convert device_id to string for use with provider options
@@ -506,8 +1736,17 @@ void FlutterOnnxruntimePlugin::HandleCreateSession(
             std::unique_ptr<OrtCUDAProviderOptionsV2, CudaOptionsDeleter> cuda_options_ptr(cuda_options);
 
             // Set CUDA options
-            std::vector<const char *> keys{"device_id"};
-            std::vector<const char *> values{device_id_str.c_str()};
+            std::map<std::string, std::string> provider_options;
+            if (!CollectProviderOptions(options_map, provider, device_id_str, &provider_options)) {
+              result->Error("INVALID_ARG", "Options of provider CUDA must map names to strings", nullptr);
+              return;
+            }
+            std::vector<const char *> keys;
+            std::vector<const char *> values;
+            for (const auto &option : provider_options) {
+              keys.push_back(option.first.c_str());
+              values.push_back(option.second.c_str());
+            }
             status = Ort::GetApi().UpdateCUDAProviderOptions(cuda_options_ptr.get(), keys.data(), values.data(),
                                                              keys.size());
 
@@ -521,11 +1760,56 @@ void FlutterOnnxruntimePlugin::HandleCreateSession(
 
             // Append CUDA execution provider to session options
             session_options.AppendExecutionProvider_CUDA_V2(*cuda_options_ptr);
-          } else if (provider == "TENSOR_RT") {
-            // Use TensorRT if available
-            // This is just a placeholder - actual implementation would depend on TensorRT availability
-            result->Error("PROVIDER_ERROR", "TensorRT provider not implemented yet", nullptr);
+          } else if (provider == "DIRECT_ML") {
+#ifdef FLUTTER_ONNXRUNTIME_DIRECTML
+            // DirectML supports neither memory patterns nor running nodes in parallel
+            session_options.DisableMemPattern();
+            session_options.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
+            Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_DML(session_options, device_id));
+#else
+            result->Error("PROVIDER_ERROR",
+                          "DirectML is not available in this ONNX Runtime build, set ONNXRUNTIME_USE_DIRECTML",
+                          nullptr);
             return;
+#endif
+          } else if (provider == "TENSOR_RT") {
+            OrtTensorRTProviderOptionsV2 *tensorrt_options = nullptr;
+            OrtStatus *status = Ort::GetApi().CreateTensorRTProviderOptions(&tensorrt_options);
+            if (status != nullptr) {
+              std::string error_message = "Failed to create TensorRT provider options: ";
+              error_message += Ort::GetApi().GetErrorMessage(status);
+              Ort::GetApi().ReleaseStatus(status);
+              result->Error("PROVIDER_ERROR", error_message.c_str(), nullptr);
+              return;
+            }
+            struct TensorRTOptionsDeleter {
+              void operator()(OrtTensorRTProviderOptionsV2 *p) { Ort::GetApi().ReleaseTensorRTProviderOptions(p); }
+            };
+            std::unique_ptr<OrtTensorRTProviderOptionsV2, TensorRTOptionsDeleter> tensorrt_options_ptr(
+                tensorrt_options);
+
+            std::map<std::string, std::string> provider_options;
+            if (!CollectProviderOptions(options_map, provider, device_id_str, &provider_options)) {
+              result->Error("INVALID_ARG", "Options of provider TENSOR_RT must map names to strings", nullptr);
+              return;
+            }
+            std::vector<const char *> keys;
+            std::vector<const char *> values;
+            for (const auto &option : provider_options) {
+              keys.push_back(option.first.c_str());
+              values.push_back(option.second.c_str());
+            }
+            status = Ort::GetApi().UpdateTensorRTProviderOptions(tensorrt_options_ptr.get(), keys.data(),
+                                                                 values.data(), keys.size());
+            if (status != nullptr) {
+              std::string error_message = "Failed to update TensorRT provider options: ";
+              error_message += Ort::GetApi().GetErrorMessage(status);
+              Ort::GetApi().ReleaseStatus(status);
+              result->Error("PROVIDER_ERROR", error_message.c_str(), nullptr);
+              return;
+            }
+
+            session_options.AppendExecutionProvider_TensorRT_V2(*tensorrt_options_ptr);
           } else {
             std::string error_message = "Provider is not supported: " + provider;
             result->Error("INVALID_PROVIDER", error_message.c_str(), nullptr);
@@ -539,20 +1823,50 @@ void FlutterOnnxruntimePlugin::HandleCreateSession(
     }
 
     // Create the session
-    std::string session_id = impl_->sessionManager_->createSession(model_path.c_str(), session_options);
+    SessionHandle session_id;
+    if (model_data != nullptr) {
+      // Models in memory have no file to cache an optimized graph for
+      session_id =
+          impl_->sessionManager_->createSessionFromBuffer(model_data->data(), model_data->size(), session_options);
+    } else {
+      // Sessions opened with equal options share a cached model when the session cache is enabled
+      std::string options_key = session_options_it != args->end()
+                                    ? ValueConversion::canonicalString(session_options_it->second)
+                                    : std::string("null");
+
+      // Parse the model from a memory mapping of the file instead of reading it
+      auto map_model_it = args->find(flutter::EncodableValue("mapModel"));
+      bool map_model = map_model_it != args->end() && std::holds_alternative<bool>(map_model_it->second) &&
+                       std::get<bool>(map_model_it->second);
+
+      session_id = impl_->sessionManager_->createSession(model_path.c_str(), session_options, options_key,
+                                                         optimized_model_dir, map_model, profiling);
+    }
 
-    if (session_id.empty()) {
+    if (session_id == kInvalidHandle) {
       result->Error("SESSION_CREATION_ERROR", "Failed to create ONNX Runtime session", nullptr);
       return;
     }
 
+    // A session that fails to warm up is closed again, as Dart never learns its ID
+    if (warmup_runs > 0) {
+      try {
+        impl_->sessionManager_->warmupSession(session_id, static_cast<int>(warmup_runs), warmup_dims);
+      } catch (const Ort::Exception &e) {
+        impl_->sessionManager_->closeSession(session_id);
+        std::string error_message = std::string("Session warmup failed: ") + e.what();
+        result->Error("ORT_ERROR", error_message.c_str(), nullptr);
+        return;
+      }
+    }
+
     // Get input and output names
     std::vector<std::string> input_names = impl_->sessionManager_->getInputNames(session_id);
     std::vector<std::string> output_names = impl_->sessionManager_->getOutputNames(session_id);
 
     // Prepare response
     flutter::EncodableMap response;
-    response[flutter::EncodableValue("sessionId")] = flutter::EncodableValue(session_id);
+    response[flutter::EncodableValue("sessionId")] = impl_->EncodeHandle(kSessionIdPrefix, session_id);
 
     // Convert input names to Flutter list
     flutter::EncodableList input_names_list;
@@ -568,59 +1882,1402 @@ void FlutterOnnxruntimePlugin::HandleCreateSession(
     }
     response[flutter::EncodableValue("outputNames")] = flutter::EncodableValue(output_names_list);
 
-    // Add status for compatibility
-    response[flutter::EncodableValue("status")] = flutter::EncodableValue("success");
+    // Add status for compatibility
+    response[flutter::EncodableValue("status")] = flutter::EncodableValue("success");
+
+    result->Success(flutter::EncodableValue(response));
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleGetAvailableProviders(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  try {
+    // Get available providers from ONNX Runtime
+    std::vector<std::string> providers = Ort::GetAvailableProviders();
+
+    // Map provider names to standardized enum names
+    flutter::EncodableList providers_list;
+    for (const auto &provider : providers) {
+      std::string mapped_name = provider;
+
+      // Map C++ API provider names to enum names
+      static const std::unordered_map<std::string, std::string> provider_map = {
+          {"CPUExecutionProvider", "CPU"},
+          {"CUDAExecutionProvider", "CUDA"},
+          {"TensorrtExecutionProvider", "TENSOR_RT"},
+          {"AzureExecutionProvider", "AZURE"},
+          {"MIGraphXExecutionProvider", "MIGRAPHX"},
+          {"ROCMExecutionProvider", "ROCM"},
+          {"CoreMLExecutionProvider", "CORE_ML"},
+          {"DnnlExecutionProvider", "DNNL"},
+          {"OpenVINOExecutionProvider", "OPEN_VINO"},
+          {"NnapiExecutionProvider", "NNAPI"},
+          {"QnnExecutionProvider", "QNN"},
+          {"DmlExecutionProvider", "DIRECT_ML"},
+          {"ACLExecutionProvider", "ACL"},
+          {"ArmNNExecutionProvider", "ARM_NN"},
+          {"XnnpackExecutionProvider", "XNNPACK"}};
+
+      auto it = provider_map.find(provider);
+      if (it != provider_map.end()) {
+        mapped_name = it->second;
+      }
+
+      providers_list.push_back(flutter::EncodableValue(mapped_name));
+    }
+
+    result->Success(flutter::EncodableValue(providers_list));
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleRunInference(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  // Calls of sessions with micro-batching enabled respond from their batch instead
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  if (args && SubmitBatchedInference(*args, result)) {
+    return;
+  }
+  RunWithInputsOnWorker(method_call, std::move(result), &FlutterOnnxruntimePlugin::RunInference);
+}
+
+void FlutterOnnxruntimePlugin::RunOnWorker(InferenceExecutor &executor,
+                                           const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+                                           WorkerHandler handler) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  // The method call only lives for the duration of this handler, so the worker gets its own copy of the arguments.
+  // std::function needs a copyable callable, hence the shared_ptr around the result.
+  auto arguments = std::make_shared<flutter::EncodableMap>(*args);
+  auto platform_result = std::make_shared<std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>>(
+      std::make_unique<PlatformThreadResult>(std::move(result), impl_->platformTaskRunner_.get()));
+
+  std::shared_ptr<RunControl> run = TrackRun(*impl_->runRegistry_, *args);
+  executor.submit(
+      [this, handler, arguments, platform_result, run]() {
+        (this->*handler)(*arguments, std::move(*platform_result));
+        if (run) {
+          impl_->runRegistry_->untrack(run);
+        }
+      },
+      LookupRunPriority(*args), run);
+}
+
+namespace {
+
+// Borrow the tensors of an inputs map from Dart ({name: {valueId: id}}); returns false with an error message if one
+// of them was released or never existed, or cannot be copied to the host for host_memory.
+// Stored tensors are borrowed rather than cloned; the leases keep them alive during inference
+// even if Dart releases them in the meantime
+bool CollectInputs(TensorManager &tensor_manager, const flutter::EncodableMap &inputs_map,
+                   std::vector<TensorLease> &input_leases, std::vector<const OrtValue *> &input_values,
+                   std::vector<std::string> &input_names, std::string *error_message, bool host_memory = false) {
+  TraceScope trace("collectInputs");
+  for (const auto &input_pair : inputs_map) {
+    if (!std::holds_alternative<std::string>(input_pair.first) ||
+        !std::holds_alternative<flutter::EncodableMap>(input_pair.second)) {
+      continue;
+    }
+
+    // Extract the input name from the map key
+    std::string input_name = std::get<std::string>(input_pair.first);
+
+    const auto &input_value_map = std::get<flutter::EncodableMap>(input_pair.second);
+    TensorHandle tensor_id = kInvalidHandle;
+    if (!LookupHandle(input_value_map, "valueId", kTensorIdPrefix, &tensor_id)) {
+      continue;
+    }
+
+    // Borrow the tensor value
+    TensorLease lease;
+    try {
+      lease = host_memory ? tensor_manager.acquireHostTensor(tensor_id) : tensor_manager.acquireTensor(tensor_id);
+    } catch (const std::exception &e) {
+      *error_message = "OrtValue of input " + input_name + ": " + e.what();
+      return false;
+    }
+    if (!lease) {
+      *error_message = "OrtValue of input " + input_name + " not found";
+      return false;
+    }
+    input_values.push_back(lease.get());
+    input_names.push_back(input_name);
+    input_leases.push_back(std::move(lease));
+  }
+  return true;
+}
+
+// Borrow the inputs of a call: its inputs map, or every map of its list of inputs for runBatch. Inputs of the wrong
+// type are left for the handler to report; returns false with an error message if a tensor cannot be borrowed.
+bool BorrowCallInputs(TensorManager &tensor_manager, const flutter::EncodableMap &arguments, CallInputs &inputs,
+                      std::string *error_message, bool host_memory) {
+  auto inputs_it = arguments.find(flutter::EncodableValue("inputs"));
+  if (inputs_it == arguments.end()) {
+    return true;
+  }
+
+  uint64_t borrow_start = steadyNanos();
+  std::vector<const flutter::EncodableValue *> input_maps;
+  if (std::holds_alternative<flutter::EncodableMap>(inputs_it->second)) {
+    input_maps.push_back(&inputs_it->second);
+  } else if (std::holds_alternative<flutter::EncodableList>(inputs_it->second)) {
+    for (const auto &request : std::get<flutter::EncodableList>(inputs_it->second)) {
+      input_maps.push_back(&request);
+    }
+  }
+  for (const auto *input_map : input_maps) {
+    inputs.values.emplace_back();
+    inputs.names.emplace_back();
+    if (!std::holds_alternative<flutter::EncodableMap>(*input_map)) {
+      continue;
+    }
+    if (!CollectInputs(tensor_manager, std::get<flutter::EncodableMap>(*input_map), inputs.leases,
+                       inputs.values.back(), inputs.names.back(), error_message, host_memory)) {
+      return false;
+    }
+  }
+  inputs.nanos = steadyNanos() - borrow_start;
+  return true;
+}
+
+// Configure run options from the runOptions entry of the method call arguments
+void ApplyRunOptions(const flutter::EncodableMap &args, Ort::RunOptions &run_options) {
+  auto run_options_it = args.find(flutter::EncodableValue("runOptions"));
+  if (run_options_it == args.end() || !std::holds_alternative<flutter::EncodableMap>(run_options_it->second)) {
+    return;
+  }
+
+  const auto &options_map = std::get<flutter::EncodableMap>(run_options_it->second);
+
+  // Extract log severity level if provided
+  auto log_severity_it = options_map.find(flutter::EncodableValue("logSeverityLevel"));
+  if (log_severity_it != options_map.end() && std::holds_alternative<int32_t>(log_severity_it->second)) {
+    run_options.SetRunLogSeverityLevel(std::get<int32_t>(log_severity_it->second));
+  }
+
+  // Extract log verbosity level if provided
+  auto log_verbosity_it = options_map.find(flutter::EncodableValue("logVerbosityLevel"));
+  if (log_verbosity_it != options_map.end() && std::holds_alternative<int32_t>(log_verbosity_it->second)) {
+    run_options.SetRunLogVerbosityLevel(std::get<int32_t>(log_verbosity_it->second));
+  }
+
+  // Extract terminate option if provided
+  auto terminate_it = options_map.find(flutter::EncodableValue("terminate"));
+  if (terminate_it != options_map.end() && std::holds_alternative<bool>(terminate_it->second)) {
+    if (std::get<bool>(terminate_it->second)) {
+      run_options.SetTerminate();
+    }
+  }
+
+  // The tag a call can be cancelled by also names its run in the ONNX Runtime logs
+  auto run_tag_it = options_map.find(flutter::EncodableValue("runTag"));
+  if (run_tag_it != options_map.end() && std::holds_alternative<std::string>(run_tag_it->second)) {
+    run_options.SetRunTag(std::get<std::string>(run_tag_it->second).c_str());
+  }
+}
+
+// Throw if one of the outputs is a sequence or a map: the tensor manager only stores tensors, so these cannot be
+// returned to Dart. Checked before any output is stored so that a failing call leaves no tensors behind.
+void CheckTensorOutputs(const std::vector<std::string> &names, const std::vector<Ort::Value> &outputs) {
+  for (size_t i = 0; i < outputs.size() && i < names.size(); i++) {
+    // Outputs kept as sequence state are empty and stay in the session
+    if (outputs[i] && !outputs[i].IsTensor()) {
+      throw std::runtime_error("Output " + names[i] + " is a sequence or map, only tensor outputs can be returned");
+    }
+  }
+}
+
+void CheckTensorOutputs(const std::vector<std::pair<std::string, Ort::Value>> &outputs) {
+  for (const auto &[name, value] : outputs) {
+    if (value && !value.IsTensor()) {
+      throw std::runtime_error("Output " + name + " is a sequence or map, only tensor outputs can be returned");
+    }
+  }
+}
+
+// Build the (value_id, type, shape) entry that Dart expects for an output tensor
+flutter::EncodableValue OutputInfoToEncodable(const FlutterOnnxruntimePluginImpl &impl, TensorHandle value_id) {
+  // Get the tensor type and shape
+  std::string tensor_type = impl.tensorManager_->getTensorType(value_id);
+  std::vector<int64_t> shape = impl.tensorManager_->getTensorShape(value_id);
+
+  flutter::EncodableList shape_list;
+  for (const auto &dim : shape) {
+    shape_list.push_back(static_cast<int64_t>(dim));
+  }
+
+  flutter::EncodableList output_info;
+  output_info.push_back(impl.EncodeHandle(kTensorIdPrefix, value_id));
+  output_info.push_back(flutter::EncodableValue(tensor_type));
+  output_info.push_back(flutter::EncodableValue(shape_list));
+  return flutter::EncodableValue(output_info);
+}
+
+} // namespace
+
+void FlutterOnnxruntimePlugin::RunWithInputsOnWorker(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result, InputsHandler handler, bool host_memory) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  // std::function needs a copyable callable, hence the shared_ptrs around the inputs and the result
+  auto inputs = std::make_shared<CallInputs>();
+  std::string error_message;
+  if (!BorrowCallInputs(*impl_->tensorManager_, *args, *inputs, &error_message, host_memory)) {
+    result->Error("INVALID_ORT_VALUE", error_message, nullptr);
+    return;
+  }
+
+  // The method call only lives for the duration of this handler, so the worker gets its own copy of the arguments
+  auto arguments = std::make_shared<flutter::EncodableMap>(*args);
+  auto platform_result = std::make_shared<std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>>(
+      std::make_unique<PlatformThreadResult>(std::move(result), impl_->platformTaskRunner_.get()));
+
+  std::shared_ptr<RunControl> run = TrackRun(*impl_->runRegistry_, *args);
+  impl_->inferenceExecutor_->submit(
+      [this, handler, arguments, inputs, platform_result, run]() {
+        (this->*handler)(*arguments, *inputs, std::move(*platform_result));
+        if (run) {
+          impl_->runRegistry_->untrack(run);
+        }
+      },
+      LookupRunPriority(*args), run);
+}
+
+bool FlutterOnnxruntimePlugin::SubmitBatchedInference(
+    const flutter::EncodableMap &arguments, std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> &result) {
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(arguments, "sessionId", kSessionIdPrefix, &session_id) ||
+      !impl_->microBatcher_->isEnabled(session_id)) {
+    return false;
+  }
+
+  // Invalid calls run on their own so that RunInference reports the error
+  auto inputs_it = arguments.find(flutter::EncodableValue("inputs"));
+  if (inputs_it == arguments.end() || !std::holds_alternative<flutter::EncodableMap>(inputs_it->second)) {
+    return false;
+  }
+
+  // A batch runs with default run options, so calls with their own options are not batched
+  auto run_options_it = arguments.find(flutter::EncodableValue("runOptions"));
+  if (run_options_it != arguments.end() && std::holds_alternative<flutter::EncodableMap>(run_options_it->second) &&
+      !std::get<flutter::EncodableMap>(run_options_it->second).empty()) {
+    return false;
+  }
+
+  // Batches return every output, so calls that select some of them are not batched either
+  auto output_names_it = arguments.find(flutter::EncodableValue("outputNames"));
+  if (output_names_it != arguments.end() && std::holds_alternative<flutter::EncodableList>(output_names_it->second) &&
+      !std::get<flutter::EncodableList>(output_names_it->second).empty()) {
+    return false;
+  }
+
+  // Calls with inputs that cannot be borrowed run on their own as well, which reports the error
+  BatchedInference request;
+  std::string error_message;
+  if (!CollectInputs(*impl_->tensorManager_, std::get<flutter::EncodableMap>(inputs_it->second), request.input_leases,
+                     request.input_values, request.input_names, &error_message) ||
+      request.input_values.empty()) {
+    return false;
+  }
+
+  request.result = std::make_shared<PlatformThreadResult>(std::move(result), impl_->platformTaskRunner_.get());
+  auto request_result = request.result;
+  if (!impl_->microBatcher_->submit(session_id, std::move(request))) {
+    // Only happens while the plugin is being destroyed
+    request_result->Error("INVALID_SESSION", "Session is being closed", nullptr);
+  }
+  return true;
+}
+
+void FlutterOnnxruntimePluginImpl::DispatchBatch(SessionHandle session_id, std::vector<BatchedInference> &&batch) {
+  // std::function needs a copyable callable, hence the shared_ptr around the batch
+  auto requests = std::make_shared<std::vector<BatchedInference>>(std::move(batch));
+
+  inferenceExecutor_->submit([this, session_id, requests]() {
+    try {
+      std::vector<std::vector<const OrtValue *>> input_values;
+      std::vector<std::vector<std::string>> input_names;
+      for (const auto &request : *requests) {
+        input_values.push_back(request.input_values);
+        input_names.push_back(request.input_names);
+      }
+
+      // The requests come from unrelated calls, so one that fails is answered with its own error
+      std::vector<std::string> output_names = sessionManager_->getOutputNames(session_id);
+      std::vector<std::string> errors;
+      std::vector<std::vector<Ort::Value>> batch_outputs =
+          sessionManager_->runBatch(session_id, input_values, input_names, nullptr, &errors);
+
+      // The inputs were borrowed when each request was queued, so only the outputs are timed
+      uint64_t output_start = steadyNanos();
+      for (size_t r = 0; r < batch_outputs.size(); r++) {
+        if (!errors[r].empty()) {
+          (*requests)[r].result->Error("INFERENCE_ERROR", errors[r], nullptr);
+          continue;
+        }
+        std::vector<TensorHandle> stored_ids;
+        flutter::EncodableMap outputs_map;
+        try {
+          CheckTensorOutputs(output_names, batch_outputs[r]);
+          for (size_t i = 0; i < batch_outputs[r].size() && i < output_names.size(); i++) {
+            stored_ids.push_back(tensorManager_->storeTensor(std::move(batch_outputs[r][i])));
+            outputs_map[flutter::EncodableValue(output_names[i])] = OutputInfoToEncodable(*this, stored_ids.back());
+          }
+        } catch (const std::exception &e) {
+          // Dart never learns the IDs of the outputs stored before the failure, so they are released here
+          tensorManager_->releaseTensors(stored_ids);
+          (*requests)[r].result->Error("PLUGIN_ERROR", e.what(), nullptr);
+          continue;
+        }
+        (*requests)[r].result->Success(flutter::EncodableValue(outputs_map));
+      }
+      sessionManager_->recordCall(session_id, 0, steadyNanos() - output_start);
+    } catch (const Ort::Exception &e) {
+      for (auto &request : *requests) {
+        request.result->Error("INFERENCE_ERROR", e.what(), nullptr);
+      }
+    } catch (const std::exception &e) {
+      for (auto &request : *requests) {
+        request.result->Error("PLUGIN_ERROR", e.what(), nullptr);
+      }
+    } catch (...) {
+      for (auto &request : *requests) {
+        request.result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+      }
+    }
+  });
+}
+
+void FlutterOnnxruntimePlugin::RunInference(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                                            std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  TraceScope trace("runInference");
+  const auto *args = &arguments;
+
+  try {
+    // Extract session ID
+    SessionHandle session_id = kInvalidHandle;
+    if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
+      result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+      return;
+    }
+
+    // Check if session exists
+    if (!impl_->sessionManager_->hasSession(session_id)) {
+      result->Error("INVALID_SESSION", "Session not found", nullptr);
+      return;
+    }
+
+    // Extract inputs map
+    auto inputs_it = args->find(flutter::EncodableValue("inputs"));
+    if (inputs_it == args->end() || !std::holds_alternative<flutter::EncodableMap>(inputs_it->second)) {
+      result->Error("INVALID_ARG", "Inputs must be a non-null map", nullptr);
+      return;
+    }
+
+    Ort::MemoryInfo output_memory_info{nullptr};
+    std::string device_error;
+    if (!LookupOutputDevice(*args, &output_memory_info, &device_error)) {
+      result->Error("INVALID_ARG", device_error.c_str(), nullptr);
+      return;
+    }
+
+    // Extract run options if provided
+    Ort::RunOptions run_options;
+    ApplyRunOptions(*args, run_options);
+    // The run stops early if it is cancelled, times out or a high-priority run needs its worker
+    RunScope run_scope([&run_options] { run_options.SetTerminate(); });
+
+    // Compute only the requested outputs, or all outputs if no names are given
+    std::vector<std::string> requested_names;
+    auto output_names_it = args->find(flutter::EncodableValue("outputNames"));
+    if (output_names_it != args->end() && std::holds_alternative<flutter::EncodableList>(output_names_it->second)) {
+      for (const auto &name_value : std::get<flutter::EncodableList>(output_names_it->second)) {
+        if (std::holds_alternative<std::string>(name_value)) {
+          requested_names.push_back(std::get<std::string>(name_value));
+        }
+      }
+    }
+    std::vector<std::string> output_names =
+        requested_names.empty() ? impl_->sessionManager_->getOutputNames(session_id) : requested_names;
+
+    // The inputs were borrowed when the call arrived
+    const std::vector<const OrtValue *> &input_values = inputs.values[0];
+    const std::vector<std::string> &input_names = inputs.names[0];
+
+    // Run inference using SessionManager with input names
+    // Note: the leases of the inputs stay alive until the call has been answered
+    std::vector<Ort::Value> output_tensors;
+    if (!input_values.empty() && output_memory_info) {
+      output_tensors = impl_->sessionManager_->runInferenceOnDevice(session_id, input_values, input_names,
+                                                                    output_memory_info, &run_options, requested_names);
+    } else if (!input_values.empty()) {
+      output_tensors =
+          impl_->sessionManager_->runInference(session_id, input_values, input_names, &run_options, requested_names);
+    }
+
+    // Process outputs
+    CheckTensorOutputs(output_names, output_tensors);
+    uint64_t output_start = steadyNanos();
+    flutter::EncodableMap outputs_map;
+    uint64_t return_data_max_bytes = output_memory_info ? 0 : LookupReturnDataMaxBytes(*args);
+
+    // For each output tensor, store it using TensorManager
+    for (size_t i = 0; i < output_tensors.size(); i++) {
+      // Outputs kept as sequence state stay in the session
+      if (!output_tensors[i]) {
+        continue;
+      }
+
+      // Small outputs come back as a {data, dataType, shape} map and are never stored
+      if (i < output_names.size() && IsInlineOutput(output_tensors[i], return_data_max_bytes)) {
+        outputs_map[flutter::EncodableValue(output_names[i])] = encodeTensor<EncodableValueCodec>(output_tensors[i]);
+        continue;
+      }
+
+      // Store the tensor - this transfers ownership and returns its handle
+      TensorHandle value_id = impl_->tensorManager_->storeTensor(std::move(output_tensors[i]));
+
+      if (i < output_names.size()) {
+        outputs_map[flutter::EncodableValue(output_names[i])] = OutputInfoToEncodable(*impl_, value_id);
+      }
+    }
+    impl_->sessionManager_->recordCall(session_id, inputs.nanos, steadyNanos() - output_start);
+
+    result->Success(flutter::EncodableValue(outputs_map));
+  } catch (const Ort::Exception &e) {
+    result->Error(InferenceErrorCode(), e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleRunBatch(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  RunWithInputsOnWorker(method_call, std::move(result), &FlutterOnnxruntimePlugin::RunBatch);
+}
+
+void FlutterOnnxruntimePlugin::RunBatch(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                                        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  try {
+    SessionHandle session_id = kInvalidHandle;
+    if (!LookupHandle(arguments, "sessionId", kSessionIdPrefix, &session_id)) {
+      result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+      return;
+    }
+
+    if (!impl_->sessionManager_->hasSession(session_id)) {
+      result->Error("INVALID_SESSION", "Session not found", nullptr);
+      return;
+    }
+
+    // One inputs map per request
+    auto inputs_it = arguments.find(flutter::EncodableValue("inputs"));
+    if (inputs_it == arguments.end() || !std::holds_alternative<flutter::EncodableList>(inputs_it->second)) {
+      result->Error("INVALID_ARG", "Inputs must be a non-null list", nullptr);
+      return;
+    }
+    const auto &requests = std::get<flutter::EncodableList>(inputs_it->second);
+
+    Ort::RunOptions run_options;
+    ApplyRunOptions(arguments, run_options);
+    // The run stops early if it is cancelled, times out or a high-priority run needs its worker
+    RunScope run_scope([&run_options] { run_options.SetTerminate(); });
+
+    std::vector<std::string> output_names = impl_->sessionManager_->getOutputNames(session_id);
+
+    // The inputs of every request were borrowed when the call arrived
+    for (const auto &request : requests) {
+      if (!std::holds_alternative<flutter::EncodableMap>(request)) {
+        result->Error("INVALID_ARG", "Each batch entry must be a map of inputs", nullptr);
+        return;
+      }
+    }
+
+    std::vector<std::vector<Ort::Value>> batch_outputs =
+        impl_->sessionManager_->runBatch(session_id, inputs.values, inputs.names, &run_options);
+
+    for (const auto &output_tensors : batch_outputs) {
+      CheckTensorOutputs(output_names, output_tensors);
+    }
+
+    // One outputs map per request, in request order
+    uint64_t output_start = steadyNanos();
+    flutter::EncodableList results;
+    results.reserve(batch_outputs.size());
+    for (auto &output_tensors : batch_outputs) {
+      flutter::EncodableMap outputs_map;
+      for (size_t i = 0; i < output_tensors.size() && i < output_names.size(); i++) {
+        TensorHandle value_id = impl_->tensorManager_->storeTensor(std::move(output_tensors[i]));
+        outputs_map[flutter::EncodableValue(output_names[i])] = OutputInfoToEncodable(*impl_, value_id);
+      }
+      results.push_back(flutter::EncodableValue(outputs_map));
+    }
+    impl_->sessionManager_->recordCall(session_id, inputs.nanos, steadyNanos() - output_start);
+
+    result->Success(flutter::EncodableValue(results));
+  } catch (const Ort::Exception &e) {
+    result->Error(InferenceErrorCode(), e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleBindOutputs(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  // Extract session ID
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+
+  // Check if session exists
+  if (!impl_->sessionManager_->hasSession(session_id)) {
+    result->Error("INVALID_SESSION", "Session not found", nullptr);
+    return;
+  }
+
+  std::vector<TensorInfo> output_info = impl_->sessionManager_->getOutputInfo(session_id);
+
+  // Bind the requested outputs, or all outputs if no names are given
+  std::vector<std::string> output_names;
+  auto output_names_it = args->find(flutter::EncodableValue("outputNames"));
+  if (output_names_it != args->end() && std::holds_alternative<flutter::EncodableList>(output_names_it->second)) {
+    for (const auto &name_value : std::get<flutter::EncodableList>(output_names_it->second)) {
+      if (std::holds_alternative<std::string>(name_value)) {
+        output_names.push_back(std::get<std::string>(name_value));
+      }
+    }
+  } else {
+    for (const auto &info : output_info) {
+      output_names.push_back(info.name);
+    }
+  }
+
+  // Preallocate one tensor per output; they are released again if any of them cannot be created
+  std::vector<TensorHandle> value_ids;
+  std::vector<TensorLease> outputs;
+  try {
+    for (const auto &name : output_names) {
+      auto info_it = std::find_if(output_info.begin(), output_info.end(),
+                                  [&name](const TensorInfo &info) { return info.name == name; });
+      if (info_it == output_info.end()) {
+        throw std::runtime_error("Unknown output name: " + name);
+      }
+
+      try {
+        value_ids.push_back(impl_->tensorManager_->createEmptyTensor(info_it->element_type, info_it->shape));
+      } catch (const std::exception &e) {
+        throw std::runtime_error("Cannot bind output " + name + ": " + e.what());
+      }
+      outputs.push_back(impl_->tensorManager_->acquireTensor(value_ids.back()));
+    }
+
+    impl_->sessionManager_->bindOutputs(session_id, output_names, std::move(outputs));
+  } catch (const std::exception &e) {
+    outputs.clear();
+    for (const auto &value_id : value_ids) {
+      impl_->tensorManager_->releaseTensor(value_id);
+    }
+    result->Error("INVALID_ARG", e.what(), nullptr);
+    return;
+  }
+
+  flutter::EncodableMap outputs_map;
+  for (size_t i = 0; i < output_names.size(); i++) {
+    outputs_map[flutter::EncodableValue(output_names[i])] = OutputInfoToEncodable(*impl_, value_ids[i]);
+  }
+  result->Success(flutter::EncodableValue(outputs_map));
+}
+
+void FlutterOnnxruntimePlugin::HandleRunWithBinding(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  RunWithInputsOnWorker(method_call, std::move(result), &FlutterOnnxruntimePlugin::RunWithBinding);
+}
+
+void FlutterOnnxruntimePlugin::RunWithBinding(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  try {
+    // Extract session ID
+    SessionHandle session_id = kInvalidHandle;
+    if (!LookupHandle(arguments, "sessionId", kSessionIdPrefix, &session_id)) {
+      result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+      return;
+    }
+
+    // Check if session exists
+    if (!impl_->sessionManager_->hasSession(session_id)) {
+      result->Error("INVALID_SESSION", "Session not found", nullptr);
+      return;
+    }
+
+    // Extract inputs map
+    auto inputs_it = arguments.find(flutter::EncodableValue("inputs"));
+    if (inputs_it == arguments.end() || !std::holds_alternative<flutter::EncodableMap>(inputs_it->second)) {
+      result->Error("INVALID_ARG", "Inputs must be a non-null map", nullptr);
+      return;
+    }
+
+    Ort::RunOptions run_options;
+    ApplyRunOptions(arguments, run_options);
+    // The run stops early if it is cancelled, times out or a high-priority run needs its worker
+    RunScope run_scope([&run_options] { run_options.SetTerminate(); });
+
+    // Outputs are written in place into the tensors created by bindOutputs
+    std::vector<std::pair<std::string, TensorHandle>> bound_outputs =
+        impl_->sessionManager_->runWithBinding(session_id, inputs.values[0], inputs.names[0], &run_options);
+
+    uint64_t output_start = steadyNanos();
+    flutter::EncodableMap outputs_map;
+    for (const auto &bound_output : bound_outputs) {
+      if (impl_->tensorManager_->getTensor(bound_output.second) == nullptr) {
+        result->Error("INVALID_VALUE", "Bound output " + bound_output.first + " was released, call bindOutputs again",
+                      nullptr);
+        return;
+      }
+      outputs_map[flutter::EncodableValue(bound_output.first)] = OutputInfoToEncodable(*impl_, bound_output.second);
+    }
+    impl_->sessionManager_->recordCall(session_id, inputs.nanos, steadyNanos() - output_start);
+
+    result->Success(flutter::EncodableValue(outputs_map));
+  } catch (const Ort::Exception &e) {
+    result->Error(InferenceErrorCode(), e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleUnbindOutputs(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+
+  impl_->sessionManager_->unbindOutputs(session_id);
+  result->Success(nullptr);
+}
+
+void FlutterOnnxruntimePlugin::EnableSequenceState(
+    const flutter::EncodableMap &arguments, std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(arguments, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+
+  // Loops map output names to the input names they feed
+  auto loops_it = arguments.find(flutter::EncodableValue("loops"));
+  const auto *loops_map =
+      loops_it != arguments.end() ? std::get_if<flutter::EncodableMap>(&loops_it->second) : nullptr;
+  if (!loops_map) {
+    result->Error("INVALID_ARG", "Loops must be a non-null map", nullptr);
+    return;
+  }
+  std::vector<std::pair<std::string, std::string>> loops;
+  for (const auto &loop : *loops_map) {
+    const auto *output = std::get_if<std::string>(&loop.first);
+    const auto *input = std::get_if<std::string>(&loop.second);
+    if (!output || !input) {
+      result->Error("INVALID_ARG", "Loops must map output names to input names", nullptr);
+      return;
+    }
+    loops.emplace_back(*output, *input);
+  }
+
+  std::map<std::string, int64_t> initial_dims;
+  auto dims_it = arguments.find(flutter::EncodableValue("initialDimensions"));
+  const auto *dims_map = dims_it != arguments.end() ? std::get_if<flutter::EncodableMap>(&dims_it->second) : nullptr;
+  if (dims_map) {
+    for (const auto &dim : *dims_map) {
+      const auto *name = std::get_if<std::string>(&dim.first);
+      int64_t size;
+      if (!name || !LookupInt(*dims_map, name->c_str(), &size) || size < 0) {
+        result->Error("INVALID_ARG", "Initial dimensions must map names to non-negative integers", nullptr);
+        return;
+      }
+      initial_dims[*name] = size;
+    }
+  }
+
+  if (!impl_->sessionManager_->hasSession(session_id)) {
+    result->Error("INVALID_SESSION", "Session not found", nullptr);
+    return;
+  }
+
+  try {
+    impl_->sessionManager_->enableSequenceState(session_id, loops, initial_dims);
+    result->Success(nullptr);
+  } catch (const Ort::Exception &e) {
+    result->Error("INVALID_ARG", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::ResetSequenceState(
+    const flutter::EncodableMap &arguments, std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(arguments, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+
+  try {
+    if (!impl_->sessionManager_->resetSequenceState(session_id)) {
+      result->Error("INVALID_SESSION", "Session not found or without sequence state", nullptr);
+      return;
+    }
+    result->Success(nullptr);
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::DisableSequenceState(
+    const flutter::EncodableMap &arguments, std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(arguments, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+
+  impl_->sessionManager_->disableSequenceState(session_id);
+  result->Success(nullptr);
+}
+
+void FlutterOnnxruntimePlugin::HandleSetInferenceThreads(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  auto num_threads_it = args->find(flutter::EncodableValue("numThreads"));
+  if (num_threads_it == args->end() || !std::holds_alternative<int32_t>(num_threads_it->second) ||
+      std::get<int32_t>(num_threads_it->second) < 1) {
+    result->Error("INVALID_ARG", "Number of threads must be a positive integer", nullptr);
+    return;
+  }
+
+  impl_->inferenceExecutor_->setNumThreads(static_cast<size_t>(std::get<int32_t>(num_threads_it->second)));
+
+  result->Success(nullptr);
+}
+
+void FlutterOnnxruntimePlugin::HandleGetQueueStats(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  static const char *kPriorityNames[kJobPriorityCount] = {"high", "normal", "low"};
+  std::array<JobQueueStats, kJobPriorityCount> stats = impl_->inferenceExecutor_->getQueueStats();
+
+  // Durations are sent in microseconds
+  flutter::EncodableMap result_map;
+  for (size_t i = 0; i < kJobPriorityCount; i++) {
+    flutter::EncodableMap queue;
+    queue[flutter::EncodableValue("queued")] = flutter::EncodableValue(static_cast<int64_t>(stats[i].queued));
+    queue[flutter::EncodableValue("submitted")] = flutter::EncodableValue(static_cast<int64_t>(stats[i].submitted));
+    queue[flutter::EncodableValue("started")] = flutter::EncodableValue(static_cast<int64_t>(stats[i].started));
+    queue[flutter::EncodableValue("preempted")] = flutter::EncodableValue(static_cast<int64_t>(stats[i].preempted));
+    queue[flutter::EncodableValue("waitMicros")] = flutter::EncodableValue(static_cast<int64_t>(stats[i].wait_micros));
+    queue[flutter::EncodableValue("maxWaitMicros")] =
+        flutter::EncodableValue(static_cast<int64_t>(stats[i].max_wait_micros));
+    queue[flutter::EncodableValue("p50WaitMicros")] =
+        flutter::EncodableValue(static_cast<int64_t>(stats[i].p50_wait_micros));
+    queue[flutter::EncodableValue("p90WaitMicros")] =
+        flutter::EncodableValue(static_cast<int64_t>(stats[i].p90_wait_micros));
+    queue[flutter::EncodableValue("p99WaitMicros")] =
+        flutter::EncodableValue(static_cast<int64_t>(stats[i].p99_wait_micros));
+    result_map[flutter::EncodableValue(kPriorityNames[i])] = flutter::EncodableValue(queue);
+  }
+  result->Success(flutter::EncodableValue(result_map));
+}
+
+void FlutterOnnxruntimePlugin::HandleCancelLowPriorityRuns(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  size_t count = impl_->inferenceExecutor_->cancelLowPriority();
+  result->Success(flutter::EncodableValue(static_cast<int64_t>(count)));
+}
+
+void FlutterOnnxruntimePlugin::HandleCancelRun(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  auto tag_it = args->find(flutter::EncodableValue("runTag"));
+  if (tag_it == args->end() || !std::holds_alternative<std::string>(tag_it->second)) {
+    result->Error("INVALID_ARG", "Run tag must be a non-null string", nullptr);
+    return;
+  }
+
+  // False if no call with the tag is in flight, e.g. because it has already finished
+  bool cancelled = impl_->runRegistry_->cancel(std::get<std::string>(tag_it->second));
+  result->Success(flutter::EncodableValue(cancelled));
+}
+
+void FlutterOnnxruntimePlugin::HandleSetIntegerHandles(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  auto enabled_it = args->find(flutter::EncodableValue("enabled"));
+  if (enabled_it == args->end() || !std::holds_alternative<bool>(enabled_it->second)) {
+    result->Error("INVALID_ARG", "Enabled must be a boolean", nullptr);
+    return;
+  }
+
+  // Only affects handles sent from now on; both forms of existing IDs are still accepted
+  impl_->integerHandles_.store(std::get<bool>(enabled_it->second));
+
+  result->Success(nullptr);
+}
+
+void FlutterOnnxruntimePlugin::HandleConfigureSessionCache(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  int64_t max_sessions;
+  int64_t max_bytes;
+  if (!LookupInt(*args, "maxSessions", &max_sessions) || max_sessions < 0 ||
+      !LookupInt(*args, "maxBytes", &max_bytes) || max_bytes < 0) {
+    result->Error("INVALID_ARG", "Session and byte limits must be non-negative integers", nullptr);
+    return;
+  }
+
+  // Both limits 0 disable the cache
+  impl_->sessionManager_->configureSessionCache(static_cast<size_t>(max_sessions), static_cast<size_t>(max_bytes));
+
+  result->Success(nullptr);
+}
+
+void FlutterOnnxruntimePlugin::HandleConfigureThreadPools(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  int64_t intra_op_threads;
+  int64_t inter_op_threads;
+  if (!LookupInt(*args, "intraOpNumThreads", &intra_op_threads) || intra_op_threads < 0 ||
+      !LookupInt(*args, "interOpNumThreads", &inter_op_threads) || inter_op_threads < 0) {
+    result->Error("INVALID_ARG", "Thread counts must be non-negative integers", nullptr);
+    return;
+  }
+
+  ThreadPoolOptions options;
+  options.intra_op_threads = static_cast<int>(intra_op_threads);
+  options.inter_op_threads = static_cast<int>(inter_op_threads);
+
+  auto spinning_it = args->find(flutter::EncodableValue("allowSpinning"));
+  if (spinning_it != args->end() && std::holds_alternative<bool>(spinning_it->second)) {
+    options.allow_spinning = std::get<bool>(spinning_it->second);
+  }
+
+  auto affinity_it = args->find(flutter::EncodableValue("intraOpThreadAffinity"));
+  if (affinity_it != args->end() && std::holds_alternative<std::string>(affinity_it->second)) {
+    options.intra_op_affinity = std::get<std::string>(affinity_it->second);
+  }
+
+  try {
+    impl_->sessionManager_->configureThreadPools(options);
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+    return;
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+    return;
+  }
+
+  result->Success(nullptr);
+}
+
+void FlutterOnnxruntimePlugin::HandleConfigureSharedArena(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  ArenaOptions options;
+  int64_t max_bytes = 0;
+  if (LookupInt(*args, "maxBytes", &max_bytes)) {
+    if (max_bytes < 0) {
+      result->Error("INVALID_ARG", "maxBytes must be a non-negative integer", nullptr);
+      return;
+    }
+    options.max_bytes = static_cast<size_t>(max_bytes);
+  }
+
+  auto strategy_it = args->find(flutter::EncodableValue("extendStrategy"));
+  if (strategy_it != args->end() && std::holds_alternative<std::string>(strategy_it->second)) {
+    const std::string &strategy = std::get<std::string>(strategy_it->second);
+    if (strategy == "nextPowerOfTwo") {
+      options.extend_strategy = 0;
+    } else if (strategy == "sameAsRequested") {
+      options.extend_strategy = 1;
+    } else {
+      result->Error("INVALID_ARG", "Unknown arena extend strategy: " + strategy, nullptr);
+      return;
+    }
+  }
+
+  int64_t initial_chunk_bytes = 0;
+  if (LookupInt(*args, "initialChunkBytes", &initial_chunk_bytes)) {
+    options.initial_chunk_bytes = static_cast<int>(initial_chunk_bytes);
+  }
+
+  int64_t max_dead_bytes_per_chunk = 0;
+  if (LookupInt(*args, "maxDeadBytesPerChunk", &max_dead_bytes_per_chunk)) {
+    options.max_dead_bytes_per_chunk = static_cast<int>(max_dead_bytes_per_chunk);
+  }
+
+  try {
+    impl_->sessionManager_->configureSharedArena(options);
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+    return;
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+    return;
+  }
+
+  result->Success(nullptr);
+}
+
+void FlutterOnnxruntimePlugin::HandleConfigureBatching(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+
+  int64_t window_micros = 0;
+  int64_t max_batch_size = 0;
+  if (!LookupInt(*args, "windowMicros", &window_micros) || window_micros < 0 ||
+      !LookupInt(*args, "maxBatchSize", &max_batch_size) || max_batch_size < 0) {
+    result->Error("INVALID_ARG", "Batch size and window must be non-negative integers", nullptr);
+    return;
+  }
+
+  if (!impl_->sessionManager_->hasSession(session_id)) {
+    result->Error("INVALID_SESSION", "Session not found", nullptr);
+    return;
+  }
+
+  // A batch size below 2 disables batching
+  impl_->microBatcher_->configure(session_id, std::chrono::microseconds(window_micros),
+                                  static_cast<size_t>(max_batch_size));
+
+  result->Success(nullptr);
+}
+
+void FlutterOnnxruntimePlugin::HandleGetBatchingStats(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+
+  BatchingStats stats = impl_->microBatcher_->getStats(session_id);
+
+  flutter::EncodableList histogram;
+  for (uint64_t count : stats.batch_size_histogram) {
+    histogram.push_back(flutter::EncodableValue(static_cast<int64_t>(count)));
+  }
+
+  flutter::EncodableMap response;
+  response[flutter::EncodableValue("queueDepth")] = flutter::EncodableValue(static_cast<int64_t>(stats.queue_depth));
+  response[flutter::EncodableValue("maxQueueDepth")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.max_queue_depth));
+  response[flutter::EncodableValue("requests")] = flutter::EncodableValue(static_cast<int64_t>(stats.requests));
+  response[flutter::EncodableValue("batches")] = flutter::EncodableValue(static_cast<int64_t>(stats.batches));
+  response[flutter::EncodableValue("batchSizeHistogram")] = flutter::EncodableValue(histogram);
+
+  result->Success(flutter::EncodableValue(response));
+}
+
+void FlutterOnnxruntimePlugin::HandleGetSessionStats(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+
+  std::optional<SessionStatsSnapshot> stats = impl_->sessionManager_->getSessionStats(session_id);
+  if (!stats) {
+    result->Error("INVALID_SESSION", "Session not found", nullptr);
+    return;
+  }
+
+  // Durations are sent in microseconds
+  flutter::EncodableMap response;
+  response[flutter::EncodableValue("runs")] = flutter::EncodableValue(static_cast<int64_t>(stats->runs));
+  response[flutter::EncodableValue("runMicros")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats->run_nanos / 1000));
+  response[flutter::EncodableValue("p50Micros")] = flutter::EncodableValue(static_cast<int64_t>(stats->p50_micros));
+  response[flutter::EncodableValue("p90Micros")] = flutter::EncodableValue(static_cast<int64_t>(stats->p90_micros));
+  response[flutter::EncodableValue("p99Micros")] = flutter::EncodableValue(static_cast<int64_t>(stats->p99_micros));
+  response[flutter::EncodableValue("calls")] = flutter::EncodableValue(static_cast<int64_t>(stats->calls));
+  response[flutter::EncodableValue("inputMicros")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats->input_nanos / 1000));
+  response[flutter::EncodableValue("outputMicros")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats->output_nanos / 1000));
+  response[flutter::EncodableValue("bytesIn")] = flutter::EncodableValue(static_cast<int64_t>(stats->bytes_in));
+  response[flutter::EncodableValue("bytesOut")] = flutter::EncodableValue(static_cast<int64_t>(stats->bytes_out));
+
+  result->Success(flutter::EncodableValue(response));
+}
+
+void FlutterOnnxruntimePlugin::HandleGetMemoryStats(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  TensorMemoryStats stats = impl_->tensorManager_->getMemoryStats();
+  BufferPoolStats pool = impl_->tensorManager_->getBufferPoolStats();
+
+  flutter::EncodableMap response;
+  response[flutter::EncodableValue("tensorCount")] = flutter::EncodableValue(static_cast<int64_t>(stats.tensor_count));
+  response[flutter::EncodableValue("hostBytes")] = flutter::EncodableValue(static_cast<int64_t>(stats.host_bytes));
+  flutter::EncodableMap bytes_by_type;
+  for (const auto &entry : stats.host_bytes_by_type) {
+    bytes_by_type[flutter::EncodableValue(entry.first)] = flutter::EncodableValue(static_cast<int64_t>(entry.second));
+  }
+  response[flutter::EncodableValue("hostBytesByType")] = flutter::EncodableValue(bytes_by_type);
+  response[flutter::EncodableValue("deviceBytes")] = flutter::EncodableValue(static_cast<int64_t>(stats.device_bytes));
+  response[flutter::EncodableValue("retiredCount")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.retired_count));
+  response[flutter::EncodableValue("hardLimitBytes")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.hard_limit_bytes));
+
+  flutter::EncodableMap pool_map;
+  pool_map[flutter::EncodableValue("hits")] = flutter::EncodableValue(static_cast<int64_t>(pool.hits));
+  pool_map[flutter::EncodableValue("misses")] = flutter::EncodableValue(static_cast<int64_t>(pool.misses));
+  pool_map[flutter::EncodableValue("retainedBytes")] =
+      flutter::EncodableValue(static_cast<int64_t>(pool.retained_bytes));
+  pool_map[flutter::EncodableValue("retainedBuffers")] =
+      flutter::EncodableValue(static_cast<int64_t>(pool.retained_buffers));
+  pool_map[flutter::EncodableValue("maxRetainedBytes")] =
+      flutter::EncodableValue(static_cast<int64_t>(pool.max_retained_bytes));
+  response[flutter::EncodableValue("bufferPool")] = flutter::EncodableValue(pool_map);
+
+  // Only sessions holding sequence state, such as a key/value cache, are listed
+  flutter::EncodableList sessions;
+  for (const auto &entry : impl_->sessionManager_->getSequenceStateBytes()) {
+    flutter::EncodableMap session;
+    session[flutter::EncodableValue("sessionId")] = impl_->EncodeHandle(kSessionIdPrefix, entry.first);
+    session[flutter::EncodableValue("sequenceStateBytes")] =
+        flutter::EncodableValue(static_cast<int64_t>(entry.second));
+    sessions.push_back(flutter::EncodableValue(session));
+  }
+  response[flutter::EncodableValue("sessions")] = flutter::EncodableValue(sessions);
+
+  result->Success(flutter::EncodableValue(response));
+}
+
+void FlutterOnnxruntimePlugin::HandleSetMemoryLimit(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
+
+  int64_t hard_limit_bytes = 0;
+  if (!LookupInt(*args, "hardLimitBytes", &hard_limit_bytes) || hard_limit_bytes < 0) {
+    result->Error("INVALID_ARG", "hardLimitBytes must be a non-negative integer", nullptr);
+    return;
+  }
+
+  impl_->tensorManager_->setHardMemoryLimit(static_cast<uint64_t>(hard_limit_bytes));
+
+  result->Success(nullptr);
+}
+
+namespace {
+
+// Convert profile entries to a list of {name, opType, provider, totalMicros, calls} maps
+flutter::EncodableList ProfileEntriesToList(const std::vector<ProfileEntry> &entries) {
+  flutter::EncodableList list;
+  for (const auto &entry : entries) {
+    flutter::EncodableMap map;
+    map[flutter::EncodableValue("name")] = flutter::EncodableValue(entry.name);
+    map[flutter::EncodableValue("opType")] = flutter::EncodableValue(entry.op_type);
+    map[flutter::EncodableValue("provider")] = flutter::EncodableValue(entry.provider);
+    map[flutter::EncodableValue("totalMicros")] = flutter::EncodableValue(static_cast<int64_t>(entry.total_micros));
+    map[flutter::EncodableValue("calls")] = flutter::EncodableValue(static_cast<int64_t>(entry.calls));
+    list.push_back(flutter::EncodableValue(map));
+  }
+  return list;
+}
+
+} // namespace
+
+void FlutterOnnxruntimePlugin::HandleEndProfiling(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  // Writing and parsing the trace can take a while
+  RunOnWorker(*impl_->sessionLoader_, method_call, std::move(result), &FlutterOnnxruntimePlugin::EndProfiling);
+}
+
+void FlutterOnnxruntimePlugin::EndProfiling(const flutter::EncodableMap &arguments,
+                                            std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  SessionHandle session_id = kInvalidHandle;
+  if (!LookupHandle(arguments, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+
+  try {
+    std::optional<std::string> profile_path = impl_->sessionManager_->endProfiling(session_id);
+    if (!profile_path) {
+      result->Error("INVALID_SESSION", "Session not found", nullptr);
+      return;
+    }
+    if (profile_path->empty()) {
+      result->Error("INVALID_ARG", "Profiling is not enabled for this session", nullptr);
+      return;
+    }
+
+    ProfileSummary summary = summarizeProfileFile(*profile_path);
+    flutter::EncodableMap response;
+    response[flutter::EncodableValue("profilePath")] = flutter::EncodableValue(*profile_path);
+    response[flutter::EncodableValue("totalMicros")] =
+        flutter::EncodableValue(static_cast<int64_t>(summary.total_micros));
+    response[flutter::EncodableValue("nodes")] = flutter::EncodableValue(ProfileEntriesToList(summary.nodes));
+    response[flutter::EncodableValue("ops")] = flutter::EncodableValue(ProfileEntriesToList(summary.ops));
+    result->Success(flutter::EncodableValue(response));
+  } catch (const Ort::Exception &e) {
+    result->Error("ORT_ERROR", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::HandleStartTracing(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  TraceRecorder::instance().start();
+  result->Success();
+}
+
+void FlutterOnnxruntimePlugin::HandleStopTracing(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  // The trace file is written off the platform thread
+  RunOnWorker(*impl_->sessionLoader_, method_call, std::move(result), &FlutterOnnxruntimePlugin::StopTracing);
+}
+
+void FlutterOnnxruntimePlugin::StopTracing(const flutter::EncodableMap &arguments,
+                                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  TraceRecorder::instance().stop();
+
+  // Write to the given path, or to a new file in the app temp directory
+  std::filesystem::path trace_path;
+  auto path_it = arguments.find(flutter::EncodableValue("path"));
+  if (path_it != arguments.end() && std::holds_alternative<std::string>(path_it->second)) {
+    trace_path = std::filesystem::u8path(std::get<std::string>(path_it->second));
+  } else {
+    std::error_code error;
+    std::filesystem::path trace_dir = std::filesystem::u8path(WindowsUtils::getAppTempDirectory() + "traces");
+    std::filesystem::create_directories(trace_dir, error);
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    trace_path = trace_dir / ("plugin_trace_" + std::to_string(now.count()) + ".json");
+  }
 
-    result->Success(flutter::EncodableValue(response));
-  } catch (const Ort::Exception &e) {
-    result->Error("ORT_ERROR", e.what(), nullptr);
-  } catch (const std::exception &e) {
-    result->Error("PLUGIN_ERROR", e.what(), nullptr);
-  } catch (...) {
-    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  std::string trace_path_utf8 = trace_path.u8string();
+  std::ofstream trace_file(trace_path, std::ios::binary);
+  if (!trace_file) {
+    std::string error_message = "Failed to open trace file: " + trace_path_utf8;
+    result->Error("INVALID_ARG", error_message.c_str(), nullptr);
+    return;
+  }
+  size_t spans = TraceRecorder::instance().writeChromeTrace(trace_file);
+  trace_file.close();
+  if (!trace_file) {
+    std::string error_message = "Failed to write trace file: " + trace_path_utf8;
+    result->Error("PLUGIN_ERROR", error_message.c_str(), nullptr);
+    return;
   }
+
+  flutter::EncodableMap response;
+  response[flutter::EncodableValue("tracePath")] = flutter::EncodableValue(trace_path_utf8);
+  response[flutter::EncodableValue("spans")] = flutter::EncodableValue(static_cast<int64_t>(spans));
+  result->Success(flutter::EncodableValue(response));
 }
 
-void FlutterOnnxruntimePlugin::HandleGetAvailableProviders(
+void FlutterOnnxruntimePlugin::HandleGetNativeContext(
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  // The address that Dart passes back to the fort_* functions of native_api.h over dart:ffi
+  flutter::EncodableMap response;
+  response[flutter::EncodableValue("context")] =
+      flutter::EncodableValue(static_cast<int64_t>(reinterpret_cast<intptr_t>(&impl_->nativeContext_)));
 
-  try {
-    // Get available providers from ONNX Runtime
-    std::vector<std::string> providers = Ort::GetAvailableProviders();
+  result->Success(flutter::EncodableValue(response));
+}
 
-    // Map provider names to standardized enum names
-    flutter::EncodableList providers_list;
-    for (const auto &provider : providers) {
-      std::string mapped_name = provider;
+void FlutterOnnxruntimePlugin::HandleCloseSession(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
 
-      // Map C++ API provider names to enum names
-      static const std::unordered_map<std::string, std::string> provider_map = {
-          {"CPUExecutionProvider", "CPU"},
-          {"CUDAExecutionProvider", "CUDA"},
-          {"TensorrtExecutionProvider", "TENSOR_RT"},
-          {"AzureExecutionProvider", "AZURE"},
-          {"MIGraphXExecutionProvider", "MIGRAPHX"},
-          {"ROCMExecutionProvider", "ROCM"},
-          {"CoreMLExecutionProvider", "CORE_ML"},
-          {"DnnlExecutionProvider", "DNNL"},
-          {"OpenVINOExecutionProvider", "OPEN_VINO"},
-          {"NnapiExecutionProvider", "NNAPI"},
-          {"QnnExecutionProvider", "QNN"},
-          {"DmlExecutionProvider", "DIRECT_ML"},
-          {"ACLExecutionProvider", "ACL"},
-          {"ArmNNExecutionProvider", "ARM_NN"},
-          {"XnnpackExecutionProvider", "XNNPACK"}};
+  // Extract parameters
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
 
-      auto it = provider_map.find(provider);
-      if (it != provider_map.end()) {
-        mapped_name = it->second;
-      }
+  if (!args) {
+    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+    return;
+  }
 
-      providers_list.push_back(flutter::EncodableValue(mapped_name));
+  try {
+    // Extract session ID
+    SessionHandle session_id = kInvalidHandle;
+    if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
+      result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+      return;
     }
 
-    result->Success(flutter::EncodableValue(providers_list));
+    // Requests still waiting for their batch are run now and fail once the session is gone
+    impl_->microBatcher_->remove(session_id);
+
+    // Close the session
+    impl_->sessionManager_->closeSession(session_id);
+
+    // Return null for success
+    result->Success(nullptr);
   } catch (const Ort::Exception &e) {
     result->Error("ORT_ERROR", e.what(), nullptr);
   } catch (const std::exception &e) {
@@ -630,203 +3287,433 @@ void FlutterOnnxruntimePlugin::HandleGetAvailableProviders(
   }
 }
 
-void FlutterOnnxruntimePlugin::HandleRunInference(
+void FlutterOnnxruntimePlugin::HandleCreatePipeline(
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-
-  // Extract parameters
   const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
-
   if (!args) {
     result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
     return;
   }
 
-  try {
-    // Extract session ID
-    auto session_id_it = args->find(flutter::EncodableValue("sessionId"));
-    if (session_id_it == args->end() || !std::holds_alternative<std::string>(session_id_it->second)) {
-      result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+  auto stages_it = args->find(flutter::EncodableValue("stages"));
+  auto outputs_it = args->find(flutter::EncodableValue("outputs"));
+  if (stages_it == args->end() || !std::holds_alternative<flutter::EncodableList>(stages_it->second) ||
+      outputs_it == args->end() || !std::holds_alternative<flutter::EncodableMap>(outputs_it->second)) {
+    result->Error("INVALID_ARG", "Pipeline needs a list of stages and a map of outputs", nullptr);
+    return;
+  }
+
+  PipelineDescription description;
+  for (const auto &stage_value : std::get<flutter::EncodableList>(stages_it->second)) {
+    PipelineStage stage;
+    std::string error_message;
+    if (!ParsePipelineStage(stage_value, &stage, &error_message)) {
+      result->Error("INVALID_ARG", error_message.c_str(), nullptr);
       return;
     }
-    std::string session_id = std::get<std::string>(session_id_it->second);
+    description.stages.push_back(std::move(stage));
+  }
+  for (const auto &[key, value] : std::get<flutter::EncodableMap>(outputs_it->second)) {
+    if (std::holds_alternative<std::string>(key) && std::holds_alternative<std::string>(value)) {
+      description.outputs[std::get<std::string>(key)] = std::get<std::string>(value);
+    }
+  }
 
-    // Check if session exists
-    if (!impl_->sessionManager_->hasSession(session_id)) {
-      result->Error("INVALID_SESSION", "Session not found", nullptr);
+  try {
+    auto pipeline = std::make_shared<Pipeline>(std::move(description), *impl_->sessionManager_);
+    PipelineHandle pipeline_id = impl_->pipelineManager_->addPipeline(std::move(pipeline));
+    flutter::EncodableMap response;
+    response[flutter::EncodableValue("pipelineId")] = impl_->EncodeHandle(kPipelineIdPrefix, pipeline_id);
+    result->Success(flutter::EncodableValue(response));
+  } catch (const std::invalid_argument &e) {
+    result->Error("INVALID_ARG", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  }
+}
+
+void FlutterOnnxruntimePlugin::RunPipeline(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  try {
+    PipelineHandle pipeline_id = kInvalidHandle;
+    if (!LookupHandle(arguments, "pipelineId", kPipelineIdPrefix, &pipeline_id)) {
+      result->Error("INVALID_ARG", "Pipeline ID must be provided", nullptr);
       return;
     }
-
-    // Extract inputs map
-    auto inputs_it = args->find(flutter::EncodableValue("inputs"));
-    if (inputs_it == args->end() || !std::holds_alternative<flutter::EncodableMap>(inputs_it->second)) {
+    auto inputs_it = arguments.find(flutter::EncodableValue("inputs"));
+    if (inputs_it == arguments.end() || !std::holds_alternative<flutter::EncodableMap>(inputs_it->second)) {
       result->Error("INVALID_ARG", "Inputs must be a non-null map", nullptr);
       return;
     }
-    const auto &inputs_map = std::get<flutter::EncodableMap>(inputs_it->second);
 
-    // Extract run options if provided
-    auto run_options_it = args->find(flutter::EncodableValue("runOptions"));
+    std::shared_ptr<Pipeline> pipeline = impl_->pipelineManager_->findPipeline(pipeline_id);
+    if (!pipeline) {
+      result->Error("INVALID_PIPELINE", "Pipeline not found", nullptr);
+      return;
+    }
+
+    std::map<std::string, const OrtValue *> named_inputs;
+    for (size_t i = 0; i < inputs.values[0].size(); i++) {
+      named_inputs[inputs.names[0][i]] = inputs.values[0][i];
+    }
+
     Ort::RunOptions run_options;
+    ApplyRunOptions(arguments, run_options);
+    // The run stops early if it is cancelled, times out or a high-priority run needs its worker
+    RunScope run_scope([&run_options] { run_options.SetTerminate(); });
+    std::vector<std::pair<std::string, Ort::Value>> outputs =
+        pipeline->run(*impl_->sessionManager_, named_inputs, &run_options);
+    CheckTensorOutputs(outputs);
 
-    if (run_options_it != args->end() && std::holds_alternative<flutter::EncodableMap>(run_options_it->second)) {
+    flutter::EncodableMap outputs_map;
+    for (auto &[name, value] : outputs) {
+      TensorHandle value_id = impl_->tensorManager_->storeTensor(std::move(value));
+      outputs_map[flutter::EncodableValue(name)] = OutputInfoToEncodable(*impl_, value_id);
+    }
+    result->Success(flutter::EncodableValue(outputs_map));
+  } catch (const std::invalid_argument &e) {
+    result->Error("INVALID_ARG", e.what(), nullptr);
+  } catch (const Ort::Exception &e) {
+    result->Error(InferenceErrorCode(), e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
 
-      const auto &options_map = std::get<flutter::EncodableMap>(run_options_it->second);
+void FlutterOnnxruntimePlugin::HandleClosePipeline(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  PipelineHandle pipeline_id = kInvalidHandle;
+  if (!args || !LookupHandle(*args, "pipelineId", kPipelineIdPrefix, &pipeline_id)) {
+    result->Error("INVALID_ARG", "Pipeline ID must be provided", nullptr);
+    return;
+  }
+  impl_->pipelineManager_->closePipeline(pipeline_id);
+  result->Success(nullptr);
+}
 
-      // Extract log severity level if provided
-      auto log_severity_it = options_map.find(flutter::EncodableValue("logSeverityLevel"));
-      if (log_severity_it != options_map.end() && std::holds_alternative<int32_t>(log_severity_it->second)) {
-        run_options.SetRunLogSeverityLevel(std::get<int32_t>(log_severity_it->second));
-      }
+void FlutterOnnxruntimePlugin::RunTensorOp(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  try {
+    auto op_it = arguments.find(flutter::EncodableValue("op"));
+    auto inputs_it = arguments.find(flutter::EncodableValue("inputs"));
+    if (op_it == arguments.end() || !std::holds_alternative<std::string>(op_it->second) ||
+        inputs_it == arguments.end() || !std::holds_alternative<flutter::EncodableMap>(inputs_it->second)) {
+      result->Error("INVALID_ARG", "Op needs a name and a map of inputs", nullptr);
+      return;
+    }
 
-      // Extract log verbosity level if provided
-      auto log_verbosity_it = options_map.find(flutter::EncodableValue("logVerbosityLevel"));
-      if (log_verbosity_it != options_map.end() && std::holds_alternative<int32_t>(log_verbosity_it->second)) {
-        run_options.SetRunLogVerbosityLevel(std::get<int32_t>(log_verbosity_it->second));
-      }
+    PipelineStage stage;
+    stage.op = std::get<std::string>(op_it->second);
+    stage.name = stage.op;
+    std::string error_message;
+    auto params_it = arguments.find(flutter::EncodableValue("params"));
+    if (params_it != arguments.end() && !ParseStageParams(params_it->second, &stage, &error_message)) {
+      result->Error("INVALID_ARG", error_message, nullptr);
+      return;
+    }
 
-      // Extract terminate option if provided
-      auto terminate_it = options_map.find(flutter::EncodableValue("terminate"));
-      if (terminate_it != options_map.end() && std::holds_alternative<bool>(terminate_it->second)) {
-        if (std::get<bool>(terminate_it->second)) {
-          run_options.SetTerminate();
-        }
-      }
+    std::map<std::string, const OrtValue *> named_inputs;
+    for (size_t i = 0; i < inputs.values[0].size(); i++) {
+      named_inputs[inputs.names[0][i]] = inputs.values[0][i];
     }
 
-    std::vector<std::string> output_names = impl_->sessionManager_->getOutputNames(session_id);
+    std::vector<std::pair<std::string, Ort::Value>> outputs = runGlueOp(stage, named_inputs);
+    CheckTensorOutputs(outputs);
+    flutter::EncodableMap outputs_map;
+    for (auto &[name, value] : outputs) {
+      TensorHandle value_id = impl_->tensorManager_->storeTensor(std::move(value));
+      outputs_map[flutter::EncodableValue(name)] = OutputInfoToEncodable(*impl_, value_id);
+    }
+    result->Success(flutter::EncodableValue(outputs_map));
+  } catch (const std::invalid_argument &e) {
+    result->Error("INVALID_ARG", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  } catch (...) {
+    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+  }
+}
 
-    // Prepare input tensors and input names
-    // Use ClonedTensor to keep backing buffers alive during inference
-    std::vector<ClonedTensor> cloned_inputs;
-    std::vector<std::string> input_names;
+void FlutterOnnxruntimePlugin::HandleOpenStream(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  SessionHandle session_id = kInvalidHandle;
+  if (!args || !LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_SESSION", "Invalid session ID", nullptr);
+    return;
+  }
+  if (!impl_->sessionManager_->hasSession(session_id)) {
+    result->Error("INVALID_SESSION", "Session not found", nullptr);
+    return;
+  }
 
-    // Iterate through each input
-    for (const auto &input_pair : inputs_map) {
-      if (!std::holds_alternative<std::string>(input_pair.first) ||
-          !std::holds_alternative<flutter::EncodableMap>(input_pair.second)) {
-        continue;
-      }
+  int64_t depth = 2;
+  LookupInt(*args, "depth", &depth);
+  if (depth < 1) {
+    result->Error("INVALID_ARG", "Stream depth must be positive", nullptr);
+    return;
+  }
 
-      // Extract the input name from the map key
-      std::string input_name = std::get<std::string>(input_pair.first);
+  try {
+    auto stream = std::make_shared<FrameStream>(session_id, static_cast<size_t>(depth), *impl_->sessionManager_,
+                                                *impl_->tensorManager_);
+    StreamHandle stream_id = impl_->streamManager_->addStream(std::move(stream));
+    flutter::EncodableMap response;
+    response[flutter::EncodableValue("streamId")] = impl_->EncodeHandle(kStreamIdPrefix, stream_id);
+    result->Success(flutter::EncodableValue(response));
+  } catch (const std::invalid_argument &e) {
+    result->Error("INVALID_ARG", e.what(), nullptr);
+  } catch (const std::exception &e) {
+    result->Error("PLUGIN_ERROR", e.what(), nullptr);
+  }
+}
 
-      const auto &input_value_map = std::get<flutter::EncodableMap>(input_pair.second);
-      auto tensor_id_it = input_value_map.find(flutter::EncodableValue("valueId"));
+// Copy the inputs of a frame into a free slot of its stream on the platform thread and run it on the inference
+// workers. The call returns as soon as the frame is queued; its outputs follow as an event of streamChannel_.
+void FlutterOnnxruntimePlugin::HandleSubmitStreamFrame(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  StreamHandle stream_id = kInvalidHandle;
+  if (!args || !LookupHandle(*args, "streamId", kStreamIdPrefix, &stream_id)) {
+    result->Error("INVALID_ARG", "Stream ID must be provided", nullptr);
+    return;
+  }
+  auto inputs_it = args->find(flutter::EncodableValue("inputs"));
+  if (inputs_it == args->end() || !std::holds_alternative<flutter::EncodableMap>(inputs_it->second)) {
+    result->Error("INVALID_ARG", "Inputs must be a non-null map", nullptr);
+    return;
+  }
 
-      if (tensor_id_it == input_value_map.end() || !std::holds_alternative<std::string>(tensor_id_it->second)) {
-        continue;
-      }
+  std::shared_ptr<FrameStream> stream = impl_->streamManager_->findStream(stream_id);
+  if (!stream) {
+    result->Error("INVALID_STREAM", "Stream not found", nullptr);
+    return;
+  }
 
-      std::string tensor_id = std::get<std::string>(tensor_id_it->second);
+  std::optional<size_t> slot = stream->acquireSlot();
+  if (!slot) {
+    result->Error("STREAM_FULL", "Every slot of the stream holds a frame in flight", nullptr);
+    return;
+  }
 
-      // Get the tensor value
-      Ort::Value *tensor_ptr = impl_->tensorManager_->getTensor(tensor_id);
-      if (tensor_ptr != nullptr) {
-        try {
-          // Clone the tensor — ClonedTensor owns both the Ort::Value and its backing buffer
-          ClonedTensor cloned = impl_->tensorManager_->cloneTensor(tensor_id);
-          if (cloned.value) {
-            cloned_inputs.push_back(std::move(cloned));
-            input_names.push_back(input_name);
-          }
-        } catch (const std::exception &e) {
-          // Log the error but continue with the next tensor
-          std::cerr << "Failed to clone tensor " << tensor_id << ": " << e.what() << std::endl;
-        }
+  auto run_options = std::make_shared<Ort::RunOptions>();
+  try {
+    const auto &inputs = std::get<flutter::EncodableMap>(inputs_it->second);
+    for (const TensorInfo &input : stream->inputs()) {
+      auto data_it = inputs.find(flutter::EncodableValue(input.name));
+      const void *data = nullptr;
+      size_t byte_size = 0;
+      if (data_it == inputs.end() || !GetTypedData(data_it->second, input.element_type, &data, &byte_size)) {
+        throw std::invalid_argument("Input " + input.name + " must be typed data of type " + input.type);
       }
+      stream->writeInput(*slot, input.name, data, byte_size);
     }
+    ApplyRunOptions(*args, *run_options);
+  } catch (const std::exception &e) {
+    stream->releaseSlot(*slot);
+    result->Error("INVALID_ARG", e.what(), nullptr);
+    return;
+  }
+  uint64_t frame = stream->numberFrame();
 
-    // Build a vector of Ort::Value references for Session::Run
-    std::vector<Ort::Value> input_tensors;
-    input_tensors.reserve(cloned_inputs.size());
-    for (auto &ci : cloned_inputs) {
-      input_tensors.push_back(std::move(ci.value));
-    }
-
-    // Run inference using SessionManager with input names
-    // Note: cloned_inputs (with backing buffers) stays alive through this scope
-    std::vector<Ort::Value> output_tensors;
-    if (!input_tensors.empty()) {
-      output_tensors = impl_->sessionManager_->runInference(session_id, input_tensors, input_names, &run_options);
+  FlutterOnnxruntimePluginImpl *impl = impl_.get();
+  impl->inferenceExecutor_->submit([impl, stream, slot = *slot, frame, stream_id, run_options]() {
+    flutter::EncodableMap event;
+    event[flutter::EncodableValue("streamId")] = impl->EncodeHandle(kStreamIdPrefix, stream_id);
+    event[flutter::EncodableValue("frame")] = flutter::EncodableValue(static_cast<int64_t>(frame));
+    try {
+      std::vector<TensorHandle> outputs = stream->run(slot, run_options.get());
+      flutter::EncodableMap outputs_map;
+      for (size_t i = 0; i < outputs.size(); i++) {
+        outputs_map[flutter::EncodableValue(stream->outputs()[i].name)] =
+            impl->tensorManager_->getTensorData<EncodableValueCodec>(outputs[i]);
+      }
+      event[flutter::EncodableValue("outputs")] = flutter::EncodableValue(std::move(outputs_map));
+    } catch (const std::exception &e) {
+      event[flutter::EncodableValue("error")] = flutter::EncodableValue(std::string(e.what()));
     }
+    stream->releaseSlot(slot);
 
-    // Process outputs
-    flutter::EncodableMap outputs_map;
-
-    // For each output tensor, store it using TensorManager
-    for (size_t i = 0; i < output_tensors.size(); i++) {
-      // Create a tensor ID
-      std::string value_id = impl_->tensorManager_->generateTensorId();
+    // std::function needs a copyable callable, hence the shared_ptr around the event rather than a copy of its data
+    auto pending = std::make_shared<flutter::EncodableValue>(std::move(event));
+    impl->platformTaskRunner_->postTask([impl, pending]() {
+      if (impl->streamSink_) {
+        impl->streamSink_->Success(*pending);
+      }
+    });
+  });
 
-      // Store the tensor - this transfers ownership
-      // TensorManager::storeTensor returns void (not bool)
-      impl_->tensorManager_->storeTensor(value_id, std::move(output_tensors[i]));
+  flutter::EncodableMap response;
+  response[flutter::EncodableValue("frame")] = flutter::EncodableValue(static_cast<int64_t>(frame));
+  result->Success(flutter::EncodableValue(response));
+}
 
-      // Get the tensor type and shape
-      std::string tensor_type = impl_->tensorManager_->getTensorType(value_id);
-      std::vector<int64_t> shape = impl_->tensorManager_->getTensorShape(value_id);
+void FlutterOnnxruntimePlugin::HandleCloseStream(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  StreamHandle stream_id = kInvalidHandle;
+  if (!args || !LookupHandle(*args, "streamId", kStreamIdPrefix, &stream_id)) {
+    result->Error("INVALID_ARG", "Stream ID must be provided", nullptr);
+    return;
+  }
+  impl_->streamManager_->closeStream(stream_id);
+  result->Success(nullptr);
+}
 
-      // Add the value ID to the outputs map
-      flutter::EncodableList shape_list;
-      for (const auto &dim : shape) {
-        shape_list.push_back(static_cast<int64_t>(dim));
-      }
+namespace {
 
-      // Create output info (value_id, type, shape)
-      flutter::EncodableList output_info;
-      output_info.push_back(flutter::EncodableValue(value_id));
-      output_info.push_back(flutter::EncodableValue(tensor_type));
-      output_info.push_back(flutter::EncodableValue(shape_list));
+// Fill generation options from the options map sent by Dart, keeping the defaults of the keys it does not hold
+void ReadGenerationOptions(const flutter::EncodableMap &map, GenerationOptions &options) {
+  int64_t value = 0;
+  if (LookupInt(map, "maxTokens", &value)) {
+    options.max_tokens = static_cast<size_t>(std::max<int64_t>(value, 0));
+  }
+  if (LookupInt(map, "topK", &value)) {
+    options.sampling.top_k = value;
+  }
+  if (LookupInt(map, "seed", &value)) {
+    options.seed = static_cast<uint64_t>(value);
+  }
+  auto stop_it = map.find(flutter::EncodableValue("stopTokens"));
+  if (stop_it != map.end()) {
+    ReadTokens(stop_it->second, &options.stop_tokens);
+  }
 
-      if (i < output_names.size()) {
-        outputs_map[flutter::EncodableValue(output_names[i])] = flutter::EncodableValue(output_info);
-      }
+  auto lookup_double = [&map](const char *key, float *field) {
+    auto it = map.find(flutter::EncodableValue(key));
+    if (it != map.end() && std::holds_alternative<double>(it->second)) {
+      *field = static_cast<float>(std::get<double>(it->second));
+    }
+  };
+  lookup_double("temperature", &options.sampling.temperature);
+  lookup_double("topP", &options.sampling.top_p);
+
+  auto lookup_string = [&map](const char *key, std::string *field) {
+    auto it = map.find(flutter::EncodableValue(key));
+    if (it != map.end() && std::holds_alternative<std::string>(it->second)) {
+      *field = std::get<std::string>(it->second);
     }
+  };
+  lookup_string("inputIdsName", &options.input_ids_name);
+  lookup_string("attentionMaskName", &options.attention_mask_name);
+  lookup_string("positionIdsName", &options.position_ids_name);
+  lookup_string("logitsName", &options.logits_name);
+}
 
-    result->Success(flutter::EncodableValue(outputs_map));
-  } catch (const Ort::Exception &e) {
-    result->Error("INFERENCE_ERROR", e.what(), nullptr);
-  } catch (const std::exception &e) {
-    result->Error("PLUGIN_ERROR", e.what(), nullptr);
-  } catch (...) {
-    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+// Name of the reason a generation ended, as Dart reads it
+const char *GenerationEndName(GenerationEnd end) {
+  switch (end) {
+  case GenerationEnd::kStopToken:
+    return "stop";
+  case GenerationEnd::kMaxTokens:
+    return "length";
+  case GenerationEnd::kCancelled:
+    return "cancelled";
   }
+  return "cancelled";
 }
 
-void FlutterOnnxruntimePlugin::HandleCloseSession(
-    const flutter::MethodCall<flutter::EncodableValue> &method_call,
-    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+} // namespace
 
-  // Extract parameters
+// Start a generation and respond with its ID at once. The decode loop runs on one inference worker and sends each
+// token as an event of generationChannel_, followed by an event that is done, with the reason the loop ended, or
+// that holds an error.
+void FlutterOnnxruntimePlugin::HandleGenerate(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
   const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
-
-  if (!args) {
-    result->Error("INVALID_ARG", "Arguments must be provided as a map", nullptr);
+  SessionHandle session_id = kInvalidHandle;
+  if (!args || !LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
+    result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
+    return;
+  }
+  std::vector<int64_t> prompt;
+  auto prompt_it = args->find(flutter::EncodableValue("prompt"));
+  if (prompt_it == args->end() || !ReadTokens(prompt_it->second, &prompt)) {
+    result->Error("INVALID_ARG", "Prompt must be a list of tokens", nullptr);
     return;
   }
+  if (!impl_->sessionManager_->hasSession(session_id)) {
+    result->Error("INVALID_SESSION", "Session not found", nullptr);
+    return;
+  }
+
+  GenerationOptions options;
+  auto options_it = args->find(flutter::EncodableValue("options"));
+  if (options_it != args->end()) {
+    if (const auto *options_map = std::get_if<flutter::EncodableMap>(&options_it->second)) {
+      ReadGenerationOptions(*options_map, options);
+    }
+  }
 
+  std::shared_ptr<Generation> generation;
   try {
-    // Extract session ID
-    auto session_id_it = args->find(flutter::EncodableValue("sessionId"));
-    if (session_id_it == args->end() || !std::holds_alternative<std::string>(session_id_it->second)) {
-      result->Error("INVALID_ARG", "Session ID must be a non-null string", nullptr);
-      return;
+    generation = std::make_shared<Generation>(session_id, std::move(prompt), std::move(options),
+                                              *impl_->sessionManager_);
+  } catch (const std::exception &e) {
+    result->Error("INVALID_ARG", e.what(), nullptr);
+    return;
+  }
+  GenerationHandle generation_id = impl_->generationManager_->addGeneration(generation);
+
+  FlutterOnnxruntimePluginImpl *impl = impl_.get();
+  impl->inferenceExecutor_->submit([impl, generation, generation_id]() {
+    auto send_event = [impl](flutter::EncodableMap event) {
+      // std::function needs a copyable callable, hence the shared_ptr around the event rather than a copy of its data
+      auto pending = std::make_shared<flutter::EncodableValue>(std::move(event));
+      impl->platformTaskRunner_->postTask([impl, pending]() {
+        if (impl->generationSink_) {
+          impl->generationSink_->Success(*pending);
+        }
+      });
+    };
+    flutter::EncodableValue encoded_id = impl->EncodeHandle(kGenerationIdPrefix, generation_id);
+
+    flutter::EncodableMap end_event;
+    end_event[flutter::EncodableValue("generationId")] = encoded_id;
+    try {
+      GenerationEnd end = generation->run([&send_event, &encoded_id](int64_t token) {
+        flutter::EncodableMap event;
+        event[flutter::EncodableValue("generationId")] = encoded_id;
+        event[flutter::EncodableValue("token")] = flutter::EncodableValue(token);
+        send_event(std::move(event));
+      });
+      end_event[flutter::EncodableValue("done")] = flutter::EncodableValue(true);
+      end_event[flutter::EncodableValue("reason")] = flutter::EncodableValue(std::string(GenerationEndName(end)));
+    } catch (const std::exception &e) {
+      end_event[flutter::EncodableValue("error")] = flutter::EncodableValue(std::string(e.what()));
     }
-    std::string session_id = std::get<std::string>(session_id_it->second);
+    impl->generationManager_->removeGeneration(generation_id);
+    send_event(std::move(end_event));
+  });
 
-    // Close the session
-    impl_->sessionManager_->closeSession(session_id);
+  flutter::EncodableMap response;
+  response[flutter::EncodableValue("generationId")] = impl_->EncodeHandle(kGenerationIdPrefix, generation_id);
+  result->Success(flutter::EncodableValue(response));
+}
 
-    // Return null for success
-    result->Success(nullptr);
-  } catch (const Ort::Exception &e) {
-    result->Error("ORT_ERROR", e.what(), nullptr);
-  } catch (const std::exception &e) {
-    result->Error("PLUGIN_ERROR", e.what(), nullptr);
-  } catch (...) {
-    result->Error("INTERNAL_ERROR", "Unknown error occurred", nullptr);
+void FlutterOnnxruntimePlugin::HandleCancelGeneration(
+    const flutter::MethodCall<flutter::EncodableValue> &method_call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+  GenerationHandle generation_id = kInvalidHandle;
+  if (!args || !LookupHandle(*args, "generationId", kGenerationIdPrefix, &generation_id)) {
+    result->Error("INVALID_ARG", "Generation ID must be provided", nullptr);
+    return;
+  }
+  // A generation that already finished has nothing left to cancel
+  std::shared_ptr<Generation> generation = impl_->generationManager_->findGeneration(generation_id);
+  if (generation) {
+    generation->cancel();
   }
+  result->Success(nullptr);
 }
 
 void FlutterOnnxruntimePlugin::HandleGetMetadata(
@@ -843,12 +3730,11 @@ void FlutterOnnxruntimePlugin::HandleGetMetadata(
 
   try {
     // Extract session ID
-    auto session_id_it = args->find(flutter::EncodableValue("sessionId"));
-    if (session_id_it == args->end() || !std::holds_alternative<std::string>(session_id_it->second)) {
+    SessionHandle session_id = kInvalidHandle;
+    if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
       result->Error("INVALID_SESSION", "Invalid session ID", nullptr);
       return;
     }
-    std::string session_id = std::get<std::string>(session_id_it->second);
 
     // Check if session exists
     if (!impl_->sessionManager_->hasSession(session_id)) {
@@ -898,12 +3784,11 @@ void FlutterOnnxruntimePlugin::HandleGetInputInfo(
 
   try {
     // Extract session ID
-    auto session_id_it = args->find(flutter::EncodableValue("sessionId"));
-    if (session_id_it == args->end() || !std::holds_alternative<std::string>(session_id_it->second)) {
+    SessionHandle session_id = kInvalidHandle;
+    if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
       result->Error("INVALID_SESSION", "Invalid session ID", nullptr);
       return;
     }
-    std::string session_id = std::get<std::string>(session_id_it->second);
 
     // Check if session exists
     if (!impl_->sessionManager_->hasSession(session_id)) {
@@ -929,6 +3814,10 @@ void FlutterOnnxruntimePlugin::HandleGetInputInfo(
       }
       info_map[flutter::EncodableValue("shape")] = flutter::EncodableValue(shape_list);
 
+      if (info.quantization) {
+        info_map[flutter::EncodableValue("quantization")] = QuantizationToEncodable(*info.quantization);
+      }
+
       response.push_back(flutter::EncodableValue(info_map));
     }
 
@@ -956,12 +3845,11 @@ void FlutterOnnxruntimePlugin::HandleGetOutputInfo(
 
   try {
     // Extract session ID
-    auto session_id_it = args->find(flutter::EncodableValue("sessionId"));
-    if (session_id_it == args->end() || !std::holds_alternative<std::string>(session_id_it->second)) {
+    SessionHandle session_id = kInvalidHandle;
+    if (!LookupHandle(*args, "sessionId", kSessionIdPrefix, &session_id)) {
       result->Error("INVALID_SESSION", "Invalid session ID", nullptr);
       return;
     }
-    std::string session_id = std::get<std::string>(session_id_it->second);
 
     // Check if session exists
     if (!impl_->sessionManager_->hasSession(session_id)) {
@@ -987,6 +3875,10 @@ void FlutterOnnxruntimePlugin::HandleGetOutputInfo(
       }
       info_map[flutter::EncodableValue("shape")] = flutter::EncodableValue(shape_list);
 
+      if (info.quantization) {
+        info_map[flutter::EncodableValue("quantization")] = QuantizationToEncodable(*info.quantization);
+      }
+
       response.push_back(flutter::EncodableValue(info_map));
     }
 
@@ -14,14 +14,16 @@
 
 namespace flutter_onnxruntime {
 
-// Forward declaration
+// Forward declarations
 class FlutterOnnxruntimePluginImpl;
+class InferenceExecutor;
+struct CallInputs;
 
 class FlutterOnnxruntimePlugin : public flutter::Plugin {
 public:
   static void RegisterWithRegistrar(flutter::PluginRegistrarWindows *registrar);
 
-  FlutterOnnxruntimePlugin();
+  explicit FlutterOnnxruntimePlugin(flutter::PluginRegistrarWindows *registrar);
 
   virtual ~FlutterOnnxruntimePlugin();
 
@@ -35,18 +37,174 @@ private:
                         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
   // Session management method handlers
+  // Handles both createSession and createSessionFromBuffer by queueing them on the session loader
   void HandleCreateSession(const flutter::MethodCall<flutter::EncodableValue> &method_call,
                            std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
+  void CreateSession(const flutter::EncodableMap &arguments,
+                     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void CreateSessionFromBuffer(const flutter::EncodableMap &arguments,
+                               std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Create a session from the model path or, with from_buffer, the model bytes of the arguments and warm it up
+  void CreateSessionFrom(const flutter::EncodableMap &arguments, bool from_buffer,
+                         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
   void HandleGetAvailableProviders(const flutter::MethodCall<flutter::EncodableValue> &method_call,
                                    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
   void HandleRunInference(const flutter::MethodCall<flutter::EncodableValue> &method_call,
                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
+  // Handler that runs on a worker thread and responds through a platform thread result
+  using WorkerHandler = void (FlutterOnnxruntimePlugin::*)(
+      const flutter::EncodableMap &arguments, std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Queue a handler on a worker pool with a copy of the call arguments
+  void RunOnWorker(InferenceExecutor &executor, const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                   std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result, WorkerHandler handler);
+
+  // Handler that runs on a worker thread with the inputs that were borrowed before it was queued
+  using InputsHandler = void (FlutterOnnxruntimePlugin::*)(
+      const flutter::EncodableMap &arguments, CallInputs &inputs,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Borrow the inputs of a call on the platform thread, then queue its handler on the inference workers with them;
+  // responds right away if an input cannot be borrowed. Handlers that read the input data on the CPU borrow host
+  // copies of tensors in device memory.
+  void RunWithInputsOnWorker(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                             std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+                             InputsHandler handler, bool host_memory = false);
+
+  void RunInference(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Queue a runInference call in the micro-batcher, taking over the result; returns false and leaves the result
+  // untouched if the call should run on its own
+  bool SubmitBatchedInference(const flutter::EncodableMap &arguments,
+                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> &result);
+
+  void HandleRunBatch(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void RunBatch(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Output binding method handlers
+  void HandleBindOutputs(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleRunWithBinding(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                            std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void RunWithBinding(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleUnbindOutputs(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Sequence state method handlers, run on the inference workers since they wait for a step in flight
+  void EnableSequenceState(const flutter::EncodableMap &arguments,
+                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void ResetSequenceState(const flutter::EncodableMap &arguments,
+                          std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void DisableSequenceState(const flutter::EncodableMap &arguments,
+                            std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleSetInferenceThreads(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                                 std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleGetQueueStats(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleCancelLowPriorityRuns(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                                   std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleCancelRun(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleSetIntegerHandles(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                               std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleConfigureSessionCache(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                                   std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleConfigureThreadPools(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                                  std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleConfigureSharedArena(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                                  std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleConfigureBatching(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                               std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleGetBatchingStats(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleGetSessionStats(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                             std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleGetMemoryStats(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                            std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleSetMemoryLimit(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                            std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleEndProfiling(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                          std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void EndProfiling(const flutter::EncodableMap &arguments,
+                    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleStartTracing(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                          std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleStopTracing(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void StopTracing(const flutter::EncodableMap &arguments,
+                   std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleGetNativeContext(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
   void HandleCloseSession(const flutter::MethodCall<flutter::EncodableValue> &method_call,
                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
+  // Pipeline method handlers
+  void HandleCreatePipeline(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                            std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void RunPipeline(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                   std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleClosePipeline(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Runs a glue op on stored tensors, on an inference worker
+  void RunTensorOp(const flutter::EncodableMap &arguments, CallInputs &inputs,
+                   std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Frame stream method handlers
+  void HandleOpenStream(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleSubmitStreamFrame(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                               std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleCloseStream(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // Native decode loop method handlers
+  void HandleGenerate(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleCancelGeneration(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
   void HandleGetMetadata(const flutter::MethodCall<flutter::EncodableValue> &method_call,
                          std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
@@ -60,15 +218,39 @@ private:
   void HandleCreateOrtValue(const flutter::MethodCall<flutter::EncodableValue> &method_call,
                             std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
+  void HandleCreateImageTensor(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                               std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
   void HandleConvertOrtValue(const flutter::MethodCall<flutter::EncodableValue> &method_call,
                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
+  void HandleQuantizeOrtValue(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleDequantizeOrtValue(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                                std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleReshapeOrtValue(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                             std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleSliceOrtValue(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                           std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleTransposeOrtValue(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                               std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleConcatOrtValues(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                             std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
   void HandleGetOrtValueData(const flutter::MethodCall<flutter::EncodableValue> &method_call,
                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
   void HandleReleaseOrtValue(const flutter::MethodCall<flutter::EncodableValue> &method_call,
                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
+  void HandleReleaseOrtValues(const flutter::MethodCall<flutter::EncodableValue> &method_call,
+                              std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
   // Private implementation
   std::unique_ptr<FlutterOnnxruntimePluginImpl> impl_;
 };
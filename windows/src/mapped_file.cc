@@ -0,0 +1,47 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "core/mapped_file.h"
+#include "windows_utils.h"
+
+namespace flutter_onnxruntime {
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+  std::string name = WindowsUtils::wideToUtf8(path.wstring());
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("Failed to open " + name + ": " + WindowsUtils::getLastErrorAsString());
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0) {
+    CloseHandle(file);
+    throw std::runtime_error("Failed to map " + name + ": the file is empty or cannot be read");
+  }
+  size_ = static_cast<size_t>(file_size.QuadPart);
+
+  // The view stays valid after the file and mapping handles are closed
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    throw std::runtime_error("Failed to map " + name + ": " + WindowsUtils::getLastErrorAsString());
+  }
+  data_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  std::string map_error = data_ == nullptr ? WindowsUtils::getLastErrorAsString() : std::string();
+  CloseHandle(mapping);
+  if (data_ == nullptr) {
+    throw std::runtime_error("Failed to map " + name + ": " + map_error);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+}
+
+} // namespace flutter_onnxruntime
@@ -0,0 +1,94 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "platform_task_runner.h"
+#include "windows_utils.h"
+#include <iostream>
+
+namespace flutter_onnxruntime {
+
+PlatformTaskRunner::PlatformTaskRunner(flutter::PluginRegistrarWindows *registrar)
+    : registrar_(registrar), window_proc_id_(-1),
+      message_id_(RegisterWindowMessage(L"FlutterOnnxruntimeRunPlatformTasks")) {
+  window_proc_id_ = registrar_->RegisterTopLevelWindowProcDelegate(
+      [this](HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam) {
+        return handleWindowProc(hwnd, message, wparam, lparam);
+      });
+}
+
+PlatformTaskRunner::~PlatformTaskRunner() {
+  // Tasks that were never run are dropped together with the queue
+  registrar_->UnregisterTopLevelWindowProcDelegate(window_proc_id_);
+}
+
+void PlatformTaskRunner::postTask(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push(std::move(task));
+  }
+
+  HWND window = getTopLevelWindow();
+  if (window == nullptr || !PostMessage(window, message_id_, 0, 0)) {
+    std::cerr << "Failed to post task to platform thread: " << WindowsUtils::getLastErrorAsString() << std::endl;
+  }
+}
+
+std::optional<LRESULT> PlatformTaskRunner::handleWindowProc(HWND /* hwnd */, UINT message, WPARAM /* wparam */,
+                                                           LPARAM /* lparam */) {
+  if (message != message_id_) {
+    return std::nullopt;
+  }
+  runPendingTasks();
+  return 0;
+}
+
+void PlatformTaskRunner::runPendingTasks() {
+  std::queue<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(tasks, tasks_);
+  }
+
+  while (!tasks.empty()) {
+    tasks.front()();
+    tasks.pop();
+  }
+}
+
+HWND PlatformTaskRunner::getTopLevelWindow() {
+  flutter::FlutterView *view = registrar_->GetView();
+  if (view == nullptr) {
+    return nullptr;
+  }
+  return GetAncestor(view->GetNativeWindow(), GA_ROOT);
+}
+
+PlatformThreadResult::PlatformThreadResult(std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+                                           PlatformTaskRunner *task_runner)
+    : result_(std::move(result)), task_runner_(task_runner) {}
+
+void PlatformThreadResult::SuccessInternal(const flutter::EncodableValue *result) {
+  // Copy the value, as the pointer is only valid for the duration of this call
+  auto value = std::make_shared<flutter::EncodableValue>(result ? *result : flutter::EncodableValue());
+  auto target = result_;
+  task_runner_->postTask([target, value]() { target->Success(*value); });
+}
+
+void PlatformThreadResult::ErrorInternal(const std::string &error_code, const std::string &error_message,
+                                         const flutter::EncodableValue *error_details) {
+  auto details = error_details ? std::make_shared<flutter::EncodableValue>(*error_details) : nullptr;
+  auto target = result_;
+  task_runner_->postTask([target, error_code, error_message, details]() {
+    target->Error(error_code, error_message, details.get());
+  });
+}
+
+void PlatformThreadResult::NotImplementedInternal() {
+  auto target = result_;
+  task_runner_->postTask([target]() { target->NotImplemented(); });
+}
+
+} // namespace flutter_onnxruntime
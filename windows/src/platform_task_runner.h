@@ -0,0 +1,75 @@
+// Copyright (c) MASIC AI
+// All rights reserved.
+//
+// This source code is licensed under the license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef FLUTTER_ONNXRUNTIME_PLATFORM_TASK_RUNNER_H_
+#define FLUTTER_ONNXRUNTIME_PLATFORM_TASK_RUNNER_H_
+
+#include "pch.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+
+// Include Windows headers
+#include <windows.h>
+
+namespace flutter_onnxruntime {
+
+// Runs tasks on the platform (UI) thread by posting a message to the top-level Flutter window.
+// Method channel results must be delivered on this thread.
+class PlatformTaskRunner {
+public:
+  explicit PlatformTaskRunner(flutter::PluginRegistrarWindows *registrar);
+  ~PlatformTaskRunner();
+
+  // Disallow copy and assign
+  PlatformTaskRunner(const PlatformTaskRunner &) = delete;
+  PlatformTaskRunner &operator=(const PlatformTaskRunner &) = delete;
+
+  // Queue a task to run on the platform thread; safe to call from any thread
+  void postTask(std::function<void()> task);
+
+private:
+  // Window procedure delegate that drains the task queue when our message arrives
+  std::optional<LRESULT> handleWindowProc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam);
+
+  // Run all tasks queued so far
+  void runPendingTasks();
+
+  // Get the top-level window that receives our messages
+  HWND getTopLevelWindow();
+
+  flutter::PluginRegistrarWindows *registrar_;
+  int window_proc_id_;
+  UINT message_id_;
+
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+};
+
+// MethodResult that forwards the response to the wrapped result on the platform thread.
+// Allows handlers running on worker threads to respond as usual.
+class PlatformThreadResult : public flutter::MethodResult<flutter::EncodableValue> {
+public:
+  PlatformThreadResult(std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+                       PlatformTaskRunner *task_runner);
+
+protected:
+  void SuccessInternal(const flutter::EncodableValue *result) override;
+  void ErrorInternal(const std::string &error_code, const std::string &error_message,
+                     const flutter::EncodableValue *error_details) override;
+  void NotImplementedInternal() override;
+
+private:
+  std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> result_;
+  PlatformTaskRunner *task_runner_;
+};
+
+} // namespace flutter_onnxruntime
+
+#endif // FLUTTER_ONNXRUNTIME_PLATFORM_TASK_RUNNER_H_
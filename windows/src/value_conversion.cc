@@ -80,4 +80,77 @@ flutter::EncodableValue ValueConversion::vectorToFlValue(const std::vector<std::
 
   return flutter::EncodableValue(result);
 }
+
+std::string ValueConversion::canonicalString(const flutter::EncodableValue &value) {
+  if (const auto *bool_value = std::get_if<bool>(&value)) {
+    return *bool_value ? "true" : "false";
+  } else if (const auto *int_value = std::get_if<int32_t>(&value)) {
+    return std::to_string(*int_value);
+  } else if (const auto *long_value = std::get_if<int64_t>(&value)) {
+    return std::to_string(*long_value);
+  } else if (const auto *double_value = std::get_if<double>(&value)) {
+    return std::to_string(*double_value);
+  } else if (const auto *string_value = std::get_if<std::string>(&value)) {
+    return *string_value;
+  } else if (const auto *list = std::get_if<flutter::EncodableList>(&value)) {
+    std::string result = "[";
+    for (const auto &item : *list) {
+      result += canonicalString(item) + ",";
+    }
+    return result + "]";
+  } else if (const auto *map = std::get_if<flutter::EncodableMap>(&value)) {
+    // EncodableMap is ordered by key
+    std::string result = "{";
+    for (const auto &entry : *map) {
+      result += canonicalString(entry.first) + ":" + canonicalString(entry.second) + ",";
+    }
+    return result + "}";
+  }
+  // Null; typed lists do not occur in options
+  return "null";
+}
+flutter::EncodableValue EncodableValueCodec::null() { return flutter::EncodableValue(nullptr); }
+
+flutter::EncodableValue EncodableValueCodec::list(const float *data, size_t count) {
+  return flutter::EncodableValue(std::vector<float>(data, data + count));
+}
+
+flutter::EncodableValue EncodableValueCodec::list(const double *data, size_t count) {
+  return flutter::EncodableValue(std::vector<double>(data, data + count));
+}
+
+flutter::EncodableValue EncodableValueCodec::list(const int32_t *data, size_t count) {
+  return flutter::EncodableValue(std::vector<int32_t>(data, data + count));
+}
+
+flutter::EncodableValue EncodableValueCodec::list(const int64_t *data, size_t count) {
+  return flutter::EncodableValue(std::vector<int64_t>(data, data + count));
+}
+
+flutter::EncodableValue EncodableValueCodec::list(const uint8_t *data, size_t count) {
+  return flutter::EncodableValue(std::vector<uint8_t>(data, data + count));
+}
+
+flutter::EncodableValue EncodableValueCodec::list(const std::vector<bool> &data) {
+  return ValueConversion::vectorToFlValue(data);
+}
+
+flutter::EncodableValue EncodableValueCodec::list(const std::vector<std::string> &data) {
+  return ValueConversion::vectorToFlValue(data);
+}
+
+flutter::EncodableValue EncodableValueCodec::tensor(const std::vector<int64_t> &shape, const std::string &data_type,
+                                                    flutter::EncodableValue data) {
+  flutter::EncodableList shape_list;
+  for (int64_t dim : shape) {
+    shape_list.push_back(dim);
+  }
+
+  flutter::EncodableMap result;
+  result[flutter::EncodableValue("shape")] = flutter::EncodableValue(shape_list);
+  result[flutter::EncodableValue("dataType")] = flutter::EncodableValue(data_type);
+  result[flutter::EncodableValue("data")] = std::move(data);
+  return flutter::EncodableValue(result);
+}
+
 } // namespace flutter_onnxruntime
\ No newline at end of file
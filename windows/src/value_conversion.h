@@ -33,6 +33,25 @@ public:
   static flutter::EncodableValue vectorToFlValue(const std::vector<bool> &vec);
 
   static flutter::EncodableValue vectorToFlValue(const std::vector<std::string> &vec);
+
+  // Serialize a value with map entries in key order, so that equal values give equal strings
+  static std::string canonicalString(const flutter::EncodableValue &value);
+};
+
+// Codec that encodes tensor data as flutter::EncodableValue for core/tensor_codec.h
+struct EncodableValueCodec {
+  using Value = flutter::EncodableValue;
+
+  static flutter::EncodableValue null();
+  static flutter::EncodableValue list(const float *data, size_t count);
+  static flutter::EncodableValue list(const double *data, size_t count);
+  static flutter::EncodableValue list(const int32_t *data, size_t count);
+  static flutter::EncodableValue list(const int64_t *data, size_t count);
+  static flutter::EncodableValue list(const uint8_t *data, size_t count);
+  static flutter::EncodableValue list(const std::vector<bool> &data);
+  static flutter::EncodableValue list(const std::vector<std::string> &data);
+  static flutter::EncodableValue tensor(const std::vector<int64_t> &shape, const std::string &data_type,
+                                        flutter::EncodableValue data);
 };
 
 } // namespace flutter_onnxruntime